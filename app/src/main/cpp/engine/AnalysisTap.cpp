@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AnalysisTap.h"
+#include "../utils/ThreadPolicy.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+
+namespace guitarrackcraft {
+
+void AnalysisTap::setSource(int32_t source) {
+    source_.store(source, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(threadMutex_);
+    if (source == kOff) {
+        if (running_.exchange(false) && thread_.joinable()) thread_.join();
+        TelemetryBlock* block = telemetry_.load(std::memory_order_acquire);
+        if (block) {
+            block->beginAnalysisWrite().source = kOff;
+            block->endAnalysisWrite();
+        }
+    } else if (!running_.exchange(true)) {
+        thread_ = std::thread(&AnalysisTap::threadLoop, this);
+    }
+}
+
+void AnalysisTap::stopThread() {
+    std::lock_guard<std::mutex> lock(threadMutex_);
+    running_.store(false);
+    if (thread_.joinable()) thread_.join();
+}
+
+void AnalysisTap::threadLoop() {
+    applyThreadRole(ThreadRole::Background);
+    while (running_.load(std::memory_order_relaxed)) {
+        poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(kPollMs));
+    }
+}
+
+uint32_t AnalysisTap::poll() {
+    const int32_t source = source_.load(std::memory_order_acquire);
+    const float rate = sampleRate_.load(std::memory_order_relaxed);
+    if (source != lastSource_ || !analyzer_ || analyzer_->sampleRate() != rate) {
+        // New tap point or rate: history from the old one would blend into the results
+        std::fill(history_.begin(), history_.end(), 0.0f);
+        pending_ = 0;
+        lastSource_ = source;
+        if (!analyzer_ || analyzer_->sampleRate() != rate) {
+            analyzer_ = std::make_unique<SignalAnalyzer>(rate);
+        }
+    }
+
+    uint32_t published = 0;
+    const size_t window = history_.size();
+    RingBuffer::Span first, second;
+    while (ring_.peek(first, second) > 0) {
+        // Slide the history by at most one hop at a time, analyzing each completed hop
+        const size_t take = std::min<size_t>(first.count + second.count, kHopFrames - pending_);
+        std::memmove(history_.data(), history_.data() + take, (window - take) * sizeof(float));
+        const size_t fromFirst = std::min(take, first.count);
+        std::memcpy(history_.data() + window - take, first.data, fromFirst * sizeof(float));
+        std::memcpy(history_.data() + window - take + fromFirst, second.data,
+                    (take - fromFirst) * sizeof(float));
+        ring_.skip(take);
+        pending_ += static_cast<uint32_t>(take);
+        if (pending_ >= kHopFrames) {
+            pending_ = 0;
+            if (source != kOff) {
+                analyzer_->analyze(history_.data(), result_);
+                publish(source);
+                ++published;
+            }
+        }
+    }
+    return published;
+}
+
+void AnalysisTap::publish(int32_t source) {
+    TelemetryBlock* block = telemetry_.load(std::memory_order_acquire);
+    ++updates_;
+    if (!block) return;
+    TelemetryBlock::Analysis& out = block->beginAnalysisWrite();
+    // Everything after the sequence word, which only begin/endAnalysisWrite() touch
+    constexpr size_t kFirst = offsetof(TelemetryBlock::Analysis, source);
+    std::memcpy(reinterpret_cast<char*>(&out) + kFirst, reinterpret_cast<const char*>(&result_) + kFirst,
+                sizeof(out) - kFirst);
+    out.source = source;
+    out.updates = updates_;
+    block->endAnalysisWrite();
+}
+
+} // namespace guitarrackcraft
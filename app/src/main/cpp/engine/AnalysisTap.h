@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUITARRACKCRAFT_ANALYSIS_TAP_H
+#define GUITARRACKCRAFT_ANALYSIS_TAP_H
+
+#include "RingBuffer.h"
+#include "SignalAnalyzer.h"
+#include "../utils/TelemetryBlock.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Tuner/spectrum/scope without a plugin in the chain: the audio side copies the tapped signal
+ * (engine input or one slot's left output) into a ring, and a background thread runs
+ * SignalAnalyzer over it every kHopFrames and publishes into the TelemetryBlock's analysis
+ * section. The audio thread's whole cost is that one copy.
+ *
+ * Thread safety:
+ *   - write() from the thread producing the tapped signal (one at a time; the engine only
+ *     taps one point per block)
+ *   - setSource()/setSampleRate()/setTelemetry() from control threads
+ *   - poll() from the analysis thread, or directly in tests while the thread is not running
+ */
+class AnalysisTap {
+public:
+    static constexpr int32_t kOff = -2;
+    static constexpr int32_t kInput = -1;
+    static constexpr uint32_t kRingFrames = 16384;
+    static constexpr uint32_t kHopFrames = 1024;  // ~21 ms at 48 kHz
+    static constexpr int kPollMs = 10;
+
+    AnalysisTap() : ring_(kRingFrames), history_(SignalAnalyzer::kWindowFrames, 0.0f) {}
+    ~AnalysisTap() { stopThread(); }
+
+    AnalysisTap(const AnalysisTap&) = delete;
+    AnalysisTap& operator=(const AnalysisTap&) = delete;
+
+    /** kOff, kInput or a chain index; starts the analysis thread, or stops it for kOff. */
+    void setSource(int32_t source);
+    int32_t source() const { return source_.load(std::memory_order_acquire); }
+
+    void setSampleRate(float sampleRate) { sampleRate_.store(sampleRate, std::memory_order_relaxed); }
+    void setTelemetry(TelemetryBlock* block) { telemetry_.store(block, std::memory_order_release); }
+
+    /** Producer: copy 'frames' samples in; dropped if the analysis thread fell behind. */
+    void write(const float* samples, uint32_t frames) {
+        if (ring_.write(samples, frames) < frames) {
+            dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    }
+
+    /** The ring write() fills, for producers that take a RingBuffer (PluginChain). */
+    RingBuffer* ring() { return &ring_; }
+
+    /** Consumer: take what was written, and analyze and publish each complete hop.
+     *  Returns the number of results published. */
+    uint32_t poll();
+
+    uint32_t droppedBlocks() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    void threadLoop();
+    void stopThread();
+    void publish(int32_t source);
+
+    RingBuffer ring_;
+    std::atomic<int32_t> source_{kOff};
+    std::atomic<float> sampleRate_{48000.0f};
+    std::atomic<TelemetryBlock*> telemetry_{nullptr};
+    std::atomic<uint32_t> dropped_{0};
+
+    std::mutex threadMutex_;  // start/stop
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    // Consumer side
+    std::vector<float> history_;  // newest SignalAnalyzer::kWindowFrames frames, oldest first
+    uint32_t pending_ = 0;        // frames since the last analysis
+    int32_t lastSource_ = kOff;
+    uint32_t updates_ = 0;
+    std::unique_ptr<SignalAnalyzer> analyzer_;
+    TelemetryBlock::Analysis result_{};
+};
+
+} // namespace guitarrackcraft
+
+#endif // GUITARRACKCRAFT_ANALYSIS_TAP_H
@@ -18,7 +18,13 @@
  */
 
 #include "AudioEngine.h"
-#include "utils/WavIO.h"
+#include "utils/AudioKernels.h"
+#include "utils/FloatEnv.h"
+#include "utils/RtGuard.h"
+#include "utils/RtMemory.h"
+#include "utils/RtTrace.h"
+#include "utils/SystemTrace.h"
+#include "utils/ThreadPolicy.h"
 #include "utils/ThreadUtils.h"
 #include <oboe/OboeExtensions.h>
 #include <android/log.h>
@@ -33,6 +39,11 @@
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
+namespace {
+// Trace builds: periodic RT trace records roughly once per second at 48 kHz / 64 frames.
+constexpr uint32_t kTraceEveryCallbacks = 750;
+}
+
 namespace guitarrackcraft {
 
 AudioEngine::AudioEngine()
@@ -43,14 +54,26 @@ AudioEngine::AudioEngine()
     inputPtrs_[1] = nullptr;
     outputPtrs_[0] = nullptr;
     outputPtrs_[1] = nullptr;
+#if defined(GRC_RT_TRACE) && GRC_RT_TRACE
+    RtTrace::instance().start();
+#endif
 }
 
 AudioEngine::~AudioEngine() {
     stop();
+#if defined(GRC_RT_TRACE) && GRC_RT_TRACE
+    RtTrace::instance().stop();
+#endif
 }
 
 bool AudioEngine::start(float sampleRate, int32_t inputDeviceId,
                         int32_t outputDeviceId, int32_t bufferFrames) {
+    std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+    return startLocked(sampleRate, inputDeviceId, outputDeviceId, bufferFrames);
+}
+
+bool AudioEngine::startLocked(float sampleRate, int32_t inputDeviceId,
+                              int32_t outputDeviceId, int32_t bufferFrames) {
     LOGI("start() ENTER tid=%ld sampleRate=%.0f inputDev=%d outputDev=%d bufFrames=%d isRunning_=%d",
          getTid(), sampleRate, inputDeviceId, outputDeviceId, bufferFrames, isRunning_ ? 1 : 0);
     if (isRunning_) {
@@ -59,6 +82,7 @@ bool AudioEngine::start(float sampleRate, int32_t inputDeviceId,
     }
 
     sampleRate_ = sampleRate;
+    callbackStats_.requestReset();
     inputDeviceId_ = inputDeviceId;
     outputDeviceId_ = outputDeviceId;
     requestedBufferFrames_ = bufferFrames;
@@ -68,42 +92,106 @@ bool AudioEngine::start(float sampleRate, int32_t inputDeviceId,
         return false;
     }
 
-    // Activate plugin chain with the power-of-2 callback frame count
+    // Activate plugin chain with the power-of-2 block the adapter feeds it,
     // so convolver plugins configure their partition size correctly
-    LOGI("Using callback frame count: %u (power-of-2)", callbackFrameCount_);
+    LOGI("Using chain block: %u frames (power-of-2)", callbackFrameCount_);
     chain_.setSampleRate(sampleRate_, callbackFrameCount_);
     chain_.activate();
 
     isRunning_ = true;
+    state_.store(State::Running);
+    startPerformanceHints();
+    startLoadShedding();
     LOGI("start() EXIT tid=%ld Audio engine started at %.0f Hz", getTid(), sampleRate_);
     return true;
 }
 
+bool AudioEngine::reconfigure(float sampleRate, int32_t inputDeviceId,
+                              int32_t outputDeviceId, int32_t bufferFrames) {
+    std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+    if (state_.load() != State::Running) {
+        return startLocked(sampleRate, inputDeviceId, outputDeviceId, bufferFrames);
+    }
+    LOGI("reconfigure() sampleRate=%.0f inputDev=%d outputDev=%d bufFrames=%d",
+         sampleRate, inputDeviceId, outputDeviceId, bufferFrames);
+    const auto t0 = std::chrono::steady_clock::now();
+    state_.store(State::Reconfiguring);
+
+    // Everything tied to the old streams goes; the chain stays active meanwhile
+    if (recorder_.isRecording()) {
+        recorder_.stopRecording();
+    }
+    stopLoadShedding();
+    stopPerformanceHints();
+    closeStreams();
+
+    const float chainRate = chain_.getSampleRate();
+    const uint32_t chainBlock = chain_.getBufferSize();
+    sampleRate_ = sampleRate;
+    callbackStats_.requestReset();
+    inputDeviceId_ = inputDeviceId;
+    outputDeviceId_ = outputDeviceId;
+    requestedBufferFrames_ = bufferFrames;
+    if (!createAudioStreams(sampleRate)) {
+        LOGE("reconfigure() failed to create audio streams; engine stopped");
+        chain_.deactivate();
+        state_.store(State::Stopped);
+        return false;
+    }
+
+    // Plugins size their state (IR partitions, delay lines) from these two, nothing else
+    if (sampleRate_ != chainRate || callbackFrameCount_ != chainBlock) {
+        LOGI("reconfigure() chain %.0f Hz / %u -> %.0f Hz / %u frames: reactivating plugins",
+             chainRate, chainBlock, sampleRate_, callbackFrameCount_);
+        chain_.deactivate();
+        chain_.setSampleRate(sampleRate_, callbackFrameCount_);
+    } else {
+        LOGI("reconfigure() chain settings unchanged: plugins stay active");
+    }
+
+    isRunning_ = true;
+    state_.store(State::Running);
+    startPerformanceHints();
+    startLoadShedding();
+    LOGI("reconfigure() done in %lld ms",
+         static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - t0).count()));
+    return true;
+}
+
 void AudioEngine::stop() {
+    std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
     LOGI("stop() entered tid=%ld isRunning_=%d", getTid(), isRunning_ ? 1 : 0);
+    state_.store(State::Stopped);
     if (!isRunning_) {
         // Stream may have been closed by onErrorAfterClose (e.g. system closed stream when opening X11 UI).
-        // We must still call closeStreams() so streams are torn down with the 250ms wait before the
-        // destructor runs. Otherwise ~AudioEngine destroys outputStream_/inputStream_ while the
+        // We must still call closeStreams() so streams are torn down after the callback handshake
+        // before the destructor runs. Otherwise ~AudioEngine destroys outputStream_/inputStream_ while the
         // AudioTrack callback thread is still in getStream() -> pthread_mutex_lock on destroyed mutex (SIGABRT).
         LOGI("stop() isRunning_=0; calling closeStreams() anyway so streams tear down safely");
+        stopLoadShedding();
         closeStreams();
+        stopPerformanceHints();
         return;
     }
     // Stop recording before tearing down the audio path
     if (recorder_.isRecording()) {
         recorder_.stopRecording();
     }
+    // Puts back shed quality controls and the buffer size while the stream is still open
+    stopLoadShedding();
 
-    // Signal callback to exit immediately so it does not touch chain_ or stream
-    // during teardown (avoids use-after-free / destroyed mutex in plugin chain or Oboe).
+    // Signal callback to exit immediately, and wait until it has, so it does not touch chain_
+    // or the stream during teardown (avoids use-after-free / destroyed mutex in plugin chain or Oboe).
     isRunning_ = false;
-    LOGI("stop() isRunning_=false set, calling chain_.deactivate()");
+    quiesceCallback();
+    LOGI("stop() callback quiescent, calling chain_.deactivate()");
 
     chain_.deactivate();
     LOGI("stop() chain_.deactivate() done, calling closeStreams()");
 
     closeStreams();
+    stopPerformanceHints();
     LOGI("stop() done");
 }
 
@@ -125,6 +213,9 @@ AudioEngine::StreamInfo AudioEngine::getStreamInfo() const {
         info.inputExclusive = inputStream_->getSharingMode() == oboe::SharingMode::Exclusive;
         info.inputLowLatency = inputStream_->getPerformanceMode() == oboe::PerformanceMode::LowLatency;
     }
+    info.inputZeroFilledFrames = drift_.zeroFilledFrames();
+    info.inputSlippedFrames = drift_.slippedFrames();
+    info.inputDiscardedFrames = drift_.discardedFrames();
     return info;
 }
 
@@ -138,9 +229,94 @@ double AudioEngine::getLatencyMs() const {
     int32_t bufferSize = outputStream_->getBufferSizeInFrames();
     
     double latencyFrames = bufferSize + (framesWritten - framesRead);
+    latencyFrames += chain_.getAddedLatencyFrames();  // pipelined chain mode
+    latencyFrames += blockAdapter_.latencyFrames();   // fixed-block FIFO priming
     return (latencyFrames / sampleRate_) * 1000.0;
 }
 
+double AudioEngine::getRoundTripLatencyMs() const {
+    if (!outputStream_ || !inputStream_) {
+        return 0.0;
+    }
+    // A calibrated loopback measurement covers both streams and the input backlog;
+    // only the delay we add on top of the streams comes on top.
+    const int32_t measured = measuredRoundTripFrames_.load();
+    if (measured > 0) {
+        const double frames = measured + chain_.getAddedLatencyFrames() + blockAdapter_.latencyFrames();
+        return frames * 1000.0 / sampleRate_;
+    }
+    // Timestamp-based estimates where the API has them; buffer sizes otherwise.
+    auto outLatency = outputStream_->calculateLatencyMillis();
+    auto inLatency = inputStream_->calculateLatencyMillis();
+    double ms = (outLatency == oboe::Result::OK) ? outLatency.value() : getLatencyMs();
+    ms += (inLatency == oboe::Result::OK)
+              ? inLatency.value()
+              : inputStream_->getFramesPerBurst() * 1000.0 / sampleRate_;
+    // Input left waiting in the stream after each read, plus what we add on top of the streams.
+    double framesAdded = drift_.backlogFrames();
+    if (outLatency == oboe::Result::OK) {
+        framesAdded += chain_.getAddedLatencyFrames() + blockAdapter_.latencyFrames();
+    }
+    ms += framesAdded * 1000.0 / sampleRate_;
+    return ms;
+}
+
+bool AudioEngine::startLatencyCalibration() {
+    if (!isRunning_) {
+        LOGE("startLatencyCalibration: engine not running");
+        return false;
+    }
+    if (!calibrator_.prepare(sampleRate_)) {
+        LOGE("startLatencyCalibration: calibration already in progress");
+        return false;
+    }
+    wavPlaying_.store(false);  // the measurement needs the live input
+    calibrator_.start();
+    LOGI("Latency calibration started");
+    return true;
+}
+
+int32_t AudioEngine::pollLatencyCalibration() {
+    switch (calibrator_.state()) {
+        case LatencyCalibrator::State::Running:
+            return kCalibrationPending;
+        case LatencyCalibrator::State::Idle:
+            return kCalibrationFailed;
+        case LatencyCalibrator::State::Captured:
+            break;
+    }
+    float peakRatio = 0.0f;
+    const int32_t frames = calibrator_.analyze(&peakRatio);
+    if (frames < 0) {
+        LOGE("Latency calibration found no clear echo (peak ratio %.1f)", peakRatio);
+        return kCalibrationFailed;
+    }
+    measuredRoundTripFrames_.store(frames);
+    LOGI("Latency calibration: %d frames (%.2f ms), peak ratio %.1f",
+         frames, frames * 1000.0 / sampleRate_, peakRatio);
+    return frames;
+}
+
+int32_t AudioEngine::recordingAlignFrames() const {
+    // Re-amping a backing track through a hardware loop: the returning input lags what we
+    // played by the measured round trip. Otherwise the processed track lags the raw input
+    // by the delay we add between them.
+    if (wavPlaying_.load() && wavBypassChain_.load()) {
+        return -measuredRoundTripFrames_.load();
+    }
+    return static_cast<int32_t>(chain_.getAddedLatencyFrames() + blockAdapter_.latencyFrames());
+}
+
+bool AudioEngine::startRecording(const std::string& rawPath, const std::string& processedPath,
+                                 AudioRecorder::Format format) {
+    return recorder_.startRecording(rawPath, processedPath, sampleRate_, recordingAlignFrames(), format);
+}
+
+bool AudioEngine::saveLastSeconds(const std::string& rawPath, const std::string& processedPath, double seconds,
+                                  AudioRecorder::Format format) {
+    return recorder_.saveLastSeconds(rawPath, processedPath, seconds, recordingAlignFrames(), format);
+}
+
 float AudioEngine::getInputLevel() const {
     return inputPeakLevel_.load();
 }
@@ -180,41 +356,26 @@ bool AudioEngine::loadWav(const std::string& path) {
         return false;
     }
     wavPause();
-    std::vector<float> samples;
-    uint32_t fileRate = 44100;
-    uint32_t numChannels = 1;
-    if (!guitarrackcraft::readWavFile(path, samples, fileRate, numChannels)) {
+    if (!wavPlayer_.open(path, sampleRate_)) {
+        LOGE("loadWav: cannot stream %s", path.c_str());
         return false;
     }
-    // Convert to mono if stereo (samples are interleaved L,R,L,R,...)
-    std::vector<float> mono;
-    if (numChannels == 2) {
-        size_t numFrames = samples.size() / 2;
-        mono.resize(numFrames);
-        for (size_t i = 0; i < numFrames; ++i) {
-            mono[i] = (samples[i * 2] + samples[i * 2 + 1]) * 0.5f;
-        }
-    } else {
-        mono = std::move(samples);
-    }
-    wavBuffer_.clear();
-    resampleToEngineRate(mono, fileRate, wavBuffer_);
-    wavLengthFrames_ = wavBuffer_.size();
-    wavPositionFrames_.store(0);
     wavPlaying_.store(false);
-    LOGI("WAV loaded: %zu frames at %.0f Hz (from %u Hz)", wavLengthFrames_, sampleRate_, fileRate);
+    LOGI("WAV loaded: %zu frames at %.0f Hz (from %u Hz), streaming",
+         wavPlayer_.lengthFrames(), sampleRate_, wavPlayer_.fileSampleRate());
     return true;
 }
 
 void AudioEngine::unloadWav() {
     wavPlaying_.store(false);
-    wavBuffer_.clear();
-    wavLengthFrames_ = 0;
-    wavPositionFrames_.store(0);
+    wavPlayer_.close();
 }
 
 void AudioEngine::wavPlay() {
-    if (!wavBuffer_.empty()) {
+    if (wavPlayer_.isOpen()) {
+        if (wavPlayer_.atEnd()) {
+            wavPlayer_.seek(0);
+        }
         wavPlaying_.store(true);
     }
 }
@@ -224,21 +385,17 @@ void AudioEngine::wavPause() {
 }
 
 void AudioEngine::wavSeekToFrame(size_t frame) {
-    size_t end = wavLengthFrames_;
-    if (end > 0 && frame > end) {
-        frame = end;
-    }
-    wavPositionFrames_.store(frame);
+    wavPlayer_.seek(frame);
 }
 
 double AudioEngine::getWavDurationSec() const {
-    if (sampleRate_ <= 0.0f || wavLengthFrames_ == 0) return 0.0;
-    return static_cast<double>(wavLengthFrames_) / sampleRate_;
+    if (sampleRate_ <= 0.0f || wavPlayer_.lengthFrames() == 0) return 0.0;
+    return static_cast<double>(wavPlayer_.lengthFrames()) / sampleRate_;
 }
 
 double AudioEngine::getWavPositionSec() const {
     if (sampleRate_ <= 0.0f) return 0.0;
-    return static_cast<double>(wavPositionFrames_.load()) / sampleRate_;
+    return static_cast<double>(wavPlayer_.positionFrames()) / sampleRate_;
 }
 
 bool AudioEngine::isWavPlaying() const {
@@ -246,132 +403,164 @@ bool AudioEngine::isWavPlaying() const {
 }
 
 bool AudioEngine::isWavLoaded() const {
-    return !wavBuffer_.empty();
+    return wavPlayer_.isOpen();
 }
 
-
-void AudioEngine::resampleToEngineRate(const std::vector<float>& src,
-                                       uint32_t srcRate,
-                                       std::vector<float>& dst) {
-    if (src.empty() || sampleRate_ <= 0.0f) {
-        dst.clear();
+void AudioEngine::readDuplexInput(uint32_t numFrames) {
+    float* dst = inputBuffer_.data();
+    if (!inputStream_ || inputReadBuffer_.size() < numFrames + 1) {
+        std::memset(dst, 0, numFrames * sizeof(float));
         return;
     }
-    if (static_cast<float>(srcRate) == sampleRate_) {
-        dst = src;
+    float* scratch = inputReadBuffer_.data();
+    const int32_t scratchFrames = static_cast<int32_t>(inputReadBuffer_.size());
+
+    // Right after start: throw away whatever has piled up so input and output start in phase.
+    if (drift_.draining()) {
+        for (int i = 0; i < kMaxDrainReads; ++i) {
+            auto result = inputStream_->read(scratch, scratchFrames, 0);
+            if (result != oboe::Result::OK || result.value() < scratchFrames) break;
+        }
+        drift_.drained();
+        std::memset(dst, 0, numFrames * sizeof(float));
         return;
     }
-    double ratio = sampleRate_ / static_cast<double>(srcRate);
-    size_t outFrames = static_cast<size_t>(std::round(src.size() * ratio));
-    if (outFrames == 0) {
-        dst.clear();
-        return;
+
+    auto avail = inputStream_->getAvailableFrames();
+    const int32_t available = (avail == oboe::Result::OK) ? avail.value() : -1;
+
+    // A backlog far above the cushion (e.g. after a stall) is latency we would keep forever.
+    int32_t remaining = available;
+    uint32_t discard = drift_.framesToDiscard(numFrames, available);
+    while (discard > 0) {
+        const int32_t chunk = std::min(static_cast<int32_t>(discard), scratchFrames);
+        auto result = inputStream_->read(scratch, chunk, 0);
+        if (result != oboe::Result::OK || result.value() <= 0) break;
+        discard -= static_cast<uint32_t>(result.value());
+        remaining -= result.value();
     }
-    dst.resize(outFrames);
-    for (size_t i = 0; i < outFrames; ++i) {
-        double srcIdx = i / ratio;
-        size_t j = static_cast<size_t>(srcIdx);
-        float frac = static_cast<float>(srcIdx - j);
-        if (j + 1 >= src.size()) {
-            dst[i] = src[src.size() - 1];
-        } else {
-            dst[i] = src[j] * (1.0f - frac) + src[j + 1] * frac;
-        }
+
+    const uint32_t toRead = drift_.framesToRead(numFrames, remaining);
+    int32_t framesRead = 0;
+    auto result = inputStream_->read(scratch, static_cast<int32_t>(toRead), 0);
+    if (result == oboe::Result::OK) {
+        framesRead = result.value();
+    }
+    if (framesRead < static_cast<int32_t>(toRead)) {
+        drift_.recordShortRead(toRead - static_cast<uint32_t>(framesRead));
+        std::memset(scratch + framesRead, 0, (toRead - framesRead) * sizeof(float));
+    }
+    DriftCompensator::resample(scratch, toRead, dst, numFrames);
+}
+
+void AudioEngine::processChainBlock(void* context, const float* const* inputs,
+                                    float* const* outputs, uint32_t frames) {
+    auto* engine = static_cast<AudioEngine*>(context);
+    engine->deliverMidi(frames);
+    engine->chain_.process(inputs, outputs, frames);
+}
+
+void AudioEngine::deliverMidi(uint32_t frames) {
+    uint32_t count = 0;
+    MidiMessage msg;
+    while (count < kMaxHostEventsPerBlock && midiQueue_.pop(msg)) {
+        const uint32_t frame = MidiRouter::frameOffset(msg.timeNs, chainBlockNs_, frames, sampleRate_);
+        count += midiRouter_.route(msg, frame, hostEvents_ + count, kMaxHostEventsPerBlock - count);
     }
+    if (count > 0) chain_.deliverHostEvents(hostEvents_, count);
+    chainBlockNs_ += static_cast<int64_t>(frames * 1e9 / sampleRate_);
 }
 
 oboe::DataCallbackResult AudioEngine::onAudioReady(
     oboe::AudioStream* audioStream,
     void* audioData,
     int32_t numFrames) {
-    // Debug: log callback thread still active (rate-limited) to correlate with closeStreams() tid
-    {
-        static std::atomic<int> enterCount{0};
-        static auto lastEnterLog = std::chrono::steady_clock::now();
-        int c = enterCount++;
-        auto now = std::chrono::steady_clock::now();
-        if (c < 3 || std::chrono::duration<double>(now - lastEnterLog).count() >= 5.0) {
-            if (c >= 3) lastEnterLog = now;
-            LOGI("onAudioReady ENTER tid=%ld (callback thread, count=%d)", getTid(), c);
-        }
-    }
-    // Debug: log when callback bails due to shutdown (rate-limited)
+    SYSTEM_TRACE_SCOPE("onAudioReady");
+    // Quiescence handshake (quiesceCallback): in flight, under the epoch seen on entry
+    const uint32_t epoch = callbackEpoch_.load();
+    callbackAck_.store((epoch << 1) | 1u);
+    const oboe::DataCallbackResult result = renderCallback(audioStream, audioData, numFrames);
+    callbackAck_.store(epoch << 1, std::memory_order_release);
+    return result;
+}
+
+oboe::DataCallbackResult AudioEngine::renderCallback(
+    oboe::AudioStream* audioStream,
+    void* audioData,
+    int32_t numFrames) {
+    // Debug: callback thread still active, to correlate with closeStreams() tid
+    RT_TRACE_EVERY(4096, "AudioEngine", "onAudioReady enter tid", getTid());
     if (!isRunning_ || numFrames <= 0) {
-        static std::atomic<int> bailCount{0};
-        int c = bailCount++;
-        if (c < 5 || (c % 50 == 0)) {
-            LOGI("onAudioReady: bail tid=%ld !isRunning_=%d numFrames=%d (bail #%d)",
-                 getTid(), isRunning_ ? 0 : 1, numFrames, c);
-        }
+        RT_TRACE_EVERY(50, "AudioEngine", "onAudioReady bail tid/running/frames",
+                       getTid(), isRunning_ ? 1 : 0, numFrames);
         return oboe::DataCallbackResult::Continue;
     }
     // Only process when the output stream needs data (we do not set callback on input).
     if (audioStream != outputStream_.get()) {
         return oboe::DataCallbackResult::Continue;
     }
+    const auto callbackStart = std::chrono::steady_clock::now();
+
+    // Oboe may hand the callback to a new thread after a restart; place each one once.
+    static thread_local bool threadPlaced = false;
+    if (!threadPlaced) {
+        threadPlaced = true;
+        enableFlushToZero();
+        if (!applyThreadRole(ThreadRole::Audio)) {
+            RT_TRACE("AudioEngine", "callback priority boost refused tid", getTid());
+        }
+        callbackTid_.store(static_cast<int32_t>(getTid()), std::memory_order_release);
+        // Deep plugin calls then land on resident stack pages
+        rt_memory::prefaultStack(kStackPrefaultBytes, false);
+        memoryLocked_ = false;
+#if defined(GRC_RT_GUARD) && GRC_RT_GUARD
+        rt_guard::armThread();
+#endif
+    }
+
+    // Ensure buffers are large enough
+    bool grown = false;
+    if (inputBuffer_.size() < static_cast<size_t>(numFrames)) {
+        inputBuffer_.resize(numFrames);
+        inputReadBuffer_.resize(numFrames + 1);
+        grown = true;
+    }
+    if (outputBufferLeft_.size() < static_cast<size_t>(numFrames)) {
+        outputBufferLeft_.resize(numFrames);
+        outputBufferRight_.resize(numFrames);
+        grown = true;
+    }
+    const bool lockWanted = memoryLocking_.load(std::memory_order_relaxed);
+    if (lockWanted != memoryLocked_ || (lockWanted && grown)) {
+        lockCallbackMemory(lockWanted);
+    }
 
     // Input source: WAV playback or microphone
-    const bool useWav = wavPlaying_.load() && !wavBuffer_.empty();
+    const bool useWav = wavPlaying_.load() && wavPlayer_.isOpen();
     if (useWav) {
-        size_t pos = wavPositionFrames_.load();
-        size_t len = wavLengthFrames_;
-        size_t toCopy = std::min(static_cast<size_t>(numFrames), len > pos ? len - pos : 0);
-        if (toCopy > 0) {
-            std::memcpy(inputBuffer_.data(), wavBuffer_.data() + pos, toCopy * sizeof(float));
-            wavPositionFrames_.store(pos + toCopy);
-        }
-        if (toCopy < static_cast<size_t>(numFrames)) {
-            std::memset(inputBuffer_.data() + toCopy, 0, (numFrames - toCopy) * sizeof(float));
+        wavPlayer_.read(inputBuffer_.data(), static_cast<size_t>(numFrames));
+        if (wavPlayer_.atEnd()) {
             wavPlaying_.store(false);
         }
     } else {
-        int32_t framesRead = 0;
-        if (inputStream_) {
-            auto result = inputStream_->read(inputBuffer_.data(), numFrames, 0);
-            if (result == oboe::Result::OK) {
-                framesRead = result.value();
-            }
-        }
-        if (framesRead < numFrames) {
-            std::memset(inputBuffer_.data() + framesRead, 0, (numFrames - framesRead) * sizeof(float));
-        }
+        readDuplexInput(static_cast<uint32_t>(numFrames));
     }
 
     // Input peak metering and clipping
-    float inputPeak = 0.0f;
-    bool inputClip = false;
-    for (int32_t i = 0; i < numFrames; ++i) {
-        float s = std::fabs(inputBuffer_[i]);
-        if (s > inputPeak) inputPeak = s;
-        if (s >= kClippingThreshold) inputClip = true;
-    }
+    const float inputPeak = kernels::peakAbs(inputBuffer_.data(), numFrames);
     inputPeakHold_ = std::max(inputPeak, inputPeakHold_ * kPeakDecay);
     inputPeakLevel_.store(inputPeakHold_);
-    if (inputClip) inputClipping_.store(true);
-
-    // Rate-limited debug: input source and level (once per second)
-    {
-        static auto lastLog = std::chrono::steady_clock::now();
-        auto now = std::chrono::steady_clock::now();
-        if (std::chrono::duration<double>(now - lastLog).count() >= 1.0) {
-            lastLog = now;
-            LOGI("onAudioReady: source=%s numFrames=%d inputPeak=%.4f",
-                 useWav ? "WAV" : "mic", numFrames, inputPeak);
-        }
-    }
+    if (inputPeak >= kClippingThreshold) inputClipping_.store(true);
 
-    // Ensure buffers are large enough
-    if (inputBuffer_.size() < static_cast<size_t>(numFrames)) {
-        inputBuffer_.resize(numFrames);
-    }
-    if (outputBufferLeft_.size() < static_cast<size_t>(numFrames)) {
-        outputBufferLeft_.resize(numFrames);
-        outputBufferRight_.resize(numFrames);
-    }
+    RT_TRACE_EVERY(kTraceEveryCallbacks, "AudioEngine", "onAudioReady wav/frames/inputPeak",
+                   useWav ? 1 : 0, numFrames, inputPeak);
 
     // Set up input pointers (mono guitar input -> stereo)
     inputPtrs_[0] = inputBuffer_.data();
     inputPtrs_[1] = inputBuffer_.data();  // Duplicate mono to stereo
+    if (analysis_.source() == AnalysisTap::kInput) {
+        analysis_.write(inputBuffer_.data(), static_cast<uint32_t>(numFrames));
+    }
 
     // Set up output pointers (always process into our buffers for metering)
     float* outputData = static_cast<float*>(audioData);
@@ -379,67 +568,274 @@ oboe::DataCallbackResult AudioEngine::onAudioReady(
     outputPtrs_[0] = outputBufferLeft_.data();
     outputPtrs_[1] = outputBufferRight_.data();
 
-    // Skip chain processing when bypassed (during preset load) or WAV bypass active
-    if (chainBypass_.load() || (useWav && wavBypassChain_.load())) {
+    // Calibration owns the output while it runs; otherwise skip the chain when WAV bypass is active
+    const bool calibrating = calibrator_.state() == LatencyCalibrator::State::Running;
+    if (calibrating) {
+        calibrator_.process(inputPtrs_[0], outputPtrs_[0], static_cast<uint32_t>(numFrames));
+        std::memcpy(outputPtrs_[1], outputPtrs_[0], numFrames * sizeof(float));
+    } else if (useWav && wavBypassChain_.load()) {
         for (int32_t ch = 0; ch < 2; ++ch) {
             std::memcpy(outputPtrs_[ch], inputPtrs_[ch],
                         numFrames * sizeof(float));
         }
     } else {
-        // Process through plugin chain (measure CPU time)
-        double bufferDurationMs = (numFrames / static_cast<double>(sampleRate_)) * 1000.0;
-        auto t0 = std::chrono::high_resolution_clock::now();
-        chain_.process(inputPtrs_, outputPtrs_, numFrames);
-        auto t1 = std::chrono::high_resolution_clock::now();
-        double processMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
-        float load = static_cast<float>(processMs / bufferDurationMs);
-        if (load > 1.0f) load = 1.0f;
-        cpuLoad_.store(load);
-    }
-
-    // Output peak metering (from buffers we wrote to)
-    float outputPeak = 0.0f;
-    bool outputClip = false;
-    for (int32_t i = 0; i < numFrames; ++i) {
-        float s = std::max(std::fabs(outputBufferLeft_[i]), std::fabs(outputBufferRight_[i]));
-        if (s > outputPeak) outputPeak = s;
-        if (s >= kClippingThreshold) outputClip = true;
+        chainBlockNs_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            callbackStart.time_since_epoch()).count();
+        SYSTEM_TRACE_SCOPE("PluginChain");
+        blockAdapter_.process(inputPtrs_, outputPtrs_, static_cast<uint32_t>(numFrames),
+                              &AudioEngine::processChainBlock, this);
     }
-    outputPeakHold_ = std::max(outputPeak, outputPeakHold_ * kPeakDecay);
-    outputPeakLevel_.store(outputPeakHold_);
-    if (outputClip) outputClipping_.store(true);
 
-    // Feed recorder (lock-free ring buffer write)
-    if (recorder_.isRecording()) {
+    // Feed recorder and pre-roll history (lock-free ring writes)
+    if (!calibrating) {
         recorder_.feedAudio(inputBuffer_.data(),
                             outputBufferLeft_.data(),
                             outputBufferRight_.data(),
                             numFrames);
     }
 
-    // Rate-limited debug: output level (once per second)
-    {
-        static auto lastLogOut = std::chrono::steady_clock::now();
-        auto now = std::chrono::steady_clock::now();
-        if (std::chrono::duration<double>(now - lastLogOut).count() >= 1.0) {
-            lastLogOut = now;
-            LOGI("onAudioReady: outputPeak=%.4f", outputPeak);
+    // Copy to output (stereo: interleave; mono: mix), metering the output in the same pass
+    float outputPeak;
+    if (numChannels == 2) {
+        outputPeak = kernels::interleaveStereoPeak(outputBufferLeft_.data(), outputBufferRight_.data(),
+                                                   outputData, numFrames);
+    } else {
+        outputPeak = kernels::mixToMonoPeak(outputBufferLeft_.data(), outputBufferRight_.data(),
+                                            outputData, numFrames);
+    }
+    outputPeakHold_ = std::max(outputPeak, outputPeakHold_ * kPeakDecay);
+    outputPeakLevel_.store(outputPeakHold_);
+    if (outputPeak >= kClippingThreshold) outputClipping_.store(true);
+
+    RT_TRACE_EVERY(kTraceEveryCallbacks, "AudioEngine", "onAudioReady outputPeak", outputPeak);
+
+    // The only clock pair on the audio thread: feeds both the CPU meter and the histograms.
+    const auto callbackEnd = std::chrono::steady_clock::now();
+    const int64_t startNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(callbackStart.time_since_epoch()).count();
+    const int64_t endNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(callbackEnd.time_since_epoch()).count();
+    const double bufferDurationNs = numFrames * 1e9 / static_cast<double>(sampleRate_);
+    const float cpuLoad = static_cast<float>(std::min(1.0, (endNs - startNs) / bufferDurationNs));
+    cpuLoad_.store(cpuLoad);
+    SYSTEM_TRACE_COUNTER("audio.callbackUs", (endNs - startNs) / 1000);
+    if (PerformanceHintSession* hint = activeHint_.load(std::memory_order_acquire)) {
+        hint->reportActual(endNs - startNs);
+    }
+    callbackStats_.record(startNs, endNs, static_cast<uint32_t>(numFrames), sampleRate_);
+    shedder_.record(cpuLoad);
+
+    if (TelemetryBlock* telemetry = telemetry_.load(std::memory_order_acquire)) {
+        publishTelemetry(*telemetry, audioStream, cpuLoad);
+    }
+
+    return oboe::DataCallbackResult::Continue;
+}
+
+void AudioEngine::startPerformanceHints() {
+    if (!PerformanceHintSession::available()) {
+        LOGI("Performance hints unavailable on this OS");
+        return;
+    }
+    stopPerformanceHints();
+    callbackTid_.store(0);
+    hintRunning_.store(true);
+    hintThread_ = std::thread(&AudioEngine::performanceHintLoop, this);
+}
+
+void AudioEngine::stopPerformanceHints() {
+    hintRunning_.store(false);
+    if (hintThread_.joinable()) {
+        hintThread_.join();
+    }
+}
+
+void AudioEngine::startLoadShedding() {
+    stopLoadShedding();
+    shedRunning_.store(true);
+    shedThread_ = std::thread(&AudioEngine::loadShedLoop, this);
+}
+
+void AudioEngine::stopLoadShedding() {
+    shedRunning_.store(false);
+    if (shedThread_.joinable()) {
+        shedThread_.join();
+    }
+}
+
+void AudioEngine::loadShedLoop() {
+    applyThreadRole(ThreadRole::Background);
+    shedder_.reset();
+    uint32_t applied = LoadShedder::kNormal;
+    while (shedRunning_.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(kShedPollMs));
+        if (!isRunning_) continue;
+        const int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        const uint32_t level = shedder_.update(nowNs);
+        if (level != applied) {
+            LOGI("Load shedding level %u -> %u", applied, level);
+            applyLoadShedding(level);
+            applied = level;
         }
+#if defined(GRC_RT_GUARD) && GRC_RT_GUARD
+        for (const auto& offender : rt_guard::takeOffenders()) {
+            LOGE("RT guard: %s called%s%s%s on the audio thread (%u calls so far)", offender.owner,
+                 (offender.kinds & rt_guard::kMalloc) ? " malloc" : "",
+                 (offender.kinds & rt_guard::kFree) ? " free" : "",
+                 (offender.kinds & rt_guard::kMutexLock) ? " pthread_mutex_lock" : "",
+                 offender.count);
+        }
+#endif
     }
+    applyLoadShedding(LoadShedder::kNormal);
+}
 
-    // Copy to output (stereo: deinterleave; mono: mix)
-    if (numChannels == 2) {
-        for (int32_t i = 0; i < numFrames; ++i) {
-            outputData[i * 2] = outputBufferLeft_[i];
-            outputData[i * 2 + 1] = outputBufferRight_[i];
+bool AudioEngine::setMemoryLocking(bool locked) {
+    memoryLocking_.store(locked);
+    return chain_.setMemoryLocking(locked);
+}
+
+bool AudioEngine::setAnalysisSource(int32_t source) {
+    const bool tapSlot = source >= 0;
+    if (!chain_.setAnalysisTap(tapSlot ? source : -1, tapSlot ? analysis_.ring() : nullptr)) {
+        return false;
+    }
+    analysis_.setSampleRate(sampleRate_);
+    analysis_.setSource(tapSlot || source == AnalysisTap::kInput ? source : AnalysisTap::kOff);
+    return true;
+}
+
+bool AudioEngine::openMidiInput(JNIEnv* env, jobject device, int32_t portNumber) {
+    return midiInput_.open(env, device, portNumber);
+}
+
+void AudioEngine::closeMidiInput() {
+    midiInput_.close();
+    if (uint32_t dropped = midiInput_.droppedMessages()) {
+        LOGI("closeMidiInput: %u messages dropped on a full queue", dropped);
+    }
+}
+
+void AudioEngine::lockCallbackMemory(bool locked) {
+    // Audio thread, once per toggle or growth: a few mlock calls, no allocation
+    auto apply = [locked](const std::vector<float>& buffer) {
+        if (locked) {
+            rt_memory::lock(buffer.data(), buffer.size() * sizeof(float));
+        } else {
+            rt_memory::unlock(buffer.data(), buffer.size() * sizeof(float));
         }
-    } else {
-        for (int32_t i = 0; i < numFrames; ++i) {
-            outputData[i] = (outputBufferLeft_[i] + outputBufferRight_[i]) * 0.5f;
+    };
+    apply(inputBuffer_);
+    apply(inputReadBuffer_);
+    apply(outputBufferLeft_);
+    apply(outputBufferRight_);
+    // The stack stays pinned until the thread exits; unlocking one frame's view of it would
+    // be guesswork
+    if (locked) rt_memory::prefaultStack(kStackPrefaultBytes, true);
+    memoryLocked_ = locked;
+}
+
+void AudioEngine::applyLoadShedding(uint32_t level) {
+    uint32_t actions = 0;
+    if (level >= LoadShedder::kCheapQuality) actions |= TelemetryBlock::kShedQuality;
+    if (level >= LoadShedder::kFastSleep) actions |= TelemetryBlock::kShedFastSleep;
+    if (level >= LoadShedder::kSlowUi) actions |= TelemetryBlock::kShedSlowUi;
+    if (level >= LoadShedder::kLargeBuffer) actions |= TelemetryBlock::kShedLargeBuffer;
+    const uint32_t changed = actions ^ shedActions_.load(std::memory_order_relaxed);
+    if (changed == 0) return;
+
+    if (changed & TelemetryBlock::kShedQuality) {
+        chain_.setQualityShed((actions & TelemetryBlock::kShedQuality) != 0);
+    }
+    if (changed & TelemetryBlock::kShedFastSleep) {
+        chain_.setFastSleep((actions & TelemetryBlock::kShedFastSleep) != 0);
+    }
+    if ((changed & TelemetryBlock::kShedLargeBuffer) && outputStream_) {
+        // More latency, but a late callback no longer underruns the device
+        if (actions & TelemetryBlock::kShedLargeBuffer) {
+            shedBufferFrames_ = outputStream_->getBufferSizeInFrames();
+            const int32_t frames =
+                std::min(outputStream_->getBufferCapacityInFrames(), shedBufferFrames_ * 2);
+            auto result = outputStream_->setBufferSizeInFrames(frames);
+            LOGI("Load shedding: output buffer %d -> %d frames", shedBufferFrames_,
+                 result ? result.value() : -1);
+        } else if (shedBufferFrames_ > 0) {
+            outputStream_->setBufferSizeInFrames(shedBufferFrames_);
+            LOGI("Load shedding: output buffer back to %d frames", shedBufferFrames_);
+            shedBufferFrames_ = 0;
         }
     }
+    shedActions_.store(actions, std::memory_order_relaxed);
+    if (shedListener_) shedListener_(actions);
+}
 
-    return oboe::DataCallbackResult::Continue;
+void AudioEngine::performanceHintLoop() {
+    applyThreadRole(ThreadRole::Background);
+    std::vector<int32_t> tids;
+    while (hintRunning_.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(kHintPollMs));
+        const int32_t callbackTid = callbackTid_.load(std::memory_order_acquire);
+        if (callbackTid == 0 || !isRunning_) continue;
+
+        // The deadline is one callback period; the workers share it with the callback.
+        std::vector<int32_t> next{callbackTid};
+        for (int32_t tid : chain_.getWorkerThreadIds()) next.push_back(tid);
+        const int64_t targetNs = static_cast<int64_t>(
+            std::max(1u, nominalCallbackFrames_) * 1e9 / static_cast<double>(sampleRate_));
+
+        if (!hintSession_.isOpen()) {
+            if (hintSession_.open(next, targetNs)) {
+                tids = next;
+                activeHint_.store(&hintSession_, std::memory_order_release);
+                LOGI("Performance hint session: %zu threads, target %lld us",
+                     tids.size(), static_cast<long long>(targetNs / 1000));
+            }
+            continue;
+        }
+        hintSession_.updateTarget(targetNs);
+        if (next != tids) {
+            if (!hintSession_.setThreads(next)) {
+                // Pre-34: reopen, after taking the session away from the callback.
+                activeHint_.store(nullptr, std::memory_order_release);
+                std::this_thread::sleep_for(std::chrono::milliseconds(kHintPollMs));
+                hintSession_.open(next, targetNs);
+                if (hintSession_.isOpen()) activeHint_.store(&hintSession_, std::memory_order_release);
+            }
+            tids = next;
+        }
+    }
+    activeHint_.store(nullptr, std::memory_order_release);
+    // stop() calls us after the streams (and so the callback) are gone.
+    hintSession_.close();
+}
+
+void AudioEngine::publishTelemetry(TelemetryBlock& block, oboe::AudioStream* stream,
+                                   float cpuLoad) {
+    // The xrun counter and current core are syscalls; a few times a second is plenty
+    if (telemetryCallbacks_ % kXRunPollCallbacks == 0) {
+        auto xruns = stream->getXRunCount();
+        if (xruns) telemetryXRuns_ = xruns.value();
+        telemetryCpu_ = currentCpu();
+        SYSTEM_TRACE_COUNTER("audio.xruns", telemetryXRuns_);
+    }
+    ++telemetryCallbacks_;
+
+    TelemetryBlock::Layout& t = block.beginWrite();
+    t.callbacks = telemetryCallbacks_;
+    t.flags = (inputClipping_.load(std::memory_order_relaxed) ? TelemetryBlock::kInputClipping : 0u) |
+              (outputClipping_.load(std::memory_order_relaxed) ? TelemetryBlock::kOutputClipping : 0u) |
+              (CpuTopology::system().isPerformanceCpu(telemetryCpu_) ? TelemetryBlock::kCallbackOnPerformanceCore : 0u) |
+              shedActions_.load(std::memory_order_relaxed);
+    t.inputLevel = inputPeakHold_;
+    t.outputLevel = outputPeakHold_;
+    t.cpuLoad = cpuLoad;
+    t.xruns = telemetryXRuns_;
+    t.callbackCpu = telemetryCpu_;
+    t.numPlugins = chain_.readOutputControls(t.outputControlCounts, TelemetryBlock::kMaxPlugins,
+                                             t.outputControls,
+                                             TelemetryBlock::kMaxOutputControls);
+    block.endWrite();
 }
 
 void AudioEngine::onErrorBeforeClose(oboe::AudioStream* oboeStream, oboe::Result error) {
@@ -458,7 +854,7 @@ void AudioEngine::onErrorAfterClose(oboe::AudioStream* oboeStream, oboe::Result
     // the audio callback thread may still be inside Oboe -> pthread_mutex_lock on
     // destroyed mutex (SIGABRT). Leave the stream object alive; stop() -> closeStreams()
     // will run later (from lifecycle or user) and destroy it on the main thread after
-    // the 250ms sleep, when the callback thread is guaranteed idle.
+    // the callback handshake, when the callback thread is guaranteed idle.
 }
 
 bool AudioEngine::createAudioStreams(float sampleRate) {
@@ -511,6 +907,7 @@ bool AudioEngine::createAudioStreams(float sampleRate) {
 
     // Use actual sample rate from stream
     sampleRate_ = static_cast<float>(inputStream_->getSampleRate());
+    analysis_.setSampleRate(sampleRate_);
 
     // --- Output stream (stereo) ---
     oboe::AudioStreamBuilder outputBuilder;
@@ -550,55 +947,52 @@ bool AudioEngine::createAudioStreams(float sampleRate) {
          oboe::OboeExtensions::isMMapUsed(outputStreamPtr));
 
     // Determine callback block size.
-    // If the user requested a specific buffer size, use it directly.
-    // Otherwise, ensure power-of-2 for convolver plugin compatibility.
-    {
-        if (requestedBufferFrames_ > 0) {
-            callbackFrameCount_ = static_cast<uint32_t>(requestedBufferFrames_);
-            LOGI("Using user-requested buffer frames: %u", callbackFrameCount_);
-            outputStreamPtr->close();
-            delete outputStreamPtr;
-            outputStreamPtr = nullptr;
-
-            outputBuilder.setFramesPerCallback(requestedBufferFrames_);
-            result = outputBuilder.openStream(&outputStreamPtr);
-            if (result != oboe::Result::OK) {
-                LOGE("Failed to reopen output stream with requested buffer: %s",
-                     oboe::convertToText(result));
-                closeStreams();
-                return false;
-            }
-        } else {
-            int32_t framesPerBurst = outputStreamPtr->getFramesPerBurst();
-            uint32_t po2 = 1;
-            while (po2 < static_cast<uint32_t>(framesPerBurst)) po2 <<= 1;
-            callbackFrameCount_ = po2;
-
-            bool isPo2 = (framesPerBurst > 0) &&
-                          ((framesPerBurst & (framesPerBurst - 1)) == 0);
-            if (!isPo2) {
-                LOGI("framesPerBurst=%d not power-of-2, reopening with framesPerCallback=%u",
-                     framesPerBurst, po2);
-                outputStreamPtr->close();
-                delete outputStreamPtr;
-                outputStreamPtr = nullptr;
-
-                outputBuilder.setFramesPerCallback(static_cast<int32_t>(po2));
-                result = outputBuilder.openStream(&outputStreamPtr);
-                if (result != oboe::Result::OK) {
-                    LOGE("Failed to reopen output stream with po2 callback: %s",
-                         oboe::convertToText(result));
-                    closeStreams();
-                    return false;
-                }
-            } else {
-                LOGI("framesPerBurst=%d already power-of-2", framesPerBurst);
-            }
+    // If the user requested a specific buffer size, ask for it. Otherwise leave
+    // framesPerCallback unspecified so the stream keeps its native burst (the
+    // lowest-latency path); blockAdapter_ hands the chain power-of-2 blocks either way.
+    uint32_t nominalCallbackFrames = 0;
+    if (requestedBufferFrames_ > 0) {
+        LOGI("Using user-requested buffer frames: %d", requestedBufferFrames_);
+        outputStreamPtr->close();
+        delete outputStreamPtr;
+        outputStreamPtr = nullptr;
+
+        outputBuilder.setFramesPerCallback(requestedBufferFrames_);
+        result = outputBuilder.openStream(&outputStreamPtr);
+        if (result != oboe::Result::OK) {
+            LOGE("Failed to reopen output stream with requested buffer: %s",
+                 oboe::convertToText(result));
+            closeStreams();
+            return false;
         }
+        nominalCallbackFrames = static_cast<uint32_t>(requestedBufferFrames_);
+    } else {
+        nominalCallbackFrames = static_cast<uint32_t>(std::max(1, outputStreamPtr->getFramesPerBurst()));
     }
 
+    callbackFrameCount_ = FixedBlockAdapter::chooseBlockFrames(nominalCallbackFrames);
+    // Callbacks are normally one burst but may be as large as the whole buffer.
+    const uint32_t maxCallbackFrames = std::max(
+        nominalCallbackFrames, static_cast<uint32_t>(std::max(0, outputStreamPtr->getBufferCapacityInFrames())));
+    blockAdapter_.configure(callbackFrameCount_, nominalCallbackFrames, maxCallbackFrames);
+    nominalCallbackFrames_ = nominalCallbackFrames;
+    LOGI("Callback frames %u -> chain block %u, adapter latency %u frames",
+         nominalCallbackFrames, callbackFrameCount_, blockAdapter_.latencyFrames());
+
+    // Allocate buffers before the first callback, for the largest callback the stream can make
+    inputBuffer_.resize(maxCallbackFrames);
+    inputReadBuffer_.resize(maxCallbackFrames + 1);  // +1 for a drift slip
+    outputBufferLeft_.resize(maxCallbackFrames);
+    outputBufferRight_.resize(maxCallbackFrames);
+
     outputStream_.reset(outputStreamPtr);
 
+    // Hold one input burst of backlog; anything steadier than that is drift.
+    drift_.configure(static_cast<uint32_t>(std::max(1, inputStream_->getFramesPerBurst())));
+
+    // The callback feeds the pre-roll history from its first block
+    recorder_.preparePreRoll(preRollSeconds_.load(), sampleRate_);
+
     // Start streams
     result = inputStream_->requestStart();
     if (result != oboe::Result::OK) {
@@ -614,15 +1008,31 @@ bool AudioEngine::createAudioStreams(float sampleRate) {
         return false;
     }
 
-    // Allocate buffers
-    int32_t bufferSize = outputStream_->getBufferSizeInFrames();
-    inputBuffer_.resize(bufferSize);
-    outputBufferLeft_.resize(bufferSize);
-    outputBufferRight_.resize(bufferSize);
+    LOGI("Audio streams created: %d Hz, buffer size: %d frames",
+         static_cast<int>(sampleRate_), outputStream_->getBufferSizeInFrames());
 
-    LOGI("Audio streams created: %d Hz, buffer size: %d frames", 
-         static_cast<int>(sampleRate_), bufferSize);
+    return true;
+}
 
+bool AudioEngine::quiesceCallback() {
+    // Seq-cst on both sides: a callback whose entry this thread does not see will see
+    // isRunning_ == false (stored before the epoch), and one that sees the new epoch
+    // has also seen it, so either way it returns without touching the chain or buffers.
+    const uint32_t epoch = (callbackEpoch_.load() + 1) & kEpochMask;
+    callbackEpoch_.store(epoch);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kQuiesceTimeoutMs);
+    int polls = 0;
+    for (;;) {
+        const uint32_t ack = callbackAck_.load();
+        if (!(ack & 1u) || (ack >> 1) == epoch) break;
+        if (std::chrono::steady_clock::now() > deadline) {
+            LOGE("quiesceCallback() callback still running after %d ms", kQuiesceTimeoutMs);
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(kQuiescePollUs));
+        ++polls;
+    }
+    if (polls > 0) LOGI("quiesceCallback() callback returned after %d polls", polls);
     return true;
 }
 
@@ -632,7 +1042,11 @@ void AudioEngine::closeStreams() {
     // First, signal the callback to stop immediately to prevent new callbacks
     // from starting while we're tearing down.
     isRunning_.store(false);
-    
+    quiesceCallback();
+#if defined(GRC_RT_GUARD) && GRC_RT_GUARD
+    rt_guard::disarm();
+#endif
+
     if (inputStream_) {
         LOGI("closeStreams() input stream stop+close+reset");
         inputStream_->stop();
@@ -650,14 +1064,15 @@ void AudioEngine::closeStreams() {
         // so late callbacks will see !isStreamAlive and return Stop. If we reset()
         // too soon, ~AudioStreamAAudio / ~AAudioLoader run while the AudioTrack
         // thread is still in getStream() -> destroyed mutex (SIGABRT).
-        // 
-        // INCREASED from 250ms to 500ms: The 250ms delay was not sufficient on some
-        // devices (e.g., OnePlus) where the audio callback thread takes longer to
-        // fully exit, especially when the app is being force-closed or when there
-        // are concurrent EGL/GL operations that may interfere with the audio subsystem.
-        static constexpr int kStreamCloseSleepMs = 500;
-        LOGI("closeStreams() sleep %dms before outputStream_.reset() [tid=%ld]", kStreamCloseSleepMs, getTid());
-        std::this_thread::sleep_for(std::chrono::milliseconds(kStreamCloseSleepMs));
+        //
+        // This used to be a fixed 500 ms sleep (250 ms was not enough on some OnePlus
+        // devices). The handshake says when onAudioReady has returned; Oboe's trampoline
+        // around it gets one more callback period.
+        quiesceCallback();
+        if (sampleRate_ > 0.0f) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(static_cast<int64_t>(
+                std::max(1u, nominalCallbackFrames_) * 1e9 / static_cast<double>(sampleRate_))));
+        }
         LOGI("closeStreams() outputStream_.reset() NOW tid=%ld", getTid());
         outputStream_.reset();
         LOGI("closeStreams() output stream destroyed tid=%ld", getTid());
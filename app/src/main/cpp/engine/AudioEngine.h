@@ -21,12 +21,28 @@
 #define GUITARRACKCRAFT_AUDIO_ENGINE_H
 
 #include <oboe/Oboe.h>
+#include <algorithm>
 #include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include "plugin/PluginChain.h"
+#include "AnalysisTap.h"
 #include "AudioRecorder.h"
+#include "CallbackStats.h"
+#include "LoadShedder.h"
+#include "MidiInput.h"
+#include "MidiRouter.h"
+#include "WavStreamPlayer.h"
+#include "utils/DriftCompensator.h"
+#include "utils/FixedBlockAdapter.h"
+#include "utils/LatencyCalibrator.h"
+#include "utils/PerformanceHint.h"
+#include "utils/SpscQueue.h"
+#include "utils/TelemetryBlock.h"
 
 namespace guitarrackcraft {
 
@@ -52,6 +68,15 @@ public:
      */
     void stop();
 
+    /**
+     * Switch devices, sample rate or buffer size while running: only the streams are reopened,
+     * and plugins are reactivated only if the sample rate or chain block changes, so
+     * convolvers keep their IRs. Starts the engine if it is stopped. Returns false (engine
+     * stopped) if the new streams cannot be opened.
+     */
+    bool reconfigure(float sampleRate, int32_t inputDeviceId, int32_t outputDeviceId,
+                     int32_t bufferFrames);
+
     /**
      * Check if engine is running.
      */
@@ -82,6 +107,9 @@ public:
         bool outputMMap = false;       // MMAP used (lowest path)
         bool outputCallback = true;    // Using data callback
         int32_t framesPerBurst = 0;    // Hardware burst size
+        uint64_t inputZeroFilledFrames = 0;  // Input frames missing at read time (silence inserted)
+        uint64_t inputSlippedFrames = 0;     // One-frame drift corrections
+        uint64_t inputDiscardedFrames = 0;   // Surplus backlog thrown away
     };
 
     /**
@@ -94,6 +122,51 @@ public:
      */
     double getLatencyMs() const;
 
+    /**
+     * Estimated input-to-output latency in milliseconds: both streams' own latency
+     * (from timestamps when available) plus input backlog, chain and block adapter delay.
+     */
+    double getRoundTripLatencyMs() const;
+
+    // --- Round-trip latency calibration ---
+
+    static constexpr int32_t kCalibrationFailed = -1;
+    static constexpr int32_t kCalibrationPending = -2;
+
+    /**
+     * Play an MLS burst and listen for it on the input (loopback cable or acoustic).
+     * The chain is bypassed for the ~0.6 s the measurement takes. Engine must be running.
+     */
+    bool startLatencyCalibration();
+
+    /**
+     * Finish a calibration once captured: returns the measured input-to-output
+     * latency in frames (and adopts it), kCalibrationPending while still capturing,
+     * or kCalibrationFailed if no clear echo was found or none is in progress.
+     */
+    int32_t pollLatencyCalibration();
+
+    /** Adopt a previously stored measurement for the current device pair and buffer size (0 = none). */
+    void setMeasuredRoundTripFrames(int32_t frames) { measuredRoundTripFrames_.store(std::max(0, frames)); }
+    int32_t getMeasuredRoundTripFrames() const { return measuredRoundTripFrames_.load(); }
+
+    /**
+     * Start recording raw and processed tracks aligned for re-amping (see AudioRecorder).
+     */
+    bool startRecording(const std::string& rawPath, const std::string& processedPath,
+                        AudioRecorder::Format format = AudioRecorder::Format::Pcm16);
+
+    /**
+     * Retroactive capture: save the last `seconds` of both tracks from the always-on
+     * pre-roll history, aligned like startRecording(). Written on a background thread.
+     */
+    bool saveLastSeconds(const std::string& rawPath, const std::string& processedPath, double seconds,
+                         AudioRecorder::Format format = AudioRecorder::Format::Pcm16);
+
+    /** Pre-roll history length (0 = off); the buffer is reallocated at the next engine start. */
+    void setPreRollSeconds(float seconds) { preRollSeconds_.store(std::max(0.0f, seconds)); }
+    float getPreRollSeconds() const { return preRollSeconds_.load(); }
+
     /**
      * Get input peak level (0.0–1.0).
      */
@@ -114,6 +187,12 @@ public:
      */
     int32_t getXRunCount() const;
 
+    /**
+     * Callback wall-time vs deadline and inter-callback interval histograms.
+     */
+    CallbackStats::Snapshot getCallbackStats() const { return callbackStats_.read(); }
+    void resetCallbackStats() { callbackStats_.requestReset(); }
+
     /**
      * True if input has clipped (peak >= 0.99).
      */
@@ -129,12 +208,52 @@ public:
      */
     void resetClipping();
 
+    void setWavBypassChain(bool bypass) { wavBypassChain_.store(bypass); }
+
     /**
-     * Bypass chain processing (audio passthrough). Use during preset loading
-     * to prevent the audio thread from processing a partially-built chain.
+     * Publish meters, load, xruns and plugin output ports into 'block' once per callback
+     * (nullptr stops). The block must outlive the engine or be detached first.
      */
-    void setChainBypass(bool bypass) { chainBypass_.store(bypass); }
-    void setWavBypassChain(bool bypass) { wavBypassChain_.store(bypass); }
+    void setTelemetry(TelemetryBlock* block) {
+        telemetry_.store(block, std::memory_order_release);
+        analysis_.setTelemetry(block);
+    }
+
+    /**
+     * Tuner/spectrum/scope off the audio thread (AnalysisTap), published in the telemetry
+     * block's analysis section: AnalysisTap::kInput, a chain index (that plugin's output) or
+     * AnalysisTap::kOff. False if the index is out of range.
+     */
+    bool setAnalysisSource(int32_t source);
+
+    /**
+     * Load shedding (LoadShedder): while the callback runs close to its deadline the engine
+     * turns plugin quality controls down, lets silent slots sleep sooner, caps the UI frame
+     * rate and finally enlarges the output buffer, undoing each step once headroom returns.
+     * The actions in force are TelemetryBlock::kShed* flags. 'listener' is called on the
+     * shedding thread whenever they change, for the steps outside the engine (the X11 UI
+     * rate); set it before start().
+     */
+    void setLoadShedListener(std::function<void(uint32_t actions)> listener) {
+        shedListener_ = std::move(listener);
+    }
+    uint32_t getLoadShedActions() const { return shedActions_.load(std::memory_order_relaxed); }
+
+    /**
+     * RT memory residency: pin the chain's scratch and every plugin's host buffers in RAM, and
+     * pin the callback thread's stack (prefaulted on every new callback thread regardless).
+     * Best effort within RLIMIT_MEMLOCK. Returns false if a plugin's lock was refused.
+     */
+    bool setMemoryLocking(bool locked);
+
+    /**
+     * Native MIDI input: read output port 'portNumber' of an opened Java MidiDevice (see
+     * MidiInput). CCs and notes bound by MIDI learn drive controls and per-slot bypass; all
+     * other messages reach the chain's MIDI-capable plugins at their offset in the block.
+     */
+    bool openMidiInput(JNIEnv* env, jobject device, int32_t portNumber);
+    void closeMidiInput();
+    MidiRouter& getMidiRouter() { return midiRouter_; }
 
     /**
      * Get the audio recorder for real-time recording of raw input and processed output.
@@ -145,7 +264,8 @@ public:
 
     /**
      * Load a WAV file for playback. Engine must be running (sample rate known).
-     * Converts to mono and resamples to engine rate.
+     * The file is streamed from disk: mixed to mono and resampled to the engine
+     * rate by a background reader, so only a short ring is held in memory.
      * @return true on success
      */
     bool loadWav(const std::string& path);
@@ -181,9 +301,22 @@ private:
     int32_t inputDeviceId_ = 0;
     int32_t outputDeviceId_ = 0;
     int32_t requestedBufferFrames_ = 0;
-    uint32_t callbackFrameCount_ = 0;  // Power-of-2 frames per audio callback
-    std::atomic<bool> isRunning_;
-    std::atomic<bool> chainBypass_{false};  // skip chain processing (passthrough)
+    uint32_t callbackFrameCount_ = 0;  // Power-of-2 block the chain runs at (see blockAdapter_)
+    std::atomic<bool> isRunning_;  // callback gate; false also after a stream error
+
+    // Lifecycle: start/stop/reconfigure hold lifecycleMutex_ for their whole transition.
+    enum class State : uint8_t { Stopped, Running, Reconfiguring };
+    std::mutex lifecycleMutex_;
+    std::atomic<State> state_{State::Stopped};
+
+    // Callback quiescence handshake (see quiesceCallback): control threads bump
+    // callbackEpoch_; the callback stores (epoch << 1 | 1) in callbackAck_ on entry and
+    // (epoch << 1) on return.
+    std::atomic<uint32_t> callbackEpoch_{0};
+    std::atomic<uint32_t> callbackAck_{0};
+    static constexpr uint32_t kEpochMask = 0x7FFFFFFFu;
+    static constexpr int kQuiesceTimeoutMs = 500;
+    static constexpr int kQuiescePollUs = 200;
 
     // Audio buffers for processing
     std::vector<float> inputBuffer_;
@@ -194,31 +327,111 @@ private:
     const float* inputPtrs_[2];
     float* outputPtrs_[2];
 
+    // Full-duplex input: read from the output callback, held in step by drift_
+    std::vector<float> inputReadBuffer_;
+    DriftCompensator drift_;
+    static constexpr int kMaxDrainReads = 8;
+
+    // Round-trip latency measurement (bypasses the chain while running)
+    LatencyCalibrator calibrator_;
+    std::atomic<int32_t> measuredRoundTripFrames_{0};
+
+    // Re-blocks whatever the stream delivers into callbackFrameCount_ chain blocks
+    FixedBlockAdapter blockAdapter_;
+
     // Level metering and CPU (written from audio thread, read from UI)
     std::atomic<float> inputPeakLevel_{0.0f};
     std::atomic<float> outputPeakLevel_{0.0f};
     std::atomic<float> cpuLoad_{0.0f};
     std::atomic<bool> inputClipping_{false};
     std::atomic<bool> outputClipping_{false};
+    CallbackStats callbackStats_;
     float inputPeakHold_{0.0f};
     float outputPeakHold_{0.0f};
 
+    // Shared-memory telemetry for the UI (see TelemetryBlock); written by the audio thread
+    std::atomic<TelemetryBlock*> telemetry_{nullptr};
+    uint32_t telemetryCallbacks_ = 0;
+    int32_t telemetryXRuns_ = 0;
+    int32_t telemetryCpu_ = -1;
+
+    // ADPF: the callback reports each block's duration against the callback period.
+    // hintThread_ opens the session once the callback tid is known and keeps the
+    // chain worker threads in it; the callback only sees a published session.
+    PerformanceHintSession hintSession_;
+    std::atomic<PerformanceHintSession*> activeHint_{nullptr};
+    std::atomic<int32_t> callbackTid_{0};
+    std::atomic<bool> hintRunning_{false};
+    std::thread hintThread_;
+    uint32_t nominalCallbackFrames_ = 0;
+    static constexpr int kHintPollMs = 250;
+
+    // Load shedding: the callback feeds shedder_, shedThread_ polls it and applies the
+    // level's actions (applyLoadShedding); stopping undoes them.
+    LoadShedder shedder_;
+    std::atomic<bool> shedRunning_{false};
+    std::thread shedThread_;
+    std::atomic<uint32_t> shedActions_{0};
+    std::function<void(uint32_t)> shedListener_;
+    int32_t shedBufferFrames_ = 0;  // output buffer size before kShedLargeBuffer (shed thread)
+    static constexpr int kShedPollMs = 250;
+
+    // Memory residency: control threads set memoryLocking_; the callback pins its stack and
+    // the engine buffers when it differs from memoryLocked_ (audio thread only).
+    std::atomic<bool> memoryLocking_{false};
+    bool memoryLocked_ = false;
+    void lockCallbackMemory(bool locked);
+
+    AnalysisTap analysis_;
+
+    // MIDI: the input thread queues messages, processChainBlock() routes them into
+    // hostEvents_ for the chain. chainBlockNs_ is when the coming chain block starts
+    // (audio thread), the reference for each event's frame offset.
+    static constexpr uint32_t kMidiQueueSize = 1024;
+    static constexpr uint32_t kMaxHostEventsPerBlock = 256;
+    MidiRouter midiRouter_;
+    SpscQueue<MidiMessage> midiQueue_{kMidiQueueSize};
+    MidiInput midiInput_{midiRouter_, midiQueue_};
+    PluginChain::HostEvent hostEvents_[kMaxHostEventsPerBlock];
+    int64_t chainBlockNs_ = 0;
+    void deliverMidi(uint32_t frames);
+    static constexpr size_t kStackPrefaultBytes = 128 * 1024;
+    static constexpr uint32_t kXRunPollCallbacks = 64;
+
     static constexpr float kClippingThreshold = 0.99f;
     static constexpr float kPeakDecay = 0.95f;
 
     // WAV playback state (read in callback; written from load/seek/play/pause)
-    std::vector<float> wavBuffer_;
-    std::atomic<size_t> wavPositionFrames_{0};
+    WavStreamPlayer wavPlayer_;
     std::atomic<bool> wavPlaying_{false};
     std::atomic<bool> wavBypassChain_{true};  // true = WAV plays raw (backing track), false = through effects
-    size_t wavLengthFrames_{0};
 
     AudioRecorder recorder_;
+    std::atomic<float> preRollSeconds_{AudioRecorder::kDefaultPreRollSeconds};
 
+    bool startLocked(float sampleRate, int32_t inputDeviceId, int32_t outputDeviceId,
+                     int32_t bufferFrames);
+    oboe::DataCallbackResult renderCallback(oboe::AudioStream* audioStream, void* audioData,
+                                            int32_t numFrames);
+    /**
+     * After isRunning_ = false: wait until no callback that may have missed it is still
+     * inside onAudioReady. False if one did not return within kQuiesceTimeoutMs.
+     */
+    bool quiesceCallback();
     bool createAudioStreams(float sampleRate);
+    int32_t recordingAlignFrames() const;
+    void readDuplexInput(uint32_t numFrames);
+    static void processChainBlock(void* context, const float* const* inputs,
+                                  float* const* outputs, uint32_t frames);
+    void publishTelemetry(TelemetryBlock& block, oboe::AudioStream* stream, float cpuLoad);
     void closeStreams();
-    void resampleToEngineRate(const std::vector<float>& src, uint32_t srcRate,
-                              std::vector<float>& dst);
+    void startPerformanceHints();
+    void stopPerformanceHints();
+    void performanceHintLoop();
+    void startLoadShedding();
+    void stopLoadShedding();
+    void loadShedLoop();
+    void applyLoadShedding(uint32_t level);
 };
 
 } // namespace guitarrackcraft
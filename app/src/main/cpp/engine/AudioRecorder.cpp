@@ -18,10 +18,19 @@
  */
 
 #include "AudioRecorder.h"
+#include "utils/FlacStreamWriter.h"
+#include "utils/SystemTrace.h"
+#include "utils/ThreadPolicy.h"
+#include "utils/WavStreamWriter.h"
 #include <android/log.h>
 #include <algorithm>
-#include <cmath>
-#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <cstdint>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <vector>
 
 #define LOG_TAG "AudioRecorder"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -29,22 +38,76 @@
 
 namespace guitarrackcraft {
 
+namespace {
+
+// Upper bound on a writer sleep, in case a wakeup is lost (e.g. the eventfd counter saturated)
+constexpr int kWakeTimeoutMs = 500;
+
+// Frames copied out of the pre-roll history per step of a save
+constexpr size_t kSnapshotChunkFrames = 8192;
+
+const char* formatName(AudioRecorder::Format format) {
+    switch (format) {
+        case AudioRecorder::Format::Pcm16: return "pcm16";
+        case AudioRecorder::Format::Pcm24: return "pcm24";
+        case AudioRecorder::Format::Float32: return "float32";
+        case AudioRecorder::Format::Flac16: return "flac16";
+        case AudioRecorder::Format::Flac24: return "flac24";
+    }
+    return "?";
+}
+
+std::unique_ptr<AudioFileWriter> openWriter(const std::string& path, uint32_t rate, uint16_t channels,
+                                            AudioRecorder::Format format) {
+    if (format == AudioRecorder::Format::Flac16 || format == AudioRecorder::Format::Flac24) {
+        auto flac = std::make_unique<FlacStreamWriter>();
+        if (!flac->open(path, rate, channels, format == AudioRecorder::Format::Flac16 ? 16 : 24)) return nullptr;
+        return flac;
+    }
+    const auto wavFormat = format == AudioRecorder::Format::Pcm24   ? WavStreamWriter::Format::Pcm24
+                           : format == AudioRecorder::Format::Float32 ? WavStreamWriter::Format::Float32
+                                                                      : WavStreamWriter::Format::Pcm16;
+    auto wav = std::make_unique<WavStreamWriter>();
+    if (!wav->open(path, rate, channels, wavFormat)) return nullptr;
+    return wav;
+}
+
+} // namespace
+
 AudioRecorder::AudioRecorder() = default;
 
 AudioRecorder::~AudioRecorder() {
     if (recording_.load()) {
         stopRecording();
     }
+    if (snapshotThread_.joinable()) {
+        snapshotThread_.join();
+    }
+    if (wakeFd_ >= 0) {
+        ::close(wakeFd_);
+    }
 }
 
-bool AudioRecorder::startRecording(const std::string& rawPath, const std::string& processedPath, float sampleRate) {
+bool AudioRecorder::startRecording(const std::string& rawPath, const std::string& processedPath, float sampleRate,
+                                   int32_t alignFrames, Format format) {
     if (recording_.load()) {
         LOGE("Already recording");
         return false;
     }
+    if (wakeFd_ < 0) {
+        wakeFd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (wakeFd_ < 0) {
+            LOGE("eventfd failed: errno=%d", errno);
+            return false;
+        }
+    }
 
     sampleRate_ = sampleRate;
     totalRawFrames_.store(0);
+    rawSkipSamples_ = alignFrames < 0 ? static_cast<size_t>(-static_cast<int64_t>(alignFrames)) : 0;
+    processedSkipSamples_ = alignFrames > 0 ? static_cast<size_t>(alignFrames) * 2 : 0;
+    wakeFrames_ = std::max<size_t>(1, static_cast<size_t>(sampleRate * kWakeSeconds));
+    framesSinceWake_ = 0;
 
     // Size ring buffers: 2 seconds of audio
     size_t rawCapacity = static_cast<size_t>(sampleRate * 2);           // mono
@@ -52,30 +115,27 @@ bool AudioRecorder::startRecording(const std::string& rawPath, const std::string
     rawRing_.resize(rawCapacity);
     processedRing_.resize(processedCapacity);
 
-    // Open files
-    rawFile_.open(rawPath, std::ios::binary | std::ios::trunc);
-    if (!rawFile_.is_open()) {
+    // Open files; headers are finalized on stop and patched at every checkpoint
+    const auto rate = static_cast<uint32_t>(sampleRate);
+    rawWriter_ = openWriter(rawPath, rate, 1, format);
+    if (!rawWriter_) {
         LOGE("Failed to open raw file: %s", rawPath.c_str());
         return false;
     }
-
-    processedFile_.open(processedPath, std::ios::binary | std::ios::trunc);
-    if (!processedFile_.is_open()) {
+    processedWriter_ = openWriter(processedPath, rate, 2, format);
+    if (!processedWriter_) {
         LOGE("Failed to open processed file: %s", processedPath.c_str());
-        rawFile_.close();
+        rawWriter_.reset();
         return false;
     }
 
-    // Write placeholder WAV headers (will be finalized on stop)
-    writeWavHeader(rawFile_, 1, static_cast<uint32_t>(sampleRate));
-    writeWavHeader(processedFile_, 2, static_cast<uint32_t>(sampleRate));
-
     // Start writer thread
     writerRunning_.store(true);
     recording_.store(true);
     writerThread_ = std::thread(&AudioRecorder::writerLoop, this);
 
-    LOGI("Recording started: raw=%s processed=%s sr=%.0f", rawPath.c_str(), processedPath.c_str(), sampleRate);
+    LOGI("Recording started: raw=%s processed=%s sr=%.0f align=%d format=%s", rawPath.c_str(),
+         processedPath.c_str(), sampleRate, alignFrames, formatName(format));
     return true;
 }
 
@@ -84,28 +144,25 @@ void AudioRecorder::stopRecording() {
 
     recording_.store(false);
     writerRunning_.store(false);
+    signalWriter();
 
     if (writerThread_.joinable()) {
         writerThread_.join();
     }
 
-    // Final drain
-    size_t rawTotalSamples = 0;
-    size_t processedTotalSamples = 0;
-    drainRing(rawRing_, rawFile_, rawTotalSamples);
-    drainRing(processedRing_, processedFile_, processedTotalSamples);
-
-    // Finalize WAV headers with actual sizes
-    size_t totalFrames = totalRawFrames_.load();
-    finalizeWavFile(rawFile_, totalFrames, 1);
-    finalizeWavFile(processedFile_, totalFrames, 2);
-
-    rawFile_.close();
-    processedFile_.close();
+    // Final drain, then finalize WAV headers with actual sizes (the tracks differ by the alignment trim)
+    drainRing(rawRing_, *rawWriter_, rawSkipSamples_);
+    drainRing(processedRing_, *processedWriter_, processedSkipSamples_);
+    if (!rawWriter_->close() || !processedWriter_->close()) {
+        LOGE("Failed to finalize recording");
+    }
+    rawWriter_.reset();
+    processedWriter_.reset();
 
     rawRing_.reset();
     processedRing_.reset();
 
+    const size_t totalFrames = totalRawFrames_.load();
     LOGI("Recording stopped: %zu frames (%.1f sec)", totalFrames, totalFrames / static_cast<double>(sampleRate_));
 }
 
@@ -115,112 +172,175 @@ double AudioRecorder::getDurationSec() const {
 }
 
 void AudioRecorder::feedAudio(const float* rawMono, const float* processedL, const float* processedR, int32_t numFrames) {
+    const auto frames = static_cast<size_t>(numFrames);
+    if (preRollReady_.load(std::memory_order_relaxed)) {
+        rawHistory_.write(rawMono, frames);
+        processedHistory_.writeInterleaved(processedL, processedR, frames);
+        historyFrames_.store(historyFrames_.load(std::memory_order_relaxed) + frames, std::memory_order_release);
+    }
+
     if (!recording_.load(std::memory_order_relaxed)) return;
 
-    // Write raw mono
-    rawRing_.write(rawMono, static_cast<size_t>(numFrames));
+    rawRing_.write(rawMono, frames);
+    processedRing_.writeInterleaved(processedL, processedR, frames);
 
-    // Interleave stereo into stack-local buffer if small enough, otherwise use member
-    size_t stereoSamples = static_cast<size_t>(numFrames) * 2;
-    float stackBuf[1024];
-    float* buf;
-    if (stereoSamples <= 1024) {
-        buf = stackBuf;
-    } else {
-        // Very large buffer — use heap (should be rare at typical buffer sizes)
-        interleaveBuffer_.resize(stereoSamples);
-        buf = interleaveBuffer_.data();
-    }
+    totalRawFrames_.fetch_add(frames, std::memory_order_relaxed);
 
-    for (int32_t i = 0; i < numFrames; ++i) {
-        buf[i * 2] = processedL[i];
-        buf[i * 2 + 1] = processedR[i];
+    // One non-blocking syscall every kWakeSeconds instead of the writer polling.
+    framesSinceWake_ += frames;
+    if (framesSinceWake_ >= wakeFrames_) {
+        framesSinceWake_ = 0;
+        signalWriter();
     }
-    processedRing_.write(buf, stereoSamples);
+}
 
-    totalRawFrames_.fetch_add(static_cast<size_t>(numFrames), std::memory_order_relaxed);
+void AudioRecorder::signalWriter() {
+    const uint64_t one = 1;
+    // EAGAIN only when the counter is saturated, i.e. a wakeup is already pending.
+    (void)::write(wakeFd_, &one, sizeof(one));
 }
 
 void AudioRecorder::writerLoop() {
     LOGI("Writer thread started");
+    applyThreadRole(ThreadRole::Background);
 
-    size_t rawTotalSamples = 0;
-    size_t processedTotalSamples = 0;
+    const auto checkpointFrames = static_cast<size_t>(sampleRate_ * kCheckpointSeconds);
+    size_t nextCheckpoint = checkpointFrames;
+    bool ok = true;
 
+    pollfd pfd{wakeFd_, POLLIN, 0};
     while (writerRunning_.load()) {
-        drainRing(rawRing_, rawFile_, rawTotalSamples);
-        drainRing(processedRing_, processedFile_, processedTotalSamples);
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (::poll(&pfd, 1, kWakeTimeoutMs) > 0) {
+            uint64_t count;
+            (void)::read(wakeFd_, &count, sizeof(count));
+        }
+        ok = drainRing(rawRing_, *rawWriter_, rawSkipSamples_) && ok;
+        ok = drainRing(processedRing_, *processedWriter_, processedSkipSamples_) && ok;
+        if (rawWriter_->framesWritten() >= nextCheckpoint) {
+            nextCheckpoint += checkpointFrames;
+            ok = rawWriter_->checkpoint() && processedWriter_->checkpoint() && ok;
+        }
+    }
+    if (!ok) {
+        LOGE("Write errors during recording (storage full?)");
     }
 
-    // One final drain after stopping
-    drainRing(rawRing_, rawFile_, rawTotalSamples);
-    drainRing(processedRing_, processedFile_, processedTotalSamples);
-
-    LOGI("Writer thread exiting: rawSamples=%zu processedSamples=%zu", rawTotalSamples, processedTotalSamples);
+    LOGI("Writer thread exiting: rawFrames=%zu processedFrames=%zu", rawWriter_->framesWritten(),
+         processedWriter_->framesWritten());
 }
 
-void AudioRecorder::drainRing(RingBuffer& ring, std::ofstream& file, size_t& totalSamples) {
-    float readBuf[4096];
-    while (ring.available() > 0) {
-        size_t n = ring.read(readBuf, 4096);
-        if (n == 0) break;
-
-        // Convert float to int16_t
-        int16_t pcmBuf[4096];
-        for (size_t i = 0; i < n; ++i) {
-            float clamped = std::max(-1.0f, std::min(1.0f, readBuf[i]));
-            pcmBuf[i] = static_cast<int16_t>(clamped * 32767.0f);
-        }
-        file.write(reinterpret_cast<const char*>(pcmBuf), n * sizeof(int16_t));
-        totalSamples += n;
+void AudioRecorder::preparePreRoll(float seconds, float sampleRate) {
+    if (snapshotThread_.joinable()) {
+        snapshotThread_.join();
+    }
+    preRollReady_.store(false);
+    historyFrames_.store(0);
+    if (seconds <= 0.0f || sampleRate <= 0.0f) {
+        historyUsableFrames_ = 0;
+        LOGI("Pre-roll off");
+        return;
     }
+    const auto capacity = static_cast<size_t>(sampleRate * (seconds + kPreRollSlackSeconds));
+    if (rawHistory_.capacity() < capacity || historyRate_ != sampleRate) {
+        rawHistory_.resize(capacity);
+        processedHistory_.resize(rawHistory_.capacity() * 2);
+    } else {
+        rawHistory_.reset();
+        processedHistory_.reset();
+    }
+    historyRate_ = sampleRate;
+    historyUsableFrames_ = rawHistory_.capacity() - static_cast<uint64_t>(sampleRate * kPreRollSlackSeconds);
+    preRollReady_.store(true);
+    LOGI("Pre-roll ready: %.1f sec at %.0f Hz", historyUsableFrames_ / static_cast<double>(sampleRate), sampleRate);
 }
 
-void AudioRecorder::writeWavHeader(std::ofstream& file, uint16_t numChannels, uint32_t sampleRate) {
-    // Write a placeholder WAV header (44 bytes). Sizes will be patched in finalizeWavFile().
-    uint16_t bitsPerSample = 16;
-    uint32_t byteRate = sampleRate * numChannels * (bitsPerSample / 8);
-    uint16_t blockAlign = numChannels * (bitsPerSample / 8);
-
-    file.write("RIFF", 4);
-    uint32_t chunkSize = 0; // placeholder
-    file.write(reinterpret_cast<const char*>(&chunkSize), 4);
-    file.write("WAVE", 4);
-
-    // fmt sub-chunk
-    file.write("fmt ", 4);
-    uint32_t fmtSize = 16;
-    file.write(reinterpret_cast<const char*>(&fmtSize), 4);
-    uint16_t audioFormat = 1; // PCM
-    file.write(reinterpret_cast<const char*>(&audioFormat), 2);
-    file.write(reinterpret_cast<const char*>(&numChannels), 2);
-    file.write(reinterpret_cast<const char*>(&sampleRate), 4);
-    file.write(reinterpret_cast<const char*>(&byteRate), 4);
-    file.write(reinterpret_cast<const char*>(&blockAlign), 2);
-    file.write(reinterpret_cast<const char*>(&bitsPerSample), 2);
-
-    // data sub-chunk
-    file.write("data", 4);
-    uint32_t dataSize = 0; // placeholder
-    file.write(reinterpret_cast<const char*>(&dataSize), 4);
+double AudioRecorder::getPreRollAvailableSec() const {
+    if (!preRollReady_.load() || historyRate_ <= 0.0f) return 0.0;
+    return std::min<uint64_t>(historyFrames_.load(), historyUsableFrames_) / static_cast<double>(historyRate_);
 }
 
-void AudioRecorder::finalizeWavFile(std::ofstream& file, size_t totalFrames, uint16_t numChannels) {
-    if (!file.is_open()) return;
+bool AudioRecorder::saveLastSeconds(const std::string& rawPath, const std::string& processedPath, double seconds,
+                                    int32_t alignFrames, Format format) {
+    if (!preRollReady_.load() || snapshotBusy_.load()) {
+        LOGE("saveLastSeconds: %s", snapshotBusy_.load() ? "a save is still running" : "pre-roll is off");
+        return false;
+    }
+    if (snapshotThread_.joinable()) {
+        snapshotThread_.join();
+    }
+
+    // "Now" is when the user asked, not when the thread gets going
+    const uint64_t end = historyFrames_.load(std::memory_order_acquire);
+    const double wanted = std::max(0.0, seconds) * historyRate_;
+    uint64_t frames = std::min(end, historyUsableFrames_);
+    if (wanted < static_cast<double>(frames)) frames = static_cast<uint64_t>(wanted);
+    uint64_t rawStart = end - frames;
+    uint64_t processedStart = end - frames;
+    const uint64_t trim = std::min<uint64_t>(static_cast<uint64_t>(std::abs(static_cast<int64_t>(alignFrames))), frames);
+    if (alignFrames > 0) {
+        processedStart += trim;
+    } else {
+        rawStart += trim;
+    }
+    frames -= trim;
+    if (frames == 0) {
+        LOGE("saveLastSeconds: nothing captured yet");
+        return false;
+    }
 
-    uint32_t dataSize = static_cast<uint32_t>(totalFrames * numChannels * sizeof(int16_t));
-    uint32_t chunkSize = 36 + dataSize;
+    snapshotBusy_.store(true);
+    snapshotThread_ = std::thread(&AudioRecorder::writeSnapshot, this, rawPath, processedPath, rawStart,
+                                  processedStart, frames, format);
+    return true;
+}
 
-    // Patch RIFF chunk size at offset 4
-    file.seekp(4);
-    file.write(reinterpret_cast<const char*>(&chunkSize), 4);
+void AudioRecorder::writeSnapshot(const std::string& rawPath, const std::string& processedPath, uint64_t rawStart,
+                                  uint64_t processedStart, uint64_t frames, Format format) {
+    applyThreadRole(ThreadRole::Background);
+    const auto rate = static_cast<uint32_t>(historyRate_);
+    auto rawWriter = openWriter(rawPath, rate, 1, format);
+    auto processedWriter = openWriter(processedPath, rate, 2, format);
+    bool ok = rawWriter && processedWriter;
+
+    std::vector<float> raw(kSnapshotChunkFrames);
+    std::vector<float> processed(kSnapshotChunkFrames * 2);
+    for (uint64_t done = 0; ok && done < frames;) {
+        const auto n = static_cast<size_t>(std::min<uint64_t>(kSnapshotChunkFrames, frames - done));
+        // A failed read means the audio thread lapped us: stop rather than write torn audio.
+        if (!rawHistory_.read(rawStart + done, n, raw.data()) ||
+            !processedHistory_.read((processedStart + done) * 2, n * 2, processed.data())) {
+            LOGE("saveLastSeconds: history overwritten after %llu frames", static_cast<unsigned long long>(done));
+            ok = false;
+            break;
+        }
+        ok = rawWriter->writeSamples(raw.data(), n) && processedWriter->writeSamples(processed.data(), n * 2);
+        done += n;
+    }
+    if (rawWriter && !rawWriter->close()) ok = false;
+    if (processedWriter && !processedWriter->close()) ok = false;
 
-    // Patch data sub-chunk size at offset 40
-    file.seekp(40);
-    file.write(reinterpret_cast<const char*>(&dataSize), 4);
+    if (ok) {
+        LOGI("Pre-roll saved: %.1f sec to %s", frames / static_cast<double>(rate), rawPath.c_str());
+    } else {
+        LOGE("Pre-roll save failed: raw=%s processed=%s", rawPath.c_str(), processedPath.c_str());
+    }
+    snapshotBusy_.store(false);
+}
 
-    file.flush();
+bool AudioRecorder::drainRing(RingBuffer& ring, AudioFileWriter& writer, size_t& skipSamples) {
+    if (skipSamples > 0) {
+        skipSamples -= ring.skip(skipSamples);
+        if (skipSamples > 0) return true;
+    }
+    // Convert (or encode) straight out of the ring; the writer batches its own I/O.
+    RingBuffer::Span first, second;
+    const size_t available = ring.peek(first, second);
+    if (available == 0) return true;
+    SYSTEM_TRACE_SCOPE("AudioRecorder drain");
+    SYSTEM_TRACE_COUNTER(&ring == &rawRing_ ? "recorder.rawBacklog" : "recorder.processedBacklog", available);
+    const bool ok = writer.writeSamples(first.data, first.count) && writer.writeSamples(second.data, second.count);
+    ring.skip(available);
+    return ok;
 }
 
 } // namespace guitarrackcraft
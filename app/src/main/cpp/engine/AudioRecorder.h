@@ -20,9 +20,11 @@
 #ifndef GUITARRACKCRAFT_AUDIO_RECORDER_H
 #define GUITARRACKCRAFT_AUDIO_RECORDER_H
 
+#include "HistoryRing.h"
 #include "RingBuffer.h"
+#include "utils/AudioFileWriter.h"
 #include <atomic>
-#include <fstream>
+#include <memory>
 #include <string>
 #include <thread>
 
@@ -31,26 +33,69 @@ namespace guitarrackcraft {
 /**
  * Records raw input (mono) and processed output (stereo) simultaneously.
  *
- * feedAudio() is called from the real-time audio callback — it only writes to
- * lock-free ring buffers. A background writer thread drains the rings and
- * streams PCM data to two WAV files (16-bit).
+ * feedAudio() is called from the real-time audio callback — it only copies into
+ * lock-free ring buffers and, every kWakeSeconds of audio, signals an eventfd. The
+ * writer thread sleeps on that eventfd, converts straight out of the rings and
+ * streams two files: WAV (16-bit, 24-bit or float) or FLAC (16/24-bit), whose encoder
+ * also runs entirely on the writer thread.
+ *
+ * Independently of recording, feedAudio() keeps a pre-roll history of the last few
+ * seconds of both tracks (two preallocated HistoryRings), so saveLastSeconds() can
+ * retroactively capture something that was already played.
  */
 class AudioRecorder {
 public:
+    enum class Format : uint8_t { Pcm16, Pcm24, Float32, Flac16, Flac24 };
+
     AudioRecorder();
     ~AudioRecorder();
 
-    bool startRecording(const std::string& rawPath, const std::string& processedPath, float sampleRate);
+    /**
+     * Start writing both tracks. alignFrames lines them up for re-amping: a positive
+     * value means the processed signal lags the raw one by that many frames (chain and
+     * block latency) and is trimmed from the processed track's start; a negative value
+     * means the raw input lags (e.g. a hardware re-amp loop) and is trimmed from the raw track.
+     */
+    bool startRecording(const std::string& rawPath, const std::string& processedPath, float sampleRate,
+                        int32_t alignFrames = 0, Format format = Format::Pcm16);
     void stopRecording();
     bool isRecording() const { return recording_.load(std::memory_order_relaxed); }
     double getDurationSec() const;
 
     /**
      * Feed audio data from the real-time callback.
-     * Must be lock-free: only writes to ring buffers.
+     * Must be lock-free: only writes to ring buffers (plus a non-blocking eventfd write).
      */
     void feedAudio(const float* rawMono, const float* processedL, const float* processedR, int32_t numFrames);
 
+    /**
+     * Allocate the pre-roll history for `seconds` of audio at sampleRate (0 turns it off).
+     * Only while the audio callback is stopped; waits for a running save to finish.
+     */
+    void preparePreRoll(float seconds, float sampleRate);
+
+    /** Seconds saveLastSeconds() could capture right now. */
+    double getPreRollAvailableSec() const;
+
+    /**
+     * Write the last `seconds` of pre-roll history (clamped to what is available) to two
+     * files on a background thread, while the audio keeps flowing into the history.
+     * alignFrames and format as for startRecording().
+     * @return false if pre-roll is off or empty, or a previous save is still running
+     */
+    bool saveLastSeconds(const std::string& rawPath, const std::string& processedPath, double seconds,
+                         int32_t alignFrames = 0, Format format = Format::Pcm16);
+    bool isSavingPreRoll() const { return snapshotBusy_.load(); }
+
+    static constexpr float kDefaultPreRollSeconds = 30.0f;
+    /** History kept beyond the requested length, so a save can finish before it is overwritten. */
+    static constexpr float kPreRollSlackSeconds = 2.0f;
+
+    /** Audio between writer wakeups; the rings hold 2 s, so this leaves ample slack. */
+    static constexpr double kWakeSeconds = 0.25;
+    /** Header sizes are patched this often, so a crash leaves playable files. */
+    static constexpr double kCheckpointSeconds = 5.0;
+
 private:
     std::atomic<bool> recording_{false};
     std::atomic<bool> writerRunning_{false};
@@ -60,17 +105,33 @@ private:
     RingBuffer rawRing_;
     RingBuffer processedRing_;
 
-    std::ofstream rawFile_;
-    std::ofstream processedFile_;
+    std::unique_ptr<AudioFileWriter> rawWriter_;
+    std::unique_ptr<AudioFileWriter> processedWriter_;
     std::thread writerThread_;
 
-    // Temp buffer for interleaving stereo in feedAudio (avoid allocation)
-    std::vector<float> interleaveBuffer_;
+    int wakeFd_ = -1;
+    size_t wakeFrames_ = 0;
+    size_t framesSinceWake_ = 0;  // audio thread only
+
+    // Writer-thread state (set before the thread starts, read back after it joins)
+    size_t rawSkipSamples_ = 0;
+    size_t processedSkipSamples_ = 0;
+
+    // Pre-roll history; feedAudio() writes it whenever preRollReady_
+    HistoryRing rawHistory_;
+    HistoryRing processedHistory_;  // stereo interleaved
+    std::atomic<bool> preRollReady_{false};
+    std::atomic<uint64_t> historyFrames_{0};  // published after both rings are written
+    float historyRate_ = 0.0f;
+    uint64_t historyUsableFrames_ = 0;
+    std::thread snapshotThread_;
+    std::atomic<bool> snapshotBusy_{false};
 
     void writerLoop();
-    void writeWavHeader(std::ofstream& file, uint16_t numChannels, uint32_t sampleRate);
-    void finalizeWavFile(std::ofstream& file, size_t totalSamples, uint16_t numChannels);
-    void drainRing(RingBuffer& ring, std::ofstream& file, size_t& totalSamples);
+    void signalWriter();
+    void writeSnapshot(const std::string& rawPath, const std::string& processedPath, uint64_t rawStart,
+                       uint64_t processedStart, uint64_t frames, Format format);
+    bool drainRing(RingBuffer& ring, AudioFileWriter& writer, size_t& skipSamples);
 };
 
 } // namespace guitarrackcraft
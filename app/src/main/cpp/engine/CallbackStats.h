@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUITARRACKCRAFT_CALLBACK_STATS_H
+#define GUITARRACKCRAFT_CALLBACK_STATS_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace guitarrackcraft {
+
+/**
+ * Lock-free audio callback timing histograms.
+ *
+ * Thread safety:
+ *   - record() called from the audio callback only (single writer)
+ *   - read() / requestReset() called from any other thread; counters are read
+ *     individually, so a snapshot may straddle one callback
+ *
+ * Load buckets hold callback wall time as a share of the deadline (numFrames / rate)
+ * in kLoadBucketPercent steps; the last bucket collects everything beyond.
+ * Interval buckets hold the time since the previous callback relative to the
+ * nominal period, centred on 100%.
+ */
+class CallbackStats {
+public:
+    static constexpr int kLoadBuckets = 24;          // 0..115% in 5% steps, then overflow
+    static constexpr int kLoadBucketPercent = 5;
+    static constexpr int kIntervalBuckets = 21;      // 0..200% of the period in 10% steps
+    static constexpr int kIntervalBucketPercent = 10;
+    static constexpr uint32_t kNearMissPercent = 80;
+
+    struct Snapshot {
+        uint32_t callbacks = 0;
+        uint32_t nearMisses = 0;     // used more than kNearMissPercent of the budget
+        uint32_t deadlineMisses = 0; // used more than the whole budget
+        uint32_t maxWallUs = 0;
+        uint32_t maxJitterUs = 0;    // largest |interval - period|
+        uint32_t load[kLoadBuckets] = {};
+        uint32_t interval[kIntervalBuckets] = {};
+    };
+
+    /** Record one callback. Times are in nanoseconds on a monotonic clock. */
+    void record(int64_t startNs, int64_t endNs, uint32_t numFrames, float sampleRate) {
+        if (resetRequested_.exchange(false, std::memory_order_acquire)) {
+            clear();
+        }
+        if (sampleRate <= 0.0f || numFrames == 0) {
+            return;
+        }
+        const int64_t periodNs = static_cast<int64_t>(numFrames * 1e9 / sampleRate);
+        const int64_t wallNs = endNs - startNs;
+        const uint32_t loadPct = periodNs > 0 ? static_cast<uint32_t>(wallNs * 100 / periodNs) : 0;
+
+        bump(load_[bucket(loadPct, kLoadBucketPercent, kLoadBuckets)]);
+        bump(callbacks_);
+        if (loadPct > kNearMissPercent) bump(nearMisses_);
+        if (loadPct > 100) bump(deadlineMisses_);
+        raise(maxWallUs_, static_cast<uint32_t>(wallNs / 1000));
+
+        if (haveLastStart_ && periodNs > 0) {
+            const int64_t intervalNs = startNs - lastStartNs_;
+            const uint32_t intervalPct = static_cast<uint32_t>(
+                intervalNs > 0 ? intervalNs * 100 / periodNs : 0);
+            bump(interval_[bucket(intervalPct, kIntervalBucketPercent, kIntervalBuckets)]);
+            const int64_t jitterNs = intervalNs > periodNs ? intervalNs - periodNs : periodNs - intervalNs;
+            raise(maxJitterUs_, static_cast<uint32_t>(jitterNs / 1000));
+        }
+        lastStartNs_ = startNs;
+        haveLastStart_ = true;
+    }
+
+    Snapshot read() const {
+        Snapshot s;
+        s.callbacks = callbacks_.load(std::memory_order_relaxed);
+        s.nearMisses = nearMisses_.load(std::memory_order_relaxed);
+        s.deadlineMisses = deadlineMisses_.load(std::memory_order_relaxed);
+        s.maxWallUs = maxWallUs_.load(std::memory_order_relaxed);
+        s.maxJitterUs = maxJitterUs_.load(std::memory_order_relaxed);
+        for (int i = 0; i < kLoadBuckets; ++i) s.load[i] = load_[i].load(std::memory_order_relaxed);
+        for (int i = 0; i < kIntervalBuckets; ++i) s.interval[i] = interval_[i].load(std::memory_order_relaxed);
+        return s;
+    }
+
+    /** Ask the audio thread to zero all counters at its next callback. */
+    void requestReset() { resetRequested_.store(true, std::memory_order_release); }
+
+    /** Zero immediately; only when no callback can run (stream closed). */
+    void clear() {
+        callbacks_.store(0, std::memory_order_relaxed);
+        nearMisses_.store(0, std::memory_order_relaxed);
+        deadlineMisses_.store(0, std::memory_order_relaxed);
+        maxWallUs_.store(0, std::memory_order_relaxed);
+        maxJitterUs_.store(0, std::memory_order_relaxed);
+        for (auto& b : load_) b.store(0, std::memory_order_relaxed);
+        for (auto& b : interval_) b.store(0, std::memory_order_relaxed);
+        haveLastStart_ = false;
+    }
+
+private:
+    static int bucket(uint32_t percent, int step, int count) {
+        uint32_t b = percent / static_cast<uint32_t>(step);
+        return b < static_cast<uint32_t>(count - 1) ? static_cast<int>(b) : count - 1;
+    }
+    // Single writer: plain load/store avoids locked read-modify-write instructions.
+    static void bump(std::atomic<uint32_t>& c) {
+        c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    static void raise(std::atomic<uint32_t>& c, uint32_t v) {
+        if (v > c.load(std::memory_order_relaxed)) c.store(v, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint32_t> callbacks_{0};
+    std::atomic<uint32_t> nearMisses_{0};
+    std::atomic<uint32_t> deadlineMisses_{0};
+    std::atomic<uint32_t> maxWallUs_{0};
+    std::atomic<uint32_t> maxJitterUs_{0};
+    std::atomic<uint32_t> load_[kLoadBuckets] = {};
+    std::atomic<uint32_t> interval_[kIntervalBuckets] = {};
+    std::atomic<bool> resetRequested_{false};
+    int64_t lastStartNs_ = 0;  // audio thread only
+    bool haveLastStart_ = false;
+};
+
+} // namespace guitarrackcraft
+
+#endif // GUITARRACKCRAFT_CALLBACK_STATS_H
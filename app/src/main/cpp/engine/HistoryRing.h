@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUITARRACKCRAFT_HISTORY_RING_H
+#define GUITARRACKCRAFT_HISTORY_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Fixed-size circular history of the newest float samples. Unlike RingBuffer the
+ * producer never blocks or drops: it overwrites the oldest samples, so it costs one
+ * or two memcpy()s per block and keeps working with no consumer at all.
+ *
+ * Samples are addressed by absolute position (0 = first ever written). A consumer
+ * copies a range with read(), which validates it seqlock-style: the producer
+ * publishes how far it is about to write before touching the buffer, so a copy that
+ * raced with an overwrite is detected and reported instead of returned torn.
+ *
+ * Thread safety:
+ *   - write()/writeInterleaved() called from one thread (audio callback)
+ *   - read() from any number of other threads
+ *   - resize()/reset() only when idle
+ */
+class HistoryRing {
+public:
+    void resize(size_t minCapacity) {
+        size_t cap = 1;
+        while (cap < minCapacity) cap <<= 1;
+        buffer_.assign(cap, 0.0f);
+        mask_ = cap - 1;
+        reset();
+    }
+
+    size_t capacity() const { return buffer_.size(); }
+
+    void reset() {
+        written_.store(0, std::memory_order_relaxed);
+        reserved_.store(0, std::memory_order_relaxed);
+    }
+
+    /** Append samples, overwriting the oldest once full. */
+    void write(const float* data, size_t count) {
+        uint64_t w = written_.load(std::memory_order_relaxed);
+        if (count > capacity()) {
+            w += count - capacity();
+            data += count - capacity();
+            count = capacity();
+        }
+        if (count == 0) return;
+        beginWrite(w + count);
+        const size_t start = static_cast<size_t>(w) & mask_;
+        const size_t first = count < capacity() - start ? count : capacity() - start;
+        std::memcpy(buffer_.data() + start, data, first * sizeof(float));
+        std::memcpy(buffer_.data(), data + first, (count - first) * sizeof(float));
+        written_.store(w + count, std::memory_order_release);
+    }
+
+    /** Append frames of two channels, interleaved. frames * 2 must not exceed capacity(). */
+    void writeInterleaved(const float* left, const float* right, size_t frames) {
+        const uint64_t w = written_.load(std::memory_order_relaxed);
+        const size_t count = frames * 2;
+        if (count == 0 || count > capacity()) return;
+        beginWrite(w + count);
+        float* base = buffer_.data();
+        size_t pos = static_cast<size_t>(w) & mask_;
+        for (size_t i = 0; i < count;) {
+            const size_t run = count - i < capacity() - pos ? count - i : capacity() - pos;
+            for (size_t j = 0; j < run; ++j, ++i) {
+                base[pos + j] = (i & 1) ? right[i >> 1] : left[i >> 1];
+            }
+            pos = 0;
+        }
+        written_.store(w + count, std::memory_order_release);
+    }
+
+    /** Total samples ever written. */
+    uint64_t written() const { return written_.load(std::memory_order_acquire); }
+
+    /**
+     * Copy samples [pos, pos + count) into out.
+     * @return false if any of them are not written yet or were overwritten before or during the copy
+     */
+    bool read(uint64_t pos, size_t count, float* out) const {
+        if (count > capacity() || pos + count > written()) return false;
+        const size_t start = static_cast<size_t>(pos) & mask_;
+        const size_t first = count < capacity() - start ? count : capacity() - start;
+        std::memcpy(out, buffer_.data() + start, first * sizeof(float));
+        std::memcpy(out + first, buffer_.data(), (count - first) * sizeof(float));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return reserved_.load(std::memory_order_relaxed) - pos <= capacity();
+    }
+
+private:
+    std::vector<float> buffer_;
+    size_t mask_ = 0;
+    std::atomic<uint64_t> written_{0};   // published after the samples are in place
+    std::atomic<uint64_t> reserved_{0};  // published before any sample is overwritten
+
+    void beginWrite(uint64_t end) {
+        reserved_.store(end, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+};
+
+} // namespace guitarrackcraft
+
+#endif // GUITARRACKCRAFT_HISTORY_RING_H
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUITARRACKCRAFT_LOAD_SHEDDER_H
+#define GUITARRACKCRAFT_LOAD_SHEDDER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace guitarrackcraft {
+
+/**
+ * Overload policy: steps through increasingly noticeable ways of buying back callback time
+ * while the audio thread runs close to its deadline, before Oboe starts counting xruns, and
+ * undoes them one at a time once headroom returns.
+ *
+ * Each update() looks at the callbacks recorded since the previous one. A window where more
+ * than kHotPerMille of the callbacks used over kHotLoad of the deadline (or any missed it)
+ * raises the level, at most once per kEscalateHoldNs so the last step can take effect.
+ * Windows that stay entirely under kCalmLoad for the restore hold lower it by one. A level
+ * that is needed again soon after it was undone doubles the restore hold (up to
+ * kMaxRestoreHoldNs), so a marginal load does not flap between two levels.
+ *
+ * Thread safety:
+ *   - record() from the audio callback only (single writer)
+ *   - update() / reset() from one control thread; level() from any thread
+ */
+class LoadShedder {
+public:
+    enum Level : uint32_t {
+        kNormal = 0,
+        kCheapQuality,  // plugin quality/oversampling controls at their cheapest
+        kFastSleep,     // silent slots sleep after a short decay probe
+        kSlowUi,        // X11 UI frame rate capped
+        kLargeBuffer,   // larger output buffer: more latency, more slack
+    };
+    static constexpr uint32_t kMaxLevel = kLargeBuffer;
+
+    static constexpr float kHotLoad = 0.85f;
+    static constexpr float kCalmLoad = 0.6f;
+    static constexpr uint32_t kHotPerMille = 20;
+    static constexpr int64_t kEscalateHoldNs = 500000000LL;     // 0.5 s
+    static constexpr int64_t kRestoreHoldNs = 10000000000LL;    // 10 s
+    static constexpr int64_t kMaxRestoreHoldNs = 160000000000LL; // 160 s
+
+    /** One callback's wall time as a share of its deadline (1 = missed). */
+    void record(float load) {
+        bump(callbacks_);
+        if (load > kCalmLoad) bump(warm_);
+        if (load > kHotLoad) bump(hot_);
+        if (load >= 1.0f) bump(misses_);
+    }
+
+    /** Fold in the callbacks since the last call and return the new level. */
+    uint32_t update(int64_t nowNs) {
+        const uint32_t callbacks = callbacks_.load(std::memory_order_relaxed);
+        const uint32_t warm = warm_.load(std::memory_order_relaxed);
+        const uint32_t hot = hot_.load(std::memory_order_relaxed);
+        const uint32_t misses = misses_.load(std::memory_order_relaxed);
+        const uint32_t n = callbacks - seenCallbacks_;
+        const uint32_t nWarm = warm - seenWarm_;
+        const uint32_t nHot = hot - seenHot_;
+        const uint32_t nMisses = misses - seenMisses_;
+        seenCallbacks_ = callbacks;
+        seenWarm_ = warm;
+        seenHot_ = hot;
+        seenMisses_ = misses;
+        if (n == 0) return level_.load(std::memory_order_relaxed);  // stream stalled or stopped
+
+        uint32_t level = level_.load(std::memory_order_relaxed);
+        const bool overloaded = nMisses > 0 || uint64_t{nHot} * 1000 > uint64_t{n} * kHotPerMille;
+        if (overloaded) {
+            calmSinceNs_ = -1;
+            if (level < kMaxLevel && nowNs - escalatedNs_ >= kEscalateHoldNs) {
+                if (level + 1 == restoredLevel_ && nowNs - restoredNs_ < restoreHoldNs_) {
+                    restoreHoldNs_ = std::min(restoreHoldNs_ * 2, kMaxRestoreHoldNs);
+                }
+                ++level;
+                escalatedNs_ = nowNs;
+            }
+        } else if (nWarm == 0) {
+            if (calmSinceNs_ < 0) calmSinceNs_ = nowNs;
+            if (level > kNormal && nowNs - calmSinceNs_ >= restoreHoldNs_) {
+                restoredLevel_ = level;
+                --level;
+                restoredNs_ = nowNs;
+                calmSinceNs_ = nowNs;  // each further step waits a full hold again
+            }
+        } else {
+            calmSinceNs_ = -1;
+        }
+        level_.store(level, std::memory_order_relaxed);
+        return level;
+    }
+
+    uint32_t level() const { return level_.load(std::memory_order_relaxed); }
+
+    /** Restore hold currently required before a level is undone. */
+    int64_t restoreHoldNs() const { return restoreHoldNs_; }
+
+    /** Back to kNormal, forgetting history (new stream). Callbacks recorded so far are skipped. */
+    void reset() {
+        seenCallbacks_ = callbacks_.load(std::memory_order_relaxed);
+        seenWarm_ = warm_.load(std::memory_order_relaxed);
+        seenHot_ = hot_.load(std::memory_order_relaxed);
+        seenMisses_ = misses_.load(std::memory_order_relaxed);
+        level_.store(kNormal, std::memory_order_relaxed);
+        escalatedNs_ = INT64_MIN / 2;
+        restoredNs_ = INT64_MIN / 2;
+        calmSinceNs_ = -1;
+        restoredLevel_ = kNormal;
+        restoreHoldNs_ = kRestoreHoldNs;
+    }
+
+private:
+    // Single writer: plain load/store avoids locked read-modify-write instructions.
+    static void bump(std::atomic<uint32_t>& c) {
+        c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Running totals written by the audio thread; update() works on their differences.
+    std::atomic<uint32_t> callbacks_{0};
+    std::atomic<uint32_t> warm_{0};
+    std::atomic<uint32_t> hot_{0};
+    std::atomic<uint32_t> misses_{0};
+    std::atomic<uint32_t> level_{kNormal};
+
+    // Control thread only
+    uint32_t seenCallbacks_ = 0;
+    uint32_t seenWarm_ = 0;
+    uint32_t seenHot_ = 0;
+    uint32_t seenMisses_ = 0;
+    int64_t escalatedNs_ = INT64_MIN / 2;  // last step up
+    int64_t restoredNs_ = INT64_MIN / 2;   // last step down
+    int64_t calmSinceNs_ = -1;             // start of the current calm run, -1 if not calm
+    uint32_t restoredLevel_ = kNormal;     // level the last step down left
+    int64_t restoreHoldNs_ = kRestoreHoldNs;
+};
+
+} // namespace guitarrackcraft
+
+#endif // GUITARRACKCRAFT_LOAD_SHEDDER_H
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "MidiInput.h"
+#include <android/log.h>
+#include <dlfcn.h>
+#include <chrono>
+
+#define LOG_TAG "MidiInput"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace guitarrackcraft {
+
+namespace {
+
+// NDK amidi/AMidi.h, resolved from libamidi.so so minSdk stays below 29.
+struct MidiApi {
+    static constexpr int32_t kOpcodeData = 1;  // AMIDI_OPCODE_DATA
+
+    using FromJava = int32_t (*)(JNIEnv* env, jobject device, void** outDevice);
+    using Release = int32_t (*)(const void* device);
+    using OpenOutput = int32_t (*)(const void* device, int32_t portNumber, void** outPort);
+    using Receive = ssize_t (*)(const void* port, int32_t* opcode, uint8_t* buffer,
+                                size_t maxBytes, size_t* numBytes, int64_t* timestampNs);
+    using CloseOutput = void (*)(const void* port);
+
+    FromJava fromJava = nullptr;
+    Release release = nullptr;
+    OpenOutput openOutput = nullptr;
+    Receive receive = nullptr;
+    CloseOutput closeOutput = nullptr;
+
+    MidiApi() {
+        void* lib = dlopen("libamidi.so", RTLD_NOW | RTLD_LOCAL);
+        if (!lib) return;
+        fromJava = reinterpret_cast<FromJava>(dlsym(lib, "AMidiDevice_fromJava"));
+        release = reinterpret_cast<Release>(dlsym(lib, "AMidiDevice_release"));
+        openOutput = reinterpret_cast<OpenOutput>(dlsym(lib, "AMidiOutputPort_open"));
+        receive = reinterpret_cast<Receive>(dlsym(lib, "AMidiOutputPort_receive"));
+        closeOutput = reinterpret_cast<CloseOutput>(dlsym(lib, "AMidiOutputPort_close"));
+    }
+
+    bool complete() const { return fromJava && release && openOutput && receive && closeOutput; }
+
+    static const MidiApi& get() {
+        static const MidiApi api;
+        return api;
+    }
+};
+
+} // namespace
+
+bool MidiInput::available() {
+    return MidiApi::get().complete();
+}
+
+bool MidiInput::open(JNIEnv* env, jobject device, int32_t portNumber) {
+    close();
+    const MidiApi& api = MidiApi::get();
+    if (!api.complete() || !env || !device) {
+        LOGE("open: AMidi unavailable");
+        return false;
+    }
+    if (api.fromJava(env, device, &device_) != 0 || !device_) {
+        LOGE("open: AMidiDevice_fromJava failed");
+        device_ = nullptr;
+        return false;
+    }
+    if (api.openOutput(device_, portNumber, &port_) != 0 || !port_) {
+        LOGE("open: AMidiOutputPort_open(%d) failed", portNumber);
+        api.release(device_);
+        device_ = nullptr;
+        port_ = nullptr;
+        return false;
+    }
+    running_.store(true);
+    thread_ = std::thread(&MidiInput::readLoop, this);
+    LOGI("open: reading output port %d", portNumber);
+    return true;
+}
+
+void MidiInput::close() {
+    running_.store(false);
+    if (thread_.joinable()) thread_.join();
+    const MidiApi& api = MidiApi::get();
+    if (port_) {
+        api.closeOutput(port_);
+        port_ = nullptr;
+    }
+    if (device_) {
+        api.release(device_);
+        device_ = nullptr;
+    }
+}
+
+void MidiInput::readLoop() {
+    // AMidi has no blocking receive: poll, well under a block period apart
+    const MidiApi& api = MidiApi::get();
+    MidiParser parser;
+    uint8_t buffer[1024];
+    while (running_.load(std::memory_order_relaxed)) {
+        int32_t opcode = 0;
+        size_t size = 0;
+        int64_t timeNs = 0;
+        const ssize_t received = api.receive(port_, &opcode, buffer, sizeof(buffer), &size, &timeNs);
+        if (received < 0) {
+            LOGE("readLoop: receive failed (%zd), stopping", received);
+            break;
+        }
+        if (received == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(kPollIntervalUs));
+            continue;
+        }
+        if (opcode != MidiApi::kOpcodeData) {
+            parser.reset();  // flush: drop any partial message
+            continue;
+        }
+        parser.feed(buffer, size, timeNs, [this](const MidiMessage& msg) {
+            if (router_.capture(msg)) return;
+            if (!queue_.push(msg)) {
+                dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        });
+    }
+}
+
+} // namespace guitarrackcraft
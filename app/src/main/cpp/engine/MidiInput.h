@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUITARRACKCRAFT_MIDI_INPUT_H
+#define GUITARRACKCRAFT_MIDI_INPUT_H
+
+#include "MidiRouter.h"
+#include "../utils/SpscQueue.h"
+#include <jni.h>
+#include <atomic>
+#include <thread>
+
+namespace guitarrackcraft {
+
+/**
+ * Native MIDI input (AMidi, API 29+): a reader thread drains one output port of an opened
+ * android.media.midi.MidiDevice, splits the bytes into messages and hands them to the audio
+ * thread through an SPSC queue, so events skip the Java MidiReceiver path and its GC and
+ * binder hops. Messages that complete a pending MIDI learn go to the router instead.
+ *
+ * AMidi is looked up at runtime (libamidi.so); open() fails on older releases.
+ * open()/close() from one control thread.
+ */
+class MidiInput {
+public:
+    MidiInput(MidiRouter& router, SpscQueue<MidiMessage>& queue) : router_(router), queue_(queue) {}
+    ~MidiInput() { close(); }
+
+    MidiInput(const MidiInput&) = delete;
+    MidiInput& operator=(const MidiInput&) = delete;
+
+    static bool available();
+
+    /** Start reading 'portNumber' (a device output port) of the Java MidiDevice 'device'. */
+    bool open(JNIEnv* env, jobject device, int32_t portNumber);
+    void close();
+    bool isOpen() const { return port_ != nullptr; }
+
+    /** Messages dropped because the audio thread was not draining the queue. */
+    uint32_t droppedMessages() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int64_t kPollIntervalUs = 500;
+
+    void readLoop();
+
+    MidiRouter& router_;
+    SpscQueue<MidiMessage>& queue_;
+    void* device_ = nullptr;  // AMidiDevice*
+    void* port_ = nullptr;    // AMidiOutputPort*
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint32_t> dropped_{0};
+};
+
+} // namespace guitarrackcraft
+
+#endif // GUITARRACKCRAFT_MIDI_INPUT_H
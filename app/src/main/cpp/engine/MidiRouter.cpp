@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "MidiRouter.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace guitarrackcraft {
+
+namespace {
+
+bool isControlChange(const MidiMessage& msg) {
+    return msg.size == 3 && (msg.data[0] & 0xF0) == 0xB0;
+}
+
+bool isNoteOn(const MidiMessage& msg) {
+    return msg.size == 3 && (msg.data[0] & 0xF0) == 0x90 && msg.data[2] > 0;
+}
+
+bool isNoteOff(const MidiMessage& msg) {
+    return msg.size == 3 &&
+           ((msg.data[0] & 0xF0) == 0x80 || ((msg.data[0] & 0xF0) == 0x90 && msg.data[2] == 0));
+}
+
+} // namespace
+
+MidiRouter::MidiRouter() : table_(new Table()) {}
+
+MidiRouter::~MidiRouter() {
+    delete table_.load(std::memory_order_relaxed);
+}
+
+void MidiRouter::learn(int32_t pluginIndex, int32_t portIndex, float min, float max, bool toggle) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    pending_ = MidiMapping{};
+    pending_.pluginIndex = pluginIndex;
+    pending_.portIndex = portIndex;
+    pending_.min = min;
+    pending_.max = max;
+    pending_.toggle = toggle;
+    learning_.store(true, std::memory_order_release);
+}
+
+void MidiRouter::cancelLearn() {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    learning_.store(false, std::memory_order_release);
+}
+
+bool MidiRouter::capture(const MidiMessage& msg) {
+    if (!learning_.load(std::memory_order_acquire)) return false;
+    const bool cc = isControlChange(msg);
+    if (!cc && !isNoteOn(msg)) return false;
+
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    if (!learning_.load(std::memory_order_relaxed)) return false;  // cancelled meanwhile
+    MidiMapping mapping = pending_;
+    mapping.source = cc ? MidiMapping::Source::ControlChange : MidiMapping::Source::Note;
+    mapping.channel = msg.data[0] & 0x0F;
+    mapping.number = msg.data[1];
+
+    // A controller drives one target and a target follows one controller
+    auto next = std::make_unique<Table>(*table_.load(std::memory_order_relaxed));
+    auto& list = next->mappings;
+    list.erase(std::remove_if(list.begin(), list.end(), [&](const MidiMapping& m) {
+        return (m.source == mapping.source && m.channel == mapping.channel &&
+                m.number == mapping.number) ||
+               (m.pluginIndex == mapping.pluginIndex && m.portIndex == mapping.portIndex);
+    }), list.end());
+    if (list.size() < kMaxMappings) list.push_back(mapping);
+    publish(std::move(next));
+    learning_.store(false, std::memory_order_release);
+    return true;
+}
+
+void MidiRouter::setMappings(std::vector<MidiMapping> mappings) {
+    if (mappings.size() > kMaxMappings) mappings.resize(kMaxMappings);
+    auto next = std::make_unique<Table>();
+    next->mappings = std::move(mappings);
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    publish(std::move(next));
+}
+
+std::vector<MidiMapping> MidiRouter::mappings() const {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    return table_.load(std::memory_order_relaxed)->mappings;
+}
+
+void MidiRouter::publish(std::unique_ptr<Table> next) {
+    Table* old = table_.exchange(next.release(), std::memory_order_seq_cst);
+    // Grace period, as PluginChain::waitForReaders(): route() holds a table for a few events
+    while (activeReaders_.load(std::memory_order_seq_cst) != 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    delete old;
+}
+
+uint32_t MidiRouter::route(const MidiMessage& msg, uint32_t frame, PluginChain::HostEvent* out,
+                           uint32_t capacity) const {
+    if (msg.size == 0 || capacity == 0) return 0;
+    using Kind = PluginChain::HostEvent::Kind;
+    const bool cc = isControlChange(msg);
+    const bool noteOn = isNoteOn(msg);
+    const bool noteOff = isNoteOff(msg);
+
+    uint32_t count = 0;
+    bool mapped = false;
+    if (cc || noteOn || noteOff) {
+        const auto source = cc ? MidiMapping::Source::ControlChange : MidiMapping::Source::Note;
+        const uint8_t channel = msg.data[0] & 0x0F;
+        activeReaders_.fetch_add(1, std::memory_order_seq_cst);
+        const Table* table = table_.load(std::memory_order_seq_cst);
+        for (const MidiMapping& m : table->mappings) {
+            if (m.source != source || m.number != msg.data[1] ||
+                (m.channel != MidiMapping::kAnyChannel && m.channel != channel)) {
+                continue;
+            }
+            mapped = true;
+            const bool bypass = m.portIndex == MidiMapping::kBypassPort;
+            PluginChain::HostEvent event;
+            event.pluginIndex = m.pluginIndex;
+            event.portIndex = bypass ? 0 : static_cast<uint32_t>(m.portIndex);
+            event.frame = frame;
+            if (m.toggle) {
+                // Footswitches send press and release; only the press flips
+                if (!(cc ? msg.data[2] >= 64 : noteOn)) continue;
+                event.kind = bypass ? Kind::BypassToggle : Kind::Toggle;
+                event.value = m.max;
+                event.low = m.min;
+            } else {
+                const float value = cc ? m.min + (m.max - m.min) * (msg.data[2] / 127.0f)
+                                       : noteOn ? m.max : m.min;
+                event.kind = bypass ? Kind::Bypass : Kind::Control;
+                event.value = bypass ? (value >= 0.5f ? 0.0f : 1.0f) : value;
+            }
+            if (count < capacity) out[count++] = event;
+        }
+        activeReaders_.fetch_sub(1, std::memory_order_release);
+    }
+    if (!mapped) {
+        PluginChain::HostEvent event;
+        event.kind = Kind::Midi;
+        event.size = msg.size;
+        std::copy(msg.data, msg.data + msg.size, event.data);
+        event.frame = frame;
+        out[count++] = event;
+    }
+    return count;
+}
+
+uint32_t MidiRouter::frameOffset(int64_t eventNs, int64_t blockNs, uint32_t frames,
+                                 float sampleRate) {
+    if (frames == 0) return 0;
+    const double lateFrames = static_cast<double>(blockNs - eventNs) * sampleRate * 1e-9;
+    const int64_t offset = static_cast<int64_t>(frames) - std::llround(lateFrames);
+    return static_cast<uint32_t>(std::clamp<int64_t>(offset, 0, frames - 1));
+}
+
+} // namespace guitarrackcraft
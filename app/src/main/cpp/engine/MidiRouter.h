@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUITARRACKCRAFT_MIDI_ROUTER_H
+#define GUITARRACKCRAFT_MIDI_ROUTER_H
+
+#include "../plugin/PluginChain.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/** One complete channel message (or single-byte realtime message) with its arrival time. */
+struct MidiMessage {
+    int64_t timeNs = 0;  // CLOCK_MONOTONIC
+    uint8_t size = 0;
+    uint8_t data[3] = {};
+};
+
+/**
+ * Splits a raw MIDI byte stream into messages: running status, realtime bytes interleaved
+ * anywhere, SysEx skipped (plugins get at most 3-byte messages). One stream per parser.
+ */
+class MidiParser {
+public:
+    /** Feed 'size' bytes received at 'timeNs'; calls emit(const MidiMessage&) per message. */
+    template <typename Emit>
+    void feed(const uint8_t* bytes, size_t size, int64_t timeNs, Emit&& emit) {
+        for (size_t i = 0; i < size; ++i) {
+            const uint8_t b = bytes[i];
+            if (b >= 0xF8 || b == 0xF6) {  // realtime and tune request: single byte
+                MidiMessage msg;
+                msg.timeNs = timeNs;
+                msg.size = 1;
+                msg.data[0] = b;
+                emit(msg);
+                if (b == 0xF6) status_ = 0;  // realtime bytes leave running status alone
+                continue;
+            }
+            if (b & 0x80) {
+                count_ = 0;
+                status_ = b;
+                if (b < 0xF0) {
+                    expected_ = (b & 0xF0) == 0xC0 || (b & 0xF0) == 0xD0 ? 1 : 2;
+                } else if (b == 0xF1 || b == 0xF3) {
+                    expected_ = 1;
+                } else if (b == 0xF2) {
+                    expected_ = 2;
+                } else if (b != 0xF0) {
+                    status_ = 0;  // end of SysEx or undefined
+                }
+                continue;
+            }
+            if (status_ == 0 || status_ == 0xF0) continue;  // stray data or inside SysEx
+            data_[count_++] = b;
+            if (count_ < expected_) continue;
+            MidiMessage msg;
+            msg.timeNs = timeNs;
+            msg.size = static_cast<uint8_t>(1 + expected_);
+            msg.data[0] = status_;
+            msg.data[1] = data_[0];
+            msg.data[2] = expected_ > 1 ? data_[1] : 0;
+            emit(msg);
+            count_ = 0;
+            if (status_ >= 0xF0) status_ = 0;  // no running status for system common
+        }
+    }
+
+    void reset() { status_ = 0; count_ = 0; }
+
+private:
+    uint8_t status_ = 0;
+    uint8_t expected_ = 0;
+    uint8_t count_ = 0;
+    uint8_t data_[2] = {};
+};
+
+/** A learned controller binding: one CC or note driving a control port or the host bypass. */
+struct MidiMapping {
+    enum class Source : uint8_t { ControlChange, Note };
+    static constexpr uint8_t kAnyChannel = 0xFF;
+    static constexpr int32_t kBypassPort = -1;
+
+    Source source = Source::ControlChange;
+    uint8_t channel = kAnyChannel;  // 0-15
+    uint8_t number = 0;             // CC or note number
+    int32_t pluginIndex = 0;        // chain order
+    int32_t portIndex = kBypassPort;
+    // Value at CC 0 / note off and at CC 127 / note on. For the bypass, values >= 0.5 mean
+    // the plugin is engaged (not bypassed).
+    float min = 0.0f;
+    float max = 1.0f;
+    bool toggle = false;            // press (CC >= 64, note on) flips between min and max
+};
+
+/**
+ * Turns incoming MIDI into PluginChain::HostEvents for the audio thread: learned CC and note
+ * mappings become control writes or bypass switches; every other channel message goes to the
+ * chain's MIDI-capable plugins as is.
+ *
+ * Mappings are published RCU-style, as PluginChain publishes its snapshots: writers copy the
+ * table, swap the pointer and wait for route() calls holding the old one before freeing it, so
+ * the audio thread never blocks or allocates. Plugin indices are chain positions; callers
+ * that move plugins re-learn or clear.
+ *
+ * Thread safety:
+ *   - learn()/cancelLearn()/setMappings()/clear()/mappings() from control threads
+ *   - capture() from the MIDI input thread (completes a pending learn)
+ *   - route() from the audio thread only
+ */
+class MidiRouter {
+public:
+    static constexpr size_t kMaxMappings = 128;
+
+    MidiRouter();
+    ~MidiRouter();
+    MidiRouter(const MidiRouter&) = delete;
+    MidiRouter& operator=(const MidiRouter&) = delete;
+
+    /** Bind the next CC or note that arrives to this target (portIndex kBypassPort: bypass),
+     *  replacing any mapping of the same source or target. */
+    void learn(int32_t pluginIndex, int32_t portIndex, float min, float max, bool toggle);
+    void cancelLearn();
+    bool isLearning() const { return learning_.load(std::memory_order_acquire); }
+
+    /** MIDI input thread: if a learn is pending and 'msg' is a CC or note on, bind it and return
+     *  true (the message is consumed). */
+    bool capture(const MidiMessage& msg);
+
+    /** Replace the whole table (at most kMaxMappings entries are kept). */
+    void setMappings(std::vector<MidiMapping> mappings);
+    std::vector<MidiMapping> mappings() const;
+    void clear() { setMappings({}); }
+
+    /** Audio thread: resolve 'msg' into at most 'capacity' events at 'frame'; returns the count. */
+    uint32_t route(const MidiMessage& msg, uint32_t frame, PluginChain::HostEvent* out,
+                   uint32_t capacity) const;
+
+    /**
+     * Frame in a block of 'frames' at which an event that arrived at 'eventNs' is played, for a
+     * block that starts playing at 'blockNs'. Events are delayed by one block period so the
+     * spacing between them survives: offset = frames - (blockNs - eventNs) * rate, clamped.
+     */
+    static uint32_t frameOffset(int64_t eventNs, int64_t blockNs, uint32_t frames, float sampleRate);
+
+private:
+    struct Table {
+        std::vector<MidiMapping> mappings;
+    };
+
+    /** Swap in 'next' and free the old table once no route() holds it. Caller holds writeMutex_. */
+    void publish(std::unique_ptr<Table> next);
+
+    std::atomic<Table*> table_;
+    mutable std::atomic<int> activeReaders_{0};
+    mutable std::mutex writeMutex_;  // serializes writers and guards pending_
+
+    MidiMapping pending_;
+    std::atomic<bool> learning_{false};
+};
+
+} // namespace guitarrackcraft
+
+#endif // GUITARRACKCRAFT_MIDI_ROUTER_H
@@ -18,10 +18,19 @@
  */
 
 #include "OfflineProcessor.h"
-#include "utils/WavIO.h"
+#include "utils/AudioKernels.h"
+#include "utils/MappedWavFile.h"
+#include "utils/BufferPipe.h"
+#include "utils/FloatEnv.h"
+#include "utils/LogCompat.h"
+#include "utils/PolyphaseResampler.h"
+#include "utils/ThreadPolicy.h"
+#include "utils/WavStreamWriter.h"
 #include <algorithm>
+#include <atomic>
 #include <cstring>
-#include <android/log.h>
+#include <mutex>
+#include <thread>
 
 #define LOG_TAG "OfflineProcessor"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -29,97 +38,271 @@
 
 namespace guitarrackcraft {
 
-OfflineProcessor::OfflineProcessor(PluginChain& chain)
-    : chain_(chain)
+OfflineProcessor::OfflineProcessor(const PluginRegistry& registry)
+    : registry_(registry)
 {
 }
 
 bool OfflineProcessor::processFile(
+    const PluginChain::ChainState& state,
     const std::string& inputPath,
     const std::string& outputPath,
     ProgressCallback progressCallback) {
-    
-    LOGI("Processing file: %s -> %s", inputPath.c_str(), outputPath.c_str());
+    return render(state, inputPath, outputPath, progressCallback);
+}
+
+size_t OfflineProcessor::processBatch(const std::vector<Job>& jobs, ProgressCallback progressCallback) {
+    if (jobs.empty()) return 0;
+    size_t threads = maxThreads_ != 0 ? maxThreads_ : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, jobs.size());
+    LOGI("processBatch: %zu jobs on %zu threads", jobs.size(), threads);
 
-    // Read input file
-    std::vector<float> inputSamples;
-    uint32_t sampleRate = 44100;
-    uint32_t numChannels = 1;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> succeeded{0};
+    std::mutex progressMutex;
+    std::vector<float> progress(jobs.size(), 0.0f);
+    float progressSum = 0.0f;
+
+    auto worker = [&] {
+        applyThreadRole(ThreadRole::Background);
+        for (size_t i = next.fetch_add(1); i < jobs.size(); i = next.fetch_add(1)) {
+            ProgressCallback jobProgress;
+            if (progressCallback) {
+                jobProgress = [&, i](float p) {
+                    std::lock_guard<std::mutex> lock(progressMutex);
+                    progressSum += p - progress[i];
+                    progress[i] = p;
+                    progressCallback(progressSum / jobs.size());
+                };
+            }
+            if (render(jobs[i].state, jobs[i].inputPath, jobs[i].outputPath, jobProgress)) {
+                succeeded.fetch_add(1);
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+    LOGI("processBatch: %zu of %zu jobs succeeded", succeeded.load(), jobs.size());
+    return succeeded.load();
+}
 
-    if (!guitarrackcraft::readWavFile(inputPath, inputSamples, sampleRate, numChannels)) {
-        LOGE("Failed to read input file");
+std::unique_ptr<PluginChain> OfflineProcessor::buildChain(const PluginChain::ChainState& state,
+                                                          uint32_t rate) const {
+    auto chain = std::make_unique<PluginChain>();
+    chain->setCrossfadeFrames(0);  // no fade-in from an empty chain at frame 0
+    chain->setSampleRate(static_cast<float>(rate), BUFFER_SIZE);
+    for (const PluginState& pluginState : state.plugins) {
+        // Saved states carry the bare URI; registry ids are "format:uri" (LV2 only today)
+        auto plugin = registry_.createPlugin("LV2:" + pluginState.pluginUri);
+        if (!plugin) {
+            LOGE("Offline chain: cannot instantiate %s", pluginState.pluginUri.c_str());
+            return nullptr;
+        }
+        const int index = chain->addPlugin(std::move(plugin));
+        if (index < 0 || !chain->restorePluginState(index, pluginState)) {
+            LOGE("Offline chain: cannot restore %s", pluginState.pluginUri.c_str());
+            return nullptr;
+        }
+    }
+    return chain;
+}
+
+bool OfflineProcessor::render(
+    const PluginChain::ChainState& state,
+    const std::string& inputPath,
+    const std::string& outputPath,
+    const ProgressCallback& progressCallback) const {
+
+    LOGI("Processing file: %s -> %s", inputPath.c_str(), outputPath.c_str());
+
+    // Map the input; blocks are converted straight out of the mapping
+    MappedWavFile input;
+    if (!input.open(inputPath)) {
+        LOGE("Failed to read input file: %s", input.error().c_str());
+        return false;
+    }
+    const uint32_t sampleRate = input.sampleRate();
+    const uint32_t numChannels = input.channels();
+    const size_t totalFrames = input.frames();
+    if (totalFrames == 0) {
+        LOGE("Input file has no audio");
         return false;
     }
 
-    LOGI("Loaded file: %zu samples, %u Hz, %u channels", 
-         inputSamples.size(), sampleRate, numChannels);
+    // The chain runs at renderSampleRate_ (the live rate, so models and IRs
+    // sound as they do on stage); the result goes back to the file's rate so the
+    // output lines up sample for sample with the input take.
+    const uint32_t renderRate = renderSampleRate_ != 0 ? renderSampleRate_ : sampleRate;
+    PolyphaseResampler toRender;
+    PolyphaseResampler toFile;
+    toRender.configure(sampleRate, renderRate, 2, BUFFER_SIZE);
+    toFile.configure(renderRate, sampleRate, 2, BUFFER_SIZE);
 
-    // Activate plugin chain
-    chain_.setSampleRate(static_cast<float>(sampleRate));
-    chain_.activate();
+    LOGI("Loaded file: %zu frames, %u Hz, %u channels (rendering at %u Hz)",
+         totalFrames, sampleRate, numChannels, renderRate);
 
-    // Convert to stereo if needed (guitar effects expect stereo)
-    std::vector<float> stereoInput;
-    if (numChannels == 1) {
-        stereoInput.resize(inputSamples.size() * 2);
-        for (size_t i = 0; i < inputSamples.size(); ++i) {
-            stereoInput[i * 2] = inputSamples[i];
-            stereoInput[i * 2 + 1] = inputSamples[i];
-        }
-    } else {
-        stereoInput = std::move(inputSamples);
+    std::unique_ptr<PluginChain> chain;
+    {
+        // One chain is built at a time; the renders themselves run in parallel
+        std::lock_guard<std::mutex> lock(buildMutex_);
+        chain = buildChain(state, renderRate);
+    }
+    if (!chain) {
+        return false;
+    }
+    auto releaseChain = [&] {
+        std::lock_guard<std::mutex> lock(buildMutex_);
+        chain->deactivate();
+        chain.reset();
+    };
+
+    WavStreamWriter output;
+    if (!output.open(outputPath, sampleRate, 2)) {
+        LOGE("Failed to create output file");
+        releaseChain();
+        return false;
     }
 
-    // Process through chain in blocks
-    size_t totalFrames = stereoInput.size() / 2;
-    std::vector<float> outputSamples(stereoInput.size());
-    
-    const float* inputPtrs[2];
-    float* outputPtrs[2];
-    
+    // Working buffers: memory is fixed by BUFFER_SIZE, not by the file length
     std::vector<float> inputLeft(BUFFER_SIZE);
     std::vector<float> inputRight(BUFFER_SIZE);
+    const size_t renderCapacity = toRender.maxOutputFrames(std::max(BUFFER_SIZE, static_cast<size_t>(toRender.taps())));
+    std::vector<float> renderLeft(renderCapacity);
+    std::vector<float> renderRight(renderCapacity);
     std::vector<float> outputLeft(BUFFER_SIZE);
     std::vector<float> outputRight(BUFFER_SIZE);
+    const size_t fileCapacity = toFile.maxOutputFrames(std::max(BUFFER_SIZE, static_cast<size_t>(toFile.taps())));
+    std::vector<float> fileLeft(fileCapacity);
+    std::vector<float> fileRight(fileCapacity);
+    float* renderPtrs[2] = {renderLeft.data(), renderRight.data()};
+    float* filePtrs[2] = {fileLeft.data(), fileRight.data()};
 
-    for (size_t offset = 0; offset < totalFrames; offset += BUFFER_SIZE) {
-        size_t framesToProcess = std::min(BUFFER_SIZE, totalFrames - offset);
-        
-        // Deinterleave input
-        for (size_t i = 0; i < framesToProcess; ++i) {
-            size_t idx = (offset + i) * 2;
-            inputLeft[i] = stereoInput[idx];
-            inputRight[i] = stereoInput[idx + 1];
+    // Double-buffered I/O: a reader thread converts input blocks ahead of the
+    // chain, a writer thread streams finished blocks to disk behind it.
+    BufferPipe inputPipe(kPipeBlocks, BUFFER_SIZE * numChannels);
+    BufferPipe outputPipe(kPipeBlocks, fileCapacity * 2);
+    std::atomic<bool> writeFailed{false};
+
+    std::thread reader([&] {
+        applyThreadRole(ThreadRole::Background);
+        for (size_t offset = 0; offset < totalFrames;) {
+            BufferPipe::Block* block = inputPipe.acquireFree();
+            if (!block) return;
+            block->frames = input.readFrames(offset, BUFFER_SIZE, block->data.data());
+            offset += block->frames;
+            block->last = offset >= totalFrames;
+            input.prefetch(offset, BUFFER_SIZE * kPipeBlocks);
+            inputPipe.submit(block);
         }
+    });
 
-        // Set up pointers
-        inputPtrs[0] = inputLeft.data();
-        inputPtrs[1] = inputRight.data();
-        outputPtrs[0] = outputLeft.data();
-        outputPtrs[1] = outputRight.data();
+    std::thread writer([&] {
+        applyThreadRole(ThreadRole::Background);
+        const size_t checkpointFrames = static_cast<size_t>(kCheckpointSeconds * sampleRate);
+        size_t remaining = totalFrames;  // trims the resamplers' rounding
+        size_t sinceCheckpoint = 0;
+        while (BufferPipe::Block* block = outputPipe.acquireFilled()) {
+            const size_t frames = std::min(block->frames, remaining);
+            const bool last = block->last;
+            if (!output.write(block->data.data(), frames)) {
+                writeFailed.store(true);
+                inputPipe.close();
+                outputPipe.close();
+                return;
+            }
+            remaining -= frames;
+            sinceCheckpoint += frames;
+            if (sinceCheckpoint >= checkpointFrames) {
+                output.checkpoint();
+                sinceCheckpoint = 0;
+            }
+            outputPipe.release(block);
+            if (last) return;
+        }
+    });
 
-        // Process
-        chain_.process(inputPtrs, outputPtrs, static_cast<uint32_t>(framesToProcess));
+    // Queue fileLeft/fileRight for the writer
+    auto emit = [&](size_t frames, bool last) {
+        BufferPipe::Block* block = outputPipe.acquireFree();
+        if (!block) return false;
+        kernels::interleaveStereoPeak(fileLeft.data(), fileRight.data(), block->data.data(), frames);
+        block->frames = frames;
+        block->last = last;
+        outputPipe.submit(block);
+        return true;
+    };
+    // Run render-rate audio through the chain in slices of at most BUFFER_SIZE
+    auto renderBlock = [&](size_t frames) {
+        for (size_t done = 0; done < frames; done += BUFFER_SIZE) {
+            const uint32_t n = static_cast<uint32_t>(std::min(BUFFER_SIZE, frames - done));
+            const float* inputPtrs[2] = {renderLeft.data() + done, renderRight.data() + done};
+            float* outputPtrs[2] = {outputLeft.data(), outputRight.data()};
+            chain->process(inputPtrs, outputPtrs, n);
+            const float* backPtrs[2] = {outputLeft.data(), outputRight.data()};
+            if (!emit(toFile.process(backPtrs, n, filePtrs), false)) return false;
+        }
+        return true;
+    };
 
-        // Interleave output
-        for (size_t i = 0; i < framesToProcess; ++i) {
-            size_t idx = (offset + i) * 2;
-            outputSamples[idx] = outputLeft[i];
-            outputSamples[idx + 1] = outputRight[i];
+    // Same float mode as the live audio thread, so renders match and tails stay fast
+    const ScopedFloatMode flushDenormals(true);
+    bool ok = true;
+    size_t processed = 0;
+    while (ok) {
+        BufferPipe::Block* block = inputPipe.acquireFilled();
+        if (!block || writeFailed.load()) {
+            ok = false;
+            break;
         }
+        const size_t framesToProcess = block->frames;
+        const bool last = block->last;
+
+        // Deinterleave input
+        const float* interleaved = block->data.data();
+        if (numChannels == 1) {
+            std::copy(interleaved, interleaved + framesToProcess, inputLeft.begin());
+            std::copy(interleaved, interleaved + framesToProcess, inputRight.begin());
+        } else if (numChannels == 2) {
+            kernels::deinterleaveStereo(interleaved, inputLeft.data(), inputRight.data(), framesToProcess);
+        } else {
+            for (size_t i = 0; i < framesToProcess; ++i) {
+                inputLeft[i] = interleaved[i * numChannels];
+                inputRight[i] = interleaved[i * numChannels + 1];
+            }
+        }
+        inputPipe.release(block);
+
+        // Process
+        const float* inputPtrs[2] = {inputLeft.data(), inputRight.data()};
+        ok = renderBlock(toRender.process(inputPtrs, framesToProcess, renderPtrs));
+        processed += framesToProcess;
 
         // Report progress
         if (progressCallback) {
-            float progress = static_cast<float>(offset + framesToProcess) / totalFrames;
-            progressCallback(progress);
+            progressCallback(static_cast<float>(processed) / totalFrames);
+        }
+
+        if (last) {
+            // Drain both resamplers' look-ahead
+            ok = ok && renderBlock(toRender.flush(renderPtrs)) && emit(toFile.flush(filePtrs), true);
+            break;
         }
     }
+    if (!ok) {
+        inputPipe.close();
+        outputPipe.close();
+    }
+    reader.join();
+    writer.join();
 
-    chain_.deactivate();
+    releaseChain();
 
-    // Write output file
-    if (!guitarrackcraft::writeWavFile(outputPath, outputSamples, sampleRate, 2)) {
-        LOGE("Failed to write output file");
+    // Whatever was written is a valid WAV, even after a failure
+    const bool closed = output.close();
+    if (!ok || writeFailed.load() || !closed) {
+        LOGE("Failed to write output file (%zu of %zu frames)", output.framesWritten(), totalFrames);
         return false;
     }
 
@@ -20,38 +20,88 @@
 #ifndef GUITARRACKCRAFT_OFFLINE_PROCESSOR_H
 #define GUITARRACKCRAFT_OFFLINE_PROCESSOR_H
 
+#include <cstdint>
 #include <string>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "plugin/PluginChain.h"
+#include "plugin/PluginRegistry.h"
 
 namespace guitarrackcraft {
 
 /**
- * Processes audio files offline through the plugin chain.
- * Not real-time, so can use blocking operations.
+ * Processes audio files offline through a private copy of a plugin chain.
+ * Not real-time, so can use blocking operations. Each render instantiates its own
+ * chain from a saved ChainState, so the live engine's chain is never touched
+ * (no sample-rate change, no deactivate), and a batch of jobs renders concurrently,
+ * one private chain per worker thread.
+ *
+ * Streams block by block: input is read ahead and output written behind on
+ * worker threads, memory does not depend on the file length, and a render that
+ * fails partway leaves a valid WAV of what was done.
  */
 class OfflineProcessor {
 public:
     using ProgressCallback = std::function<void(float progress)>;
 
-    OfflineProcessor(PluginChain& chain);
+    /** One render: an input file through the chain described by state. */
+    struct Job {
+        std::string inputPath;
+        std::string outputPath;
+        PluginChain::ChainState state;
+    };
+
+    explicit OfflineProcessor(const PluginRegistry& registry);
     ~OfflineProcessor() = default;
 
     /**
-     * Process an audio file through the plugin chain.
+     * Run the chain at this rate (e.g. the live engine rate) instead of the
+     * input file's; 0 keeps the file rate. The output is always written at the
+     * input file's rate.
+     */
+    void setRenderSampleRate(uint32_t rate) { renderSampleRate_ = rate; }
+
+    /** Concurrent renders for processBatch(); 0 (default) uses every core. */
+    void setMaxThreads(size_t threads) { maxThreads_ = threads; }
+
+    /**
+     * Process an audio file through a private chain built from state.
      * @param inputPath Path to input WAV file
      * @param outputPath Path to output WAV file
      * @param progressCallback Optional callback for progress updates (0.0-1.0)
      * @return true if processing succeeded
      */
     bool processFile(
+        const PluginChain::ChainState& state,
         const std::string& inputPath,
         const std::string& outputPath,
         ProgressCallback progressCallback = nullptr);
 
+    /**
+     * Render every job, up to setMaxThreads() at a time. Progress is the mean over
+     * all jobs and may be reported from any worker thread. Returns the number of
+     * jobs that succeeded.
+     */
+    size_t processBatch(const std::vector<Job>& jobs, ProgressCallback progressCallback = nullptr);
+
 private:
-    PluginChain& chain_;
+    /** Instantiate and restore state's plugins into a fresh chain at rate. Caller holds
+     *  buildMutex_. */
+    std::unique_ptr<PluginChain> buildChain(const PluginChain::ChainState& state, uint32_t rate) const;
+    bool render(const PluginChain::ChainState& state, const std::string& inputPath,
+                const std::string& outputPath, const ProgressCallback& progressCallback) const;
+
+    const PluginRegistry& registry_;
+    uint32_t renderSampleRate_ = 0;
+    size_t maxThreads_ = 0;
+    // Plugin instantiation, state restore and teardown share the factories' LilvWorld,
+    // which is not thread safe: batch workers take turns for those and render in parallel.
+    mutable std::mutex buildMutex_;
     static constexpr size_t BUFFER_SIZE = 4096;
+    static constexpr size_t kPipeBlocks = 2;            // double-buffered reader and writer
+    static constexpr double kCheckpointSeconds = 1.0;   // header rewrite interval
 };
 
 } // namespace guitarrackcraft
@@ -20,6 +20,7 @@
 #ifndef GUITARRACKCRAFT_RING_BUFFER_H
 #define GUITARRACKCRAFT_RING_BUFFER_H
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <vector>
@@ -56,7 +57,7 @@ public:
     }
 
     /**
-     * Write samples into the ring buffer.
+     * Write samples into the ring buffer: at most two memcpy()s, split at the wrap point.
      * @return number of floats actually written (may be < count if full)
      */
     size_t write(const float* data, size_t count) {
@@ -64,17 +65,44 @@ public:
         size_t r = readPos_.load(std::memory_order_acquire);
         size_t available = capacity() - (w - r);
         size_t toWrite = count < available ? count : available;
+        if (toWrite == 0) return 0;
 
-        for (size_t i = 0; i < toWrite; ++i) {
-            buffer_[(w + i) & mask_] = data[i];
-        }
+        const size_t start = w & mask_;
+        const size_t first = toWrite < capacity() - start ? toWrite : capacity() - start;
+        std::memcpy(buffer_.data() + start, data, first * sizeof(float));
+        std::memcpy(buffer_.data(), data + first, (toWrite - first) * sizeof(float));
 
         writePos_.store(w + toWrite, std::memory_order_release);
         return toWrite;
     }
 
     /**
-     * Read samples from the ring buffer.
+     * Interleave two channels straight into the ring (producer only), so the caller
+     * needs no scratch buffer. Writes whole frames only.
+     * @return number of frames actually written (may be < frames if full)
+     */
+    size_t writeInterleaved(const float* left, const float* right, size_t frames) {
+        size_t w = writePos_.load(std::memory_order_relaxed);
+        size_t r = readPos_.load(std::memory_order_acquire);
+        size_t availableFrames = (capacity() - (w - r)) / 2;
+        size_t toWrite = frames < availableFrames ? frames : availableFrames;
+
+        float* base = buffer_.data();
+        size_t pos = w & mask_;
+        for (size_t i = 0; i < toWrite * 2;) {
+            const size_t run = std::min(toWrite * 2 - i, capacity() - pos);
+            for (size_t j = 0; j < run; ++j, ++i) {
+                base[pos + j] = (i & 1) ? right[i >> 1] : left[i >> 1];
+            }
+            pos = 0;
+        }
+
+        writePos_.store(w + toWrite * 2, std::memory_order_release);
+        return toWrite;
+    }
+
+    /**
+     * Read samples from the ring buffer: at most two memcpy()s, split at the wrap point.
      * @return number of floats actually read (may be < count if empty)
      */
     size_t read(float* data, size_t count) {
@@ -82,15 +110,51 @@ public:
         size_t w = writePos_.load(std::memory_order_acquire);
         size_t available = w - r;
         size_t toRead = count < available ? count : available;
+        if (toRead == 0) return 0;
 
-        for (size_t i = 0; i < toRead; ++i) {
-            data[i] = buffer_[(r + i) & mask_];
-        }
+        const size_t start = r & mask_;
+        const size_t first = toRead < capacity() - start ? toRead : capacity() - start;
+        std::memcpy(data, buffer_.data() + start, first * sizeof(float));
+        std::memcpy(data + first, buffer_.data(), (toRead - first) * sizeof(float));
 
         readPos_.store(r + toRead, std::memory_order_release);
         return toRead;
     }
 
+    struct Span {
+        const float* data = nullptr;
+        size_t count = 0;
+    };
+
+    /**
+     * Zero-copy view of what is readable (consumer only): up to two contiguous spans in
+     * order, the second non-empty only when the data wraps. Consume with skip().
+     * @return total number of floats in both spans
+     */
+    size_t peek(Span& first, Span& second) const {
+        size_t r = readPos_.load(std::memory_order_relaxed);
+        size_t w = writePos_.load(std::memory_order_acquire);
+        const size_t available = w - r;
+        const size_t start = r & mask_;
+        first.data = buffer_.data() + start;
+        first.count = available < capacity() - start ? available : capacity() - start;
+        second.data = buffer_.data();
+        second.count = available - first.count;
+        return available;
+    }
+
+    /**
+     * Drop up to count samples from the read side (consumer only).
+     * @return number of floats dropped
+     */
+    size_t skip(size_t count) {
+        size_t r = readPos_.load(std::memory_order_relaxed);
+        size_t w = writePos_.load(std::memory_order_acquire);
+        size_t toSkip = count < w - r ? count : w - r;
+        readPos_.store(r + toSkip, std::memory_order_release);
+        return toSkip;
+    }
+
     size_t available() const {
         size_t w = writePos_.load(std::memory_order_acquire);
         size_t r = readPos_.load(std::memory_order_acquire);
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "SignalAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(HAVE_FFTW3) && HAVE_FFTW3 == 1
+#include <fftw3.h>
+#endif
+
+namespace guitarrackcraft {
+
+namespace {
+
+constexpr float kPi = 3.14159265358979f;
+
+float toDb(float amplitude, float floorDb) {
+    return amplitude > 0.0f ? std::max(floorDb, 20.0f * std::log10(amplitude)) : floorDb;
+}
+
+} // namespace
+
+SignalAnalyzer::SignalAnalyzer(float sampleRate)
+    : sampleRate_(sampleRate),
+      hann_(kWindowFrames),
+      fftIn_(kWindowFrames),
+      bins_(kWindowFrames / 2 + 1),
+      bandEdges_(TelemetryBlock::kSpectrumBands + 1),
+      yin_(kPitchFrames / 2) {
+    float sum = 0.0f;
+    for (uint32_t n = 0; n < kWindowFrames; ++n) {
+        hann_[n] = 0.5f - 0.5f * std::cos(2.0f * kPi * n / kWindowFrames);
+        sum += hann_[n];
+    }
+    hannGain_ = sum;
+
+    // Log-spaced band edges in bins; bands narrower than a bin take the bin they fall in
+    const float nyquist = sampleRate_ * 0.5f;
+    const float binHz = sampleRate_ / kWindowFrames;
+    const uint32_t lastBin = kWindowFrames / 2;
+    for (uint32_t b = 0; b <= TelemetryBlock::kSpectrumBands; ++b) {
+        const float hz = kMinBandHz * std::pow(nyquist / kMinBandHz,
+                                               static_cast<float>(b) / TelemetryBlock::kSpectrumBands);
+        bandEdges_[b] = std::min(lastBin, static_cast<uint32_t>(hz / binHz));
+    }
+
+#if defined(HAVE_FFTW3) && HAVE_FFTW3 == 1
+    plan_ = fftwf_plan_dft_r2c_1d(static_cast<int>(kWindowFrames), fftIn_.data(),
+                                  reinterpret_cast<fftwf_complex*>(bins_.data()), FFTW_ESTIMATE);
+#else
+    work_.resize(kWindowFrames);
+    twiddles_.resize(kWindowFrames / 2);
+    for (uint32_t k = 0; k < kWindowFrames / 2; ++k) {
+        twiddles_[k] = std::polar(1.0f, -2.0f * kPi * k / kWindowFrames);
+    }
+#endif
+}
+
+SignalAnalyzer::~SignalAnalyzer() {
+#if defined(HAVE_FFTW3) && HAVE_FFTW3 == 1
+    if (plan_) fftwf_destroy_plan(static_cast<fftwf_plan>(plan_));
+#endif
+}
+
+void SignalAnalyzer::analyze(const float* window, TelemetryBlock::Analysis& out) {
+    const float* recent = window + (kWindowFrames - kPitchFrames);
+    double energy = 0.0;
+    for (uint32_t n = 0; n < kPitchFrames; ++n) energy += double{recent[n]} * recent[n];
+    out.rmsDb = toDb(static_cast<float>(std::sqrt(energy / kPitchFrames)), kFloorDb);
+
+    float clarity = 0.0f;
+    out.pitchHz = out.rmsDb > kSilenceDb ? detectPitch(recent, clarity) : 0.0f;
+    out.pitchClarity = clarity;
+    computeSpectrum(window, out.spectrumDb);
+    decimateScope(window, out.scopeMin, out.scopeMax);
+}
+
+float SignalAnalyzer::detectPitch(const float* x, float& clarity) {
+    // YIN (de Cheveigne & Kawahara): difference function over half the frames, normalized by
+    // its running mean; the first dip under the threshold is the period.
+    const uint32_t w = kPitchFrames / 2;
+    const uint32_t tauMin = std::max<uint32_t>(2, static_cast<uint32_t>(sampleRate_ / kMaxPitchHz));
+    const uint32_t tauMax = std::min<uint32_t>(w - 2, static_cast<uint32_t>(sampleRate_ / kMinPitchHz) + 1);
+    clarity = 0.0f;
+    if (tauMin >= tauMax) return 0.0f;
+
+    yin_[0] = 1.0f;
+    double running = 0.0;
+    for (uint32_t tau = 1; tau <= tauMax + 1; ++tau) {
+        float d = 0.0f;
+        for (uint32_t j = 0; j < w; ++j) {
+            const float diff = x[j] - x[j + tau];
+            d += diff * diff;
+        }
+        running += d;
+        yin_[tau] = running > 0.0 ? static_cast<float>(d * tau / running) : 1.0f;
+    }
+
+    uint32_t best = 0;
+    for (uint32_t tau = tauMin; tau <= tauMax; ++tau) {
+        if (yin_[tau] < kYinThreshold) {
+            while (tau + 1 <= tauMax && yin_[tau + 1] < yin_[tau]) ++tau;
+            best = tau;
+            break;
+        }
+    }
+    if (best == 0) {
+        const float* lowest = std::min_element(yin_.data() + tauMin, yin_.data() + tauMax + 1);
+        clarity = std::clamp(1.0f - *lowest, 0.0f, 1.0f);
+        return 0.0f;
+    }
+    clarity = std::clamp(1.0f - yin_[best], 0.0f, 1.0f);
+
+    // Parabola through the dip and its neighbours
+    const float a = yin_[best - 1];
+    const float b = yin_[best];
+    const float c = yin_[best + 1];
+    const float denom = a - 2.0f * b + c;
+    const float shift = denom != 0.0f ? std::clamp(0.5f * (a - c) / denom, -0.5f, 0.5f) : 0.0f;
+    return sampleRate_ / (static_cast<float>(best) + shift);
+}
+
+void SignalAnalyzer::computeSpectrum(const float* x, float* bandsDb) {
+    for (uint32_t n = 0; n < kWindowFrames; ++n) fftIn_[n] = x[n] * hann_[n];
+    transform();
+    const float scale = 2.0f / hannGain_;
+    for (uint32_t b = 0; b < TelemetryBlock::kSpectrumBands; ++b) {
+        const uint32_t lo = bandEdges_[b];
+        const uint32_t hi = std::max(lo + 1, bandEdges_[b + 1]);
+        float peak = 0.0f;
+        for (uint32_t k = lo; k < hi && k < bins_.size(); ++k) peak = std::max(peak, std::norm(bins_[k]));
+        bandsDb[b] = toDb(std::sqrt(peak) * scale, kFloorDb);
+    }
+}
+
+void SignalAnalyzer::transform() {
+#if defined(HAVE_FFTW3) && HAVE_FFTW3 == 1
+    fftwf_execute(static_cast<fftwf_plan>(plan_));
+#else
+    // Iterative radix-2 over the real input as a complex sequence; only the lower half is kept.
+    const uint32_t n = kWindowFrames;
+    std::vector<std::complex<float>>& a = work_;
+    for (uint32_t i = 0, j = 0; i < n; ++i) {
+        a[j] = fftIn_[i];
+        // Bit-reversed increment of j
+        uint32_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j |= bit;
+    }
+    for (uint32_t len = 2; len <= n; len <<= 1) {
+        const uint32_t half = len >> 1;
+        const uint32_t step = n / len;
+        for (uint32_t i = 0; i < n; i += len) {
+            for (uint32_t k = 0; k < half; ++k) {
+                const std::complex<float> v = a[i + k + half] * twiddles_[k * step];
+                a[i + k + half] = a[i + k] - v;
+                a[i + k] += v;
+            }
+        }
+    }
+    std::copy(a.begin(), a.begin() + bins_.size(), bins_.begin());
+#endif
+}
+
+void SignalAnalyzer::decimateScope(const float* window, float* mins, float* maxs) {
+    // Latest rising zero crossing that still leaves a full scope of frames after it
+    const uint32_t latest = kWindowFrames - kScopeFrames;
+    uint32_t start = latest;
+    for (uint32_t i = latest; i > 0 && i + kScopeFrames / 2 > latest; --i) {
+        if (window[i - 1] < 0.0f && window[i] >= 0.0f) {
+            start = i;
+            break;
+        }
+    }
+    constexpr uint32_t per = kScopeFrames / TelemetryBlock::kScopePoints;
+    for (uint32_t p = 0; p < TelemetryBlock::kScopePoints; ++p) {
+        const float* seg = window + start + p * per;
+        const auto range = std::minmax_element(seg, seg + per);
+        mins[p] = *range.first;
+        maxs[p] = *range.second;
+    }
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUITARRACKCRAFT_SIGNAL_ANALYZER_H
+#define GUITARRACKCRAFT_SIGNAL_ANALYZER_H
+
+#include "../utils/TelemetryBlock.h"
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Tuner, spectrum and scope over one window of mono audio, for AnalysisTap's background
+ * thread (allocates only in the constructor, but is far too slow for the audio thread).
+ *
+ *   - pitch: YIN over the newest kPitchFrames frames, kMinPitchHz..kMaxPitchHz, parabolic
+ *     refinement; 0 below kSilenceDb or when no period stands out
+ *   - spectrum: Hann-windowed FFT of the whole window (FFTW when built with HAVE_FFTW3, a
+ *     radix-2 fallback otherwise), peak per log-spaced band from kMinBandHz up to Nyquist,
+ *     scaled so a full-scale sine reads 0 dB
+ *   - scope: min/max decimation of the newest kScopeFrames frames from a rising zero crossing,
+ *     so a steady note stands still
+ */
+class SignalAnalyzer {
+public:
+    static constexpr uint32_t kWindowFrames = 4096;
+    static constexpr uint32_t kPitchFrames = 2048;
+    static constexpr uint32_t kScopeFrames = 2048;
+    static constexpr float kMinPitchHz = 50.0f;
+    static constexpr float kMaxPitchHz = 1500.0f;
+    static constexpr float kYinThreshold = 0.15f;
+    static constexpr float kSilenceDb = -60.0f;
+    static constexpr float kMinBandHz = 20.0f;
+    static constexpr float kFloorDb = -120.0f;
+
+    explicit SignalAnalyzer(float sampleRate);
+    ~SignalAnalyzer();
+
+    SignalAnalyzer(const SignalAnalyzer&) = delete;
+    SignalAnalyzer& operator=(const SignalAnalyzer&) = delete;
+
+    float sampleRate() const { return sampleRate_; }
+
+    /** 'window' holds kWindowFrames frames, oldest first. Fills the result fields of 'out'
+     *  (not sequence, source or updates). */
+    void analyze(const float* window, TelemetryBlock::Analysis& out);
+
+private:
+    float detectPitch(const float* x, float& clarity);
+    void computeSpectrum(const float* x, float* bandsDb);
+    static void decimateScope(const float* window, float* mins, float* maxs);
+    void transform();  // fftIn_ -> bins_[0, kWindowFrames / 2]
+
+    float sampleRate_;
+    std::vector<float> hann_;
+    float hannGain_ = 1.0f;  // sum of the window: a full-scale sine peaks at hannGain_ / 2
+    std::vector<float> fftIn_;
+    std::vector<std::complex<float>> bins_;
+    std::vector<uint32_t> bandEdges_;  // kSpectrumBands + 1 FFT bin indices
+    std::vector<float> yin_;           // difference function, then its normalized form
+#if defined(HAVE_FFTW3) && HAVE_FFTW3 == 1
+    void* plan_ = nullptr;  // fftwf_plan
+#else
+    std::vector<std::complex<float>> twiddles_;
+    std::vector<std::complex<float>> work_;  // full-length transform
+#endif
+};
+
+} // namespace guitarrackcraft
+
+#endif // GUITARRACKCRAFT_SIGNAL_ANALYZER_H
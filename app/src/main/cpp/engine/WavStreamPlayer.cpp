@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "WavStreamPlayer.h"
+#include "utils/ThreadPolicy.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace guitarrackcraft {
+
+namespace {
+
+constexpr auto kIdlePoll = std::chrono::milliseconds(5);
+constexpr auto kSeekPoll = std::chrono::milliseconds(1);
+
+} // namespace
+
+bool WavStreamPlayer::open(const std::string& path, float engineRate) {
+    close();
+    if (engineRate <= 0.0f) return false;
+    if (!wav_.open(path) || wav_.frames() == 0) {
+        wav_.close();
+        return false;
+    }
+
+    const uint32_t outRate = static_cast<uint32_t>(std::lround(engineRate));
+    resampler_.configure(wav_.sampleRate(), outRate, 1, kChunkFrames);
+    step_ = static_cast<double>(wav_.sampleRate()) / outRate;
+    lengthFrames_ = resampler_.outputFramesFor(wav_.frames());
+    interleaved_.resize(static_cast<size_t>(kChunkFrames) * wav_.channels());
+    mono_.resize(kChunkFrames);
+    resampled_.resize(resampler_.maxOutputFrames(std::max<size_t>(kChunkFrames, resampler_.taps())));
+    ring_.resize(static_cast<size_t>(kRingSeconds * engineRate));
+
+    repositionReader(0);
+    const size_t prefetch = static_cast<size_t>(kPrefetchSeconds * engineRate);
+    bool more = true;
+    while (more && ring_.available() < prefetch) {
+        more = fillChunk();
+    }
+
+    const uint32_t gen = seekGen_.load();
+    parkedGen_.store(gen);
+    ackGen_.store(gen);
+    readerDone_.store(!more);
+    position_.store(0);
+    atEnd_.store(false);
+    underrunFrames_.store(0);
+    stop_.store(false);
+    open_.store(true, std::memory_order_release);
+    reader_ = std::thread(&WavStreamPlayer::readerLoop, this, gen);
+    return true;
+}
+
+void WavStreamPlayer::close() {
+    open_.store(false, std::memory_order_release);
+    while (readers_.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+    stop_.store(true);
+    if (reader_.joinable()) {
+        reader_.join();
+    }
+    wav_.close();
+    ring_.reset();
+    lengthFrames_ = 0;
+    position_.store(0);
+}
+
+size_t WavStreamPlayer::read(float* out, size_t frames) {
+    readers_.fetch_add(1, std::memory_order_acq_rel);
+    if (!open_.load(std::memory_order_acquire)) {
+        readers_.fetch_sub(1, std::memory_order_release);
+        std::memset(out, 0, frames * sizeof(float));
+        return 0;
+    }
+
+    size_t delivered = 0;
+    const uint32_t gen = seekGen_.load(std::memory_order_acquire);
+    if (gen != ackGen_.load(std::memory_order_relaxed)) {
+        // Seek pending: once the reader has parked, drop what it queued before the seek.
+        if (parkedGen_.load(std::memory_order_acquire) == gen) {
+            ring_.skip(ring_.capacity());
+            ackGen_.store(gen, std::memory_order_release);
+        }
+    } else {
+        delivered = ring_.read(out, frames);
+        position_.fetch_add(delivered, std::memory_order_relaxed);
+        if (delivered < frames) {
+            if (readerDone_.load(std::memory_order_acquire) && ring_.available() == 0) {
+                atEnd_.store(true, std::memory_order_release);
+            } else {
+                underrunFrames_.fetch_add(frames - delivered, std::memory_order_relaxed);
+            }
+        }
+    }
+    if (delivered < frames) {
+        std::memset(out + delivered, 0, (frames - delivered) * sizeof(float));
+    }
+    readers_.fetch_sub(1, std::memory_order_release);
+    return delivered;
+}
+
+void WavStreamPlayer::seek(size_t frame) {
+    if (!isOpen()) return;
+    frame = std::min(frame, lengthFrames_);
+    seekTarget_.store(frame, std::memory_order_relaxed);
+    position_.store(frame, std::memory_order_relaxed);
+    atEnd_.store(false, std::memory_order_relaxed);
+    seekGen_.fetch_add(1, std::memory_order_release);
+}
+
+void WavStreamPlayer::repositionReader(size_t frame) {
+    fileFrame_ = std::min(wav_.frames(), static_cast<size_t>(frame * step_));
+    resampler_.reset();
+}
+
+bool WavStreamPlayer::fillChunk() {
+    const size_t got = wav_.readFrames(fileFrame_, kChunkFrames, interleaved_.data());
+    if (got == 0) {
+        // End of data: drain the resampler's look-ahead once
+        float* out = resampled_.data();
+        ring_.write(resampled_.data(), resampler_.flush(&out));
+        return false;
+    }
+    fileFrame_ += got;
+    wav_.prefetch(fileFrame_, kChunkFrames);
+
+    // Mix down to mono.
+    const uint32_t channels = wav_.channels();
+    const float* mono = interleaved_.data();
+    if (channels > 1) {
+        const float gain = 1.0f / static_cast<float>(channels);
+        const float* p = interleaved_.data();
+        for (size_t i = 0; i < got; ++i, p += channels) {
+            float sum = 0.0f;
+            for (uint32_t ch = 0; ch < channels; ++ch) sum += p[ch];
+            mono_[i] = sum * gain;
+        }
+        mono = mono_.data();
+    }
+
+    float* out = resampled_.data();
+    const size_t produced = resampler_.process(&mono, got, &out);
+    ring_.write(resampled_.data(), produced);
+    return true;
+}
+
+void WavStreamPlayer::readerLoop(uint32_t handled) {
+    applyThreadRole(ThreadRole::Background);
+    const size_t chunkOut = resampled_.size();
+    while (!stop_.load(std::memory_order_relaxed)) {
+        const uint32_t gen = seekGen_.load(std::memory_order_acquire);
+        if (gen != handled) {
+            // Clear before parking: read() may ack and look for the end right after, while
+            // this thread still sleeps, and must not see the previous pass's end flag
+            readerDone_.store(false, std::memory_order_release);
+            parkedGen_.store(gen, std::memory_order_release);
+            while (ackGen_.load(std::memory_order_acquire) != gen &&
+                   seekGen_.load(std::memory_order_acquire) == gen &&
+                   !stop_.load(std::memory_order_relaxed)) {
+                std::this_thread::sleep_for(kSeekPoll);
+            }
+            if (ackGen_.load(std::memory_order_acquire) != gen) continue;  // superseded or stopping
+            repositionReader(seekTarget_.load(std::memory_order_relaxed));
+            handled = gen;
+            continue;
+        }
+        if (readerDone_.load(std::memory_order_relaxed) ||
+            ring_.capacity() - ring_.available() < chunkOut) {
+            std::this_thread::sleep_for(kIdlePoll);
+            continue;
+        }
+        if (!fillChunk()) {
+            readerDone_.store(true, std::memory_order_release);
+        }
+    }
+}
+
+} // namespace guitarrackcraft
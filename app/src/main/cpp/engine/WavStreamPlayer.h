@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef GUITARRACKCRAFT_WAV_STREAM_PLAYER_H
+#define GUITARRACKCRAFT_WAV_STREAM_PLAYER_H
+
+#include "RingBuffer.h"
+#include "utils/MappedWavFile.h"
+#include "utils/PolyphaseResampler.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Disk-backed WAV playback for the audio callback. A background reader converts the
+ * memory-mapped file in chunks, mixes to mono, resamples block by block to the
+ * engine rate and keeps a fixed ring (kRingSeconds) topped up, so memory use does
+ * not depend on track length and open() returns as soon as the header is parsed
+ * and a short prefetch is queued.
+ *
+ * read() is the only real-time call. Seeks are handed to the reader, which parks,
+ * lets the callback drop the stale ring contents and refills from the new offset;
+ * the callback plays silence for that gap rather than waiting.
+ */
+class WavStreamPlayer {
+public:
+    static constexpr double kRingSeconds = 2.0;
+    static constexpr double kPrefetchSeconds = 0.05;
+    static constexpr uint32_t kChunkFrames = 4096;  // file frames decoded per read
+
+    WavStreamPlayer() = default;
+    ~WavStreamPlayer() { close(); }
+
+    WavStreamPlayer(const WavStreamPlayer&) = delete;
+    WavStreamPlayer& operator=(const WavStreamPlayer&) = delete;
+
+    /** Open path for playback at engineRate; false if the file is unreadable or unsupported. */
+    bool open(const std::string& path, float engineRate);
+
+    /** Stop the reader and release the file. Waits for an in-flight read() to finish. */
+    void close();
+
+    bool isOpen() const { return open_.load(std::memory_order_acquire); }
+
+    /**
+     * Audio thread: fill out with up to frames engine-rate samples. Missing data
+     * (reader behind, seek in progress) is zero-filled. Returns the frames of
+     * track actually delivered; 0 with atEnd() once the track has been played out.
+     */
+    size_t read(float* out, size_t frames);
+
+    /** Move playback to an engine-rate frame; clamped to the track length. */
+    void seek(size_t frame);
+
+    bool atEnd() const { return atEnd_.load(std::memory_order_acquire); }
+    size_t lengthFrames() const { return lengthFrames_; }
+    size_t positionFrames() const { return position_.load(std::memory_order_relaxed); }
+    uint32_t fileSampleRate() const { return wav_.sampleRate(); }
+    uint64_t underrunFrames() const { return underrunFrames_.load(std::memory_order_relaxed); }
+
+private:
+    /** handled: the seek generation already reflected in the ring when the thread starts. */
+    void readerLoop(uint32_t handled);
+    /** Decode, mix down and resample one chunk into the ring; false at end of data. */
+    bool fillChunk();
+    void repositionReader(size_t frame);
+
+    MappedWavFile wav_;
+    size_t lengthFrames_ = 0;  // at engine rate
+    double step_ = 1.0;        // file frames per engine frame (seek mapping)
+
+    // Reader-thread state
+    size_t fileFrame_ = 0;          // next file frame to decode
+    PolyphaseResampler resampler_;
+    std::vector<float> interleaved_;
+    std::vector<float> mono_;
+    std::vector<float> resampled_;
+
+    RingBuffer ring_;
+    std::thread reader_;
+    std::atomic<bool> open_{false};
+    std::atomic<bool> stop_{false};
+    std::atomic<int> readers_{0};
+    std::atomic<bool> readerDone_{false};  // reader hit end of data
+    std::atomic<bool> atEnd_{false};
+
+    // Seek hand-off: control bumps seekGen_, reader parks at parkedGen_, callback flushes and acks
+    std::atomic<uint32_t> seekGen_{0};
+    std::atomic<uint32_t> parkedGen_{0};
+    std::atomic<uint32_t> ackGen_{0};
+    std::atomic<size_t> seekTarget_{0};
+
+    std::atomic<size_t> position_{0};
+    std::atomic<uint64_t> underrunFrames_{0};
+};
+
+} // namespace guitarrackcraft
+
+#endif // GUITARRACKCRAFT_WAV_STREAM_PLAYER_H
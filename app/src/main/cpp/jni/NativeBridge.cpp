@@ -19,11 +19,14 @@
 
 #include <jni.h>
 #include <android/log.h>
+#include <algorithm>
 #include <atomic>
 #include <csignal>
+#include <cstdint>
 #include <cstring>
 #include <signal.h>
 #include <dlfcn.h>
+#include <sys/system_properties.h>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -40,11 +43,15 @@
 #include "../plugin/IPluginFactory.h"
 #include "../plugin/lv2/LV2PluginFactory.h"
 #include "../plugin/StateSerializer.h"
+#include "../plugin/PresetPreloader.h"
 #include "../plugin/PluginUIManager.h"
+#include "../x11/X11FramePacer.h"
 #include "../x11/X11NativeDisplay.h"
 #include "../x11/X11Worker.h"
 #include "../x11/DisplayState.h"
+#include "../utils/SystemTrace.h"
 #include "../utils/ThreadUtils.h"
+#include "../utils/TelemetryBlock.h"
 
 #define LOG_TAG "NativeBridge"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -55,6 +62,7 @@ using namespace guitarrackcraft;
 struct NativeContext {
     std::unique_ptr<AudioEngine> audioEngine;
     std::unique_ptr<PluginRegistry> pluginRegistry;
+    std::unique_ptr<PresetPreloader> presetPreloader;  // after pluginRegistry: destroyed first
     std::unique_ptr<OfflineProcessor> offlineProcessor;
     std::unique_ptr<PluginUIManager> pluginUIManager;
     std::string lv2Path;
@@ -136,6 +144,12 @@ static bool ensureJniCache(JNIEnv* env) {
 
 namespace guitarrackcraft {
 
+// Process lifetime, so ByteBuffers handed to Java stay valid across engine re-creation.
+static TelemetryBlock& telemetryBlock() {
+    static TelemetryBlock block;
+    return block;
+}
+
 static DisplayState::Phase getDisplayPhase(int displayNumber) {
     std::lock_guard<std::mutex> lock(displayStateMutex());
     auto it = displayStates().find(displayNumber);
@@ -271,6 +285,12 @@ JNIEXPORT jboolean JNICALL
 Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeInit(JNIEnv* env, jobject thiz) {
     LOGI("Initializing native engine");
 
+    // `adb shell setprop debug.guitarrackcraft.systrace 1` arms trace markers without the UI
+    char traceProp[PROP_VALUE_MAX] = {};
+    if (__system_property_get("debug.guitarrackcraft.systrace", traceProp) > 0 && traceProp[0] == '1') {
+        LOGI("System trace markers %s", SystemTrace::setEnabled(true) ? "enabled" : "unavailable");
+    }
+
     // Promote libc++_shared.so to RTLD_GLOBAL so that LV2 plugin .so files
     // (which depend on it) can resolve the dependency when dlopen'd by lilv
     void* cxxLib = dlopen("libc++_shared.so", RTLD_NOW | RTLD_GLOBAL | RTLD_NOLOAD);
@@ -288,6 +308,10 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeInit(JNIEnv* env, job
     // Create plugin registry
     ensureCtx();
     g_ctx->pluginRegistry = std::make_unique<PluginRegistry>();
+    g_ctx->presetPreloader = std::make_unique<PresetPreloader>(
+        [registry = g_ctx->pluginRegistry.get()](const std::string& uri) {
+            return registry->createPlugin("LV2:" + uri);
+        });
 
     // Register LV2 factory (pass path from nativeSetLv2Path for extracted Guitarix/assets)
     auto lv2Factory = std::make_unique<LV2PluginFactory>(g_ctx->lv2Path, g_ctx->nativeLibDir, g_ctx->filesDir, g_ctx->pluginLibDir);
@@ -301,13 +325,18 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeInit(JNIEnv* env, job
 
     // Create audio engine
     g_ctx->audioEngine = std::make_unique<AudioEngine>();
+    g_ctx->audioEngine->setTelemetry(&telemetryBlock());
+    setX11LoadSource([] { return g_ctx->audioEngine->getCpuLoad(); });
+    g_ctx->audioEngine->setLoadShedListener([](uint32_t actions) {
+        setX11FrameRateCap((actions & TelemetryBlock::kShedSlowUi) ? X11FramePacer::kIdleHz : 0.0);
+    });
 
     // Create plugin UI manager
     g_ctx->pluginUIManager = std::make_unique<guitarrackcraft::PluginUIManager>();
     g_ctx->pluginUIManager->setChain(&g_ctx->audioEngine->getChain());
 
-    // Create offline processor (uses same chain as audio engine)
-    g_ctx->offlineProcessor = std::make_unique<OfflineProcessor>(g_ctx->audioEngine->getChain());
+    // Create offline processor (renders on private copies of the engine's chain)
+    g_ctx->offlineProcessor = std::make_unique<OfflineProcessor>(*g_ctx->pluginRegistry);
 
     // Start the X11Worker thread for single-threaded X11 operations
     // This prevents xcb_xlib_threads_sequence_lost crashes by ensuring
@@ -332,6 +361,19 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeStartEngine(JNIEnv* e
                                      static_cast<int32_t>(bufferFrames)) ? JNI_TRUE : JNI_FALSE;
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeReconfigureEngine(JNIEnv* env, jobject thiz, jfloat sampleRate, jint inputDeviceId, jint outputDeviceId, jint bufferFrames) {
+    if (!g_ctx->audioEngine) {
+        LOGE("Audio engine not initialized");
+        return JNI_FALSE;
+    }
+
+    return g_ctx->audioEngine->reconfigure(static_cast<float>(sampleRate),
+                                           static_cast<int32_t>(inputDeviceId),
+                                           static_cast<int32_t>(outputDeviceId),
+                                           static_cast<int32_t>(bufferFrames)) ? JNI_TRUE : JNI_FALSE;
+}
+
 JNIEXPORT void JNICALL
 Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeStopEngine(JNIEnv* env, jobject thiz) {
     LOGI("nativeStopEngine CALLED tid=%ld (Java requested stop; will call closeStreams from this thread)", getTid());
@@ -364,8 +406,10 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetBufferFrameCount(J
 
 JNIEXPORT jintArray JNICALL
 Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetStreamInfo(JNIEnv* env, jobject thiz) {
-    // Returns [isAAudio, inputExclusive, outputExclusive, inputLowLatency, outputLowLatency, outputMMap, outputCallback, framesPerBurst]
-    jint arr[8] = {};
+    // Returns [isAAudio, inputExclusive, outputExclusive, inputLowLatency, outputLowLatency, outputMMap, outputCallback, framesPerBurst,
+    //          inputZeroFilledFrames, inputSlippedFrames, inputDiscardedFrames]
+    constexpr jsize kStreamInfoSize = 11;
+    jint arr[kStreamInfoSize] = {};
     if (g_ctx->audioEngine && g_ctx->audioEngine->isRunning()) {
         auto info = g_ctx->audioEngine->getStreamInfo();
         arr[0] = info.isAAudio ? 1 : 0;
@@ -376,10 +420,13 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetStreamInfo(JNIEnv*
         arr[5] = info.outputMMap ? 1 : 0;
         arr[6] = info.outputCallback ? 1 : 0;
         arr[7] = info.framesPerBurst;
+        arr[8] = static_cast<jint>(std::min<uint64_t>(info.inputZeroFilledFrames, INT32_MAX));
+        arr[9] = static_cast<jint>(std::min<uint64_t>(info.inputSlippedFrames, INT32_MAX));
+        arr[10] = static_cast<jint>(std::min<uint64_t>(info.inputDiscardedFrames, INT32_MAX));
     }
-    jintArray result = env->NewIntArray(8);
+    jintArray result = env->NewIntArray(kStreamInfoSize);
     if (result) {
-        env->SetIntArrayRegion(result, 0, 8, arr);
+        env->SetIntArrayRegion(result, 0, kStreamInfoSize, arr);
     }
     return result;
 }
@@ -392,6 +439,38 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetLatencyMs(JNIEnv*
     return g_ctx->audioEngine->getLatencyMs();
 }
 
+JNIEXPORT jdouble JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetRoundTripLatencyMs(JNIEnv* env, jobject thiz) {
+    if (!g_ctx->audioEngine || !g_ctx->audioEngine->isRunning()) {
+        return 0.0;
+    }
+    return g_ctx->audioEngine->getRoundTripLatencyMs();
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeStartLatencyCalibration(JNIEnv* env, jobject thiz) {
+    if (!g_ctx->audioEngine) {
+        return JNI_FALSE;
+    }
+    return g_ctx->audioEngine->startLatencyCalibration() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativePollLatencyCalibration(JNIEnv* env, jobject thiz) {
+    if (!g_ctx->audioEngine) {
+        return AudioEngine::kCalibrationFailed;
+    }
+    return g_ctx->audioEngine->pollLatencyCalibration();
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetMeasuredLatencyFrames(JNIEnv* env, jobject thiz,
+                                                                                   jint frames) {
+    if (g_ctx->audioEngine) {
+        g_ctx->audioEngine->setMeasuredRoundTripFrames(frames);
+    }
+}
+
 JNIEXPORT jfloat JNICALL
 Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetInputLevel(JNIEnv* env, jobject thiz) {
     if (!g_ctx->audioEngine) {
@@ -416,6 +495,131 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetCpuLoad(JNIEnv* en
     return g_ctx->audioEngine->getCpuLoad();
 }
 
+JNIEXPORT jobject JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetTelemetryBuffer(JNIEnv* env, jobject thiz) {
+    return env->NewDirectByteBuffer(telemetryBlock().data(),
+                                    static_cast<jlong>(guitarrackcraft::TelemetryBlock::size()));
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetPluginProfiling(JNIEnv* env, jobject thiz, jboolean enabled) {
+    if (g_ctx->audioEngine) {
+        g_ctx->audioEngine->getChain().setProfilingEnabled(enabled == JNI_TRUE);
+    }
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetMemoryLocking(JNIEnv* env, jobject thiz, jboolean locked) {
+    if (!g_ctx->audioEngine) return JNI_FALSE;
+    return g_ctx->audioEngine->setMemoryLocking(locked == JNI_TRUE) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetAnalysisSource(JNIEnv* env, jobject thiz, jint source) {
+    if (!g_ctx->audioEngine) return JNI_FALSE;
+    return g_ctx->audioEngine->setAnalysisSource(source) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetSystemTraceEnabled(JNIEnv* env, jobject thiz, jboolean enabled) {
+    const bool ok = SystemTrace::setEnabled(enabled == JNI_TRUE);
+    LOGI("nativeSetSystemTraceEnabled: %d -> %s", enabled ? 1 : 0, ok ? "ok" : "ATrace unavailable");
+    return ok ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeOpenMidiInput(JNIEnv* env, jobject thiz, jobject device, jint portNumber) {
+    if (!g_ctx->audioEngine) return JNI_FALSE;
+    return g_ctx->audioEngine->openMidiInput(env, device, portNumber) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeCloseMidiInput(JNIEnv* env, jobject thiz) {
+    if (g_ctx->audioEngine) g_ctx->audioEngine->closeMidiInput();
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeMidiLearn(JNIEnv* env, jobject thiz, jint pluginIndex, jint portIndex, jfloat min, jfloat max, jboolean toggle) {
+    if (!g_ctx->audioEngine) return;
+    g_ctx->audioEngine->getMidiRouter().learn(pluginIndex, portIndex, min, max, toggle == JNI_TRUE);
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeCancelMidiLearn(JNIEnv* env, jobject thiz) {
+    if (g_ctx->audioEngine) g_ctx->audioEngine->getMidiRouter().cancelLearn();
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeIsMidiLearning(JNIEnv* env, jobject thiz) {
+    if (!g_ctx->audioEngine) return JNI_FALSE;
+    return g_ctx->audioEngine->getMidiRouter().isLearning() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeClearMidiMappings(JNIEnv* env, jobject thiz) {
+    if (g_ctx->audioEngine) g_ctx->audioEngine->getMidiRouter().clear();
+}
+
+JNIEXPORT jfloatArray JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetPluginTimings(JNIEnv* env, jobject thiz) {
+    // Returns [lastUs, avgUs, p99Us, silentSpikes, asleep] per plugin, in chain order
+    std::vector<jfloat> arr;
+    if (g_ctx->audioEngine) {
+        for (const auto& t : g_ctx->audioEngine->getChain().getSlotTimings()) {
+            arr.push_back(t.lastUs);
+            arr.push_back(t.avgUs);
+            arr.push_back(t.p99Us);
+            arr.push_back(static_cast<jfloat>(t.silentSpikes));
+            arr.push_back(t.asleep ? 1.0f : 0.0f);
+        }
+    }
+    jfloatArray result = env->NewFloatArray(static_cast<jsize>(arr.size()));
+    if (result && !arr.empty()) {
+        env->SetFloatArrayRegion(result, 0, static_cast<jsize>(arr.size()), arr.data());
+    }
+    return result;
+}
+
+JNIEXPORT jintArray JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetCallbackStats(JNIEnv* env, jobject thiz) {
+    // Returns [callbacks, nearMisses, deadlineMisses, maxWallUs, maxJitterUs,
+    //          loadBucketPercent, intervalBucketPercent, nLoad, nInterval, load..., interval...]
+    using guitarrackcraft::CallbackStats;
+    constexpr int kHeader = 9;
+    constexpr int kSize = kHeader + CallbackStats::kLoadBuckets + CallbackStats::kIntervalBuckets;
+    jint arr[kSize] = {};
+    if (g_ctx->audioEngine) {
+        auto stats = g_ctx->audioEngine->getCallbackStats();
+        arr[0] = static_cast<jint>(stats.callbacks);
+        arr[1] = static_cast<jint>(stats.nearMisses);
+        arr[2] = static_cast<jint>(stats.deadlineMisses);
+        arr[3] = static_cast<jint>(stats.maxWallUs);
+        arr[4] = static_cast<jint>(stats.maxJitterUs);
+        for (int i = 0; i < CallbackStats::kLoadBuckets; ++i) {
+            arr[kHeader + i] = static_cast<jint>(stats.load[i]);
+        }
+        for (int i = 0; i < CallbackStats::kIntervalBuckets; ++i) {
+            arr[kHeader + CallbackStats::kLoadBuckets + i] = static_cast<jint>(stats.interval[i]);
+        }
+    }
+    arr[5] = CallbackStats::kLoadBucketPercent;
+    arr[6] = CallbackStats::kIntervalBucketPercent;
+    arr[7] = CallbackStats::kLoadBuckets;
+    arr[8] = CallbackStats::kIntervalBuckets;
+    jintArray result = env->NewIntArray(kSize);
+    if (result) {
+        env->SetIntArrayRegion(result, 0, kSize, arr);
+    }
+    return result;
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeResetCallbackStats(JNIEnv* env, jobject thiz) {
+    if (g_ctx->audioEngine) {
+        g_ctx->audioEngine->resetCallbackStats();
+    }
+}
+
 JNIEXPORT jint JNICALL
 Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetXRunCount(JNIEnv* env, jobject thiz) {
     if (!g_ctx->audioEngine) {
@@ -534,29 +738,19 @@ jobject createPluginInfoObject(JNIEnv* env, const PluginInfo& info) {
     return obj;
 }
 
-JNIEXPORT jobjectArray JNICALL
-Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetAvailablePlugins(JNIEnv* env, jobject thiz) {
-    if (!ensureJniCache(env)) return nullptr;
-
-    std::vector<PluginInfo> plugins;
-    if (g_ctx && g_ctx->pluginRegistry) {
-        plugins = g_ctx->pluginRegistry->getAllPlugins();
-    }
-
-    jobjectArray result = env->NewObjectArray(static_cast<jsize>(plugins.size()), g_jni.pluginInfoClass, nullptr);
-    if (!result) {
-        return nullptr;
-    }
-
-    for (size_t i = 0; i < plugins.size(); ++i) {
-        jobject pluginObj = createPluginInfoObject(env, plugins[i]);
-        if (pluginObj) {
-            env->SetObjectArrayElement(result, static_cast<jsize>(i), pluginObj);
-            env->DeleteLocalRef(pluginObj);
-        }
-    }
+JNIEXPORT jlong JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetPluginCatalogVersion(JNIEnv* env, jobject thiz) {
+    if (!g_ctx || !g_ctx->pluginRegistry) return 0;
+    return static_cast<jlong>(g_ctx->pluginRegistry->catalogVersion());
+}
 
-    return result;
+// Direct view of the registry's encoded catalog: no per-plugin JNI objects, and the
+// bytes outlive the buffer (PluginRegistry keeps every snapshot it hands out).
+JNIEXPORT jobject JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetPluginCatalog(JNIEnv* env, jobject thiz) {
+    if (!g_ctx || !g_ctx->pluginRegistry) return nullptr;
+    const std::vector<uint8_t>& snapshot = g_ctx->pluginRegistry->catalogSnapshot();
+    return env->NewDirectByteBuffer(const_cast<uint8_t*>(snapshot.data()), static_cast<jlong>(snapshot.size()));
 }
 
 JNIEXPORT jint JNICALL
@@ -573,13 +767,14 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeAddPluginToRack(JNIEn
     std::string fullId = std::string(idStr);
     env->ReleaseStringUTFChars(pluginId, idStr);
 
-    auto plugin = g_ctx->pluginRegistry->createPlugin(fullId);
+    PluginChain& chain = g_ctx->audioEngine->getChain();
+    auto plugin = g_ctx->pluginRegistry->acquirePlugin(fullId, chain.getSampleRate(), chain.getBufferSize());
     if (!plugin) {
         LOGE("Failed to create plugin: %s", fullId.c_str());
         return -1;
     }
 
-    int pos = g_ctx->audioEngine->getChain().addPlugin(std::move(plugin), position);
+    int pos = chain.addPlugin(std::move(plugin), position);
     if (pos >= 0) {
         LOGI("nativeAddPluginToRack: pluginId=%s position=%d -> index=%d",
              fullId.c_str(), position, pos);
@@ -587,6 +782,34 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeAddPluginToRack(JNIEn
     return pos;
 }
 
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetWarmPlugins(JNIEnv* env, jobject thiz, jobjectArray pluginIds) {
+    if (!g_ctx || !g_ctx->pluginRegistry || !pluginIds) {
+        return;
+    }
+    std::vector<std::string> ids;
+    const jsize count = env->GetArrayLength(pluginIds);
+    ids.reserve(count);
+    for (jsize i = 0; i < count; ++i) {
+        auto id = static_cast<jstring>(env->GetObjectArrayElement(pluginIds, i));
+        const char* idStr = id ? env->GetStringUTFChars(id, nullptr) : nullptr;
+        if (idStr) {
+            ids.emplace_back(idStr);
+            env->ReleaseStringUTFChars(id, idStr);
+        }
+        if (id) env->DeleteLocalRef(id);
+    }
+
+    float sampleRate = 0.0f;
+    uint32_t bufferSize = 0;
+    if (g_ctx->audioEngine) {
+        sampleRate = g_ctx->audioEngine->getChain().getSampleRate();
+        bufferSize = g_ctx->audioEngine->getChain().getBufferSize();
+    }
+    g_ctx->pluginRegistry->setWarmPlugins(ids, sampleRate, bufferSize);
+    LOGI("nativeSetWarmPlugins: %zu plugins", ids.size());
+}
+
 JNIEXPORT jboolean JNICALL
 Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeRemovePluginFromRack(JNIEnv* env, jobject thiz, jint position) {
     if (!g_ctx->audioEngine) {
@@ -660,6 +883,116 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetParameter(JNIEnv*
     return g_ctx->audioEngine->getChain().getParameter(pluginIndex, static_cast<uint32_t>(portIndex));
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetPluginBypass(JNIEnv* env, jobject thiz, jint pluginIndex, jboolean bypassed) {
+    if (!g_ctx->audioEngine) {
+        return JNI_FALSE;
+    }
+    PluginChain& chain = g_ctx->audioEngine->getChain();
+    if (!chain.setPluginBypass(pluginIndex, bypassed == JNI_TRUE)) {
+        return JNI_FALSE;
+    }
+    // The plugin's own footswitch moved with the host bypass; show it in an open UI
+    IPlugin* plugin = chain.getPlugin(pluginIndex);
+    const int32_t enabledPort = plugin ? plugin->getEnabledPortIndex() : -1;
+    if (enabledPort >= 0 && g_ctx->pluginUIManager) {
+        g_ctx->pluginUIManager->notifyUIParameterChange(pluginIndex, static_cast<uint32_t>(enabledPort),
+                                                        bypassed == JNI_TRUE ? 0.0f : 1.0f);
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeIsPluginBypassed(JNIEnv* env, jobject thiz, jint pluginIndex) {
+    if (!g_ctx->audioEngine) {
+        return JNI_FALSE;
+    }
+    return g_ctx->audioEngine->getChain().isPluginBypassed(pluginIndex) ? JNI_TRUE : JNI_FALSE;
+}
+
+// --- Bulk parameter access (direct FloatBuffer, layout documented on PluginChain) ---
+
+/** Float view of a direct FloatBuffer; capacity in floats. Null for a heap buffer. */
+static float* directFloats(JNIEnv* env, jobject buffer, uint32_t& capacity) {
+    capacity = 0;
+    if (!buffer) return nullptr;
+    void* address = env->GetDirectBufferAddress(buffer);
+    jlong elements = env->GetDirectBufferCapacity(buffer);
+    if (!address || elements <= 0) {
+        LOGE("bulk parameters: buffer is not a direct FloatBuffer");
+        return nullptr;
+    }
+    capacity = static_cast<uint32_t>(std::min<jlong>(elements, UINT32_MAX));
+    return static_cast<float*>(address);
+}
+
+/** Mirror applied (port, value) pairs to an open plugin UI, like nativeSetParameter. */
+static void notifyUIParameters(int pluginIndex, const float* pairs, uint32_t count) {
+    if (!g_ctx->pluginUIManager) return;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!(pairs[2 * i] >= 0.0f)) continue;
+        g_ctx->pluginUIManager->notifyUIParameterChange(
+            pluginIndex, static_cast<uint32_t>(pairs[2 * i]), pairs[2 * i + 1]);
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetParameters(JNIEnv* env, jobject thiz, jint pluginIndex, jobject buffer) {
+    if (!g_ctx->audioEngine) {
+        return 0;
+    }
+    uint32_t capacity = 0;
+    float* out = directFloats(env, buffer, capacity);
+    return static_cast<jint>(g_ctx->audioEngine->getChain().getParameters(pluginIndex, out, capacity));
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetParameters(JNIEnv* env, jobject thiz, jint pluginIndex, jobject buffer, jint count) {
+    if (!g_ctx->audioEngine || count <= 0) {
+        return;
+    }
+    uint32_t capacity = 0;
+    const float* pairs = directFloats(env, buffer, capacity);
+    if (!pairs || static_cast<uint64_t>(count) * 2 > capacity) {
+        return;
+    }
+    g_ctx->audioEngine->getChain().setParameters(pluginIndex, pairs, static_cast<uint32_t>(count));
+    notifyUIParameters(pluginIndex, pairs, static_cast<uint32_t>(count));
+}
+
+JNIEXPORT jint JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetAllParameters(JNIEnv* env, jobject thiz, jobject buffer) {
+    if (!g_ctx->audioEngine) {
+        return 0;
+    }
+    uint32_t capacity = 0;
+    float* out = directFloats(env, buffer, capacity);
+    return static_cast<jint>(g_ctx->audioEngine->getChain().getAllParameters(out, capacity));
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetAllParameters(JNIEnv* env, jobject thiz, jobject buffer, jint size) {
+    if (!g_ctx->audioEngine || size <= 0) {
+        return JNI_FALSE;
+    }
+    uint32_t capacity = 0;
+    const float* data = directFloats(env, buffer, capacity);
+    if (!data || static_cast<uint32_t>(size) > capacity) {
+        return JNI_FALSE;
+    }
+    const uint32_t total = static_cast<uint32_t>(size);
+    bool ok = g_ctx->audioEngine->getChain().setAllParameters(data, total);
+    // Blocks were validated by the chain; mirror whatever it walked through
+    uint32_t pos = 1;
+    const int numPlugins = ok ? static_cast<int>(data[0]) : 0;
+    for (int plugin = 0; plugin < numPlugins && pos < total; ++plugin) {
+        const uint32_t count = static_cast<uint32_t>(data[pos]);
+        notifyUIParameters(plugin, data + pos + 1, count);
+        pos += 1 + 2 * count;
+    }
+    return ok ? JNI_TRUE : JNI_FALSE;
+}
+
 // --- WAV real-time playback ---
 
 JNIEXPORT jboolean JNICALL
@@ -739,7 +1072,7 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeIsWavLoaded(JNIEnv* e
 
 JNIEXPORT jboolean JNICALL
 Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeProcessFile(JNIEnv* env, jobject thiz, jstring inputPath, jstring outputPath) {
-    if (!g_ctx || !g_ctx->offlineProcessor) {
+    if (!g_ctx || !g_ctx->offlineProcessor || !g_ctx->audioEngine) {
         return JNI_FALSE;
     }
 
@@ -752,7 +1085,11 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeProcessFile(JNIEnv* e
         return JNI_FALSE;
     }
 
-    bool result = g_ctx->offlineProcessor->processFile(std::string(inputStr), std::string(outputStr));
+    // Render a copy of the current rack at the live rate so it sounds the same offline
+    const float liveRate = g_ctx->audioEngine->getSampleRate();
+    g_ctx->offlineProcessor->setRenderSampleRate(liveRate > 0.0f ? static_cast<uint32_t>(liveRate) : 0);
+    bool result = g_ctx->offlineProcessor->processFile(g_ctx->audioEngine->getChain().saveChainState(),
+                                                       std::string(inputStr), std::string(outputStr));
 
     env->ReleaseStringUTFChars(inputPath, inputStr);
     env->ReleaseStringUTFChars(outputPath, outputStr);
@@ -760,6 +1097,41 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeProcessFile(JNIEnv* e
     return result ? JNI_TRUE : JNI_FALSE;
 }
 
+JNIEXPORT jint JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeProcessFiles(JNIEnv* env, jobject thiz,
+                                                                       jobjectArray inputPaths,
+                                                                       jobjectArray outputPaths) {
+    if (!g_ctx || !g_ctx->offlineProcessor || !g_ctx->audioEngine || !inputPaths || !outputPaths) {
+        return 0;
+    }
+    const jsize count = env->GetArrayLength(inputPaths);
+    if (env->GetArrayLength(outputPaths) != count) {
+        return 0;
+    }
+
+    // Every file gets its own copy of the current rack; they render concurrently
+    const PluginChain::ChainState state = g_ctx->audioEngine->getChain().saveChainState();
+    std::vector<OfflineProcessor::Job> jobs;
+    jobs.reserve(count);
+    for (jsize i = 0; i < count; ++i) {
+        auto in = static_cast<jstring>(env->GetObjectArrayElement(inputPaths, i));
+        auto out = static_cast<jstring>(env->GetObjectArrayElement(outputPaths, i));
+        const char* inStr = in ? env->GetStringUTFChars(in, nullptr) : nullptr;
+        const char* outStr = out ? env->GetStringUTFChars(out, nullptr) : nullptr;
+        if (inStr && outStr) {
+            jobs.push_back({inStr, outStr, state});
+        }
+        if (inStr) env->ReleaseStringUTFChars(in, inStr);
+        if (outStr) env->ReleaseStringUTFChars(out, outStr);
+        if (in) env->DeleteLocalRef(in);
+        if (out) env->DeleteLocalRef(out);
+    }
+
+    const float liveRate = g_ctx->audioEngine->getSampleRate();
+    g_ctx->offlineProcessor->setRenderSampleRate(liveRate > 0.0f ? static_cast<uint32_t>(liveRate) : 0);
+    return static_cast<jint>(g_ctx->offlineProcessor->processBatch(jobs));
+}
+
 JNIEXPORT jint JNICALL
 Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetRackSize(JNIEnv* env, jobject thiz) {
     if (!g_ctx->audioEngine) {
@@ -855,6 +1227,22 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeDestroyPluginUI(JNIEn
     LOGI("nativeDestroyPluginUI RETURNED tid=%ld", getTid());
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeHasWarmPluginUI(JNIEnv* env, jobject thiz, jint displayNumber) {
+    X11NativeDisplay* disp = getX11Display(displayNumber);
+    return disp && disp->isServing() && g_ctx->pluginUIManager &&
+                   g_ctx->pluginUIManager->hasUIForDisplay(displayNumber)
+               ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeDestroyPluginUIForDisplay(JNIEnv* env, jobject thiz, jint displayNumber) {
+    LOGI("nativeDestroyPluginUIForDisplay display=%d tid=%ld", displayNumber, getTid());
+    if (g_ctx->audioEngine) {
+        g_ctx->pluginUIManager->destroyPluginUIForDisplay(displayNumber);
+    }
+}
+
 JNIEXPORT jboolean JNICALL
 Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeIdlePluginUIs(JNIEnv* env, jobject thiz) {
     if (g_ctx->audioEngine) {
@@ -872,7 +1260,17 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeAttachSurfaceToDispla
         return 0;
     }
     LOGI("nativeAttachSurfaceToDisplay display=%d width=%d height=%d", displayNumber, width, height);
-    
+
+    /* A warm display (server, connection and plugin UI still up) only needs the new surface */
+    X11NativeDisplay* warm = getX11Display(displayNumber);
+    if (warm && warm->isServing()) {
+        if (!warm->swapSurface(env, surface, width, height)) {
+            LOGE("nativeAttachSurfaceToDisplay: swap to new surface failed for display %d", displayNumber);
+            return 0;
+        }
+        return static_cast<jlong>(warm->getRootWindowId());
+    }
+
     /* Initialize display state BEFORE attaching surface */
     {
         std::lock_guard<std::mutex> lock(displayStateMutex());
@@ -1016,8 +1414,8 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetSurfaceSize(JNIEnv
 }
 
 JNIEXPORT void JNICALL
-Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeInjectTouch(JNIEnv* env, jobject thiz, jint displayNumber, jint action, jint x, jint y) {
-    withDisplayInjectTouch(displayNumber, action, x, y);
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeInjectTouch(JNIEnv* env, jobject thiz, jint displayNumber, jint action, jint x, jint y, jlong timeNs) {
+    withDisplayInjectTouch(displayNumber, action, x, y, static_cast<int64_t>(timeNs));
 }
 
 JNIEXPORT jboolean JNICALL
@@ -1047,6 +1445,11 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetX11UIScale(JNIEnv*
     return withDisplayGetUIScale(displayNumber);
 }
 
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetX11AdaptiveUIScale(JNIEnv* env, jobject thiz, jint displayNumber, jboolean enabled) {
+    withDisplaySetAdaptiveUIScale(displayNumber, enabled == JNI_TRUE);
+}
+
 JNIEXPORT jobjectArray JNICALL
 Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativePollFileRequest(JNIEnv* env, jobject thiz) {
     if (!g_ctx || !g_ctx->pluginUIManager) return nullptr;
@@ -1087,14 +1490,33 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeDeliverFileToPluginUI
 
 // --- Real-time recording ---
 
+// Values mirror NativeEngine.RECORD_FORMAT_*
+static bool recordFormatFromJava(jint format, AudioRecorder::Format& out) {
+    switch (format) {
+        case 0: out = AudioRecorder::Format::Pcm16; return true;
+        case 1: out = AudioRecorder::Format::Pcm24; return true;
+        case 2: out = AudioRecorder::Format::Float32; return true;
+        case 3: out = AudioRecorder::Format::Flac16; return true;
+        case 4: out = AudioRecorder::Format::Flac24; return true;
+        default:
+            LOGE("Unknown recording format %d", format);
+            return false;
+    }
+}
+
 JNIEXPORT jboolean JNICALL
-Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeStartRecording(JNIEnv* env, jobject thiz, jstring rawPath, jstring processedPath) {
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeStartRecording(JNIEnv* env, jobject thiz, jstring rawPath, jstring processedPath,
+                                                                         jint format) {
     if (!g_ctx || !g_ctx->audioEngine) {
         return JNI_FALSE;
     }
     if (!rawPath || !processedPath) {
         return JNI_FALSE;
     }
+    AudioRecorder::Format recordFormat;
+    if (!recordFormatFromJava(format, recordFormat)) {
+        return JNI_FALSE;
+    }
     const char* rawStr = env->GetStringUTFChars(rawPath, nullptr);
     const char* procStr = env->GetStringUTFChars(processedPath, nullptr);
     if (!rawStr || !procStr) {
@@ -1102,8 +1524,7 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeStartRecording(JNIEnv
         if (procStr) env->ReleaseStringUTFChars(processedPath, procStr);
         return JNI_FALSE;
     }
-    bool result = g_ctx->audioEngine->getRecorder().startRecording(
-        std::string(rawStr), std::string(procStr), g_ctx->audioEngine->getSampleRate());
+    bool result = g_ctx->audioEngine->startRecording(std::string(rawStr), std::string(procStr), recordFormat);
     env->ReleaseStringUTFChars(rawPath, rawStr);
     env->ReleaseStringUTFChars(processedPath, procStr);
     return result ? JNI_TRUE : JNI_FALSE;
@@ -1132,6 +1553,50 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetRecordingDurationS
     return g_ctx->audioEngine->getRecorder().getDurationSec();
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSaveLastSeconds(JNIEnv* env, jobject thiz, jstring rawPath, jstring processedPath,
+                                                                          jdouble seconds, jint format) {
+    if (!g_ctx || !g_ctx->audioEngine || !rawPath || !processedPath) {
+        return JNI_FALSE;
+    }
+    AudioRecorder::Format recordFormat;
+    if (!recordFormatFromJava(format, recordFormat)) {
+        return JNI_FALSE;
+    }
+    const char* rawStr = env->GetStringUTFChars(rawPath, nullptr);
+    const char* procStr = env->GetStringUTFChars(processedPath, nullptr);
+    bool result = false;
+    if (rawStr && procStr) {
+        result = g_ctx->audioEngine->saveLastSeconds(std::string(rawStr), std::string(procStr), seconds, recordFormat);
+    }
+    if (rawStr) env->ReleaseStringUTFChars(rawPath, rawStr);
+    if (procStr) env->ReleaseStringUTFChars(processedPath, procStr);
+    return result ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jdouble JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeGetPreRollAvailableSec(JNIEnv* env, jobject thiz) {
+    if (!g_ctx || !g_ctx->audioEngine) {
+        return 0.0;
+    }
+    return g_ctx->audioEngine->getRecorder().getPreRollAvailableSec();
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeIsSavingPreRoll(JNIEnv* env, jobject thiz) {
+    if (!g_ctx || !g_ctx->audioEngine) {
+        return JNI_FALSE;
+    }
+    return g_ctx->audioEngine->getRecorder().isSavingPreRoll() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetPreRollSeconds(JNIEnv* env, jobject thiz, jfloat seconds) {
+    if (g_ctx && g_ctx->audioEngine) {
+        g_ctx->audioEngine->setPreRollSeconds(seconds);
+    }
+}
+
 // --- State save/restore (presets) ---
 
 JNIEXPORT jstring JNICALL
@@ -1211,10 +1676,157 @@ Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeRestorePluginState(
     return ok ? JNI_TRUE : JNI_FALSE;
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSaveChainStateFile(JNIEnv* env, jobject thiz, jstring path) {
+    if (!g_ctx || !g_ctx->audioEngine || !path) {
+        return JNI_FALSE;
+    }
+    const char* pathStr = env->GetStringUTFChars(path, nullptr);
+    if (!pathStr) {
+        return JNI_FALSE;
+    }
+    std::string filePath(pathStr);
+    env->ReleaseStringUTFChars(path, pathStr);
+
+    bool ok = saveChainStateFile(filePath, g_ctx->audioEngine->getChain().saveChainState());
+    if (!ok) {
+        LOGE("nativeSaveChainStateFile: failed to write %s", filePath.c_str());
+    }
+    return ok ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Switch the rack to a binary chain-state file in one call. The target is diffed against the
+ * live chain, so plugins the presets share keep their instance (and loaded models) and only
+ * get changed control values; the rest are created, warm spares first. Callers wrap this in
+ * begin/commitChainBatch like the JSON path, so the audio thread swaps once.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeLoadChainStateFile(JNIEnv* env, jobject thiz, jstring path) {
+    if (!g_ctx || !g_ctx->audioEngine || !g_ctx->pluginRegistry || !path) {
+        return JNI_FALSE;
+    }
+    const char* pathStr = env->GetStringUTFChars(path, nullptr);
+    if (!pathStr) {
+        return JNI_FALSE;
+    }
+    std::string filePath(pathStr);
+    env->ReleaseStringUTFChars(path, pathStr);
+
+    PluginChain::ChainState state;
+    if (!loadChainStateFile(filePath, state)) {
+        LOGE("nativeLoadChainStateFile: unreadable or corrupt %s", filePath.c_str());
+        return JNI_FALSE;
+    }
+
+    PluginChain& chain = g_ctx->audioEngine->getChain();
+    // Chain indices change; the rack UI re-attaches plugin UIs after a preset load.
+    if (g_ctx->pluginUIManager) {
+        for (int i = static_cast<int>(chain.getSize()) - 1; i >= 0; --i) {
+            g_ctx->pluginUIManager->detachAndShiftForRemoval(i);
+        }
+    }
+
+    // Setlist mode: a chain preloaded from this very state swaps in without creating anything
+    if (g_ctx->presetPreloader) {
+        g_ctx->presetPreloader->setActivation(chain.getSampleRate(), chain.getBufferSize());
+        if (auto prepared = g_ctx->presetPreloader->take(filePath, state)) {
+            chain.replaceChain(std::move(prepared->plugins));
+            LOGI("nativeLoadChainStateFile: %zu plugins from preloaded chain", state.plugins.size());
+            return JNI_TRUE;
+        }
+    }
+    PluginRegistry* registry = g_ctx->pluginRegistry.get();
+    bool ok = chain.applyChainState(state, [&](const std::string& uri) {
+        return registry->acquirePlugin("LV2:" + uri, chain.getSampleRate(), chain.getBufferSize());
+    });
+    LOGI("nativeLoadChainStateFile: %zu plugins, ok=%d", state.plugins.size(), ok);
+    return ok ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeArmPresets(JNIEnv* env, jobject thiz, jobjectArray paths) {
+    if (!g_ctx || !g_ctx->presetPreloader || !g_ctx->audioEngine || !paths) {
+        return;
+    }
+    std::vector<PresetPreloader::Preset> presets;
+    const jsize count = env->GetArrayLength(paths);
+    for (jsize i = 0; i < count; ++i) {
+        auto path = static_cast<jstring>(env->GetObjectArrayElement(paths, i));
+        const char* pathStr = path ? env->GetStringUTFChars(path, nullptr) : nullptr;
+        if (pathStr) {
+            PresetPreloader::Preset preset;
+            preset.key = pathStr;
+            env->ReleaseStringUTFChars(path, pathStr);
+            if (loadChainStateFile(preset.key, preset.state)) {
+                presets.push_back(std::move(preset));
+            } else {
+                LOGE("nativeArmPresets: cannot read %s", preset.key.c_str());
+            }
+        }
+        if (path) env->DeleteLocalRef(path);
+    }
+
+    PluginChain& chain = g_ctx->audioEngine->getChain();
+    g_ctx->presetPreloader->setActivation(chain.getSampleRate(), chain.getBufferSize());
+    LOGI("nativeArmPresets: %zu presets", presets.size());
+    g_ctx->presetPreloader->arm(std::move(presets));
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetPreloadBudgetMb(JNIEnv* /*env*/, jobject /*thiz*/, jint megabytes) {
+    if (g_ctx && g_ctx->presetPreloader) {
+        g_ctx->presetPreloader->setBudgetBytes(static_cast<size_t>(std::max(0, megabytes)) << 20);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeBeginChainBatch(JNIEnv* /*env*/, jobject /*thiz*/) {
+    if (g_ctx && g_ctx->audioEngine) {
+        g_ctx->audioEngine->getChain().beginBatch();
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeCommitChainBatch(JNIEnv* /*env*/, jobject /*thiz*/) {
+    if (g_ctx && g_ctx->audioEngine) {
+        g_ctx->audioEngine->getChain().commitBatch();
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetChainCrossfadeFrames(JNIEnv* /*env*/, jobject /*thiz*/, jint frames) {
+    if (g_ctx && g_ctx->audioEngine) {
+        g_ctx->audioEngine->getChain().setCrossfadeFrames(frames > 0 ? static_cast<uint32_t>(frames) : 0);
+    }
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetPluginRouting(JNIEnv* /*env*/, jobject /*thiz*/,
+                                                                           jint pluginIndex, jint group, jint branch) {
+    if (!g_ctx || !g_ctx->audioEngine) return JNI_FALSE;
+    return g_ctx->audioEngine->getChain().setPluginRouting(pluginIndex, group, branch) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetBranchGain(JNIEnv* /*env*/, jobject /*thiz*/,
+                                                                        jint group, jint branch, jfloat gain) {
+    if (g_ctx && g_ctx->audioEngine) {
+        g_ctx->audioEngine->getChain().setBranchGain(group, branch, gain);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetPipelineStages(JNIEnv* /*env*/, jobject /*thiz*/, jint stages) {
+    if (g_ctx && g_ctx->audioEngine) {
+        g_ctx->audioEngine->getChain().setPipelineStages(stages);
+    }
+}
+
 JNIEXPORT void JNICALL
-Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeSetChainBypass(JNIEnv* /*env*/, jobject /*thiz*/, jboolean bypass) {
+Java_com_varcain_guitarrackcraft_engine_NativeEngine_nativeRebalancePipeline(JNIEnv* /*env*/, jobject /*thiz*/) {
     if (g_ctx && g_ctx->audioEngine) {
-        g_ctx->audioEngine->setChainBypass(bypass == JNI_TRUE);
+        g_ctx->audioEngine->getChain().rebalancePipeline();
     }
 }
 
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ChainStateDiff.h"
+#include <algorithm>
+
+namespace guitarrackcraft {
+
+namespace {
+
+bool sameProperty(const StateProperty& a, const StateProperty& b) {
+    return a.keyUri == b.keyUri && a.typeUri == b.typeUri && a.flags == b.flags && a.value == b.value;
+}
+
+std::vector<std::pair<uint32_t, float>> controlChanges(const PluginState& live, const PluginState& target) {
+    std::vector<std::pair<uint32_t, float>> changes;
+    for (const auto& [port, value] : target.controlPortValues) {
+        auto it = std::find_if(live.controlPortValues.begin(), live.controlPortValues.end(),
+                               [port = port](const std::pair<uint32_t, float>& cp) { return cp.first == port; });
+        if (it == live.controlPortValues.end() || it->second != value) {
+            changes.emplace_back(port, value);
+        }
+    }
+    return changes;
+}
+
+} // namespace
+
+size_t ChainStatePlan::reusedCount() const {
+    return static_cast<size_t>(std::count_if(slots.begin(), slots.end(),
+                                             [](const Slot& s) { return s.liveIndex >= 0; }));
+}
+
+bool canReuseInstance(const PluginState& live, const PluginState& target) {
+    if (live.pluginUri != target.pluginUri || live.properties.size() != target.properties.size()) {
+        return false;
+    }
+    // Plugins save properties in a fixed order, but don't rely on it
+    for (const auto& prop : target.properties) {
+        auto it = std::find_if(live.properties.begin(), live.properties.end(),
+                               [&](const StateProperty& p) { return p.keyUri == prop.keyUri; });
+        if (it == live.properties.end() || !sameProperty(*it, prop)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ChainStatePlan planChainState(const std::vector<PluginState>& live, const std::vector<PluginState>& target) {
+    ChainStatePlan plan;
+    plan.slots.resize(target.size());
+    std::vector<bool> claimed(live.size(), false);
+
+    for (size_t i = 0; i < target.size() && i < live.size(); ++i) {
+        if (canReuseInstance(live[i], target[i])) {
+            plan.slots[i].liveIndex = static_cast<int>(i);
+            claimed[i] = true;
+        }
+    }
+    for (size_t i = 0; i < target.size(); ++i) {
+        if (plan.slots[i].liveIndex >= 0) continue;
+        for (size_t j = 0; j < live.size(); ++j) {
+            if (!claimed[j] && canReuseInstance(live[j], target[i])) {
+                plan.slots[i].liveIndex = static_cast<int>(j);
+                claimed[j] = true;
+                break;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < target.size(); ++i) {
+        auto& slot = plan.slots[i];
+        if (slot.liveIndex >= 0) {
+            slot.controlChanges = controlChanges(live[slot.liveIndex], target[i]);
+        }
+    }
+    for (size_t j = 0; j < live.size(); ++j) {
+        if (!claimed[j]) plan.dropped.push_back(static_cast<int>(j));
+    }
+    return plan;
+}
+
+} // namespace guitarrackcraft
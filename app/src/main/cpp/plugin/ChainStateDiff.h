@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUITARRACKCRAFT_CHAIN_STATE_DIFF_H
+#define GUITARRACKCRAFT_CHAIN_STATE_DIFF_H
+
+#include "IPlugin.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * How to turn a live chain into a target chain while keeping as many instances as possible.
+ * One slot per target plugin, in target order.
+ */
+struct ChainStatePlan {
+    struct Slot {
+        int liveIndex = -1;  // live instance to keep, or -1 to create a new one
+        // For kept instances: target control values that differ from the live ones
+        std::vector<std::pair<uint32_t, float>> controlChanges;
+    };
+    std::vector<Slot> slots;
+    std::vector<int> dropped;  // live indices no slot keeps, ascending
+
+    size_t reusedCount() const;
+};
+
+/**
+ * A live instance can stand in for a target plugin when the URI matches and every state
+ * property is identical. Properties are where plugins keep model and IR paths and other
+ * non-control state; restoring them re-triggers loads, so only control values may differ.
+ */
+bool canReuseInstance(const PluginState& live, const PluginState& target);
+
+/**
+ * Match target plugins to live ones: same position first, then the first unclaimed live
+ * instance in chain order, so duplicates of a plugin keep their relative order.
+ */
+ChainStatePlan planChainState(const std::vector<PluginState>& live, const std::vector<PluginState>& target);
+
+} // namespace guitarrackcraft
+
+#endif // GUITARRACKCRAFT_CHAIN_STATE_DIFF_H
@@ -54,6 +54,12 @@ struct ScalePoint {
     float value;
 };
 
+/** Input control that trades sound quality for CPU (oversampling, quality mode). */
+struct QualityControl {
+    uint32_t portIndex;
+    float cheapestValue;
+};
+
 struct PortInfo {
     uint32_t index;
     std::string name;
@@ -108,6 +114,9 @@ public:
 
     /**
      * Process audio through the plugin.
+     * Buffers belong to the caller and may be used directly as the plugin's port buffers; they
+     * are only touched inside process(). Input and output buffers never alias unless
+     * canProcessInPlace() returns true, in which case outputs[i] may equal inputs[i].
      * @param inputs Array of input audio buffers (one per input port)
      * @param outputs Array of output audio buffers (one per output port)
      * @param numFrames Number of audio frames to process
@@ -121,11 +130,48 @@ public:
 
     /**
      * Set a control parameter value.
+     * Implementations may queue the change for the start of the next process() block and
+     * ramp continuous ports towards it instead of jumping.
      * @param portIndex Index of the control port
      * @param value Normalized value [0.0, 1.0] or denormalized depending on port
      */
     virtual void setParameter(uint32_t portIndex, float value) = 0;
 
+    /**
+     * Set a control parameter 'frameOffset' frames into the next process() block (clamped to
+     * the block), for sample-accurate sources such as MIDI or an expression pedal.
+     * The default applies the change immediately.
+     */
+    virtual void setParameterAt(uint32_t portIndex, float value, uint32_t frameOffset) {
+        (void)frameOffset;
+        setParameter(portIndex, value);
+    }
+
+    /**
+     * Audio thread only, between process() calls: setParameterAt() without locking, for host
+     * mappings resolved on the audio thread (MIDI learn). getParameter() reports the value.
+     * The default drops it; plugins that can take it lock-free override this.
+     */
+    virtual void setParameterRt(uint32_t portIndex, float value, uint32_t frameOffset) {
+        (void)portIndex;
+        (void)value;
+        (void)frameOffset;
+    }
+
+    /** True if the plugin takes MIDI (LV2: an atom input supporting midi:MidiEvent).
+     *  Changes only in activate(), like the port layout. */
+    virtual bool hasMidiInput() const { return false; }
+
+    /**
+     * Audio thread only, between process() calls: deliver one MIDI message (at most 3 bytes)
+     * 'frameOffset' frames into the next process() block (clamped to the block).
+     */
+    virtual void queueMidi(const uint8_t* data, uint32_t size, uint32_t frameOffset) {
+        (void)data;
+        (void)size;
+        (void)frameOffset;
+    }
+
     /**
      * Get a control parameter value.
      * @param portIndex Index of the control port
@@ -133,6 +179,80 @@ public:
      */
     virtual float getParameter(uint32_t portIndex) const = 0;
 
+    /**
+     * Number of control ports, and the port index of the i-th one in port order.
+     * Used for bulk parameter access; both must not change after construction/activation.
+     */
+    virtual uint32_t getNumControlPorts() const { return 0; }
+    virtual uint32_t getControlPortIndex(uint32_t i) const { (void)i; return 0; }
+
+    /**
+     * Copy the output control port values (meters, gain reduction, ...) in port order into
+     * 'values', writing at most 'capacity'. Returns the number of output control ports, or 0
+     * while inactive. Real-time safe; called on the audio thread between process() calls.
+     */
+    virtual uint32_t readOutputControls(float* values, uint32_t capacity) {
+        (void)values;
+        (void)capacity;
+        return 0;
+    }
+
+    /**
+     * Append (port index, value) for each output control port whose value process() changed
+     * since the previous call, so a UI pays for changes rather than for ports. Called from the
+     * UI thread. Returns false if the plugin does not track changes; poll getParameter() then.
+     */
+    virtual bool takeChangedOutputs(std::vector<std::pair<uint32_t, float>>& changed) {
+        (void)changed;
+        return false;
+    }
+
+    /**
+     * True if process() works with outputs[i] == inputs[i] (LV2: no lv2:inPlaceBroken).
+     * Must not change after construction.
+     */
+    virtual bool canProcessInPlace() const { return false; }
+
+    /**
+     * True if process() needs IEEE 754 denormals; the host runs DSP threads with
+     * flush-to-zero and turns it off around this plugin only. Must not change after construction.
+     */
+    virtual bool needsStrictFloat() const { return false; }
+
+    /** getTailFrames(): no declared tail; the host measures the decay instead. */
+    static constexpr uint32_t kTailUnknown = 0xFFFFFFFEu;
+    /** getTailFrames(): output without input (generators, oscillators); never put to sleep. */
+    static constexpr uint32_t kTailInfinite = 0xFFFFFFFFu;
+
+    /**
+     * Frames of output that can follow the last non-silent input, excluding latency. The chain
+     * skips process() and emits zeros once the input has been silent for latency + tail and
+     * the output has decayed to silence.
+     */
+    virtual uint32_t getTailFrames() const { return kTailUnknown; }
+
+    /** Reported processing latency in frames (LV2: the lv2:latency output port). Audio thread. */
+    virtual uint32_t getLatencyFrames() const { return 0; }
+
+    /**
+     * Input control port that switches the plugin on (1) and off (0), LV2's lv2:enabled
+     * designation; -1 if none. The host bypass follows it. Must not change after construction.
+     */
+    virtual int32_t getEnabledPortIndex() const { return -1; }
+
+    /**
+     * Controls the chain may turn down to their cheapest value while the audio thread is
+     * overloaded (PluginChain::setQualityShed). Must not change after construction.
+     */
+    virtual std::vector<QualityControl> getQualityControls() const { return {}; }
+
+    /**
+     * Keep the host-side buffers the audio thread touches (ports, atom sequences) pinned in
+     * RAM while 'locked', including across re-instantiation (rt_memory::lock; best effort).
+     * Control thread. Returns false if the lock was refused.
+     */
+    virtual bool setMemoryLocked(bool locked) { (void)locked; return true; }
+
     /**
      * Get number of input audio ports.
      */
@@ -18,24 +18,401 @@
  */
 
 #include "PluginChain.h"
+#include "ChainStateDiff.h"
+#include "PluginWarmUp.h"
+#include "../engine/RingBuffer.h"
+#include "../utils/AudioKernels.h"
+#include "../utils/FloatEnv.h"
+#include "../utils/RtGuard.h"
+#include "../utils/RtMemory.h"
+#include "../utils/RtTrace.h"
+#include "../utils/RtWorkerPool.h"
+#include "../utils/SystemTrace.h"
 #include "../utils/ThreadUtils.h"
-#include <android/log.h>
+#include "../utils/LogCompat.h"
 #include <algorithm>
+#include <cmath>
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <cstring>
+#include <thread>
 
 #define LOG_TAG "PluginChain"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
 namespace guitarrackcraft {
 
+namespace {
+
+constexpr auto kFadeStallTimeout = std::chrono::milliseconds(50);
+constexpr uint32_t kTraceEveryBlocks = 750;
+// Scratch block size until setSampleRate() names the real one
+constexpr uint32_t kDefaultScratchFrames = 1024;
+// Denormal probe: a block whose input peaks below -90 dBFS is silent; a silent block taking
+// kSpikeFactor times the plugin's average on signal (and kSpikeFloorNs more) is a spike.
+constexpr float kSilencePeak = 3.2e-5f;
+constexpr uint32_t kSpikeFactor = 3;
+constexpr uint32_t kSpikeFloorNs = 2000;
+// Silence sleeping: output must stay below kSilencePeak this long when a plugin declares no tail
+constexpr float kSleepHoldSeconds = 0.25f;
+constexpr uint32_t kDefaultSleepHoldFrames = 12000;
+// ... and this long while load shedding asks for fast sleep
+constexpr float kFastSleepHoldSeconds = 0.05f;
+// Per-slot bypass crossfade
+constexpr float kBypassRampSeconds = 0.01f;
+constexpr uint32_t kDefaultBypassRampFrames = 480;
+
+/** Owner name for RT guard reports; interning copies the name, so only debug builds pay. */
+const char* guardName(const IPlugin& plugin) {
+#if defined(GRC_RT_GUARD) && GRC_RT_GUARD
+    return rt_guard::intern(plugin.getInfo().name);
+#else
+    (void)plugin;
+    return nullptr;
+#endif
+}
+
+void copyThrough(const float* const* inputs, float* const* outputs, uint32_t numFrames) {
+    if (inputs && outputs && numFrames > 0) {
+        for (uint32_t ch = 0; ch < 2; ++ch) {
+            if (inputs[ch] && outputs[ch] && inputs[ch] != outputs[ch]) {
+                std::memcpy(outputs[ch], inputs[ch], numFrames * sizeof(float));
+            }
+        }
+    }
+}
+
+/** Port indices travel as floats in bulk parameter blocks; reject anything not a valid index. */
+bool portFromFloat(float value, uint32_t& port) {
+    if (!(value >= 0.0f && value < 16777216.0f)) return false;
+    port = static_cast<uint32_t>(value);
+    return true;
+}
+
+bool contains(const std::vector<IPlugin*>& list, const IPlugin* plugin) {
+    return std::find(list.begin(), list.end(), plugin) != list.end();
+}
+
+uint64_t branchKey(int group, int branch) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(group)) << 32) |
+           static_cast<uint32_t>(branch);
+}
+
+struct BranchJob {
+    PluginChain* chain;
+    const void* stage;
+    void* scratch;
+    const float* const* inputs;
+    uint32_t numFrames;
+    uint32_t fadePos;
+    uint32_t fadeFrames;
+};
+
+struct SegmentJob {
+    PluginChain* chain;
+    const void* snapshot;
+    const float* const* inputs;
+    float* const* outputs;
+    uint32_t numFrames;
+    uint32_t fadePos;
+    uint32_t fadeFrames;
+};
+
+uint32_t saturatingAdd(uint32_t a, uint32_t b) {
+    return a > UINT32_MAX - b ? UINT32_MAX : a + b;
+}
+
+uint32_t elapsedNs(std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    return ns > 0 ? static_cast<uint32_t>(std::min<int64_t>(ns, UINT32_MAX)) : 0;
+}
+
+} // namespace
+
+PluginChain::PluginChain()
+    : sleepHoldFrames_(kDefaultSleepHoldFrames), bypassRampFrames_(kDefaultBypassRampFrames) {}
+
+PluginChain::~PluginChain() {
+    // No process() call may be in flight when the owner is destroyed.
+    delete snapshot_.exchange(nullptr);
+}
+
+void PluginChain::forgetPlugin(const IPlugin* plugin) {
+    const IPlugin* tapped = plugin;
+    tapPlugin_.compare_exchange_strong(tapped, nullptr);
+    routing_.erase(plugin);
+    stats_.erase(plugin);
+    std::lock_guard shedLock(shedMutex_);
+    shedControls_.erase(std::remove_if(shedControls_.begin(), shedControls_.end(),
+                                       [plugin](const ShedControl& c) { return c.plugin == plugin; }),
+                        shedControls_.end());
+}
+
+std::unique_ptr<PluginChain::SlotStats> PluginChain::makeSlotStats(const IPlugin& plugin) {
+    auto stats = std::make_unique<SlotStats>();
+    std::snprintf(stats->traceName, sizeof(stats->traceName), "%s", plugin.getInfo().name.c_str());
+    // A plugin restored switched off starts bypassed, without a ramp
+    const int32_t enabledPort = plugin.getEnabledPortIndex();
+    if (enabledPort >= 0 && plugin.getParameter(static_cast<uint32_t>(enabledPort)) < 0.5f) {
+        stats->bypassed.store(true);
+        stats->bypassGain = 0.0f;
+    }
+    return stats;
+}
+
+void PluginChain::controlsChanged(const IPlugin* plugin) const {
+    auto it = stats_.find(plugin);
+    if (it == stats_.end()) return;
+    it->second->wake.store(true, std::memory_order_relaxed);
+    const int32_t enabledPort = plugin->getEnabledPortIndex();
+    if (enabledPort >= 0) {
+        it->second->bypassed.store(plugin->getParameter(static_cast<uint32_t>(enabledPort)) < 0.5f,
+                                   std::memory_order_relaxed);
+    }
+}
+
+std::vector<PluginChain::Snapshot::Segment> PluginChain::splitPipeline(
+        const std::vector<Snapshot::Stage>& stages, size_t count) const {
+    // Stage cost: serial sum within a branch, slowest branch for a parallel stage.
+    // Plugins not measured yet count as one unit so the first split is by plugin count.
+    const size_t n = stages.size();
+    std::vector<uint64_t> cost(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        for (auto& branch : stages[i].branches) {
+            uint64_t sum = 0;
+            for (auto& slot : branch.slots) {
+                uint32_t ns = slot.stats ? slot.stats->avgNs.load(std::memory_order_relaxed) : 0;
+                sum += ns > 0 ? ns : 1;
+            }
+            cost[i] = std::max(cost[i], sum);
+        }
+    }
+    count = std::min(count, n);
+
+    // Linear partition: best[k][i] = min over cuts of the max segment cost for stages [0, i)
+    // split into k segments. n is a rack's worth of plugins, so O(k n^2) is nothing.
+    std::vector<uint64_t> prefix(n + 1, 0);
+    for (size_t i = 0; i < n; ++i) prefix[i + 1] = prefix[i] + cost[i];
+    std::vector<std::vector<uint64_t>> best(count + 1, std::vector<uint64_t>(n + 1, UINT64_MAX));
+    std::vector<std::vector<size_t>> cut(count + 1, std::vector<size_t>(n + 1, 0));
+    best[0][0] = 0;
+    for (size_t k = 1; k <= count; ++k) {
+        for (size_t i = k; i <= n; ++i) {
+            for (size_t j = k - 1; j < i; ++j) {
+                if (best[k - 1][j] == UINT64_MAX) continue;
+                uint64_t worst = std::max(best[k - 1][j], prefix[i] - prefix[j]);
+                if (worst < best[k][i]) {
+                    best[k][i] = worst;
+                    cut[k][i] = j;
+                }
+            }
+        }
+    }
+
+    std::vector<Snapshot::Segment> segments(count);
+    size_t end = n;
+    for (size_t k = count; k > 0; --k) {
+        size_t begin = cut[k][end];
+        segments[k - 1] = {begin, end};
+        end = begin;
+    }
+    return segments;
+}
+
+void PluginChain::setPipelineStages(int stages) {
+    std::unique_lock lock(chainMutex_);
+    stages = std::max(0, std::min(stages, kMaxWorkers + 1));
+    if (stages == pipelineStages_) {
+        return;
+    }
+    pipelineStages_ = stages;
+    profiling_.store(profilingRequested_ || pipelineStages_ > 1);
+    if (!inBatch_) {
+        publishSnapshot(controlView());
+    }
+    LOGI("setPipelineStages: %d", stages);
+}
+
+void PluginChain::setProfilingEnabled(bool enabled) {
+    std::unique_lock lock(chainMutex_);
+    profilingRequested_ = enabled;
+    profiling_.store(profilingRequested_ || pipelineStages_ > 1);
+}
+
+void PluginChain::rebalancePipeline() {
+    std::unique_lock lock(chainMutex_);
+    if (pipelineStages_ > 1 && !inBatch_) {
+        publishSnapshot(controlView());
+    }
+}
+
+std::vector<IPlugin*> PluginChain::controlView() const {
+    std::vector<IPlugin*> view;
+    view.reserve(plugins_.size());
+    for (auto& plugin : plugins_) {
+        view.push_back(plugin.get());
+    }
+    return view;
+}
+
+void PluginChain::publishSnapshot(const std::vector<IPlugin*>& plugins,
+                                  const std::vector<IPlugin*>& fadeIn,
+                                  const std::vector<IPlugin*>& fadeOut,
+                                  bool crossfade) {
+    auto* next = new Snapshot();
+    next->plugins = plugins;
+    bool ramped = false;
+    // Build stages: runs of group 0 form serial stages, runs of one non-zero group form a
+    // parallel stage whose branches are keyed by branch id.
+    int stageGroup = 0;
+    std::vector<int> branchIds;
+    for (IPlugin* plugin : plugins) {
+        Snapshot::Fade fade = Snapshot::Fade::None;
+        if (contains(fadeIn, plugin)) {
+            fade = Snapshot::Fade::In;
+        } else if (contains(fadeOut, plugin)) {
+            fade = Snapshot::Fade::Out;
+        }
+        ramped |= fade != Snapshot::Fade::None;
+
+        Routing routing;
+        auto it = routing_.find(plugin);
+        if (it != routing_.end()) routing = it->second;
+        int branchId = routing.group == 0 ? 0 : routing.branch;
+        auto stats = stats_.find(plugin);
+        SlotStats* slotStats = stats != stats_.end() ? stats->second.get() : nullptr;
+
+        // When pipelining, every serial plugin is its own stage so the split can fall anywhere.
+        bool splitSerial = pipelineStages_ > 1 && routing.group == 0;
+        if (next->stages.empty() || routing.group != stageGroup || splitSerial) {
+            next->stages.emplace_back();
+            stageGroup = routing.group;
+            branchIds.clear();
+        }
+        auto& stage = next->stages.back();
+        auto pos = std::find(branchIds.begin(), branchIds.end(), branchId);
+        size_t b = static_cast<size_t>(pos - branchIds.begin());
+        if (pos == branchIds.end()) {
+            branchIds.push_back(branchId);
+            Snapshot::Branch branch;
+            auto gain = branchGains_.find(branchKey(stageGroup, branchId));
+            branch.gain = gain != branchGains_.end() ? gain->second : -1.0f;
+            stage.branches.push_back(std::move(branch));
+        }
+        stage.branches[b].slots.push_back({plugin, fade, slotStats, plugin->canProcessInPlace(),
+                                         plugin->needsStrictFloat(), plugin->getTailFrames(),
+                                         guardName(*plugin)});
+    }
+    for (auto& stage : next->stages) {
+        // Unset mixer gains default to an equal-weight sum
+        float defaultGain = 1.0f / static_cast<float>(stage.branches.size());
+        for (auto& branch : stage.branches) {
+            if (branch.gain < 0.0f) branch.gain = defaultGain;
+        }
+        next->maxBranches = std::max(next->maxBranches, stage.branches.size());
+    }
+    // A crossfade runs two graphs back to back, which the pipeline can't interleave.
+    if (pipelineStages_ > 1 && !crossfade && next->stages.size() > 1) {
+        next->segments = splitPipeline(next->stages, static_cast<size_t>(pipelineStages_));
+    }
+    if ((next->maxBranches > 1 || !next->segments.empty()) && !workers_) {
+        unsigned cores = std::thread::hardware_concurrency();
+        int count = std::min(kMaxWorkers, cores > 1 ? static_cast<int>(cores) - 1 : 1);
+        workers_ = std::make_unique<RtWorkerPool>(count);
+    }
+
+    // Only writers swap the pointer, and they hold chainMutex_ exclusively.
+    Snapshot* prev = snapshot_.load(std::memory_order_relaxed);
+    uint32_t frames = crossfadeFrames_.load();
+    if (frames > 0 && crossfade && prev) {
+        next->outgoing.reset(prev);
+        ramped = true;
+    }
+    if (frames > 0 && ramped) {
+        next->fadeFrames = frames;
+        next->fadeDone.store(false);
+    }
+    // Buffers for the new topology are allocated here, never on its first audio block.
+    next->scratch = scratchFor(
+        bufferSize_ > 0 ? bufferSize_ : kDefaultScratchFrames,
+        std::max<size_t>({1, next->maxBranches, next->outgoing ? next->outgoing->maxBranches : 0}),
+        std::max<size_t>(1, next->segments.size()));
+
+    snapshot_.exchange(next, std::memory_order_seq_cst);
+    waitForReaders();
+    if (next->outgoing) {
+        // The outgoing chain is run without its own predecessor.
+        next->outgoing->outgoing.reset();
+    } else {
+        delete prev;
+    }
+    published_ = plugins;
+
+    if (next->fadeFrames > 0) {
+        waitForFade(next);
+    }
+}
+
+void PluginChain::waitForReaders() const {
+    // Grace period: once activeReaders_ is observed at zero after the swap, every later
+    // process() call loads the new pointer. A block lasts at most a few ms, so poll.
+    while (activeReaders_.load(std::memory_order_seq_cst) != 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+void PluginChain::waitForFade(const Snapshot* snapshot) const {
+    // If the stream is stopped the ramp never advances; give up once process() stalls.
+    // Callers always follow up with a publish that drops the ramp, so this is only cosmetic.
+    uint64_t lastCount = processCount_.load(std::memory_order_relaxed);
+    auto lastProgress = std::chrono::steady_clock::now();
+    while (!snapshot->fadeDone.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        uint64_t count = processCount_.load(std::memory_order_relaxed);
+        auto now = std::chrono::steady_clock::now();
+        if (count != lastCount) {
+            lastCount = count;
+            lastProgress = now;
+        } else if (now - lastProgress > kFadeStallTimeout) {
+            LOGI("waitForFade: audio thread idle, skipping ramp");
+            return;
+        }
+    }
+}
+
 int PluginChain::addPlugin(std::unique_ptr<IPlugin> plugin, int position) {
     if (!plugin) {
         return -1;
     }
 
+    // Activate the new plugin with current sample rate so it processes audio.
+    // Plugins added after the engine has started would otherwise never be activated.
+    // Done before taking the exclusive lock: convolver/NAM activation takes tens of ms,
+    // during which the audio thread's try_to_lock would fail and the chain would pass dry.
+    // The plugin is not published yet, so nothing else can touch it meanwhile.
+    float sampleRate;
+    uint32_t bufferSize;
+    {
+        std::shared_lock lock(chainMutex_);
+        sampleRate = sampleRate_;
+        bufferSize = bufferSize_;
+    }
+    if (sampleRate > 0.0f) {
+        plugin->activate(sampleRate, bufferSize);
+        if (memoryLocking_.load()) plugin->setMemoryLocked(true);
+        warmUpPlugin(*plugin, bufferSize);
+    }
+
     std::unique_lock lock(chainMutex_);
+    if (sampleRate_ > 0.0f && (sampleRate_ != sampleRate || bufferSize_ != bufferSize)) {
+        // setSampleRate() ran in between; rare, so just redo it under the lock
+        plugin->activate(sampleRate_, bufferSize_);
+    }
 
+    IPlugin* added = plugin.get();
+    stats_[added] = makeSlotStats(*added);
     int index;
     if (position < 0 || position >= static_cast<int>(plugins_.size())) {
         plugins_.push_back(std::move(plugin));
@@ -44,11 +421,8 @@ int PluginChain::addPlugin(std::unique_ptr<IPlugin> plugin, int position) {
         plugins_.insert(plugins_.begin() + position, std::move(plugin));
         index = position;
     }
-
-    // Activate the new plugin with current sample rate so it processes audio.
-    // Plugins added after the engine has started would otherwise never be activated.
-    if (sampleRate_ > 0.0f) {
-        plugins_[index]->activate(sampleRate_, bufferSize_);
+    if (!inBatch_) {
+        publishSnapshot(controlView(), {added});
     }
     LOGI("addPlugin: index=%d sampleRate=%.0f", index, sampleRate_);
     return index;
@@ -61,8 +435,28 @@ bool PluginChain::removePlugin(int index) {
         return false;
     }
 
-    plugins_[index]->deactivate();
+    std::unique_ptr<IPlugin> removed = std::move(plugins_[index]);
     plugins_.erase(plugins_.begin() + index);
+    IPlugin* raw = removed.get();
+
+    if (inBatch_) {
+        // The live chain may still be running it; keep it until commitBatch().
+        if (contains(published_, raw)) {
+            retired_.push_back(std::move(removed));
+        } else {
+            removed->deactivate();
+            forgetPlugin(raw);
+        }
+        return true;
+    }
+
+    // Ramp it to dry in place, then unpublish; after the grace period the audio
+    // thread holds no reference.
+    publishSnapshot(published_, {}, {raw});
+    publishSnapshot(controlView());
+
+    removed->deactivate();
+    forgetPlugin(raw);
     return true;
 }
 
@@ -76,99 +470,609 @@ bool PluginChain::reorderPlugins(int fromIndex, int toIndex) {
     }
 
     auto plugin = std::move(plugins_[fromIndex]);
+    IPlugin* moved = plugin.get();
     plugins_.erase(plugins_.begin() + fromIndex);
     
     plugins_.insert(plugins_.begin() + toIndex, std::move(plugin));
-    
+    if (!inBatch_) {
+        // Fade out at the old position, fade back in at the new one.
+        publishSnapshot(published_, {}, {moved});
+        publishSnapshot(controlView(), {moved});
+    }
+
     return true;
 }
 
-void PluginChain::process(const float* const* inputs, float* const* outputs, uint32_t numFrames) {
-    // Shared lock so we can run alongside get/setParameter; only fail when add/remove holds exclusive
-    std::shared_lock lock(chainMutex_, std::try_to_lock);
-    if (!lock.owns_lock()) {
-        static auto lastLogFail = std::chrono::steady_clock::now();
-        auto now = std::chrono::steady_clock::now();
-        if (std::chrono::duration<double>(now - lastLogFail).count() >= 1.0) {
-            lastLogFail = now;
-            LOGI("process: lock failed tid=%ld passthrough", getTid());
-        }
-        if (inputs && outputs && numFrames > 0) {
-            for (uint32_t ch = 0; ch < 2; ++ch) {
-                if (inputs[ch] && outputs[ch]) {
-                    std::memcpy(outputs[ch], inputs[ch], numFrames * sizeof(float));
-                }
-            }
-        }
+void PluginChain::beginBatch() {
+    std::unique_lock lock(chainMutex_);
+    inBatch_ = true;
+}
+
+void PluginChain::commitBatch() {
+    std::unique_lock lock(chainMutex_);
+    if (!inBatch_) {
         return;
     }
+    inBatch_ = false;
+    publishBatch();
+}
+
+bool PluginChain::applyChainState(const ChainState& target, const PluginCreator& create) {
+    std::vector<PluginState> live;
+    std::vector<IPlugin*> liveView;
+    float sampleRate;
+    uint32_t bufferSize;
+    {
+        std::shared_lock lock(chainMutex_);
+        live.reserve(plugins_.size());
+        for (auto& plugin : plugins_) {
+            live.push_back(plugin->saveState());
+        }
+        liveView = controlView();
+        sampleRate = sampleRate_;
+        bufferSize = bufferSize_;
+    }
+    ChainStatePlan plan = planChainState(live, target.plugins);
 
-    if (plugins_.empty()) {
-        static auto lastLogEmpty = std::chrono::steady_clock::now();
-        auto now = std::chrono::steady_clock::now();
-        if (std::chrono::duration<double>(now - lastLogEmpty).count() >= 1.0) {
-            lastLogEmpty = now;
-            LOGI("process: chain empty, passthrough");
+    // Newcomers are instantiated and fully restored before the chain is touched, as addPlugin()
+    // does, so the exclusive section below only moves pointers.
+    std::vector<std::unique_ptr<IPlugin>> created(target.plugins.size());
+    for (size_t i = 0; i < target.plugins.size(); ++i) {
+        if (plan.slots[i].liveIndex >= 0) continue;
+        created[i] = create(target.plugins[i].pluginUri);
+        if (!created[i]) {
+            LOGE("applyChainState: cannot create %s", target.plugins[i].pluginUri.c_str());
+            return false;
         }
-        if (inputs && outputs && numFrames > 0) {
-            for (uint32_t ch = 0; ch < 2; ++ch) {
-                if (inputs[ch] && outputs[ch]) {
-                    std::memcpy(outputs[ch], inputs[ch], numFrames * sizeof(float));
-                }
+        if (sampleRate > 0.0f) {
+            created[i]->activate(sampleRate, bufferSize);
+            if (memoryLocking_.load()) created[i]->setMemoryLocked(true);
+            warmUpPlugin(*created[i], bufferSize);
+        }
+        created[i]->restoreState(target.plugins[i]);
+    }
+
+    std::unique_lock lock(chainMutex_);
+    if (controlView() != liveView) {
+        LOGE("applyChainState: chain changed while preparing, not applied");
+        return false;
+    }
+
+    std::vector<std::unique_ptr<IPlugin>> next;
+    next.reserve(target.plugins.size());
+    for (size_t i = 0; i < target.plugins.size(); ++i) {
+        const auto& slot = plan.slots[i];
+        if (slot.liveIndex >= 0) {
+            auto& kept = plugins_[slot.liveIndex];
+            for (const auto& [port, value] : slot.controlChanges) {
+                kept->setParameter(port, value);
             }
+            if (!slot.controlChanges.empty()) controlsChanged(kept.get());
+            next.push_back(std::move(kept));
+            continue;
+        }
+        if (sampleRate_ > 0.0f && (sampleRate_ != sampleRate || bufferSize_ != bufferSize)) {
+            created[i]->activate(sampleRate_, bufferSize_);
+        }
+        stats_[created[i].get()] = makeSlotStats(*created[i]);
+        next.push_back(std::move(created[i]));
+    }
+    for (int index : plan.dropped) {
+        std::unique_ptr<IPlugin>& dropped = plugins_[index];
+        if (contains(published_, dropped.get())) {
+            retired_.push_back(std::move(dropped));
+        } else {
+            dropped->deactivate();
+            forgetPlugin(dropped.get());
         }
-        return;
     }
+    plugins_ = std::move(next);
+    if (!inBatch_) {
+        publishBatch();
+    }
+    LOGI("applyChainState: %zu plugins, kept %zu, dropped %zu", plugins_.size(), plan.reusedCount(),
+         plan.dropped.size());
+    return true;
+}
 
-    // Rate-limited: confirm we're running the chain (helps debug shutdown race)
-    {
-        static auto lastLogRun = std::chrono::steady_clock::now();
-        auto now = std::chrono::steady_clock::now();
-        if (std::chrono::duration<double>(now - lastLogRun).count() >= 1.0) {
-            lastLogRun = now;
-            LOGI("process: running chain tid=%ld size=%zu", getTid(), plugins_.size());
+void PluginChain::replaceChain(std::vector<std::unique_ptr<IPlugin>> plugins) {
+    std::unique_lock lock(chainMutex_);
+    for (auto& plugin : plugins_) {
+        if (contains(published_, plugin.get())) {
+            retired_.push_back(std::move(plugin));
+        } else {
+            plugin->deactivate();
+            forgetPlugin(plugin.get());
         }
     }
+    plugins_ = std::move(plugins);
+    for (auto& plugin : plugins_) {
+        stats_[plugin.get()] = makeSlotStats(*plugin);
+        if (memoryLocking_.load()) plugin->setMemoryLocked(true);
+    }
+    if (!inBatch_) {
+        publishBatch();
+    }
+    LOGI("replaceChain: %zu plugins", plugins_.size());
+}
+
+void PluginChain::publishBatch() {
+    std::vector<IPlugin*> next = controlView();
+    bool shared = std::any_of(next.begin(), next.end(),
+                              [this](IPlugin* p) { return contains(published_, p); });
+    if (!shared && !published_.empty() && !next.empty()) {
+        // Disjoint chains (typical preset switch): run both and crossfade.
+        publishSnapshot(next, {}, {}, true);
+    } else {
+        // Instances can't run twice per block, so ramp only the slots that differ.
+        std::vector<IPlugin*> removed;
+        std::vector<IPlugin*> inserted;
+        for (IPlugin* p : published_) {
+            if (!contains(next, p)) removed.push_back(p);
+        }
+        for (IPlugin* p : next) {
+            if (!contains(published_, p)) inserted.push_back(p);
+        }
+        if (!removed.empty()) {
+            publishSnapshot(published_, {}, removed);
+        }
+        publishSnapshot(next, inserted);
+    }
+    // Steady snapshot: drops the outgoing chain before its plugins are released.
+    publishSnapshot(next);
+
+    for (auto& plugin : retired_) {
+        plugin->deactivate();
+        forgetPlugin(plugin.get());
+    }
+    LOGI("publishBatch: %zu plugins, released %zu", next.size(), retired_.size());
+    retired_.clear();
+}
+
+bool PluginChain::setPluginRouting(int pluginIndex, int group, int branch) {
+    std::unique_lock lock(chainMutex_);
+    if (pluginIndex < 0 || pluginIndex >= static_cast<int>(plugins_.size()) || group < 0 || branch < 0) {
+        return false;
+    }
+    IPlugin* plugin = plugins_[pluginIndex].get();
+    if (group == 0) {
+        routing_.erase(plugin);
+    } else {
+        routing_[plugin] = Routing{group, branch};
+    }
+    if (!inBatch_) {
+        // Same as a move: fade out on the old path, back in on the new one.
+        publishSnapshot(published_, {}, {plugin});
+        publishSnapshot(controlView(), {plugin});
+    }
+    LOGI("setPluginRouting: index=%d group=%d branch=%d", pluginIndex, group, branch);
+    return true;
+}
+
+void PluginChain::setBranchGain(int group, int branch, float gain) {
+    std::unique_lock lock(chainMutex_);
+    branchGains_[branchKey(group, branch)] = gain;
+    if (!inBatch_) {
+        publishSnapshot(controlView());
+    }
+}
+
+void PluginChain::runChain(const std::vector<Snapshot::Slot>& slots, const float* const* inputs,
+                           float* const* outputs, uint32_t numFrames,
+                           uint32_t fadePos, uint32_t fadeFrames, BranchScratch& scratch) {
+    if (slots.empty()) {
+        copyThrough(inputs, outputs, numFrames);
+        return;
+    }
+
+    // Per-slot clock reads only while someone looks at the numbers (or the pipeline splits on them)
+    const bool profiling = profiling_.load(std::memory_order_relaxed);
+    const bool rampDone = fadePos >= fadeFrames;
+    const float rampStep = rampDone ? 0.0f : 1.0f / static_cast<float>(fadeFrames);
+    const uint32_t sleepHold = sleepHoldFrames_.load(std::memory_order_relaxed);
+    const float bypassRampStep = 1.0f / static_cast<float>(std::max<uint32_t>(
+                                            1, bypassRampFrames_.load(std::memory_order_relaxed)));
+
+    const IPlugin* tapPlugin = tapPlugin_.load(std::memory_order_acquire);
 
     // Process through chain
     const float* currentInputs[2] = {inputs[0], inputs[1]};
     float* currentOutputs[2] = {nullptr, nullptr};
+    int parity = -1;  // intermediate pair holding currentInputs; -1 = the caller's inputs
 
-    ensureBuffers(numFrames, 2);
+    for (size_t i = 0; i < slots.size(); ++i) {
+        const Snapshot::Slot& slot = slots[i];
+        // Host bypass: ramp the wet share towards the target; at 0 the slot is a wire
+        const float bypassFrom = slot.stats ? slot.stats->bypassGain : 1.0f;
+        const float bypassTo =
+            slot.stats && slot.stats->bypassed.load(std::memory_order_relaxed) ? 0.0f : 1.0f;
+        const bool bypassRamping = bypassFrom != bypassTo;
+        const bool fading = !rampDone && slot.fade != Snapshot::Fade::None;
+        const bool ramping = fading || bypassRamping;
+        const bool wire = (rampDone && slot.fade == Snapshot::Fade::Out) ||
+                          (bypassTo == 0.0f && !bypassRamping);
 
-    for (size_t i = 0; i < plugins_.size(); ++i) {
-        auto& plugin = plugins_[i];
-        
         // Set up outputs
-        if (i == plugins_.size() - 1) {
+        if (i == slots.size() - 1) {
             // Last plugin writes to final outputs
             currentOutputs[0] = outputs[0];
             currentOutputs[1] = outputs[1];
         } else {
-            // Intermediate plugins write to buffers
-            currentOutputs[0] = intermediateBuffers_[0].data();
-            currentOutputs[1] = intermediateBuffers_[1].data();
+            // Intermediate plugins stay in their input pair when they can process in place
+            // (a ramp needs the dry input afterwards), otherwise switch to the other pair.
+            // Wires cost nothing in place. The caller's inputs are never written.
+            if (parity < 0) {
+                parity = 0;
+            } else if ((!slot.inPlace && !wire) || ramping) {
+                parity ^= 1;
+            }
+            currentOutputs[0] = scratch.intermediate[parity][0].data();
+            currentOutputs[1] = scratch.intermediate[parity][1].data();
         }
 
-        // Process
         const float* const inputPtrs[2] = {currentInputs[0], currentInputs[1]};
-        plugin->process(inputPtrs, currentOutputs, numFrames);
+        const bool timed = profiling && slot.stats;
+        // Held to the end of this slot; a no-op unless the plugin opted out of flush-to-zero
+        const ScopedFloatMode floatMode(!slot.strictFloat);
+        const bool steady = !wire && !ramping;
+        // Slots that may sleep check their input every block; others only while profiling
+        const bool maySleep = steady && slot.stats && slot.tailFrames != IPlugin::kTailInfinite;
+        const bool silent = (maySleep || timed) &&
+                            kernels::peakAbsStereo(inputPtrs[0], inputPtrs[1], numFrames) < kSilencePeak;
+        bool sleeping = false;
+        if (maySleep) {
+            SlotStats& stats = *slot.stats;
+            const bool woken = stats.wake.load(std::memory_order_relaxed);
+            if (!silent || woken) {
+                // Signal is back: run this whole block, so its first sample is processed
+                if (woken) stats.wake.store(false, std::memory_order_relaxed);
+                stats.silentInFrames = 0;
+                stats.quietOutFrames = 0;
+                if (stats.asleep.load(std::memory_order_relaxed)) {
+                    stats.asleep.store(false, std::memory_order_relaxed);
+                    RT_TRACE("PluginChain", "slot wakes", static_cast<int>(i));
+                }
+            } else {
+                stats.silentInFrames = saturatingAdd(stats.silentInFrames, numFrames);
+                sleeping = stats.asleep.load(std::memory_order_relaxed);
+            }
+        }
+        std::chrono::steady_clock::time_point t0;
+        if (timed) t0 = std::chrono::steady_clock::now();
+        if (sleeping) {
+            // Input silent past the tail and the output decayed: the plugin would emit silence
+            std::memset(currentOutputs[0], 0, numFrames * sizeof(float));
+            std::memset(currentOutputs[1], 0, numFrames * sizeof(float));
+        } else if (steady) {
+            RT_GUARD_SCOPE(slot.guardName);
+            SYSTEM_TRACE_SCOPE(slot.stats ? slot.stats->traceName : "plugin");
+            slot.plugin->process(inputPtrs, currentOutputs, numFrames);
+            if (maySleep && silent) {
+                SlotStats& stats = *slot.stats;
+                const bool quiet = kernels::peakAbsStereo(currentOutputs[0], currentOutputs[1],
+                                                          numFrames) < kSilencePeak;
+                stats.quietOutFrames = quiet ? saturatingAdd(stats.quietOutFrames, numFrames) : 0;
+                // Declared tail: wait it out plus latency. Unknown: probe until the output has
+                // been silent for the hold time.
+                const bool declared = slot.tailFrames != IPlugin::kTailUnknown;
+                const uint64_t needIn = uint64_t{slot.plugin->getLatencyFrames()} +
+                                        (declared ? slot.tailFrames : sleepHold);
+                const uint32_t needOut = declared ? 1 : sleepHold;
+                if (stats.silentInFrames >= needIn && stats.quietOutFrames >= needOut) {
+                    stats.asleep.store(true, std::memory_order_relaxed);
+                    RT_TRACE("PluginChain", "slot sleeps", static_cast<int>(i));
+                }
+            }
+        } else if (wire) {
+            // Fully faded out or bypassed: the slot is a wire and the plugin does not run.
+            copyThrough(inputPtrs, currentOutputs, numFrames);
+        } else {
+            // Outputs never alias inputs, so the input is the dry signal.
+            {
+                RT_GUARD_SCOPE(slot.guardName);
+                SYSTEM_TRACE_SCOPE(slot.stats ? slot.stats->traceName : "plugin");
+                slot.plugin->process(inputPtrs, currentOutputs, numFrames);
+            }
+            const bool in = slot.fade == Snapshot::Fade::In;
+            const float bypassStep = (bypassTo > bypassFrom ? 1.0f : -1.0f) * bypassRampStep;
+            for (uint32_t ch = 0; ch < 2; ++ch) {
+                const float* dry = inputPtrs[ch];
+                float* out = currentOutputs[ch];
+                for (uint32_t n = 0; n < numFrames; ++n) {
+                    float wet = 1.0f;
+                    if (fading) {
+                        float g = std::min(1.0f, static_cast<float>(fadePos + n + 1) * rampStep);
+                        wet = in ? g : 1.0f - g;
+                    }
+                    if (bypassRamping) {
+                        wet *= std::clamp(bypassFrom + static_cast<float>(n + 1) * bypassStep, 0.0f, 1.0f);
+                    }
+                    out[n] = dry[n] + wet * (out[n] - dry[n]);
+                }
+            }
+            if (bypassRamping) {
+                slot.stats->bypassGain = std::clamp(
+                    bypassFrom + static_cast<float>(numFrames) * bypassStep, 0.0f, 1.0f);
+            }
+        }
+
+        if (timed) {
+            uint32_t ns = elapsedNs(t0, std::chrono::steady_clock::now());
+            uint32_t avg = slot.stats->avgNs.load(std::memory_order_relaxed);
+            slot.stats->lastNs.store(ns, std::memory_order_relaxed);
+            slot.stats->avgNs.store(avg == 0 ? ns : avg + (static_cast<int32_t>(ns - avg) >> 4),
+                                    std::memory_order_relaxed);
+            // Cost should not rise when the input goes quiet; if it does, tails are denormal
+            uint32_t signalAvg = slot.stats->signalAvgNs.load(std::memory_order_relaxed);
+            if (!silent) {
+                slot.stats->signalAvgNs.store(
+                    signalAvg == 0 ? ns : signalAvg + (static_cast<int32_t>(ns - signalAvg) >> 4),
+                    std::memory_order_relaxed);
+            } else if (signalAvg != 0 && ns > signalAvg * kSpikeFactor && ns > signalAvg + kSpikeFloorNs) {
+                slot.stats->silentSpikes.store(
+                    slot.stats->silentSpikes.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+            }
+            uint32_t count = slot.stats->count.load(std::memory_order_relaxed);
+            slot.stats->window[count % SlotStats::kWindow].store(ns, std::memory_order_relaxed);
+            slot.stats->count.store(count + 1, std::memory_order_release);
+        }
+
+        if (slot.plugin == tapPlugin) {
+            if (RingBuffer* ring = tapRing_.load(std::memory_order_acquire)) {
+                ring->write(currentOutputs[0], numFrames);
+            }
+        }
 
         // Next plugin's input is this plugin's output
-        if (i < plugins_.size() - 1) {
-            currentInputs[0] = intermediateBuffers_[0].data();
-            currentInputs[1] = intermediateBuffers_[1].data();
+        if (i < slots.size() - 1) {
+            currentInputs[0] = currentOutputs[0];
+            currentInputs[1] = currentOutputs[1];
+        }
+    }
+}
+
+void PluginChain::runBranchJob(void* context, uint32_t index) {
+    auto* job = static_cast<BranchJob*>(context);
+    auto* stage = static_cast<const Snapshot::Stage*>(job->stage);
+    BranchScratch& scratch = static_cast<ScratchSet*>(job->scratch)->branches[index];
+    float* outs[2] = {scratch.out[0].data(), scratch.out[1].data()};
+    job->chain->runChain(stage->branches[index].slots, job->inputs, outs, job->numFrames,
+                         job->fadePos, job->fadeFrames, scratch);
+}
+
+void PluginChain::runGraph(const Snapshot& snapshot, size_t first, size_t last,
+                           const float* const* inputs, float* const* outputs, uint32_t numFrames,
+                           uint32_t fadePos, uint32_t fadeFrames, ScratchSet& scratch, bool fanOut) {
+    if (first >= last) {
+        copyThrough(inputs, outputs, numFrames);
+        return;
+    }
+
+    const float* stageIn[2] = {inputs[0], inputs[1]};
+    for (size_t s = first; s < last; ++s) {
+        const Snapshot::Stage& stage = snapshot.stages[s];
+        float* stageOut[2];
+        if (s == last - 1) {
+            stageOut[0] = outputs[0];
+            stageOut[1] = outputs[1];
+        } else {
+            stageOut[0] = scratch.stage[s % 2][0].data();
+            stageOut[1] = scratch.stage[s % 2][1].data();
+        }
+
+        if (stage.branches.size() == 1) {
+            runChain(stage.branches[0].slots, stageIn, stageOut, numFrames, fadePos, fadeFrames,
+                     scratch.branches[0]);
+        } else {
+            // Fan out: every branch reads the stage input and writes its own scratch output.
+            BranchJob job{this, &stage, &scratch, stageIn, numFrames, fadePos, fadeFrames};
+            uint32_t count = static_cast<uint32_t>(stage.branches.size());
+            if (fanOut && workers_) {
+                workers_->run(&PluginChain::runBranchJob, &job, count);
+            } else {
+                for (uint32_t b = 0; b < count; ++b) runBranchJob(&job, b);
+            }
+
+            // Mixer node
+            for (uint32_t ch = 0; ch < 2; ++ch) {
+                float* out = stageOut[ch];
+                const float* src0 = scratch.branches[0].out[ch].data();
+                kernels::copyWithGain(out, src0, numFrames, stage.branches[0].gain);
+                for (size_t b = 1; b < stage.branches.size(); ++b) {
+                    kernels::mixInto(out, scratch.branches[b].out[ch].data(), numFrames,
+                                     stage.branches[b].gain);
+                }
+            }
+        }
+
+        stageIn[0] = stageOut[0];
+        stageIn[1] = stageOut[1];
+    }
+}
+
+void PluginChain::runSegmentJob(void* context, uint32_t index) {
+    auto* job = static_cast<SegmentJob*>(context);
+    PluginChain* chain = job->chain;
+    auto* snapshot = static_cast<const Snapshot*>(job->snapshot);
+    const size_t last = snapshot->segments.size() - 1;
+    const uint32_t cur = chain->pipelineParity_;
+    const uint32_t prev = cur ^ 1;
+
+    // Segment j consumes what segment j-1 produced last callback and produces for the next one.
+    const float* in[2];
+    float* out[2];
+    if (index == 0) {
+        in[0] = job->inputs[0];
+        in[1] = job->inputs[1];
+    } else {
+        in[0] = snapshot->scratch->handoff[index - 1][prev][0].data();
+        in[1] = snapshot->scratch->handoff[index - 1][prev][1].data();
+    }
+    if (index == last) {
+        out[0] = job->outputs[0];
+        out[1] = job->outputs[1];
+    } else {
+        out[0] = snapshot->scratch->handoff[index][cur][0].data();
+        out[1] = snapshot->scratch->handoff[index][cur][1].data();
+    }
+    const auto& segment = snapshot->segments[index];
+    // Segments already occupy the pool, so parallel stages inside one run serially.
+    chain->runGraph(*snapshot, segment.begin, segment.end, in, out, job->numFrames,
+                    job->fadePos, job->fadeFrames, snapshot->scratch->sets[index], false);
+}
+
+void PluginChain::runPipeline(const Snapshot& snapshot, const float* const* inputs,
+                              float* const* outputs, uint32_t numFrames,
+                              uint32_t fadePos, uint32_t fadeFrames) {
+    if (numFrames != pipelineFrames_) {
+        // Block size changed: the queued blocks no longer line up, start from silence.
+        for (auto& boundary : snapshot.scratch->handoff) {
+            for (auto& parity : boundary) {
+                for (auto& channel : parity) {
+                    std::fill(channel.begin(), channel.end(), 0.0f);
+                }
+            }
         }
+        pipelineFrames_ = numFrames;
     }
+
+    SegmentJob job{this, &snapshot, inputs, outputs, numFrames, fadePos, fadeFrames};
+    workers_->run(&PluginChain::runSegmentJob, &job,
+                  static_cast<uint32_t>(snapshot.segments.size()));
+    pipelineParity_ ^= 1;
+}
+
+void PluginChain::process(const float* const* inputs, float* const* outputs, uint32_t numFrames) {
+    // Pin the published snapshot for this block: one counter increment and one pointer load.
+    // Writers swap the pointer and wait for activeReaders_ to drain before reclaiming,
+    // so the audio thread never blocks on control-side edits and never drops to dry.
+    activeReaders_.fetch_add(1, std::memory_order_seq_cst);
+    Snapshot* snapshot = snapshot_.load(std::memory_order_seq_cst);
+    processCount_.fetch_add(1, std::memory_order_relaxed);
+
+    if (!snapshot || (snapshot->stages.empty() && !snapshot->outgoing)) {
+        RT_TRACE_EVERY(kTraceEveryBlocks, LOG_TAG, "process: chain empty, passthrough");
+        copyThrough(inputs, outputs, numFrames);
+        activeReaders_.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+
+    // Confirm we're running the chain (helps debug shutdown race)
+    RT_TRACE_EVERY(kTraceEveryBlocks, LOG_TAG, "process: running chain tid/stages",
+                   getTid(), snapshot->stages.size());
+    // The pool was sized for the configured block on the control thread; a longer callback
+    // runs in slices rather than growing buffers here.
+    const uint32_t capacity = snapshot->scratch->frames;
+    if (numFrames <= capacity) {
+        processBlock(*snapshot, inputs, outputs, numFrames);
+    } else {
+        RT_TRACE_EVERY(kTraceEveryBlocks, LOG_TAG, "process: block over scratch size",
+                       numFrames, capacity);
+        for (uint32_t done = 0; done < numFrames; done += capacity) {
+            const uint32_t n = std::min(capacity, numFrames - done);
+            const float* in[2] = {inputs[0] + done, inputs[1] + done};
+            float* out[2] = {outputs[0] + done, outputs[1] + done};
+            processBlock(*snapshot, in, out, n);
+        }
+    }
+
+    activeReaders_.fetch_sub(1, std::memory_order_release);
+}
+
+void PluginChain::processBlock(Snapshot& snapshot, const float* const* inputs,
+                               float* const* outputs, uint32_t numFrames) {
+    ScratchPool& scratch = *snapshot.scratch;
+    const uint32_t fadePos = snapshot.fadePos;
+    const uint32_t fadeFrames = snapshot.fadeFrames;
+    const bool fading = fadePos < fadeFrames;
+
+    bool pipelined = false;
+    if (fading && snapshot.outgoing) {
+        // Run the outgoing chain as it was, then the incoming one, and crossfade outputs.
+        float* oldOutputs[2] = {scratch.crossfade[0].data(), scratch.crossfade[1].data()};
+        runGraph(*snapshot.outgoing, 0, snapshot.outgoing->stages.size(), inputs, oldOutputs,
+                 numFrames, 0, 0, scratch.sets[0], true);
+        runGraph(snapshot, 0, snapshot.stages.size(), inputs, outputs, numFrames, 0, 0,
+                 scratch.sets[0], true);
+        const float step = 1.0f / static_cast<float>(fadeFrames);
+        for (uint32_t ch = 0; ch < 2; ++ch) {
+            const float* from = oldOutputs[ch];
+            float* to = outputs[ch];
+            for (uint32_t n = 0; n < numFrames; ++n) {
+                float g = std::min(1.0f, static_cast<float>(fadePos + n + 1) * step);
+                to[n] = from[n] + g * (to[n] - from[n]);
+            }
+        }
+    } else if (!snapshot.segments.empty() && workers_) {
+        runPipeline(snapshot, inputs, outputs, numFrames, fadePos, fadeFrames);
+        pipelined = true;
+    } else {
+        runGraph(snapshot, 0, snapshot.stages.size(), inputs, outputs, numFrames,
+                 fadePos, fadeFrames, scratch.sets[0], true);
+    }
+
+    addedLatencyFrames_.store(
+        pipelined ? static_cast<uint32_t>(snapshot.segments.size() - 1) * numFrames : 0,
+        std::memory_order_relaxed);
+
+    if (fading) {
+        snapshot.fadePos = std::min(fadeFrames, fadePos + numFrames);
+        if (snapshot.fadePos >= fadeFrames) {
+            snapshot.fadeDone.store(true, std::memory_order_release);
+        }
+    }
+}
+
+uint32_t PluginChain::readOutputControls(uint32_t* counts, uint32_t maxPlugins, float* values,
+                                         uint32_t maxValues) {
+    activeReaders_.fetch_add(1, std::memory_order_seq_cst);
+    Snapshot* snapshot = snapshot_.load(std::memory_order_seq_cst);
+    uint32_t numPlugins = 0;
+    uint32_t used = 0;
+    if (snapshot) {
+        for (IPlugin* plugin : snapshot->plugins) {
+            if (numPlugins == maxPlugins) break;
+            uint32_t n = plugin->readOutputControls(values + used, maxValues - used);
+            n = std::min(n, maxValues - used);
+            counts[numPlugins++] = n;
+            used += n;
+        }
+    }
+    activeReaders_.fetch_sub(1, std::memory_order_release);
+    return numPlugins;
 }
 
 void PluginChain::setSampleRate(float sampleRate, uint32_t bufferSize) {
     std::unique_lock lock(chainMutex_);
     sampleRate_ = sampleRate;
     bufferSize_ = bufferSize;
+    if (sampleRate > 0.0f) {
+        const float hold = fastSleep_ ? kFastSleepHoldSeconds : kSleepHoldSeconds;
+        sleepHoldFrames_.store(static_cast<uint32_t>(sampleRate * hold));
+        bypassRampFrames_.store(static_cast<uint32_t>(sampleRate * kBypassRampSeconds));
+    }
     for (auto& plugin : plugins_) {
         plugin->activate(sampleRate, bufferSize);
     }
+    for (auto& plugin : retired_) {
+        plugin->activate(sampleRate, bufferSize);
+    }
+    // A longer block than the live pool holds: republish onto a pool sized for it.
+    const Snapshot* live = snapshot_.load(std::memory_order_relaxed);
+    if (live && live->scratch->frames < bufferSize) {
+        publishSnapshot(published_);
+    }
+}
+
+float PluginChain::getSampleRate() const {
+    std::shared_lock lock(chainMutex_);
+    return sampleRate_;
+}
+
+uint32_t PluginChain::getBufferSize() const {
+    std::shared_lock lock(chainMutex_);
+    return bufferSize_;
 }
 
 void PluginChain::activate() {
@@ -182,6 +1086,9 @@ void PluginChain::deactivate() {
     for (auto& plugin : plugins_) {
         plugin->deactivate();
     }
+    for (auto& plugin : retired_) {
+        plugin->deactivate();
+    }
     LOGI("deactivate() done tid=%ld", getTid());
 }
 
@@ -190,6 +1097,11 @@ size_t PluginChain::getSize() const {
     return plugins_.size();
 }
 
+std::vector<int32_t> PluginChain::getWorkerThreadIds() const {
+    std::shared_lock lock(chainMutex_);
+    return workers_ ? workers_->threadIds() : std::vector<int32_t>{};
+}
+
 IPlugin* PluginChain::getPlugin(int index) {
     std::shared_lock lock(chainMutex_);
     if (index < 0 || index >= static_cast<int>(plugins_.size())) {
@@ -204,6 +1116,17 @@ void PluginChain::setParameter(int pluginIndex, uint32_t portIndex, float value)
         return;
     }
     plugins_[pluginIndex]->setParameter(portIndex, value);
+    controlsChanged(plugins_[pluginIndex].get());
+}
+
+void PluginChain::setParameterAt(int pluginIndex, uint32_t portIndex, float value,
+                                 uint32_t frameOffset) {
+    std::shared_lock lock(chainMutex_);
+    if (pluginIndex < 0 || pluginIndex >= static_cast<int>(plugins_.size())) {
+        return;
+    }
+    plugins_[pluginIndex]->setParameterAt(portIndex, value, frameOffset);
+    controlsChanged(plugins_[pluginIndex].get());
 }
 
 float PluginChain::getParameter(int pluginIndex, uint32_t portIndex) const {
@@ -214,12 +1137,271 @@ float PluginChain::getParameter(int pluginIndex, uint32_t portIndex) const {
     return plugins_[pluginIndex]->getParameter(portIndex);
 }
 
+bool PluginChain::setPluginBypass(int pluginIndex, bool bypassed) {
+    std::shared_lock lock(chainMutex_);
+    if (pluginIndex < 0 || pluginIndex >= static_cast<int>(plugins_.size())) {
+        return false;
+    }
+    IPlugin* plugin = plugins_[pluginIndex].get();
+    auto it = stats_.find(plugin);
+    if (it == stats_.end()) return false;
+    // Keep the plugin's own switch in step so UIs and saved state agree with the host
+    const int32_t enabledPort = plugin->getEnabledPortIndex();
+    if (enabledPort >= 0) {
+        plugin->setParameter(static_cast<uint32_t>(enabledPort), bypassed ? 0.0f : 1.0f);
+    }
+    it->second->bypassed.store(bypassed, std::memory_order_relaxed);
+    it->second->wake.store(true, std::memory_order_relaxed);
+    LOGI("setPluginBypass: index=%d bypassed=%d", pluginIndex, bypassed ? 1 : 0);
+    return true;
+}
+
+PluginChain::SlotStats* PluginChain::findSlotStats(const Snapshot& snapshot, const IPlugin* plugin) {
+    for (const auto& stage : snapshot.stages) {
+        for (const auto& branch : stage.branches) {
+            for (const auto& slot : branch.slots) {
+                if (slot.plugin == plugin) return slot.stats;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void PluginChain::deliverHostEvents(const HostEvent* events, uint32_t count) {
+    if (count == 0) return;
+    // Same pin as process(): writers cannot reclaim the snapshot or its plugins meanwhile
+    activeReaders_.fetch_add(1, std::memory_order_seq_cst);
+    Snapshot* snapshot = snapshot_.load(std::memory_order_seq_cst);
+    if (!snapshot) {
+        activeReaders_.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+    const auto& plugins = snapshot->plugins;
+    for (uint32_t i = 0; i < count; ++i) {
+        const HostEvent& event = events[i];
+        if (event.kind == HostEvent::Kind::Midi) {
+            for (IPlugin* plugin : plugins) {
+                if (!plugin->hasMidiInput()) continue;
+                plugin->queueMidi(event.data, event.size, event.frame);
+                if (SlotStats* stats = findSlotStats(*snapshot, plugin)) {
+                    stats->wake.store(true, std::memory_order_relaxed);
+                }
+            }
+            continue;
+        }
+        if (event.pluginIndex < 0 || event.pluginIndex >= static_cast<int32_t>(plugins.size())) {
+            continue;
+        }
+        IPlugin* plugin = plugins[event.pluginIndex];
+        SlotStats* stats = findSlotStats(*snapshot, plugin);
+        const int32_t enabledPort = plugin->getEnabledPortIndex();
+        if (event.kind == HostEvent::Kind::Bypass || event.kind == HostEvent::Kind::BypassToggle) {
+            if (!stats) continue;
+            const bool bypassed = event.kind == HostEvent::Kind::Bypass
+                                      ? event.value >= 0.5f
+                                      : !stats->bypassed.load(std::memory_order_relaxed);
+            // As setPluginBypass(): the plugin's own switch follows the host bypass
+            if (enabledPort >= 0) {
+                plugin->setParameterRt(static_cast<uint32_t>(enabledPort), bypassed ? 0.0f : 1.0f,
+                                       event.frame);
+            }
+            stats->bypassed.store(bypassed, std::memory_order_relaxed);
+        } else {
+            float value = event.value;
+            if (event.kind == HostEvent::Kind::Toggle) {
+                const float current = plugin->getParameter(event.portIndex);
+                value = std::fabs(current - event.low) < std::fabs(current - event.value)
+                            ? event.value : event.low;
+            }
+            plugin->setParameterRt(event.portIndex, value, event.frame);
+            if (stats && enabledPort >= 0 && event.portIndex == static_cast<uint32_t>(enabledPort)) {
+                stats->bypassed.store(value < 0.5f, std::memory_order_relaxed);
+            }
+        }
+        if (stats) stats->wake.store(true, std::memory_order_relaxed);
+    }
+    activeReaders_.fetch_sub(1, std::memory_order_release);
+}
+
+bool PluginChain::setAnalysisTap(int pluginIndex, RingBuffer* ring) {
+    std::shared_lock lock(chainMutex_);
+    if (pluginIndex < 0 || !ring) {
+        tapPlugin_.store(nullptr, std::memory_order_release);
+        tapRing_.store(nullptr, std::memory_order_release);
+        return true;
+    }
+    if (pluginIndex >= static_cast<int>(plugins_.size())) return false;
+    tapPlugin_.store(nullptr, std::memory_order_release);  // no writes to a half-switched tap
+    tapRing_.store(ring, std::memory_order_release);
+    tapPlugin_.store(plugins_[pluginIndex].get(), std::memory_order_release);
+    LOGI("setAnalysisTap: index=%d", pluginIndex);
+    return true;
+}
+
+bool PluginChain::isPluginBypassed(int pluginIndex) const {
+    std::shared_lock lock(chainMutex_);
+    if (pluginIndex < 0 || pluginIndex >= static_cast<int>(plugins_.size())) {
+        return false;
+    }
+    auto it = stats_.find(plugins_[pluginIndex].get());
+    return it != stats_.end() && it->second->bypassed.load(std::memory_order_relaxed);
+}
+
+uint32_t PluginChain::setQualityShed(bool shed) {
+    std::shared_lock lock(chainMutex_);
+    std::lock_guard shedLock(shedMutex_);
+    if (shed == qualityShed_) return 0;
+    qualityShed_ = shed;
+    uint32_t changed = 0;
+    if (shed) {
+        for (auto& plugin : plugins_) {
+            for (const QualityControl& q : plugin->getQualityControls()) {
+                const float current = plugin->getParameter(q.portIndex);
+                if (current == q.cheapestValue) continue;
+                shedControls_.push_back({plugin.get(), q.portIndex, current, q.cheapestValue});
+                plugin->setParameter(q.portIndex, q.cheapestValue);
+                controlsChanged(plugin.get());
+                ++changed;
+            }
+        }
+    } else {
+        // Removed plugins were dropped from shedControls_ by forgetPlugin()
+        for (const ShedControl& c : shedControls_) {
+            // A control the user moved while shed keeps the user's value
+            if (c.plugin->getParameter(c.portIndex) != c.cheapest) continue;
+            c.plugin->setParameter(c.portIndex, c.original);
+            controlsChanged(c.plugin);
+            ++changed;
+        }
+        shedControls_.clear();
+    }
+    LOGI("setQualityShed(%d): %u controls", shed ? 1 : 0, changed);
+    return changed;
+}
+
+void PluginChain::setFastSleep(bool fast) {
+    std::unique_lock lock(chainMutex_);
+    fastSleep_ = fast;
+    if (sampleRate_ > 0.0f) {
+        const float hold = fast ? kFastSleepHoldSeconds : kSleepHoldSeconds;
+        sleepHoldFrames_.store(static_cast<uint32_t>(sampleRate_ * hold));
+    }
+}
+
+bool PluginChain::setMemoryLocking(bool locked) {
+    std::unique_lock lock(chainMutex_);
+    memoryLocking_.store(locked);
+    // Later pools are pinned as they are built
+    if (scratchPool_ && scratchPool_->locked != locked) {
+        scratchPool_->forEachBuffer([locked](std::vector<float>& buffer) {
+            const size_t bytes = buffer.size() * sizeof(float);
+            if (locked) {
+                rt_memory::lock(buffer.data(), bytes);
+            } else {
+                rt_memory::unlock(buffer.data(), bytes);
+            }
+        });
+        scratchPool_->locked = locked;
+    }
+    bool ok = true;
+    for (auto& plugin : plugins_) ok = plugin->setMemoryLocked(locked) && ok;
+    for (auto& plugin : retired_) plugin->setMemoryLocked(locked);
+    LOGI("setMemoryLocking: %d (%s)", locked ? 1 : 0, ok ? "ok" : "mlock refused for some plugins");
+    return ok;
+}
+
+uint32_t PluginChain::writeParameterBlock(const IPlugin& plugin, float* out, uint32_t capacity) {
+    const uint32_t count = plugin.getNumControlPorts();
+    const uint32_t size = 1 + 2 * count;
+    if (size > capacity || !out) {
+        return size;
+    }
+    out[0] = static_cast<float>(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t port = plugin.getControlPortIndex(i);
+        out[1 + 2 * i] = static_cast<float>(port);
+        out[2 + 2 * i] = plugin.getParameter(port);
+    }
+    return size;
+}
+
+uint32_t PluginChain::getParameters(int pluginIndex, float* out, uint32_t capacity) const {
+    std::shared_lock lock(chainMutex_);
+    if (pluginIndex < 0 || pluginIndex >= static_cast<int>(plugins_.size())) {
+        return 0;
+    }
+    return writeParameterBlock(*plugins_[pluginIndex], out, capacity);
+}
+
+void PluginChain::setParameters(int pluginIndex, const float* pairs, uint32_t count) {
+    std::shared_lock lock(chainMutex_);
+    if (pluginIndex < 0 || pluginIndex >= static_cast<int>(plugins_.size()) || !pairs) {
+        return;
+    }
+    IPlugin* plugin = plugins_[pluginIndex].get();
+    uint32_t port = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (portFromFloat(pairs[2 * i], port)) {
+            plugin->setParameter(port, pairs[2 * i + 1]);
+        }
+    }
+    controlsChanged(plugin);
+}
+
+uint32_t PluginChain::getAllParameters(float* out, uint32_t capacity) const {
+    std::shared_lock lock(chainMutex_);
+    uint32_t size = 1;
+    for (const auto& plugin : plugins_) {
+        size += 1 + 2 * plugin->getNumControlPorts();
+    }
+    if (size > capacity || !out) {
+        return size;
+    }
+    out[0] = static_cast<float>(plugins_.size());
+    uint32_t pos = 1;
+    for (const auto& plugin : plugins_) {
+        pos += writeParameterBlock(*plugin, out + pos, capacity - pos);
+    }
+    return size;
+}
+
+bool PluginChain::setAllParameters(const float* data, uint32_t size) {
+    std::shared_lock lock(chainMutex_);
+    if (!data || size < 1 || data[0] != static_cast<float>(plugins_.size())) {
+        LOGE("setAllParameters: block is for a different chain");
+        return false;
+    }
+    uint32_t pos = 1;
+    for (const auto& plugin : plugins_) {
+        // Counts come from Java: range-check before converting
+        if (pos >= size || !(data[pos] >= 0.0f) || data[pos] > static_cast<float>(size)) {
+            LOGE("setAllParameters: malformed block at %u", pos);
+            return false;
+        }
+        const uint32_t count = static_cast<uint32_t>(data[pos]);
+        if (size - pos - 1 < 2 * static_cast<uint64_t>(count)) {
+            LOGE("setAllParameters: truncated block");
+            return false;
+        }
+        uint32_t port = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            if (portFromFloat(data[pos + 1 + 2 * i], port)) {
+                plugin->setParameter(port, data[pos + 2 + 2 * i]);
+            }
+        }
+        controlsChanged(plugin.get());
+        pos += 1 + 2 * count;
+    }
+    return true;
+}
+
 void PluginChain::setPluginFilePath(int pluginIndex, const std::string& propertyUri, const std::string& path) {
     std::shared_lock lock(chainMutex_);
     if (pluginIndex < 0 || pluginIndex >= static_cast<int>(plugins_.size())) {
         return;
     }
     plugins_[pluginIndex]->setFilePath(propertyUri, path);
+    controlsChanged(plugins_[pluginIndex].get());
 }
 
 void PluginChain::injectAtom(int pluginIndex, const void* data, uint32_t size) {
@@ -228,6 +1410,39 @@ void PluginChain::injectAtom(int pluginIndex, const void* data, uint32_t size) {
         return;
     }
     plugins_[pluginIndex]->injectAtom(data, size);
+    controlsChanged(plugins_[pluginIndex].get());
+}
+
+std::vector<PluginChain::SlotTiming> PluginChain::getSlotTimings() const {
+    std::shared_lock lock(chainMutex_);
+    std::vector<SlotTiming> timings(plugins_.size());
+    std::vector<uint32_t> samples;
+    samples.reserve(SlotStats::kWindow);
+    for (size_t i = 0; i < plugins_.size(); ++i) {
+        auto it = stats_.find(plugins_[i].get());
+        if (it == stats_.end()) continue;
+        const SlotStats& stats = *it->second;
+
+        uint32_t count = std::min(stats.count.load(std::memory_order_acquire), SlotStats::kWindow);
+        samples.clear();
+        uint64_t sum = 0;
+        for (uint32_t k = 0; k < count; ++k) {
+            uint32_t ns = stats.window[k].load(std::memory_order_relaxed);
+            samples.push_back(ns);
+            sum += ns;
+        }
+        timings[i].lastUs = stats.lastNs.load(std::memory_order_relaxed) / 1000.0f;
+        if (count > 0) {
+            // Samples may be overwritten while copying; a torn window is fine for a meter.
+            size_t rank = std::min<size_t>(count - 1, (static_cast<size_t>(count) * 99) / 100);
+            std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+            timings[i].avgUs = static_cast<float>(sum) / count / 1000.0f;
+            timings[i].p99Us = samples[rank] / 1000.0f;
+        }
+        timings[i].silentSpikes = stats.silentSpikes.load(std::memory_order_relaxed);
+        timings[i].asleep = stats.asleep.load(std::memory_order_relaxed);
+    }
+    return timings;
 }
 
 PluginChain::ChainState PluginChain::saveChainState() {
@@ -237,6 +1452,16 @@ PluginChain::ChainState PluginChain::saveChainState() {
     for (auto& plugin : plugins_) {
         cs.plugins.push_back(plugin->saveState());
     }
+    // Presets keep the quality the user chose, not what load shedding turned it down to
+    std::lock_guard shedLock(shedMutex_);
+    for (const ShedControl& c : shedControls_) {
+        for (size_t i = 0; i < plugins_.size(); ++i) {
+            if (plugins_[i].get() != c.plugin) continue;
+            for (auto& [port, value] : cs.plugins[i].controlPortValues) {
+                if (port == c.portIndex && value == c.cheapest) value = c.original;
+            }
+        }
+    }
     LOGI("saveChainState: %zu plugins", cs.plugins.size());
     return cs;
 }
@@ -246,20 +1471,77 @@ bool PluginChain::restorePluginState(int index, const PluginState& state) {
     if (index < 0 || index >= static_cast<int>(plugins_.size())) {
         return false;
     }
-    bool ok = plugins_[index]->restoreState(state);
+    IPlugin* plugin = plugins_[index].get();
+    bool ok;
+    if (!contains(published_, plugin)) {
+        // Not on the audio path yet (added inside a batch).
+        ok = plugin->restoreState(state);
+    } else {
+        // Only this plugin leaves the audio path while its state is rewritten: ramp it to
+        // dry, unpublish, restore, then ramp it back in.
+        std::vector<IPlugin*> live = published_;
+        std::vector<IPlugin*> without = live;
+        without.erase(std::remove(without.begin(), without.end(), plugin), without.end());
+        publishSnapshot(live, {}, {plugin});
+        publishSnapshot(without);
+        ok = plugin->restoreState(state);
+        publishSnapshot(live, {plugin});
+    }
+    controlsChanged(plugin);
     LOGI("restorePluginState: index=%d ok=%d", index, ok);
     return ok;
 }
 
-void PluginChain::ensureBuffers(uint32_t numFrames, uint32_t numChannels) {
-    if (intermediateBuffers_.size() < numChannels) {
-        intermediateBuffers_.resize(numChannels);
+template <typename Fn>
+void PluginChain::ScratchPool::forEachBuffer(Fn&& fn) {
+    for (auto& set : sets) {
+        for (auto& scratch : set.branches) {
+            for (uint32_t ch = 0; ch < 2; ++ch) {
+                fn(scratch.intermediate[0][ch]);
+                fn(scratch.intermediate[1][ch]);
+                fn(scratch.out[ch]);
+            }
+        }
+        for (auto& pair : set.stage) {
+            fn(pair[0]);
+            fn(pair[1]);
+        }
     }
-    for (auto& buffer : intermediateBuffers_) {
-        if (buffer.size() < numFrames) {
-            buffer.resize(numFrames);
+    for (auto& boundary : handoff) {
+        for (auto& parity : boundary) {
+            for (auto& channel : parity) fn(channel);
         }
     }
+    for (auto& buffer : crossfade) {
+        fn(buffer);
+    }
+}
+
+std::shared_ptr<PluginChain::ScratchPool> PluginChain::scratchFor(uint32_t frames, size_t branches,
+                                                                  size_t sets) {
+    if (scratchPool_ && scratchPool_->frames >= frames && scratchPool_->sets.size() >= sets &&
+        scratchPool_->sets[0].branches.size() >= branches) {
+        return scratchPool_;
+    }
+    // Grow only, so alternating topologies settle on one pool. The published one stays
+    // untouched: the audio thread may be running on it until the grace period ends.
+    if (scratchPool_) {
+        frames = std::max(frames, scratchPool_->frames);
+        sets = std::max(sets, scratchPool_->sets.size());
+        branches = std::max(branches, scratchPool_->sets[0].branches.size());
+    }
+    auto pool = std::make_shared<ScratchPool>();
+    pool->frames = frames;
+    pool->sets.resize(sets);
+    for (auto& set : pool->sets) set.branches.resize(branches);
+    const bool locked = memoryLocking_.load();
+    pool->forEachBuffer([frames, locked](std::vector<float>& buffer) {
+        buffer.assign(frames, 0.0f);
+        if (locked) rt_memory::lock(buffer.data(), buffer.size() * sizeof(float));
+    });
+    pool->locked = locked;
+    scratchPool_ = pool;
+    return pool;
 }
 
 } // namespace guitarrackcraft
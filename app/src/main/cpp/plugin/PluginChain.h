@@ -20,18 +20,26 @@
 #ifndef GUITARRACKCRAFT_PLUGIN_CHAIN_H
 #define GUITARRACKCRAFT_PLUGIN_CHAIN_H
 
+#include <atomic>
+#include <functional>
 #include <vector>
 #include <memory>
+#include <string>
 #include <shared_mutex>
 #include <mutex>
+#include <unordered_map>
 #include "IPlugin.h"
 
 namespace guitarrackcraft {
 
+class RingBuffer;
+
+class RtWorkerPool;
+
 class PluginChain {
 public:
-    PluginChain() = default;
-    ~PluginChain() = default;
+    PluginChain();
+    ~PluginChain();
 
     int addPlugin(std::unique_ptr<IPlugin> plugin, int position = -1);
     bool removePlugin(int index);
@@ -40,6 +48,9 @@ public:
     void process(const float* const* inputs, float* const* outputs, uint32_t numFrames);
 
     void setSampleRate(float sampleRate, uint32_t bufferSize = 0);
+    /** Settings plugins are activated with; sample rate 0 until the engine has started. */
+    float getSampleRate() const;
+    uint32_t getBufferSize() const;
     void activate();
     void deactivate();
 
@@ -47,8 +58,84 @@ public:
     IPlugin* getPlugin(int index);
 
     void setParameter(int pluginIndex, uint32_t portIndex, float value);
+    /** Sample-accurate variant: the change lands 'frameOffset' frames into the next block. */
+    void setParameterAt(int pluginIndex, uint32_t portIndex, float value, uint32_t frameOffset);
     float getParameter(int pluginIndex, uint32_t portIndex) const;
 
+    /**
+     * Host bypass for one slot: crossfades to dry over ~10 ms, then stops calling process()
+     * until re-enabled, so a switched-off pedal costs nothing. Plugins with an enabled port
+     * (IPlugin::getEnabledPortIndex) get it written too, and writes to that port bypass the slot.
+     */
+    bool setPluginBypass(int pluginIndex, bool bypassed);
+    bool isPluginBypassed(int pluginIndex) const;
+
+    /**
+     * Load shedding (see AudioEngine): turn every plugin's quality controls
+     * (IPlugin::getQualityControls) down to their cheapest value, or put back what they were.
+     * Controls the user moves meanwhile keep the user's value; saveChainState() reports the
+     * original values while shed. Plugins added while shed are left alone. Returns the number
+     * of controls changed.
+     */
+    uint32_t setQualityShed(bool shed);
+    /** Load shedding: silent slots without a declared tail sleep after 50 ms instead of 250 ms. */
+    void setFastSleep(bool fast);
+
+    /**
+     * Keep RT memory pinned in RAM (rt_memory::lock): every plugin's host buffers, for plugins
+     * added later too, and the chain's scratch buffers, which are locked here and as they are
+     * allocated. Best effort; returns false if any lock was refused.
+     */
+    bool setMemoryLocking(bool locked);
+
+    /** Event from a hardware controller, resolved by the host (see MidiRouter). */
+    struct HostEvent {
+        enum class Kind : uint8_t {
+            Midi,     // raw message for every plugin with a MIDI input
+            Control,  // set 'portIndex' of plugin 'pluginIndex' to 'value'
+            Toggle,   // flip that port between 'low' and 'value' (whichever it is further from)
+            Bypass,   // host bypass on (value >= 0.5) or off
+            BypassToggle,
+        };
+        Kind kind = Kind::Midi;
+        uint8_t size = 0;      // Midi: bytes used in 'data'
+        uint8_t data[3] = {};
+        int32_t pluginIndex = -1;
+        uint32_t portIndex = 0;
+        float value = 0.0f;
+        float low = 0.0f;
+        uint32_t frame = 0;    // offset into the next block
+    };
+
+    /**
+     * Audio thread only, right before process(): hand 'count' events to the plugins of the
+     * published chain for the coming block. Plugin indices are in chain order. Never blocks;
+     * events for missing plugins or ports are dropped.
+     */
+    void deliverHostEvents(const HostEvent* events, uint32_t count);
+
+    /**
+     * Analysis tap (see AnalysisTap): after each block, copy the left output of the plugin now
+     * at 'pluginIndex' into 'ring', from whichever thread runs it. The tap follows that plugin
+     * through reorders and ends when it is removed. -1 or a null ring turns it off.
+     */
+    bool setAnalysisTap(int pluginIndex, RingBuffer* ring);
+
+    /**
+     * Bulk control access under one lock acquisition. One plugin's block is
+     * [count, port0, value0, port1, value1, ...]; port indices are stored as floats (exact
+     * below 2^24). Returns the number of floats needed; nothing is written if that exceeds
+     * 'capacity'.
+     */
+    uint32_t getParameters(int pluginIndex, float* out, uint32_t capacity) const;
+    /** Apply 'count' (port, value) pairs to one plugin. */
+    void setParameters(int pluginIndex, const float* pairs, uint32_t count);
+    /** Whole chain: [pluginCount, then one block per plugin in chain order]. */
+    uint32_t getAllParameters(float* out, uint32_t capacity) const;
+    /** Inverse of getAllParameters(). Returns false if 'data' is malformed or the chain size
+     *  differs; well-formed blocks before the error are still applied. */
+    bool setAllParameters(const float* data, uint32_t size);
+
     void setPluginFilePath(int pluginIndex, const std::string& propertyUri, const std::string& path);
 
     /** Inject an atom message into a plugin (thread-safe, holds shared_lock). */
@@ -58,21 +145,309 @@ public:
     struct ChainState { std::vector<PluginState> plugins; };
     ChainState saveChainState();
 
-    /** Restore state for a single plugin by index. Takes exclusive lock. */
+    /** Restore state for a single plugin by index. Takes exclusive lock; the plugin is
+     *  unpublished from the audio snapshot while restoring, the rest of the chain keeps running. */
     bool restorePluginState(int index, const PluginState& state);
 
-    /** Expose chain mutex so UI code can take a shared_lock during port reads. */
+    /**
+     * Batch topology edits (e.g. preset load). Between begin and commit the audio thread keeps
+     * running the last published chain; add/remove/reorder/restore only edit the control-side view
+     * and removed plugins stay alive. commitBatch() crossfades from the old chain to the new one.
+     */
+    void beginBatch();
+    void commitBatch();
+
+    /** Creates the plugins applyChainState() cannot reuse, keyed by plugin URI. */
+    using PluginCreator = std::function<std::unique_ptr<IPlugin>(const std::string& pluginUri)>;
+
+    /**
+     * Switch to 'target' by diffing it against the live chain (see planChainState): instances
+     * whose URI and state properties match are kept and only receive the control values that
+     * differ; the others are created, activated and restored off the audio path. The new
+     * topology is then published in one swap (or left for commitBatch() inside a batch).
+     * Returns false, leaving the chain untouched, if a plugin can't be created or the chain was
+     * edited concurrently.
+     */
+    bool applyChainState(const ChainState& target, const PluginCreator& create);
+
+    /**
+     * Replace the whole chain with ready instances in one swap (crossfading from the old chain).
+     * The plugins must already be activated at this chain's settings and restored, e.g. by
+     * PresetPreloader; nothing but pointer moves happens under the lock.
+     */
+    void replaceChain(std::vector<std::unique_ptr<IPlugin>> plugins);
+
+    /**
+     * Graph mode: consecutive plugins with the same non-zero group form one parallel block.
+     * Within a block, plugins sharing a branch id run serially; branches run concurrently on
+     * the worker pool and are summed by a mixer node. Group 0 (default) is the serial chain.
+     */
+    bool setPluginRouting(int pluginIndex, int group, int branch);
+    /** Mixer gain for one branch of a parallel group (default 1/number of branches). */
+    void setBranchGain(int group, int branch, float gain);
+
+    /**
+     * Pipelined mode for long serial chains: split the chain into 'stages' (2..kMaxWorkers+1)
+     * segments that run concurrently on different cores, each on a different block. Adds
+     * (stages - 1) callback periods of latency. 0 or 1 disables. Split points are chosen from
+     * the measured per-plugin cost; call rebalancePipeline() to re-split after costs settle.
+     */
+    void setPipelineStages(int stages);
+    int getPipelineStages() const { return pipelineStages_; }
+    void rebalancePipeline();
+    /** Extra output latency introduced by pipelining, in frames. */
+    uint32_t getAddedLatencyFrames() const { return addedLatencyFrames_.load(); }
+
+    /** Per-slot timing costs two clock reads per plugin per block, so it is off unless
+     *  requested here (pipelined mode enables it implicitly to find split points). */
+    void setProfilingEnabled(bool enabled);
+
+    /**
+     * Copy every published plugin's output control values (IPlugin::readOutputControls) into
+     * 'values', concatenated in chain order, with per-plugin counts in 'counts'. Returns the
+     * number of plugins described. Audio thread only, between process() calls.
+     */
+    uint32_t readOutputControls(uint32_t* counts, uint32_t maxPlugins, float* values,
+                                uint32_t maxValues);
+
+    /** Per-plugin DSP time over the last SlotStats::kWindow blocks, in chain order. */
+    struct SlotTiming {
+        float lastUs = 0.0f;
+        float avgUs = 0.0f;
+        float p99Us = 0.0f;
+        /** Blocks with silent input that took several times the signal average: the
+         *  signature of denormal tails. Counts up while profiling; should stay 0. */
+        uint32_t silentSpikes = 0;
+        /** Input silent past the plugin's tail: process() is skipped and the slot emits zeros. */
+        bool asleep = false;
+    };
+    std::vector<SlotTiming> getSlotTimings() const;
+
+    /** Length of the ramp used for glitch-free topology changes (0 = switch instantly). */
+    void setCrossfadeFrames(uint32_t frames) { crossfadeFrames_.store(frames); }
+    uint32_t getCrossfadeFrames() const { return crossfadeFrames_.load(); }
+
+    /** Expose chain mutex so UI code can take a shared_lock during port reads.
+     *  Only control threads contend on it; process() reads the published snapshot. */
     std::shared_mutex* getChainMutex() { return &chainMutex_; }
 
+    /** Kernel thread ids of the parallel chain workers (empty until a parallel layout needs them). */
+    std::vector<int32_t> getWorkerThreadIds() const;
+
 private:
+    static constexpr uint32_t kDefaultCrossfadeFrames = 512;
+    static constexpr int kMaxWorkers = 3;
+
+    struct Routing {
+        int group = 0;
+        int branch = 0;
+    };
+
+    /** Per-plugin measurements; written by whichever RT thread runs the plugin (one block at
+     *  a time), read lock-free by control threads. */
+    struct SlotStats {
+        static constexpr uint32_t kWindow = 256;
+        std::atomic<uint32_t> lastNs{0};
+        std::atomic<uint32_t> avgNs{0};  // EWMA, 1/16 weight
+        std::atomic<uint32_t> count{0};  // total samples written
+        std::atomic<uint32_t> signalAvgNs{0};   // EWMA over blocks with input above silence
+        std::atomic<uint32_t> silentSpikes{0};  // silent blocks far above signalAvgNs
+
+        // Silence sleeping: the counters belong to the thread running the slot; control threads
+        // set 'wake' on parameter and atom input so the next block runs the plugin.
+        uint32_t silentInFrames = 0;   // consecutive frames of silent input
+        uint32_t quietOutFrames = 0;   // of those, consecutive frames of silent output
+        std::atomic<bool> asleep{false};
+        std::atomic<bool> wake{false};
+
+        // Host bypass: control threads set 'bypassed'; the thread running the slot moves
+        // 'bypassGain' (wet share) towards it and stops calling process() at 0.
+        std::atomic<bool> bypassed{false};
+        float bypassGain = 1.0f;
+        std::atomic<uint32_t> window[kWindow] = {};
+
+        char traceName[48] = {};  // system trace section name: the plugin's name
+    };
+
+    struct ScratchPool;
+
+    /** Immutable chain topology read by the audio thread (RCU-style).
+     *  Built and published by writers; reclaimed after a grace period.
+     *  Only the fade progress fields are written, and only by the audio thread. */
+    struct Snapshot {
+        enum class Fade { None, In, Out };
+        struct Slot {
+            IPlugin* plugin;
+            Fade fade;  // In: ramp dry->wet (inserted), Out: wet->dry (about to leave)
+            SlotStats* stats;
+            bool inPlace;  // plugin->canProcessInPlace(), cached at publish time
+            bool strictFloat;  // plugin->needsStrictFloat(): flush-to-zero off around process()
+            uint32_t tailFrames;  // plugin->getTailFrames()
+            const char* guardName;  // RT guard owner (rt_guard::intern), null in release builds
+        };
+        struct Branch {
+            std::vector<Slot> slots;
+            float gain = 1.0f;
+        };
+        struct Stage {
+            std::vector<Branch> branches;  // one branch = serial section
+        };
+        std::vector<Stage> stages;
+        size_t maxBranches = 0;
+        std::vector<IPlugin*> plugins;  // published order, for per-plugin telemetry
+
+        // Pipelined mode: contiguous stage ranges, segment j processes the block j periods old.
+        struct Segment {
+            size_t begin;
+            size_t end;
+        };
+        std::vector<Segment> segments;
+
+        // When set, this chain shares no instances with the incoming one: both run and the
+        // output crossfades from 'outgoing' to 'stages'. Owned by this snapshot.
+        std::unique_ptr<Snapshot> outgoing;
+
+        // Buffers this snapshot (and its outgoing chain) runs on, sized before publishing.
+        std::shared_ptr<ScratchPool> scratch;
+
+        uint32_t fadeFrames = 0;
+        uint32_t fadePos = 0;
+        std::atomic<bool> fadeDone{true};
+    };
+
+    // Control-side view of the chain; owns the plugins. Guarded by chainMutex_.
     std::vector<std::unique_ptr<IPlugin>> plugins_;
     mutable std::shared_mutex chainMutex_;
 
+    std::atomic<Snapshot*> snapshot_{nullptr};
+    // Analysis tap: which plugin's output feeds which ring (compared, never dereferenced)
+    std::atomic<const IPlugin*> tapPlugin_{nullptr};
+    std::atomic<RingBuffer*> tapRing_{nullptr};
+    std::atomic<int> activeReaders_{0};  // process() calls currently holding a snapshot
+    std::atomic<uint64_t> processCount_{0};
+    std::atomic<uint32_t> crossfadeFrames_{kDefaultCrossfadeFrames};
+
+    // Plugin list last handed to the audio thread; differs from plugins_ only inside a batch.
+    std::vector<IPlugin*> published_;
+    bool inBatch_ = false;
+    // Removed during a batch but still referenced by the live snapshot.
+    std::vector<std::unique_ptr<IPlugin>> retired_;
+    // Graph routing per plugin (absent = serial) and mixer gains keyed by (group, branch).
+    std::unordered_map<const IPlugin*, Routing> routing_;
+    std::unordered_map<uint64_t, float> branchGains_;
+    std::unordered_map<const IPlugin*, std::unique_ptr<SlotStats>> stats_;
+    int pipelineStages_ = 0;
+    bool profilingRequested_ = false;
+    std::atomic<bool> profiling_{false};
+    std::atomic<uint32_t> addedLatencyFrames_{0};
+    // Decay probe for plugins without a declared tail: silent output this long before sleeping
+    std::atomic<uint32_t> sleepHoldFrames_{0};
+    std::atomic<uint32_t> bypassRampFrames_{0};
+    bool fastSleep_ = false;  // guarded by chainMutex_
+    std::atomic<bool> memoryLocking_{false};
+
+    // Quality controls load shedding turned down, with the values to put back
+    struct ShedControl {
+        IPlugin* plugin;
+        uint32_t portIndex;
+        float original;
+        float cheapest;
+    };
+    std::mutex shedMutex_;  // after chainMutex_
+    std::vector<ShedControl> shedControls_;
+    bool qualityShed_ = false;
+
+    std::unique_ptr<RtWorkerPool> workers_;  // created on first parallel snapshot
+
+    /** Publish 'plugins' to the audio thread, wait for the grace period, then for any ramps to
+     *  finish. Caller must hold chainMutex_ exclusively. */
+    void publishSnapshot(const std::vector<IPlugin*>& plugins,
+                         const std::vector<IPlugin*>& fadeIn = {},
+                         const std::vector<IPlugin*>& fadeOut = {},
+                         bool crossfade = false);
+    /** Block until no process() call can still observe a previously published snapshot. */
+    void waitForReaders() const;
+    /** Block until the snapshot's ramp completed, or the audio thread stopped calling process(). */
+    void waitForFade(const Snapshot* snapshot) const;
+    std::vector<IPlugin*> controlView() const;
+    /** Publish the control view after batched edits and release retired_. Caller must hold
+     *  chainMutex_ exclusively. */
+    void publishBatch();
+    /** Pick pipeline split points minimizing the most expensive segment. */
+    std::vector<Snapshot::Segment> splitPipeline(const std::vector<Snapshot::Stage>& stages,
+                                                 size_t count) const;
+    void forgetPlugin(const IPlugin* plugin);
+    /** After a control write: wake a sleeping plugin and follow its lv2:enabled port into the
+     *  host bypass. Caller holds chainMutex_ (either mode). */
+    void controlsChanged(const IPlugin* plugin) const;
+    /** The published slot stats of 'plugin', null if it is not in 'snapshot' (audio thread). */
+    static SlotStats* findSlotStats(const Snapshot& snapshot, const IPlugin* plugin);
+    /** Fresh per-plugin state; starts bypassed if the plugin's enabled port is off. */
+    static std::unique_ptr<SlotStats> makeSlotStats(const IPlugin& plugin);
+    /** Write one plugin's parameter block at 'out' if it fits; returns its size. Caller holds
+     *  chainMutex_. */
+    static uint32_t writeParameterBlock(const IPlugin& plugin, float* out, uint32_t capacity);
+
+    /** Per-branch scratch, so branches can run concurrently. */
+    struct BranchScratch {
+        // Ping-pong between consecutive slots, [parity][channel]. Plugins connect their ports
+        // straight to these, so a slot's buffers only move when the topology does. In-place
+        // capable slots reuse their input pair; the others flip, which keeps their input
+        // intact after they ran (the dry signal for ramps).
+        std::vector<float> intermediate[2][2];
+        std::vector<float> out[2];   // branch output for the mixer node
+    };
+    /** Everything one runGraph() call touches; one set per concurrently running pipeline segment. */
+    struct ScratchSet {
+        std::vector<BranchScratch> branches;
+        std::vector<float> stage[2][2];  // ping-pong between stages
+    };
+
+    /** Run 'slots' serially; slot ramps are evaluated at fadePos of fadeFrames.
+     *  'outputs' must not alias 'inputs'; neither is written in place. */
+    void runChain(const std::vector<Snapshot::Slot>& slots, const float* const* inputs,
+                  float* const* outputs, uint32_t numFrames, uint32_t fadePos, uint32_t fadeFrames,
+                  BranchScratch& scratch);
+    /** Run stages [first, last) of a snapshot. With fanOut, parallel branches go to the worker pool. */
+    void runGraph(const Snapshot& snapshot, size_t first, size_t last, const float* const* inputs,
+                  float* const* outputs, uint32_t numFrames, uint32_t fadePos, uint32_t fadeFrames,
+                  ScratchSet& scratch, bool fanOut);
+    /** Run every segment once, each on its own block, passing blocks through handoff buffers. */
+    void runPipeline(const Snapshot& snapshot, const float* const* inputs, float* const* outputs,
+                     uint32_t numFrames, uint32_t fadePos, uint32_t fadeFrames);
+    static void runBranchJob(void* context, uint32_t index);
+    static void runSegmentJob(void* context, uint32_t index);
+
     float sampleRate_ = 0.0f;
     uint32_t bufferSize_ = 0;
 
-    std::vector<std::vector<float>> intermediateBuffers_;
-    void ensureBuffers(uint32_t numFrames, uint32_t numChannels);
+    /** Scratch storage for one topology at one block size. Built on the control thread and
+     *  never resized once published: a snapshot that needs more gets a new pool. */
+    struct ScratchPool {
+        uint32_t frames = 0;
+        std::vector<ScratchSet> sets;     // [0] for serial runs, [j] for segment j
+        std::vector<float> crossfade[2];  // outgoing chain output
+
+        // Pipeline handoff: handoff[j][parity] carries segment j's output to segment j+1 one
+        // block later; a two-slot SPSC queue per boundary, swapped once per callback.
+        std::vector<float> handoff[kMaxWorkers][2][2];  // [boundary][parity][channel]
+        bool locked = false;  // pages pinned by setMemoryLocking()
+
+        /** Call fn(std::vector<float>&) on every scratch, handoff and crossfade buffer. */
+        template <typename Fn>
+        void forEachBuffer(Fn&& fn);
+    };
+    std::shared_ptr<ScratchPool> scratchPool_;  // newest pool; guarded by chainMutex_
+    // Audio thread: pipeline block size and which handoff slot is being written
+    uint32_t pipelineFrames_ = 0;
+    uint32_t pipelineParity_ = 0;
+
+    /** A pool holding 'frames' per buffer for 'branches' per set and 'sets' sets: the current
+     *  one if it is large enough, otherwise a new one. Caller holds chainMutex_ exclusively. */
+    std::shared_ptr<ScratchPool> scratchFor(uint32_t frames, size_t branches, size_t sets);
+    /** Run one block of at most snapshot.scratch->frames (audio thread). */
+    void processBlock(Snapshot& snapshot, const float* const* inputs, float* const* outputs,
+                      uint32_t numFrames);
 };
 
 } // namespace guitarrackcraft
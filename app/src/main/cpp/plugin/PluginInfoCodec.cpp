@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PluginInfoCodec.h"
+#include <cstring>
+
+namespace guitarrackcraft {
+
+namespace {
+
+void writePort(ByteWriter& w, const PortInfo& port) {
+    w.u32(port.index);
+    w.str(port.name);
+    w.str(port.symbol);
+    w.u8(static_cast<uint8_t>((port.isInput ? 1 : 0) | (port.isAudio ? 2 : 0) | (port.isControl ? 4 : 0) |
+                              (port.isToggle ? 8 : 0)));
+    w.f32(port.defaultValue);
+    w.f32(port.minValue);
+    w.f32(port.maxValue);
+    w.u32(static_cast<uint32_t>(port.scalePoints.size()));
+    for (const auto& sp : port.scalePoints) {
+        w.str(sp.label);
+        w.f32(sp.value);
+    }
+}
+
+PortInfo readPort(ByteReader& r) {
+    PortInfo port;
+    port.index = r.u32();
+    port.name = r.str();
+    port.symbol = r.str();
+    const uint8_t flags = r.u8();
+    port.isInput = flags & 1;
+    port.isAudio = flags & 2;
+    port.isControl = flags & 4;
+    port.isToggle = flags & 8;
+    port.defaultValue = r.f32();
+    port.minValue = r.f32();
+    port.maxValue = r.f32();
+    const uint32_t points = r.count(8);
+    port.scalePoints.resize(points);
+    for (auto& sp : port.scalePoints) {
+        sp.label = r.str();
+        sp.value = r.f32();
+    }
+    return port;
+}
+
+} // namespace
+
+void writePluginInfo(ByteWriter& w, const PluginInfo& info) {
+    w.str(info.id);
+    w.str(info.name);
+    w.str(info.format);
+    w.str(info.modguiBasePath);
+    w.str(info.modguiIconTemplate);
+    w.u8(info.hasX11Ui ? 1 : 0);
+    w.str(info.x11UiBinaryPath);
+    w.str(info.x11UiUri);
+    w.u32(static_cast<uint32_t>(info.ports.size()));
+    for (const auto& port : info.ports) writePort(w, port);
+}
+
+PluginInfo readPluginInfo(ByteReader& r) {
+    PluginInfo info;
+    info.id = r.str();
+    info.name = r.str();
+    info.format = r.str();
+    info.modguiBasePath = r.str();
+    info.modguiIconTemplate = r.str();
+    info.hasX11Ui = r.u8() != 0;
+    info.x11UiBinaryPath = r.str();
+    info.x11UiUri = r.str();
+    const uint32_t ports = r.count(kMinPortRecordBytes);
+    info.ports.reserve(ports);
+    for (uint32_t i = 0; i < ports && r.ok; ++i) info.ports.push_back(readPort(r));
+    return info;
+}
+
+std::vector<uint8_t> encodePluginCatalog(const std::vector<PluginInfo>& plugins, uint64_t catalogVersion) {
+    ByteWriter w;
+    w.bytes(kCatalogMagic, sizeof(kCatalogMagic));
+    w.u32(kCatalogLayoutVersion);
+    w.u64(catalogVersion);
+    w.u32(static_cast<uint32_t>(plugins.size()));
+    for (const auto& p : plugins) writePluginInfo(w, p);
+    return std::move(w.out);
+}
+
+bool decodePluginCatalog(const uint8_t* data, size_t size, std::vector<PluginInfo>& plugins,
+                         uint64_t* catalogVersion) {
+    plugins.clear();
+    ByteReader r(data, size);
+    char magic[sizeof(kCatalogMagic)];
+    bool ok = r.take(magic, sizeof(magic)) && std::memcmp(magic, kCatalogMagic, sizeof(magic)) == 0;
+    ok = ok && r.u32() == kCatalogLayoutVersion;
+    const uint64_t version = ok ? r.u64() : 0;
+    if (ok) {
+        const uint32_t count = r.count(kMinPluginRecordBytes);
+        plugins.reserve(count);
+        for (uint32_t i = 0; i < count && r.ok; ++i) plugins.push_back(readPluginInfo(r));
+        ok = r.ok && r.remaining() == 0;
+    }
+    if (!ok) {
+        plugins.clear();
+        return false;
+    }
+    if (catalogVersion) *catalogVersion = version;
+    return true;
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUITARRACKCRAFT_PLUGIN_INFO_CODEC_H
+#define GUITARRACKCRAFT_PLUGIN_INFO_CODEC_H
+
+#include "IPlugin.h"
+#include "../utils/ByteCodec.h"
+#include <cstdint>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Binary record layout for PluginInfo, shared by the persistent bundle cache
+ * (PluginCatalogCache) and the catalog snapshot handed to Kotlin as a direct ByteBuffer.
+ *
+ * Plugin record: id, name, format, modguiBasePath, modguiIconTemplate (str), hasX11Ui (u8),
+ * x11UiBinaryPath, x11UiUri (str), port count (u32), ports.
+ * Port record: index (u32), name, symbol (str), flags (u8: 1 input, 2 audio, 4 control,
+ * 8 toggle), default, min, max (f32), scale point count (u32), then label (str) and
+ * value (f32) per point. Strings are a u32 byte length plus UTF-8 bytes; all integers
+ * and floats are little-endian. Keep PluginCatalog.kt's decoder in step with any change.
+ */
+void writePluginInfo(ByteWriter& w, const PluginInfo& info);
+PluginInfo readPluginInfo(ByteReader& r);
+
+/** Smallest encoded plugin / port record, for ByteReader::count(). */
+constexpr size_t kMinPluginRecordBytes = 33;
+constexpr size_t kMinPortRecordBytes = 29;
+
+/** Catalog snapshot header: magic "GRCCATLG", layout version (u32), catalog version (u64), plugin count (u32). */
+constexpr char kCatalogMagic[8] = {'G', 'R', 'C', 'C', 'A', 'T', 'L', 'G'};
+constexpr uint32_t kCatalogLayoutVersion = 1;
+constexpr size_t kCatalogHeaderBytes = sizeof(kCatalogMagic) + 4 + 8 + 4;
+
+/** Serialize plugins into one catalog snapshot stamped with catalogVersion. */
+std::vector<uint8_t> encodePluginCatalog(const std::vector<PluginInfo>& plugins, uint64_t catalogVersion);
+
+/**
+ * Parse a catalog snapshot.
+ * @return false (plugins left empty) on a bad magic, an unknown layout or a truncated record
+ */
+bool decodePluginCatalog(const uint8_t* data, size_t size, std::vector<PluginInfo>& plugins,
+                         uint64_t* catalogVersion = nullptr);
+
+} // namespace guitarrackcraft
+
+#endif // GUITARRACKCRAFT_PLUGIN_INFO_CODEC_H
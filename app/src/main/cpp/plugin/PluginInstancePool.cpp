@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PluginInstancePool.h"
+#include "../utils/ThreadPolicy.h"
+#include <algorithm>
+
+namespace guitarrackcraft {
+
+PluginInstancePool::PluginInstancePool(Creator creator)
+    : creator_(std::move(creator))
+{
+}
+
+PluginInstancePool::~PluginInstancePool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    workCv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void PluginInstancePool::setWarmSet(const std::vector<std::string>& pluginIds) {
+    std::vector<std::unique_ptr<IPlugin>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        warm_.clear();
+        for (const auto& id : pluginIds) {
+            if (std::find(warm_.begin(), warm_.end(), id) == warm_.end()) {
+                warm_.push_back(id);
+            }
+        }
+        for (auto it = spares_.begin(); it != spares_.end();) {
+            if (std::find(warm_.begin(), warm_.end(), it->first) == warm_.end()) {
+                dropped.push_back(std::move(it->second.plugin));
+                it = spares_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        failed_.clear();
+        if (!thread_.joinable() && !warm_.empty()) {
+            thread_ = std::thread(&PluginInstancePool::run, this);
+        }
+    }
+    workCv_.notify_all();
+    // dropped spares are destroyed here, outside the lock
+}
+
+void PluginInstancePool::setActivation(float sampleRate, uint32_t bufferSize) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sampleRate_ == sampleRate && bufferSize_ == bufferSize) {
+            return;
+        }
+        sampleRate_ = sampleRate;
+        bufferSize_ = bufferSize;
+    }
+    workCv_.notify_all();
+}
+
+std::unique_ptr<IPlugin> PluginInstancePool::take(const std::string& pluginId) {
+    std::unique_ptr<IPlugin> plugin;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = spares_.find(pluginId);
+        if (it == spares_.end()) {
+            return nullptr;
+        }
+        plugin = std::move(it->second.plugin);
+        spares_.erase(it);
+    }
+    workCv_.notify_all();
+    return plugin;
+}
+
+size_t PluginInstancePool::spareCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return spares_.size();
+}
+
+void PluginInstancePool::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idleCv_.wait(lock, [this] { return stop_ || (!busy_ && nextWork().empty()); });
+}
+
+std::string PluginInstancePool::nextWork() const {
+    for (const auto& id : warm_) {
+        if (failed_.count(id)) continue;
+        auto it = spares_.find(id);
+        if (it == spares_.end() || it->second.sampleRate != sampleRate_ || it->second.bufferSize != bufferSize_) {
+            return id;
+        }
+    }
+    return {};
+}
+
+void PluginInstancePool::run() {
+    applyThreadRole(ThreadRole::Background);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        std::string id;
+        workCv_.wait(lock, [&] { return stop_ || !(id = nextWork()).empty(); });
+        if (stop_) {
+            break;
+        }
+        const float sampleRate = sampleRate_;
+        const uint32_t bufferSize = bufferSize_;
+        busy_ = true;
+        lock.unlock();
+
+        std::unique_ptr<IPlugin> plugin = creator_(id);
+        if (plugin && sampleRate > 0.0f) {
+            plugin->activate(sampleRate, bufferSize);
+        }
+
+        lock.lock();
+        busy_ = false;
+        std::unique_ptr<IPlugin> replaced;
+        if (!plugin) {
+            failed_.insert(id);
+        } else if (std::find(warm_.begin(), warm_.end(), id) != warm_.end()) {
+            Spare& spare = spares_[id];
+            replaced = std::move(spare.plugin);
+            spare = {std::move(plugin), sampleRate, bufferSize};
+        }
+        idleCv_.notify_all();
+        // Instances no longer wanted are destroyed outside the lock
+        if (replaced || plugin) {
+            lock.unlock();
+            replaced.reset();
+            plugin.reset();
+            lock.lock();
+        }
+    }
+    idleCv_.notify_all();
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUITARRACKCRAFT_PLUGIN_INSTANCE_POOL_H
+#define GUITARRACKCRAFT_PLUGIN_INSTANCE_POOL_H
+
+#include "IPlugin.h"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Spare, already-instantiated plugins for instant rack insertion.
+ *
+ * Keeps at most one spare per plugin id in the warm set (the user's favorites and recent
+ * plugins). Spares are created on a background thread and, once the engine's sample rate is
+ * known, activated at it, so taking one skips instantiation, dlopen and activation. take()
+ * hands out the spare and the pool refills it asynchronously.
+ */
+class PluginInstancePool {
+public:
+    using Creator = std::function<std::unique_ptr<IPlugin>(const std::string& pluginId)>;
+
+    explicit PluginInstancePool(Creator creator);
+    /** Stops the pool thread and destroys the spares. */
+    ~PluginInstancePool();
+
+    PluginInstancePool(const PluginInstancePool&) = delete;
+    PluginInstancePool& operator=(const PluginInstancePool&) = delete;
+
+    /** Keep one spare for each id; spares for other ids are dropped. */
+    void setWarmSet(const std::vector<std::string>& pluginIds);
+
+    /**
+     * Activation for new spares; sampleRate 0 leaves them inactive. Spares activated at other
+     * settings stay takeable (activate() re-does them) and are replaced in the background.
+     */
+    void setActivation(float sampleRate, uint32_t bufferSize);
+
+    /** The spare for pluginId, or nullptr if none is ready. Schedules a refill. */
+    std::unique_ptr<IPlugin> take(const std::string& pluginId);
+
+    size_t spareCount() const;
+    /** Block until every warm id has an up-to-date spare or failed to create one. */
+    void waitIdle();
+
+private:
+    struct Spare {
+        std::unique_ptr<IPlugin> plugin;
+        float sampleRate = 0.0f;
+        uint32_t bufferSize = 0;
+    };
+
+    void run();
+    /** Next warm id without an up-to-date spare, or empty. Caller holds mutex_. */
+    std::string nextWork() const;
+
+    Creator creator_;
+    mutable std::mutex mutex_;
+    std::condition_variable workCv_;
+    std::condition_variable idleCv_;
+    std::vector<std::string> warm_;
+    std::unordered_map<std::string, Spare> spares_;
+    std::unordered_set<std::string> failed_;  // creation failed; retried when the warm set changes
+    float sampleRate_ = 0.0f;
+    uint32_t bufferSize_ = 0;
+    bool busy_ = false;
+    bool stop_ = false;
+    std::thread thread_;  // started with the first warm set
+};
+
+} // namespace guitarrackcraft
+
+#endif // GUITARRACKCRAFT_PLUGIN_INSTANCE_POOL_H
@@ -18,6 +18,7 @@
  */
 
 #include "PluginRegistry.h"
+#include "PluginInfoCodec.h"
 #include <algorithm>
 
 namespace guitarrackcraft {
@@ -46,6 +47,7 @@ bool PluginRegistry::initializeAll() {
         }
     }
 
+    catalogVersion_.store(catalogVersion_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
     return allSucceeded;
 }
 
@@ -80,6 +82,27 @@ std::unique_ptr<IPlugin> PluginRegistry::createPlugin(const std::string& pluginI
     return nullptr;
 }
 
+std::unique_ptr<IPlugin> PluginRegistry::acquirePlugin(const std::string& pluginId, float sampleRate,
+                                                       uint32_t bufferSize) {
+    pool_.setActivation(sampleRate, bufferSize);
+    if (auto warm = pool_.take(pluginId)) {
+        return warm;
+    }
+    return createPlugin(pluginId);
+}
+
+void PluginRegistry::setWarmPlugins(const std::vector<std::string>& pluginIds, float sampleRate,
+                                    uint32_t bufferSize) {
+    std::vector<std::string> known;
+    for (const auto& id : pluginIds) {
+        if (pluginCache_.count(id)) {
+            known.push_back(id);
+        }
+    }
+    pool_.setActivation(sampleRate, bufferSize);
+    pool_.setWarmSet(known);
+}
+
 PluginInfo PluginRegistry::getPluginInfo(const std::string& pluginId) const {
     auto it = pluginCache_.find(pluginId);
     if (it != pluginCache_.end()) {
@@ -88,4 +111,26 @@ PluginInfo PluginRegistry::getPluginInfo(const std::string& pluginId) const {
     return PluginInfo{}; // Return empty info if not found
 }
 
+const std::vector<uint8_t>& PluginRegistry::catalogSnapshot() {
+    std::lock_guard<std::mutex> lock(catalogMutex_);
+    const uint64_t version = catalogVersion();
+    if (catalogSnapshots_.empty() || snapshotVersion_ != version) {
+        std::vector<const std::pair<const std::string, PluginInfo>*> sorted;
+        sorted.reserve(pluginCache_.size());
+        for (const auto& pair : pluginCache_) {
+            sorted.push_back(&pair);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+        std::vector<PluginInfo> plugins;
+        plugins.reserve(sorted.size());
+        for (const auto* pair : sorted) {
+            plugins.push_back(pair->second);
+        }
+        catalogSnapshots_.push_back(
+            std::make_unique<const std::vector<uint8_t>>(encodePluginCatalog(plugins, version)));
+        snapshotVersion_ = version;
+    }
+    return *catalogSnapshots_.back();
+}
+
 } // namespace guitarrackcraft
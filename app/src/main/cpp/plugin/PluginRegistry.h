@@ -20,11 +20,14 @@
 #ifndef GUITARRACKCRAFT_PLUGIN_REGISTRY_H
 #define GUITARRACKCRAFT_PLUGIN_REGISTRY_H
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 #include "IPluginFactory.h"
 #include "IPlugin.h"
+#include "PluginInstancePool.h"
 
 namespace guitarrackcraft {
 
@@ -59,14 +62,42 @@ public:
      */
     std::unique_ptr<IPlugin> createPlugin(const std::string& pluginId) const;
 
+    /**
+     * Like createPlugin(), but hands out a pre-warmed spare when one is ready (see
+     * setWarmPlugins()). sampleRate/bufferSize are the chain's current settings; later
+     * spares are activated at them ahead of time.
+     */
+    std::unique_ptr<IPlugin> acquirePlugin(const std::string& pluginId, float sampleRate, uint32_t bufferSize);
+
+    /** Keep one spare instance of each of these plugins (favorites, recents) warm in the background. */
+    void setWarmPlugins(const std::vector<std::string>& pluginIds, float sampleRate, uint32_t bufferSize);
+
     /**
      * Get plugin info by ID.
      */
     PluginInfo getPluginInfo(const std::string& pluginId) const;
 
+    /** Stamp that changes whenever the set of plugins does (each initializeAll()); starts at 0. */
+    uint64_t catalogVersion() const { return catalogVersion_.load(std::memory_order_acquire); }
+
+    /**
+     * All plugins encoded as one catalog snapshot (see PluginInfoCodec.h), sorted by full ID
+     * and stamped with catalogVersion(). Built on the first call after a change and reused
+     * until the next one. Snapshots are never freed before the registry, so the bytes can
+     * back a direct ByteBuffer that Kotlin holds on to.
+     */
+    const std::vector<uint8_t>& catalogSnapshot();
+
 private:
     std::vector<std::unique_ptr<IPluginFactory>> factories_;
     std::unordered_map<std::string, PluginInfo> pluginCache_;
+    std::atomic<uint64_t> catalogVersion_{0};
+    std::mutex catalogMutex_;
+    // Every snapshot handed out so far, newest last; see catalogSnapshot()
+    std::vector<std::unique_ptr<const std::vector<uint8_t>>> catalogSnapshots_;
+    uint64_t snapshotVersion_ = 0;
+    // Declared last: spares are destroyed before the factories that created them
+    PluginInstancePool pool_{[this](const std::string& id) { return createPlugin(id); }};
 };
 
 } // namespace guitarrackcraft
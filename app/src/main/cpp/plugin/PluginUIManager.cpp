@@ -129,6 +129,7 @@ bool PluginUIManager::createPluginUI(int pluginIndex, int displayNumber,
     uiEntries_[pluginIndex].displayNumber = displayNumber;
     uiEntries_[pluginIndex].pluginIndex = indexPtr;
     uiEntries_[pluginIndex].detached = detachedPtr;
+    uiEntries_[pluginIndex].budget.reset();
     LOGI("createPluginUI: done (UI stored at index %d)", pluginIndex);
 
     LOGI("createPluginUI: requesting initial frame for display=%d", displayNumber);
@@ -137,20 +138,10 @@ bool PluginUIManager::createPluginUI(int pluginIndex, int displayNumber,
         display->setIdleCallback([this, indexPtr, detachedPtr]() {
             if (paused_.load(std::memory_order_acquire)) return;  // paused during reorder
             if (detachedPtr->load(std::memory_order_acquire)) return;  // plugin detached
-            auto start = std::chrono::steady_clock::now();
             std::lock_guard uiLock(uiMutex_);
             int idx = indexPtr->load(std::memory_order_acquire);
             if (idx >= 0 && idx < static_cast<int>(uiEntries_.size())) {
-                auto& entry = uiEntries_[idx];
-                if (entry.ui && entry.ui->isValid()) {
-                    entry.ui->idle();
-                    entry.ui->syncOutputPorts(chain_ ? chain_->getChainMutex() : nullptr);
-                }
-            }
-            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
-                std::chrono::steady_clock::now() - start).count();
-            if (elapsed > 1000) {
-                LOGI("PluginUIManager::idle callback took %lld us", (long long)elapsed);
+                idleUILocked(uiEntries_[idx]);
             }
         });
         LOGI("createPluginUI: idle callback set on display=%d", displayNumber);
@@ -218,7 +209,38 @@ void PluginUIManager::destroyPluginUI(int pluginIndex) {
     }
 }
 
+void PluginUIManager::idleUILocked(UIEntry& entry) {
+    if (!entry.ui || !entry.ui->isValid()) return;
+    const auto start = std::chrono::steady_clock::now();
+    const int64_t startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        start.time_since_epoch()).count();
+    if (!entry.budget.due(startNs)) return;
+
+    entry.ui->idle();
+    entry.ui->syncOutputPorts(chain_ ? chain_->getChainMutex() : nullptr);
+
+    const int64_t costNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    int openUIs = 0;
+    for (const auto& e : uiEntries_) {
+        if (e.ui) ++openUIs;
+    }
+    const int64_t prevIntervalMs = entry.budget.intervalNs() / 1000000;
+    entry.budget.ran(startNs, costNs, openUIs);
+    if (costNs > 1000000) {
+        LOGI("PluginUIManager::idle took %lld us", (long long)(costNs / 1000));
+    }
+    if (entry.budget.intervalNs() / 1000000 != prevIntervalMs) {
+        LOGI("PluginUIManager::idle interval %lld ms (%d UIs open)",
+             (long long)(entry.budget.intervalNs() / 1000000), openUIs);
+    }
+}
+
 bool PluginUIManager::idleAllUIs() {
+    std::lock_guard lock(uiMutex_);
+    for (const auto& entry : uiEntries_) {
+        if (entry.ui && entry.ui->isValid()) return true;
+    }
     return false;
 }
 
@@ -338,6 +360,33 @@ bool PluginUIManager::hasUIForPlugin(int pluginIndex) const {
     return false;
 }
 
+bool PluginUIManager::hasUIForDisplay(int displayNumber) const {
+    if (displayNumber < 0) return false;
+    std::lock_guard uiLock(uiMutex_);
+    for (const auto& entry : uiEntries_) {
+        if (entry.displayNumber == displayNumber && entry.ui && entry.ui->isValid()) {
+            return !(entry.detached && entry.detached->load(std::memory_order_acquire));
+        }
+    }
+    return false;
+}
+
+void PluginUIManager::destroyPluginUIForDisplay(int displayNumber) {
+    int pluginIndex = -1;
+    {
+        std::lock_guard uiLock(uiMutex_);
+        for (int i = 0; i < static_cast<int>(uiEntries_.size()); ++i) {
+            if (uiEntries_[i].displayNumber == displayNumber && uiEntries_[i].ui) {
+                pluginIndex = i;
+                break;
+            }
+        }
+    }
+    if (pluginIndex >= 0) {
+        destroyPluginUI(pluginIndex);
+    }
+}
+
 bool PluginUIManager::pollFileRequest(FileRequest& out) {
     std::lock_guard uiLock(uiMutex_);
     for (int i = 0; i < static_cast<int>(uiEntries_.size()); ++i) {
@@ -24,6 +24,7 @@
 #include <atomic>
 #include <string>
 #include <vector>
+#include "UIUpdateScheduler.h"
 #include "lv2/LV2PluginUI.h"
 
 namespace guitarrackcraft {
@@ -44,6 +45,8 @@ public:
 
     void destroyPluginUI(int pluginIndex);
 
+    /** UIs are idled on their display's pluginUI thread, each at the rate its UIIdleBudget
+     *  allows; this only reports whether any UI is open and being idled. */
     bool idleAllUIs();
 
     /** Pause all UI idle callbacks (e.g. before reorder). */
@@ -62,6 +65,13 @@ public:
     /** Get UI entry for a plugin (for checking if UI exists). */
     bool hasUIForPlugin(int pluginIndex) const;
 
+    /** True if a live (instantiated, still attached to its plugin) UI runs on this display. */
+    bool hasUIForDisplay(int displayNumber) const;
+
+    /** Destroy the UI running on this display, wherever its plugin has moved in the chain.
+     *  Used to evict warm UIs, which are tracked by display rather than by chain index. */
+    void destroyPluginUIForDisplay(int displayNumber);
+
     /** Result of polling for a pending file request from any plugin UI. */
     struct FileRequest {
         int pluginIndex;
@@ -92,8 +102,12 @@ private:
         int displayNumber = -1;
         std::shared_ptr<std::atomic<int>> pluginIndex; // mutable index read by closures
         std::shared_ptr<std::atomic<bool>> detached;   // set true after detachPlugin()
+        UIIdleBudget budget;                           // pluginUI thread, under uiMutex_
     };
 
+    /** Idle one UI if its budget says it is due. Caller holds uiMutex_. */
+    void idleUILocked(UIEntry& entry);
+
     PluginChain* chain_ = nullptr;
     std::vector<UIEntry> uiEntries_;
     mutable std::mutex uiMutex_;
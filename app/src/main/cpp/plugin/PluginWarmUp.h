@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUITARRACKCRAFT_PLUGIN_WARM_UP_H
+#define GUITARRACKCRAFT_PLUGIN_WARM_UP_H
+
+#include "IPlugin.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/** Blocks of silence run through a newly activated plugin before it is published. */
+constexpr int kWarmUpBlocks = 2;
+constexpr uint32_t kWarmUpDefaultFrames = 256;
+
+/**
+ * Run kWarmUpBlocks of silence through an active, unpublished plugin. Plugins that allocate
+ * lazily (convolvers, NAM) do so in their first run() calls; pay for that here rather than on
+ * the audio thread.
+ */
+inline void warmUpPlugin(IPlugin& plugin, uint32_t bufferSize) {
+    const uint32_t frames = bufferSize > 0 ? bufferSize : kWarmUpDefaultFrames;
+    std::vector<float> buffers(4 * static_cast<size_t>(frames), 0.0f);
+    const float* inputs[2] = {buffers.data(), buffers.data() + frames};
+    float* outputs[2] = {buffers.data() + 2 * frames, buffers.data() + 3 * frames};
+    for (int i = 0; i < kWarmUpBlocks; ++i) {
+        std::fill(buffers.begin(), buffers.begin() + 2 * frames, 0.0f);
+        plugin.process(inputs, outputs, frames);
+    }
+}
+
+} // namespace guitarrackcraft
+
+#endif // GUITARRACKCRAFT_PLUGIN_WARM_UP_H
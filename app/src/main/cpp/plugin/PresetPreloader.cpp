@@ -0,0 +1,343 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PresetPreloader.h"
+#include "ChainStateDiff.h"
+#include "PluginWarmUp.h"
+#include "../utils/SharedFileCache.h"
+#include "../utils/ThreadPolicy.h"
+#include <algorithm>
+#include <cstring>
+#include <sys/stat.h>
+
+namespace guitarrackcraft {
+
+namespace {
+
+constexpr const char* kAtomPath = "http://lv2plug.in/ns/ext/atom#Path";
+
+/** Same plugins in the same order with identical properties and control values. */
+bool sameState(const PluginChain::ChainState& a, const PluginChain::ChainState& b) {
+    if (a.plugins.size() != b.plugins.size()) {
+        return false;
+    }
+    ChainStatePlan plan = planChainState(a.plugins, b.plugins);
+    for (size_t i = 0; i < plan.slots.size(); ++i) {
+        if (plan.slots[i].liveIndex != static_cast<int>(i) || !plan.slots[i].controlChanges.empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+PresetPreloader::PresetPreloader(Creator creator)
+    : creator_(std::move(creator))
+{
+}
+
+PresetPreloader::~PresetPreloader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    workCv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+size_t PresetPreloader::estimateBytes(const PluginChain::ChainState& state) {
+    size_t bytes = 0;
+    for (const auto& plugin : state.plugins) {
+        bytes += kInstanceOverheadBytes;
+        for (const auto& prop : plugin.properties) {
+            bytes += prop.value.size();
+        }
+    }
+    for (const std::string& path : referencedFiles(state)) {
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+            bytes += static_cast<size_t>(st.st_size);
+        }
+    }
+    return bytes;
+}
+
+std::vector<std::string> PresetPreloader::referencedFiles(const PluginChain::ChainState& state) {
+    std::vector<std::string> paths;
+    for (const auto& plugin : state.plugins) {
+        for (const auto& prop : plugin.properties) {
+            if (prop.typeUri != kAtomPath || prop.value.empty()) continue;
+            const auto* chars = reinterpret_cast<const char*>(prop.value.data());
+            paths.emplace_back(chars, strnlen(chars, prop.value.size()));
+        }
+    }
+    return paths;
+}
+
+void PresetPreloader::arm(std::vector<Preset> presets) {
+    std::vector<size_t> bytes;
+    bytes.reserve(presets.size());
+    for (const auto& preset : presets) {
+        bytes.push_back(estimateBytes(preset.state));
+    }
+
+    std::vector<std::unique_ptr<PreparedChain>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        armed_ = std::move(presets);
+        armedBytes_ = std::move(bytes);
+        // Armed chains move to the front in priority order; the rest age towards eviction
+        for (auto preset = armed_.rbegin(); preset != armed_.rend(); ++preset) {
+            auto it = findPrepared(preset->key);
+            if (it == prepared_.end()) continue;
+            if (!sameState((*it)->state, preset->state)) {
+                residentBytes_ -= (*it)->bytes;
+                dropped.push_back(std::move(*it));
+                prepared_.erase(it);
+            } else {
+                prepared_.splice(prepared_.begin(), prepared_, it);
+            }
+        }
+        skipped_.clear();
+        if (!thread_.joinable() && !armed_.empty()) {
+            thread_ = std::thread(&PresetPreloader::run, this);
+        }
+    }
+    workCv_.notify_all();
+    // dropped chains are destroyed here, outside the lock
+}
+
+void PresetPreloader::setActivation(float sampleRate, uint32_t bufferSize) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sampleRate_ == sampleRate && bufferSize_ == bufferSize) {
+            return;
+        }
+        sampleRate_ = sampleRate;
+        bufferSize_ = bufferSize;
+    }
+    workCv_.notify_all();
+}
+
+void PresetPreloader::setBudgetBytes(size_t bytes) {
+    std::vector<std::unique_ptr<PreparedChain>> evicted;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budgetBytes_ = bytes;
+        makeRoom(0, -1, evicted);
+        skipped_.clear();
+    }
+    workCv_.notify_all();
+}
+
+std::unique_ptr<PresetPreloader::PreparedChain> PresetPreloader::take(const std::string& key,
+                                                                     const PluginChain::ChainState& state) {
+    std::unique_ptr<PreparedChain> chain;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = findPrepared(key);
+        if (it == prepared_.end() || !isCurrent(**it) || !sameState((*it)->state, state)) {
+            return nullptr;
+        }
+        chain = std::move(*it);
+        prepared_.erase(it);
+        residentBytes_ -= chain->bytes;
+        for (size_t i = 0; i < armed_.size(); ++i) {
+            if (armed_[i].key == key) {
+                armed_.erase(armed_.begin() + i);
+                armedBytes_.erase(armedBytes_.begin() + i);
+                break;
+            }
+        }
+    }
+    workCv_.notify_all();
+    return chain;
+}
+
+void PresetPreloader::clear() {
+    std::list<std::unique_ptr<PreparedChain>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        armed_.clear();
+        armedBytes_.clear();
+        dropped.swap(prepared_);
+        residentBytes_ = 0;
+    }
+    idleCv_.notify_all();
+}
+
+size_t PresetPreloader::preparedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return prepared_.size();
+}
+
+size_t PresetPreloader::residentBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return residentBytes_;
+}
+
+void PresetPreloader::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idleCv_.wait(lock, [this] { return stop_ || (!busy_ && nextWork() < 0); });
+}
+
+bool PresetPreloader::isCurrent(const PreparedChain& chain) const {
+    return chain.sampleRate == sampleRate_ && chain.bufferSize == bufferSize_;
+}
+
+std::list<std::unique_ptr<PresetPreloader::PreparedChain>>::iterator PresetPreloader::findPrepared(
+    const std::string& key) {
+    return std::find_if(prepared_.begin(), prepared_.end(),
+                        [&](const std::unique_ptr<PreparedChain>& c) { return c->key == key; });
+}
+
+int PresetPreloader::nextWork() const {
+    for (size_t i = 0; i < armed_.size(); ++i) {
+        const std::string& key = armed_[i].key;
+        if (skipped_.count(key)) continue;
+        auto it = std::find_if(prepared_.begin(), prepared_.end(),
+                               [&](const std::unique_ptr<PreparedChain>& c) { return c->key == key; });
+        if (it == prepared_.end() || !isCurrent(**it)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool PresetPreloader::makeRoom(size_t bytes, int armedIndex,
+                               std::vector<std::unique_ptr<PreparedChain>>& evicted) {
+    if (bytes > budgetBytes_) {
+        return false;
+    }
+    auto priority = [&](const std::string& key) {
+        for (size_t i = 0; i < armed_.size(); ++i) {
+            if (armed_[i].key == key) return static_cast<int>(i);
+        }
+        return static_cast<int>(armed_.size());
+    };
+    // prepared_ is ordered by recency of arming, so the back is the least recently armed
+    auto it = prepared_.end();
+    while (residentBytes_ + bytes > budgetBytes_ && it != prepared_.begin()) {
+        --it;
+        if (priority((*it)->key) <= armedIndex) continue;
+        residentBytes_ -= (*it)->bytes;
+        evicted.push_back(std::move(*it));
+        it = prepared_.erase(it);
+    }
+    return residentBytes_ + bytes <= budgetBytes_;
+}
+
+void PresetPreloader::run() {
+    applyThreadRole(ThreadRole::Background);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        int index = -1;
+        workCv_.wait(lock, [&] { return stop_ || (index = nextWork()) >= 0; });
+        if (stop_) {
+            break;
+        }
+        const Preset preset = armed_[index];
+        const size_t bytes = armedBytes_[index];
+        const float sampleRate = sampleRate_;
+        const uint32_t bufferSize = bufferSize_;
+
+        std::vector<std::unique_ptr<PreparedChain>> evicted;
+        auto stale = findPrepared(preset.key);
+        if (stale != prepared_.end()) {
+            residentBytes_ -= (*stale)->bytes;
+            evicted.push_back(std::move(*stale));
+            prepared_.erase(stale);
+        }
+        if (!makeRoom(bytes, index, evicted)) {
+            skipped_.insert(preset.key);
+            idleCv_.notify_all();
+            lock.unlock();
+            evicted.clear();
+            lock.lock();
+            continue;
+        }
+        busy_ = true;
+        lock.unlock();
+        evicted.clear();
+
+        auto chain = std::make_unique<PreparedChain>();
+        chain->key = preset.key;
+        chain->state = preset.state;
+        chain->bytes = bytes;
+        chain->sampleRate = sampleRate;
+        chain->bufferSize = bufferSize;
+        // Map the files first so the plugins parse resident pages, shared with every other
+        // chain and live plugin using the same file
+        for (const std::string& path : referencedFiles(preset.state)) {
+            if (SharedFileCache::Ref file = SharedFileCache::instance().acquire(path)) {
+                chain->files.push_back(std::move(file));
+            }
+        }
+        bool ok = true;
+        for (const auto& pluginState : preset.state.plugins) {
+            std::unique_ptr<IPlugin> plugin = creator_(pluginState.pluginUri);
+            if (!plugin) {
+                ok = false;
+                break;
+            }
+            if (sampleRate > 0.0f) {
+                plugin->activate(sampleRate, bufferSize);
+                warmUpPlugin(*plugin, bufferSize);
+            }
+            plugin->restoreState(pluginState);
+            chain->plugins.push_back(std::move(plugin));
+        }
+
+        lock.lock();
+        busy_ = false;
+        int armedIndex = -1;
+        for (size_t i = 0; i < armed_.size(); ++i) {
+            if (armed_[i].key == preset.key && sameState(armed_[i].state, preset.state)) {
+                armedIndex = static_cast<int>(i);
+                break;
+            }
+        }
+        if (!ok) {
+            skipped_.insert(preset.key);
+        } else if (armedIndex >= 0 && findPrepared(preset.key) == prepared_.end() &&
+                   makeRoom(bytes, armedIndex, evicted)) {
+            // Keep prepared_ in armed order: before the first chain armed after this one
+            auto pos = std::find_if(prepared_.begin(), prepared_.end(), [&](const std::unique_ptr<PreparedChain>& c) {
+                for (int i = 0; i < armedIndex; ++i) {
+                    if (armed_[i].key == c->key) return false;
+                }
+                return true;
+            });
+            residentBytes_ += bytes;
+            prepared_.insert(pos, std::move(chain));
+        }
+        idleCv_.notify_all();
+        // Unwanted instances are destroyed outside the lock
+        lock.unlock();
+        chain.reset();
+        evicted.clear();
+        lock.lock();
+    }
+    idleCv_.notify_all();
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUITARRACKCRAFT_PRESET_PRELOADER_H
+#define GUITARRACKCRAFT_PRESET_PRELOADER_H
+
+#include "PluginChain.h"
+#include "../utils/SharedFileCache.h"
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Fully prepared chains for upcoming setlist presets.
+ *
+ * arm() names the presets to have ready, in priority order (the next preset first). A
+ * background thread instantiates each one's plugins, activates them at the chain's settings,
+ * warms them up and restores their state, so switching to it is a single
+ * PluginChain::replaceChain() swap. Prepared chains stay resident until taken or evicted:
+ * when preparing the next chain would exceed the memory budget, the least recently armed
+ * chains are dropped first, never one armed ahead of the chain being prepared.
+ *
+ * Plugins don't report their memory use, so a chain's footprint is estimated from its state:
+ * the model/IR files its path properties reference plus a fixed per-instance overhead.
+ * Those files are mapped through SharedFileCache before the plugins load them and stay
+ * mapped while the chain is resident.
+ */
+class PresetPreloader {
+public:
+    using Creator = PluginChain::PluginCreator;
+
+    struct Preset {
+        std::string key;  // stable identity, e.g. the preset file path
+        PluginChain::ChainState state;
+    };
+
+    struct PreparedChain {
+        std::string key;
+        PluginChain::ChainState state;
+        std::vector<std::unique_ptr<IPlugin>> plugins;  // in chain order
+        std::vector<SharedFileCache::Ref> files;  // model/IR files its state references, mapped
+        size_t bytes = 0;  // estimated footprint
+        float sampleRate = 0.0f;
+        uint32_t bufferSize = 0;
+    };
+
+    static constexpr size_t kDefaultBudgetBytes = 192u << 20;
+    static constexpr size_t kInstanceOverheadBytes = 1u << 20;
+
+    explicit PresetPreloader(Creator creator);
+    /** Stops the preloader thread and destroys the prepared chains. */
+    ~PresetPreloader();
+
+    PresetPreloader(const PresetPreloader&) = delete;
+    PresetPreloader& operator=(const PresetPreloader&) = delete;
+
+    /**
+     * Presets to have ready, most important first; replaces the previous list. Prepared chains
+     * no longer armed stay resident (evictable) so stepping back through a setlist is instant too.
+     * A prepared chain whose state differs from the newly armed one is rebuilt.
+     */
+    void arm(std::vector<Preset> presets);
+
+    /** Activation settings of the chain; prepared chains at other settings are rebuilt. */
+    void setActivation(float sampleRate, uint32_t bufferSize);
+
+    void setBudgetBytes(size_t bytes);
+
+    /**
+     * The prepared chain for key if it was built from exactly 'state' at the current activation
+     * settings, else nullptr. Taking a chain removes it from the cache and from the armed list.
+     */
+    std::unique_ptr<PreparedChain> take(const std::string& key, const PluginChain::ChainState& state);
+
+    /** Drop every prepared chain and the armed list. */
+    void clear();
+
+    size_t preparedCount() const;
+    size_t residentBytes() const;
+    /** Block until every armed preset is prepared, failed or does not fit the budget. */
+    void waitIdle();
+
+    /** Footprint estimate used for the budget. */
+    static size_t estimateBytes(const PluginChain::ChainState& state);
+    /** Paths of the files (atom:Path properties) the chain's state references. */
+    static std::vector<std::string> referencedFiles(const PluginChain::ChainState& state);
+
+private:
+    void run();
+    /** Index into armed_ of the next chain to prepare, or -1. Caller holds mutex_. */
+    int nextWork() const;
+    /** Make room for 'bytes' by evicting chains not armed at or before armedIndex. Returns
+     *  false if it cannot fit. Evicted chains are moved to 'evicted'. Caller holds mutex_. */
+    bool makeRoom(size_t bytes, int armedIndex, std::vector<std::unique_ptr<PreparedChain>>& evicted);
+    bool isCurrent(const PreparedChain& chain) const;
+    std::list<std::unique_ptr<PreparedChain>>::iterator findPrepared(const std::string& key);
+
+    Creator creator_;
+    mutable std::mutex mutex_;
+    std::condition_variable workCv_;
+    std::condition_variable idleCv_;
+    std::vector<Preset> armed_;
+    std::vector<size_t> armedBytes_;  // estimateBytes() per armed preset
+    std::list<std::unique_ptr<PreparedChain>> prepared_;  // most recently armed first
+    std::unordered_set<std::string> skipped_;  // failed or over budget; retried on the next arm()
+    size_t budgetBytes_ = kDefaultBudgetBytes;
+    size_t residentBytes_ = 0;
+    float sampleRate_ = 0.0f;
+    uint32_t bufferSize_ = 0;
+    bool busy_ = false;
+    bool stop_ = false;
+    std::thread thread_;  // started with the first arm()
+};
+
+} // namespace guitarrackcraft
+
+#endif // GUITARRACKCRAFT_PRESET_PRELOADER_H
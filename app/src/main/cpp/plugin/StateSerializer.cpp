@@ -18,6 +18,8 @@
  */
 
 #include "StateSerializer.h"
+#include "../utils/ByteCodec.h"
+#include <unordered_map>
 #include <sstream>
 #include <cstring>
 
@@ -125,4 +127,136 @@ std::string serializeChainStateToJson(const PluginChain::ChainState& state) {
     return os.str();
 }
 
+namespace {
+
+constexpr char kChainMagic[8] = {'G', 'R', 'C', 'C', 'H', 'A', 'I', 'N'};
+constexpr uint32_t kChainVersion = 1;
+// Smallest possible encodings, used to reject counts larger than the remaining bytes
+constexpr size_t kMinStringBytes = 4;
+constexpr size_t kMinRecordBytes = 4 + 4 + 4 + 4;
+constexpr size_t kMinControlBytes = 8;
+constexpr size_t kMinPropertyBytes = 16;
+
+/** Assigns each distinct string a dense id in first-use order. */
+class StringTable {
+public:
+    uint32_t intern(const std::string& s) {
+        auto it = ids_.find(s);
+        if (it != ids_.end()) return it->second;
+        const auto id = static_cast<uint32_t>(strings_.size());
+        ids_.emplace(s, id);
+        strings_.push_back(s);
+        return id;
+    }
+    const std::vector<std::string>& strings() const { return strings_; }
+
+private:
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::vector<std::string> strings_;
+};
+
+} // namespace
+
+std::vector<uint8_t> serializeChainStateToBinary(const PluginChain::ChainState& state) {
+    StringTable table;
+    ByteWriter body;
+    for (const auto& ps : state.plugins) {
+        const size_t lengthAt = body.size();
+        body.u32(0);
+        body.u32(table.intern(ps.pluginUri));
+        body.u32(static_cast<uint32_t>(ps.controlPortValues.size()));
+        for (const auto& cp : ps.controlPortValues) {
+            body.u32(cp.first);
+            body.f32(cp.second);
+        }
+        body.u32(static_cast<uint32_t>(ps.properties.size()));
+        for (const auto& prop : ps.properties) {
+            body.u32(table.intern(prop.keyUri));
+            body.u32(table.intern(prop.typeUri));
+            body.u32(prop.flags);
+            body.u32(static_cast<uint32_t>(prop.value.size()));
+            body.bytes(prop.value.data(), prop.value.size());
+        }
+        body.patchU32(lengthAt, static_cast<uint32_t>(body.size() - lengthAt - 4));
+    }
+
+    ByteWriter w;
+    w.bytes(kChainMagic, sizeof(kChainMagic));
+    w.u32(kChainVersion);
+    w.u32(static_cast<uint32_t>(table.strings().size()));
+    for (const auto& s : table.strings()) w.str(s);
+    w.u32(static_cast<uint32_t>(state.plugins.size()));
+    w.bytes(body.out.data(), body.out.size());
+    w.u64(fnv1a64(w.out.data(), w.out.size()));
+    return std::move(w.out);
+}
+
+bool deserializeChainStateFromBinary(const uint8_t* data, size_t size, PluginChain::ChainState& out) {
+    out.plugins.clear();
+    if (!data || size < sizeof(kChainMagic) + 4 + 4 + 4 + 8) return false;
+
+    ByteReader tail(data + size - 8, 8);
+    if (tail.u64() != fnv1a64(data, size - 8)) return false;
+
+    ByteReader r(data, size - 8);
+    char magic[sizeof(kChainMagic)];
+    if (!r.take(magic, sizeof(magic)) || std::memcmp(magic, kChainMagic, sizeof(kChainMagic)) != 0 ||
+        r.u32() != kChainVersion) {
+        return false;
+    }
+
+    std::vector<std::string> strings(r.count(kMinStringBytes));
+    for (auto& s : strings) s = r.str();
+    auto lookup = [&](uint32_t id, std::string& dst) {
+        if (id >= strings.size()) return false;
+        dst = strings[id];
+        return true;
+    };
+
+    bool ok = r.ok;
+    out.plugins.resize(r.count(kMinRecordBytes));
+    for (auto& ps : out.plugins) {
+        const uint32_t recordBytes = r.u32();
+        const uint8_t* record = r.view(recordBytes);
+        if (!record) {
+            ok = false;
+            break;
+        }
+        // Each record is decoded on its own so a bad length cannot bleed into the next one
+        ByteReader rec(record, recordBytes);
+        ok = lookup(rec.u32(), ps.pluginUri);
+        ps.controlPortValues.resize(rec.count(kMinControlBytes));
+        for (auto& cp : ps.controlPortValues) {
+            cp.first = rec.u32();
+            cp.second = rec.f32();
+        }
+        ps.properties.resize(rec.count(kMinPropertyBytes));
+        for (auto& prop : ps.properties) {
+            ok = ok && lookup(rec.u32(), prop.keyUri) && lookup(rec.u32(), prop.typeUri);
+            prop.flags = rec.u32();
+            const uint32_t len = rec.u32();
+            const uint8_t* value = rec.view(len);
+            if (value) prop.value.assign(value, value + len);
+        }
+        ok = ok && rec.ok && rec.remaining() == 0;
+        if (!ok) break;
+    }
+    ok = ok && r.ok && r.remaining() == 0;
+    if (!ok) out.plugins.clear();
+    return ok;
+}
+
+bool saveChainStateFile(const std::string& path, const PluginChain::ChainState& state) {
+    return writeFileAtomically(path, serializeChainStateToBinary(state));
+}
+
+bool loadChainStateFile(const std::string& path, PluginChain::ChainState& out) {
+    MappedFile file;
+    if (!file.open(path)) {
+        out.plugins.clear();
+        return false;
+    }
+    return deserializeChainStateFromBinary(file.data(), file.size(), out);
+}
+
 } // namespace guitarrackcraft
@@ -21,13 +21,34 @@
 #define GUITARRACKCRAFT_STATE_SERIALIZER_H
 
 #include "PluginChain.h"
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace guitarrackcraft {
 
 /** Serialize a ChainState to a JSON string (version 1 format). */
 std::string serializeChainStateToJson(const PluginChain::ChainState& state);
 
+/**
+ * Binary chain-state format ("GRCCHAIN", version 1): a per-file string table interning every
+ * plugin, key and type URI, then one length-prefixed record per plugin holding (port index, value)
+ * pairs and (key id, type id, flags, raw value) properties, and a trailing FNV-1a checksum.
+ * Property values are stored as-is, so restoring is a bounds-checked copy rather than a parse.
+ * JSON stays the export/interchange format; this one is for fast local preset switching.
+ */
+std::vector<uint8_t> serializeChainStateToBinary(const PluginChain::ChainState& state);
+
+/** Decode a binary chain state. Returns false (and leaves out empty) on any corruption. */
+bool deserializeChainStateFromBinary(const uint8_t* data, size_t size, PluginChain::ChainState& out);
+
+/** Write the binary form to path atomically. */
+bool saveChainStateFile(const std::string& path, const PluginChain::ChainState& state);
+
+/** Memory-map path and decode it. */
+bool loadChainStateFile(const std::string& path, PluginChain::ChainState& out);
+
 } // namespace guitarrackcraft
 
 #endif // GUITARRACKCRAFT_STATE_SERIALIZER_H
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "UIUpdateScheduler.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace guitarrackcraft {
+
+namespace {
+
+uint32_t readU32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * The patch:property URID of a patch:Set object, or 0 if 'atom' is something else.
+ * Layout: LV2_Atom {size, type}, object body {id, otype}, then properties
+ * {key, context, LV2_Atom value, value body}, each padded to 8 bytes.
+ */
+uint32_t patchSetProperty(const std::vector<uint8_t>& atom, const PatchSetUrids& urids) {
+    if (atom.size() < 16) return 0;
+    const uint32_t type = readU32(atom.data() + 4);
+    if (type == 0 || (type != urids.atomObject && type != urids.atomBlank)) return 0;
+    if (readU32(atom.data() + 12) != urids.patchSet) return 0;
+    const size_t end = std::min(atom.size(), static_cast<size_t>(8) + readU32(atom.data()));
+    size_t pos = 16;
+    while (pos + 16 <= end) {
+        const uint32_t key = readU32(atom.data() + pos);
+        const uint32_t valueSize = readU32(atom.data() + pos + 8);
+        if (key == urids.patchProperty) {
+            return valueSize >= 4 && pos + 20 <= end ? readU32(atom.data() + pos + 16) : 0;
+        }
+        pos += 16 + ((static_cast<size_t>(valueSize) + 7) & ~static_cast<size_t>(7));
+    }
+    return 0;
+}
+
+}  // namespace
+
+size_t coalesceOutputAtoms(std::vector<OutputAtomEvent>& events, const PatchSetUrids& urids) {
+    if (events.size() < 2 || urids.patchSet == 0) return 0;
+    // Walk backwards so the first (port, property) seen is the one that survives
+    std::vector<std::pair<uint32_t, uint32_t>> seen;
+    std::vector<bool> drop(events.size(), false);
+    size_t dropped = 0;
+    for (size_t i = events.size(); i-- > 0;) {
+        const uint32_t property = patchSetProperty(events[i].data, urids);
+        if (property == 0) continue;
+        const std::pair<uint32_t, uint32_t> key{events[i].portIndex, property};
+        if (std::find(seen.begin(), seen.end(), key) != seen.end()) {
+            drop[i] = true;
+            ++dropped;
+        } else {
+            seen.push_back(key);
+        }
+    }
+    if (dropped == 0) return 0;
+    size_t out = 0;
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (drop[i]) continue;
+        if (out != i) events[out] = std::move(events[i]);
+        ++out;
+    }
+    events.resize(out);
+    return dropped;
+}
+
+void UIIdleBudget::ran(int64_t startNs, int64_t costNs, int openUIs) {
+    const double cost = static_cast<double>(std::max<int64_t>(costNs, 0));
+    avgCostNs_ = avgCostNs_ < 0.0 ? cost : avgCostNs_ * 0.875 + cost * 0.125;
+    const double share = kBudgetFraction / static_cast<double>(std::max(openUIs, 1));
+    const auto wanted = static_cast<int64_t>(avgCostNs_ / share);
+    intervalNs_ = std::clamp(wanted, kMinIntervalNs, kMaxIntervalNs);
+    nextNs_ = startNs + intervalNs_ - kSlackNs;
+}
+
+void UIIdleBudget::reset() {
+    nextNs_ = 0;
+    intervalNs_ = kMinIntervalNs;
+    avgCostNs_ = -1.0;
+}
+
+} // namespace guitarrackcraft
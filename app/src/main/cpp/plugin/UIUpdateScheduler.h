@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUITARRACKCRAFT_UI_UPDATE_SCHEDULER_H
+#define GUITARRACKCRAFT_UI_UPDATE_SCHEDULER_H
+
+#include "IPlugin.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/** URIDs coalesceOutputAtoms() needs, mapped with the UI's URID map. */
+struct PatchSetUrids {
+    uint32_t atomObject = 0;
+    uint32_t atomBlank = 0;
+    uint32_t patchSet = 0;
+    uint32_t patchProperty = 0;
+};
+
+/**
+ * Drop the patch:Set events that a later patch:Set for the same port and property in the same
+ * batch overrides; the UI would only redraw twice and keep the last value. Everything else,
+ * and the order of what is kept, is left alone. Returns the number of events dropped.
+ */
+size_t coalesceOutputAtoms(std::vector<OutputAtomEvent>& events, const PatchSetUrids& urids);
+
+/**
+ * Per-UI idle rate. Every open UI shares kBudgetFraction of one core: a UI whose idle pass
+ * (LV2 idle() plus port updates) costs more than its share is run less often, down to
+ * kMaxIntervalNs, while cheap UIs keep running on every pluginUI loop pass.
+ */
+class UIIdleBudget {
+public:
+    static constexpr int64_t kMinIntervalNs = 16000000LL;   // one pluginUI loop pass
+    static constexpr int64_t kMaxIntervalNs = 100000000LL;  // never slower than 10 Hz
+    static constexpr int64_t kSlackNs = 2000000LL;          // loop wakeup jitter
+    static constexpr double kBudgetFraction = 0.25;
+
+    /** True if the UI should run a pass at 'nowNs'. */
+    bool due(int64_t nowNs) const { return nowNs >= nextNs_; }
+
+    /** Record a pass that started at 'startNs' and took 'costNs', with 'openUIs' sharing the
+     *  budget, and schedule the next one. */
+    void ran(int64_t startNs, int64_t costNs, int openUIs);
+
+    int64_t intervalNs() const { return intervalNs_; }
+
+    void reset();
+
+private:
+    int64_t nextNs_ = 0;
+    int64_t intervalNs_ = kMinIntervalNs;
+    double avgCostNs_ = -1.0;  // < 0 until the first pass
+};
+
+} // namespace guitarrackcraft
+
+#endif // GUITARRACKCRAFT_UI_UPDATE_SCHEDULER_H
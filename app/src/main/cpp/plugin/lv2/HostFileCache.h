@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef GUITARRACKCRAFT_HOST_FILE_CACHE_H
+#define GUITARRACKCRAFT_HOST_FILE_CACHE_H
+
+/*
+ * Host feature: shared read-only file mappings.
+ *
+ * A plugin that finds GRC_FILE_CACHE_URI among its instantiate() features can ask the
+ * host for a file (a model capture, an impulse response) instead of reading it itself.
+ * Every instance asking for the same file, or for a file with the same contents, gets the
+ * same read-only pages, the ones the host may already have preloaded for an upcoming
+ * preset. Plugins without support keep reading files themselves.
+ *
+ * Plain C so plugins can copy this header as is.
+ */
+
+#include <stddef.h>
+
+#define GRC_FILE_CACHE_URI "urn:guitarrackcraft:lv2:fileCache"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void* GRC_File_Cache_Handle;
+
+typedef struct {
+    GRC_File_Cache_Handle handle;
+
+    /**
+     * Map the file at absolute path. Returns its contents (size bytes, read-only, valid
+     * until release()), or NULL if it cannot be read. Call from instantiate(), the worker
+     * or state restore, never from run().
+     */
+    const void* (*acquire)(GRC_File_Cache_Handle handle, const char* path, size_t* size);
+
+    /** Hand back a pointer returned by acquire(). Every acquire() needs one release(). */
+    void (*release)(GRC_File_Cache_Handle handle, const void* data);
+} GRC_File_Cache;
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // GUITARRACKCRAFT_HOST_FILE_CACHE_H
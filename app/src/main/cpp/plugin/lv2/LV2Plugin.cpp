@@ -20,13 +20,15 @@
 #include "LV2Plugin.h"
 #include "LV2Utils.h"
 #include "../PluginUIGuard.h"
-#include <android/log.h>
-#include <chrono>
+#include "../../utils/RtTrace.h"
+#include "../../utils/SystemTrace.h"
+#include "../../utils/UridTable.h"
+#include "../../utils/LogCompat.h"
+#include <cctype>
 #include <cmath>
 #include <cstring>
 #include <algorithm>
 #include <mutex>
-#include <unordered_map>
 #include <vector>
 
 #define LOG_TAG "LV2Plugin"
@@ -37,34 +39,29 @@
 #include <lilv/lilv.h>
 #include <lv2/urid/urid.h>
 #include <lv2/atom/util.h>
+#include <lv2/midi/midi.h>
+#include <lv2/port-props/port-props.h>
 
 // ---------- Global URID map (shared across all plugin instances + UIs) ------
 
 namespace {
 
-struct UridMapImpl {
-    std::mutex mutex;
-    std::unordered_map<std::string, LV2_URID> uriToId;
-    std::vector<std::string> idToUri;  // index 0 unused (URID 0 is invalid)
+#if defined(GRC_RT_TRACE) && GRC_RT_TRACE
+constexpr uint32_t kTraceEveryBlocks = 750;
 
-    UridMapImpl() { idToUri.emplace_back(""); } // reserve index 0
-
-    LV2_URID map(const char* uri) {
-        std::lock_guard<std::mutex> lock(mutex);
-        auto it = uriToId.find(uri);
-        if (it != uriToId.end()) return it->second;
-        LV2_URID id = static_cast<LV2_URID>(idToUri.size());
-        uriToId[uri] = id;
-        idToUri.push_back(uri);
-        return id;
+float tracePeak(const float* buf, uint32_t numFrames) {
+    float peak = 0.0f;
+    if (buf) {
+        for (uint32_t i = 0, n = std::min(numFrames, 128u); i < n; ++i) {
+            peak = std::max(peak, std::fabs(buf[i]));
+        }
     }
+    return peak;
+}
+#endif
 
-    const char* unmap(LV2_URID id) {
-        std::lock_guard<std::mutex> lock(mutex);
-        if (id == 0 || id >= idToUri.size()) return nullptr;
-        return idToUri[id].c_str();
-    }
-};
+// Lock-free for lookups: plugins call map/unmap from run() and work_response()
+using UridMapImpl = guitarrackcraft::UridTable;
 
 UridMapImpl& getGlobalUridMap() {
     static UridMapImpl instance;
@@ -88,11 +85,33 @@ LV2_URID_Unmap globalLv2UridUnmap = { &getGlobalUridMap(), uridUnmapCallback };
 namespace {
 LV2_Feature uridMapFeature = { LV2_URID__map, &globalLv2UridMap };
 LV2_Feature uridUnmapFeature = { LV2_URID__unmap, &globalLv2UridUnmap };
+
+// Host extension: a bundle lists this (optional or required) to run without flush-to-zero.
+// DSP threads flush denormals by default; see utils/FloatEnv.h.
+constexpr const char* kStrictFloatFeature = "urn:guitarrackcraft:lv2:strictFloat";
+
+// LV2 has no property for "costs CPU"; plugins name these controls consistently enough
+// (oversampling, os, quality, hq) that the symbol is a usable hint.
+bool isQualitySymbol(const char* symbol) {
+    std::string s(symbol ? symbol : "");
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+    return s.find("oversampl") != std::string::npos || s.find("quality") != std::string::npos ||
+           s == "os" || s == "hq";
+}
 } // anonymous namespace
 #endif
 
 namespace guitarrackcraft {
 
+bool LV2Plugin::setMemoryLocked(bool locked) {
+    memoryLocked_.store(locked);
+    if (!locked) {
+        arena_.unlock();
+        return true;
+    }
+    return arena_.lock();
+}
+
 #if defined(HAVE_LV2) && HAVE_LV2 == 1
 
 // Check if we support all required features of a plugin
@@ -105,6 +124,9 @@ static bool checkRequiredFeatures(const LilvPlugin* plugin, LilvWorld* world) {
         LV2_BUF_SIZE__boundedBlockLength,
         LV2_STATE__mapPath,
         LV2_STATE__freePath,
+        LV2_CORE__inPlaceBroken,  // honoured: such plugins never get aliased buffers
+        kStrictFloatFeature,      // honoured: run with IEEE denormals
+        GRC_FILE_CACHE_URI,
         nullptr
     };
 
@@ -131,16 +153,12 @@ static bool checkRequiredFeatures(const LilvPlugin* plugin, LilvWorld* world) {
 void LV2Plugin::buildFeatures() {
     auto& uridMap = getGlobalUridMap();
 
-    // Initialize atom forge
-    lv2_atom_forge_init(&forge_, &globalLv2UridMap);
-
     // Map patch/atom URIDs
-    atom_Path_ = uridMap.map(LV2_ATOM__Path);
-    atom_URID_ = uridMap.map(LV2_ATOM__URID);
+    atom_Sequence_ = uridMap.map(LV2_ATOM__Sequence);
     patch_Set_ = uridMap.map(LV2_PATCH__Set);
-    patch_Get_ = uridMap.map(LV2_PATCH__Get);
     patch_property_ = uridMap.map(LV2_PATCH__property);
     patch_value_ = uridMap.map(LV2_PATCH__value);
+    midi_MidiEvent_ = uridMap.map(LV2_MIDI__MidiEvent);
 
     // Options: provide buffer size info
     LV2_URID bufsz_max = uridMap.map(LV2_BUF_SIZE__maxBlockLength);
@@ -172,6 +190,11 @@ void LV2Plugin::buildFeatures() {
     freePathData_.free_path = freePathCallback;
     freePathFeature_ = {LV2_STATE__freePath, &freePathData_};
 
+    fileCacheData_.handle = this;
+    fileCacheData_.acquire = fileCacheAcquireCallback;
+    fileCacheData_.release = fileCacheReleaseCallback;
+    fileCacheFeature_ = {GRC_FILE_CACHE_URI, &fileCacheData_};
+
     // Build null-terminated features pointer array
     instanceFeatures_.clear();
     instanceFeatures_.push_back(&uridMapFeature);         // global
@@ -181,6 +204,7 @@ void LV2Plugin::buildFeatures() {
     instanceFeatures_.push_back(&boundedBlockFeature_);    // static
     instanceFeatures_.push_back(&mapPathFeature_);         // per-instance
     instanceFeatures_.push_back(&freePathFeature_);        // per-instance
+    instanceFeatures_.push_back(&fileCacheFeature_);       // per-instance
     instanceFeatures_.push_back(nullptr);
 }
 
@@ -197,6 +221,9 @@ LV2Plugin::LV2Plugin(const LilvPlugin* plugin, LilvWorld* world, float sampleRat
         return;
     }
 
+    std::lock_guard<std::recursive_mutex> worldLock(lilvWorldMutex());
+    info_ = queryInfo();
+
     if (!checkRequiredFeatures(plugin_, world_)) {
         LOGE("Plugin has unsupported required features, skipping instantiation");
         return;
@@ -210,7 +237,11 @@ LV2Plugin::LV2Plugin(const LilvPlugin* plugin, LilvWorld* world, float sampleRat
         return;
     }
 
-    initializePorts();
+    if (!initializePorts()) {
+        lilv_instance_free(instance_);
+        instance_ = nullptr;
+        return;
+    }
     connectPorts();
 
     // Query state:interface extension
@@ -223,8 +254,9 @@ LV2Plugin::LV2Plugin(const LilvPlugin* plugin, LilvWorld* world, float sampleRat
 }
 
 LV2Plugin::~LV2Plugin() {
-    stopWorker();
+    // Stop run() first so nothing can schedule work on the pool after stopWorker()
     deactivate();
+    stopWorker();
     if (instance_) {
         if (!guitarrackcraft::isCreatingPluginUI()) {
             lilv_instance_free(instance_);
@@ -235,7 +267,12 @@ LV2Plugin::~LV2Plugin() {
 
 void LV2Plugin::activate(float sampleRate, uint32_t bufferSize) {
     LOGI("activate: sampleRate=%.0f bufferSize=%u", sampleRate, bufferSize);
-    if (isActive_.load(std::memory_order_seq_cst) && sampleRate_ == sampleRate) {
+    // process() caps each run() at maxBlockLength_ and the host arena is sized from it, so an
+    // active instance is only kept while the new buffer still fits
+    uint32_t po2 = 1;
+    while (po2 < bufferSize) po2 <<= 1;
+    if (isActive_.load(std::memory_order_seq_cst) && sampleRate_ == sampleRate &&
+        (bufferSize == 0 || static_cast<int32_t>(po2) <= maxBlockLength_)) {
         return;
     }
 
@@ -248,9 +285,6 @@ void LV2Plugin::activate(float sampleRate, uint32_t bufferSize) {
     // because zita-convolver requires power-of-2 quantum. Fall back to
     // kMaxLv2BufferFrames only if no buffer size is provided.
     if (bufferSize > 0) {
-        // Round up to next power of 2
-        uint32_t po2 = 1;
-        while (po2 < bufferSize) po2 <<= 1;
         maxBlockLength_ = static_cast<int32_t>(po2);
         LOGI("activate: framesPerBurst=%u rounded to power-of-2 maxBlockLength=%d",
              bufferSize, maxBlockLength_);
@@ -276,6 +310,8 @@ void LV2Plugin::activate(float sampleRate, uint32_t bufferSize) {
         instance_ = nullptr;
     }
 
+    // Instantiation and port setup query the world, which other threads may be loading bundles into
+    std::unique_lock<std::recursive_mutex> worldLock(lilvWorldMutex());
     if (!checkRequiredFeatures(plugin_, world_)) {
         LOGE("Plugin has unsupported required features, skipping re-instantiation");
         return;
@@ -289,15 +325,20 @@ void LV2Plugin::activate(float sampleRate, uint32_t bufferSize) {
         return;
     }
 
-    initializePorts();
+    if (!initializePorts()) {
+        lilv_instance_free(instance_);
+        instance_ = nullptr;
+        return;
+    }
     connectPorts();
+    worldLock.unlock();
 
     // Re-query state:interface after re-instantiation
     const void* si = lilv_instance_get_extension_data(instance_, LV2_STATE__interface);
     stateInterface_ = static_cast<const LV2_State_Interface*>(si);
 
     LOGI("activate: ports control=%zu audioIn=%zu audioOut=%zu atom=%zu",
-         controlPorts_.size(), audioInputPorts_.size(), audioOutputPorts_.size(),
+         controlCount_, audioInputPorts_.size(), audioOutputPorts_.size(),
          atomPorts_.size());
 
     if (instance_) {
@@ -327,6 +368,16 @@ void LV2Plugin::deactivate() {
     }
 
     stopWorker();
+    // Nothing reads the queue until the next activation; pending values are already targets
+    {
+        std::lock_guard<std::mutex> lock(paramWriteMutex_);
+        ParamEvent event;
+        while (paramEvents_.pop(event)) {
+            controlValues_[event.slot] = event.value;
+        }
+        for (auto& ramp : ramps_) ramp.remaining = 0;
+        activeRamps_.clear();
+    }
 
     if (instance_) {
         lilv_instance_deactivate(instance_);
@@ -341,12 +392,10 @@ void LV2Plugin::process(const float* const* inputs, float* const* outputs, uint3
 
     if (!isActive_.load(std::memory_order_seq_cst) || !instance_) {
         processing_.store(false, std::memory_order_seq_cst);
-        static auto lastLogPassthrough = std::chrono::steady_clock::now();
-        auto now = std::chrono::steady_clock::now();
-        if (std::chrono::duration<double>(now - lastLogPassthrough).count() >= 1.0) {
-            lastLogPassthrough = now;
-            LOGI("process: passthrough isActive=%d instance=%p", (int)isActive_.load(), (void*)instance_);
-        }
+        midiCount_ = 0;
+        rtEventCount_ = 0;
+        RT_TRACE_EVERY(kTraceEveryBlocks, LOG_TAG, "process: passthrough isActive/instance",
+                       isActive_.load() ? 1 : 0, instance_ ? 1 : 0);
         if (inputs && outputs && numFrames > 0) {
             for (uint32_t ch = 0; ch < 2; ++ch) {
                 if (inputs[ch] && outputs[ch]) {
@@ -357,106 +406,8 @@ void LV2Plugin::process(const float* const* inputs, float* const* outputs, uint3
         return;
     }
 
-    // Copy host input into the instance's connected buffers
-    const size_t maxCopy = std::min(static_cast<size_t>(numFrames), kMaxLv2BufferFrames);
-    for (size_t i = 0; i < audioInputPorts_.size() && i < 2; ++i) {
-        if (inputs[i] && audioInputPorts_[i]) {
-            std::memcpy(audioInputPorts_[i], inputs[i], maxCopy * sizeof(float));
-        }
-    }
-
-    // Reset atom buffers before run()
-    for (auto& ap : atomPorts_) {
-        auto* seq = reinterpret_cast<LV2_Atom_Sequence*>(
-            atomPortBuffers_[ap.bufferIdx].data());
-        seq->atom.type = getGlobalUridMap().map(LV2_ATOM__Sequence);
-        if (ap.isInput) {
-            // Input: empty sequence (body header only)
-            seq->atom.size = sizeof(LV2_Atom_Sequence_Body);
-        } else {
-            // Output: set atom.size to total buffer capacity so the plugin's
-            // forge knows how much space is available for writing
-            seq->atom.size = kAtomBufferSize;
-        }
-        seq->body.unit = 0;
-        seq->body.pad = 0;
-    }
-
-    // Inject pending raw atom messages from UI (DPF state sync, etc.)
-    {
-        std::lock_guard<std::mutex> lock(pendingAtomMutex_);
-        if (!pendingAtoms_.empty()) {
-            for (auto& ap : atomPorts_) {
-                if (ap.isInput) {
-                    auto* buf = atomPortBuffers_[ap.bufferIdx].data();
-                    auto* seq = reinterpret_cast<LV2_Atom_Sequence*>(buf);
-                    // Append each pending atom as an event in the sequence
-                    for (auto& atomData : pendingAtoms_) {
-                        if (atomData.size() < sizeof(LV2_Atom)) continue;
-                        auto* srcAtom = reinterpret_cast<const LV2_Atom*>(atomData.data());
-                        uint32_t bodyDataSize = srcAtom->size;
-                        // Event: time(8) + atom header(8) + body data
-                        uint32_t evtBytes = sizeof(LV2_Atom_Event) + bodyDataSize;
-                        uint32_t paddedEvt = (evtBytes + 7u) & ~7u;
-                        // Check if there's room in the buffer
-                        uint32_t totalUsed = sizeof(LV2_Atom) + seq->atom.size;
-                        if (totalUsed + paddedEvt > kAtomBufferSize) continue;
-                        // Write at end of current sequence
-                        auto* writePos = reinterpret_cast<uint8_t*>(&seq->body) + seq->atom.size;
-                        auto* evt = reinterpret_cast<LV2_Atom_Event*>(writePos);
-                        evt->time.frames = 0;
-                        evt->body.size = bodyDataSize;
-                        evt->body.type = srcAtom->type;
-                        std::memcpy(reinterpret_cast<uint8_t*>(evt) + sizeof(LV2_Atom_Event),
-                                    atomData.data() + sizeof(LV2_Atom),
-                                    bodyDataSize);
-                        seq->atom.size += paddedEvt;
-                    }
-                    break;  // only inject into first atom input port
-                }
-            }
-            pendingAtoms_.clear();
-        }
-    }
-
-    // Forge pending patch:Set message into atom input port
-    {
-        std::lock_guard<std::mutex> lock(filePathMutex_);
-        if (!pendingFilePath_.empty()) {
-            for (auto& ap : atomPorts_) {
-                if (ap.isInput) {
-                    auto* buf = atomPortBuffers_[ap.bufferIdx].data();
-                    lv2_atom_forge_set_buffer(&forge_, buf, kAtomBufferSize);
-
-                    LV2_Atom_Forge_Frame seqFrame;
-                    lv2_atom_forge_sequence_head(&forge_, &seqFrame, 0);
-
-                    LV2_Atom_Forge_Frame objFrame;
-                    lv2_atom_forge_frame_time(&forge_, 0);
-                    lv2_atom_forge_object(&forge_, &objFrame, 0, patch_Set_);
-
-                    lv2_atom_forge_key(&forge_, patch_property_);
-                    LV2_URID propUrid = getGlobalUridMap().map(
-                        pendingFilePropertyUri_.c_str());
-                    lv2_atom_forge_urid(&forge_, propUrid);
-
-                    lv2_atom_forge_key(&forge_, patch_value_);
-                    lv2_atom_forge_path(&forge_, pendingFilePath_.c_str(),
-                                        pendingFilePath_.size() + 1);
-
-                    lv2_atom_forge_pop(&forge_, &objFrame);
-                    lv2_atom_forge_pop(&forge_, &seqFrame);
-
-                    LOGI("process: forged patch:Set for %s -> %s",
-                         pendingFilePropertyUri_.c_str(),
-                         pendingFilePath_.c_str());
-                    break;
-                }
-            }
-            pendingFilePath_.clear();
-            pendingFilePropertyUri_.clear();
-        }
-    }
+    // The plugin reads and writes the host buffers directly; no copy in or out
+    const size_t maxCopy = std::min(static_cast<size_t>(numFrames), static_cast<size_t>(maxBlockLength_));
 
     // Re-check instance_ (defensive — processing_ guard should prevent this)
     if (!instance_) {
@@ -467,112 +418,82 @@ void LV2Plugin::process(const float* const* inputs, float* const* outputs, uint3
         }
         return;
     }
-    lilv_instance_run(instance_, static_cast<uint32_t>(maxCopy));
 
-    // Call end_run if available
-    if (workerInterface_ && workerInterface_->end_run) {
-        workerInterface_->end_run(lilv_instance_get_handle(instance_));
-    }
+    // Split the block where parameter events land and every kRampStepFrames while a smoothed
+    // port is ramping, so control changes take effect at their frame instead of block edges.
+    const uint32_t frames = static_cast<uint32_t>(maxCopy);
+    const uint32_t numEvents = collectParamEvents(frames);
+    uint32_t pos = 0;
+    uint32_t ev = 0;
+    do {
+        while (ev < numEvents && (!splitBlocks_ || blockEvents_[ev].frame <= pos)) {
+            applyParamEvent(blockEvents_[ev++]);
+        }
+        uint32_t end = frames;
+        if (splitBlocks_) {
+            if (ev < numEvents) {
+                end = std::min(end, std::max(blockEvents_[ev].frame, pos + kMinSegmentFrames));
+            }
+            if (!activeRamps_.empty()) end = std::min(end, pos + kRampStepFrames);
+        }
+        advanceRamps(end - pos);
+        runSegment(inputs, outputs, pos, end - pos, pos == 0, end >= frames);
+        pos = end;
+    } while (pos < frames);
+    midiCount_ = 0;
+    midiNext_ = 0;
 
     // Deliver pending worker responses AFTER run() (LV2 Worker spec requirement).
     // Plugins like AIDA-X write to the atom forge in work_response(), which
     // requires the forge to be initialized by run() first. Delivering before
     // run() used stale forge state and violated the spec ordering.
+    // At most kMaxWorkResponsesPerBlock per block so a burst cannot blow the deadline;
+    // the rest stay queued for the following blocks.
     if (workerInterface_ && workerInterface_->work_response) {
         LV2_Handle handle = lilv_instance_get_handle(instance_);
-        std::lock_guard<std::mutex> lock(responseMutex_);
-        while (!workResponses_.empty()) {
-            auto& resp = workResponses_.front();
-            workerInterface_->work_response(
-                handle,
-                static_cast<uint32_t>(resp.size()),
-                resp.data());
-            workResponses_.pop();
+        uint32_t size = 0;
+        for (int n = 0; n < kMaxWorkResponsesPerBlock &&
+                        workResponses_.read(responseBuffer_.data(),
+                                            static_cast<uint32_t>(responseBuffer_.size()), size);
+             ++n) {
+            SYSTEM_TRACE_SCOPE("LV2 work_response");
+            workerInterface_->work_response(handle, size, responseBuffer_.data());
         }
     }
 
     // Read atom output ports and queue events for UI forwarding
-    {
-        std::vector<OutputAtomEvent> batch;
-        for (auto& ap : atomPorts_) {
-            if (ap.isInput) continue;
-            auto* seq = reinterpret_cast<const LV2_Atom_Sequence*>(
-                atomPortBuffers_[ap.bufferIdx].data());
-            // Skip if empty or if the plugin left atom.size at the pre-run
-            // capacity (meaning it didn't write the output sequence at all —
-            // iterating would walk through uninitialised memory).
-            if (seq->atom.size <= sizeof(LV2_Atom_Sequence_Body) ||
-                seq->atom.size >= kAtomBufferSize) continue;
-            LV2_ATOM_SEQUENCE_FOREACH(seq, ev) {
-                uint32_t bodySize = ev->body.size;
-                // Sanity-check: event body must fit inside the atom buffer
-                const uint8_t* evEnd = reinterpret_cast<const uint8_t*>(&ev->body) +
-                                       sizeof(LV2_Atom) + bodySize;
-                const uint8_t* bufEnd = atomPortBuffers_[ap.bufferIdx].data() +
-                                        kAtomBufferSize;
-                if (evEnd > bufEnd) break;
-                uint32_t atomTotalSize = sizeof(LV2_Atom) + bodySize;
-                std::vector<uint8_t> data(atomTotalSize);
-                std::memcpy(data.data(), &ev->body, atomTotalSize);
-                batch.push_back(OutputAtomEvent{ap.portIndex, std::move(data)});
-            }
-        }
-        if (!batch.empty()) {
-            std::lock_guard<std::mutex> lock(outputAtomMutex_);
-            for (auto& evt : batch) {
-                pendingOutputAtoms_.push_back(std::move(evt));
-            }
-        }
+    queueOutputAtoms();
+    markChangedOutputs();
+    if (latencySlot_ >= 0) {
+        latencyFrames_ = static_cast<uint32_t>(std::max(0.0f, controlValues_[latencySlot_]));
     }
 
-    const size_t numOut = audioOutputPorts_.size();
-    for (size_t i = 0; i < numOut && i < 2; ++i) {
-        if (outputs[i] && audioOutputPorts_[i]) {
-            std::memcpy(outputs[i], audioOutputPorts_[i], maxCopy * sizeof(float));
-        }
-    }
     // Mono plugin: duplicate single output to both channels
-    if (numOut == 1 && outputs[0] && outputs[1] && audioOutputPorts_[0]) {
-        std::memcpy(outputs[1], audioOutputPorts_[0], maxCopy * sizeof(float));
+    if (audioOutputPorts_.size() == 1 && outputs[0] && outputs[1]) {
+        std::memcpy(outputs[1], outputs[0], maxCopy * sizeof(float));
     }
     // If host requested more frames than our internal buffer, passthrough the tail
     if (maxCopy < static_cast<size_t>(numFrames)) {
         for (uint32_t ch = 0; ch < 2; ++ch) {
-            if (inputs[ch] && outputs[ch]) {
+            if (inputs[ch] && outputs[ch] && inputs[ch] != outputs[ch]) {
                 std::memcpy(outputs[ch] + maxCopy, inputs[ch] + maxCopy,
                             (numFrames - maxCopy) * sizeof(float));
             }
         }
     }
 
-    // Rate-limited: in/out peak to verify plugin is changing the signal
-    {
-        static auto lastLogPeak = std::chrono::steady_clock::now();
-        auto now = std::chrono::steady_clock::now();
-        if (std::chrono::duration<double>(now - lastLogPeak).count() >= 1.0) {
-            lastLogPeak = now;
-            const uint32_t n = std::min(numFrames, 128u);
-            float inPeak = 0.0f, outPeak = 0.0f;
-            if (inputs[0]) {
-                for (uint32_t i = 0; i < n; ++i) {
-                    float s = std::fabs(inputs[0][i]);
-                    if (s > inPeak) inPeak = s;
-                }
-            }
-            if (outputs[0]) {
-                for (uint32_t i = 0; i < n; ++i) {
-                    float s = std::fabs(outputs[0][i]);
-                    if (s > outPeak) outPeak = s;
-                }
-            }
-            LOGI("process: inPeak=%.4f outPeak=%.4f nFrames=%u", inPeak, outPeak, numFrames);
-        }
-    }
+    // Trace builds: in/out peak to verify plugin is changing the signal
+    RT_TRACE_EVERY(kTraceEveryBlocks, LOG_TAG, "process: inPeak/outPeak/nFrames",
+                   tracePeak(inputs[0], numFrames), tracePeak(outputs[0], numFrames), numFrames);
 
     processing_.store(false, std::memory_order_seq_cst);
 }
 
 PluginInfo LV2Plugin::getInfo() const {
+    return info_;
+}
+
+PluginInfo LV2Plugin::queryInfo() const {
     PluginInfo info;
     
     if (!plugin_) {
@@ -705,22 +626,98 @@ PluginInfo LV2Plugin::getInfo() const {
 }
 
 void LV2Plugin::setParameter(uint32_t portIndex, float value) {
+    setParameterAt(portIndex, value, 0);
+}
+
+void LV2Plugin::setParameterAt(uint32_t portIndex, float value, uint32_t frameOffset) {
     // portIndex is the global LV2 port index; map to control buffer index
-    for (size_t k = 0; k < controlPortIndices_.size(); ++k) {
-        if (controlPortIndices_[k] == portIndex && k < controlPorts_.size() && controlPorts_[k]) {
-            *controlPorts_[k].get() = value;
-            return;
-        }
+    if (portIndex >= controlSlotByPort_.size()) return;
+    int32_t slot = controlSlotByPort_[portIndex];
+    if (slot < 0) return;
+
+    std::lock_guard<std::mutex> lock(paramWriteMutex_);
+    controlTargets_[slot].store(value, std::memory_order_relaxed);
+    // Inactive instances are not run, and output ports are the plugin's to write: store
+    // directly. A full queue also falls back to the old jump at the next run().
+    if (!(controlFlags_[slot] & kControlInput) || !isActive_.load(std::memory_order_acquire) ||
+        !paramEvents_.push({static_cast<uint32_t>(slot), frameOffset, value})) {
+        controlValues_[slot] = value;
     }
 }
 
+void LV2Plugin::setParameterRt(uint32_t portIndex, float value, uint32_t frameOffset) {
+    if (portIndex >= controlSlotByPort_.size()) return;
+    int32_t slot = controlSlotByPort_[portIndex];
+    if (slot < 0 || !(controlFlags_[slot] & kControlInput)) return;
+    controlTargets_[slot].store(value, std::memory_order_relaxed);
+    // Inactive instances pick the target up when the host next restores or sets parameters
+    if (rtEventCount_ < kMaxParamEventsPerBlock && isActive_.load(std::memory_order_acquire)) {
+        rtEvents_[rtEventCount_++] = {static_cast<uint32_t>(slot), frameOffset, value};
+    }
+}
+
+void LV2Plugin::queueMidi(const uint8_t* data, uint32_t size, uint32_t frameOffset) {
+    if (midiPort_ < 0 || size == 0 || size > sizeof(MidiEvent::data) ||
+        midiCount_ >= kMaxMidiEventsPerBlock) {
+        return;
+    }
+    MidiEvent event{frameOffset, static_cast<uint8_t>(size), {}};
+    std::memcpy(event.data, data, size);
+    // Insertion sort, as in collectParamEvents(): arrival order is nearly always frame order
+    uint32_t i = midiCount_++;
+    while (i > 0 && midiEvents_[i - 1].frame > event.frame) {
+        midiEvents_[i] = midiEvents_[i - 1];
+        --i;
+    }
+    midiEvents_[i] = event;
+}
+
 float LV2Plugin::getParameter(uint32_t portIndex) const {
-    for (size_t k = 0; k < controlPortIndices_.size(); ++k) {
-        if (controlPortIndices_[k] == portIndex && k < controlPorts_.size() && controlPorts_[k]) {
-            return *controlPorts_[k].get();
+    if (portIndex >= controlSlotByPort_.size()) return 0.0f;
+    int32_t slot = controlSlotByPort_[portIndex];
+    if (slot < 0) return 0.0f;
+    // Inputs report the value last set even while it is still queued or ramping
+    return (controlFlags_[slot] & kControlInput) ? controlTargets_[slot].load(std::memory_order_relaxed)
+                                                 : controlValues_[slot];
+}
+
+uint32_t LV2Plugin::getLatencyFrames() const {
+    return latencyFrames_;
+}
+
+uint32_t LV2Plugin::readOutputControls(float* values, uint32_t capacity) {
+    // Same guard as process(): activate() may be rebuilding the port arrays
+    processing_.store(true, std::memory_order_seq_cst);
+    uint32_t count = 0;
+    if (isActive_.load(std::memory_order_seq_cst)) {
+        for (size_t k = 0; k < controlFlags_.size(); ++k) {
+            if (controlFlags_[k] & kControlInput) continue;
+            if (count < capacity) values[count] = controlValues_[k];
+            ++count;
+        }
+    }
+    processing_.store(false, std::memory_order_seq_cst);
+    return count;
+}
+
+bool LV2Plugin::takeChangedOutputs(std::vector<std::pair<uint32_t, float>>& changed) {
+    if (!isActive_.load(std::memory_order_acquire)) return true;
+    changedOutputs_.take([&](uint32_t slot) {
+        if (slot < controlPortIndices_.size()) {
+            changed.emplace_back(controlPortIndices_[slot], controlValues_[slot]);
+        }
+    });
+    return true;
+}
+
+void LV2Plugin::markChangedOutputs() {
+    for (size_t i = 0; i < outputSlots_.size(); ++i) {
+        const float value = controlValues_[outputSlots_[i]];
+        if (value != publishedOutputs_[i]) {
+            publishedOutputs_[i] = value;
+            changedOutputs_.mark(outputSlots_[i]);
         }
     }
-    return 0.0f;
 }
 
 uint32_t LV2Plugin::getNumInputPorts() const {
@@ -732,36 +729,280 @@ uint32_t LV2Plugin::getNumOutputPorts() const {
 }
 
 void LV2Plugin::setFilePath(const std::string& propertyUri, const std::string& path) {
-    std::lock_guard<std::mutex> lock(filePathMutex_);
-    pendingFilePropertyUri_ = propertyUri;
-    pendingFilePath_ = path;
+    // Forge the patch:Set object here, off the audio thread; process() only copies it.
+    // Map the file first: the worker then parses pages that are resident and shared with
+    // every other instance using it (by path or by content), and stay so while selected.
+    SharedFileCache::Ref file = SharedFileCache::instance().acquire(path);
+    {
+        std::lock_guard<std::mutex> lock(fileCacheMutex_);
+        std::swap(fileRefs_[propertyUri], file);
+    }
+    auto& uridMap = getGlobalUridMap();
+    std::vector<uint8_t> buf(path.size() + 128);
+    LV2_Atom_Forge forge;
+    lv2_atom_forge_init(&forge, &globalLv2UridMap);
+    lv2_atom_forge_set_buffer(&forge, buf.data(), buf.size());
+
+    LV2_Atom_Forge_Frame objFrame;
+    LV2_Atom_Forge_Ref ref = lv2_atom_forge_object(&forge, &objFrame, 0,
+                                                   uridMap.map(LV2_PATCH__Set));
+    lv2_atom_forge_key(&forge, uridMap.map(LV2_PATCH__property));
+    lv2_atom_forge_urid(&forge, uridMap.map(propertyUri.c_str()));
+    lv2_atom_forge_key(&forge, uridMap.map(LV2_PATCH__value));
+    ref = ref ? lv2_atom_forge_path(&forge, path.c_str(), path.size() + 1) : 0;
+    lv2_atom_forge_pop(&forge, &objFrame);
+    if (!ref) {
+        LOGE("setFilePath: patch:Set does not fit (%zu byte path)", path.size());
+        return;
+    }
+
+    const auto* atom = reinterpret_cast<const LV2_Atom*>(buf.data());
+    injectAtom(atom, sizeof(LV2_Atom) + atom->size);
     LOGI("setFilePath: property=%s path=%s", propertyUri.c_str(), path.c_str());
 }
 
 void LV2Plugin::injectAtom(const void* data, uint32_t size) {
-    if (!data || size == 0) return;
-    std::vector<uint8_t> buf(size);
-    std::memcpy(buf.data(), data, size);
+    if (!data || size < sizeof(LV2_Atom)) return;
+    // Queue exactly one atom: header plus the body size it declares
+    const uint32_t atomSize = sizeof(LV2_Atom) + static_cast<const LV2_Atom*>(data)->size;
+    if (atomSize > size) {
+        LOGE("injectAtom: atom claims %u bytes, only %u given", atomSize, size);
+        return;
+    }
+    bool queued;
     {
-        std::lock_guard<std::mutex> lock(pendingAtomMutex_);
-        pendingAtoms_.push_back(std::move(buf));
+        std::lock_guard<std::mutex> lock(inputAtomWriteMutex_);
+        queued = inputAtoms_.write(data, atomSize);
     }
-    LOGI("injectAtom: queued %u bytes for atom input port", size);
+    if (!queued) {
+        LOGE("injectAtom: input ring full, dropped %u bytes", atomSize);
+        return;
+    }
+    LOGI("injectAtom: queued %u bytes for atom input port", atomSize);
 }
 
 std::vector<OutputAtomEvent> LV2Plugin::drainOutputAtoms() {
-    std::lock_guard<std::mutex> lock(outputAtomMutex_);
+    std::lock_guard<std::mutex> lock(outputAtomReadMutex_);
     std::vector<OutputAtomEvent> result;
-    result.swap(pendingOutputAtoms_);
+    uint32_t size = 0;
+    while (outputAtoms_.peek(size)) {
+        std::vector<uint8_t> message(size);
+        outputAtoms_.read(message.data(), size, size);
+        if (size < sizeof(uint32_t) + sizeof(LV2_Atom)) continue;
+        OutputAtomEvent event;
+        std::memcpy(&event.portIndex, message.data(), sizeof(uint32_t));
+        event.data.assign(message.begin() + sizeof(uint32_t), message.end());
+        result.push_back(std::move(event));
+    }
     return result;
 }
 
+void LV2Plugin::appendInputAtoms() {
+    LV2_Atom_Sequence* seq = nullptr;
+    for (auto& ap : atomPorts_) {
+        if (ap.isInput) {  // only the first atom input port receives UI messages
+            seq = reinterpret_cast<LV2_Atom_Sequence*>(ap.buffer);
+            break;
+        }
+    }
+    if (!seq) {
+        inputAtoms_.clear();
+        return;
+    }
+
+    // Each message is an LV2_Atom, which is exactly an event body: read it in place.
+    uint32_t size = 0;
+    while (inputAtoms_.peek(size)) {
+        const uint32_t used = sizeof(LV2_Atom) + seq->atom.size;
+        const uint32_t evtBytes = (sizeof(LV2_Atom_Event::time) + size + 7u) & ~7u;
+        const bool empty = seq->atom.size == sizeof(LV2_Atom_Sequence_Body);
+        if (used + evtBytes > kAtomBufferSize && !empty) {
+            break;  // sequence full: deliver the rest next block
+        }
+        auto* evt = reinterpret_cast<LV2_Atom_Event*>(
+            reinterpret_cast<uint8_t*>(&seq->body) + seq->atom.size);
+        const uint32_t room = kAtomBufferSize - used - sizeof(LV2_Atom_Event::time);
+        if (!inputAtoms_.read(&evt->body, room, size)) {
+            RT_TRACE(LOG_TAG, "appendInputAtoms: atom larger than port buffer, dropped", size);
+            continue;
+        }
+        evt->time.frames = 0;
+        seq->atom.size += evtBytes;
+    }
+}
+
+void LV2Plugin::queueOutputAtoms() {
+    for (auto& ap : atomPorts_) {
+        if (ap.isInput) continue;
+        auto* seq = reinterpret_cast<const LV2_Atom_Sequence*>(
+            ap.buffer);
+        // Skip if empty or if the plugin left atom.size at the pre-run
+        // capacity (meaning it didn't write the output sequence at all —
+        // iterating would walk through uninitialised memory).
+        if (seq->atom.size <= sizeof(LV2_Atom_Sequence_Body) ||
+            seq->atom.size >= kAtomBufferSize) continue;
+        const uint8_t* bufEnd = ap.buffer + kAtomBufferSize;
+        LV2_ATOM_SEQUENCE_FOREACH(seq, ev) {
+            // Sanity-check: event body must fit inside the atom buffer
+            const uint32_t atomTotalSize = sizeof(LV2_Atom) + ev->body.size;
+            if (reinterpret_cast<const uint8_t*>(&ev->body) + atomTotalSize > bufEnd) break;
+            if (!outputAtoms_.write(&ap.portIndex, sizeof(ap.portIndex), &ev->body, atomTotalSize)) {
+                RT_TRACE(LOG_TAG, "queueOutputAtoms: output ring full, dropped", atomTotalSize);
+                return;  // UI is not draining; keep later events from reordering
+            }
+        }
+    }
+}
+
+void LV2Plugin::runSegment(const float* const* inputs, float* const* outputs, uint32_t offset,
+                           uint32_t frames, bool first, bool last) {
+    const float* in[2] = {inputs[0] ? inputs[0] + offset : nullptr,
+                          inputs[1] ? inputs[1] + offset : nullptr};
+    float* out[2] = {outputs[0] ? outputs[0] + offset : nullptr,
+                     outputs[1] ? outputs[1] + offset : nullptr};
+    routeAudioPorts(in, out);
+
+    // Reset atom buffers before run()
+    for (auto& ap : atomPorts_) {
+        auto* seq = reinterpret_cast<LV2_Atom_Sequence*>(
+            ap.buffer);
+        seq->atom.type = atom_Sequence_;
+        if (ap.isInput) {
+            // Input: empty sequence (body header only)
+            seq->atom.size = sizeof(LV2_Atom_Sequence_Body);
+        } else {
+            // Output: set atom.size to total buffer capacity so the plugin's
+            // forge knows how much space is available for writing
+            seq->atom.size = kAtomBufferSize;
+        }
+        seq->body.unit = 0;
+        seq->body.pad = 0;
+    }
+
+    // Deliver queued UI messages (DPF state sync, patch:Set file paths, etc.) once per block
+    if (first) {
+        appendInputAtoms();
+    }
+    if (midiNext_ < midiCount_) {
+        appendMidiEvents(offset, last ? UINT32_MAX : offset + frames);
+    }
+
+    lilv_instance_run(instance_, frames);
+
+    // Call end_run if available
+    if (workerInterface_ && workerInterface_->end_run) {
+        workerInterface_->end_run(lilv_instance_get_handle(instance_));
+    }
+
+    // The last segment's output is read after the worker responses, which may add to it
+    if (!last) {
+        queueOutputAtoms();
+    }
+}
+
+void LV2Plugin::appendMidiEvents(uint32_t offset, uint32_t end) {
+    auto* seq = reinterpret_cast<LV2_Atom_Sequence*>(atomPorts_[midiPort_].buffer);
+    // Event time is relative to this run(); events after an earlier segment's UI atoms
+    // (all at frame 0) keep the sequence ordered.
+    constexpr uint32_t evtBytes = (sizeof(LV2_Atom_Event) + sizeof(MidiEvent::data) + 7u) & ~7u;
+    while (midiNext_ < midiCount_ && midiEvents_[midiNext_].frame < end) {
+        const MidiEvent& midi = midiEvents_[midiNext_];
+        if (sizeof(LV2_Atom) + seq->atom.size + evtBytes > kAtomBufferSize) {
+            RT_TRACE(LOG_TAG, "appendMidiEvents: sequence full, dropped", midiCount_ - midiNext_);
+            midiNext_ = midiCount_;
+            return;
+        }
+        auto* evt = reinterpret_cast<LV2_Atom_Event*>(
+            reinterpret_cast<uint8_t*>(&seq->body) + seq->atom.size);
+        evt->time.frames = midi.frame > offset ? midi.frame - offset : 0;
+        evt->body.type = midi_MidiEvent_;
+        evt->body.size = midi.size;
+        std::memcpy(evt + 1, midi.data, midi.size);
+        seq->atom.size += (sizeof(LV2_Atom_Event) + midi.size + 7u) & ~7u;
+        ++midiNext_;
+    }
+}
+
+uint32_t LV2Plugin::collectParamEvents(uint32_t numFrames) {
+    uint32_t count = 0;
+    const uint32_t lastFrame = numFrames > 0 ? numFrames - 1 : 0;
+    // Insertion sort: events nearly always arrive in order, and equal frames keep theirs
+    auto insert = [&](ParamEvent event) {
+        if (event.slot >= controlCount_) return;
+        event.frame = std::min(event.frame, lastFrame);
+        uint32_t i = count++;
+        while (i > 0 && blockEvents_[i - 1].frame > event.frame) {
+            blockEvents_[i] = blockEvents_[i - 1];
+            --i;
+        }
+        blockEvents_[i] = event;
+    };
+    ParamEvent event;
+    while (count < kMaxParamEventsPerBlock && paramEvents_.pop(event)) {
+        insert(event);
+    }
+    // Audio-thread events (MIDI-learned controls) follow the queued ones at equal frames
+    for (uint32_t r = 0; r < rtEventCount_ && count < kMaxParamEventsPerBlock; ++r) {
+        insert(rtEvents_[r]);
+    }
+    rtEventCount_ = 0;
+    return count;
+}
+
+void LV2Plugin::applyParamEvent(const ParamEvent& event) {
+    ParamRamp& ramp = ramps_[event.slot];
+    if ((controlFlags_[event.slot] & kControlSmoothed) && rampFrames_ > 0) {
+        if (ramp.remaining == 0) activeRamps_.push_back(event.slot);  // within reserved capacity
+        ramp.target = event.value;
+        ramp.step = (event.value - controlValues_[event.slot]) / static_cast<float>(rampFrames_);
+        ramp.remaining = rampFrames_;
+    } else {
+        controlValues_[event.slot] = event.value;
+        ramp.remaining = 0;  // advanceRamps() drops it from activeRamps_
+    }
+}
+
+void LV2Plugin::advanceRamps(uint32_t frames) {
+    size_t kept = 0;
+    for (uint32_t slot : activeRamps_) {
+        ParamRamp& ramp = ramps_[slot];
+        if (ramp.remaining == 0) continue;
+        if (ramp.remaining <= frames) {
+            controlValues_[slot] = ramp.target;
+            ramp.remaining = 0;
+            continue;
+        }
+        controlValues_[slot] += ramp.step * static_cast<float>(frames);
+        ramp.remaining -= frames;
+        activeRamps_[kept++] = slot;
+    }
+    activeRamps_.resize(kept);
+}
+
+void LV2Plugin::routeAudioPorts(const float* const* inputs, float* const* outputs) {
+    // Ports beyond the stereo pair, or with no host buffer, keep their internal buffers
+    for (size_t i = 0; i < audioInputPorts_.size(); ++i) {
+        const float* buffer = (i < 2 && inputs[i]) ? inputs[i] : audioInputPorts_[i];
+        if (connectedInputs_[i] != buffer) {
+            lilv_instance_connect_port(instance_, audioInputPortIndices_[i],
+                                       const_cast<float*>(buffer));
+            connectedInputs_[i] = buffer;
+        }
+    }
+    for (size_t i = 0; i < audioOutputPorts_.size(); ++i) {
+        float* buffer = (i < 2 && outputs[i]) ? outputs[i] : audioOutputPorts_[i];
+        if (connectedOutputs_[i] != buffer) {
+            lilv_instance_connect_port(instance_, audioOutputPortIndices_[i], buffer);
+            connectedOutputs_[i] = buffer;
+        }
+    }
+}
+
 void LV2Plugin::connectPorts() {
     if (!instance_ || !plugin_) {
         return;
     }
 
-    uint32_t controlIdx = 0;
     uint32_t audioInputIdx = 0;
     uint32_t audioOutputIdx = 0;
 
@@ -783,16 +1024,16 @@ void LV2Plugin::connectPorts() {
         for (auto& ap : atomPorts_) {
             if (ap.portIndex == i) {
                 lilv_instance_connect_port(instance_, i,
-                    atomPortBuffers_[ap.bufferIdx].data());
+                    ap.buffer);
                 connectedAtom = true;
                 break;
             }
         }
         if (connectedAtom) continue;
 
-        if (isControl && controlIdx < controlPorts_.size()) {
-            lilv_instance_connect_port(instance_, i, controlPorts_[controlIdx].get());
-            controlIdx++;
+        int32_t controlSlot = i < controlSlotByPort_.size() ? controlSlotByPort_[i] : -1;
+        if (isControl && controlSlot >= 0) {
+            lilv_instance_connect_port(instance_, i, &controlValues_[controlSlot]);
         } else if (isAudio && isInput && audioInputIdx < audioInputPorts_.size()) {
             lilv_instance_connect_port(instance_, i, audioInputPorts_[audioInputIdx]);
             audioInputIdx++;
@@ -807,27 +1048,51 @@ void LV2Plugin::connectPorts() {
     lilv_node_free(audioClass);
     lilv_node_free(controlClass);
     lilv_node_free(inputClass);
+
+    connectedInputs_.assign(audioInputPorts_.begin(), audioInputPorts_.end());
+    connectedOutputs_.assign(audioOutputPorts_.begin(), audioOutputPorts_.end());
 }
 
-void LV2Plugin::initializePorts() {
+bool LV2Plugin::initializePorts() {
     if (!plugin_) {
-        return;
+        return false;
     }
 
-    controlPorts_.clear();
+    arena_.reset();
+    controlValues_ = nullptr;
+    controlCount_ = 0;
     controlPortIndices_.clear();
-    audioInputBuffers_.clear();
-    audioOutputBuffers_.clear();
+    controlSlotByPort_.clear();
+    controlTargets_.clear();
+    controlFlags_.clear();
+    midiPort_ = -1;
+    midiCount_ = 0;
     audioInputPorts_.clear();
     audioOutputPorts_.clear();
-    atomPortBuffers_.clear();
+    audioInputPortIndices_.clear();
+    audioOutputPortIndices_.clear();
+    connectedInputs_.clear();
+    connectedOutputs_.clear();
     atomPorts_.clear();
+    qualityControls_.clear();
 
     uint32_t numPorts = lilv_plugin_get_num_ports(plugin_);
+    controlSlotByPort_.assign(numPorts, -1);
     LilvNode* audioClass = lilv_new_uri(world_, LILV_URI_AUDIO_PORT);
     LilvNode* controlClass = lilv_new_uri(world_, LILV_URI_CONTROL_PORT);
     LilvNode* atomClass = lilv_new_uri(world_, LILV_URI_ATOM_PORT);
     LilvNode* inputClass = lilv_new_uri(world_, LILV_URI_INPUT_PORT);
+    LilvNode* midiEvent = lilv_new_uri(world_, LV2_MIDI__MidiEvent);
+    std::vector<float> defaults;
+    // Ports whose values are discrete, or costly to change, jump instead of ramping
+    LilvNode* steppedProps[] = {
+        lilv_new_uri(world_, LV2_CORE__toggled),
+        lilv_new_uri(world_, LV2_CORE__integer),
+        lilv_new_uri(world_, LV2_CORE__enumeration),
+        lilv_new_uri(world_, LV2_PORT_PROPS__trigger),
+        lilv_new_uri(world_, LV2_PORT_PROPS__expensive),
+        lilv_new_uri(world_, LV2_PORT_PROPS__causesArtifacts),
+    };
 
     for (uint32_t i = 0; i < numPorts; ++i) {
         const LilvPort* port = lilv_plugin_get_port_by_index(plugin_, i);
@@ -840,6 +1105,7 @@ void LV2Plugin::initializePorts() {
 
         if (isControl) {
             float defaultVal = 0.0f;
+            float minVal = 0.0f;
             LilvNode* defNode = nullptr;
             LilvNode* minNode = nullptr;
             LilvNode* maxNode = nullptr;
@@ -848,33 +1114,142 @@ void LV2Plugin::initializePorts() {
                 defaultVal = static_cast<float>(lilv_node_as_float(defNode));
                 lilv_node_free(defNode);
             }
-            if (minNode) lilv_node_free(minNode);
+            const bool hasMin = minNode != nullptr;
+            if (minNode) {
+                minVal = static_cast<float>(lilv_node_as_float(minNode));
+                lilv_node_free(minNode);
+            }
             if (maxNode) lilv_node_free(maxNode);
-            controlPorts_.push_back(std::unique_ptr<float>(new float(defaultVal)));
+            uint8_t flags = 0;
+            if (isInput) {
+                if (hasMin && isQualitySymbol(lilv_node_as_string(lilv_port_get_symbol(plugin_, port)))) {
+                    qualityControls_.push_back({i, minVal});
+                }
+                flags = kControlInput | kControlSmoothed;
+                for (const LilvNode* prop : steppedProps) {
+                    if (lilv_port_has_property(plugin_, port, prop)) {
+                        flags = kControlInput;
+                        break;
+                    }
+                }
+            }
+            controlSlotByPort_[i] = static_cast<int32_t>(defaults.size());
+            defaults.push_back(defaultVal);
+            controlFlags_.push_back(flags);
             controlPortIndices_.push_back(i);
         } else if (isAudio) {
             if (isInput) {
-                audioInputBuffers_.emplace_back(kMaxLv2BufferFrames, 0.0f);
-                audioInputPorts_.push_back(audioInputBuffers_.back().data());
+                audioInputPortIndices_.push_back(i);
             } else {
-                audioOutputBuffers_.emplace_back(kMaxLv2BufferFrames, 0.0f);
-                audioOutputPorts_.push_back(audioOutputBuffers_.back().data());
+                audioOutputPortIndices_.push_back(i);
             }
         } else if (isAtom) {
-            size_t bufIdx = atomPortBuffers_.size();
-            atomPortBuffers_.emplace_back(kAtomBufferSize, 0);
-            atomPorts_.push_back({i, isInput, bufIdx});
+            if (isInput && midiPort_ < 0 && lilv_port_supports_event(plugin_, port, midiEvent)) {
+                midiPort_ = static_cast<int32_t>(atomPorts_.size());
+            }
+            atomPorts_.push_back({i, isInput, nullptr});
         }
     }
+    lilv_node_free(midiEvent);
+    controlTargets_ = std::vector<std::atomic<float>>(defaults.size());
+    for (size_t k = 0; k < defaults.size(); ++k) {
+        controlTargets_[k].store(defaults[k], std::memory_order_relaxed);
+    }
+
+    // Lay out the host-side storage in the order a block uses it
+    controlCount_ = defaults.size();
+    const size_t audioBytes = static_cast<size_t>(maxBlockLength_) * sizeof(float);
+    const size_t controlsAt = arena_.reserve(controlCount_ * sizeof(float));
+    std::vector<size_t> atomAt(atomPorts_.size());
+    for (size_t k = 0; k < atomPorts_.size(); ++k) {
+        if (atomPorts_[k].isInput) atomAt[k] = arena_.reserve(kAtomBufferSize);
+    }
+    std::vector<size_t> audioInAt(audioInputPortIndices_.size());
+    for (size_t& at : audioInAt) at = arena_.reserve(audioBytes);
+    std::vector<size_t> audioOutAt(audioOutputPortIndices_.size());
+    for (size_t& at : audioOutAt) at = arena_.reserve(audioBytes);
+    for (size_t k = 0; k < atomPorts_.size(); ++k) {
+        if (!atomPorts_[k].isInput) atomAt[k] = arena_.reserve(kAtomBufferSize);
+    }
+    if (!arena_.allocate()) {
+        LOGE("initializePorts: cannot allocate %zu bytes of port buffers", arena_.reserved());
+        return false;
+    }
+    controlValues_ = arena_.at<float>(controlsAt);
+    std::copy(defaults.begin(), defaults.end(), controlValues_);
+    for (size_t k = 0; k < atomPorts_.size(); ++k) atomPorts_[k].buffer = arena_.at<uint8_t>(atomAt[k]);
+    for (size_t at : audioInAt) audioInputPorts_.push_back(arena_.at<float>(at));
+    for (size_t at : audioOutAt) audioOutputPorts_.push_back(arena_.at<float>(at));
+    if (memoryLocked_.load() && !arena_.lock()) {
+        LOGE("initializePorts: mlock of %zu bytes refused, buffers stay prefaulted", arena_.size());
+    }
 
     lilv_node_free(audioClass);
     lilv_node_free(controlClass);
     lilv_node_free(atomClass);
     lilv_node_free(inputClass);
+    for (LilvNode* prop : steppedProps) lilv_node_free(prop);
+
+    outputSlots_.clear();
+    publishedOutputs_.clear();
+    for (size_t k = 0; k < controlFlags_.size(); ++k) {
+        if (controlFlags_[k] & kControlInput) continue;
+        outputSlots_.push_back(static_cast<uint32_t>(k));
+        publishedOutputs_.push_back(controlValues_[k]);
+    }
+    changedOutputs_.resize(static_cast<uint32_t>(controlCount_));
+
+    // Parameter events: process() is inactive here, so the consumer side can be reset too
+    paramEvents_.clear();
+    ramps_.assign(controlCount_, ParamRamp{});
+    activeRamps_.clear();
+    activeRamps_.reserve(controlCount_);
+    rampFrames_ = static_cast<uint32_t>(sampleRate_ * kSmoothingSeconds);
+    // Plugins that want particular block lengths get whole blocks; their changes apply at the
+    // block start and smoothed ports ramp block by block.
+    splitBlocks_ = true;
+    for (const char* uri : {LV2_BUF_SIZE__fixedBlockLength, LV2_BUF_SIZE__powerOf2BlockLength,
+                            LV2_BUF_SIZE__coarseBlockLength}) {
+        LilvNode* feature = lilv_new_uri(world_, uri);
+        if (lilv_plugin_has_feature(plugin_, feature)) splitBlocks_ = false;
+        lilv_node_free(feature);
+    }
 
-    LOGI("initializePorts: control=%zu audioIn=%zu audioOut=%zu atom=%zu",
-         controlPorts_.size(), audioInputPorts_.size(), audioOutputPorts_.size(),
-         atomPorts_.size());
+    // Required or optional, the feature means input and output must not share a buffer
+    LilvNode* inPlaceBroken = lilv_new_uri(world_, LV2_CORE__inPlaceBroken);
+    inPlaceBroken_ = lilv_plugin_has_feature(plugin_, inPlaceBroken);
+    lilv_node_free(inPlaceBroken);
+
+    LilvNode* strictFloat = lilv_new_uri(world_, kStrictFloatFeature);
+    strictFloat_ = lilv_plugin_has_feature(plugin_, strictFloat);
+    lilv_node_free(strictFloat);
+
+    // Generators make sound from silence, so they are never put to sleep on silent input
+    generator_ = audioInputPorts_.empty();
+    const LilvNode* classUri = lilv_plugin_class_get_uri(lilv_plugin_get_class(plugin_));
+    for (const char* uri : {LV2_CORE__GeneratorPlugin, LV2_CORE__OscillatorPlugin,
+                            LV2_CORE__InstrumentPlugin}) {
+        if (classUri && !std::strcmp(lilv_node_as_uri(classUri), uri)) generator_ = true;
+    }
+
+    // The plugin's own bypass switch; the host bypass follows it (PluginChain::setPluginBypass)
+    LilvNode* inputPort = lilv_new_uri(world_, LILV_URI_INPUT_PORT);
+    LilvNode* enabled = lilv_new_uri(world_, LV2_CORE__enabled);
+    const LilvPort* enabledPort = lilv_plugin_get_port_by_designation(plugin_, inputPort, enabled);
+    enabledPort_ = enabledPort && controlSlotByPort_[lilv_port_get_index(plugin_, enabledPort)] >= 0
+                       ? static_cast<int32_t>(lilv_port_get_index(plugin_, enabledPort))
+                       : -1;
+    lilv_node_free(enabled);
+    lilv_node_free(inputPort);
+    latencySlot_ = lilv_plugin_has_latency(plugin_)
+                       ? controlSlotByPort_[lilv_plugin_get_latency_port_index(plugin_)]
+                       : -1;
+
+    LOGI("initializePorts: control=%zu audioIn=%zu audioOut=%zu atom=%zu inPlace=%d strictFloat=%d quality=%zu arena=%zu",
+         controlCount_, audioInputPorts_.size(), audioOutputPorts_.size(),
+         atomPorts_.size(), inPlaceBroken_ ? 0 : 1, strictFloat_ ? 1 : 0, qualityControls_.size(),
+         arena_.size());
+    return true;
 }
 
 // ---------- State path mapping ----------
@@ -920,6 +1295,34 @@ void LV2Plugin::freePathCallback(LV2_State_Free_Path_Handle /*handle*/, char* pa
     free(path);
 }
 
+const void* LV2Plugin::fileCacheAcquireCallback(GRC_File_Cache_Handle handle, const char* path, size_t* size) {
+    auto* self = static_cast<LV2Plugin*>(handle);
+    if (size) *size = 0;
+    if (!path) return nullptr;
+    SharedFileCache::Ref ref = SharedFileCache::instance().acquire(path);
+    if (!ref) {
+        LOGE("fileCache: cannot map %s", path);
+        return nullptr;
+    }
+    if (size) *size = ref->size();
+    std::lock_guard<std::mutex> lock(self->fileCacheMutex_);
+    self->fileLeases_.push_back(ref);
+    return ref->data();
+}
+
+void LV2Plugin::fileCacheReleaseCallback(GRC_File_Cache_Handle handle, const void* data) {
+    auto* self = static_cast<LV2Plugin*>(handle);
+    SharedFileCache::Ref released;  // unmapped, if last, outside the lock
+    std::lock_guard<std::mutex> lock(self->fileCacheMutex_);
+    for (auto it = self->fileLeases_.begin(); it != self->fileLeases_.end(); ++it) {
+        if ((*it)->data() == data) {
+            released = std::move(*it);
+            self->fileLeases_.erase(it);
+            return;
+        }
+    }
+}
+
 // ---------- State save/restore ----------
 
 PluginState LV2Plugin::saveState() {
@@ -927,14 +1330,14 @@ PluginState LV2Plugin::saveState() {
     if (!plugin_) return state;
 
     // Plugin URI
-    const LilvNode* uri = lilv_plugin_get_uri(plugin_);
-    if (uri) state.pluginUri = lilv_node_as_string(uri);
+    state.pluginUri = info_.id;
 
     // Control port values
-    for (size_t k = 0; k < controlPorts_.size(); ++k) {
-        if (controlPorts_[k] && k < controlPortIndices_.size()) {
-            state.controlPortValues.emplace_back(controlPortIndices_[k], *controlPorts_[k]);
-        }
+    for (size_t k = 0; k < controlCount_; ++k) {
+        state.controlPortValues.emplace_back(
+            controlPortIndices_[k],
+            (controlFlags_[k] & kControlInput) ? controlTargets_[k].load(std::memory_order_relaxed)
+                                               : controlValues_[k]);
     }
 
     // State properties via state:interface
@@ -965,7 +1368,7 @@ PluginState LV2Plugin::saveState() {
         };
 
         const LV2_Feature* stateFeatures[] = {
-            &mapPathFeature_, &freePathFeature_, nullptr
+            &mapPathFeature_, &freePathFeature_, &fileCacheFeature_, nullptr
         };
 
         LV2_Handle lv2Handle = lilv_instance_get_handle(instance_);
@@ -1014,7 +1417,7 @@ bool LV2Plugin::restoreState(const PluginState& state) {
         };
 
         const LV2_Feature* stateFeatures[] = {
-            &mapPathFeature_, &freePathFeature_, nullptr
+            &mapPathFeature_, &freePathFeature_, &fileCacheFeature_, nullptr
         };
 
         LV2_Handle lv2Handle = lilv_instance_get_handle(instance_);
@@ -1042,92 +1445,59 @@ void LV2Plugin::startWorker() {
         return;
     }
 
-    LOGI("Starting worker thread (work=%p work_response=%p end_run=%p)",
+    LOGI("Starting worker (work=%p work_response=%p end_run=%p)",
          (void*)workerInterface_->work,
          (void*)workerInterface_->work_response,
          (void*)workerInterface_->end_run);
 
     workerRunning_.store(true, std::memory_order_release);
-    workerThread_ = std::thread(&LV2Plugin::workerThreadFunc, this);
+    if (!workRequests_.empty()) {
+        SerialWorkerPool::instance().schedule(this);
+    }
 }
 
 void LV2Plugin::stopWorker() {
     if (!workerRunning_.load(std::memory_order_acquire)) return;
 
-    {
-        std::lock_guard<std::mutex> lock(workerMutex_);
-        workerRunning_.store(false, std::memory_order_release);
-    }
-    workerCond_.notify_one();
+    // Whatever run is in flight sees the flag and returns; wait for it to leave the pool.
+    workerRunning_.store(false, std::memory_order_release);
+    SerialWorkerPool::instance().waitIdle(this);
 
-    if (workerThread_.joinable()) {
-        workerThread_.join();
-    }
-
-    // Clear queues
-    {
-        std::lock_guard<std::mutex> lock(workerMutex_);
-        while (!workRequests_.empty()) workRequests_.pop();
-    }
-    {
-        std::lock_guard<std::mutex> lock(responseMutex_);
-        while (!workResponses_.empty()) workResponses_.pop();
-    }
+    // Neither side is running now: drop anything still queued
+    workRequests_.clear();
+    workResponses_.clear();
 
     workerInterface_ = nullptr;
 }
 
-void LV2Plugin::workerThreadFunc() {
-    LOGI("Worker thread started");
-    while (true) {
-        std::vector<uint8_t> data;
-        {
-            std::unique_lock<std::mutex> lock(workerMutex_);
-            workerCond_.wait(lock, [this] {
-                return !workRequests_.empty() ||
-                       !workerRunning_.load(std::memory_order_acquire);
-            });
-
-            if (!workerRunning_.load(std::memory_order_acquire) &&
-                workRequests_.empty()) {
-                break;
-            }
-
-            if (!workRequests_.empty()) {
-                data = std::move(workRequests_.front());
-                workRequests_.pop();
-            }
+void LV2Plugin::runPendingWork() {
+    uint32_t size = 0;
+    while (workerRunning_.load(std::memory_order_acquire) && workRequests_.peek(size)) {
+        if (!workRequests_.read(workBuffer_.data(),
+                                static_cast<uint32_t>(workBuffer_.size()), size)) {
+            LOGE("Worker: dropped %u byte request (larger than ring)", size);
+            continue;
         }
-
-        if (!data.empty() && workerInterface_ && instance_) {
+        if (workerInterface_ && instance_) {
             LV2_Handle handle = lilv_instance_get_handle(instance_);
-            workerInterface_->work(
-                handle,
-                respondCallback,
-                this,
-                static_cast<uint32_t>(data.size()),
-                data.data());
+            SYSTEM_TRACE_SCOPE("LV2 work");
+            workerInterface_->work(handle, respondCallback, this, size, workBuffer_.data());
         }
     }
-    LOGI("Worker thread stopped");
 }
 
 LV2_Worker_Status LV2Plugin::scheduleWorkCallback(
     LV2_Worker_Schedule_Handle handle, uint32_t size, const void* data)
 {
+    // Called from run() on the audio thread: copy into the ring and wake the pool.
+    // Before startWorker() the request waits in the ring.
     auto* self = static_cast<LV2Plugin*>(handle);
-
-    std::vector<uint8_t> buf(size);
-    if (size > 0 && data) {
-        std::memcpy(buf.data(), data, size);
+    if (!self->workRequests_.write(data, size)) {
+        return LV2_WORKER_ERR_NO_SPACE;
     }
-
-    {
-        std::lock_guard<std::mutex> lock(self->workerMutex_);
-        self->workRequests_.push(std::move(buf));
+    if (self->workerRunning_.load(std::memory_order_acquire)) {
+        SerialWorkerPool::instance().schedule(self);
     }
-    self->workerCond_.notify_one();
-
     return LV2_WORKER_SUCCESS;
 }
 
@@ -1135,17 +1505,9 @@ LV2_Worker_Status LV2Plugin::respondCallback(
     LV2_Worker_Respond_Handle handle, uint32_t size, const void* data)
 {
     auto* self = static_cast<LV2Plugin*>(handle);
-
-    std::vector<uint8_t> buf(size);
-    if (size > 0 && data) {
-        std::memcpy(buf.data(), data, size);
-    }
-
-    {
-        std::lock_guard<std::mutex> lock(self->responseMutex_);
-        self->workResponses_.push(std::move(buf));
+    if (!self->workResponses_.write(data, size)) {
+        return LV2_WORKER_ERR_NO_SPACE;
     }
-
     return LV2_WORKER_SUCCESS;
 }
 
@@ -1195,6 +1557,30 @@ void LV2Plugin::setParameter(uint32_t portIndex, float value) {
     // Stub
 }
 
+void LV2Plugin::setParameterAt(uint32_t portIndex, float value, uint32_t frameOffset) {
+    // Stub
+}
+
+void LV2Plugin::setParameterRt(uint32_t portIndex, float value, uint32_t frameOffset) {
+    // Stub
+}
+
+void LV2Plugin::queueMidi(const uint8_t* data, uint32_t size, uint32_t frameOffset) {
+    // Stub
+}
+
+uint32_t LV2Plugin::readOutputControls(float* values, uint32_t capacity) {
+    return 0;
+}
+
+uint32_t LV2Plugin::getLatencyFrames() const {
+    return 0;
+}
+
+bool LV2Plugin::takeChangedOutputs(std::vector<std::pair<uint32_t, float>>& changed) {
+    return false;
+}
+
 float LV2Plugin::getParameter(uint32_t portIndex) const {
     return 0.0f;
 }
@@ -1215,8 +1601,9 @@ void LV2Plugin::connectPorts() {
     // Stub
 }
 
-void LV2Plugin::initializePorts() {
+bool LV2Plugin::initializePorts() {
     // Stub
+    return false;
 }
 
 #endif // HAVE_LV2 == 1
@@ -21,6 +21,12 @@
 #define GUITARRACKCRAFT_LV2_PLUGIN_H
 
 #include "../IPlugin.h"
+#include "../../utils/DirtyPortMask.h"
+#include "../../utils/RtArena.h"
+#include "../../utils/SerialWorkerPool.h"
+#include "../../utils/SharedFileCache.h"
+#include "../../utils/SpscMessageRing.h"
+#include "../../utils/SpscQueue.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -35,10 +41,10 @@
 #include <lv2/patch/patch.h>
 #include <lv2/buf-size/buf-size.h>
 #include <lv2/state/state.h>
+#include "HostFileCache.h"
+#include <map>
 #include <thread>
 #include <mutex>
-#include <condition_variable>
-#include <queue>
 #else
 struct LilvInstance_;
 struct LilvPlugin_;
@@ -51,7 +57,7 @@ namespace guitarrackcraft {
  * LV2 plugin wrapper implementing IPlugin interface.
  * Wraps LilvInstance and handles LV2-specific audio processing.
  */
-class LV2Plugin : public IPlugin {
+class LV2Plugin : public IPlugin, private SerialWorkerPool::Client {
 public:
 #if defined(HAVE_LV2) && HAVE_LV2 == 1
     LV2Plugin(const LilvPlugin* plugin, LilvWorld* world, float sampleRate,
@@ -68,9 +74,28 @@ public:
     void process(const float* const* inputs, float* const* outputs, uint32_t numFrames) override;
     PluginInfo getInfo() const override;
     void setParameter(uint32_t portIndex, float value) override;
+    void setParameterAt(uint32_t portIndex, float value, uint32_t frameOffset) override;
+    void setParameterRt(uint32_t portIndex, float value, uint32_t frameOffset) override;
+    bool hasMidiInput() const override { return midiPort_ >= 0; }
+    void queueMidi(const uint8_t* data, uint32_t size, uint32_t frameOffset) override;
     float getParameter(uint32_t portIndex) const override;
+    uint32_t getNumControlPorts() const override {
+        return static_cast<uint32_t>(controlPortIndices_.size());
+    }
+    uint32_t getControlPortIndex(uint32_t i) const override {
+        return i < controlPortIndices_.size() ? controlPortIndices_[i] : 0;
+    }
+    uint32_t readOutputControls(float* values, uint32_t capacity) override;
+    bool takeChangedOutputs(std::vector<std::pair<uint32_t, float>>& changed) override;
     uint32_t getNumInputPorts() const override;
     uint32_t getNumOutputPorts() const override;
+    bool canProcessInPlace() const override { return !inPlaceBroken_; }
+    bool needsStrictFloat() const override { return strictFloat_; }
+    uint32_t getTailFrames() const override { return generator_ ? kTailInfinite : kTailUnknown; }
+    uint32_t getLatencyFrames() const override;
+    int32_t getEnabledPortIndex() const override { return enabledPort_; }
+    std::vector<QualityControl> getQualityControls() const override { return qualityControls_; }
+    bool setMemoryLocked(bool locked) override;
 
     /** True if the plugin binary loaded and instantiated successfully. */
     bool hasInstance() const { return instance_ != nullptr; }
@@ -100,22 +125,67 @@ private:
     LilvWorld_* world_;
     LilvInstance_* instance_;
 #endif
+    /** Metadata queried once at construction; getInfo() must not touch the shared lilv world. */
+    PluginInfo info_;
     float sampleRate_;
     std::atomic<bool> isActive_{false};
     std::atomic<bool> processing_{false}; // guards instance_ use in process()
 
-    std::vector<std::unique_ptr<float>> controlPorts_;
-    /** Global LV2 port index for each control port (same order as controlPorts_). */
+    /** Host-side port storage, laid out by initializePorts() in the order run() touches it:
+     *  control values, atom inputs, audio inputs, audio outputs, atom outputs.
+     *  Audio buffers hold maxBlockLength_ frames. Reallocated only with a new instance. */
+    RtArena arena_;
+    std::atomic<bool> memoryLocked_{false};  // re-lock arena_ whenever it is reallocated
+    /** Control port values, the arena's first region; the ports are connected into it. */
+    float* controlValues_ = nullptr;
+    size_t controlCount_ = 0;
+    /** Global LV2 port index for each control port (same order as controlValues_). */
     std::vector<uint32_t> controlPortIndices_;
-    std::vector<std::vector<float>> audioInputBuffers_;
-    std::vector<std::vector<float>> audioOutputBuffers_;
+    /** Global LV2 port index -> slot in controlValues_, -1 for non-control ports. */
+    std::vector<int32_t> controlSlotByPort_;
+    /** Last value set per slot, from the control side or setParameterRt(); what getParameter()
+     *  reports for inputs. Sized once per instance in initializePorts(). */
+    std::vector<std::atomic<float>> controlTargets_;
+    enum ControlFlags : uint8_t { kControlInput = 1, kControlSmoothed = 2 };
+    std::vector<uint8_t> controlFlags_;
+    /** Internal buffer per audio port (in arena_), used for ports the host does not feed. */
     std::vector<float*> audioInputPorts_;
     std::vector<float*> audioOutputPorts_;
+    /** LV2 port index of each audio port (same order as audioInputPorts_/audioOutputPorts_). */
+    std::vector<uint32_t> audioInputPortIndices_;
+    std::vector<uint32_t> audioOutputPortIndices_;
+    /** Buffer each audio port is connected to right now. process() connects the ports straight
+     *  to the host's buffers and only calls connect_port again when those buffers move. */
+    std::vector<const float*> connectedInputs_;
+    std::vector<float*> connectedOutputs_;
+    /** Slots of the output control ports, the value process() last compared each against, and
+     *  the slots that differed since the UI last looked. publishedOutputs_ is process() only. */
+    std::vector<uint32_t> outputSlots_;
+    std::vector<float> publishedOutputs_;
+    DirtyPortMask changedOutputs_;
+    /** lv2:inPlaceBroken declared (or ports not yet inspected): never alias input and output. */
+    bool inPlaceBroken_ = true;
+    /** Declares kStrictFloatFeature: run without flush-to-zero. */
+    bool strictFloat_ = false;
+    /** Generator/oscillator/instrument class, or no audio input: output does not follow input. */
+    bool generator_ = false;
+    /** Slot in controlValues_ of the lv2:latency output port, -1 if none. */
+    int32_t latencySlot_ = -1;
+    /** Last value of that port, copied after each run() (audio thread). */
+    uint32_t latencyFrames_ = 0;
+    /** Entry in atomPorts_ of the first atom input that supports midi:MidiEvent, -1 if none. */
+    int32_t midiPort_ = -1;
+    /** Input control port designated lv2:enabled, -1 if none. */
+    int32_t enabledPort_ = -1;
+    /** Input controls named like oversampling/quality settings, with their minimum. */
+    std::vector<QualityControl> qualityControls_;
 
     static constexpr size_t kMaxLv2BufferFrames = 8192;
 
     void connectPorts();
-    void initializePorts();
+    bool initializePorts();
+    /** Flag output control ports whose value moved during this block (RT-safe). */
+    void markChangedOutputs();
 
 #if defined(HAVE_LV2) && HAVE_LV2 == 1
     // Worker extension
@@ -128,45 +198,101 @@ private:
     int32_t maxBlockLength_ = kMaxLv2BufferFrames;
     std::vector<const LV2_Feature*> instanceFeatures_;
 
-    std::thread workerThread_;
-    std::mutex workerMutex_;
-    std::condition_variable workerCond_;
-    std::queue<std::vector<uint8_t>> workRequests_;
-    std::mutex responseMutex_;
-    std::queue<std::vector<uint8_t>> workResponses_;
+    // Worker: requests from run() to the shared SerialWorkerPool, responses back to
+    // process(). Both are preallocated SPSC rings; schedule_work only copies and schedules.
+    // The pool runs this instance's work serially, so LV2 worker ordering holds.
+    static constexpr uint32_t kWorkerRingSize = 32 * 1024;
+    static constexpr int kMaxWorkResponsesPerBlock = 8;
+    SpscMessageRing workRequests_{kWorkerRingSize};
+    SpscMessageRing workResponses_{kWorkerRingSize};
+    std::vector<uint8_t> workBuffer_ = std::vector<uint8_t>(kWorkerRingSize);      // pool thread
+    std::vector<uint8_t> responseBuffer_ = std::vector<uint8_t>(kWorkerRingSize);  // process()
     std::atomic<bool> workerRunning_{false};
 
+    // Control changes from setParameter()/setParameterAt() to process(). Control threads
+    // serialize on paramWriteMutex_; process() drains the queue without locking and splits
+    // run() at event offsets. Smoothed ports ramp to the new value in kRampStepFrames steps.
+    struct ParamEvent {
+        uint32_t slot;   // index into controlValues_
+        uint32_t frame;  // offset into the next block
+        float value;
+    };
+    struct ParamRamp {
+        float target = 0.0f;
+        float step = 0.0f;        // per frame
+        uint32_t remaining = 0;   // frames until target, 0 = idle
+    };
+    static constexpr uint32_t kParamQueueSize = 1024;
+    static constexpr uint32_t kMaxParamEventsPerBlock = 128;
+    static constexpr uint32_t kRampStepFrames = 32;
+    static constexpr uint32_t kMinSegmentFrames = 16;
+    static constexpr float kSmoothingSeconds = 0.01f;
+    SpscQueue<ParamEvent> paramEvents_{kParamQueueSize};
+    std::mutex paramWriteMutex_;
+    ParamEvent blockEvents_[kMaxParamEventsPerBlock]{};  // process() only
+    // setParameterRt() events for the next block, merged by collectParamEvents() (audio thread)
+    ParamEvent rtEvents_[kMaxParamEventsPerBlock]{};
+    uint32_t rtEventCount_ = 0;
+    std::vector<ParamRamp> ramps_;                        // process() only, one per slot
+    std::vector<uint32_t> activeRamps_;                   // reserved to the slot count
+    uint32_t rampFrames_ = 0;
+    /** False if the plugin asks for fixed, power-of-two or coarse block lengths. */
+    bool splitBlocks_ = true;
+
+    /** Pop this block's events into blockEvents_, ordered by frame (RT-safe). */
+    uint32_t collectParamEvents(uint32_t numFrames);
+    void applyParamEvent(const ParamEvent& event);
+    /** Move ramping ports 'frames' further towards their targets. */
+    void advanceRamps(uint32_t frames);
+    /** One run() over [offset, offset + frames) of the host buffers, with atom I/O. */
+    void runSegment(const float* const* inputs, float* const* outputs, uint32_t offset,
+                    uint32_t frames, bool first, bool last);
+
     // Atom port buffers
     static constexpr size_t kAtomBufferSize = 8192;
     struct AtomPortInfo {
         uint32_t portIndex;
         bool isInput;
-        size_t bufferIdx;
+        uint8_t* buffer;  // kAtomBufferSize bytes in arena_
     };
-    std::vector<std::vector<uint8_t>> atomPortBuffers_;
     std::vector<AtomPortInfo> atomPorts_;
 
-    // Atom forge + patch:Set support
-    LV2_Atom_Forge forge_{};
-    LV2_URID atom_Path_ = 0;
-    LV2_URID atom_URID_ = 0;
+    // Atom URIDs, mapped once in buildFeatures()
+    LV2_URID atom_Sequence_ = 0;
     LV2_URID patch_Set_ = 0;
-    LV2_URID patch_Get_ = 0;
     LV2_URID patch_property_ = 0;
     LV2_URID patch_value_ = 0;
 
-    // Pending file path for patch:Set delivery
-    std::string pendingFilePath_;
-    std::string pendingFilePropertyUri_;
-    std::mutex filePathMutex_;
+    // UI -> DSP atoms (injected messages and forged patch:Set), one LV2_Atom per message.
+    // Control threads serialize on inputAtomWriteMutex_; process() reads without locking.
+    static constexpr uint32_t kAtomRingSize = 64 * 1024;
+    SpscMessageRing inputAtoms_{kAtomRingSize};
+    std::mutex inputAtomWriteMutex_;
 
-    // Pending raw atom messages from UI (DPF state sync, etc.)
-    std::mutex pendingAtomMutex_;
-    std::vector<std::vector<uint8_t>> pendingAtoms_;
+    // DSP -> UI atom events, [uint32 port index][LV2_Atom + body] per message.
+    // process() writes without locking; drainOutputAtoms() callers serialize on the mutex.
+    SpscMessageRing outputAtoms_{kAtomRingSize};
+    std::mutex outputAtomReadMutex_;
 
-    // Queued atom output events for UI forwarding (written by process, read by UI thread)
-    std::mutex outputAtomMutex_;
-    std::vector<OutputAtomEvent> pendingOutputAtoms_;
+    /** Append queued input atoms to the first atom input sequence (RT-safe). */
+    void appendInputAtoms();
+
+    // queueMidi() events for the next block, ordered by frame (audio thread only)
+    struct MidiEvent {
+        uint32_t frame;
+        uint8_t size;
+        uint8_t data[3];
+    };
+    static constexpr uint32_t kMaxMidiEventsPerBlock = 256;
+    MidiEvent midiEvents_[kMaxMidiEventsPerBlock]{};
+    uint32_t midiCount_ = 0;
+    uint32_t midiNext_ = 0;  // first event not yet delivered by runSegment()
+    LV2_URID midi_MidiEvent_ = 0;
+    /** Append the MIDI events before frame 'end' to the MIDI input sequence, times relative
+     *  to 'offset' (RT-safe). */
+    void appendMidiEvents(uint32_t offset, uint32_t end);
+    /** Copy the events of the atom output sequences into outputAtoms_ (RT-safe). */
+    void queueOutputAtoms();
 
     // State extension (save/restore)
     const LV2_State_Interface* stateInterface_ = nullptr;
@@ -180,10 +306,26 @@ private:
     static char* mapAbsolutePathCallback(LV2_State_Map_Path_Handle handle, const char* abstractPath);
     static void freePathCallback(LV2_State_Free_Path_Handle handle, char* path);
 
+    // Host file cache (HostFileCache.h). Leases are the mappings handed to the plugin
+    // through the feature; fileRefs_ holds the file last sent by setFilePath() per property,
+    // so every instance loading it parses the same resident pages.
+    GRC_File_Cache fileCacheData_{};
+    LV2_Feature fileCacheFeature_{};
+    std::mutex fileCacheMutex_;
+    std::vector<SharedFileCache::Ref> fileLeases_;
+    std::map<std::string, SharedFileCache::Ref> fileRefs_;
+
+    static const void* fileCacheAcquireCallback(GRC_File_Cache_Handle handle, const char* path, size_t* size);
+    static void fileCacheReleaseCallback(GRC_File_Cache_Handle handle, const void* data);
+
+    /** Point the first two audio inputs/outputs at the host buffers (RT-safe). */
+    void routeAudioPorts(const float* const* inputs, float* const* outputs);
     void buildFeatures();
+    /** Build PluginInfo from lilv. Caller holds lilvWorldMutex(). */
+    PluginInfo queryInfo() const;
     void startWorker();
     void stopWorker();
-    void workerThreadFunc();
+    void runPendingWork() override;
     static LV2_Worker_Status scheduleWorkCallback(
         LV2_Worker_Schedule_Handle handle, uint32_t size, const void* data);
     static LV2_Worker_Status respondCallback(
@@ -20,12 +20,16 @@
 #include "LV2PluginFactory.h"
 #include "LV2Plugin.h"
 #include "LV2Utils.h"
-#include <android/log.h>
-#include <android/asset_manager.h>
-#include <android/asset_manager_jni.h>
+#include "PluginCatalogCache.h"
+#include "../../utils/CpuFeatures.h"
+#include "../../utils/ParallelFor.h"
+#include "../../utils/LogCompat.h"
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstring>
 #include <dirent.h>
+#include <fcntl.h>
 #include <fstream>
 #include <sstream>
 #include <sys/stat.h>
@@ -60,25 +64,152 @@ LV2PluginFactory::~LV2PluginFactory() {
     }
 }
 
+namespace {
+
+constexpr const char* kCatalogFileName = "lv2_catalog.bin";
+/** Dotfile in each bundle marking its binary paths as rewritten; fingerprints ignore it. */
+constexpr const char* kRewriteStampName = ".grc-paths-stamp";
+/** Bump when rewriteBundle() resolves paths differently, to redo every bundle. */
+constexpr uint32_t kRewriteVersion = 2;
+
+/** Bundle directory of a loaded plugin, without trailing slash. */
+std::string bundleDirOf(const LilvPlugin* plugin) {
+    std::string dir = pluginBundlePath(plugin);
+    while (dir.size() > 1 && dir.back() == '/') dir.pop_back();
+    return dir;
+}
+
+/** Metadata of a stale plugin: the lilv facts, read on one thread, and the file checks still to run. */
+struct PendingPlugin {
+    size_t bundle = 0;
+    PluginInfo info;
+    std::string bundlePath;           // as parsed from the bundle URI, for modgui discovery
+    std::vector<std::pair<std::string, UiBinaryRef>> x11Uis;  // UI URI and binary, in TTL order
+};
+
+/** Subdirectories of path, in readdir order. */
+std::vector<std::string> listSubdirectories(const std::string& path) {
+    std::vector<std::string> dirs;
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        LOGE("collectBundles: opendir failed path='%s' errno=%d (%s)", path.c_str(), errno, std::strerror(errno));
+        return dirs;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        std::string fullPath = path + "/" + entry->d_name;
+        struct stat st;
+        if (stat(fullPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+            dirs.push_back(std::move(fullPath));
+        }
+    }
+    closedir(dir);
+    return dirs;
+}
+
+/** Append dir if it is an LV2 bundle (has manifest.ttl), else the bundles below it. */
+void walkBundles(const std::string& dir, std::vector<std::string>& out) {
+    if (access((dir + "/manifest.ttl").c_str(), F_OK) == 0) {
+        out.push_back(dir);
+        return;
+    }
+    // Not a bundle, recurse into subdirectories (e.g., GxPlugins.lv2/)
+    for (const auto& sub : listSubdirectories(dir)) {
+        walkBundles(sub, out);
+    }
+}
+
+/** Start readahead of a bundle's TTL so lilv's serial parse does not wait on flash. */
+void prefetchBundleTtl(const std::string& bundleDir) {
+    DIR* dir = opendir(bundleDir.c_str());
+    if (!dir) return;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        const size_t len = std::strlen(entry->d_name);
+        if (len < 4 || std::strcmp(entry->d_name + len - 4, ".ttl") != 0) continue;
+        const int fd = open((bundleDir + "/" + entry->d_name).c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        close(fd);
+    }
+    closedir(dir);
+}
+
+/** lilv half of PluginInfo construction. Caller holds lilvWorldMutex(). */
+PendingPlugin gatherPlugin(const LilvPlugin* plugin, const LilvNode* x11UiClass) {
+    PendingPlugin pending;
+    PluginInfo& info = pending.info;
+
+    const LilvNode* uri = lilv_plugin_get_uri(plugin);
+    const LilvNode* name = lilv_plugin_get_name(plugin);
+
+    if (uri) {
+        info.id = lilv_node_as_string(uri);
+    }
+    if (name) {
+        info.name = lilv_node_as_string(name);
+    }
+    info.format = "LV2";
+
+    // Get port count for info
+    uint32_t numPorts = lilv_plugin_get_num_ports(plugin);
+    info.ports.reserve(numPorts);
+
+    pending.bundlePath = pluginBundlePath(plugin);
+
+    // X11UI candidates (guiext:X11UI in the TTL); whether the binary exists is checked later
+    LilvUIs* uis = x11UiClass ? lilv_plugin_get_uis(plugin) : nullptr;
+    if (uis) {
+        LILV_FOREACH(uis, u, uis) {
+            const LilvUI* ui = lilv_uis_get(uis, u);
+            if (!lilv_ui_is_a(ui, x11UiClass)) continue;
+            UiBinaryRef ref;
+            if (getUiBinaryRef(ui, plugin, ref)) {
+                pending.x11Uis.emplace_back(lilv_node_as_string(lilv_ui_get_uri(ui)), std::move(ref));
+            }
+        }
+        lilv_uis_free(uis);
+    }
+    return pending;
+}
+
+/** File half of PluginInfo construction; no lilv access, so it runs on any thread. */
+void completePlugin(PendingPlugin& pending) {
+    PluginInfo& info = pending.info;
+
+    // Discover modgui (modgui.ttl + iconTemplate)
+    discoverModguiMetadata(pending.bundlePath, info);
+
+    // Discover X11UI. Always prefer X11 over modgui when both present.
+    for (const auto& candidate : pending.x11Uis) {
+        std::string binaryPath = resolveUiBinaryFile(candidate.second);
+        if (binaryPath.empty()) continue;
+
+        info.hasX11Ui = true;
+        info.x11UiBinaryPath = binaryPath;
+        info.x11UiUri = candidate.first;
+        break;
+    }
+}
+
+} // namespace
+
 bool LV2PluginFactory::initialize() {
     if (initialized_) {
         return true;
     }
 
-    world_ = lilv_world_new();
-    if (!world_) {
-        LOGE("Failed to create LV2 world");
-        return false;
-    }
-    
     // Scan path set by nativeSetLv2Path() (extracted assets), then fallback paths
     LOGI("LV2 scan path: '%s'", lv2Path_.c_str());
     if (!lv2Path_.empty()) {
-        // Create symlinks from bundle dirs to native lib dir before scanning
+        collectBundles(lv2Path_, bundlePaths_);
+        // Point binaries at the native lib dir before anything parses or fingerprints the TTL
         if (!nativeLibDir_.empty()) {
-            rewriteManifestPaths(lv2Path_);
+            rewriteManifestPaths(bundlePaths_);
         }
-        scanPlugins(lv2Path_);
     }
     const char* fallbackPaths[] = {
         "/data/data/com.varcain.guitarrackcraft/files/lv2",
@@ -87,54 +218,218 @@ bool LV2PluginFactory::initialize() {
     };
     for (int i = 0; fallbackPaths[i]; ++i) {
         if (lv2Path_ != fallbackPaths[i]) {
-            scanPlugins(fallbackPaths[i]);
+            collectBundles(fallbackPaths[i], bundlePaths_);
         }
     }
-    
-    // Parse specifications and plugin classes so get_all_plugins() returns discovered plugins
-    lilv_world_load_specifications(world_);
-    lilv_world_load_plugin_classes(world_);
-    
-    // Enumerate all discovered plugins
-    const LilvPlugins* plugins = lilv_world_get_all_plugins(world_);
-    int x11Count = 0, modguiCount = 0;
-    LILV_FOREACH(plugins, i, plugins) {
-        const LilvPlugin* plugin = lilv_plugins_get(plugins, i);
-        PluginInfo info;
-
-        const LilvNode* uri = lilv_plugin_get_uri(plugin);
-        const LilvNode* name = lilv_plugin_get_name(plugin);
 
-        if (uri) {
-            info.id = lilv_node_as_string(uri);
+    // Reuse cached metadata for every bundle whose files are unchanged; only the rest go through lilv
+    PluginCatalogCache catalog;
+    const std::string catalogFile = catalogPath();
+    const uint64_t environmentKey = catalogEnvironmentKey();
+    const bool catalogLoaded = !catalogFile.empty() && catalog.load(catalogFile, environmentKey);
+    const size_t catalogBundles = catalog.bundles().size();
+
+    std::vector<uint64_t> fingerprints(bundlePaths_.size());
+    parallelFor(bundlePaths_.size(), [&](size_t b) {
+        fingerprints[b] = PluginCatalogCache::fingerprintBundle(bundlePaths_[b]);
+    });
+
+    std::vector<PluginCatalogCache::Bundle> entries(bundlePaths_.size());
+    std::vector<size_t> stale;
+    for (size_t b = 0; b < bundlePaths_.size(); ++b) {
+        const uint64_t fingerprint = fingerprints[b];
+        if (const auto* hit = catalog.find(bundlePaths_[b], fingerprint)) {
+            entries[b] = *hit;
+        } else {
+            entries[b].path = bundlePaths_[b];
+            entries[b].fingerprint = fingerprint;
+            stale.push_back(b);
         }
-        if (name) {
-            info.name = lilv_node_as_string(name);
+    }
+
+    bool catalogComplete = true;
+    if (!stale.empty()) {
+        // lilv parses serially; warm the page cache for its TTL reads from all cores first
+        parallelFor(stale.size(), [&](size_t i) { prefetchBundleTtl(bundlePaths_[stale[i]]); });
+
+        std::vector<PendingPlugin> pending;
+        {
+            std::lock_guard<std::recursive_mutex> lock(lilvWorldMutex());
+            if (!ensureWorld()) {
+                return false;
+            }
+            for (size_t b : stale) {
+                loadBundle(bundlePaths_[b]);
+            }
+            // Parse specifications and plugin classes so get_all_plugins() returns discovered plugins
+            lilv_world_load_specifications(world_);
+            lilv_world_load_plugin_classes(world_);
+
+            // Only stale bundles are in the world, so every plugin here belongs to one of them
+            LilvNode* x11UiClass = lilv_new_uri(world_, "http://lv2plug.in/ns/extensions/ui#X11UI");
+            const LilvPlugins* plugins = lilv_world_get_all_plugins(world_);
+            LILV_FOREACH(plugins, i, plugins) {
+                const LilvPlugin* plugin = lilv_plugins_get(plugins, i);
+                pending.push_back(gatherPlugin(plugin, x11UiClass));
+                const std::string dir = bundleDirOf(plugin);
+                size_t owner = entries.size();
+                for (size_t b : stale) {
+                    if (bundlePaths_[b] == dir) {
+                        owner = b;
+                        break;
+                    }
+                }
+                if (owner == entries.size()) {
+                    // Cannot attribute it to a bundle: keep it for this run, but a catalog without it would lose it
+                    LOGE("Plugin bundle '%s' not in scan list; not updating catalog", dir.c_str());
+                    catalogComplete = false;
+                    owner = stale.front();
+                }
+                pending.back().bundle = owner;
+            }
+            if (x11UiClass) {
+                lilv_node_free(x11UiClass);
+            }
         }
-        info.format = "LV2";
 
-        // Get port count for info
-        uint32_t numPorts = lilv_plugin_get_num_ports(plugin);
-        info.ports.reserve(numPorts);
+        // modgui.ttl reads and UI binary checks touch only the filesystem
+        parallelFor(pending.size(), [&](size_t i) { completePlugin(pending[i]); });
+        for (auto& p : pending) {
+            entries[p.bundle].plugins.push_back(std::move(p.info));
+        }
+        for (size_t b : stale) {
+            catalog.put(entries[b]);
+        }
+    }
 
-        // Discover modgui (modgui.ttl + iconTemplate)
-        discoverModgui(plugin, info);
+    catalog.retain(bundlePaths_);
+    if (!catalogFile.empty() && catalogComplete && (!stale.empty() || catalog.bundles().size() != catalogBundles)) {
+        if (!catalog.save(catalogFile, environmentKey)) {
+            LOGE("Failed to write plugin catalog %s: %s", catalogFile.c_str(), strerror(errno));
+        }
+    }
 
-        // Discover X11UI (guiext:X11UI in the TTL). Always prefer X11 over modgui when both present.
-        discoverX11UI(plugin, info);
+    // Same order and duplicate handling as lilv: sorted by URI, first bundle in scan order wins
+    for (size_t b = 0; b < entries.size(); ++b) {
+        if (entries[b].plugins.empty()) {
+            supportBundles_.push_back(b);
+        }
+        for (const auto& info : entries[b].plugins) {
+            pluginBundles_.emplace(info.id, b);
+        }
+        plugins_.insert(plugins_.end(), entries[b].plugins.begin(), entries[b].plugins.end());
+    }
+    std::stable_sort(plugins_.begin(), plugins_.end(),
+                     [](const PluginInfo& a, const PluginInfo& b) { return a.id < b.id; });
+    plugins_.erase(std::unique(plugins_.begin(), plugins_.end(),
+                               [](const PluginInfo& a, const PluginInfo& b) { return a.id == b.id; }),
+                   plugins_.end());
 
+    int x11Count = 0, modguiCount = 0;
+    for (const auto& info : plugins_) {
         if (info.hasX11Ui) x11Count++;
         if (!info.modguiBasePath.empty()) modguiCount++;
-
-        plugins_.push_back(info);
     }
 
     initialized_ = true;
-    LOGI("LV2 plugin factory initialized: %zu plugins found (x11=%d, modgui=%d)",
-         plugins_.size(), x11Count, modguiCount);
+    LOGI("LV2 plugin factory initialized: %zu plugins found (x11=%d, modgui=%d), %zu/%zu bundles from catalog%s",
+         plugins_.size(), x11Count, modguiCount, bundlePaths_.size() - stale.size(), bundlePaths_.size(),
+         catalogLoaded ? "" : " (no valid catalog)");
+    return true;
+}
+
+std::string LV2PluginFactory::catalogPath() const {
+    return filesDir_.empty() ? std::string() : filesDir_ + "/" + kCatalogFileName;
+}
+
+uint64_t LV2PluginFactory::catalogEnvironmentKey() const {
+    // nativeLibDir changes on every app update, which also refreshes resolved UI binary paths
+    uint64_t key = PluginCatalogCache::hashString(std::to_string(PluginCatalogCache::kVersion));
+    key = PluginCatalogCache::hashString(lv2Path_, key);
+    key = PluginCatalogCache::hashString(nativeLibDir_, key);
+    return PluginCatalogCache::hashString(pluginLibDir_, key);
+}
+
+bool LV2PluginFactory::ensureWorld() {
+    if (!world_) {
+        world_ = lilv_world_new();
+        if (!world_) {
+            LOGE("Failed to create LV2 world");
+            return false;
+        }
+    }
     return true;
 }
 
+void LV2PluginFactory::loadBundle(const std::string& bundleDir) {
+    if (!loadedBundles_.insert(bundleDir).second) {
+        return;
+    }
+    // API requires URI with trailing slash
+    std::string pathWithSlash = bundleDir;
+    if (pathWithSlash.back() != '/') {
+        pathWithSlash += '/';
+    }
+    LilvNode* bundleUri = lilv_new_file_uri(world_, nullptr, pathWithSlash.c_str());
+    if (bundleUri) {
+        lilv_world_load_bundle(world_, bundleUri);
+        lilv_node_free(bundleUri);
+    }
+}
+
+void LV2PluginFactory::loadSupportBundles() {
+    if (supportBundlesLoaded_) {
+        return;
+    }
+    for (size_t b : supportBundles_) {
+        loadBundle(bundlePaths_[b]);
+    }
+    // Re-running after initialize() is cheap: lilv skips files it has already loaded
+    lilv_world_load_specifications(world_);
+    lilv_world_load_plugin_classes(world_);
+    supportBundlesLoaded_ = true;
+}
+
+void LV2PluginFactory::loadAllBundles() {
+    if (allBundlesLoaded_) {
+        return;
+    }
+    for (const auto& bundle : bundlePaths_) {
+        loadBundle(bundle);
+    }
+    allBundlesLoaded_ = true;
+    LOGI("LV2 world loaded: %zu bundles", loadedBundles_.size());
+}
+
+const LilvPlugin* LV2PluginFactory::resolvePlugin(const std::string& pluginId) {
+    auto cached = resolvedPlugins_.find(pluginId);
+    if (cached != resolvedPlugins_.end()) {
+        return cached->second;
+    }
+
+    loadSupportBundles();
+    auto owner = pluginBundles_.find(pluginId);
+    if (owner != pluginBundles_.end()) {
+        loadBundle(bundlePaths_[owner->second]);
+    } else {
+        // Not in the catalog (e.g. a bundle the catalog could not attribute): fall back to everything
+        loadAllBundles();
+    }
+
+    LilvNode* uri = lilv_new_uri(world_, pluginId.c_str());
+    if (!uri) {
+        LOGE("Invalid plugin URI: %s", pluginId.c_str());
+        return nullptr;
+    }
+    const LilvPlugin* plugin = lilv_plugins_get_by_uri(lilv_world_get_all_plugins(world_), uri);
+    lilv_node_free(uri);
+    if (plugin) {
+        // Plugins stay valid for the lifetime of the world; bundles are never unloaded
+        resolvedPlugins_.emplace(pluginId, plugin);
+    }
+    return plugin;
+}
+
 std::vector<PluginInfo> LV2PluginFactory::enumeratePlugins() {
     if (!initialized_) {
         return {};
@@ -143,25 +438,21 @@ std::vector<PluginInfo> LV2PluginFactory::enumeratePlugins() {
 }
 
 std::unique_ptr<IPlugin> LV2PluginFactory::createPlugin(const std::string& pluginId) {
-    if (!initialized_ || !world_) {
+    if (!initialized_) {
         return nullptr;
     }
 
-    LilvNode* uri = lilv_new_uri(world_, pluginId.c_str());
-    if (!uri) {
-        LOGE("Invalid plugin URI: %s", pluginId.c_str());
+    std::lock_guard<std::recursive_mutex> lock(lilvWorldMutex());
+    if (!ensureWorld()) {
         return nullptr;
     }
-    
-    const LilvPlugins* plugins = lilv_world_get_all_plugins(world_);
-    const LilvPlugin* plugin = lilv_plugins_get_by_uri(plugins, uri);
-    lilv_node_free(uri);
-    
+
+    const LilvPlugin* plugin = resolvePlugin(pluginId);
     if (!plugin) {
         LOGE("LV2 plugin not found: %s", pluginId.c_str());
         return nullptr;
     }
-    
+
     static constexpr float kDefaultSampleRate = 48000.0f;
     auto lv2Plugin = std::make_unique<LV2Plugin>(plugin, world_, kDefaultSampleRate, filesDir_);
     if (!lv2Plugin->hasInstance()) {
@@ -171,82 +462,23 @@ std::unique_ptr<IPlugin> LV2PluginFactory::createPlugin(const std::string& plugi
     return lv2Plugin;
 }
 
-void LV2PluginFactory::discoverModgui(const LilvPlugin* plugin, PluginInfo& info) {
-    discoverModguiMetadata(plugin, info);
-}
-
-void LV2PluginFactory::discoverX11UI(const LilvPlugin* plugin, PluginInfo& info) {
-    LilvNode* x11UiClass = lilv_new_uri(world_, "http://lv2plug.in/ns/extensions/ui#X11UI");
-    if (!x11UiClass) return;
-
-    LilvUIs* uis = lilv_plugin_get_uis(plugin);
-    if (!uis) {
-        lilv_node_free(x11UiClass);
-        return;
-    }
-
-    LILV_FOREACH(uis, u, uis) {
-        const LilvUI* ui = lilv_uis_get(uis, u);
-        if (!lilv_ui_is_a(ui, x11UiClass)) continue;
-
-        std::string binaryPath = resolveX11UIBinaryPath(ui, plugin, world_);
-        if (binaryPath.empty()) continue;
-
-        info.hasX11Ui = true;
-        info.x11UiBinaryPath = binaryPath;
-        info.x11UiUri = lilv_node_as_string(lilv_ui_get_uri(ui));
-        break;
-    }
-
-    lilv_uis_free(uis);
-    lilv_node_free(x11UiClass);
-}
-
-void LV2PluginFactory::scanPlugins(const std::string& bundlePath) {
-    if (bundlePath.empty() || !world_) {
-        return;
-    }
-
-    DIR* dir = opendir(bundlePath.c_str());
-    if (!dir) {
-        LOGE("scanPlugins: opendir failed path='%s' errno=%d (%s)", bundlePath.c_str(), errno, std::strerror(errno));
+void LV2PluginFactory::collectBundles(const std::string& basePath, std::vector<std::string>& out) {
+    if (basePath.empty()) {
         return;
     }
 
-    int bundleCount = 0;
-    struct dirent* entry;
-    while ((entry = readdir(dir)) != nullptr) {
-        if (entry->d_name[0] == '.') {
-            continue;
-        }
+    // List the top level here and walk the subtrees (e.g. GxPlugins.lv2/) in parallel; results keep readdir order
+    const std::vector<std::string> dirs = listSubdirectories(basePath);
+    std::vector<std::vector<std::string>> found(dirs.size());
+    parallelFor(dirs.size(), [&](size_t i) { walkBundles(dirs[i], found[i]); });
 
-        std::string fullPath = bundlePath + "/" + entry->d_name;
-        struct stat st;
-        if (stat(fullPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
-            // Check if it's an LV2 bundle (has manifest.ttl)
-            std::string manifestPath = fullPath + "/manifest.ttl";
-            if (access(manifestPath.c_str(), F_OK) == 0) {
-                // This is an LV2 bundle - load it (API requires URI with trailing slash)
-                std::string pathWithSlash = fullPath;
-                if (pathWithSlash.back() != '/') {
-                    pathWithSlash += '/';
-                }
-                LilvNode* bundleUri = lilv_new_file_uri(world_, nullptr, pathWithSlash.c_str());
-                if (bundleUri) {
-                    lilv_world_load_bundle(world_, bundleUri);
-                    bundleCount++;
-                    lilv_node_free(bundleUri);
-                }
-            } else {
-                // Not a bundle, recurse into subdirectories (e.g., GxPlugins.lv2/)
-                scanPlugins(fullPath);
-            }
-        }
+    size_t bundleCount = 0;
+    for (auto& bundles : found) {
+        bundleCount += bundles.size();
+        out.insert(out.end(), std::make_move_iterator(bundles.begin()), std::make_move_iterator(bundles.end()));
     }
-
-    closedir(dir);
     if (bundleCount > 0) {
-        LOGI("scanPlugins: loaded %d bundles from %s", bundleCount, bundlePath.c_str());
+        LOGI("collectBundles: found %zu bundles in %s", bundleCount, basePath.c_str());
     }
 }
 
@@ -343,105 +575,129 @@ int LV2PluginFactory::rewriteGuiextBinaryPaths(const std::string& bundleDir) {
     return rewriteCount;
 }
 
-void LV2PluginFactory::rewriteManifestPaths(const std::string& basePath) {
-    DIR* dir = opendir(basePath.c_str());
-    if (!dir) return;
+LV2PluginFactory::RewriteResult LV2PluginFactory::rewriteBundle(const std::string& bundleDir, int& uiRewrites) {
+    // Rewrite manifest.ttl to point lv2:binary to the native lib dir so dlopen uses an exec-permitted path
+    const std::string manifestPath = bundleDir + "/manifest.ttl";
+    FILE* f = fopen(manifestPath.c_str(), "r");
+    if (!f) return RewriteResult::Failed;
+
+    // Read entire manifest
+    std::string content;
+    char buf[1024];
+    while (fgets(buf, sizeof(buf), f)) {
+        content += buf;
+    }
+    fclose(f);
+
+    // Find lv2:binary <soname.so> and replace with absolute path; bundles without one have nothing to do
+    size_t binaryPos = content.find("lv2:binary");
+    if (binaryPos == std::string::npos) return RewriteResult::Unchanged;
+
+    size_t lt = content.find('<', binaryPos);
+    size_t gt = content.find('>', lt != std::string::npos ? lt : 0);
+    if (lt == std::string::npos || gt == std::string::npos) return RewriteResult::Unchanged;
+
+    std::string binaryUri = content.substr(lt + 1, gt - lt - 1);
+    size_t lastSlash = binaryUri.rfind('/');
+    std::string soName = (lastSlash != std::string::npos)
+        ? binaryUri.substr(lastSlash + 1) : binaryUri;
+
+    if (soName.size() <= 3 || soName.substr(soName.size() - 3) != ".so") return RewriteResult::Unchanged;
+
+    // A manifest rewritten on an earlier run names an installed lib<name>[_tier].so outside the
+    // bundle; recover <name>, so the tier is chosen afresh (the stamp key changes with the CPU tier).
+    std::string stem = soName.substr(0, soName.size() - 3);
+    const bool installedLib = binaryUri.compare(0, 7, "file://") == 0 &&
+                              binaryUri.compare(7, lastSlash - 7, bundleDir) != 0;
+    if (installedLib && stem.compare(0, 3, "lib") == 0) stem = stem.substr(3);
+    stem = stripVariantSuffix(stem);
+
+    // Resolve which path to use for lv2:binary: the best CPU-tuned variant present (heavy DSP
+    // plugins ship lib<name>_armv82.so / _armv9.so next to the baseline), and for each name
+    // nativeLibDir (full flavor) → pluginLibDir (PAD extraction) → bundle fallback.
+    std::string binaryUriValue;
+    std::string chosenSuffix;
+    for (const std::string& suffix : CpuFeatures::current().variantSuffixes()) {
+        const std::string name = stem + suffix + ".so";
+        const std::string nativeLibPath = nativeLibDir_ + "/lib" + name;
+        const std::string pluginLibPath = pluginLibDir_.empty() ? std::string() : (pluginLibDir_ + "/lib" + name);
+        const std::string bundleSoPath = bundleDir + "/" + name;
+        if (access(nativeLibPath.c_str(), F_OK) == 0) {
+            binaryUriValue = "file://" + nativeLibPath;
+        } else if (!pluginLibPath.empty() && access(pluginLibPath.c_str(), F_OK) == 0) {
+            binaryUriValue = "file://" + pluginLibPath;
+        } else if (access(bundleSoPath.c_str(), F_OK) == 0) {
+            binaryUriValue = "file://" + bundleSoPath;
+        } else {
+            continue;
+        }
+        chosenSuffix = suffix;
+        break;
+    }
+    if (binaryUriValue.empty()) return RewriteResult::Missing;
+    if (!chosenSuffix.empty()) {
+        LOGI("rewriteBundle: %s uses CPU-tuned %s%s.so", bundleDir.c_str(), stem.c_str(), chosenSuffix.c_str());
+    }
 
-    int rewriteCount = 0;
-    int uiRewriteCount = 0;
-    int missingCount = 0;
-    struct dirent* entry;
-    while ((entry = readdir(dir)) != nullptr) {
-        if (entry->d_name[0] == '.') continue;
+    // Replace ALL occurrences of <soname.so> (multi-plugin bundles share the same binary)
+    std::string oldToken = "<" + binaryUri + ">";
+    std::string newToken = "<" + binaryUriValue + ">";
+    std::string newContent = content;
+    size_t pos = 0;
+    while ((pos = newContent.find(oldToken, pos)) != std::string::npos) {
+        newContent.replace(pos, oldToken.size(), newToken);
+        pos += newToken.size();
+    }
 
-        std::string fullPath = basePath + "/" + entry->d_name;
-        struct stat st;
-        if (stat(fullPath.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) continue;
-
-        std::string manifestPath = fullPath + "/manifest.ttl";
-        if (access(manifestPath.c_str(), F_OK) == 0) {
-            // It's an LV2 bundle - rewrite manifest.ttl to point lv2:binary
-            // to the native lib dir so dlopen uses an exec-permitted path
-            FILE* f = fopen(manifestPath.c_str(), "r");
-            if (!f) continue;
-
-            // Read entire manifest
-            std::string content;
-            char buf[1024];
-            while (fgets(buf, sizeof(buf), f)) {
-                content += buf;
-            }
-            fclose(f);
-
-            // Find lv2:binary <soname.so> and replace with absolute path
-            size_t binaryPos = content.find("lv2:binary");
-            if (binaryPos == std::string::npos) continue;
-
-            size_t lt = content.find('<', binaryPos);
-            size_t gt = content.find('>', lt != std::string::npos ? lt : 0);
-            if (lt == std::string::npos || gt == std::string::npos) continue;
-
-            std::string binaryUri = content.substr(lt + 1, gt - lt - 1);
-            size_t lastSlash = binaryUri.rfind('/');
-            std::string soName = (lastSlash != std::string::npos)
-                ? binaryUri.substr(lastSlash + 1) : binaryUri;
-
-            if (soName.size() <= 3 || soName.substr(soName.size() - 3) != ".so") continue;
-
-            std::string nativeLibPath = nativeLibDir_ + "/lib" + soName;
-            std::string pluginLibPath = pluginLibDir_.empty() ? std::string() : (pluginLibDir_ + "/lib" + soName);
-            std::string bundleSoPath = fullPath + "/" + soName;
-
-            // Resolve which path to use for lv2:binary.
-            // Search order: nativeLibDir (full flavor) → pluginLibDir (PAD extraction) → bundle fallback
-            std::string binaryUriValue;
-            bool haveInLibDir = (access(nativeLibPath.c_str(), F_OK) == 0);
-            bool haveInPluginDir = (!pluginLibPath.empty() && access(pluginLibPath.c_str(), F_OK) == 0);
-            bool haveInBundle = (access(bundleSoPath.c_str(), F_OK) == 0);
-
-            if (haveInLibDir) {
-                binaryUriValue = "file://" + nativeLibPath;
-            } else if (haveInPluginDir) {
-                binaryUriValue = "file://" + pluginLibPath;
-            } else if (haveInBundle) {
-                binaryUriValue = "file://" + bundleSoPath;
-            } else {
-                missingCount++;
-                continue;
-            }
+    // Also rewrite guiext:binary in all .ttl files in this bundle
+    const int uiCount = rewriteGuiextBinaryPaths(bundleDir);
+    uiRewrites += uiCount;
 
-            // Replace ALL occurrences of <soname.so> (multi-plugin bundles share the same binary)
-            std::string oldToken = "<" + binaryUri + ">";
-            std::string newToken = "<" + binaryUriValue + ">";
-            std::string newContent = content;
-            size_t pos = 0;
-            while ((pos = newContent.find(oldToken, pos)) != std::string::npos) {
-                newContent.replace(pos, oldToken.size(), newToken);
-                pos += newToken.size();
-            }
+    // Already pointing at the resolved path: leave the file (and its mtime) untouched
+    if (newContent == content) {
+        return uiCount > 0 ? RewriteResult::Rewritten : RewriteResult::Unchanged;
+    }
 
-            // Write back
-            FILE* fw = fopen(manifestPath.c_str(), "w");
-            if (fw) {
-                fwrite(newContent.c_str(), 1, newContent.size(), fw);
-                fclose(fw);
-                rewriteCount++;
-            } else {
-                LOGE("Failed to rewrite manifest: %s: %s", manifestPath.c_str(), strerror(errno));
-            }
+    // Write back
+    FILE* fw = fopen(manifestPath.c_str(), "w");
+    if (!fw) {
+        LOGE("Failed to rewrite manifest: %s: %s", manifestPath.c_str(), strerror(errno));
+        return RewriteResult::Failed;
+    }
+    fwrite(newContent.c_str(), 1, newContent.size(), fw);
+    fclose(fw);
+    return RewriteResult::Rewritten;
+}
 
-            // Also rewrite guiext:binary in all .ttl files in this bundle
-            uiRewriteCount += rewriteGuiextBinaryPaths(fullPath);
-        } else {
-            // Not a bundle, recurse (e.g. GxPlugins.lv2/)
-            rewriteManifestPaths(fullPath);
+void LV2PluginFactory::rewriteManifestPaths(const std::vector<std::string>& bundleDirs) {
+    // A bundle is done once per library location (changes with every app update) and file contents
+    // (changes with every asset extraction); only bundles missing their binary are retried each start
+    uint64_t stampKey = PluginCatalogCache::hashString(std::to_string(kRewriteVersion));
+    stampKey = PluginCatalogCache::hashString(nativeLibDir_, stampKey);
+    stampKey = PluginCatalogCache::hashString(pluginLibDir_, stampKey);
+    stampKey = PluginCatalogCache::hashString(CpuFeatures::current().bestSuffix(), stampKey);
+
+    std::atomic<int> rewriteCount{0}, uiRewriteCount{0}, missingCount{0}, stampedCount{0};
+    parallelFor(bundleDirs.size(), [&](size_t i) {
+        const std::string& bundleDir = bundleDirs[i];
+        if (PluginCatalogCache::bundleStampMatches(bundleDir, kRewriteStampName, stampKey)) {
+            stampedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
         }
-    }
-    closedir(dir);
-    if (rewriteCount > 0 || missingCount > 0) {
-        LOGI("rewriteManifestPaths: %d manifests rewritten, %d UI binaries rewritten, %d missing (%s)",
-             rewriteCount, uiRewriteCount, missingCount, basePath.c_str());
-    }
+        int uiRewrites = 0;
+        const RewriteResult result = rewriteBundle(bundleDir, uiRewrites);
+        uiRewriteCount.fetch_add(uiRewrites, std::memory_order_relaxed);
+        if (result == RewriteResult::Missing) {
+            missingCount.fetch_add(1, std::memory_order_relaxed);
+        } else if (result != RewriteResult::Failed) {
+            if (result == RewriteResult::Rewritten) rewriteCount.fetch_add(1, std::memory_order_relaxed);
+            if (!PluginCatalogCache::writeBundleStamp(bundleDir, kRewriteStampName, stampKey)) {
+                LOGE("Failed to write rewrite stamp in %s", bundleDir.c_str());
+            }
+        }
+    });
+    LOGI("rewriteManifestPaths: %d bundles rewritten, %d UI binaries rewritten, %d missing, %d up to date (of %zu)",
+         rewriteCount.load(), uiRewriteCount.load(), missingCount.load(), stampedCount.load(), bundleDirs.size());
 }
 
 #else // HAVE_LV2 not defined or == 0 - stub implementation
@@ -472,11 +728,11 @@ std::unique_ptr<IPlugin> LV2PluginFactory::createPlugin(const std::string& plugi
     return nullptr;
 }
 
-void LV2PluginFactory::scanPlugins(const std::string& bundlePath) {
+void LV2PluginFactory::collectBundles(const std::string& /*basePath*/, std::vector<std::string>& /*out*/) {
     // Stub
 }
 
-void LV2PluginFactory::rewriteManifestPaths(const std::string& basePath) {
+void LV2PluginFactory::rewriteManifestPaths(const std::vector<std::string>& /*bundleDirs*/) {
     // Stub
 }
 
@@ -21,9 +21,11 @@
 #define GUITARRACKCRAFT_LV2_PLUGIN_FACTORY_H
 
 #include "../IPluginFactory.h"
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
-#include <memory>
 
 #if defined(HAVE_LV2) && HAVE_LV2 == 1
 #include <lilv/lilv.h>
@@ -36,6 +38,11 @@ namespace guitarrackcraft {
 /**
  * Factory for creating LV2 plugins.
  * Scans for LV2 plugins in assets/lv2/ directory.
+ *
+ * Plugin metadata is served from a persistent catalog (PluginCatalogCache) in filesDir, so
+ * startup only parses bundles that changed since the last run. The lilv world is created on
+ * the first createPlugin(), and each createPlugin() loads only the bundle that defines the
+ * requested URI (plus, once, the bundles that define no plugins: specifications, presets).
  */
 class LV2PluginFactory : public IPluginFactory {
 public:
@@ -57,23 +64,47 @@ public:
 private:
 #if defined(HAVE_LV2) && HAVE_LV2 == 1
     LilvWorld* world_;
-    void scanPlugins(const std::string& bundlePath);
-    void rewriteManifestPaths(const std::string& bundlePath);
+    /** Create the world if needed. Caller holds lilvWorldMutex(). */
+    bool ensureWorld();
+    /** Load one bundle directory into the world (once). Caller holds lilvWorldMutex(). */
+    void loadBundle(const std::string& bundleDir);
+    /** Load the plugin-less bundles, then specifications and plugin classes. Caller holds lilvWorldMutex(). */
+    void loadSupportBundles();
+    /** Load every discovered bundle not loaded yet. Caller holds lilvWorldMutex(). */
+    void loadAllBundles();
+    /** Find a plugin in the world, loading its bundle on demand. Caller holds lilvWorldMutex(). */
+    const LilvPlugin* resolvePlugin(const std::string& pluginId);
+    std::string catalogPath() const;
+    uint64_t catalogEnvironmentKey() const;
+    enum class RewriteResult { Rewritten, Unchanged, Missing, Failed };
+    /** Rewrite binary paths of every bundle whose stamp is stale, in parallel; stamps the ones that resolved. */
+    void rewriteManifestPaths(const std::vector<std::string>& bundleDirs);
+    /** Point lv2:binary (and UI binaries) of one bundle at the native lib dir. Thread-safe. */
+    RewriteResult rewriteBundle(const std::string& bundleDir, int& uiRewrites);
     int rewriteGuiextBinaryPaths(const std::string& bundleDir);
-    /** If modgui.ttl exists for this plugin, set info.modguiBasePath and info.modguiIconTemplate. */
-    void discoverModgui(const LilvPlugin* plugin, PluginInfo& info);
-    /** If the TTL declares a guiext:X11UI, fill info.hasX11Ui / x11UiBinaryPath / x11UiUri. */
-    void discoverX11UI(const LilvPlugin* plugin, PluginInfo& info);
 #else
     LilvWorld_* world_;
-    void scanPlugins(const std::string& bundlePath);
-    void rewriteManifestPaths(const std::string& bundlePath);
+    void rewriteManifestPaths(const std::vector<std::string>& bundleDirs);
 #endif
+    /** Append every bundle directory (has manifest.ttl) under basePath to out; filesystem only, walked in parallel. */
+    void collectBundles(const std::string& basePath, std::vector<std::string>& out);
     std::string lv2Path_;
     std::string nativeLibDir_;
     std::string filesDir_;
     std::string pluginLibDir_;
     std::vector<PluginInfo> plugins_;
+    std::vector<std::string> bundlePaths_;
+#if defined(HAVE_LV2) && HAVE_LV2 == 1
+    /** Plugin URI -> index into bundlePaths_ of the bundle that defines it. */
+    std::unordered_map<std::string, size_t> pluginBundles_;
+    /** Bundles that define no plugins (specifications, presets); loaded with the first plugin. */
+    std::vector<size_t> supportBundles_;
+    // World state below is guarded by lilvWorldMutex()
+    std::unordered_map<std::string, const LilvPlugin*> resolvedPlugins_;
+    std::unordered_set<std::string> loadedBundles_;
+    bool supportBundlesLoaded_ = false;
+    bool allBundlesLoaded_ = false;
+#endif
     bool initialized_;
 };
 
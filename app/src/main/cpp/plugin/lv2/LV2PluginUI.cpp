@@ -217,6 +217,7 @@ static const char* LV2_PATCH__Set        = "http://lv2plug.in/ns/ext/patch#Set";
 static const char* LV2_PATCH__property   = "http://lv2plug.in/ns/ext/patch#property";
 static const char* LV2_PATCH__value      = "http://lv2plug.in/ns/ext/patch#value";
 static const char* LV2_ATOM__Object      = "http://lv2plug.in/ns/ext/atom#Object";
+static const char* LV2_ATOM__Blank       = "http://lv2plug.in/ns/ext/atom#Blank";
 static const char* LV2_ATOM__URID        = "http://lv2plug.in/ns/ext/atom#URID";
 static const char* LV2_ATOM__Path        = "http://lv2plug.in/ns/ext/atom#Path";
 static const char* LV2_ATOM__eventTransfer = "http://lv2plug.in/ns/ext/atom#eventTransfer";
@@ -647,9 +648,19 @@ bool LV2PluginUI::instantiate(
         }
     }
 
+    auto& uridMap = getUIUridMap();
+    patchSetUrids_.atomObject = uridMap.map(LV2_ATOM__Object);
+    patchSetUrids_.atomBlank = uridMap.map(LV2_ATOM__Blank);
+    patchSetUrids_.patchSet = uridMap.map(LV2_PATCH__Set);
+    patchSetUrids_.patchProperty = uridMap.map(LV2_PATCH__property);
+
     /* --- Send initial port values to the UI ---------------------- */
     IPlugin* pluginPtr = plugin_.load(std::memory_order_acquire);
     if (pluginPtr) {
+        // Clear the changes so far: the values read below already include them
+        changedOutputs_.clear();
+        pluginPtr->takeChangedOutputs(changedOutputs_);
+        changedOutputs_.clear();
         PluginInfo info = pluginPtr->getInfo();
         int portEventCount = 0;
         for (const auto& port : info.ports) {
@@ -659,7 +670,7 @@ bool LV2PluginUI::instantiate(
                 portEventCount++;
                 if (!port.isInput) {
                     outputControlPorts_.push_back(port.index);
-                    lastOutputValues_[port.index] = val;
+                    lastOutputValues_.push_back(val);
                 }
             }
         }
@@ -696,6 +707,7 @@ void LV2PluginUI::cleanup() {
     resizeFn_ = nullptr;
     outputControlPorts_.clear();
     lastOutputValues_.clear();
+    changedOutputs_.clear();
 
     if (requestValueData_) {
         delete static_cast<LV2UI_Request_Value*>(requestValueData_);
@@ -765,7 +777,7 @@ void LV2PluginUI::portEventAtom(uint32_t portIndex, uint32_t size, const void* d
 }
 
 /* ------------------------------------------------------------------ */
-/* syncOutputPorts — poll output control ports and push to UI         */
+/* syncOutputPorts — push changed output ports and atoms to the UI   */
 /* ------------------------------------------------------------------ */
 void LV2PluginUI::syncOutputPorts(std::shared_mutex* chainMutex) {
     // Take a shared lock on the chain mutex to prevent reorder from
@@ -778,17 +790,24 @@ void LV2PluginUI::syncOutputPorts(std::shared_mutex* chainMutex) {
 
     IPlugin* p = plugin_.load(std::memory_order_acquire);
     if (!p || !isValid()) return;
-    for (uint32_t portIndex : outputControlPorts_) {
-        float val = p->getParameter(portIndex);
-        auto it = lastOutputValues_.find(portIndex);
-        if (it == lastOutputValues_.end() || it->second != val) {
-            lastOutputValues_[portIndex] = val;
-            portEvent(portIndex, val);
+    changedOutputs_.clear();
+    if (p->takeChangedOutputs(changedOutputs_)) {
+        for (const auto& change : changedOutputs_) {
+            portEvent(change.first, change.second);
+        }
+    } else {
+        for (size_t i = 0; i < outputControlPorts_.size(); ++i) {
+            float val = p->getParameter(outputControlPorts_[i]);
+            if (lastOutputValues_[i] != val) {
+                lastOutputValues_[i] = val;
+                portEvent(outputControlPorts_[i], val);
+            }
         }
     }
 
-    // Forward atom output events from DSP to UI
+    // Forward atom output events from DSP to UI; only the last patch:Set per property counts
     auto atoms = p->drainOutputAtoms();
+    coalesceOutputAtoms(atoms, patchSetUrids_);
     for (auto& atom : atoms) {
         portEventAtom(atom.portIndex, static_cast<uint32_t>(atom.data.size()), atom.data.data());
     }
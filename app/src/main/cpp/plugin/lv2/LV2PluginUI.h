@@ -21,6 +21,7 @@
 #define GUITARRACKCRAFT_LV2_PLUGIN_UI_H
 
 #include "../IPlugin.h"
+#include "../UIUpdateScheduler.h"
 #include <string>
 #include <functional>
 #include <memory>
@@ -108,7 +109,8 @@ public:
      *  @param data      Raw atom data */
     void portEventAtom(uint32_t portIndex, uint32_t size, const void* data);
 
-    /** Poll output control ports and push changed values to the UI.
+    /** Push the output control ports the DSP marked as changed, and this tick's atom events
+     *  (superseded patch:Set events dropped), to the UI.
      *  @param chainMutex If non-null, takes a shared_lock to prevent reorder during reads. */
     void syncOutputPorts(std::shared_mutex* chainMutex = nullptr);
 
@@ -162,9 +164,12 @@ private:
     // Cached resize function pointer (extension_data result)
     int (*resizeFn_)(void* handle, int w, int h) = nullptr;
 
-    // Output control port tracking for syncOutputPorts()
+    // Output control port tracking for syncOutputPorts(). The plugin normally reports what
+    // changed; plugins that do not are polled against lastOutputValues_.
     std::vector<uint32_t> outputControlPorts_;         // LV2 port indices of control outputs
-    std::unordered_map<uint32_t, float> lastOutputValues_;  // last sent value per port index
+    std::vector<float> lastOutputValues_;              // last sent value, same order
+    std::vector<std::pair<uint32_t, float>> changedOutputs_;  // reused every tick
+    PatchSetUrids patchSetUrids_;
 
     // Heap-allocated LV2UI_Request_Value data (must outlive instantiate() since
     // the plugin stores a pointer to it via the LV2 feature array)
@@ -19,7 +19,7 @@
 
 #include "LV2Utils.h"
 #include "../IPlugin.h"
-#include <android/log.h>
+#include "../../utils/LogCompat.h"
 #include <cstring>
 #include <fstream>
 #include <sstream>
@@ -30,63 +30,31 @@
 
 namespace guitarrackcraft {
 
-#if defined(HAVE_LV2) && HAVE_LV2 == 1
-
-std::string resolveX11UIBinaryPath(const LilvUI* ui, const LilvPlugin* plugin, LilvWorld* world) {
-    const LilvNode* binaryUri = lilv_ui_get_binary_uri(ui);
-    if (!binaryUri) return {};
-
-    const char* uriStr = lilv_node_as_string(binaryUri);
-    char* parsedPath = lilv_file_uri_parse(uriStr, nullptr);
-    std::string result;
-
-    if (parsedPath && access(parsedPath, F_OK) == 0) {
-        result = parsedPath;
-    } else {
-        if (parsedPath) lilv_free(parsedPath);
-        parsedPath = nullptr;
-
-        // Try bundle root: use UI bundle URI first, then plugin bundle URI
-        const LilvNode* bundleUriNode = lilv_ui_get_bundle_uri(ui);
-        if (!bundleUriNode) {
-            bundleUriNode = lilv_plugin_get_bundle_uri(plugin);
-        }
-        if (bundleUriNode) {
-            char* bundlePathStr = lilv_file_uri_parse(lilv_node_as_string(bundleUriNode), nullptr);
-            if (bundlePathStr) {
-                std::string bundleStr(bundlePathStr);
-                lilv_free(bundlePathStr);
-                if (!bundleStr.empty() && bundleStr.back() == '/') bundleStr.pop_back();
-                const char* lastSlash = strrchr(uriStr, '/');
-                const char* filename = lastSlash ? (lastSlash + 1) : uriStr;
-                std::string fallback = bundleStr + "/" + filename;
-                if (access(fallback.c_str(), F_OK) == 0) {
-                    result = fallback;
-                }
-            }
+std::string resolveUiBinaryFile(const UiBinaryRef& ref) {
+    if (!ref.parsedPath.empty() && access(ref.parsedPath.c_str(), F_OK) == 0) {
+        return ref.parsedPath;
+    }
+    // Try bundle root + the file name from the URI
+    if (!ref.bundleDir.empty()) {
+        const size_t lastSlash = ref.uri.rfind('/');
+        const std::string filename = lastSlash != std::string::npos ? ref.uri.substr(lastSlash + 1) : ref.uri;
+        std::string fallback = ref.bundleDir + "/" + filename;
+        if (access(fallback.c_str(), F_OK) == 0) {
+            return fallback;
         }
     }
-    if (parsedPath) lilv_free(parsedPath);
-    return result;
+    return {};
 }
 
-bool discoverModguiMetadata(const LilvPlugin* plugin, PluginInfo& info) {
-    const LilvNode* bundleUriNode = lilv_plugin_get_bundle_uri(plugin);
-    if (!bundleUriNode) return false;
-    const char* bundleUri = lilv_node_as_string(bundleUriNode);
-    if (!bundleUri) return false;
-    char* bundlePath = lilv_file_uri_parse(bundleUri, nullptr);
-    if (!bundlePath) return false;
-
-    std::string bundleStr(bundlePath);
-    std::string modguiTtlPath = bundleStr + "/modgui.ttl";
+bool discoverModguiMetadata(const std::string& bundlePath, PluginInfo& info) {
+    if (bundlePath.empty()) return false;
+    std::string modguiTtlPath = bundlePath + "/modgui.ttl";
     std::ifstream f(modguiTtlPath);
     if (!f.good()) {
         // Some bundles use "modguis.ttl" (e.g. gx_redeye, gx_vibe, gxautowah)
-        modguiTtlPath = bundleStr + "/modguis.ttl";
+        modguiTtlPath = bundlePath + "/modguis.ttl";
         f.open(modguiTtlPath);
         if (!f.good()) {
-            lilv_free(bundlePath);
             return false;
         }
     }
@@ -97,7 +65,6 @@ bool discoverModguiMetadata(const LilvPlugin* plugin, PluginInfo& info) {
 
     size_t idPos = content.find(info.id);
     if (content.empty() || idPos == std::string::npos) {
-        lilv_free(bundlePath);
         return false;
     }
 
@@ -105,29 +72,73 @@ bool discoverModguiMetadata(const LilvPlugin* plugin, PluginInfo& info) {
     const std::string key = "modgui:iconTemplate";
     size_t keyPos = content.find(key, idPos);
     if (keyPos == std::string::npos) {
-        lilv_free(bundlePath);
         return false;
     }
     size_t openAngle = content.find('<', keyPos);
     if (openAngle == std::string::npos) {
-        lilv_free(bundlePath);
         return false;
     }
     size_t closeAngle = content.find('>', openAngle);
     if (closeAngle == std::string::npos) {
-        lilv_free(bundlePath);
         return false;
     }
     info.modguiIconTemplate = content.substr(openAngle + 1, closeAngle - openAngle - 1);
     if (info.modguiIconTemplate.empty()) {
-        lilv_free(bundlePath);
         return false;
     }
     info.modguiBasePath = bundlePath;
-    lilv_free(bundlePath);
     return true;
 }
 
+#if defined(HAVE_LV2) && HAVE_LV2 == 1
+
+namespace {
+
+std::string parseFileUri(const LilvNode* node) {
+    if (!node) return {};
+    char* path = lilv_file_uri_parse(lilv_node_as_string(node), nullptr);
+    if (!path) return {};
+    std::string result(path);
+    lilv_free(path);
+    return result;
+}
+
+} // namespace
+
+bool getUiBinaryRef(const LilvUI* ui, const LilvPlugin* plugin, UiBinaryRef& ref) {
+    const LilvNode* binaryUri = lilv_ui_get_binary_uri(ui);
+    if (!binaryUri) return false;
+    ref.uri = lilv_node_as_string(binaryUri);
+    ref.parsedPath = parseFileUri(binaryUri);
+
+    // Fallback root: use UI bundle URI first, then plugin bundle URI
+    const LilvNode* bundleUriNode = lilv_ui_get_bundle_uri(ui);
+    if (!bundleUriNode) {
+        bundleUriNode = lilv_plugin_get_bundle_uri(plugin);
+    }
+    ref.bundleDir = parseFileUri(bundleUriNode);
+    if (!ref.bundleDir.empty() && ref.bundleDir.back() == '/') ref.bundleDir.pop_back();
+    return true;
+}
+
+std::string resolveX11UIBinaryPath(const LilvUI* ui, const LilvPlugin* plugin, LilvWorld* /*world*/) {
+    UiBinaryRef ref;
+    return getUiBinaryRef(ui, plugin, ref) ? resolveUiBinaryFile(ref) : std::string();
+}
+
+std::string pluginBundlePath(const LilvPlugin* plugin) {
+    return parseFileUri(lilv_plugin_get_bundle_uri(plugin));
+}
+
+bool discoverModguiMetadata(const LilvPlugin* plugin, PluginInfo& info) {
+    return discoverModguiMetadata(pluginBundlePath(plugin), info);
+}
+
+std::recursive_mutex& lilvWorldMutex() {
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
 #endif
 
 } // namespace guitarrackcraft
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <string>
 
 #if defined(HAVE_LV2) && HAVE_LV2 == 1
@@ -27,18 +28,44 @@
 
 namespace guitarrackcraft {
 
+struct PluginInfo;
+
+/** Where a UI's binary should be, as read from the TTL. */
+struct UiBinaryRef {
+    std::string uri;         // ui:binary as written
+    std::string parsedPath;  // uri as a file path, empty if not a file URI
+    std::string bundleDir;   // UI bundle (else plugin bundle), no trailing slash
+};
+
+/** Filesystem half of resolveX11UIBinaryPath: parsedPath if it exists, else bundleDir + the
+ *  URI's file name if that exists, else empty. No lilv access; safe on any thread. */
+std::string resolveUiBinaryFile(const UiBinaryRef& ref);
+
+/** Filesystem half of discoverModguiMetadata for a bundle directory (as parsed from its URI).
+ *  No lilv access; safe on any thread. */
+bool discoverModguiMetadata(const std::string& bundlePath, PluginInfo& info);
+
 #if defined(HAVE_LV2) && HAVE_LV2 == 1
 
+/** Read the binary reference of a lilv UI entry. Returns false if the UI has no binary. */
+bool getUiBinaryRef(const LilvUI* ui, const LilvPlugin* plugin, UiBinaryRef& ref);
+
 /** Resolve the X11 UI binary path from a lilv UI entry.
  *  Tries the parsed file URI first, then falls back to bundle root + filename.
  *  Returns empty string if binary not found on disk. */
 std::string resolveX11UIBinaryPath(const LilvUI* ui, const LilvPlugin* plugin, LilvWorld* world);
 
+/** Bundle directory of a plugin as parsed from its bundle URI (keeps the trailing slash). */
+std::string pluginBundlePath(const LilvPlugin* plugin);
+
 /** Discover modgui metadata (iconTemplate + basePath) from a plugin's bundle.
  *  Returns true if modgui was found and info fields were populated. */
-struct PluginInfo;
 bool discoverModguiMetadata(const LilvPlugin* plugin, PluginInfo& info);
 
+/** lilv is not thread-safe: every query or load on the shared world holds this.
+ *  Recursive so plugin construction can run under the factory's lock. */
+std::recursive_mutex& lilvWorldMutex();
+
 #endif
 
 } // namespace guitarrackcraft
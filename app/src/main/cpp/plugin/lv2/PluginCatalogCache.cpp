@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PluginCatalogCache.h"
+#include "../PluginInfoCodec.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace guitarrackcraft {
+
+namespace {
+
+constexpr char kMagic[8] = {'G', 'R', 'C', 'P', 'L', 'U', 'G', 'C'};
+
+} // namespace
+
+uint64_t PluginCatalogCache::hashString(const std::string& s, uint64_t seed) {
+    const uint64_t h = fnv1a64(s.data(), s.size(), seed);
+    const uint8_t terminator = 0;  // so ("ab", "c") and ("a", "bc") differ
+    return fnv1a64(&terminator, 1, h);
+}
+
+uint64_t PluginCatalogCache::fingerprintBundle(const std::string& bundleDir) {
+    DIR* dir = opendir(bundleDir.c_str());
+    if (!dir) return 0;
+    struct FileStamp {
+        std::string name;
+        uint64_t size;
+        int64_t mtimeNs;
+    };
+    std::vector<FileStamp> files;
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') continue;
+        struct stat st;
+        const std::string full = bundleDir + "/" + entry->d_name;
+        if (stat(full.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) continue;
+        files.push_back({entry->d_name, static_cast<uint64_t>(st.st_size),
+                         static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec});
+    }
+    closedir(dir);
+    std::sort(files.begin(), files.end(), [](const FileStamp& a, const FileStamp& b) { return a.name < b.name; });
+
+    uint64_t h = kFnvOffset;
+    for (const auto& f : files) {
+        h = hashString(f.name, h);
+        h = fnv1a64(&f.size, sizeof(f.size), h);
+        h = fnv1a64(&f.mtimeNs, sizeof(f.mtimeNs), h);
+    }
+    return h == 0 ? 1 : h;  // 0 is reserved for "unreadable"
+}
+
+bool PluginCatalogCache::bundleStampMatches(const std::string& bundleDir, const char* stampName, uint64_t key) {
+    FILE* f = std::fopen((bundleDir + "/" + stampName).c_str(), "rb");
+    if (!f) return false;
+    uint64_t stored[2] = {};
+    const bool read = std::fread(stored, sizeof(stored), 1, f) == 1;
+    std::fclose(f);
+    return read && stored[0] == key && stored[1] == fingerprintBundle(bundleDir);
+}
+
+bool PluginCatalogCache::writeBundleStamp(const std::string& bundleDir, const char* stampName, uint64_t key) {
+    const uint64_t stamp[2] = {key, fingerprintBundle(bundleDir)};
+    if (stamp[1] == 0) return false;
+    FILE* f = std::fopen((bundleDir + "/" + stampName).c_str(), "wb");
+    if (!f) return false;
+    const bool written = std::fwrite(stamp, sizeof(stamp), 1, f) == 1;
+    return std::fclose(f) == 0 && written;
+}
+
+const PluginCatalogCache::Bundle* PluginCatalogCache::find(const std::string& path, uint64_t fingerprint) const {
+    for (const auto& b : bundles_) {
+        if (b.path == path) return b.fingerprint == fingerprint && fingerprint != 0 ? &b : nullptr;
+    }
+    return nullptr;
+}
+
+void PluginCatalogCache::put(Bundle bundle) {
+    for (auto& b : bundles_) {
+        if (b.path == bundle.path) {
+            b = std::move(bundle);
+            return;
+        }
+    }
+    bundles_.push_back(std::move(bundle));
+}
+
+void PluginCatalogCache::retain(const std::vector<std::string>& keep) {
+    bundles_.erase(std::remove_if(bundles_.begin(), bundles_.end(),
+                                  [&](const Bundle& b) {
+                                      return std::find(keep.begin(), keep.end(), b.path) == keep.end();
+                                  }),
+                   bundles_.end());
+}
+
+bool PluginCatalogCache::load(const std::string& path, uint64_t environmentKey) {
+    bundles_.clear();
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(kMagic) + 4 + 8 + 4 + 8) return false;
+    const uint8_t* bytes = file.data();
+    const size_t size = file.size();
+
+    // Trailing checksum over everything before it catches truncated or torn files
+    ByteReader tail(bytes + size - 8, 8);
+    bool ok = tail.u64() == fnv1a64(bytes, size - 8, kFnvOffset);
+
+    ByteReader r(bytes, size - 8);
+    char magic[sizeof(kMagic)];
+    ok = ok && r.take(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+    ok = ok && r.u32() == kVersion && r.u64() == environmentKey;
+    if (ok) {
+        const uint32_t count = r.count(16);
+        bundles_.resize(count);
+        for (auto& b : bundles_) {
+            b.path = r.str();
+            b.fingerprint = r.u64();
+            const uint32_t plugins = r.count(kMinPluginRecordBytes);
+            b.plugins.reserve(plugins);
+            for (uint32_t i = 0; i < plugins && r.ok; ++i) b.plugins.push_back(readPluginInfo(r));
+        }
+        ok = r.ok && r.remaining() == 0;
+    }
+    if (!ok) bundles_.clear();
+    return ok;
+}
+
+bool PluginCatalogCache::save(const std::string& path, uint64_t environmentKey) const {
+    ByteWriter w;
+    w.bytes(kMagic, sizeof(kMagic));
+    w.u32(kVersion);
+    w.u64(environmentKey);
+    w.u32(static_cast<uint32_t>(bundles_.size()));
+    for (const auto& b : bundles_) {
+        w.str(b.path);
+        w.u64(b.fingerprint);
+        w.u32(static_cast<uint32_t>(b.plugins.size()));
+        for (const auto& p : b.plugins) writePluginInfo(w, p);
+    }
+    w.u64(fnv1a64(w.out.data(), w.out.size(), kFnvOffset));
+    return writeFileAtomically(path, w.out);
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUITARRACKCRAFT_PLUGIN_CATALOG_CACHE_H
+#define GUITARRACKCRAFT_PLUGIN_CATALOG_CACHE_H
+
+#include "../IPlugin.h"
+#include "../../utils/ByteCodec.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Persistent catalog of plugin metadata per LV2 bundle, so startup can skip parsing
+ * TTL through lilv for every bundle that has not changed since the last run.
+ *
+ * Each bundle is keyed by its directory path and a fingerprint of the files in it
+ * (names, sizes and modification times); a changed fingerprint invalidates only that
+ * bundle. The whole file is additionally keyed by an environment key (format version,
+ * scan paths, native library dirs): anything that changes how bundles resolve makes
+ * every entry stale. The file is memory-mapped and parsed in one pass on load, and
+ * written to a temporary file and renamed into place on save.
+ */
+class PluginCatalogCache {
+public:
+    struct Bundle {
+        std::string path;          // bundle directory, no trailing slash
+        uint64_t fingerprint = 0;
+        std::vector<PluginInfo> plugins;
+    };
+
+    /** Bump when the layout or anything that feeds PluginInfo changes. */
+    static constexpr uint32_t kVersion = 1;
+
+    /**
+     * Replace the contents with the cache at path.
+     * @return false (and leaves the cache empty) if missing, corrupt, or written for another version/environment
+     */
+    bool load(const std::string& path, uint64_t environmentKey);
+    bool save(const std::string& path, uint64_t environmentKey) const;
+
+    /** The cached entry for a bundle if its fingerprint still matches, else nullptr. */
+    const Bundle* find(const std::string& path, uint64_t fingerprint) const;
+
+    /** Insert or replace a bundle entry. */
+    void put(Bundle bundle);
+
+    /** Drop entries whose path is not in keep. */
+    void retain(const std::vector<std::string>& keep);
+
+    const std::vector<Bundle>& bundles() const { return bundles_; }
+    void clear() { bundles_.clear(); }
+
+    /**
+     * Fingerprint of a bundle directory: FNV-1a over the sorted names, sizes and mtimes of
+     * its regular files. 0 if it cannot be read.
+     */
+    static uint64_t fingerprintBundle(const std::string& bundleDir);
+
+    /**
+     * Stamp file (a dotfile, so fingerprintBundle ignores it) recording that a one-time step
+     * ran on a bundle with the given key. It matches only while the key is the same and the
+     * bundle's files are unchanged since writeBundleStamp().
+     */
+    static bool bundleStampMatches(const std::string& bundleDir, const char* stampName, uint64_t key);
+    static bool writeBundleStamp(const std::string& bundleDir, const char* stampName, uint64_t key);
+
+    /** FNV-1a of a string, chaining from seed; used to build environment keys. */
+    static uint64_t hashString(const std::string& s, uint64_t seed = kFnvOffset);
+
+    static constexpr uint64_t kFnvOffset = kFnv1aOffset;
+
+private:
+    std::vector<Bundle> bundles_;
+};
+
+} // namespace guitarrackcraft
+
+#endif // GUITARRACKCRAFT_PLUGIN_CATALOG_CACHE_H
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace guitarrackcraft {
+
+/**
+ * Streaming sink for interleaved float audio, fed from a writer thread (never the audio
+ * callback). Implementations batch their own I/O; checkpoint() leaves a playable file.
+ */
+class AudioFileWriter {
+public:
+    virtual ~AudioFileWriter() = default;
+
+    /** Append interleaved samples; a trailing partial frame is carried into the next call. */
+    virtual bool writeSamples(const float* interleaved, size_t samples) = 0;
+
+    /** Make everything complete so far durable and valid on disk. */
+    virtual bool checkpoint() = 0;
+
+    /** Finish the file; safe to call twice. */
+    virtual bool close() = 0;
+
+    virtual bool isOpen() const = 0;
+    virtual size_t framesWritten() const = 0;
+};
+
+} // namespace guitarrackcraft
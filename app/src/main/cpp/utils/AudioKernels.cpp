@@ -0,0 +1,378 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AudioKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define GRC_KERNELS_NEON 1
+#endif
+
+namespace guitarrackcraft {
+namespace kernels {
+
+namespace scalar {
+
+float peakAbs(const float* x, size_t n) {
+    float peak = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        const float s = std::fabs(x[i]);
+        peak = s > peak ? s : peak;
+    }
+    return peak;
+}
+
+float peakAbsStereo(const float* l, const float* r, size_t n) {
+    float peakL = 0.0f;
+    float peakR = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        const float sl = std::fabs(l[i]);
+        const float sr = std::fabs(r[i]);
+        peakL = sl > peakL ? sl : peakL;
+        peakR = sr > peakR ? sr : peakR;
+    }
+    return peakL > peakR ? peakL : peakR;
+}
+
+float interleaveStereoPeak(const float* l, const float* r, float* out, size_t n) {
+    float peakL = 0.0f;
+    float peakR = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        const float sl = l[i];
+        const float sr = r[i];
+        out[i * 2] = sl;
+        out[i * 2 + 1] = sr;
+        peakL = std::fabs(sl) > peakL ? std::fabs(sl) : peakL;
+        peakR = std::fabs(sr) > peakR ? std::fabs(sr) : peakR;
+    }
+    return peakL > peakR ? peakL : peakR;
+}
+
+float mixToMonoPeak(const float* l, const float* r, float* out, size_t n) {
+    float peakL = 0.0f;
+    float peakR = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        const float sl = l[i];
+        const float sr = r[i];
+        out[i] = (sl + sr) * 0.5f;
+        peakL = std::fabs(sl) > peakL ? std::fabs(sl) : peakL;
+        peakR = std::fabs(sr) > peakR ? std::fabs(sr) : peakR;
+    }
+    return peakL > peakR ? peakL : peakR;
+}
+
+void deinterleaveStereo(const float* in, float* l, float* r, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        l[i] = in[i * 2];
+        r[i] = in[i * 2 + 1];
+    }
+}
+
+void applyGain(float* x, size_t n, float gain) {
+    for (size_t i = 0; i < n; ++i) x[i] *= gain;
+}
+
+void copyWithGain(float* dst, const float* src, size_t n, float gain) {
+    for (size_t i = 0; i < n; ++i) dst[i] = src[i] * gain;
+}
+
+void mixInto(float* dst, const float* src, size_t n, float gain) {
+    for (size_t i = 0; i < n; ++i) dst[i] += src[i] * gain;
+}
+
+void pcm16ToFloat(const uint8_t* src, float* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i, src += 2) {
+        const int16_t v = static_cast<int16_t>(src[0] | (src[1] << 8));
+        dst[i] = v * (1.0f / 32768.0f);
+    }
+}
+
+void pcm24ToFloat(const uint8_t* src, float* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i, src += 3) {
+        const uint32_t u = (static_cast<uint32_t>(src[0]) << 8) | (static_cast<uint32_t>(src[1]) << 16) |
+                           (static_cast<uint32_t>(src[2]) << 24);
+        dst[i] = static_cast<float>(static_cast<int32_t>(u) >> 8) * (1.0f / 8388608.0f);
+    }
+}
+
+void pcm32ToFloat(const uint8_t* src, float* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i, src += 4) {
+        const uint32_t u = static_cast<uint32_t>(src[0]) | (static_cast<uint32_t>(src[1]) << 8) |
+                           (static_cast<uint32_t>(src[2]) << 16) | (static_cast<uint32_t>(src[3]) << 24);
+        dst[i] = static_cast<float>(static_cast<int32_t>(u)) * (1.0f / 2147483648.0f);
+    }
+}
+
+void floatToPcm16(const float* src, uint8_t* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i, dst += 2) {
+        const float clamped = std::max(-1.0f, std::min(1.0f, src[i]));
+        const auto v = static_cast<uint16_t>(static_cast<int16_t>(clamped * 32767.0f));
+        dst[0] = static_cast<uint8_t>(v);
+        dst[1] = static_cast<uint8_t>(v >> 8);
+    }
+}
+
+void floatToPcm24(const float* src, uint8_t* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i, dst += 3) {
+        const float clamped = std::max(-1.0f, std::min(1.0f, src[i]));
+        const auto v = static_cast<uint32_t>(static_cast<int32_t>(clamped * 8388607.0f));
+        dst[0] = static_cast<uint8_t>(v);
+        dst[1] = static_cast<uint8_t>(v >> 8);
+        dst[2] = static_cast<uint8_t>(v >> 16);
+    }
+}
+
+} // namespace scalar
+
+// Host byte order is little-endian on every target we build for, so float data is a plain copy.
+void float32ToFloat(const uint8_t* src, float* dst, size_t n) {
+    std::memcpy(dst, src, n * sizeof(float));
+}
+
+#if GRC_KERNELS_NEON
+
+namespace {
+
+inline float horizontalMax(float32x4_t v) {
+#if defined(__aarch64__)
+    return vmaxvq_f32(v);
+#else
+    float32x2_t m = vmax_f32(vget_low_f32(v), vget_high_f32(v));
+    m = vpmax_f32(m, m);
+    return vget_lane_f32(m, 0);
+#endif
+}
+
+inline float tailPeak(float peak, const float* x, size_t i, size_t n) {
+    for (; i < n; ++i) peak = std::fabs(x[i]) > peak ? std::fabs(x[i]) : peak;
+    return peak;
+}
+
+} // namespace
+
+float peakAbs(const float* x, size_t n) {
+    size_t i = 0;
+    float32x4_t m0 = vdupq_n_f32(0.0f);
+    float32x4_t m1 = m0;
+    // Two accumulators hide the vmax latency
+    for (; i + 8 <= n; i += 8) {
+        m0 = vmaxq_f32(m0, vabsq_f32(vld1q_f32(x + i)));
+        m1 = vmaxq_f32(m1, vabsq_f32(vld1q_f32(x + i + 4)));
+    }
+    for (; i + 4 <= n; i += 4) m0 = vmaxq_f32(m0, vabsq_f32(vld1q_f32(x + i)));
+    return tailPeak(horizontalMax(vmaxq_f32(m0, m1)), x, i, n);
+}
+
+float peakAbsStereo(const float* l, const float* r, size_t n) {
+    size_t i = 0;
+    float32x4_t ml = vdupq_n_f32(0.0f);
+    float32x4_t mr = ml;
+    for (; i + 4 <= n; i += 4) {
+        ml = vmaxq_f32(ml, vabsq_f32(vld1q_f32(l + i)));
+        mr = vmaxq_f32(mr, vabsq_f32(vld1q_f32(r + i)));
+    }
+    const float peak = horizontalMax(vmaxq_f32(ml, mr));
+    return tailPeak(tailPeak(peak, l, i, n), r, i, n);
+}
+
+float interleaveStereoPeak(const float* l, const float* r, float* out, size_t n) {
+    size_t i = 0;
+    float32x4_t ml = vdupq_n_f32(0.0f);
+    float32x4_t mr = ml;
+    for (; i + 4 <= n; i += 4) {
+        float32x4x2_t lr;
+        lr.val[0] = vld1q_f32(l + i);
+        lr.val[1] = vld1q_f32(r + i);
+        ml = vmaxq_f32(ml, vabsq_f32(lr.val[0]));
+        mr = vmaxq_f32(mr, vabsq_f32(lr.val[1]));
+        vst2q_f32(out + i * 2, lr);
+    }
+    float peak = horizontalMax(vmaxq_f32(ml, mr));
+    const size_t tail = i;
+    for (; i < n; ++i) {
+        out[i * 2] = l[i];
+        out[i * 2 + 1] = r[i];
+    }
+    peak = tailPeak(tailPeak(peak, l, tail, n), r, tail, n);
+    return peak;
+}
+
+float mixToMonoPeak(const float* l, const float* r, float* out, size_t n) {
+    size_t i = 0;
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    float32x4_t ml = vdupq_n_f32(0.0f);
+    float32x4_t mr = ml;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t vl = vld1q_f32(l + i);
+        const float32x4_t vr = vld1q_f32(r + i);
+        ml = vmaxq_f32(ml, vabsq_f32(vl));
+        mr = vmaxq_f32(mr, vabsq_f32(vr));
+        vst1q_f32(out + i, vmulq_f32(vaddq_f32(vl, vr), half));
+    }
+    float peak = horizontalMax(vmaxq_f32(ml, mr));
+    const size_t tail = i;
+    for (; i < n; ++i) {
+        out[i] = (l[i] + r[i]) * 0.5f;
+    }
+    peak = tailPeak(tailPeak(peak, l, tail, n), r, tail, n);
+    return peak;
+}
+
+void deinterleaveStereo(const float* in, float* l, float* r, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4x2_t lr = vld2q_f32(in + i * 2);
+        vst1q_f32(l + i, lr.val[0]);
+        vst1q_f32(r + i, lr.val[1]);
+    }
+    for (; i < n; ++i) {
+        l[i] = in[i * 2];
+        r[i] = in[i * 2 + 1];
+    }
+}
+
+void applyGain(float* x, size_t n, float gain) {
+    size_t i = 0;
+    const float32x4_t g = vdupq_n_f32(gain);
+    for (; i + 4 <= n; i += 4) vst1q_f32(x + i, vmulq_f32(vld1q_f32(x + i), g));
+    for (; i < n; ++i) x[i] *= gain;
+}
+
+void copyWithGain(float* dst, const float* src, size_t n, float gain) {
+    size_t i = 0;
+    const float32x4_t g = vdupq_n_f32(gain);
+    for (; i + 4 <= n; i += 4) vst1q_f32(dst + i, vmulq_f32(vld1q_f32(src + i), g));
+    for (; i < n; ++i) dst[i] = src[i] * gain;
+}
+
+void mixInto(float* dst, const float* src, size_t n, float gain) {
+    size_t i = 0;
+    const float32x4_t g = vdupq_n_f32(gain);
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), g));
+    }
+    for (; i < n; ++i) dst[i] += src[i] * gain;
+}
+
+void pcm16ToFloat(const uint8_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    const float32x4_t scale = vdupq_n_f32(1.0f / 32768.0f);
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t v = vreinterpretq_s16_u8(vld1q_u8(src + i * 2));
+        vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+        vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+    }
+    scalar::pcm16ToFloat(src + i * 2, dst + i, n - i);
+}
+
+void pcm24ToFloat(const uint8_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    const float32x4_t scale = vdupq_n_f32(1.0f / 8388608.0f);
+    for (; i + 8 <= n; i += 8) {
+        // De-interleave the three bytes of 8 samples and rebuild each one in the top 24
+        // bits of a 32-bit lane; the arithmetic shift back down sign-extends it.
+        const uint8x8x3_t b = vld3_u8(src + i * 3);
+        const uint16x8_t lo = vshll_n_u8(b.val[0], 8);
+        const uint16x8_t hi = vorrq_u16(vmovl_u8(b.val[1]), vshll_n_u8(b.val[2], 8));
+        const uint32x4_t w0 = vorrq_u32(vshll_n_u16(vget_low_u16(hi), 16), vmovl_u16(vget_low_u16(lo)));
+        const uint32x4_t w1 = vorrq_u32(vshll_n_u16(vget_high_u16(hi), 16), vmovl_u16(vget_high_u16(lo)));
+        vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vshrq_n_s32(vreinterpretq_s32_u32(w0), 8)), scale));
+        vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(vshrq_n_s32(vreinterpretq_s32_u32(w1), 8)), scale));
+    }
+    scalar::pcm24ToFloat(src + i * 3, dst + i, n - i);
+}
+
+void pcm32ToFloat(const uint8_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    const float32x4_t scale = vdupq_n_f32(1.0f / 2147483648.0f);
+    for (; i + 4 <= n; i += 4) {
+        const int32x4_t v = vreinterpretq_s32_u8(vld1q_u8(src + i * 4));
+        vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(v), scale));
+    }
+    scalar::pcm32ToFloat(src + i * 4, dst + i, n - i);
+}
+
+void floatToPcm16(const float* src, uint8_t* dst, size_t n) {
+    size_t i = 0;
+    const float32x4_t lo = vdupq_n_f32(-1.0f);
+    const float32x4_t hi = vdupq_n_f32(1.0f);
+    const float32x4_t scale = vdupq_n_f32(32767.0f);
+    for (; i + 8 <= n; i += 8) {
+        const float32x4_t a = vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(src + i), lo), hi), scale);
+        const float32x4_t b = vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(src + i + 4), lo), hi), scale);
+        const int16x8_t v = vcombine_s16(vmovn_s32(vcvtq_s32_f32(a)), vmovn_s32(vcvtq_s32_f32(b)));
+        vst1q_u8(dst + i * 2, vreinterpretq_u8_s16(v));
+    }
+    scalar::floatToPcm16(src + i, dst + i * 2, n - i);
+}
+
+void floatToPcm24(const float* src, uint8_t* dst, size_t n) {
+    size_t i = 0;
+    const float32x4_t lo = vdupq_n_f32(-1.0f);
+    const float32x4_t hi = vdupq_n_f32(1.0f);
+    const float32x4_t scale = vdupq_n_f32(8388607.0f);
+    for (; i + 8 <= n; i += 8) {
+        const float32x4_t a = vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(src + i), lo), hi), scale);
+        const float32x4_t b = vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(src + i + 4), lo), hi), scale);
+        const uint32x4_t w0 = vreinterpretq_u32_s32(vcvtq_s32_f32(a));
+        const uint32x4_t w1 = vreinterpretq_u32_s32(vcvtq_s32_f32(b));
+        // Split the low three bytes of each lane into planes and interleave them on store.
+        const uint16x8_t low16 = vcombine_u16(vmovn_u32(w0), vmovn_u32(w1));
+        const uint16x8_t high16 = vcombine_u16(vshrn_n_u32(w0, 16), vshrn_n_u32(w1, 16));
+        uint8x8x3_t bytes;
+        bytes.val[0] = vmovn_u16(low16);
+        bytes.val[1] = vshrn_n_u16(low16, 8);
+        bytes.val[2] = vmovn_u16(high16);
+        vst3_u8(dst + i * 3, bytes);
+    }
+    scalar::floatToPcm24(src + i, dst + i * 3, n - i);
+}
+
+#else
+
+float peakAbs(const float* x, size_t n) { return scalar::peakAbs(x, n); }
+float peakAbsStereo(const float* l, const float* r, size_t n) { return scalar::peakAbsStereo(l, r, n); }
+float interleaveStereoPeak(const float* l, const float* r, float* out, size_t n) {
+    return scalar::interleaveStereoPeak(l, r, out, n);
+}
+float mixToMonoPeak(const float* l, const float* r, float* out, size_t n) {
+    return scalar::mixToMonoPeak(l, r, out, n);
+}
+void deinterleaveStereo(const float* in, float* l, float* r, size_t n) {
+    scalar::deinterleaveStereo(in, l, r, n);
+}
+void applyGain(float* x, size_t n, float gain) { scalar::applyGain(x, n, gain); }
+void copyWithGain(float* dst, const float* src, size_t n, float gain) {
+    scalar::copyWithGain(dst, src, n, gain);
+}
+void mixInto(float* dst, const float* src, size_t n, float gain) { scalar::mixInto(dst, src, n, gain); }
+void pcm16ToFloat(const uint8_t* src, float* dst, size_t n) { scalar::pcm16ToFloat(src, dst, n); }
+void pcm24ToFloat(const uint8_t* src, float* dst, size_t n) { scalar::pcm24ToFloat(src, dst, n); }
+void pcm32ToFloat(const uint8_t* src, float* dst, size_t n) { scalar::pcm32ToFloat(src, dst, n); }
+void floatToPcm16(const float* src, uint8_t* dst, size_t n) { scalar::floatToPcm16(src, dst, n); }
+void floatToPcm24(const float* src, uint8_t* dst, size_t n) { scalar::floatToPcm24(src, dst, n); }
+
+#endif // GRC_KERNELS_NEON
+
+} // namespace kernels
+} // namespace guitarrackcraft
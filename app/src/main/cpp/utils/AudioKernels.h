@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace guitarrackcraft {
+namespace kernels {
+
+/**
+ * Block kernels for the audio callback. The NEON versions work on 4 floats at a time, keep
+ * running maxima in registers, and reduce once at the end, so each buffer is read once.
+ * Each kernel that writes also returns the peak of its input, so metering costs no extra
+ * pass. A buffer clipped if and only if its peak is >= the threshold.
+ * Any alignment and length are OK; tails are handled scalar.
+ */
+
+/** max |x[i]| */
+float peakAbs(const float* x, size_t n);
+
+/** max(|l[i]|, |r[i]|) */
+float peakAbsStereo(const float* l, const float* r, size_t n);
+
+/** out[2i] = l[i], out[2i+1] = r[i]; returns max(|l|, |r|). */
+float interleaveStereoPeak(const float* l, const float* r, float* out, size_t n);
+
+/** out[i] = (l[i] + r[i]) * 0.5; returns max(|l|, |r|) (the pre-mix peak, as metered). */
+float mixToMonoPeak(const float* l, const float* r, float* out, size_t n);
+
+/** l[i] = in[2i], r[i] = in[2i+1] */
+void deinterleaveStereo(const float* in, float* l, float* r, size_t n);
+
+/** x[i] *= gain */
+void applyGain(float* x, size_t n, float gain);
+
+/** dst[i] = src[i] * gain */
+void copyWithGain(float* dst, const float* src, size_t n, float gain);
+
+/** dst[i] += src[i] * gain */
+void mixInto(float* dst, const float* src, size_t n, float gain);
+
+/**
+ * Little-endian PCM to float in [-1, 1): src is raw sample bytes with no alignment
+ * requirement (a view into a mapped file), n is the sample count.
+ */
+void pcm16ToFloat(const uint8_t* src, float* dst, size_t n);
+void pcm24ToFloat(const uint8_t* src, float* dst, size_t n);
+void pcm32ToFloat(const uint8_t* src, float* dst, size_t n);
+void float32ToFloat(const uint8_t* src, float* dst, size_t n);
+
+/**
+ * Float to little-endian PCM, clamped to [-1, 1] and truncated toward zero; dst has no
+ * alignment requirement (a write buffer packed at 2 or 3 bytes per sample).
+ */
+void floatToPcm16(const float* src, uint8_t* dst, size_t n);
+void floatToPcm24(const float* src, uint8_t* dst, size_t n);
+
+/** Plain loops with the same contracts; the reference for tests and benchmarks. */
+namespace scalar {
+float peakAbs(const float* x, size_t n);
+float peakAbsStereo(const float* l, const float* r, size_t n);
+float interleaveStereoPeak(const float* l, const float* r, float* out, size_t n);
+float mixToMonoPeak(const float* l, const float* r, float* out, size_t n);
+void deinterleaveStereo(const float* in, float* l, float* r, size_t n);
+void applyGain(float* x, size_t n, float gain);
+void copyWithGain(float* dst, const float* src, size_t n, float gain);
+void mixInto(float* dst, const float* src, size_t n, float gain);
+void pcm16ToFloat(const uint8_t* src, float* dst, size_t n);
+void pcm24ToFloat(const uint8_t* src, float* dst, size_t n);
+void pcm32ToFloat(const uint8_t* src, float* dst, size_t n);
+void floatToPcm16(const float* src, uint8_t* dst, size_t n);
+void floatToPcm24(const float* src, uint8_t* dst, size_t n);
+} // namespace scalar
+
+} // namespace kernels
+} // namespace guitarrackcraft
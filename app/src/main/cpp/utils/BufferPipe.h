@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Fixed set of preallocated float blocks cycling between one producer and one
+ * consumer thread: the producer fills a free block and submits it, the consumer
+ * takes it and releases it back. With two blocks this is a double buffer, so
+ * file I/O overlaps with processing while memory stays constant. Blocking, for
+ * worker threads only (never the audio callback).
+ */
+class BufferPipe {
+public:
+    struct Block {
+        std::vector<float> data;
+        size_t frames = 0;
+        bool last = false;  // producer's end-of-stream marker
+    };
+
+    BufferPipe(size_t blocks, size_t floatsPerBlock) : blocks_(blocks) {
+        for (Block& block : blocks_) {
+            block.data.resize(floatsPerBlock);
+            free_.push_back(&block);
+        }
+    }
+
+    BufferPipe(const BufferPipe&) = delete;
+    BufferPipe& operator=(const BufferPipe&) = delete;
+
+    /** Producer: wait for a free block; nullptr once closed. */
+    Block* acquireFree() { return take(free_); }
+
+    /** Producer: hand a filled block to the consumer. */
+    void submit(Block* block) { give(filled_, block); }
+
+    /** Consumer: wait for the next filled block; nullptr once closed and drained. */
+    Block* acquireFilled() { return take(filled_); }
+
+    /** Consumer: return a block for reuse. */
+    void release(Block* block) {
+        block->frames = 0;
+        block->last = false;
+        give(free_, block);
+    }
+
+    /** Wake both sides for shutdown; queued filled blocks stay readable. */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        cv_.notify_all();
+    }
+
+private:
+    Block* take(std::deque<Block*>& queue) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return !queue.empty() || closed_; });
+        // After close() only already-filled blocks are still handed out
+        if (queue.empty() || (closed_ && &queue == &free_)) return nullptr;
+        Block* block = queue.front();
+        queue.pop_front();
+        return block;
+    }
+
+    void give(std::deque<Block*>& queue, Block* block) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue.push_back(block);
+        }
+        cv_.notify_all();
+    }
+
+    std::vector<Block> blocks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Block*> free_;
+    std::deque<Block*> filled_;
+    bool closed_ = false;
+};
+
+} // namespace guitarrackcraft
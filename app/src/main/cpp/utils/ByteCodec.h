@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace guitarrackcraft {
+
+constexpr uint64_t kFnv1aOffset = 1469598103934665603ull;
+
+/** 64-bit FNV-1a over n bytes, continuing from h. */
+inline uint64_t fnv1a64(const void* data, size_t n, uint64_t h = kFnv1aOffset) {
+    const auto* p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < n; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+/** Little-endian serializer into a byte vector, for the app's binary cache and preset files. */
+class ByteWriter {
+public:
+    void u8(uint8_t v) { out.push_back(v); }
+    void u32(uint32_t v) {
+        for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+    void u64(uint64_t v) {
+        for (int i = 0; i < 8; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+    void f32(float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, 4);
+        u32(bits);
+    }
+    void bytes(const void* data, size_t n) {
+        const auto* p = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), p, p + n);
+    }
+    void str(const std::string& s) {
+        u32(static_cast<uint32_t>(s.size()));
+        bytes(s.data(), s.size());
+    }
+    /** Overwrite a u32 written earlier at offset (for length prefixes known only afterwards). */
+    void patchU32(size_t offset, uint32_t v) {
+        for (int i = 0; i < 4; ++i) out[offset + i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+    size_t size() const { return out.size(); }
+
+    std::vector<uint8_t> out;
+};
+
+/** Bounds-checked reader over a byte range; any overrun latches ok = false. */
+class ByteReader {
+public:
+    ByteReader(const uint8_t* p, size_t n) : p_(p), end_(p + n) {}
+
+    bool take(void* dst, size_t n) {
+        if (!ok || remaining() < n) return ok = false;
+        std::memcpy(dst, p_, n);
+        p_ += n;
+        return true;
+    }
+    /** Zero-copy view of the next n bytes, or nullptr (and ok = false) on overrun. */
+    const uint8_t* view(size_t n) {
+        if (!ok || remaining() < n) {
+            ok = false;
+            return nullptr;
+        }
+        const uint8_t* v = p_;
+        p_ += n;
+        return v;
+    }
+    uint8_t u8() {
+        uint8_t v = 0;
+        take(&v, 1);
+        return v;
+    }
+    uint32_t u32() {
+        uint8_t b[4] = {};
+        take(b, 4);
+        return b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24);
+    }
+    uint64_t u64() {
+        const uint64_t lo = u32();
+        return lo | (static_cast<uint64_t>(u32()) << 32);
+    }
+    float f32() {
+        const uint32_t bits = u32();
+        float v;
+        std::memcpy(&v, &bits, 4);
+        return v;
+    }
+    std::string str() {
+        const uint32_t n = u32();
+        const uint8_t* s = view(n);
+        return s ? std::string(reinterpret_cast<const char*>(s), n) : std::string();
+    }
+    /** Element count that cannot exceed what is left, so a corrupt count cannot over-allocate. */
+    uint32_t count(size_t minElementBytes) {
+        const uint32_t n = u32();
+        if (ok && remaining() / minElementBytes < n) ok = false;
+        return ok ? n : 0;
+    }
+    size_t remaining() const { return static_cast<size_t>(end_ - p_); }
+
+    bool ok = true;
+
+private:
+    const uint8_t* p_;
+    const uint8_t* end_;
+};
+
+/** Read-only private mapping of a whole file; empty files fail to open. */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/** Write bytes to path via a temporary file and rename, so readers never see a torn file. */
+bool writeFileAtomically(const std::string& path, const std::vector<uint8_t>& bytes);
+
+} // namespace guitarrackcraft
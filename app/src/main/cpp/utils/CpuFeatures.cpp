@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CpuFeatures.h"
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+namespace guitarrackcraft {
+
+namespace {
+
+// arm64 HWCAP bits (asm/hwcap.h), spelled out so older NDK headers and host builds compile
+constexpr uint64_t kHwcapAtomics = 1ull << 8;
+constexpr uint64_t kHwcapFphp = 1ull << 9;
+constexpr uint64_t kHwcapAsimdhp = 1ull << 10;
+constexpr uint64_t kHwcapAsimdrdm = 1ull << 12;
+constexpr uint64_t kHwcapAsimddp = 1ull << 20;
+constexpr uint64_t kHwcapSve = 1ull << 22;
+constexpr uint64_t kHwcap2Sve2 = 1ull << 1;
+
+constexpr const char* kSuffixArmv9 = "_armv9";
+constexpr const char* kSuffixArmv82 = "_armv82";
+
+bool endsWith(const std::string& s, const char* suffix) {
+    const std::string tail(suffix);
+    return s.size() > tail.size() && s.compare(s.size() - tail.size(), tail.size(), tail) == 0;
+}
+
+} // namespace
+
+CpuFeatures CpuFeatures::fromHwcaps(uint64_t hwcap, uint64_t hwcap2) {
+    CpuFeatures f;
+    f.atomics = hwcap & kHwcapAtomics;
+    f.rdm = hwcap & kHwcapAsimdrdm;
+    f.fp16 = (hwcap & kHwcapFphp) && (hwcap & kHwcapAsimdhp);
+    f.dotprod = hwcap & kHwcapAsimddp;
+    f.sve2 = (hwcap & kHwcapSve) && (hwcap2 & kHwcap2Sve2);
+    return f;
+}
+
+const CpuFeatures& CpuFeatures::current() {
+#if defined(__aarch64__) && defined(__linux__)
+    static const CpuFeatures features = fromHwcaps(getauxval(AT_HWCAP), getauxval(AT_HWCAP2));
+#else
+    static const CpuFeatures features;
+#endif
+    return features;
+}
+
+std::vector<std::string> CpuFeatures::variantSuffixes() const {
+    std::vector<std::string> suffixes;
+    if (armv9()) suffixes.emplace_back(kSuffixArmv9);
+    if (armv82()) suffixes.emplace_back(kSuffixArmv82);
+    suffixes.emplace_back();
+    return suffixes;
+}
+
+std::string stripVariantSuffix(const std::string& stem) {
+    for (const char* suffix : {kSuffixArmv9, kSuffixArmv82}) {
+        if (endsWith(stem, suffix)) return stem.substr(0, stem.size() - std::string(suffix).size());
+    }
+    return stem;
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * arm64 instruction set features that decide which tuned build of a heavy DSP plugin
+ * (NAM, AIDA-X) this CPU can run. The superbuild ships each such plugin as a baseline
+ * armv8-a .so plus optional variants next to it, named with a tier suffix:
+ *   lib<name>_armv82.so  -march=armv8.2-a+dotprod+fp16
+ *   lib<name>_armv9.so   -march=armv9-a+sve2
+ * LV2PluginFactory points lv2:binary at the best one present.
+ */
+struct CpuFeatures {
+    bool atomics = false;  // LSE (armv8.1)
+    bool rdm = false;      // SQRDMLAH (armv8.1)
+    bool fp16 = false;     // FPHP + ASIMDHP (armv8.2)
+    bool dotprod = false;  // ASIMDDP
+    bool sve2 = false;     // SVE + SVE2 (armv9)
+
+    /** Features from AT_HWCAP / AT_HWCAP2 style bit masks (Linux arm64 layout). */
+    static CpuFeatures fromHwcaps(uint64_t hwcap, uint64_t hwcap2);
+    /** Features of the running CPU; all false on other architectures. Cached. */
+    static const CpuFeatures& current();
+
+    bool armv82() const { return atomics && rdm && fp16 && dotprod; }
+    bool armv9() const { return armv82() && sve2; }
+
+    /** Library name suffixes this CPU can run, best first; always ends with "" (baseline). */
+    std::vector<std::string> variantSuffixes() const;
+    /** The best tier's suffix ("" for baseline), for logs and cache keys. */
+    std::string bestSuffix() const { return variantSuffixes().front(); }
+};
+
+/**
+ * Strip a tier suffix from a library stem ("nam_armv82" -> "nam"), so a manifest already
+ * pointing at a variant resolves afresh on another CPU.
+ */
+std::string stripVariantSuffix(const std::string& stem);
+
+} // namespace guitarrackcraft
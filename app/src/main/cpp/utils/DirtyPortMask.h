@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace guitarrackcraft {
+
+/**
+ * Fixed-size set of "changed" flags, one bit per index, shared by one writer and one reader.
+ * mark() is a single relaxed fetch_or and safe on the audio thread; take() swaps each word
+ * with zero, so the reader visits every index marked since its last take() exactly once and
+ * the cost follows the number of set words, not the number of indices.
+ */
+class DirtyPortMask {
+public:
+    DirtyPortMask() = default;
+    explicit DirtyPortMask(uint32_t size) { resize(size); }
+
+    /** Size for 'size' indices, all clear. The storage is kept when the word count does not
+     *  change, so re-activation with the same ports never frees memory a reader may touch. */
+    void resize(uint32_t size) {
+        const uint32_t words = (size + 63) / 64;
+        if (words != numWords_) {
+            words_ = std::make_unique<std::atomic<uint64_t>[]>(words);
+            numWords_ = words;
+        }
+        for (uint32_t w = 0; w < numWords_; ++w) words_[w].store(0, std::memory_order_relaxed);
+        size_ = size;
+    }
+
+    uint32_t size() const { return size_; }
+
+    /** Writer: flag 'index' as changed. Out-of-range indices are ignored. */
+    void mark(uint32_t index) {
+        if (index >= size_) return;
+        words_[index / 64].fetch_or(uint64_t{1} << (index % 64), std::memory_order_release);
+    }
+
+    /** True if anything is marked (reader side hint; a concurrent mark() may be missed). */
+    bool any() const {
+        for (uint32_t w = 0; w < numWords_; ++w) {
+            if (words_[w].load(std::memory_order_relaxed) != 0) return true;
+        }
+        return false;
+    }
+
+    /** Reader: clear every flag and call fn(index) for each one that was set, in index order. */
+    template <typename Fn>
+    void take(Fn&& fn) {
+        for (uint32_t w = 0; w < numWords_; ++w) {
+            if (words_[w].load(std::memory_order_relaxed) == 0) continue;
+            uint64_t bits = words_[w].exchange(0, std::memory_order_acquire);
+            while (bits) {
+                fn(w * 64 + static_cast<uint32_t>(__builtin_ctzll(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> words_;
+    uint32_t numWords_ = 0;
+    uint32_t size_ = 0;
+};
+
+} // namespace guitarrackcraft
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "DriftCompensator.h"
+#include <algorithm>
+#include <cstring>
+
+namespace guitarrackcraft {
+
+void DriftCompensator::configure(uint32_t cushionFrames) {
+    cushionFrames_ = std::max(1u, cushionFrames);
+    drainCallbacksLeft_ = kDrainCallbacks;
+    backlogValid_ = false;
+    smoothedBacklog_ = 0.0f;
+    backlog_.store(0.0f, std::memory_order_relaxed);
+    zeroFilledFrames_.store(0, std::memory_order_relaxed);
+    slippedFrames_.store(0, std::memory_order_relaxed);
+    discardedFrames_.store(0, std::memory_order_relaxed);
+}
+
+uint32_t DriftCompensator::framesToDiscard(uint32_t frames, int32_t available) {
+    if (available < 0) return 0;
+    const int64_t leftover = static_cast<int64_t>(available) - frames;
+    const int64_t limit = static_cast<int64_t>(kDiscardCushions) * cushionFrames_;
+    if (leftover <= limit) return 0;
+    // Drop back to the cushion; the smoothed estimate restarts from there.
+    const uint32_t excess = static_cast<uint32_t>(leftover - cushionFrames_);
+    discardedFrames_.fetch_add(excess, std::memory_order_relaxed);
+    smoothedBacklog_ = static_cast<float>(cushionFrames_);
+    return excess;
+}
+
+uint32_t DriftCompensator::framesToRead(uint32_t frames, int32_t available) {
+    if (available < 0 || frames < 2) return frames;
+
+    const float leftover = static_cast<float>(available) - static_cast<float>(frames);
+    if (!backlogValid_) {
+        smoothedBacklog_ = leftover;
+        backlogValid_ = true;
+    } else {
+        smoothedBacklog_ += (leftover - smoothedBacklog_) * kBacklogSmoothing;
+    }
+    backlog_.store(smoothedBacklog_, std::memory_order_relaxed);
+
+    // Half a cushion of hysteresis either side keeps burst jitter from causing slips.
+    const float error = smoothedBacklog_ - static_cast<float>(cushionFrames_);
+    const float deadband = 0.5f * static_cast<float>(cushionFrames_);
+    uint32_t toRead = frames;
+    if (error > deadband && available > static_cast<int32_t>(frames)) {
+        toRead = frames + 1;
+    } else if (error < -deadband) {
+        toRead = frames - 1;
+    }
+    if (toRead != frames) {
+        slippedFrames_.fetch_add(1, std::memory_order_relaxed);
+        // The slip moves the backlog by one frame; reflect it so one slip is taken per frame of error.
+        smoothedBacklog_ += (toRead > frames) ? -1.0f : 1.0f;
+    }
+    return toRead;
+}
+
+void DriftCompensator::recordShortRead(uint32_t missing) {
+    if (missing > 0) {
+        zeroFilledFrames_.fetch_add(missing, std::memory_order_relaxed);
+    }
+}
+
+void DriftCompensator::resample(const float* src, uint32_t srcFrames, float* dst, uint32_t dstFrames) {
+    if (dstFrames == 0) return;
+    if (srcFrames == dstFrames) {
+        std::memcpy(dst, src, dstFrames * sizeof(float));
+        return;
+    }
+    if (srcFrames < 2 || dstFrames < 2) {
+        std::fill(dst, dst + dstFrames, srcFrames > 0 ? src[0] : 0.0f);
+        return;
+    }
+    // End points map onto end points, so consecutive blocks join without a step.
+    const double step = static_cast<double>(srcFrames - 1) / static_cast<double>(dstFrames - 1);
+    for (uint32_t i = 0; i < dstFrames; ++i) {
+        const double pos = i * step;
+        const uint32_t j = std::min(static_cast<uint32_t>(pos), srcFrames - 2);
+        const float frac = static_cast<float>(pos - j);
+        dst[i] = src[j] + (src[j + 1] - src[j]) * frac;
+    }
+}
+
+} // namespace guitarrackcraft
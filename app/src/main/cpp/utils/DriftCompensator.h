@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace guitarrackcraft {
+
+/**
+ * Keeps a non-blocking input stream read from the output callback in step
+ * with it, the way oboe::FullDuplexStream does: the input is drained for a few
+ * callbacks after start so both sides begin in phase, and afterwards the input
+ * backlog left over after each read is held near a one-burst cushion. Slow
+ * drift is absorbed by reading one frame more or less than the callback needs
+ * and stretching the block back to size (a sample slip spread over the whole
+ * block); a backlog far above target, e.g. after a stall, is discarded at once.
+ * All methods except configure() are real-time safe; counters may be read
+ * from any thread.
+ */
+class DriftCompensator {
+public:
+    static constexpr uint32_t kDrainCallbacks = 20;
+
+    /** Reset for a new stream pair. cushionFrames is the backlog target (normally one input burst). */
+    void configure(uint32_t cushionFrames);
+
+    /** True while the caller should read and discard everything available. */
+    bool draining() const { return drainCallbacksLeft_ > 0; }
+
+    /** Count one draining callback. */
+    void drained() { if (drainCallbacksLeft_ > 0) --drainCallbacksLeft_; }
+
+    /** Frames of input to read for an output callback of frames, given the input frames
+     *  available (negative when unknown). Returns frames - 1, frames or frames + 1. */
+    uint32_t framesToRead(uint32_t frames, int32_t available);
+
+    /** Frames of surplus backlog the caller should read and throw away before
+     *  framesToRead() (0 unless the backlog jumped far above the cushion). */
+    uint32_t framesToDiscard(uint32_t frames, int32_t available);
+
+    /** Record that the last read came back short by missing frames (zero-filled by the caller). */
+    void recordShortRead(uint32_t missing);
+
+    /** Stretch or squeeze srcFrames of input to dstFrames by linear interpolation; plain copy when equal.
+     *  src and dst must not alias. */
+    static void resample(const float* src, uint32_t srcFrames, float* dst, uint32_t dstFrames);
+
+    uint64_t zeroFilledFrames() const { return zeroFilledFrames_.load(std::memory_order_relaxed); }
+    uint64_t slippedFrames() const { return slippedFrames_.load(std::memory_order_relaxed); }
+    uint64_t discardedFrames() const { return discardedFrames_.load(std::memory_order_relaxed); }
+    /** Smoothed input backlog after the read, in frames. */
+    float backlogFrames() const { return backlog_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr float kBacklogSmoothing = 1.0f / 16.0f;
+    static constexpr uint32_t kDiscardCushions = 4;
+
+    uint32_t cushionFrames_ = 0;
+    uint32_t drainCallbacksLeft_ = 0;
+    bool backlogValid_ = false;
+    float smoothedBacklog_ = 0.0f;
+
+    std::atomic<float> backlog_{0.0f};
+    std::atomic<uint64_t> zeroFilledFrames_{0};
+    std::atomic<uint64_t> slippedFrames_{0};
+    std::atomic<uint64_t> discardedFrames_{0};
+};
+
+} // namespace guitarrackcraft
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "FixedBlockAdapter.h"
+#include <algorithm>
+#include <cstring>
+
+namespace guitarrackcraft {
+
+namespace {
+uint32_t gcd(uint32_t a, uint32_t b) {
+    while (b != 0) {
+        const uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+}
+
+uint32_t FixedBlockAdapter::primingFrames(uint32_t blockFrames, uint32_t callbackFrames) {
+    // After n callbacks the FIFO is short by (n * callbackFrames) mod blockFrames at most,
+    // and that residue peaks at blockFrames - gcd(callbackFrames, blockFrames).
+    if (blockFrames == 0 || callbackFrames == 0) return 0;
+    return blockFrames - gcd(callbackFrames, blockFrames);
+}
+
+uint32_t FixedBlockAdapter::chooseBlockFrames(uint32_t callbackFrames) {
+    uint32_t maxBlock = kMinBlockFrames;
+    while (maxBlock < callbackFrames) maxBlock <<= 1;
+
+    uint32_t best = kMinBlockFrames;
+    uint32_t bestLatency = primingFrames(best, callbackFrames);
+    for (uint32_t block = kMinBlockFrames << 1; block <= maxBlock; block <<= 1) {
+        const uint32_t latency = primingFrames(block, callbackFrames);
+        if (latency <= bestLatency) {
+            best = block;
+            bestLatency = latency;
+        }
+    }
+    return best;
+}
+
+void FixedBlockAdapter::configure(uint32_t blockFrames, uint32_t nominalCallbackFrames,
+                                  uint32_t maxCallbackFrames) {
+    blockFrames_ = std::max(1u, blockFrames);
+    maxCallbackFrames_ = std::max(maxCallbackFrames, blockFrames_);
+    primingFrames_ = primingFrames(blockFrames_, nominalCallbackFrames);
+    for (int ch = 0; ch < 2; ++ch) {
+        inFifo_[ch].assign(blockFrames_, 0.0f);
+        // Buffered frames (in + out) stay below one block between callbacks, so a
+        // slice can at most add one callback's worth on top of that.
+        outFifo_[ch].assign(blockFrames_ + maxCallbackFrames_, 0.0f);
+    }
+    reset();
+}
+
+void FixedBlockAdapter::reset() {
+    inCount_ = 0;
+    outCount_ = primingFrames_;
+    for (int ch = 0; ch < 2; ++ch) {
+        std::fill(outFifo_[ch].begin(), outFifo_[ch].end(), 0.0f);
+    }
+    latencyFrames_.store(primingFrames_, std::memory_order_relaxed);
+}
+
+void FixedBlockAdapter::process(const float* const* inputs, float* const* outputs, uint32_t frames,
+                                ProcessFn fn, void* context) {
+    if (blockFrames_ == 0) {
+        std::memset(outputs[0], 0, frames * sizeof(float));
+        std::memset(outputs[1], 0, frames * sizeof(float));
+        return;
+    }
+
+    // Aligned fast path: nothing buffered and a whole number of blocks requested.
+    if (inCount_ == 0 && outCount_ == 0 && frames % blockFrames_ == 0) {
+        for (uint32_t offset = 0; offset < frames; offset += blockFrames_) {
+            const float* in[2] = {inputs[0] + offset, inputs[1] + offset};
+            float* out[2] = {outputs[0] + offset, outputs[1] + offset};
+            fn(context, in, out, blockFrames_);
+        }
+        return;
+    }
+
+    // Oversized callbacks are cut into slices the FIFOs were sized for.
+    for (uint32_t offset = 0; offset < frames; offset += maxCallbackFrames_) {
+        const uint32_t n = std::min(maxCallbackFrames_, frames - offset);
+        const float* in[2] = {inputs[0] + offset, inputs[1] + offset};
+        float* out[2] = {outputs[0] + offset, outputs[1] + offset};
+        processSlice(in, out, n, fn, context);
+    }
+}
+
+void FixedBlockAdapter::processSlice(const float* const* inputs, float* const* outputs,
+                                     uint32_t frames, ProcessFn fn, void* context) {
+    // Gather input; each completed block is processed straight onto the output FIFO's tail.
+    for (uint32_t pos = 0; pos < frames;) {
+        const uint32_t take = std::min(frames - pos, blockFrames_ - inCount_);
+        for (int ch = 0; ch < 2; ++ch) {
+            std::memcpy(inFifo_[ch].data() + inCount_, inputs[ch] + pos, take * sizeof(float));
+        }
+        inCount_ += take;
+        pos += take;
+        if (inCount_ == blockFrames_) {
+            const float* in[2] = {inFifo_[0].data(), inFifo_[1].data()};
+            float* out[2] = {outFifo_[0].data() + outCount_, outFifo_[1].data() + outCount_};
+            fn(context, in, out, blockFrames_);
+            outCount_ += blockFrames_;
+            inCount_ = 0;
+        }
+    }
+
+    // Deliver. A shortfall (only possible with irregular callback sizes) is filled with
+    // silence, which permanently shifts the stream later by that many frames.
+    const uint32_t available = std::min(outCount_, frames);
+    for (int ch = 0; ch < 2; ++ch) {
+        std::memcpy(outputs[ch], outFifo_[ch].data(), available * sizeof(float));
+        if (available < frames) {
+            std::memset(outputs[ch] + available, 0, (frames - available) * sizeof(float));
+        }
+        std::memmove(outFifo_[ch].data(), outFifo_[ch].data() + available,
+                     (outCount_ - available) * sizeof(float));
+    }
+    outCount_ -= available;
+    if (available < frames) {
+        latencyFrames_.fetch_add(frames - available, std::memory_order_relaxed);
+    }
+}
+
+} // namespace guitarrackcraft
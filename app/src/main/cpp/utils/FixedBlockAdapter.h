@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Presents a stereo processor with fixed power-of-2 blocks whatever size the
+ * audio callback asks for. Input is gathered into a one-block FIFO and output
+ * is delivered from a FIFO that starts primed with latencyFrames() of silence,
+ * which is the least that keeps it from running dry for the nominal callback.
+ * Callbacks that are whole multiples of the block with empty FIFOs skip the
+ * copies entirely. process() never allocates or locks.
+ */
+class FixedBlockAdapter {
+public:
+    using ProcessFn = void (*)(void* context, const float* const* inputs,
+                               float* const* outputs, uint32_t frames);
+
+    static constexpr uint32_t kMinBlockFrames = 32;
+
+    /** Block size for callbacks of callbackFrames: the power of two in
+     *  [kMinBlockFrames, nextPow2(callbackFrames)] adding the least latency, the larger on ties. */
+    static uint32_t chooseBlockFrames(uint32_t callbackFrames);
+
+    /** Frames of silence needed in front of the output for callbacks of callbackFrames. */
+    static uint32_t primingFrames(uint32_t blockFrames, uint32_t callbackFrames);
+
+    /** Allocate for blockFrames (power of 2) and callbacks of up to maxCallbackFrames,
+     *  primed for nominalCallbackFrames. Not real-time safe. */
+    void configure(uint32_t blockFrames, uint32_t nominalCallbackFrames, uint32_t maxCallbackFrames);
+
+    /** Drop buffered audio and re-prime the output FIFO. Call only while process() is not running. */
+    void reset();
+
+    /** Run frames of stereo audio from inputs to outputs through fn in blocks of blockFrames().
+     *  inputs and outputs must not alias. */
+    void process(const float* const* inputs, float* const* outputs, uint32_t frames,
+                 ProcessFn fn, void* context);
+
+    uint32_t blockFrames() const { return blockFrames_; }
+
+    /** Delay the adapter adds; grows if an irregular callback ever drains the output FIFO. */
+    uint32_t latencyFrames() const { return latencyFrames_.load(std::memory_order_relaxed); }
+
+private:
+    void processSlice(const float* const* inputs, float* const* outputs, uint32_t frames,
+                      ProcessFn fn, void* context);
+
+    uint32_t blockFrames_ = 0;
+    uint32_t maxCallbackFrames_ = 0;
+    uint32_t primingFrames_ = 0;
+
+    std::vector<float> inFifo_[2];    // blockFrames_
+    std::vector<float> outFifo_[2];   // blockFrames_ + maxCallbackFrames_
+    uint32_t inCount_ = 0;
+    uint32_t outCount_ = 0;
+
+    std::atomic<uint32_t> latencyFrames_{0};
+};
+
+} // namespace guitarrackcraft
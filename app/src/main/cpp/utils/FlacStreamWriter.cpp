@@ -0,0 +1,421 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "FlacStreamWriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace guitarrackcraft {
+
+namespace {
+
+constexpr size_t kStreamInfoOffset = 8;  // after "fLaC" and the metadata block header
+constexpr size_t kStreamInfoBytes = 34;
+constexpr int kMaxFixedOrder = 4;
+constexpr int kMaxPartitionOrder = 8;
+
+/** MSB-first bit packer appending to a byte vector. */
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    void put(uint32_t value, int bits) {
+        acc_ = (acc_ << bits) | (value & ((uint64_t{1} << bits) - 1));
+        pending_ += bits;
+        while (pending_ >= 8) {
+            pending_ -= 8;
+            out_.push_back(static_cast<uint8_t>(acc_ >> pending_));
+        }
+    }
+
+    void putRice(uint32_t value, int k) {
+        uint32_t zeros = value >> k;
+        while (zeros >= 31) {
+            put(0, 31);
+            zeros -= 31;
+        }
+        put(1, static_cast<int>(zeros) + 1);
+        if (k > 0) put(value, k);
+    }
+
+    void alignToByte() {
+        if (pending_ > 0) put(0, 8 - pending_);
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+    uint64_t acc_ = 0;
+    int pending_ = 0;
+};
+
+uint8_t crc8(const uint8_t* p, size_t n) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < n; ++i) {
+        crc ^= p[i];
+        for (int b = 0; b < 8; ++b) crc = static_cast<uint8_t>((crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1);
+    }
+    return crc;
+}
+
+uint16_t crc16(const uint8_t* p, size_t n) {
+    uint16_t crc = 0;
+    for (size_t i = 0; i < n; ++i) {
+        crc ^= static_cast<uint16_t>(p[i] << 8);
+        for (int b = 0; b < 8; ++b) crc = static_cast<uint16_t>((crc & 0x8000) ? (crc << 1) ^ 0x8005 : crc << 1);
+    }
+    return crc;
+}
+
+inline uint32_t zigzag(int32_t v) { return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31); }
+
+inline int32_t fixedResidual(const int32_t* x, uint32_t i, int order) {
+    switch (order) {
+        case 0: return x[i];
+        case 1: return x[i] - x[i - 1];
+        case 2: return x[i] - 2 * x[i - 1] + x[i - 2];
+        case 3: return x[i] - 3 * x[i - 1] + 3 * x[i - 2] - x[i - 3];
+        default: return x[i] - 4 * x[i - 1] + 6 * x[i - 2] - 4 * x[i - 3] + x[i - 4];
+    }
+}
+
+int maxFixedOrder(uint32_t n) { return std::min<int>(kMaxFixedOrder, static_cast<int>(n) - 1); }
+
+/** Fixed predictor order with the smallest sum of |residual|; returns that sum. */
+uint64_t bestFixedOrder(const int32_t* x, uint32_t n, int& order) {
+    const int maxOrder = maxFixedOrder(n);
+    order = 0;
+    uint64_t best = UINT64_MAX;
+    for (int o = 0; o <= maxOrder; ++o) {
+        uint64_t sum = 0;
+        for (uint32_t i = static_cast<uint32_t>(maxOrder); i < n; ++i) {
+            sum += static_cast<uint64_t>(std::abs(static_cast<int64_t>(fixedResidual(x, i, o))));
+        }
+        if (sum < best) {
+            best = sum;
+            order = o;
+        }
+    }
+    return best;
+}
+
+/** Rice parameter and estimated bits for a partition of count zigzagged residuals summing to sum. */
+int riceParameter(uint64_t sum, uint32_t count, uint64_t& bits) {
+    int bestK = 0;
+    bits = UINT64_MAX;
+    for (int k = 0; k <= 30; ++k) {
+        const uint64_t cost = static_cast<uint64_t>(count) * (k + 1) + (sum >> k);
+        if (cost < bits) {
+            bits = cost;
+            bestK = k;
+        }
+    }
+    return bestK;
+}
+
+struct RicePlan {
+    int partitionOrder = 0;
+    int params[1 << kMaxPartitionOrder] = {};
+    bool wideParams = false;  // RICE2: 5-bit parameters, needed above 14
+    uint64_t bits = UINT64_MAX;
+};
+
+/** Choose the partition order and per-partition parameters for residuals r[order..n). */
+void planResidual(const int32_t* r, uint32_t n, int order, RicePlan& plan) {
+    int maxPartition = 0;
+    while (maxPartition < kMaxPartitionOrder && (n % (2u << maxPartition)) == 0 &&
+           (n >> (maxPartition + 1)) > static_cast<uint32_t>(order)) {
+        ++maxPartition;
+    }
+    // Sums at the finest partitioning, merged pairwise for the coarser ones
+    uint64_t sums[1 << kMaxPartitionOrder];
+    const uint32_t finest = n >> maxPartition;
+    for (uint32_t p = 0; p < (1u << maxPartition); ++p) {
+        uint64_t s = 0;
+        for (uint32_t i = std::max<uint32_t>(p * finest, static_cast<uint32_t>(order)); i < (p + 1) * finest; ++i) {
+            s += zigzag(r[i]);
+        }
+        sums[p] = s;
+    }
+    for (int po = maxPartition; po >= 0; --po) {
+        const uint32_t partitions = 1u << po;
+        const uint32_t size = n >> po;
+        RicePlan candidate;
+        candidate.partitionOrder = po;
+        candidate.bits = 0;
+        for (uint32_t p = 0; p < partitions; ++p) {
+            const uint32_t count = p == 0 ? size - static_cast<uint32_t>(order) : size;
+            uint64_t bits;
+            candidate.params[p] = riceParameter(sums[p], count, bits);
+            candidate.wideParams = candidate.wideParams || candidate.params[p] > 14;
+            candidate.bits += bits;
+        }
+        candidate.bits += partitions * (candidate.wideParams ? 5 : 4);
+        if (candidate.bits < plan.bits) plan = candidate;
+        for (uint32_t p = 0; p < partitions / 2; ++p) sums[p] = sums[2 * p] + sums[2 * p + 1];
+    }
+}
+
+/** One subframe: constant, verbatim or fixed-predicted, whichever is smallest. */
+void encodeSubframe(BitWriter& bw, const int32_t* x, uint32_t n, int bps, int32_t* residual) {
+    if (std::all_of(x + 1, x + n, [&](int32_t v) { return v == x[0]; })) {
+        bw.put(0x00, 8);  // zero pad, CONSTANT, no wasted bits
+        bw.put(static_cast<uint32_t>(x[0]), bps);
+        return;
+    }
+    int order;
+    bestFixedOrder(x, n, order);
+    for (uint32_t i = static_cast<uint32_t>(order); i < n; ++i) residual[i] = fixedResidual(x, i, order);
+    RicePlan plan;
+    planResidual(residual, n, order, plan);
+
+    const uint64_t fixedBits = static_cast<uint64_t>(order) * bps + 6 + plan.bits;
+    if (fixedBits >= static_cast<uint64_t>(n) * bps) {
+        bw.put(0x02, 8);  // VERBATIM
+        for (uint32_t i = 0; i < n; ++i) bw.put(static_cast<uint32_t>(x[i]), bps);
+        return;
+    }
+    bw.put(static_cast<uint32_t>(0x08 | order) << 1, 8);  // FIXED (001xxx), order in the low bits
+    for (int i = 0; i < order; ++i) bw.put(static_cast<uint32_t>(x[i]), bps);
+    bw.put(plan.wideParams ? 1 : 0, 2);
+    bw.put(static_cast<uint32_t>(plan.partitionOrder), 4);
+    const uint32_t size = n >> plan.partitionOrder;
+    for (uint32_t p = 0; p < (1u << plan.partitionOrder); ++p) {
+        const int k = plan.params[p];
+        bw.put(static_cast<uint32_t>(k), plan.wideParams ? 5 : 4);
+        for (uint32_t i = std::max<uint32_t>(p * size, static_cast<uint32_t>(order)); i < (p + 1) * size; ++i) {
+            bw.putRice(zigzag(residual[i]), k);
+        }
+    }
+}
+
+int sampleRateCode(uint32_t rate) {
+    switch (rate) {
+        case 88200: return 1;
+        case 176400: return 2;
+        case 192000: return 3;
+        case 8000: return 4;
+        case 16000: return 5;
+        case 22050: return 6;
+        case 24000: return 7;
+        case 32000: return 8;
+        case 44100: return 9;
+        case 48000: return 10;
+        case 96000: return 11;
+        default: break;
+    }
+    if (rate % 1000 == 0 && rate / 1000 < 256) return 12;
+    if (rate < 65536) return 13;
+    if (rate % 10 == 0 && rate / 10 < 65536) return 14;
+    return 0;  // from STREAMINFO
+}
+
+void putUtf8(BitWriter& bw, uint32_t v) {
+    if (v < 0x80) {
+        bw.put(v, 8);
+        return;
+    }
+    int extra = v < 0x800 ? 1 : v < 0x10000 ? 2 : v < 0x200000 ? 3 : v < 0x4000000 ? 4 : 5;
+    const uint32_t lead = (0xFF00u >> (extra + 1)) & 0xFF;
+    bw.put(lead | (v >> (6 * extra)), 8);
+    for (int i = extra - 1; i >= 0; --i) bw.put(0x80 | ((v >> (6 * i)) & 0x3F), 8);
+}
+
+bool writeAll(int fd, const uint8_t* p, size_t bytes) {
+    while (bytes > 0) {
+        const ssize_t n = ::write(fd, p, bytes);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        bytes -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+bool FlacStreamWriter::open(const std::string& path, uint32_t sampleRate, uint16_t channels, uint16_t bitsPerSample) {
+    close();
+    if (channels == 0 || channels > 8 || sampleRate == 0 || sampleRate >= (1u << 20) ||
+        (bitsPerSample != 16 && bitsPerSample != 24)) {
+        return false;
+    }
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) return false;
+    sampleRate_ = sampleRate;
+    channels_ = channels;
+    bitsPerSample_ = bitsPerSample;
+    scale_ = bitsPerSample == 16 ? 32767.0f : 8388607.0f;
+    block_.assign(static_cast<size_t>(channels) * kBlockFrames, 0);
+    scratch_.assign(3 * kBlockFrames, 0);
+    out_.clear();
+    out_.reserve(kBatchBytes + 64 * 1024);
+    blockFill_ = 0;
+    pendingChannel_ = 0;
+    framesEncoded_ = 0;
+    frameNumber_ = 0;
+    minFrameBytes_ = 0;
+    maxFrameBytes_ = 0;
+    fileBytes_ = 0;
+
+    const uint8_t magic[8] = {'f', 'L', 'a', 'C', 0x80, 0, 0, kStreamInfoBytes};  // last metadata block
+    out_.insert(out_.end(), magic, magic + sizeof(magic));
+    out_.resize(out_.size() + kStreamInfoBytes, 0);
+    if (!flushOut() || !writeStreamInfo()) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+bool FlacStreamWriter::writeSamples(const float* interleaved, size_t samples) {
+    if (fd_ < 0) return false;
+    for (size_t i = 0; i < samples; ++i) {
+        const float clamped = std::max(-1.0f, std::min(1.0f, interleaved[i]));
+        block_[static_cast<size_t>(pendingChannel_) * kBlockFrames + blockFill_] = static_cast<int32_t>(clamped * scale_);
+        if (++pendingChannel_ < channels_) continue;
+        pendingChannel_ = 0;
+        if (++blockFill_ == kBlockFrames) {
+            encodeBlock(kBlockFrames);
+            if (out_.size() >= kBatchBytes && !flushOut()) return false;
+        }
+    }
+    return true;
+}
+
+void FlacStreamWriter::encodeBlock(uint32_t frames) {
+    const size_t frameStart = out_.size();
+    const int32_t* left = block_.data();
+    const int32_t* right = left + kBlockFrames;
+    int32_t* side = scratch_.data();
+    int32_t* mid = side + kBlockFrames;
+    int32_t* residual = mid + kBlockFrames;
+
+    // Stereo decorrelation: compare the cheapest fixed-predictor cost of each candidate pair
+    uint32_t assignment = channels_ - 1u;  // independent
+    if (channels_ == 2) {
+        for (uint32_t i = 0; i < frames; ++i) {
+            side[i] = left[i] - right[i];
+            mid[i] = (left[i] + right[i]) >> 1;
+        }
+        int order;
+        const uint64_t costL = bestFixedOrder(left, frames, order);
+        const uint64_t costR = bestFixedOrder(right, frames, order);
+        const uint64_t costS = bestFixedOrder(side, frames, order);
+        const uint64_t costM = bestFixedOrder(mid, frames, order);
+        const uint64_t costs[4] = {costL + costR, costL + costS, costS + costR, costM + costS};
+        const int best = static_cast<int>(std::min_element(costs, costs + 4) - costs);
+        assignment = best == 0 ? 1u : 7u + static_cast<uint32_t>(best);
+    }
+
+    BitWriter bw(out_);
+    bw.put(0xFFF8, 16);  // sync, reserved, fixed block size
+    const bool fullBlock = frames == kBlockFrames;
+    const uint32_t blockCode = fullBlock ? 12u : frames <= 256 ? 6u : 7u;
+    const int rateCode = sampleRateCode(sampleRate_);
+    bw.put(blockCode, 4);
+    bw.put(static_cast<uint32_t>(rateCode), 4);
+    bw.put(assignment, 4);
+    bw.put(bitsPerSample_ == 16 ? 4u : 6u, 3);
+    bw.put(0, 1);
+    putUtf8(bw, frameNumber_);
+    if (blockCode == 6) bw.put(frames - 1, 8);
+    if (blockCode == 7) bw.put(frames - 1, 16);
+    if (rateCode == 12) bw.put(sampleRate_ / 1000, 8);
+    if (rateCode == 13) bw.put(sampleRate_, 16);
+    if (rateCode == 14) bw.put(sampleRate_ / 10, 16);
+    bw.put(crc8(out_.data() + frameStart, out_.size() - frameStart), 8);
+
+    const int bps = bitsPerSample_;
+    switch (assignment) {
+        case 8:  // left/side
+            encodeSubframe(bw, left, frames, bps, residual);
+            encodeSubframe(bw, side, frames, bps + 1, residual);
+            break;
+        case 9:  // side/right
+            encodeSubframe(bw, side, frames, bps + 1, residual);
+            encodeSubframe(bw, right, frames, bps, residual);
+            break;
+        case 10:  // mid/side
+            encodeSubframe(bw, mid, frames, bps, residual);
+            encodeSubframe(bw, side, frames, bps + 1, residual);
+            break;
+        default:
+            for (uint16_t ch = 0; ch < channels_; ++ch) {
+                encodeSubframe(bw, block_.data() + static_cast<size_t>(ch) * kBlockFrames, frames, bps, residual);
+            }
+            break;
+    }
+    bw.alignToByte();
+    const uint16_t crc = crc16(out_.data() + frameStart, out_.size() - frameStart);
+    out_.push_back(static_cast<uint8_t>(crc >> 8));
+    out_.push_back(static_cast<uint8_t>(crc));
+
+    const auto frameBytes = static_cast<uint32_t>(out_.size() - frameStart);
+    minFrameBytes_ = minFrameBytes_ == 0 ? frameBytes : std::min(minFrameBytes_, frameBytes);
+    maxFrameBytes_ = std::max(maxFrameBytes_, frameBytes);
+    framesEncoded_ += frames;
+    ++frameNumber_;
+    blockFill_ = 0;
+}
+
+bool FlacStreamWriter::flushOut() {
+    if (out_.empty()) return true;
+    if (!writeAll(fd_, out_.data(), out_.size())) return false;
+    fileBytes_ += out_.size();
+    out_.clear();
+    return true;
+}
+
+bool FlacStreamWriter::writeStreamInfo() {
+    std::vector<uint8_t> info;
+    info.reserve(kStreamInfoBytes);
+    BitWriter bw(info);
+    bw.put(kBlockFrames, 16);  // min block size (the last block may be shorter)
+    bw.put(kBlockFrames, 16);
+    bw.put(minFrameBytes_, 24);
+    bw.put(maxFrameBytes_, 24);
+    bw.put(sampleRate_, 20);
+    bw.put(channels_ - 1u, 3);
+    bw.put(bitsPerSample_ - 1u, 5);
+    bw.put(static_cast<uint32_t>(framesEncoded_ >> 32), 4);
+    bw.put(static_cast<uint32_t>(framesEncoded_), 32);
+    info.resize(kStreamInfoBytes, 0);  // MD5 unknown
+    return pwrite(fd_, info.data(), info.size(), kStreamInfoOffset) == static_cast<ssize_t>(info.size());
+}
+
+bool FlacStreamWriter::checkpoint() {
+    if (fd_ < 0) return false;
+    return flushOut() && writeStreamInfo();
+}
+
+bool FlacStreamWriter::close() {
+    if (fd_ < 0) return true;
+    if (blockFill_ > 0) encodeBlock(blockFill_);
+    const bool ok = checkpoint();
+    const bool closed = ::close(fd_) == 0;
+    fd_ = -1;
+    return ok && closed;
+}
+
+} // namespace guitarrackcraft
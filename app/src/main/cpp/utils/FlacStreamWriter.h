@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "AudioFileWriter.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Streaming FLAC encoder for long captures: lossless at about half the size and write
+ * bandwidth of PCM WAV. Input is buffered into fixed kBlockFrames blocks, and each full
+ * block is encoded as soon as it completes:
+ *   - stereo picks independent, left/side, right/side or mid/side per block;
+ *   - each channel is constant, verbatim or the best of the fixed predictors (orders 0-4);
+ *   - residuals are partitioned Rice codes with per-partition parameters.
+ * No LPC: fixed predictors get most of the gain on guitar material for a fraction of the
+ * cost. Encoded frames are batched into large write() calls. checkpoint() writes out the
+ * complete frames and patches STREAMINFO's sample count, so a crash leaves a valid file;
+ * close() encodes the final partial block. The MD5 signature is left zero ("unknown").
+ */
+class FlacStreamWriter : public AudioFileWriter {
+public:
+    FlacStreamWriter() = default;
+    ~FlacStreamWriter() override { close(); }
+
+    FlacStreamWriter(const FlacStreamWriter&) = delete;
+    FlacStreamWriter& operator=(const FlacStreamWriter&) = delete;
+
+    /** Create/truncate path and write the stream header. bitsPerSample is 16 or 24; channels 1..8. */
+    bool open(const std::string& path, uint32_t sampleRate, uint16_t channels, uint16_t bitsPerSample);
+
+    /** Floats are clamped to [-1, 1] and quantized to bitsPerSample. */
+    bool writeSamples(const float* interleaved, size_t samples) override;
+    bool checkpoint() override;
+    bool close() override;
+
+    bool isOpen() const override { return fd_ >= 0; }
+    size_t framesWritten() const override { return static_cast<size_t>(framesEncoded_) + blockFill_; }
+
+    /** Encoded bytes so far (header and complete frames). */
+    uint64_t bytesWritten() const { return fileBytes_ + out_.size(); }
+
+    static constexpr uint32_t kBlockFrames = 4096;
+    static constexpr size_t kBatchBytes = 128 * 1024;
+
+private:
+    int fd_ = -1;
+    uint32_t sampleRate_ = 0;
+    uint16_t channels_ = 0;
+    uint16_t bitsPerSample_ = 16;
+    float scale_ = 32767.0f;
+
+    std::vector<int32_t> block_;  // planar, kBlockFrames per channel
+    uint32_t blockFill_ = 0;      // frames in block_
+    uint16_t pendingChannel_ = 0; // next channel of a partial frame
+    uint64_t framesEncoded_ = 0;
+    uint32_t frameNumber_ = 0;
+    uint32_t minFrameBytes_ = 0;
+    uint32_t maxFrameBytes_ = 0;
+
+    std::vector<uint8_t> out_;    // encoded bytes not yet written
+    uint64_t fileBytes_ = 0;
+    std::vector<int32_t> scratch_;
+
+    void encodeBlock(uint32_t frames);
+    bool flushOut();
+    bool writeStreamInfo();
+};
+
+} // namespace guitarrackcraft
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <xmmintrin.h>
+#endif
+
+namespace guitarrackcraft {
+
+/**
+ * Per-thread floating-point control for DSP threads. Denormals in decaying tails (reverb,
+ * IIR, LSTM state after the gate closes) cost 10-100x per operation on many cores, so every
+ * thread that runs plugin code flushes them: FPCR.FZ|DN on ARM, MXCSR.FTZ|DAZ on x86. The
+ * setting is per thread and survives until changed, so each thread sets it once at start.
+ */
+namespace float_env {
+
+#if defined(__aarch64__) || defined(__arm__)
+constexpr uint64_t kFlushBits = (1ull << 24) | (1ull << 25);  // FZ, DN
+#elif defined(__x86_64__) || defined(__i386__)
+constexpr uint64_t kFlushBits = 0x8040;  // FTZ, DAZ
+#else
+constexpr uint64_t kFlushBits = 0;
+#endif
+
+inline uint64_t read() {
+#if defined(__aarch64__)
+    uint64_t fpcr;
+    asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+    return fpcr;
+#elif defined(__arm__)
+    uint32_t fpscr;
+    asm volatile("vmrs %0, fpscr" : "=r"(fpscr));
+    return fpscr;
+#elif defined(__x86_64__) || defined(__i386__)
+    return _mm_getcsr();
+#else
+    return 0;
+#endif
+}
+
+inline void write(uint64_t value) {
+#if defined(__aarch64__)
+    asm volatile("msr fpcr, %0" ::"r"(value));
+#elif defined(__arm__)
+    asm volatile("vmsr fpscr, %0" ::"r"(static_cast<uint32_t>(value)));
+#elif defined(__x86_64__) || defined(__i386__)
+    _mm_setcsr(static_cast<unsigned int>(value));
+#else
+    (void)value;
+#endif
+}
+
+} // namespace float_env
+
+/** Flush denormal inputs and results to zero on the calling thread. */
+inline void enableFlushToZero() {
+    const uint64_t value = float_env::read();
+    if ((value & float_env::kFlushBits) != float_env::kFlushBits) {
+        float_env::write(value | float_env::kFlushBits);
+    }
+}
+
+inline bool flushToZeroEnabled() {
+    return float_env::kFlushBits != 0 &&
+           (float_env::read() & float_env::kFlushBits) == float_env::kFlushBits;
+}
+
+/**
+ * Flush-to-zero on or off for one scope, restored on exit. Writes the control register only
+ * when the mode differs, so wrapping every plugin call on an FTZ thread costs one read; off is
+ * for plugins that need strict IEEE 754 (IPlugin::needsStrictFloat).
+ */
+class ScopedFloatMode {
+public:
+    explicit ScopedFloatMode(bool flushToZero) : saved_(float_env::read()) {
+        const uint64_t wanted = flushToZero ? saved_ | float_env::kFlushBits
+                                            : saved_ & ~float_env::kFlushBits;
+        changed_ = wanted != saved_;
+        if (changed_) float_env::write(wanted);
+    }
+    ~ScopedFloatMode() {
+        if (changed_) float_env::write(saved_);
+    }
+    ScopedFloatMode(const ScopedFloatMode&) = delete;
+    ScopedFloatMode& operator=(const ScopedFloatMode&) = delete;
+
+private:
+    uint64_t saved_;
+    bool changed_;
+};
+
+} // namespace guitarrackcraft
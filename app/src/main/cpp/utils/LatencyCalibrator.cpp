@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "LatencyCalibrator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace guitarrackcraft {
+
+std::vector<float> LatencyCalibrator::mls(int order) {
+    // Galois LFSR toggle masks for primitive polynomials, indexed by order.
+    static constexpr uint32_t kTaps[] = {0, 0, 0x3, 0x6, 0xC, 0x14, 0x30, 0x60, 0xB8,
+                                         0x110, 0x240, 0x500, 0xE08, 0x1C80, 0x3802, 0x6000, 0xD008};
+    order = std::max(2, std::min(order, 16));
+    const uint32_t length = (1u << order) - 1;
+    std::vector<float> seq(length);
+    uint32_t reg = 1;
+    for (uint32_t i = 0; i < length; ++i) {
+        const uint32_t bit = reg & 1u;
+        seq[i] = bit ? 1.0f : -1.0f;
+        reg >>= 1;
+        if (bit) reg ^= kTaps[order];
+    }
+    return seq;
+}
+
+bool LatencyCalibrator::prepare(float sampleRate) {
+    if (state() == State::Running || sampleRate <= 0.0f) return false;
+    if (stimulus_.empty()) {
+        stimulus_ = mls(kMlsOrder);
+        for (float& s : stimulus_) s *= kStimulusLevel;
+    }
+    maxLag_ = static_cast<uint32_t>(sampleRate * kMaxLatencySeconds);
+    capture_.assign(stimulus_.size() + maxLag_, 0.0f);
+    state_.store(State::Idle, std::memory_order_release);
+    return true;
+}
+
+void LatencyCalibrator::start() {
+    if (capture_.empty()) return;
+    position_ = 0;
+    state_.store(State::Running, std::memory_order_release);
+}
+
+void LatencyCalibrator::process(const float* input, float* output, uint32_t frames) {
+    if (state() != State::Running) {
+        std::memset(output, 0, frames * sizeof(float));
+        return;
+    }
+    const uint32_t total = static_cast<uint32_t>(capture_.size());
+    const uint32_t length = static_cast<uint32_t>(stimulus_.size());
+    const uint32_t n = std::min(frames, total - position_);
+    std::memcpy(capture_.data() + position_, input, n * sizeof(float));
+    for (uint32_t i = 0; i < frames; ++i) {
+        const uint32_t pos = position_ + i;
+        output[i] = pos < length ? stimulus_[pos] : 0.0f;
+    }
+    position_ += n;
+    if (position_ >= total) {
+        state_.store(State::Captured, std::memory_order_release);
+    }
+}
+
+int32_t LatencyCalibrator::findLag(const std::vector<float>& stimulus, const std::vector<float>& capture,
+                                   uint32_t maxLag, float minRatio, float* peakRatio) {
+    if (stimulus.empty() || capture.size() < stimulus.size()) return -1;
+    const size_t lags = std::min<size_t>(maxLag + 1, capture.size() - stimulus.size() + 1);
+    double sum = 0.0;
+    double best = 0.0;
+    int32_t bestLag = -1;
+    for (size_t lag = 0; lag < lags; ++lag) {
+        const float* c = capture.data() + lag;
+        double acc = 0.0;
+        for (size_t i = 0; i < stimulus.size(); ++i) {
+            acc += static_cast<double>(stimulus[i]) * c[i];
+        }
+        acc = std::fabs(acc);
+        sum += acc;
+        if (acc > best) {
+            best = acc;
+            bestLag = static_cast<int32_t>(lag);
+        }
+    }
+    const double mean = sum / static_cast<double>(lags);
+    const float ratio = mean > 0.0 ? static_cast<float>(best / mean) : 0.0f;
+    if (peakRatio) *peakRatio = ratio;
+    return ratio >= minRatio ? bestLag : -1;
+}
+
+int32_t LatencyCalibrator::analyze(float* peakRatio) {
+    if (state() != State::Captured) return -1;
+    const int32_t lag = findLag(stimulus_, capture_, maxLag_, kMinPeakRatio, peakRatio);
+    state_.store(State::Idle, std::memory_order_release);
+    return lag;
+}
+
+} // namespace guitarrackcraft
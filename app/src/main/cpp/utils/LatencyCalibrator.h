@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Measures true input-to-output latency: plays a maximum-length sequence (MLS)
+ * burst on the output while capturing the input, then finds the lag of the
+ * cross-correlation peak. Works through a loopback cable or acoustically; the
+ * correlation gain of the MLS keeps it robust against room noise, and the peak
+ * is taken on magnitude so inverting paths are found too.
+ *
+ * prepare() and analyze() run on a control thread; process() is the only call
+ * made from the audio callback and does no allocation.
+ */
+class LatencyCalibrator {
+public:
+    enum class State : int { Idle = 0, Running = 1, Captured = 2 };
+
+    static constexpr int kMlsOrder = 12;              // 4095-sample sequence
+    static constexpr float kStimulusLevel = 0.25f;    // about -12 dBFS
+    static constexpr double kMaxLatencySeconds = 0.5;
+    static constexpr float kMinPeakRatio = 6.0f;      // peak over mean |correlation|
+
+    /** Allocate the stimulus and capture buffer for sampleRate. Fails while a run is in progress. */
+    bool prepare(float sampleRate);
+
+    /** Begin a measurement; process() plays and captures until the window is full. */
+    void start();
+    void cancel() { state_.store(State::Idle, std::memory_order_release); }
+    State state() const { return state_.load(std::memory_order_acquire); }
+
+    /** Audio thread: capture frames of input and write the stimulus to output. */
+    void process(const float* input, float* output, uint32_t frames);
+
+    /** Latency in frames from the capture, or -1 if no clear peak was found. Resets to Idle. */
+    int32_t analyze(float* peakRatio = nullptr);
+
+    /** Binary maximum-length sequence of 2^order - 1 values in {-1, +1}. */
+    static std::vector<float> mls(int order);
+
+    /** Index of the largest |correlation| of stimulus against capture over lags [0, maxLag],
+     *  or -1 if its ratio to the mean magnitude is below minRatio. */
+    static int32_t findLag(const std::vector<float>& stimulus, const std::vector<float>& capture,
+                           uint32_t maxLag, float minRatio, float* peakRatio = nullptr);
+
+private:
+    std::vector<float> stimulus_;
+    std::vector<float> capture_;
+    uint32_t position_ = 0;
+    uint32_t maxLag_ = 0;
+    std::atomic<State> state_{State::Idle};
+};
+
+} // namespace guitarrackcraft
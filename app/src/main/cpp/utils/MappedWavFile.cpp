@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "MappedWavFile.h"
+#include "AudioKernels.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace guitarrackcraft {
+
+namespace {
+
+constexpr uint16_t kFormatPcm = 1;
+constexpr uint16_t kFormatFloat = 3;
+constexpr uint16_t kFormatExtensible = 0xFFFE;
+
+uint16_t le16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+uint32_t le32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+} // namespace
+
+bool MappedWavFile::open(const std::string& path) {
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return fail("cannot open file");
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size < 12) {
+        ::close(fd);
+        return fail("file too short");
+    }
+    void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // the mapping keeps the file referenced
+    if (p == MAP_FAILED) return fail("mmap failed");
+    map_ = static_cast<const uint8_t*>(p);
+    mapSize_ = static_cast<size_t>(st.st_size);
+    if (!index()) {
+        const std::string why = error_;
+        close();
+        error_ = why;
+        return false;
+    }
+    return true;
+}
+
+void MappedWavFile::close() {
+    if (map_) {
+        munmap(const_cast<uint8_t*>(map_), mapSize_);
+    }
+    map_ = nullptr;
+    mapSize_ = 0;
+    data_ = nullptr;
+    chunks_.clear();
+    frames_ = 0;
+    error_.clear();
+}
+
+bool MappedWavFile::fail(const char* message) {
+    error_ = message;
+    return false;
+}
+
+bool MappedWavFile::index() {
+    if (std::memcmp(map_, "RIFF", 4) != 0 || std::memcmp(map_ + 8, "WAVE", 4) != 0) {
+        return fail("not a RIFF/WAVE file");
+    }
+    for (size_t pos = 12; pos + 8 <= mapSize_;) {
+        Chunk chunk;
+        std::memcpy(chunk.id, map_ + pos, 4);
+        const size_t declared = le32(map_ + pos + 4);
+        chunk.offset = pos + 8;
+        // Streamed writers leave 0 or 0xFFFFFFFF in the header; clamp to what is there.
+        chunk.size = std::min(declared, mapSize_ - chunk.offset);
+        if (declared == 0 && std::memcmp(chunk.id, "data", 4) == 0) {
+            chunk.size = mapSize_ - chunk.offset;
+        }
+        chunks_.push_back(chunk);
+        pos = chunk.offset + chunk.size + (chunk.size & 1u);
+    }
+
+    const Chunk* fmt = findChunk("fmt ");
+    const Chunk* data = findChunk("data");
+    if (!fmt || fmt->size < 16) return fail("missing fmt chunk");
+    if (!data) return fail("missing data chunk");
+
+    const uint8_t* f = map_ + fmt->offset;
+    uint16_t tag = le16(f);
+    channels_ = le16(f + 2);
+    sampleRate_ = le32(f + 4);
+    bytesPerFrame_ = le16(f + 12);
+    bitsPerSample_ = le16(f + 14);
+    if (tag == kFormatExtensible) {
+        // cbSize, validBits, channelMask, then the sub-format GUID whose first two bytes are the tag
+        if (fmt->size < 40) return fail("truncated WAVE_FORMAT_EXTENSIBLE");
+        tag = le16(f + 24);
+    }
+    if (channels_ == 0 || sampleRate_ == 0) return fail("bad fmt chunk");
+
+    if (tag == kFormatPcm && bitsPerSample_ == 16) format_ = SampleFormat::Pcm16;
+    else if (tag == kFormatPcm && bitsPerSample_ == 24) format_ = SampleFormat::Pcm24;
+    else if (tag == kFormatPcm && bitsPerSample_ == 32) format_ = SampleFormat::Pcm32;
+    else if (tag == kFormatFloat && bitsPerSample_ == 32) format_ = SampleFormat::Float32;
+    else return fail("unsupported sample format");
+    if (bytesPerFrame_ != channels_ * (bitsPerSample_ / 8)) return fail("bad block alignment");
+
+    data_ = map_ + data->offset;
+    frames_ = data->size / bytesPerFrame_;
+    return true;
+}
+
+const MappedWavFile::Chunk* MappedWavFile::findChunk(const char* id) const {
+    for (const Chunk& chunk : chunks_) {
+        if (std::memcmp(chunk.id, id, 4) == 0) return &chunk;
+    }
+    return nullptr;
+}
+
+size_t MappedWavFile::readFrames(size_t frame, size_t count, float* interleaved) const {
+    if (!data_ || frame >= frames_) return 0;
+    count = std::min(count, frames_ - frame);
+    const uint8_t* src = frameData(frame);
+    const size_t samples = count * channels_;
+    switch (format_) {
+        case SampleFormat::Pcm16: kernels::pcm16ToFloat(src, interleaved, samples); break;
+        case SampleFormat::Pcm24: kernels::pcm24ToFloat(src, interleaved, samples); break;
+        case SampleFormat::Pcm32: kernels::pcm32ToFloat(src, interleaved, samples); break;
+        case SampleFormat::Float32: kernels::float32ToFloat(src, interleaved, samples); break;
+    }
+    return count;
+}
+
+void MappedWavFile::prefetch(size_t frame, size_t count) const {
+    if (!data_ || frame >= frames_) return;
+    count = std::min(count, frames_ - frame);
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(frameData(frame)) & ~(page - 1);
+    const uintptr_t end = reinterpret_cast<uintptr_t>(frameData(frame + count));
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+}
+
+} // namespace guitarrackcraft
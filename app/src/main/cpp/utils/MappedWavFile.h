@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Read-only WAV file mapped into memory. open() indexes the RIFF chunks once and
+ * validates "fmt "; sample data is then exposed as a zero-copy view and converted
+ * to float on demand with the AudioKernels PCM kernels, so reading a file never
+ * holds more than the mapping plus the caller's output buffer.
+ *
+ * Supports 16/24/32-bit integer PCM and 32-bit IEEE float, plain or
+ * WAVE_FORMAT_EXTENSIBLE, any channel count.
+ */
+class MappedWavFile {
+public:
+    enum class SampleFormat { Pcm16, Pcm24, Pcm32, Float32 };
+
+    struct Chunk {
+        char id[4];
+        size_t offset;  // of the chunk body, from the start of the file
+        size_t size;    // body bytes, clamped to the file
+    };
+
+    MappedWavFile() = default;
+    ~MappedWavFile() { close(); }
+
+    MappedWavFile(const MappedWavFile&) = delete;
+    MappedWavFile& operator=(const MappedWavFile&) = delete;
+
+    /** Map and index path. On failure returns false and error() says why. */
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data_ != nullptr; }
+    const std::string& error() const { return error_; }
+
+    const std::vector<Chunk>& chunks() const { return chunks_; }
+    /** First chunk with the given four-character id, or nullptr. */
+    const Chunk* findChunk(const char* id) const;
+
+    SampleFormat format() const { return format_; }
+    uint32_t sampleRate() const { return sampleRate_; }
+    uint32_t channels() const { return channels_; }
+    uint32_t bitsPerSample() const { return bitsPerSample_; }
+    uint32_t bytesPerFrame() const { return bytesPerFrame_; }
+    size_t frames() const { return frames_; }
+
+    /** Raw little-endian bytes of frame; valid while the file is open. */
+    const uint8_t* frameData(size_t frame) const { return data_ + frame * bytesPerFrame_; }
+
+    /**
+     * Convert up to count frames starting at frame into interleaved floats
+     * (count * channels() values). Returns the frames converted.
+     */
+    size_t readFrames(size_t frame, size_t count, float* interleaved) const;
+
+    /** Hint the kernel to read ahead [frame, frame + count) for sequential access. */
+    void prefetch(size_t frame, size_t count) const;
+
+private:
+    bool index();
+    bool fail(const char* message);
+
+    const uint8_t* map_ = nullptr;
+    size_t mapSize_ = 0;
+    const uint8_t* data_ = nullptr;
+    std::vector<Chunk> chunks_;
+    std::string error_;
+
+    SampleFormat format_ = SampleFormat::Pcm16;
+    uint32_t sampleRate_ = 0;
+    uint32_t channels_ = 0;
+    uint32_t bitsPerSample_ = 0;
+    uint32_t bytesPerFrame_ = 0;
+    size_t frames_ = 0;
+};
+
+} // namespace guitarrackcraft
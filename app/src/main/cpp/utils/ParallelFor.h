@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "ThreadPolicy.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Run fn(i) for every i in [0, count) across up to maxThreads threads (0: one per core),
+ * the calling thread included. Items are handed out one at a time, so uneven items balance
+ * themselves. Blocks until all are done; fn must be safe to call concurrently.
+ * Spawned helpers run as ThreadRole::Background.
+ */
+template <typename Fn>
+void parallelFor(size_t count, Fn&& fn, size_t maxThreads = 0) {
+    if (count == 0) return;
+    size_t threads = maxThreads != 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, count);
+
+    std::atomic<size_t> next{0};
+    auto drain = [&] {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) fn(i);
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) {
+        pool.emplace_back([&] {
+            applyThreadRole(ThreadRole::Background);
+            drain();
+        });
+    }
+    drain();
+    for (auto& thread : pool) thread.join();
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "PerformanceHint.h"
+#include <dlfcn.h>
+
+namespace guitarrackcraft {
+
+namespace {
+
+// NDK android/performance_hint.h, resolved from libandroid.so so minSdk stays below 33.
+struct HintApi {
+    using GetManager = void* (*)();
+    using CreateSession = void* (*)(void* manager, const int32_t* tids, size_t size, int64_t targetNs);
+    using UpdateTarget = int (*)(void* session, int64_t targetNs);
+    using ReportActual = int (*)(void* session, int64_t actualNs);
+    using SetThreads = int (*)(void* session, const int32_t* tids, size_t size);
+    using CloseSession = void (*)(void* session);
+
+    GetManager getManager = nullptr;
+    CreateSession createSession = nullptr;
+    UpdateTarget updateTarget = nullptr;
+    ReportActual reportActual = nullptr;
+    SetThreads setThreads = nullptr;  // API 34
+    CloseSession closeSession = nullptr;
+    void* manager = nullptr;
+
+    HintApi() {
+        void* lib = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+        if (!lib) return;
+        getManager = reinterpret_cast<GetManager>(dlsym(lib, "APerformanceHint_getManager"));
+        createSession = reinterpret_cast<CreateSession>(dlsym(lib, "APerformanceHint_createSession"));
+        updateTarget = reinterpret_cast<UpdateTarget>(dlsym(lib, "APerformanceHint_updateTargetWorkDuration"));
+        reportActual = reinterpret_cast<ReportActual>(dlsym(lib, "APerformanceHint_reportActualWorkDuration"));
+        setThreads = reinterpret_cast<SetThreads>(dlsym(lib, "APerformanceHint_setThreads"));
+        closeSession = reinterpret_cast<CloseSession>(dlsym(lib, "APerformanceHint_closeSession"));
+        if (getManager && createSession && updateTarget && reportActual && closeSession) {
+            manager = getManager();
+        }
+    }
+
+    static const HintApi& get() {
+        static const HintApi api;
+        return api;
+    }
+};
+
+} // namespace
+
+bool PerformanceHintSession::available() {
+    return HintApi::get().manager != nullptr;
+}
+
+bool PerformanceHintSession::open(const std::vector<int32_t>& threadIds, int64_t targetDurationNs) {
+    close();
+    const HintApi& api = HintApi::get();
+    if (!api.manager || threadIds.empty() || targetDurationNs <= 0) return false;
+    session_ = api.createSession(api.manager, threadIds.data(), threadIds.size(), targetDurationNs);
+    targetNs_ = session_ ? targetDurationNs : 0;
+    return session_ != nullptr;
+}
+
+bool PerformanceHintSession::setThreads(const std::vector<int32_t>& threadIds) {
+    const HintApi& api = HintApi::get();
+    if (!session_ || !api.setThreads || threadIds.empty()) return false;
+    return api.setThreads(session_, threadIds.data(), threadIds.size()) == 0;
+}
+
+void PerformanceHintSession::updateTarget(int64_t targetDurationNs) {
+    if (!session_ || targetDurationNs <= 0 || targetDurationNs == targetNs_) return;
+    if (HintApi::get().updateTarget(session_, targetDurationNs) == 0) {
+        targetNs_ = targetDurationNs;
+    }
+}
+
+void PerformanceHintSession::reportActual(int64_t actualDurationNs) {
+    if (session_ && actualDurationNs > 0) {
+        HintApi::get().reportActual(session_, actualDurationNs);
+    }
+}
+
+void PerformanceHintSession::close() {
+    if (session_) {
+        HintApi::get().closeSession(session_);
+        session_ = nullptr;
+        targetNs_ = 0;
+    }
+}
+
+} // namespace guitarrackcraft
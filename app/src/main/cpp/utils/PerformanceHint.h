@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Android Dynamic Performance Framework session (APerformanceHintManager, API 33+)
+ * for a set of threads doing periodic work against a deadline. Reporting each
+ * period's actual duration lets the governor keep clocks just high enough for
+ * the target rather than dropping them in quiet passages or pinning them high.
+ *
+ * The NDK entry points are looked up at runtime so the app still runs on older
+ * releases, where open() simply fails. open(), setThreads() and close() make
+ * binder calls and belong on a control thread; reportActual() is meant for the
+ * worker's own thread once per period.
+ */
+class PerformanceHintSession {
+public:
+    PerformanceHintSession() = default;
+    ~PerformanceHintSession() { close(); }
+
+    PerformanceHintSession(const PerformanceHintSession&) = delete;
+    PerformanceHintSession& operator=(const PerformanceHintSession&) = delete;
+
+    /** True if this OS offers performance hint sessions. */
+    static bool available();
+
+    bool open(const std::vector<int32_t>& threadIds, int64_t targetDurationNs);
+
+    /** Replace the thread set (API 34+); false if unsupported, in which case reopen. */
+    bool setThreads(const std::vector<int32_t>& threadIds);
+
+    void updateTarget(int64_t targetDurationNs);
+    void reportActual(int64_t actualDurationNs);
+    void close();
+
+    bool isOpen() const { return session_ != nullptr; }
+    int64_t targetDurationNs() const { return targetNs_; }
+
+private:
+    void* session_ = nullptr;  // APerformanceHintSession*
+    int64_t targetNs_ = 0;
+};
+
+} // namespace guitarrackcraft
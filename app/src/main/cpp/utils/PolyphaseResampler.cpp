@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PolyphaseResampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <utility>
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define GRC_RESAMPLER_NEON 1
+#endif
+
+namespace guitarrackcraft {
+
+struct PolyphaseResampler::Table {
+    bool exact = true;
+    uint32_t rows = 0;  // exact: L; otherwise kInterpolatedPhases + 1 (last row closes the interval)
+    uint32_t taps = 0;
+    std::vector<float> coeffs;  // rows * taps
+
+    const float* row(uint32_t r) const { return coeffs.data() + static_cast<size_t>(r) * taps; }
+};
+
+namespace {
+
+constexpr uint64_t kFracOne = 1ull << 32;
+
+double besselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    const double q = x * x * 0.25;
+    for (int k = 1; k < 64 && term > sum * 1e-12; ++k) {
+        term *= q / (static_cast<double>(k) * k);
+        sum += term;
+    }
+    return sum;
+}
+
+std::shared_ptr<const PolyphaseResampler::Table> buildTable(uint64_t up, uint64_t down) {
+    auto table = std::make_shared<PolyphaseResampler::Table>();
+    table->exact = up <= PolyphaseResampler::kMaxExactPhases;
+    table->rows = table->exact ? static_cast<uint32_t>(up) : PolyphaseResampler::kInterpolatedPhases + 1;
+    const uint32_t phases = table->exact ? table->rows : PolyphaseResampler::kInterpolatedPhases;
+
+    // Cutoff in cycles per input sample, below whichever Nyquist is lower
+    const double cutoff = 0.5 * PolyphaseResampler::kPassband *
+                          std::min(1.0, static_cast<double>(up) / static_cast<double>(down));
+    const uint32_t half = static_cast<uint32_t>(std::ceil(PolyphaseResampler::kZeroCrossings / (2.0 * cutoff)));
+    table->taps = (2 * half + 3) & ~3u;  // multiple of 4 for the vector dot product
+    const double radius = table->taps / 2.0;
+    const double norm = besselI0(PolyphaseResampler::kKaiserBeta);
+
+    table->coeffs.resize(static_cast<size_t>(table->rows) * table->taps);
+    for (uint32_t r = 0; r < table->rows; ++r) {
+        const double frac = static_cast<double>(r) / phases;
+        float* row = table->coeffs.data() + static_cast<size_t>(r) * table->taps;
+        double sum = 0.0;
+        for (uint32_t k = 0; k < table->taps; ++k) {
+            // Distance from the output instant to input sample k of the window
+            const double d = frac + (table->taps / 2 - 1) - k;
+            const double x = d / radius;
+            double h = 0.0;
+            if (std::fabs(x) < 1.0) {
+                const double arg = 2.0 * cutoff * d;
+                const double sinc = arg == 0.0 ? 1.0 : std::sin(M_PI * arg) / (M_PI * arg);
+                h = 2.0 * cutoff * sinc * besselI0(PolyphaseResampler::kKaiserBeta * std::sqrt(1.0 - x * x)) / norm;
+            }
+            row[k] = static_cast<float>(h);
+            sum += h;
+        }
+        for (uint32_t k = 0; k < table->taps; ++k) row[k] = static_cast<float>(row[k] / sum);  // unity DC gain
+    }
+    return table;
+}
+
+/** Tables depend only on the reduced ratio; build each once per process. */
+std::shared_ptr<const PolyphaseResampler::Table> tableFor(uint64_t up, uint64_t down) {
+    static std::mutex mutex;
+    static std::map<std::pair<uint64_t, uint64_t>, std::shared_ptr<const PolyphaseResampler::Table>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = cache[{up, down}];
+    if (!entry) entry = buildTable(up, down);
+    return entry;
+}
+
+} // namespace
+
+PolyphaseResampler::PolyphaseResampler() = default;
+PolyphaseResampler::~PolyphaseResampler() = default;
+
+float PolyphaseResampler::dot(const float* a, const float* b, size_t n) {
+#if GRC_RESAMPLER_NEON
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = acc0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    for (; i < n; i += 4) acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    const float32x4_t acc = vaddq_f32(acc0, acc1);
+#if defined(__aarch64__)
+    return vaddvq_f32(acc);
+#else
+    float32x2_t s = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    return vget_lane_f32(vpadd_f32(s, s), 0);
+#endif
+#else
+    float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (size_t i = 0; i < n; i += 4) {
+        acc[0] += a[i] * b[i];
+        acc[1] += a[i + 1] * b[i + 1];
+        acc[2] += a[i + 2] * b[i + 2];
+        acc[3] += a[i + 3] * b[i + 3];
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+}
+
+bool PolyphaseResampler::configure(uint32_t inRate, uint32_t outRate, uint32_t channels,
+                                   size_t maxInputFrames) {
+    if (inRate == 0 || outRate == 0 || channels == 0 || maxInputFrames == 0) return false;
+    const uint64_t g = std::gcd(inRate, outRate);
+    up_ = outRate / g;
+    down_ = inRate / g;
+    channels_ = channels;
+    maxInput_ = maxInputFrames;
+    passthrough_ = up_ == down_;
+    if (passthrough_) {
+        table_.reset();
+        taps_ = 0;
+        buffer_.clear();
+        return true;
+    }
+
+    table_ = tableFor(up_, down_);
+    taps_ = table_->taps;
+    step_ = static_cast<uint64_t>(std::llround(static_cast<double>(down_) / up_ * kFracOne));
+    buffer_.assign(channels_, std::vector<float>(2 * taps_ + maxInput_, 0.0f));
+    scratch_.assign(taps_, 0.0f);
+    reset();
+    return true;
+}
+
+void PolyphaseResampler::reset() {
+    // Priming with half a window of silence puts input frame 0 under the centre
+    // of the first output's kernel: no look-ahead delay in the output.
+    for (auto& channel : buffer_) std::fill(channel.begin(), channel.end(), 0.0f);
+    length_ = taps_ / 2 - 1;
+    pos_ = 0;
+    phase_ = 0;
+    inputTotal_ = 0;
+    outputTotal_ = 0;
+}
+
+size_t PolyphaseResampler::maxOutputFrames(size_t frames) const {
+    if (passthrough_) return frames;
+    return static_cast<size_t>(((frames + taps_) * up_ + down_ - 1) / down_) + 1;
+}
+
+size_t PolyphaseResampler::outputFramesFor(size_t frames) const {
+    if (passthrough_) return frames;
+    return static_cast<size_t>((frames * up_ + down_ - 1) / down_);
+}
+
+size_t PolyphaseResampler::process(const float* const* in, size_t frames, float* const* out) {
+    frames = std::min(frames, maxInput_);
+    if (passthrough_) {
+        for (uint32_t c = 0; c < channels_; ++c) std::memcpy(out[c], in[c], frames * sizeof(float));
+        return frames;
+    }
+    for (uint32_t c = 0; c < channels_; ++c) {
+        std::memcpy(buffer_[c].data() + length_, in[c], frames * sizeof(float));
+    }
+    length_ += frames;
+    inputTotal_ += frames;
+    return run(out, SIZE_MAX);
+}
+
+size_t PolyphaseResampler::flush(float* const* out) {
+    if (passthrough_) return 0;
+    const uint64_t expected = outputFramesFor(static_cast<size_t>(inputTotal_));
+    if (outputTotal_ >= expected) return 0;
+    // Half a window of silence lets the last real frames reach the kernel centre.
+    for (uint32_t c = 0; c < channels_; ++c) {
+        std::fill(buffer_[c].begin() + length_, buffer_[c].begin() + length_ + taps_, 0.0f);
+    }
+    length_ += taps_;
+    return run(out, static_cast<size_t>(expected - outputTotal_));
+}
+
+size_t PolyphaseResampler::run(float* const* out, size_t limit) {
+    const Table& table = *table_;
+    size_t produced = 0;
+    while (pos_ + taps_ <= length_ && produced < limit) {
+        const float* coeffs;
+        if (table.exact) {
+            coeffs = table.row(static_cast<uint32_t>(phase_));
+        } else {
+            // Blend the two table rows around the fractional position
+            const uint64_t scaled = phase_ * kInterpolatedPhases;
+            const uint32_t r = static_cast<uint32_t>(scaled >> 32);
+            const float alpha = static_cast<float>(scaled & (kFracOne - 1)) / static_cast<float>(kFracOne);
+            const float* a = table.row(r);
+            const float* b = table.row(r + 1);
+            for (uint32_t k = 0; k < taps_; ++k) scratch_[k] = a[k] + (b[k] - a[k]) * alpha;
+            coeffs = scratch_.data();
+        }
+        for (uint32_t c = 0; c < channels_; ++c) {
+            out[c][produced] = dot(buffer_[c].data() + pos_, coeffs, taps_);
+        }
+        ++produced;
+
+        if (table.exact) {
+            phase_ += down_;
+            pos_ += static_cast<size_t>(phase_ / up_);
+            phase_ %= up_;
+        } else {
+            phase_ += step_;
+            pos_ += static_cast<size_t>(phase_ >> 32);
+            phase_ &= kFracOne - 1;
+        }
+    }
+
+    // Keep only the frames later outputs still need
+    const size_t keep = length_ - std::min(pos_, length_);
+    if (pos_ > 0) {
+        for (uint32_t c = 0; c < channels_; ++c) {
+            std::memmove(buffer_[c].data(), buffer_[c].data() + pos_, keep * sizeof(float));
+        }
+    }
+    pos_ -= length_ - keep;
+    length_ = keep;
+    outputTotal_ += produced;
+    return produced;
+}
+
+} // namespace guitarrackcraft
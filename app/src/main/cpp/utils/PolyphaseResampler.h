@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Streaming windowed-sinc sample-rate converter for planar float audio.
+ *
+ * The rate ratio is reduced to L/M. When L is small enough (44.1 <-> 48 kHz is
+ * 160/147, 96 -> 48 kHz is 1/2) each output phase has its own exact row of
+ * Kaiser-windowed sinc taps; other ratios interpolate between rows of a finer
+ * table. Tables depend only on the ratio, so they are built once and shared by
+ * every instance. For downsampling the cutoff follows the output Nyquist, so
+ * nothing above it aliases back.
+ *
+ * The filter's look-ahead is compensated: output frame n lines up with input time
+ * n * inRate / outRate, and after flush() exactly outputFramesFor(total input)
+ * frames have been produced. Not real-time safe to configure; process() and
+ * flush() do not allocate.
+ */
+class PolyphaseResampler {
+public:
+    static constexpr uint32_t kZeroCrossings = 16;   // per side of the kernel
+    static constexpr uint32_t kMaxExactPhases = 512;
+    static constexpr uint32_t kInterpolatedPhases = 256;
+    static constexpr float kPassband = 0.91f;        // cutoff relative to the lower Nyquist
+    static constexpr double kKaiserBeta = 8.0;       // ~80 dB stopband
+
+    PolyphaseResampler();
+    ~PolyphaseResampler();
+
+    /**
+     * Prepare for inRate -> outRate on channels planar channels, fed at most
+     * maxInputFrames per process() call. Returns false on invalid arguments.
+     */
+    bool configure(uint32_t inRate, uint32_t outRate, uint32_t channels, size_t maxInputFrames);
+
+    /** Forget history and buffered input, e.g. after a seek. */
+    void reset();
+
+    /**
+     * Consume frames (<= maxInputFrames) from each in[c] and append the output
+     * that is now computable to out[c], which must hold maxOutputFrames(frames).
+     * Returns the frames written per channel.
+     */
+    size_t process(const float* const* in, size_t frames, float* const* out);
+
+    /** End of input: write the remaining tail (at most maxOutputFrames(taps())). */
+    size_t flush(float* const* out);
+
+    /** Upper bound on what process() writes for frames of input. */
+    size_t maxOutputFrames(size_t frames) const;
+
+    /** Output length for a whole input of frames. */
+    size_t outputFramesFor(size_t frames) const;
+
+    bool isPassthrough() const { return passthrough_; }
+    uint32_t taps() const { return taps_; }
+
+    /** Dot product of n floats; n a multiple of 4 (exposed for tests). */
+    static float dot(const float* a, const float* b, size_t n);
+
+    struct Table;
+
+private:
+    size_t run(float* const* out, size_t limit);
+
+    std::shared_ptr<const Table> table_;
+    bool passthrough_ = true;
+    uint32_t channels_ = 0;
+    uint32_t taps_ = 0;
+    uint64_t up_ = 1;     // L
+    uint64_t down_ = 1;   // M
+    uint64_t step_ = 0;   // non-exact: input frames per output frame, 32.32 fixed point
+    size_t maxInput_ = 0;
+
+    // Buffered input per channel: window for the next output starts at pos_
+    std::vector<std::vector<float>> buffer_;
+    std::vector<float> scratch_;  // interpolated taps for the non-exact path
+    size_t length_ = 0;
+    size_t pos_ = 0;
+    uint64_t phase_ = 0;          // exact: numerator in [0, L); else fraction in 2^32 units
+    uint64_t inputTotal_ = 0;
+    uint64_t outputTotal_ = 0;
+};
+
+} // namespace guitarrackcraft
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "RtArena.h"
+#include "RtMemory.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace guitarrackcraft {
+
+RtArena::~RtArena() {
+    release();
+}
+
+size_t RtArena::reserve(size_t bytes) {
+    const size_t offset = reserved_;
+    reserved_ += (bytes + kAlignment - 1) & ~(kAlignment - 1);
+    return offset;
+}
+
+bool RtArena::allocate() {
+    release();
+    if (reserved_ == 0) return true;
+    void* block = nullptr;
+    if (posix_memalign(&block, kAlignment, reserved_) != 0) return false;
+    base_ = static_cast<uint8_t*>(block);
+    size_ = reserved_;
+    // Writing every byte also takes the page faults here instead of on the audio thread
+    std::memset(base_, 0, size_);
+    return true;
+}
+
+void RtArena::reset() {
+    release();
+    reserved_ = 0;
+}
+
+bool RtArena::lock() {
+    if (!locked_ && size_ > 0) locked_ = rt_memory::lock(base_, size_);
+    return locked_ || size_ == 0;
+}
+
+void RtArena::unlock() {
+    if (locked_) rt_memory::unlock(base_, size_);
+    locked_ = false;
+}
+
+void RtArena::release() {
+    unlock();
+    std::free(base_);
+    base_ = nullptr;
+    size_ = 0;
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace guitarrackcraft {
+
+/**
+ * One allocation for a set of real-time buffers. The owner lays it out with reserve(),
+ * in the order the audio thread walks the regions, then allocate() backs every region
+ * with a single kAlignment-aligned block that is zeroed, so all its pages are faulted in
+ * before the first callback touches them. Pointers from at() stay valid until the next
+ * allocate() or reset(). Not thread safe; lay out and allocate while nothing processes.
+ */
+class RtArena {
+public:
+    static constexpr size_t kAlignment = 64;
+
+    RtArena() = default;
+    ~RtArena();
+    RtArena(const RtArena&) = delete;
+    RtArena& operator=(const RtArena&) = delete;
+
+    /** Add a region of 'bytes' (rounded up to kAlignment); returns its offset. */
+    size_t reserve(size_t bytes);
+
+    /** Back the layout with zeroed, prefaulted storage, replacing any earlier block. */
+    bool allocate();
+
+    /** Free the storage and forget the layout. */
+    void reset();
+
+    /** Pin the current block in RAM (rt_memory::lock) until it is freed; false if refused. */
+    bool lock();
+    void unlock();
+    bool locked() const { return locked_; }
+
+    template <typename T>
+    T* at(size_t offset) const { return reinterpret_cast<T*>(base_ + offset); }
+
+    /** Bytes laid out so far, and bytes currently allocated. */
+    size_t reserved() const { return reserved_; }
+    size_t size() const { return size_; }
+
+private:
+    uint8_t* base_ = nullptr;
+    size_t reserved_ = 0;
+    size_t size_ = 0;
+    bool locked_ = false;
+
+    void release();
+};
+
+} // namespace guitarrackcraft
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "RtGuard.h"
+#include <mutex>
+#include <pthread.h>
+#include <set>
+
+namespace guitarrackcraft {
+namespace rt_guard {
+
+const char* const kHostOwner = "host";
+
+namespace {
+
+// Written by the armed thread only; plain loads and stores keep note() free of locks.
+struct OwnerSlot {
+    std::atomic<const char*> owner{nullptr};
+    std::atomic<uint32_t> kinds{0};
+    std::atomic<uint32_t> count{0};
+};
+
+std::atomic<bool> g_armed{false};
+std::atomic<pthread_t> g_armedThread{};
+std::atomic<const char*> g_owner{nullptr};
+OwnerSlot g_slots[kMaxOwners];
+
+std::mutex g_reportMutex;  // takeOffenders() and intern()
+uint32_t g_reported[kMaxOwners] = {};
+
+bool onArmedThread() {
+    return g_armed.load(std::memory_order_relaxed) &&
+           pthread_equal(g_armedThread.load(std::memory_order_relaxed), pthread_self());
+}
+
+} // namespace
+
+void armThread() {
+    g_armedThread.store(pthread_self(), std::memory_order_relaxed);
+    g_owner.store(nullptr, std::memory_order_relaxed);
+    g_armed.store(true, std::memory_order_release);
+}
+
+void disarm() {
+    g_armed.store(false, std::memory_order_release);
+}
+
+Scope::Scope(const char* owner) : previous_(g_owner.load(std::memory_order_relaxed)) {
+    g_owner.store(owner, std::memory_order_relaxed);
+}
+
+Scope::~Scope() {
+    g_owner.store(previous_, std::memory_order_relaxed);
+}
+
+void note(Kind kind) {
+    if (!onArmedThread()) return;
+    const char* owner = g_owner.load(std::memory_order_relaxed);
+    if (!owner) owner = kHostOwner;
+    uint32_t i = 0;
+    for (; i + 1 < kMaxOwners; ++i) {
+        const char* slotOwner = g_slots[i].owner.load(std::memory_order_relaxed);
+        if (slotOwner == owner) break;
+        if (!slotOwner) {
+            g_slots[i].owner.store(owner, std::memory_order_release);
+            break;
+        }
+    }
+    OwnerSlot& slot = g_slots[i];
+    if (i + 1 == kMaxOwners && !slot.owner.load(std::memory_order_relaxed)) {
+        slot.owner.store(owner, std::memory_order_release);
+    }
+    slot.kinds.store(slot.kinds.load(std::memory_order_relaxed) | kind, std::memory_order_relaxed);
+    slot.count.store(slot.count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+std::vector<Offender> takeOffenders() {
+    std::vector<Offender> offenders;
+    std::lock_guard<std::mutex> lock(g_reportMutex);
+    for (uint32_t i = 0; i < kMaxOwners; ++i) {
+        const char* owner = g_slots[i].owner.load(std::memory_order_acquire);
+        if (!owner) break;
+        const uint32_t count = g_slots[i].count.load(std::memory_order_acquire);
+        if (count == g_reported[i]) continue;
+        g_reported[i] = count;
+        offenders.push_back({owner, g_slots[i].kinds.load(std::memory_order_relaxed), count});
+    }
+    return offenders;
+}
+
+const char* intern(const std::string& name) {
+    static std::set<std::string> names;
+    std::lock_guard<std::mutex> lock(g_reportMutex);
+    return names.insert(name).first->c_str();
+}
+
+} // namespace rt_guard
+} // namespace guitarrackcraft
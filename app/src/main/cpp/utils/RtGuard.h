@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Debug check that nothing on the audio thread allocates, frees or blocks on a mutex. The
+ * callback thread arms itself; PluginChain names the plugin it is running with a Scope; the
+ * hooks in RtGuardHooks.cpp (debug builds, GRC_RT_GUARD) call note() on every malloc, free
+ * and pthread_mutex_lock, and calls on the armed thread are tallied per owner. A control
+ * thread collects new offenders with takeOffenders() and logs them.
+ *
+ * Host code is always covered. Plugins are covered where their calls reach the hooks: on
+ * desktop builds the interposers see the whole process; on Android, plugins loaded with
+ * dlopen bind to libc directly, so their allocations are seen only through libc's malloc
+ * hooks (Android 9+, LIBC_HOOKS_ENABLE=1 in wrap.sh) and their mutex locks not at all.
+ * Only the callback thread is armed; plugins running on chain workers are not checked.
+ */
+namespace rt_guard {
+
+enum Kind : uint32_t {
+    kMalloc = 1u << 0,  // malloc, calloc, realloc, operator new
+    kFree = 1u << 1,
+    kMutexLock = 1u << 2,
+};
+
+/** Maximum distinct owners tallied; later ones are folded into the last slot. */
+constexpr uint32_t kMaxOwners = 32;
+
+/** Owner reported for calls outside any plugin Scope. */
+extern const char* const kHostOwner;
+
+/** Guard the calling thread, replacing any previously armed one. */
+void armThread();
+/** Stop guarding; any thread. */
+void disarm();
+
+/** Attribute guarded calls to 'owner' (an intern()ed name) until destroyed. Armed thread only. */
+class Scope {
+public:
+    explicit Scope(const char* owner);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* previous_;
+};
+
+/** Tally one call of 'kind' if the calling thread is armed. No allocation, no locks. */
+void note(Kind kind);
+
+struct Offender {
+    const char* owner;
+    uint32_t kinds;  // Kind bits seen so far
+    uint32_t count;  // guarded calls so far
+};
+/** Owners with calls since the previous takeOffenders(); control thread only. */
+std::vector<Offender> takeOffenders();
+
+/** Stable copy of 'name' for Scope; never freed, so owners outlive their plugins. */
+const char* intern(const std::string& name);
+
+} // namespace rt_guard
+
+} // namespace guitarrackcraft
+
+#if defined(GRC_RT_GUARD) && GRC_RT_GUARD
+#define RT_GUARD_CONCAT_(a, b) a##b
+#define RT_GUARD_CONCAT(a, b) RT_GUARD_CONCAT_(a, b)
+#define RT_GUARD_SCOPE(owner) \
+    const ::guitarrackcraft::rt_guard::Scope RT_GUARD_CONCAT(rtGuardScope_, __LINE__)(owner)
+#else
+#define RT_GUARD_SCOPE(owner) do {} while (0)
+#endif
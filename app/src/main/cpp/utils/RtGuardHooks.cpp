@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Debug-build interposers feeding rt_guard::note(). Compiled only with GRC_RT_GUARD and
+ * linked straight into libguitarrackcraft.so (a static archive would drop them, since
+ * nothing references these symbols). Each forwards to the definition it shadows; the
+ * checks cost one relaxed load when no thread is armed.
+ */
+#if defined(GRC_RT_GUARD) && GRC_RT_GUARD
+
+#include "RtGuard.h"
+#include <atomic>
+#include <cstddef>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdlib.h>
+#if defined(__ANDROID__)
+#include <sys/system_properties.h>
+#endif
+
+using guitarrackcraft::rt_guard::Kind;
+using guitarrackcraft::rt_guard::note;
+
+namespace {
+
+using MallocFn = void* (*)(size_t);
+using CallocFn = void* (*)(size_t, size_t);
+using ReallocFn = void* (*)(void*, size_t);
+using FreeFn = void (*)(void*);
+using MutexLockFn = int (*)(pthread_mutex_t*);
+
+// Resolved on first use; dlsym of a function is served by the dynamic linker without
+// locking through the interposed pthread_mutex_lock.
+template <typename Fn>
+Fn resolveNext(std::atomic<Fn>& cache, const char* name) {
+    Fn fn = cache.load(std::memory_order_relaxed);
+    if (!fn) {
+        fn = reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+        cache.store(fn, std::memory_order_relaxed);
+    }
+    return fn;
+}
+std::atomic<MutexLockFn> g_mutexLock{nullptr};
+MutexLockFn realMutexLock() { return resolveNext(g_mutexLock, "pthread_mutex_lock"); }
+
+#if defined(__GLIBC__)
+} // namespace
+// glibc exports its allocator under these names, so forwarding needs no dlsym (whose own
+// allocations would recurse into the hooks before the pointers are resolved).
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void __libc_free(void*);
+namespace {
+MallocFn realMalloc() { return __libc_malloc; }
+CallocFn realCalloc() { return __libc_calloc; }
+ReallocFn realRealloc() { return __libc_realloc; }
+FreeFn realFree() { return __libc_free; }
+#else
+// Bionic's dlsym is served by the linker's own allocator, so lazy resolution cannot recurse.
+std::atomic<MallocFn> g_malloc{nullptr};
+std::atomic<CallocFn> g_calloc{nullptr};
+std::atomic<ReallocFn> g_realloc{nullptr};
+std::atomic<FreeFn> g_free{nullptr};
+MallocFn realMalloc() { return resolveNext(g_malloc, "malloc"); }
+CallocFn realCalloc() { return resolveNext(g_calloc, "calloc"); }
+ReallocFn realRealloc() { return resolveNext(g_realloc, "realloc"); }
+FreeFn realFree() { return resolveNext(g_free, "free"); }
+#endif
+
+// Set once libc's own hooks report every allocation; the interposers then only forward.
+std::atomic<bool> g_libcHooked{false};
+
+void noteAllocation(Kind kind) {
+    if (!g_libcHooked.load(std::memory_order_relaxed)) note(kind);
+}
+
+#if defined(__ANDROID__)
+// Bionic's malloc hooks (Android 9+, active when the process starts with LIBC_HOOKS_ENABLE=1)
+// see allocations from every library, plugins included. Resolved at run time: minSdk predates
+// their declarations.
+using MallocHook = void* (*)(size_t, const void*);
+using ReallocHook = void* (*)(void*, size_t, const void*);
+using FreeHook = void (*)(void*, const void*);
+using MemalignHook = void* (*)(size_t, size_t, const void*);
+
+MallocHook g_nextMallocHook = nullptr;
+ReallocHook g_nextReallocHook = nullptr;
+FreeHook g_nextFreeHook = nullptr;
+MemalignHook g_nextMemalignHook = nullptr;
+
+void* mallocHook(size_t size, const void* caller) {
+    note(guitarrackcraft::rt_guard::kMalloc);
+    return g_nextMallocHook(size, caller);
+}
+void* reallocHook(void* ptr, size_t size, const void* caller) {
+    note(guitarrackcraft::rt_guard::kMalloc);
+    return g_nextReallocHook(ptr, size, caller);
+}
+void freeHook(void* ptr, const void* caller) {
+    if (ptr) note(guitarrackcraft::rt_guard::kFree);
+    g_nextFreeHook(ptr, caller);
+}
+void* memalignHook(size_t alignment, size_t size, const void* caller) {
+    note(guitarrackcraft::rt_guard::kMalloc);
+    return g_nextMemalignHook(alignment, size, caller);
+}
+
+/** Whether libc dispatches through the hooks; otherwise writing them has no effect. */
+bool libcHooksEnabled() {
+    const char* env = getenv("LIBC_HOOKS_ENABLE");
+    if (env && env[0] != '\0' && env[0] != '0') return true;
+    char value[PROP_VALUE_MAX] = {};
+    return __system_property_get("libc.debug.hooks.enable", value) > 0 && value[0] == '1';
+}
+
+template <typename Hook>
+Hook* hookSlot(const char* name) {
+    return static_cast<Hook*>(dlsym(RTLD_DEFAULT, name));
+}
+
+__attribute__((constructor)) void installLibcHooks() {
+    if (!libcHooksEnabled()) return;
+    auto* mallocSlot = hookSlot<MallocHook>("__malloc_hook");
+    auto* reallocSlot = hookSlot<ReallocHook>("__realloc_hook");
+    auto* freeSlot = hookSlot<FreeHook>("__free_hook");
+    auto* memalignSlot = hookSlot<MemalignHook>("__memalign_hook");
+    if (!mallocSlot || !reallocSlot || !freeSlot || !memalignSlot || !*mallocSlot ||
+        !*reallocSlot || !*freeSlot || !*memalignSlot) {
+        return;
+    }
+    g_nextMallocHook = *mallocSlot;
+    g_nextReallocHook = *reallocSlot;
+    g_nextFreeHook = *freeSlot;
+    g_nextMemalignHook = *memalignSlot;
+    *memalignSlot = memalignHook;
+    *freeSlot = freeHook;
+    *reallocSlot = reallocHook;
+    *mallocSlot = mallocHook;
+    g_libcHooked.store(true, std::memory_order_relaxed);
+}
+#endif
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size) {
+    noteAllocation(guitarrackcraft::rt_guard::kMalloc);
+    return realMalloc()(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    noteAllocation(guitarrackcraft::rt_guard::kMalloc);
+    return realCalloc()(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    noteAllocation(guitarrackcraft::rt_guard::kMalloc);
+    return realRealloc()(ptr, size);
+}
+
+void free(void* ptr) {
+    if (ptr) noteAllocation(guitarrackcraft::rt_guard::kFree);
+    realFree()(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    note(guitarrackcraft::rt_guard::kMutexLock);
+    return realMutexLock()(mutex);
+}
+
+} // extern "C"
+
+#endif // GRC_RT_GUARD
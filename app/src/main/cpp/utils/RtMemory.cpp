@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "RtMemory.h"
+#include <alloca.h>
+#include <cstdint>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace guitarrackcraft {
+namespace rt_memory {
+
+namespace {
+
+size_t pageSize() {
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+/** Page-aligned span covering [data, data + bytes). */
+void pageSpan(const void* data, size_t bytes, uintptr_t& begin, size_t& length) {
+    const uintptr_t mask = ~(static_cast<uintptr_t>(pageSize()) - 1);
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(data);
+    begin = addr & mask;
+    length = ((addr + bytes + pageSize() - 1) & mask) - begin;
+}
+
+} // namespace
+
+bool lock(const void* data, size_t bytes) {
+    if (!data || bytes == 0) return true;
+    uintptr_t begin;
+    size_t length;
+    pageSpan(data, bytes, begin, length);
+    return mlock(reinterpret_cast<const void*>(begin), length) == 0;
+}
+
+void unlock(const void* data, size_t bytes) {
+    if (!data || bytes == 0) return;
+    uintptr_t begin;
+    size_t length;
+    pageSpan(data, bytes, begin, length);
+    munlock(reinterpret_cast<const void*>(begin), length);
+}
+
+void prefaultStack(size_t bytes, bool pin) {
+    if (bytes == 0) return;
+    // A frame of 'bytes' below this one: the pages a deep plugin call would reach
+    volatile char* frame = static_cast<volatile char*>(alloca(bytes));
+    const size_t page = pageSize();
+    for (size_t offset = 0; offset < bytes; offset += page) {
+        frame[offset] = 0;
+    }
+    frame[bytes - 1] = 0;
+    if (pin) lock(const_cast<const char*>(frame), bytes);
+}
+
+} // namespace rt_memory
+} // namespace guitarrackcraft
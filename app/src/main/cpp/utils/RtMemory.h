@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace guitarrackcraft {
+
+/**
+ * Keeping real-time memory resident. Fresh allocations fault their pages in when first
+ * written, and under memory pressure Android compresses idle anonymous pages into zram, so
+ * the audio thread can fault even on memory it has used for minutes. Writing buffers once
+ * when they are allocated (RtArena, zero-filled vectors) pays the first kind up front; lock()
+ * pins pages against the second. Locking is best effort: apps get a small RLIMIT_MEMLOCK
+ * budget, and a refused lock leaves the pages merely prefaulted.
+ */
+namespace rt_memory {
+
+/** Pin the pages of [data, data + bytes) in RAM; false when refused. Makes no log calls. */
+bool lock(const void* data, size_t bytes);
+void unlock(const void* data, size_t bytes);
+
+/** Fault in 'bytes' of the calling thread's stack below the current frame and, with 'pin',
+ *  lock them until the thread exits. Call from the thread itself, at a shallow frame. */
+void prefaultStack(size_t bytes, bool pin);
+
+} // namespace rt_memory
+
+} // namespace guitarrackcraft
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "RtTrace.h"
+#include "ThreadPolicy.h"
+#include "LogCompat.h"
+#include <chrono>
+#include <cstdio>
+
+#define LOG_TAG "RtTrace"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+
+namespace guitarrackcraft {
+
+namespace {
+constexpr auto kDrainInterval = std::chrono::milliseconds(100);
+}
+
+RtTrace& RtTrace::instance() {
+    static RtTrace trace;
+    return trace;
+}
+
+RtTrace::RtTrace() {
+    // Vyukov bounded queue: slot i is free for the producer at position i.
+    for (uint32_t i = 0; i < kCapacity; ++i) {
+        ring_[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
+
+void RtTrace::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread([this] { drainLoop(); });
+}
+
+void RtTrace::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void RtTrace::pushValues(const char* tag, const char* msg, const double* values, int count) {
+    uint64_t pos = head_.load(std::memory_order_relaxed);
+    Record* rec;
+    for (;;) {
+        rec = &ring_[pos & (kCapacity - 1)];
+        uint64_t seq = rec->seq.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = head_.load(std::memory_order_relaxed);
+        }
+    }
+    rec->tag = tag;
+    rec->msg = msg;
+    rec->count = count;
+    for (int i = 0; i < count; ++i) rec->values[i] = values[i];
+    rec->seq.store(pos + 1, std::memory_order_release);
+}
+
+bool RtTrace::pop(Record& out) {
+    Record& rec = ring_[tail_ & (kCapacity - 1)];
+    if (rec.seq.load(std::memory_order_acquire) != tail_ + 1) {
+        return false;
+    }
+    out.tag = rec.tag;
+    out.msg = rec.msg;
+    out.count = rec.count;
+    for (int i = 0; i < rec.count; ++i) out.values[i] = rec.values[i];
+    rec.seq.store(tail_ + kCapacity, std::memory_order_release);
+    ++tail_;
+    return true;
+}
+
+void RtTrace::drainLoop() {
+    applyThreadRole(ThreadRole::Background);
+    Record rec;
+    char text[160];
+    while (running_.load()) {
+        while (pop(rec)) {
+            int len = 0;
+            for (int i = 0; i < rec.count && len < static_cast<int>(sizeof(text)); ++i) {
+                len += std::snprintf(text + len, sizeof(text) - len, " %g", rec.values[i]);
+            }
+            if (len == 0) text[0] = '\0';
+            __android_log_print(ANDROID_LOG_INFO, rec.tag, "%s%s", rec.msg, text);
+        }
+        uint32_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            LOGI("dropped %u trace records", dropped);
+        }
+        std::this_thread::sleep_for(kDrainInterval);
+    }
+}
+
+} // namespace guitarrackcraft
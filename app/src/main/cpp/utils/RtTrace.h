@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace guitarrackcraft {
+
+/**
+ * Real-time safe trace ring. Audio and worker threads push fixed-size records
+ * (static tag and message strings plus up to four numbers) into a bounded
+ * lock-free MPSC queue; a background thread drains it to logcat. Records are
+ * dropped, never waited for, when the ring is full.
+ *
+ * Only compiled into builds with GRC_RT_TRACE (debug); otherwise the RT_TRACE
+ * macros expand to nothing and their arguments are not evaluated.
+ */
+class RtTrace {
+public:
+    static constexpr uint32_t kCapacity = 1024;  // power of 2
+    static constexpr int kMaxValues = 4;
+
+    static RtTrace& instance();
+
+    /** Start / stop the drain thread (control thread only). */
+    void start();
+    void stop();
+
+    template <typename... Args>
+    void push(const char* tag, const char* msg, Args... args) {
+        static_assert(sizeof...(Args) <= kMaxValues, "RT_TRACE takes at most 4 values");
+        const double values[kMaxValues + 1] = {static_cast<double>(args)..., 0.0};
+        pushValues(tag, msg, values, static_cast<int>(sizeof...(Args)));
+    }
+
+private:
+    struct Record {
+        std::atomic<uint64_t> seq{0};
+        const char* tag = nullptr;
+        const char* msg = nullptr;
+        int count = 0;
+        double values[kMaxValues] = {};
+    };
+
+    RtTrace();
+    void pushValues(const char* tag, const char* msg, const double* values, int count);
+    bool pop(Record& out);
+    void drainLoop();
+
+    Record ring_[kCapacity];
+    std::atomic<uint64_t> head_{0};
+    uint64_t tail_ = 0;  // drain thread only
+    std::atomic<uint32_t> dropped_{0};
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+} // namespace guitarrackcraft
+
+#if defined(GRC_RT_TRACE) && GRC_RT_TRACE
+#define RT_TRACE(tag, ...) ::guitarrackcraft::RtTrace::instance().push(tag, __VA_ARGS__)
+// Emit on the first call and then every n-th call from this site; no clock reads.
+#define RT_TRACE_EVERY(n, tag, ...)                                  \
+    do {                                                             \
+        static uint32_t rtTraceSiteCount_ = 0;                       \
+        if (rtTraceSiteCount_++ % (n) == 0) RT_TRACE(tag, __VA_ARGS__); \
+    } while (0)
+#else
+#define RT_TRACE(...) do {} while (0)
+#define RT_TRACE_EVERY(...) do {} while (0)
+#endif
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "RtWorkerPool.h"
+#include "FloatEnv.h"
+#include "ThreadPolicy.h"
+#include "ThreadUtils.h"
+#include "LogCompat.h"
+#include <algorithm>
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define LOG_TAG "RtWorkerPool"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+
+namespace guitarrackcraft {
+
+namespace {
+
+// Spin this many times before parking; covers the gap between consecutive stages of one callback.
+constexpr int kSpinIterations = 4000;
+
+inline void cpuRelax() {
+#if defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+void futexWait(std::atomic<uint32_t>* word, uint32_t expected) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT_PRIVATE, expected,
+            nullptr, nullptr, 0);
+}
+
+void futexWakeAll(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE_PRIVATE, INT_MAX,
+            nullptr, nullptr, 0);
+}
+
+} // namespace
+
+RtWorkerPool::RtWorkerPool(int numWorkers) {
+    threads_.reserve(numWorkers > 0 ? numWorkers : 0);
+    threadIds_ = std::make_unique<std::atomic<int32_t>[]>(numWorkers > 0 ? numWorkers : 0);
+    for (int i = 0; i < numWorkers; ++i) {
+        threadIds_[i].store(0, std::memory_order_relaxed);
+        threads_.emplace_back([this, i] { workerLoop(i); });
+    }
+    LOGI("started %d workers", numWorkers);
+}
+
+RtWorkerPool::~RtWorkerPool() {
+    stop_.store(true);
+    wakeSeq_.fetch_add(1);
+    futexWakeAll(&wakeSeq_);
+    for (auto& t : threads_) {
+        if (t.joinable()) t.join();
+    }
+}
+
+bool RtWorkerPool::claimAndRun(uint32_t generation) {
+    uint64_t w = work_.load(std::memory_order_acquire);
+    while (static_cast<uint32_t>(w >> 32) == generation) {
+        // The count travels in the same word as the index, so a claim is only ever checked
+        // against its own generation's count
+        const uint32_t index = static_cast<uint32_t>(w) & kIndexMask;
+        if (index >= (static_cast<uint32_t>(w) >> kCountShift)) {
+            return false;
+        }
+        if (work_.compare_exchange_weak(w, w + 1, std::memory_order_acq_rel)) {
+            job_.load(std::memory_order_relaxed)(context_.load(std::memory_order_relaxed), index);
+            remaining_.fetch_sub(1, std::memory_order_release);
+            w = work_.load(std::memory_order_acquire);
+        }
+    }
+    return false;
+}
+
+std::vector<int32_t> RtWorkerPool::threadIds() const {
+    std::vector<int32_t> ids;
+    for (size_t i = 0; i < threads_.size(); ++i) {
+        const int32_t tid = threadIds_[i].load(std::memory_order_acquire);
+        if (tid != 0) ids.push_back(tid);
+    }
+    return ids;
+}
+
+void RtWorkerPool::workerLoop(int index) {
+    threadIds_[index].store(static_cast<int32_t>(getTid()), std::memory_order_release);
+    enableFlushToZero();
+    if (!applyThreadRole(ThreadRole::AudioWorker)) {
+        LOGI("worker: could not raise priority");
+    }
+    uint32_t seenSeq = wakeSeq_.load(std::memory_order_acquire);
+    while (!stop_.load(std::memory_order_relaxed)) {
+        claimAndRun(static_cast<uint32_t>(work_.load(std::memory_order_acquire) >> 32));
+
+        // Wait for the next run(): spin first, then park.
+        int spins = 0;
+        while (wakeSeq_.load(std::memory_order_acquire) == seenSeq &&
+               !stop_.load(std::memory_order_relaxed)) {
+            if (++spins < kSpinIterations) {
+                cpuRelax();
+                continue;
+            }
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            if (wakeSeq_.load(std::memory_order_seq_cst) == seenSeq) {
+                futexWait(&wakeSeq_, seenSeq);
+            }
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        seenSeq = wakeSeq_.load(std::memory_order_acquire);
+    }
+}
+
+void RtWorkerPool::run(Job job, void* context, uint32_t count) {
+    if (count == 0) {
+        return;
+    }
+    if (threads_.empty() || count == 1) {
+        for (uint32_t i = 0; i < count; ++i) job(context, i);
+        return;
+    }
+
+    // Every job of the previous generation was claimed and finished (remaining_ reached 0),
+    // and its word holds index == count, so no stale worker can claim anything until the
+    // new word is published; the release store below then hands out job_ and context_.
+    count = std::min(count, kIndexMask);
+    job_.store(job, std::memory_order_relaxed);
+    context_.store(context, std::memory_order_relaxed);
+    remaining_.store(count, std::memory_order_relaxed);
+    uint32_t generation = static_cast<uint32_t>(work_.load(std::memory_order_relaxed) >> 32) + 1;
+    work_.store(static_cast<uint64_t>(generation) << 32 | static_cast<uint64_t>(count) << kCountShift,
+                std::memory_order_release);
+
+    wakeSeq_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+        futexWakeAll(&wakeSeq_);
+    }
+
+    claimAndRun(generation);
+    while (remaining_.load(std::memory_order_acquire) != 0) {
+        cpuRelax();
+    }
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Small pool of pre-spawned, high-priority threads that help the audio thread
+ * run independent jobs within one callback. run() never allocates or locks:
+ * jobs are claimed from an atomic (generation, index) word, idle workers spin
+ * briefly and then park on a futex, and the caller spins until all jobs finish.
+ */
+class RtWorkerPool {
+public:
+    using Job = void (*)(void* context, uint32_t index);
+
+    static constexpr uint32_t kMaxJobs = 0xFFFF;
+
+    explicit RtWorkerPool(int numWorkers);
+    ~RtWorkerPool();
+
+    RtWorkerPool(const RtWorkerPool&) = delete;
+    RtWorkerPool& operator=(const RtWorkerPool&) = delete;
+
+    int size() const { return static_cast<int>(threads_.size()); }
+
+    /** Kernel thread ids of the workers that have started (for performance hint sessions). */
+    std::vector<int32_t> threadIds() const;
+
+    /** Run job(context, i) for i in [0, count) on the caller plus the workers; returns when all are done.
+     *  Only one thread may call run() at a time. count is capped at kMaxJobs. */
+    void run(Job job, void* context, uint32_t count);
+
+private:
+    void workerLoop(int index);
+    bool claimAndRun(uint32_t generation);
+
+    std::vector<std::thread> threads_;
+    std::unique_ptr<std::atomic<int32_t>[]> threadIds_;  // 0 until the worker has started
+
+    // Rewritten only while no job is claimable; atomic because stale workers may still peek.
+    std::atomic<Job> job_{nullptr};
+    std::atomic<void*> context_{nullptr};
+
+    // work_ layout: generation << 32 | job count << kCountShift | next job index
+    static constexpr uint32_t kCountShift = 16;
+    static constexpr uint32_t kIndexMask = kMaxJobs;
+    std::atomic<uint64_t> work_{0};
+    std::atomic<uint32_t> remaining_{0};   // jobs not yet finished in this generation
+    std::atomic<uint32_t> wakeSeq_{0};     // futex word, bumped once per run()
+    std::atomic<int> sleepers_{0};
+    std::atomic<bool> stop_{false};
+};
+
+} // namespace guitarrackcraft
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "SerialWorkerPool.h"
+#include "FloatEnv.h"
+#include "ThreadPolicy.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+
+namespace guitarrackcraft {
+
+namespace {
+constexpr auto kWaitIdlePoll = std::chrono::milliseconds(1);
+}
+
+SerialWorkerPool& SerialWorkerPool::instance() {
+    // Model and IR loads are I/O plus number crunching: one thread per core.
+    static SerialWorkerPool pool(
+        static_cast<int>(std::max(2u, std::thread::hardware_concurrency())));
+    return pool;
+}
+
+SerialWorkerPool::SerialWorkerPool(int numThreads) {
+    for (uint32_t i = 0; i < kQueueCapacity; ++i) {
+        cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    sem_init(&wake_, 0, 0);
+    for (int i = 0; i < std::max(1, numThreads); ++i) {
+        threads_.emplace_back([this] { threadLoop(); });
+    }
+}
+
+SerialWorkerPool::~SerialWorkerPool() {
+    stop_.store(true, std::memory_order_release);
+    for (size_t i = 0; i < threads_.size(); ++i) {
+        sem_post(&wake_);
+    }
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+    sem_destroy(&wake_);
+}
+
+void SerialWorkerPool::schedule(Client* client) {
+    int state = client->state_.load(std::memory_order_acquire);
+    for (;;) {
+        if (state == Client::Queued || state == Client::Rerun) {
+            return;  // a run is already coming that will see the new work
+        }
+        const int next = state == Client::Idle ? Client::Queued : Client::Rerun;
+        if (client->state_.compare_exchange_weak(state, next, std::memory_order_acq_rel)) {
+            if (next == Client::Rerun) return;  // the running thread loops once more
+            break;
+        }
+    }
+    if (!push(client)) {
+        // More than kQueueCapacity clients pending: cannot happen with fewer attached;
+        // leave it Idle so the next schedule() retries instead of wedging the client.
+        client->state_.store(Client::Idle, std::memory_order_release);
+        return;
+    }
+    sem_post(&wake_);
+}
+
+void SerialWorkerPool::waitIdle(Client* client) {
+    while (client->state_.load(std::memory_order_acquire) != Client::Idle) {
+        std::this_thread::sleep_for(kWaitIdlePoll);
+    }
+}
+
+bool SerialWorkerPool::push(Client* client) {
+    uint32_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = cells_[pos & (kQueueCapacity - 1)];
+        const uint32_t seq = cell.seq.load(std::memory_order_acquire);
+        const int32_t diff = static_cast<int32_t>(seq - pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.client = client;
+                cell.seq.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+SerialWorkerPool::Client* SerialWorkerPool::pop() {
+    uint32_t pos = dequeuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = cells_[pos & (kQueueCapacity - 1)];
+        const uint32_t seq = cell.seq.load(std::memory_order_acquire);
+        const int32_t diff = static_cast<int32_t>(seq - (pos + 1));
+        if (diff == 0) {
+            if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                Client* client = cell.client;
+                cell.seq.store(pos + kQueueCapacity, std::memory_order_release);
+                return client;
+            }
+        } else if (diff < 0) {
+            return nullptr;
+        } else {
+            pos = dequeuePos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void SerialWorkerPool::threadLoop() {
+    applyThreadRole(ThreadRole::Background);
+    // LV2 work() runs here (convolver and model setup, some tails), so it flushes like the audio thread
+    enableFlushToZero();
+    for (;;) {
+        while (sem_wait(&wake_) != 0 && errno == EINTR) {}
+        if (stop_.load(std::memory_order_acquire)) {
+            return;
+        }
+        // One post per push, so a client is normally waiting; a push racing its own
+        // cell publication can make pop() miss, in which case repost and retry.
+        if (Client* client = pop()) {
+            runClient(client);
+        } else {
+            sem_post(&wake_);
+            std::this_thread::yield();
+        }
+    }
+}
+
+void SerialWorkerPool::runClient(Client* client) {
+    client->state_.store(Client::Running, std::memory_order_release);
+    for (;;) {
+        client->runPendingWork();
+        int expected = Client::Running;
+        if (client->state_.compare_exchange_strong(expected, Client::Idle,
+                                                   std::memory_order_acq_rel)) {
+            return;
+        }
+        // Rerun: more work was scheduled while running
+        client->state_.store(Client::Running, std::memory_order_release);
+    }
+}
+
+} // namespace guitarrackcraft
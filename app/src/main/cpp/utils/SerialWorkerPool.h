@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <semaphore.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Host-wide pool of background threads shared by every plugin instance, with one serial
+ * queue per client: a client's work never runs on two threads at once and runs in the order
+ * it was scheduled, while different clients run concurrently on all cores.
+ *
+ * schedule() is real-time safe (no locks, no allocation): each client sits in a bounded
+ * lock-free ready queue at most once, tracked by a small per-client state machine.
+ */
+class SerialWorkerPool {
+public:
+    class Client {
+    public:
+        virtual ~Client() = default;
+
+    protected:
+        /** Run whatever work is pending; called on a pool thread, never concurrently. */
+        virtual void runPendingWork() = 0;
+
+    private:
+        friend class SerialWorkerPool;
+        enum State : int { Idle, Queued, Running, Rerun };
+        std::atomic<int> state_{Idle};
+    };
+
+    static constexpr uint32_t kQueueCapacity = 1024;  // max clients with pending work, power of 2
+
+    static SerialWorkerPool& instance();
+
+    explicit SerialWorkerPool(int numThreads);
+    ~SerialWorkerPool();
+
+    SerialWorkerPool(const SerialWorkerPool&) = delete;
+    SerialWorkerPool& operator=(const SerialWorkerPool&) = delete;
+
+    int size() const { return static_cast<int>(threads_.size()); }
+
+    /** Request a runPendingWork() call for 'client' (RT-safe). Work scheduled while the client
+     *  is running triggers one more run afterwards, so nothing is missed. */
+    void schedule(Client* client);
+
+    /** Block until 'client' is neither queued nor running. The caller must have stopped
+     *  scheduling it, e.g. before destroying it. */
+    void waitIdle(Client* client);
+
+private:
+    struct Cell {
+        std::atomic<uint32_t> seq{0};
+        Client* client = nullptr;
+    };
+
+    bool push(Client* client);
+    Client* pop();
+    void threadLoop();
+    void runClient(Client* client);
+
+    // Vyukov bounded MPMC queue of clients whose state is Queued
+    Cell cells_[kQueueCapacity];
+    alignas(64) std::atomic<uint32_t> enqueuePos_{0};
+    alignas(64) std::atomic<uint32_t> dequeuePos_{0};
+
+    sem_t wake_;
+    std::atomic<bool> stop_{false};
+    std::vector<std::thread> threads_;
+};
+
+} // namespace guitarrackcraft
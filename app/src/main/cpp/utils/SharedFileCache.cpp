@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "SharedFileCache.h"
+#include "ByteCodec.h"
+#include <cstring>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace guitarrackcraft {
+
+SharedFileCache::Mapping::~Mapping() {
+    if (data_ && size_ > 0) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+}
+
+SharedFileCache& SharedFileCache::instance() {
+    static SharedFileCache cache;
+    return cache;
+}
+
+SharedFileCache::Ref SharedFileCache::acquire(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    FileId id;
+    id.device = static_cast<uint64_t>(st.st_dev);
+    id.inode = static_cast<uint64_t>(st.st_ino);
+    id.size = static_cast<uint64_t>(st.st_size);
+    id.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = byPath_.find(path);
+        if (it != byPath_.end() && it->second.id == id) {
+            if (Ref ref = it->second.mapping.lock()) {
+                ::close(fd);
+                return ref;
+            }
+        }
+    }
+
+    // Map and hash outside the lock; hashing also faults the pages in for the plugin
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // the mapping keeps the file referenced
+    if (p == MAP_FAILED) return nullptr;
+    madvise(p, size, MADV_WILLNEED);
+    const auto* data = static_cast<const uint8_t*>(p);
+    auto mapping = std::make_shared<const Mapping>(data, size, fnv1a64(data, size));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    prune();
+    Ref ref = mapping;
+    auto range = byContent_.equal_range(mapping->contentHash());
+    for (auto it = range.first; it != range.second; ++it) {
+        Ref existing = it->second.lock();
+        if (existing && existing->size() == size && memcmp(existing->data(), data, size) == 0) {
+            ref = existing;  // same bytes under another path, or raced with another acquire()
+            break;
+        }
+    }
+    if (ref == mapping) {
+        byContent_.emplace(mapping->contentHash(), mapping);
+    }
+    byPath_[path] = PathEntry{id, ref};
+    return ref;
+}
+
+size_t SharedFileCache::mappedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& entry : byContent_) {
+        if (!entry.second.expired()) ++count;
+    }
+    return count;
+}
+
+size_t SharedFileCache::mappedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t bytes = 0;
+    for (const auto& entry : byContent_) {
+        if (Ref ref = entry.second.lock()) bytes += ref->size();
+    }
+    return bytes;
+}
+
+void SharedFileCache::prune() {
+    for (auto it = byPath_.begin(); it != byPath_.end();) {
+        it = it->second.mapping.expired() ? byPath_.erase(it) : std::next(it);
+    }
+    for (auto it = byContent_.begin(); it != byContent_.end();) {
+        it = it->second.expired() ? byContent_.erase(it) : std::next(it);
+    }
+}
+
+} // namespace guitarrackcraft
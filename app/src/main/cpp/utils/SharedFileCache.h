@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Process-wide read-only file mappings for model captures and impulse responses.
+ *
+ * acquire() maps a file once and hands out shared references to the same pages. Files
+ * are known by path and by content: a second path with identical bytes (a copied
+ * capture, the same IR imported twice) resolves to the mapping that already exists. A
+ * path whose size or mtime changed is mapped again; holders of the old mapping keep it
+ * until they let go (files must be replaced, not rewritten in place, for that to hold).
+ * A mapping is unmapped when its last reference is dropped.
+ *
+ * Never call from the audio thread: acquire() may open, map and hash a file.
+ */
+class SharedFileCache {
+public:
+    class Mapping {
+    public:
+        Mapping(const uint8_t* data, size_t size, uint64_t contentHash)
+            : data_(data), size_(size), contentHash_(contentHash) {}
+        ~Mapping();
+
+        Mapping(const Mapping&) = delete;
+        Mapping& operator=(const Mapping&) = delete;
+
+        const uint8_t* data() const { return data_; }
+        size_t size() const { return size_; }
+        uint64_t contentHash() const { return contentHash_; }
+
+    private:
+        const uint8_t* data_;
+        size_t size_;
+        uint64_t contentHash_;
+    };
+    using Ref = std::shared_ptr<const Mapping>;
+
+    /** The cache shared by every plugin instance in the process. */
+    static SharedFileCache& instance();
+
+    /** Shared mapping of path's current contents, or nullptr if it cannot be mapped. */
+    Ref acquire(const std::string& path);
+
+    /** Files currently mapped (held by someone) and their total size. */
+    size_t mappedCount() const;
+    size_t mappedBytes() const;
+
+private:
+    struct FileId {
+        uint64_t device = 0;
+        uint64_t inode = 0;
+        uint64_t size = 0;
+        int64_t mtimeNs = 0;
+        bool operator==(const FileId& o) const {
+            return device == o.device && inode == o.inode && size == o.size && mtimeNs == o.mtimeNs;
+        }
+    };
+    struct PathEntry {
+        FileId id;
+        std::weak_ptr<const Mapping> mapping;
+    };
+
+    /** Drop entries whose mapping is gone. Caller holds mutex_. */
+    void prune();
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, PathEntry> byPath_;
+    std::unordered_multimap<uint64_t, std::weak_ptr<const Mapping>> byContent_;
+};
+
+} // namespace guitarrackcraft
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Preallocated single-producer single-consumer ring of variable-size messages.
+ * Each message is stored as a 32-bit length followed by its bytes, wrapping around the end.
+ * write() and read() never allocate, lock or wait: a message that does not fit is refused
+ * whole, so the producer decides whether to drop or retry.
+ */
+class SpscMessageRing {
+public:
+    SpscMessageRing() = default;
+    explicit SpscMessageRing(uint32_t capacityBytes) { reset(capacityBytes); }
+
+    /** (Re)allocate, rounded up to a power of two and emptied. Neither side may be active. */
+    void reset(uint32_t capacityBytes) {
+        uint32_t capacity = 64;
+        while (capacity < capacityBytes) capacity <<= 1;
+        buffer_.assign(capacity, 0);
+        mask_ = capacity - 1;
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+    /** Producer: append one message made of a followed by b. */
+    bool write(const void* a, uint32_t sizeA, const void* b = nullptr, uint32_t sizeB = 0) {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        const uint32_t tail = tail_.load(std::memory_order_acquire);
+        const uint32_t size = sizeA + sizeB;
+        if (buffer_.empty() || size > mask_ + 1 - kHeader ||
+            (mask_ + 1) - (head - tail) < kHeader + size) {
+            return false;
+        }
+        copyIn(head, &size, kHeader);
+        copyIn(head + kHeader, a, sizeA);
+        copyIn(head + kHeader + sizeA, b, sizeB);
+        head_.store(head + kHeader + size, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer: size of the next message, false if the ring is empty. */
+    bool peek(uint32_t& size) const {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail) return false;
+        copyOut(tail, &size, kHeader);
+        return true;
+    }
+
+    /** Consumer: pop the next message into dst. One larger than dstCapacity is discarded
+     *  (size still reports its length) and false returned. */
+    bool read(void* dst, uint32_t dstCapacity, uint32_t& size) {
+        if (!peek(size)) return false;
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const bool fits = size <= dstCapacity;
+        if (fits) copyOut(tail + kHeader, dst, size);
+        tail_.store(tail + kHeader + size, std::memory_order_release);
+        return fits;
+    }
+
+    /** Consumer: drop everything currently queued. */
+    void clear() { tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release); }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr uint32_t kHeader = sizeof(uint32_t);
+
+    void copyIn(uint32_t pos, const void* src, uint32_t n) {
+        if (n == 0) return;
+        const uint32_t start = pos & mask_;
+        const uint32_t first = std::min(n, mask_ + 1 - start);
+        std::memcpy(buffer_.data() + start, src, first);
+        std::memcpy(buffer_.data(), static_cast<const uint8_t*>(src) + first, n - first);
+    }
+
+    void copyOut(uint32_t pos, void* dst, uint32_t n) const {
+        if (n == 0) return;
+        const uint32_t start = pos & mask_;
+        const uint32_t first = std::min(n, mask_ + 1 - start);
+        std::memcpy(dst, buffer_.data() + start, first);
+        std::memcpy(static_cast<uint8_t*>(dst) + first, buffer_.data(), n - first);
+    }
+
+    std::vector<uint8_t> buffer_;
+    uint32_t mask_ = 0;
+    // Free-running byte counters; unsigned wraparound keeps head - tail correct.
+    alignas(64) std::atomic<uint32_t> head_{0};  // written by the producer
+    alignas(64) std::atomic<uint32_t> tail_{0};  // written by the consumer
+};
+
+} // namespace guitarrackcraft
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Preallocated single-producer single-consumer queue of trivially copyable items.
+ * push() and pop() never allocate, lock or wait; a full queue refuses the item. Several
+ * producers must serialize among themselves (the consumer side stays lock-free).
+ */
+template <typename T>
+class SpscQueue {
+public:
+    SpscQueue() = default;
+    explicit SpscQueue(uint32_t capacity) { reset(capacity); }
+
+    /** (Re)allocate, rounded up to a power of two and emptied. Neither side may be active. */
+    void reset(uint32_t capacity) {
+        uint32_t size = 2;
+        while (size < capacity) size <<= 1;
+        items_.assign(size, T{});
+        mask_ = size - 1;
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+    /** Producer: append one item, false if the queue is full. */
+    bool push(const T& item) {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        if (items_.empty() || head - tail_.load(std::memory_order_acquire) > mask_) return false;
+        items_[head & mask_] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer: take the oldest item, false if the queue is empty. */
+    bool pop(T& item) {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail) return false;
+        item = items_[tail & mask_];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer: drop everything currently queued. */
+    void clear() { tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release); }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    std::vector<T> items_;
+    uint32_t mask_ = 0;
+    // Free-running item counters; unsigned wraparound keeps head - tail correct.
+    alignas(64) std::atomic<uint32_t> head_{0};  // written by the producer
+    alignas(64) std::atomic<uint32_t> tail_{0};  // written by the consumer
+};
+
+} // namespace guitarrackcraft
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "SystemTrace.h"
+#include <dlfcn.h>
+
+namespace guitarrackcraft {
+
+std::atomic<bool> SystemTrace::enabled_{false};
+
+namespace {
+
+// NDK android/trace.h, resolved from libandroid.so so minSdk stays below 29.
+struct TraceApi {
+    using BeginSection = void (*)(const char* name);
+    using EndSection = void (*)();
+    using AsyncSection = void (*)(const char* name, int32_t cookie);
+    using SetCounter = void (*)(const char* name, int64_t value);
+
+    BeginSection beginSection = nullptr;
+    EndSection endSection = nullptr;
+    AsyncSection beginAsync = nullptr;  // API 29
+    AsyncSection endAsync = nullptr;    // API 29
+    SetCounter setCounter = nullptr;    // API 29
+
+    TraceApi() {
+        void* lib = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+        if (!lib) return;
+        beginSection = reinterpret_cast<BeginSection>(dlsym(lib, "ATrace_beginSection"));
+        endSection = reinterpret_cast<EndSection>(dlsym(lib, "ATrace_endSection"));
+        beginAsync = reinterpret_cast<AsyncSection>(dlsym(lib, "ATrace_beginAsyncSection"));
+        endAsync = reinterpret_cast<AsyncSection>(dlsym(lib, "ATrace_endAsyncSection"));
+        setCounter = reinterpret_cast<SetCounter>(dlsym(lib, "ATrace_setCounter"));
+        if (!beginSection || !endSection) beginSection = nullptr;
+    }
+
+    static const TraceApi& get() {
+        static const TraceApi api;
+        return api;
+    }
+};
+
+} // namespace
+
+bool SystemTrace::setEnabled(bool enabled) {
+    const bool available = TraceApi::get().beginSection != nullptr;
+    enabled_.store(enabled && available, std::memory_order_relaxed);
+    return available || !enabled;
+}
+
+void SystemTrace::beginSection(const char* name) {
+    if (enabled()) TraceApi::get().beginSection(name);
+}
+
+void SystemTrace::endSection() {
+    // Not gated: a section begun while enabled must still end
+    if (const auto end = TraceApi::get().endSection) end();
+}
+
+void SystemTrace::beginAsync(const char* name, int32_t cookie) {
+    const TraceApi& api = TraceApi::get();
+    if (enabled() && api.beginAsync) api.beginAsync(name, cookie);
+}
+
+void SystemTrace::endAsync(const char* name, int32_t cookie) {
+    const TraceApi& api = TraceApi::get();
+    if (enabled() && api.endAsync) api.endAsync(name, cookie);
+}
+
+void SystemTrace::setCounter(const char* name, int64_t value) {
+    const TraceApi& api = TraceApi::get();
+    if (enabled() && api.setCounter) api.setCounter(name, value);
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace guitarrackcraft {
+
+/**
+ * Runtime-gated system trace markers (NDK android/trace.h), so a Perfetto or systrace
+ * capture shows the audio callback, each plugin slot, LV2 worker calls, recorder drains
+ * and X11 server/render work side by side with the scheduler and whatever preempted them.
+ *
+ * Off by default. Disabled, every marker is one relaxed load and a branch, cheap enough for
+ * the audio callback; once enabled, markers go to ATrace, which in turn drops them unless a
+ * capture with the app category is recording. Names must be string literals or otherwise
+ * outlive the call. The NDK entry points are looked up at runtime (sections API 23, async
+ * sections and counters API 29), so setEnabled() simply fails where they are missing,
+ * including host builds.
+ */
+class SystemTrace {
+public:
+    /** Arm or disarm markers, from any thread. @return false if ATrace is unavailable */
+    static bool setEnabled(bool enabled);
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /** Nested section on the calling thread; prefer TraceSection / SYSTEM_TRACE_SCOPE. */
+    static void beginSection(const char* name);
+    static void endSection();
+
+    /** Section that may end on another thread; name + cookie pair begin and end. */
+    static void beginAsync(const char* name, int32_t cookie);
+    static void endAsync(const char* name, int32_t cookie);
+
+    /** Counter track, e.g. callback duration or a queue's backlog. */
+    static void setCounter(const char* name, int64_t value);
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+/** Section for the enclosing scope. Stays balanced if tracing is toggled meanwhile. */
+class TraceSection {
+public:
+    explicit TraceSection(const char* name) : active_(SystemTrace::enabled()) {
+        if (active_) SystemTrace::beginSection(name);
+    }
+    ~TraceSection() {
+        if (active_) SystemTrace::endSection();
+    }
+
+    TraceSection(const TraceSection&) = delete;
+    TraceSection& operator=(const TraceSection&) = delete;
+
+private:
+    const bool active_;
+};
+
+} // namespace guitarrackcraft
+
+#define SYSTEM_TRACE_CONCAT_(a, b) a##b
+#define SYSTEM_TRACE_CONCAT(a, b) SYSTEM_TRACE_CONCAT_(a, b)
+#define SYSTEM_TRACE_SCOPE(name) \
+    const ::guitarrackcraft::TraceSection SYSTEM_TRACE_CONCAT(systemTraceSection_, __LINE__)(name)
+// The value is not evaluated while tracing is off
+#define SYSTEM_TRACE_COUNTER(name, value)                                              \
+    do {                                                                               \
+        if (::guitarrackcraft::SystemTrace::enabled())                                 \
+            ::guitarrackcraft::SystemTrace::setCounter(name, static_cast<int64_t>(value)); \
+    } while (0)
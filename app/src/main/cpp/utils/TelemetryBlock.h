@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace guitarrackcraft {
+
+/**
+ * Engine telemetry (meters, load, xruns, plugin output ports) published once per audio
+ * callback into fixed memory that Kotlin maps as a direct ByteBuffer, so the UI reads it
+ * at frame rate without JNI calls.
+ *
+ * Seqlock with a single writer (the audio callback): 'sequence' is odd while a block is being
+ * written. Readers copy the block and retry if sequence was odd or changed meanwhile.
+ * All fields are 32-bit in native byte order; Telemetry.kt mirrors the offsets, so bump
+ * kVersion with any layout change.
+ *
+ * The analysis results (AnalysisTap: pitch, spectrum, scope) follow in their own seqlocked
+ * section, written by the analysis thread at its own rate.
+ */
+class TelemetryBlock {
+public:
+    static constexpr uint32_t kVersion = 3;
+    static constexpr uint32_t kMaxPlugins = 32;
+    static constexpr uint32_t kMaxOutputControls = 256;
+    static constexpr uint32_t kSpectrumBands = 128;
+    static constexpr uint32_t kScopePoints = 256;
+
+    enum Flags : uint32_t {
+        kInputClipping = 1u << 0,
+        kOutputClipping = 1u << 1,
+        kCallbackOnPerformanceCore = 1u << 2,
+        // Load shedding actions in force (AudioEngine, LoadShedder levels)
+        kShedQuality = 1u << 3,
+        kShedFastSleep = 1u << 4,
+        kShedSlowUi = 1u << 5,
+        kShedLargeBuffer = 1u << 6,
+    };
+
+    struct Analysis {
+        uint32_t sequence;       // seqlock of this section alone
+        int32_t source;          // tap point: AnalysisTap::kInput or a chain index, kOff if idle
+        uint32_t updates;        // results published since the tap started
+        float pitchHz;           // 0 if no clear pitch
+        float pitchClarity;      // 0..1, how periodic the signal is
+        float rmsDb;             // over the analysis window, dBFS
+        float spectrumDb[kSpectrumBands];  // peak per log-spaced band, dBFS
+        float scopeMin[kScopePoints];      // min/max per scope point, from a rising zero crossing
+        float scopeMax[kScopePoints];
+    };
+
+    struct Layout {
+        uint32_t sequence;
+        uint32_t version;
+        uint32_t callbacks;      // blocks published since start
+        uint32_t flags;
+        float inputLevel;        // peak-hold, 0..1
+        float outputLevel;
+        float cpuLoad;           // last callback's wall time / period
+        int32_t xruns;           // output stream xrun count
+        int32_t callbackCpu;     // core the audio callback last ran on, -1 if unknown
+        uint32_t numPlugins;     // entries used in outputControlCounts
+        uint32_t outputControlCounts[kMaxPlugins];  // output control ports per plugin, chain order
+        float outputControls[kMaxOutputControls];   // their values, concatenated
+        Analysis analysis;
+    };
+
+    TelemetryBlock() { layout_.version = kVersion; }
+
+    /** Memory handed to Java; lives as long as this object. */
+    void* data() { return &layout_; }
+    static constexpr size_t size() { return sizeof(Layout); }
+
+    /** Writer: open a block. Fields may be updated until endWrite(). */
+    Layout& beginWrite() {
+        const uint32_t seq = __atomic_load_n(&layout_.sequence, __ATOMIC_RELAXED);
+        __atomic_store_n(&layout_.sequence, seq + 1, __ATOMIC_RELAXED);
+        std::atomic_thread_fence(std::memory_order_release);
+        return layout_;
+    }
+
+    void endWrite() {
+        const uint32_t seq = __atomic_load_n(&layout_.sequence, __ATOMIC_RELAXED);
+        __atomic_store_n(&layout_.sequence, seq + 1, __ATOMIC_RELEASE);
+    }
+
+    /** Analysis writer (one thread): open the analysis section. */
+    Analysis& beginAnalysisWrite() {
+        const uint32_t seq = __atomic_load_n(&layout_.analysis.sequence, __ATOMIC_RELAXED);
+        __atomic_store_n(&layout_.analysis.sequence, seq + 1, __ATOMIC_RELAXED);
+        std::atomic_thread_fence(std::memory_order_release);
+        return layout_.analysis;
+    }
+
+    void endAnalysisWrite() {
+        const uint32_t seq = __atomic_load_n(&layout_.analysis.sequence, __ATOMIC_RELAXED);
+        __atomic_store_n(&layout_.analysis.sequence, seq + 1, __ATOMIC_RELEASE);
+    }
+
+    /** Reader: copy a consistent analysis section. */
+    bool readAnalysis(Analysis& out, int attempts = 64) const {
+        for (int i = 0; i < attempts; ++i) {
+            const uint32_t before = __atomic_load_n(&layout_.analysis.sequence, __ATOMIC_ACQUIRE);
+            if (before & 1u) continue;
+            std::memcpy(&out, &layout_.analysis, sizeof(Analysis));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (__atomic_load_n(&layout_.analysis.sequence, __ATOMIC_RELAXED) == before) return true;
+        }
+        return false;
+    }
+
+    /** Reader: copy a consistent block; false if the writer kept interrupting. The analysis
+     *  section comes along but is only consistent via readAnalysis(). */
+    bool read(Layout& out, int attempts = 64) const {
+        for (int i = 0; i < attempts; ++i) {
+            const uint32_t before = __atomic_load_n(&layout_.sequence, __ATOMIC_ACQUIRE);
+            if (before & 1u) continue;
+            std::memcpy(&out, &layout_, sizeof(Layout));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (__atomic_load_n(&layout_.sequence, __ATOMIC_RELAXED) == before) return true;
+        }
+        return false;
+    }
+
+private:
+    alignas(64) Layout layout_{};
+};
+
+// Telemetry.kt reads the analysis section at this offset
+static_assert(offsetof(TelemetryBlock::Layout, analysis) ==
+                  40 + 4 * (TelemetryBlock::kMaxPlugins + TelemetryBlock::kMaxOutputControls),
+              "Telemetry.kt offsets");
+
+} // namespace guitarrackcraft
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "ThermalStatus.h"
+#include <dlfcn.h>
+
+namespace guitarrackcraft {
+
+namespace {
+
+// NDK android/thermal.h, resolved from libandroid.so so minSdk stays below 30.
+struct ThermalApi {
+    using AcquireManager = void* (*)();
+    using GetStatus = int (*)(void* manager);
+
+    GetStatus getStatus = nullptr;
+    void* manager = nullptr;
+
+    ThermalApi() {
+        void* lib = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+        if (!lib) return;
+        auto acquire = reinterpret_cast<AcquireManager>(dlsym(lib, "AThermal_acquireManager"));
+        getStatus = reinterpret_cast<GetStatus>(dlsym(lib, "AThermal_getCurrentThermalStatus"));
+        if (acquire && getStatus) {
+            manager = acquire();  // kept for the process lifetime
+        }
+    }
+
+    static const ThermalApi& get() {
+        static const ThermalApi api;
+        return api;
+    }
+};
+
+} // namespace
+
+int currentThermalStatus() {
+    const ThermalApi& api = ThermalApi::get();
+    if (!api.manager) return -1;
+    int status = api.getStatus(api.manager);
+    return status >= 0 ? status : -1;
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+namespace guitarrackcraft {
+
+/**
+ * Current device thermal status as an AThermalStatus value (0 none, 1 light, 2 moderate,
+ * 3 severe, 4 critical, 5 emergency, 6 shutdown), or -1 where the thermal API (API 30+)
+ * is unavailable. The NDK entry points are looked up at runtime so minSdk stays lower.
+ * Makes a binder call; keep it off the audio thread and poll it at a second or so.
+ */
+int currentThermalStatus();
+
+} // namespace guitarrackcraft
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "ThreadPolicy.h"
+#include <algorithm>
+#include <cstdio>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+
+namespace guitarrackcraft {
+
+namespace {
+
+// android.os.Process priority levels (nice values)
+constexpr int kNiceUrgentAudio = -19;
+constexpr int kNiceAudio = -16;
+constexpr int kNiceBackground = 10;
+constexpr int kWorkerFifoPriority = 2;
+constexpr int kMaxCpus = 64;
+
+long readNumber(const std::string& path) {
+    FILE* f = std::fopen(path.c_str(), "r");
+    if (!f) return -1;
+    long value = -1;
+    if (std::fscanf(f, "%ld", &value) != 1) value = -1;
+    std::fclose(f);
+    return value;
+}
+
+void setAffinity(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+bool setNice(int nice) {
+    return setpriority(PRIO_PROCESS, 0, nice) == 0;
+}
+
+} // namespace
+
+CpuTopology CpuTopology::fromSysfs(const std::string& root) {
+    std::vector<std::pair<int, long>> capacities;
+    for (int cpu = 0; cpu < kMaxCpus; ++cpu) {
+        const std::string dir = root + "/cpu" + std::to_string(cpu);
+        long capacity = readNumber(dir + "/cpu_capacity");
+        if (capacity <= 0) capacity = readNumber(dir + "/cpufreq/cpuinfo_max_freq");
+        if (capacity > 0) capacities.emplace_back(cpu, capacity);
+    }
+
+    CpuTopology topology;
+    long maxCapacity = 0;
+    for (const auto& c : capacities) maxCapacity = std::max(maxCapacity, c.second);
+    for (const auto& c : capacities) {
+        if (c.second >= kPerformanceFraction * maxCapacity) {
+            topology.performanceCpus_.push_back(c.first);
+        } else {
+            topology.efficiencyCpus_.push_back(c.first);
+        }
+    }
+    return topology;
+}
+
+const CpuTopology& CpuTopology::system() {
+    static const CpuTopology topology = fromSysfs("/sys/devices/system/cpu");
+    return topology;
+}
+
+bool CpuTopology::isPerformanceCpu(int cpu) const {
+    return std::find(performanceCpus_.begin(), performanceCpus_.end(), cpu) != performanceCpus_.end();
+}
+
+bool applyThreadRole(ThreadRole role) {
+    const CpuTopology& topology = CpuTopology::system();
+    const bool place = topology.heterogeneous();
+
+    switch (role) {
+        case ThreadRole::Audio:
+            if (place) setAffinity(topology.performanceCpus());
+            // AAudio normally hands us a SCHED_FIFO thread; only the legacy paths need the nice boost.
+            if (sched_getscheduler(0) == SCHED_FIFO) return true;
+            return setNice(kNiceUrgentAudio);
+        case ThreadRole::AudioWorker: {
+            if (place) setAffinity(topology.performanceCpus());
+            sched_param param{};
+            param.sched_priority = kWorkerFifoPriority;
+            if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0) return true;
+            return setNice(kNiceAudio);
+        }
+        case ThreadRole::Display:
+            if (place) setAffinity(topology.efficiencyCpus());
+            return true;
+        case ThreadRole::Background:
+            if (place) setAffinity(topology.efficiencyCpus());
+            return setNice(kNiceBackground);
+    }
+    return false;
+}
+
+int currentCpu() {
+    return sched_getcpu();
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * CPU clusters as the kernel reports them. On big.LITTLE parts cpu_capacity (or,
+ * on older kernels, cpuinfo_max_freq) tells the performance cores from the
+ * efficiency ones; homogeneous or unreadable topologies have no efficiency set
+ * and thread placement is then left to the scheduler.
+ */
+class CpuTopology {
+public:
+    /** Cores at or above this fraction of the largest capacity count as performance cores. */
+    static constexpr double kPerformanceFraction = 0.5;
+
+    /** Topology of this device, read once from /sys/devices/system/cpu. */
+    static const CpuTopology& system();
+
+    /** Parse <root>/cpuN/cpu_capacity, falling back to <root>/cpuN/cpufreq/cpuinfo_max_freq. */
+    static CpuTopology fromSysfs(const std::string& root);
+
+    bool heterogeneous() const { return !performanceCpus_.empty() && !efficiencyCpus_.empty(); }
+    const std::vector<int>& performanceCpus() const { return performanceCpus_; }
+    const std::vector<int>& efficiencyCpus() const { return efficiencyCpus_; }
+    bool isPerformanceCpu(int cpu) const;
+
+private:
+    std::vector<int> performanceCpus_;
+    std::vector<int> efficiencyCpus_;
+};
+
+/** What a thread does, which decides where it may run and at what priority. */
+enum class ThreadRole {
+    Audio,        // the stream callback: performance cores, URGENT_AUDIO if not already SCHED_FIFO
+    AudioWorker,  // helpers inside one callback: performance cores, SCHED_FIFO or URGENT_AUDIO
+    Display,      // X11 server, render and plugin UI threads: efficiency cores, priority unchanged
+    Background,   // file writers, model loading, trace draining: efficiency cores, BACKGROUND
+};
+
+/**
+ * Apply role's affinity and priority to the calling thread. Affinity is only set on
+ * heterogeneous topologies. Returns false if the priority change was refused; a
+ * refused affinity is not treated as an error.
+ */
+bool applyThreadRole(ThreadRole role);
+
+/** Core the calling thread is running on, or -1 if unknown. */
+int currentCpu();
+
+} // namespace guitarrackcraft
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "UridTable.h"
+#include <cstring>
+
+namespace guitarrackcraft {
+
+UridTable::UridTable()
+    : entries_(new Entry[kMaxIds])
+{
+    for (auto& slot : slots_) {
+        slot.store(0, std::memory_order_relaxed);
+    }
+}
+
+UridTable::~UridTable() = default;
+
+uint64_t UridTable::hashUri(const char* uri) {
+    // FNV-1a; URIs share long prefixes, so hash every byte
+    uint64_t h = 1469598103934665603ull;
+    for (const auto* p = reinterpret_cast<const uint8_t*>(uri); *p; ++p) {
+        h ^= *p;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+uint32_t UridTable::find(const char* uri, uint64_t hash, uint32_t& emptySlot) const {
+    uint32_t i = static_cast<uint32_t>(hash) & (kSlots - 1);
+    while (true) {
+        const uint32_t id = slots_[i].load(std::memory_order_acquire);
+        if (id == 0) {
+            emptySlot = i;
+            return 0;
+        }
+        const Entry& entry = entries_[id];
+        if (entry.hash == hash && std::strcmp(entry.uri.load(std::memory_order_acquire), uri) == 0) {
+            return id;
+        }
+        i = (i + 1) & (kSlots - 1);
+    }
+}
+
+uint32_t UridTable::map(const char* uri) {
+    if (!uri) {
+        return 0;
+    }
+    const uint64_t hash = hashUri(uri);
+    uint32_t slot = 0;
+    if (uint32_t id = find(uri, hash, slot)) {
+        return id;
+    }
+
+    std::lock_guard<std::mutex> lock(insertMutex_);
+    // Another thread may have inserted it (or filled our slot) since the lock-free probe
+    if (uint32_t id = find(uri, hash, slot)) {
+        return id;
+    }
+    auto overflowIt = overflow_.find(uri);
+    if (overflowIt != overflow_.end()) {
+        return overflowIt->second;
+    }
+
+    const size_t len = std::strlen(uri);
+    storage_.emplace_back(new char[len + 1]);
+    char* stored = storage_.back().get();
+    std::memcpy(stored, uri, len + 1);
+
+    const uint32_t id = count_.load(std::memory_order_relaxed) + 1;
+    if (id < kMaxIds) {
+        Entry& entry = entries_[id];
+        entry.hash = hash;
+        entry.uri.store(stored, std::memory_order_release);
+        slots_[slot].store(id, std::memory_order_release);
+    } else {
+        overflow_.emplace(stored, id);
+        overflowUris_.push_back(stored);
+    }
+    count_.store(id, std::memory_order_release);
+    return id;
+}
+
+const char* UridTable::unmap(uint32_t id) const {
+    if (id == 0) {
+        return nullptr;
+    }
+    if (id < kMaxIds) {
+        return entries_[id].uri.load(std::memory_order_acquire);
+    }
+    std::lock_guard<std::mutex> lock(insertMutex_);
+    const size_t index = id - kMaxIds;
+    return index < overflowUris_.size() ? overflowUris_[index] : nullptr;
+}
+
+} // namespace guitarrackcraft
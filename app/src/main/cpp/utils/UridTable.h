@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Process-wide URI <-> integer table backing LV2 urid:map / urid:unmap.
+ *
+ * Lookups of known URIs and every unmap() are lock-free, so plugins may call them from run()
+ * or work_response(): a pre-sized open-addressing hash of ids is probed with acquire loads, and
+ * ids index a fixed entry array whose strings are never moved or freed. Only inserting a new
+ * URI takes the mutex. After kMaxIds URIs (far more than a session uses) new ones go to a
+ * mutex-guarded overflow map, which stays correct but is no longer lock-free.
+ *
+ * Ids start at 1; 0 is the invalid URID.
+ */
+class UridTable {
+public:
+    static constexpr uint32_t kSlots = 16384;  // power of 2; load factor stays <= 0.5
+    static constexpr uint32_t kMaxIds = kSlots / 2;
+
+    UridTable();
+    ~UridTable();
+
+    UridTable(const UridTable&) = delete;
+    UridTable& operator=(const UridTable&) = delete;
+
+    /** Id for uri, assigning the next one if it is new. Returns 0 only for a null uri. */
+    uint32_t map(const char* uri);
+    /** The URI for id, or nullptr. The pointer stays valid for the table's lifetime. */
+    const char* unmap(uint32_t id) const;
+
+    /** Number of URIs mapped so far. */
+    uint32_t size() const { return count_.load(std::memory_order_acquire); }
+
+private:
+    struct Entry {
+        std::atomic<const char*> uri{nullptr};
+        uint64_t hash = 0;  // written before uri is published
+    };
+
+    static uint64_t hashUri(const char* uri);
+    /** Lock-free probe; 0 if absent. 'emptySlot' receives where the probe stopped. */
+    uint32_t find(const char* uri, uint64_t hash, uint32_t& emptySlot) const;
+
+    std::atomic<uint32_t> slots_[kSlots];  // 0 = empty, else an id below kMaxIds
+    std::unique_ptr<Entry[]> entries_;     // indexed by id
+    std::atomic<uint32_t> count_{0};
+
+    mutable std::mutex insertMutex_;
+    std::vector<std::unique_ptr<char[]>> storage_;     // owns every string; guarded by insertMutex_
+    std::unordered_map<std::string, uint32_t> overflow_;  // ids >= kMaxIds
+    std::vector<const char*> overflowUris_;            // overflowUris_[id - kMaxIds]
+};
+
+} // namespace guitarrackcraft
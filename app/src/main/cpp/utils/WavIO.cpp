@@ -18,6 +18,7 @@
  */
 
 #include "WavIO.h"
+#include "MappedWavFile.h"
 #include <android/log.h>
 #include <algorithm>
 #include <cstring>
@@ -32,48 +33,12 @@ bool readWavFile(const std::string& path,
                  std::vector<float>& samples,
                  uint32_t& sampleRate,
                  uint32_t& numChannels) {
-    std::ifstream file(path, std::ios::binary);
-    if (!file.is_open()) {
-        LOGE("Cannot open file: %s", path.c_str());
-        return false;
-    }
-
-    WavHeader header;
-    file.read(reinterpret_cast<char*>(&header), sizeof(WavHeader));
-
-    if (std::memcmp(header.riff, "RIFF", 4) != 0 ||
-        std::memcmp(header.wave, "WAVE", 4) != 0 ||
-        std::memcmp(header.fmt, "fmt ", 4) != 0 ||
-        header.audioFormat != 1) {
-        LOGE("Invalid WAV file format");
+    MappedWavFile wav;
+    if (!wav.open(path)) {
+        LOGE("Cannot read WAV %s: %s", path.c_str(), wav.error().c_str());
         return false;
     }
-
-    sampleRate = header.sampleRate;
-    numChannels = header.numChannels;
-    uint16_t bitsPerSample = header.bitsPerSample;
-
-    if (header.fmtSize > 16) {
-        file.seekg(header.fmtSize - 16, std::ios::cur);
-    }
-
-    uint32_t dataSize = 0;
-    if (std::memcmp(header.data, "data", 4) == 0) {
-        dataSize = header.dataSize;
-    } else {
-        char chunkId[4];
-        uint32_t chunkSize = 0;
-        while (file.read(chunkId, 4)) {
-            file.read(reinterpret_cast<char*>(&chunkSize), 4);
-            if (std::memcmp(chunkId, "data", 4) == 0) {
-                dataSize = chunkSize;
-                break;
-            }
-            file.seekg(chunkSize, std::ios::cur);
-        }
-    }
-
-    size_t numSamples = dataSize / (bitsPerSample / 8);
+    const size_t numSamples = wav.frames() * wav.channels();
     if (numSamples == 0) {
         LOGE("WAV file has no data");
         return false;
@@ -83,25 +48,11 @@ bool readWavFile(const std::string& path,
         return false;
     }
 
+    sampleRate = wav.sampleRate();
+    numChannels = wav.channels();
+    // Converted straight out of the mapping: no intermediate integer copy.
     samples.resize(numSamples);
-
-    if (bitsPerSample == 16) {
-        std::vector<int16_t> intSamples(numSamples);
-        file.read(reinterpret_cast<char*>(intSamples.data()), dataSize);
-        for (size_t i = 0; i < numSamples; ++i) {
-            samples[i] = intSamples[i] / kInt16MaxF;
-        }
-    } else if (bitsPerSample == 32) {
-        std::vector<int32_t> intSamples(numSamples);
-        file.read(reinterpret_cast<char*>(intSamples.data()), dataSize);
-        for (size_t i = 0; i < numSamples; ++i) {
-            samples[i] = intSamples[i] / kInt32MaxF;
-        }
-    } else {
-        LOGE("Unsupported bit depth: %u", bitsPerSample);
-        return false;
-    }
-
+    wav.readFrames(0, wav.frames(), samples.data());
     return true;
 }
 
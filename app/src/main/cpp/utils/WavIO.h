@@ -45,6 +45,10 @@ inline constexpr float kInt16MaxF = 32768.0f;
 inline constexpr float kInt32MaxF = 2147483648.0f;
 inline constexpr size_t kMaxWavSamples = 100000000;
 
+/**
+ * Decode a whole WAV file to interleaved floats. Accepts every format MappedWavFile
+ * does; prefer MappedWavFile directly when the file can be consumed block by block.
+ */
 bool readWavFile(const std::string& path,
                  std::vector<float>& samples,
                  uint32_t& sampleRate,
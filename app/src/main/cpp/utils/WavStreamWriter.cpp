@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "WavStreamWriter.h"
+#include "AudioKernels.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace guitarrackcraft {
+
+namespace {
+
+constexpr size_t kHeaderBytes = 44;
+constexpr uint16_t kFormatPcm = 1;
+constexpr uint16_t kFormatIeeeFloat = 3;
+
+void put16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+void put32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+bool pwriteAll(int fd, const uint8_t* p, size_t bytes, uint64_t offset) {
+    while (bytes > 0) {
+        const ssize_t n = ::pwrite(fd, p, bytes, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        offset += static_cast<uint64_t>(n);
+        bytes -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+void WavStreamWriter::FreeDeleter::operator()(uint8_t* p) const { std::free(p); }
+
+bool WavStreamWriter::open(const std::string& path, uint32_t sampleRate, uint16_t channels, Format format) {
+    close();
+    if (channels == 0 || sampleRate == 0) return false;
+    if (!batch_) {
+        void* mem = nullptr;
+        if (posix_memalign(&mem, kPageBytes, kBatchBytes) != 0) return false;
+        batch_.reset(static_cast<uint8_t*>(mem));
+    }
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) return false;
+    channels_ = channels;
+    format_ = format;
+    bytesPerSample_ = format == Format::Pcm16 ? 2 : format == Format::Pcm24 ? 3 : 4;
+    samplesWritten_ = 0;
+
+    // Assembled in the batch buffer and written at offset 0; fileOffset_ then tracks
+    // the file position so that later batches end on page boundaries.
+    uint8_t* header = batch_.get();
+    const auto blockAlign = static_cast<uint16_t>(channels * bytesPerSample_);
+    std::memcpy(header, "RIFF", 4);
+    put32(header + 4, kHeaderBytes - 8);
+    std::memcpy(header + 8, "WAVEfmt ", 8);
+    put32(header + 16, 16);
+    put16(header + 20, format == Format::Float32 ? kFormatIeeeFloat : kFormatPcm);
+    put16(header + 22, channels);
+    put32(header + 24, sampleRate);
+    put32(header + 28, sampleRate * blockAlign);
+    put16(header + 32, blockAlign);
+    put16(header + 34, static_cast<uint16_t>(bytesPerSample_ * 8));
+    std::memcpy(header + 36, "data", 4);
+    put32(header + 40, 0);
+    batchFill_ = kHeaderBytes;
+    fileOffset_ = 0;
+    if (!flush(false)) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+bool WavStreamWriter::writeSamples(const float* interleaved, size_t samples) {
+    if (fd_ < 0) return false;
+    while (samples > 0) {
+        const size_t n = std::min(samples, (kBatchBytes - batchFill_) / bytesPerSample_);
+        uint8_t* dst = batch_.get() + batchFill_;
+        switch (format_) {
+            case Format::Pcm16: kernels::floatToPcm16(interleaved, dst, n); break;
+            case Format::Pcm24: kernels::floatToPcm24(interleaved, dst, n); break;
+            case Format::Float32: std::memcpy(dst, interleaved, n * sizeof(float)); break;
+        }
+        batchFill_ += n * bytesPerSample_;
+        samplesWritten_ += n;
+        interleaved += n;
+        samples -= n;
+        if (kBatchBytes - batchFill_ < bytesPerSample_ && !flush(true)) return false;
+    }
+    return true;
+}
+
+bool WavStreamWriter::flush(bool pageAligned) {
+    size_t bytes = batchFill_;
+    if (pageAligned) {
+        // Stop at the last page boundary of the file; the remainder (under a page) is
+        // moved to the front and goes out with the next batch.
+        const uint64_t end = (fileOffset_ + batchFill_) & ~static_cast<uint64_t>(kPageBytes - 1);
+        bytes = end > fileOffset_ ? static_cast<size_t>(end - fileOffset_) : 0;
+    }
+    if (bytes == 0) return true;
+    if (!pwriteAll(fd_, batch_.get(), bytes, fileOffset_)) return false;
+    std::memmove(batch_.get(), batch_.get() + bytes, batchFill_ - bytes);
+    batchFill_ -= bytes;
+    fileOffset_ += bytes;
+    return true;
+}
+
+bool WavStreamWriter::checkpoint() {
+    if (fd_ < 0) return false;
+    if (!flush(false)) return false;
+    const uint32_t dataBytes = static_cast<uint32_t>(framesWritten() * channels_ * bytesPerSample_);
+    uint8_t size[4];
+    put32(size, static_cast<uint32_t>(kHeaderBytes - 8) + dataBytes);
+    if (pwrite(fd_, size, 4, 4) != 4) return false;
+    put32(size, dataBytes);
+    return pwrite(fd_, size, 4, 40) == 4;
+}
+
+bool WavStreamWriter::close() {
+    if (fd_ < 0) return true;
+    const bool ok = checkpoint();
+    const bool closed = ::close(fd_) == 0;
+    fd_ = -1;
+    return ok && closed;
+}
+
+} // namespace guitarrackcraft
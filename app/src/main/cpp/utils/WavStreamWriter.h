@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "AudioFileWriter.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace guitarrackcraft {
+
+/**
+ * Streaming WAV writer. Frames are appended as they are produced, so memory does not
+ * grow with the file. Samples are converted into a page-aligned batch buffer that is
+ * written out in large pwrite() calls ending on a page boundary of the file, so the
+ * storage sees few, whole-page writes instead of one small write per block.
+ * checkpoint() flushes and rewrites the RIFF and data sizes for everything written so
+ * far: a file left behind by a crash or a failed render is still a valid WAV up to its
+ * last checkpoint.
+ */
+class WavStreamWriter : public AudioFileWriter {
+public:
+    enum class Format : uint8_t {
+        Pcm16,    // clamped to [-1, 1]
+        Pcm24,    // clamped to [-1, 1]
+        Float32,  // IEEE float, unclamped: keeps headroom above full scale
+    };
+
+    WavStreamWriter() = default;
+    ~WavStreamWriter() override { close(); }
+
+    WavStreamWriter(const WavStreamWriter&) = delete;
+    WavStreamWriter& operator=(const WavStreamWriter&) = delete;
+
+    /** Create/truncate path and write the header. */
+    bool open(const std::string& path, uint32_t sampleRate, uint16_t channels, Format format = Format::Pcm16);
+
+    /**
+     * Append samples of interleaved floats. Anything that is not a whole number of frames
+     * is carried into the next call, so a ring drained in two spans can be written as is.
+     */
+    bool write(const float* interleaved, size_t frames) { return writeSamples(interleaved, frames * channels_); }
+    bool writeSamples(const float* interleaved, size_t samples) override;
+
+    /** Flush the batch buffer and patch the header sizes to the frames written so far. */
+    bool checkpoint() override;
+
+    /** Final checkpoint and close; safe to call twice. */
+    bool close() override;
+
+    bool isOpen() const override { return fd_ >= 0; }
+    size_t framesWritten() const override { return channels_ ? samplesWritten_ / channels_ : 0; }
+    Format format() const { return format_; }
+
+    static constexpr size_t kPageBytes = 4096;
+    static constexpr size_t kBatchBytes = 128 * 1024;
+
+private:
+    struct FreeDeleter {
+        void operator()(uint8_t* p) const;
+    };
+
+    int fd_ = -1;
+    uint16_t channels_ = 0;
+    Format format_ = Format::Pcm16;
+    size_t bytesPerSample_ = 2;
+    size_t samplesWritten_ = 0;
+    std::unique_ptr<uint8_t[], FreeDeleter> batch_;
+    size_t batchFill_ = 0;
+    uint64_t fileOffset_ = 0;  // where batch_[0] goes
+
+    bool flush(bool pageAligned);
+};
+
+} // namespace guitarrackcraft
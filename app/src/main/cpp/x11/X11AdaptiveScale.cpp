@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "X11AdaptiveScale.h"
+
+namespace guitarrackcraft {
+
+namespace {
+constexpr float kScales[X11AdaptiveScale::kLevelCount] = { 1.0f, 0.85f, 0.7f, 0.55f };
+}
+
+float X11AdaptiveScale::scaleFor(int level) {
+    if (level < 0) level = 0;
+    if (level >= kLevelCount) level = kLevelCount - 1;
+    return kScales[level];
+}
+
+int X11AdaptiveScale::thermalFloor(int thermalStatus) {
+    if (thermalStatus >= 4) return 3;  // CRITICAL, EMERGENCY, SHUTDOWN
+    if (thermalStatus >= 2) return thermalStatus - 1;  // MODERATE, SEVERE
+    return 0;
+}
+
+bool X11AdaptiveScale::update(int64_t nowNs, float cpuLoad, int thermalStatus) {
+    if (cpuLoad > kHighLoad) {
+        lowSinceNs_ = -1;
+        if (highSinceNs_ < 0) highSinceNs_ = nowNs;
+    } else if (cpuLoad < kLowLoad) {
+        highSinceNs_ = -1;
+        if (lowSinceNs_ < 0) lowSinceNs_ = nowNs;
+    } else {
+        highSinceNs_ = lowSinceNs_ = -1;
+    }
+
+    int floor = thermalFloor(thermalStatus);
+    int next = level_;
+    if (level_ < floor) {
+        next = floor;  // thermal steps are already slow; no dwell
+    } else if (changed_ && nowNs - lastChangeNs_ < kMinDwellNs) {
+        return false;
+    } else if (highSinceNs_ >= 0 && nowNs - highSinceNs_ >= kDownAfterNs && level_ < kLevelCount - 1) {
+        next = level_ + 1;
+    } else if (lowSinceNs_ >= 0 && nowNs - lowSinceNs_ >= kUpAfterNs && level_ > floor) {
+        next = level_ - 1;
+    }
+    if (next == level_) return false;
+
+    level_ = next;
+    lastChangeNs_ = nowNs;
+    changed_ = true;
+    /* The load sample after a step reflects the new scale; measure from here */
+    highSinceNs_ = highSinceNs_ >= 0 ? nowNs : -1;
+    lowSinceNs_ = lowSinceNs_ >= 0 ? nowNs : -1;
+    return true;
+}
+
+void X11AdaptiveScale::reset() {
+    level_ = 0;
+    highSinceNs_ = lowSinceNs_ = -1;
+    lastChangeNs_ = 0;
+    changed_ = false;
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace guitarrackcraft {
+
+/**
+ * Picks the resolution fraction X11 plugin UIs render at. Cairo drawing in plugin UIs
+ * runs on the same cores as the DSP, so when the audio callback's load stays high or the
+ * device heats up the UI steps down to fewer pixels; sustained light load steps it back
+ * up. Each step costs the plugin a full relayout and repaint, so changes are spaced at
+ * least kMinDwellNs apart and the load thresholds have a wide gap between them.
+ * Thermal status uses the AThermalStatus values (0 none .. 6 shutdown). Single thread.
+ */
+class X11AdaptiveScale {
+public:
+    static constexpr int kLevelCount = 4;
+    static constexpr float kHighLoad = 0.75f;                // step down above this
+    static constexpr float kLowLoad = 0.45f;                 // step up below this
+    static constexpr int64_t kDownAfterNs = 1000000000LL;    // high load this long
+    static constexpr int64_t kUpAfterNs = 5000000000LL;      // light load this long
+    static constexpr int64_t kMinDwellNs = 3000000000LL;
+
+    /** Scale factor of a level; level 0 is full resolution. */
+    static float scaleFor(int level);
+    /** Lowest level allowed at a thermal status: MODERATE 1, SEVERE 2, CRITICAL and above 3. */
+    static int thermalFloor(int thermalStatus);
+
+    /**
+     * Feed a sample of audio load (0..1, share of the callback deadline) and the thermal
+     * status at nowNs. Returns true if level() changed.
+     */
+    bool update(int64_t nowNs, float cpuLoad, int thermalStatus);
+
+    int level() const { return level_; }
+    float scale() const { return scaleFor(level_); }
+    void reset();
+
+private:
+    int level_ = 0;
+    int64_t highSinceNs_ = -1;
+    int64_t lowSinceNs_ = -1;
+    int64_t lastChangeNs_ = 0;
+    bool changed_ = false;  // lastChangeNs_ is valid
+};
+
+} // namespace guitarrackcraft
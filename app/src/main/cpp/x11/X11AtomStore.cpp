@@ -18,35 +18,120 @@
  */
 
 #include "X11AtomStore.h"
+#include <algorithm>
+#include <cstring>
 
 namespace guitarrackcraft {
 
-uint32_t X11AtomStore::intern(const std::string& name, bool onlyIfExists) {
-    auto it = nameToId_.find(name);
-    if (it != nameToId_.end()) {
-        return it->second;
+namespace {
+
+constexpr uint32_t kInitialSlots = 512;  // predefined atoms plus what a toolkit interns
+constexpr size_t kChunkBytes = 4096;
+
+// Core protocol predefined atoms, in id order (X11/Xatom.h)
+constexpr std::string_view kPredefinedAtoms[X11AtomStore::kLastPredefinedAtom] = {
+    "PRIMARY", "SECONDARY", "ARC", "ATOM", "BITMAP", "CARDINAL", "COLORMAP", "CURSOR",
+    "CUT_BUFFER0", "CUT_BUFFER1", "CUT_BUFFER2", "CUT_BUFFER3", "CUT_BUFFER4", "CUT_BUFFER5",
+    "CUT_BUFFER6", "CUT_BUFFER7", "DRAWABLE", "FONT", "INTEGER", "PIXMAP", "POINT", "RECTANGLE",
+    "RESOURCE_MANAGER", "RGB_COLOR_MAP", "RGB_BEST_MAP", "RGB_BLUE_MAP", "RGB_DEFAULT_MAP",
+    "RGB_GRAY_MAP", "RGB_GREEN_MAP", "RGB_RED_MAP", "STRING", "VISUALID", "WINDOW", "WM_COMMAND",
+    "WM_HINTS", "WM_CLIENT_MACHINE", "WM_ICON_NAME", "WM_ICON_SIZE", "WM_NAME", "WM_NORMAL_HINTS",
+    "WM_SIZE_HINTS", "WM_ZOOM_HINTS", "MIN_SPACE", "NORM_SPACE", "MAX_SPACE", "END_SPACE",
+    "SUPERSCRIPT_X", "SUPERSCRIPT_Y", "SUBSCRIPT_X", "SUBSCRIPT_Y", "UNDERLINE_POSITION",
+    "UNDERLINE_THICKNESS", "STRIKEOUT_ASCENT", "STRIKEOUT_DESCENT", "ITALIC_ANGLE", "X_HEIGHT",
+    "QUAD_WIDTH", "WEIGHT", "POINT_SIZE", "RESOLUTION", "COPYRIGHT", "NOTICE", "FONT_NAME",
+    "FAMILY_NAME", "FULL_NAME", "CAP_HEIGHT", "WM_CLASS", "WM_TRANSIENT_FOR",
+};
+
+} // namespace
+
+X11AtomStore::X11AtomStore() {
+    clear();
+}
+
+uint32_t X11AtomStore::hashName(std::string_view name) {
+    // FNV-1a; toolkit atoms share prefixes (_NET_WM_, WM_), so hash every byte
+    uint32_t h = 2166136261u;
+    for (char c : name) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+uint32_t X11AtomStore::probe(std::string_view name, uint32_t hash) const {
+    const uint32_t mask = static_cast<uint32_t>(slots_.size()) - 1;
+    uint32_t i = hash & mask;
+    while (slots_[i].id != 0 && (slots_[i].hash != hash || names_[slots_[i].id] != name)) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+void X11AtomStore::insert(std::string_view name, uint32_t hash) {
+    const uint32_t id = static_cast<uint32_t>(names_.size());
+    names_.push_back(name);
+    slots_[probe(name, hash)] = {hash, id};
+}
+
+void X11AtomStore::grow() {
+    std::vector<Slot> old(slots_.size() * 2);
+    old.swap(slots_);
+    const uint32_t mask = static_cast<uint32_t>(slots_.size()) - 1;
+    for (const Slot& s : old) {
+        if (s.id == 0) continue;
+        uint32_t i = s.hash & mask;
+        while (slots_[i].id != 0) i = (i + 1) & mask;
+        slots_[i] = s;
     }
-    if (!onlyIfExists && !name.empty()) {
-        uint32_t id = nextId_++;
-        nameToId_[name] = id;
-        idToName_[id] = name;
-        return id;
+}
+
+std::string_view X11AtomStore::store(std::string_view name) {
+    if (chunks_.empty() || chunkUsed_ + name.size() > chunkSize_) {
+        chunkSize_ = std::max(kChunkBytes, name.size());
+        chunks_.emplace_back(new char[chunkSize_]);
+        chunkUsed_ = 0;
     }
-    return 0; // None
+    char* dst = chunks_.back().get() + chunkUsed_;
+    std::memcpy(dst, name.data(), name.size());
+    chunkUsed_ += name.size();
+    return {dst, name.size()};
 }
 
-std::string X11AtomStore::getName(uint32_t atomId) const {
-    auto it = idToName_.find(atomId);
-    if (it != idToName_.end()) {
-        return it->second;
+uint32_t X11AtomStore::intern(std::string_view name, bool onlyIfExists) {
+    if (name.empty()) return 0; // None
+    const uint32_t hash = hashName(name);
+    const uint32_t slot = probe(name, hash);
+    if (slots_[slot].id != 0) {
+        return slots_[slot].id;
+    }
+    if (onlyIfExists) return 0;
+
+    if ((names_.size() + 1) * 2 > slots_.size()) {
+        grow();
+    }
+    insert(store(name), hash);
+    return static_cast<uint32_t>(names_.size()) - 1;
+}
+
+std::string_view X11AtomStore::getName(uint32_t atomId) const {
+    if (atomId < names_.size()) {
+        return names_[atomId];
     }
     return {};
 }
 
 void X11AtomStore::clear() {
-    nameToId_.clear();
-    idToName_.clear();
-    nextId_ = 1;
+    // Keep one chunk and the table's capacity for the next connection
+    if (chunks_.size() > 1) chunks_.resize(1);
+    chunkUsed_ = 0;
+    if (!chunks_.empty()) chunkSize_ = kChunkBytes;
+    slots_.assign(kInitialSlots, Slot{});
+    names_.clear();
+    names_.emplace_back();
+    for (std::string_view name : kPredefinedAtoms) {
+        insert(name, hashName(name));
+    }
 }
 
 } // namespace guitarrackcraft
@@ -20,26 +20,56 @@
 #pragma once
 
 #include <cstdint>
-#include <string>
-#include <unordered_map>
+#include <memory>
+#include <string_view>
+#include <vector>
 
 namespace guitarrackcraft {
 
+/**
+ * InternAtom / GetAtomName table for one client connection.
+ *
+ * The 68 predefined atoms of the core protocol (PRIMARY = 1 .. WM_TRANSIENT_FOR = 68) are
+ * always present, so clients that use XA_* constants without interning agree with the server;
+ * interned atoms are numbered from kFirstDynamicAtom. Names are looked up in a flat
+ * open-addressing table of ids (load factor <= 0.5) and copied into chunked storage, so a toolkit
+ * interning a few hundred atoms at startup costs a handful of allocations.
+ */
 class X11AtomStore {
 public:
+    static constexpr uint32_t kLastPredefinedAtom = 68;  // WM_TRANSIENT_FOR
+    static constexpr uint32_t kFirstDynamicAtom = kLastPredefinedAtom + 1;
+
+    X11AtomStore();
+
     // InternAtom: look up or create. Returns 0 (None) if onlyIfExists and not found.
-    uint32_t intern(const std::string& name, bool onlyIfExists);
+    uint32_t intern(std::string_view name, bool onlyIfExists);
 
     // GetAtomName: reverse lookup. Returns empty string if not found.
-    std::string getName(uint32_t atomId) const;
+    // The view stays valid until clear().
+    std::string_view getName(uint32_t atomId) const;
 
-    // Reset for new connection.
+    // Reset for new connection (predefined atoms are kept).
     void clear();
 
 private:
-    std::unordered_map<std::string, uint32_t> nameToId_;
-    std::unordered_map<uint32_t, std::string> idToName_;
-    uint32_t nextId_ = 1;
+    struct Slot {
+        uint32_t hash = 0;
+        uint32_t id = 0;  // 0 = empty
+    };
+
+    static uint32_t hashName(std::string_view name);
+    /** Slot holding name, or the empty slot where the probe stopped. */
+    uint32_t probe(std::string_view name, uint32_t hash) const;
+    void insert(std::string_view name, uint32_t hash);
+    void grow();
+    std::string_view store(std::string_view name);
+
+    std::vector<Slot> slots_;             // power-of-2 size
+    std::vector<std::string_view> names_; // indexed by id; names_[0] is None
+    std::vector<std::unique_ptr<char[]>> chunks_;  // interned names (predefined ones are static)
+    size_t chunkUsed_ = 0;
+    size_t chunkSize_ = 0;
 };
 
 } // namespace guitarrackcraft
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "X11Blit.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define GRC_BLIT_NEON 1
+#endif
+
+namespace guitarrackcraft {
+namespace blit {
+
+namespace scalar {
+
+void copyRowOpaque(uint32_t* dst, const uint8_t* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t p;
+        std::memcpy(&p, src + i * 4, 4);
+        dst[i] = p | 0xFF000000u;
+    }
+}
+
+void copyRowOpaqueMsb(uint32_t* dst, const uint8_t* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t* s = src + i * 4;
+        dst[i] = (uint32_t)s[1] << 16 | (uint32_t)s[2] << 8 | s[3] | 0xFF000000u;
+    }
+}
+
+void fillRow(uint32_t* dst, uint32_t pixel, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] = pixel;
+}
+
+} // namespace scalar
+
+#if GRC_BLIT_NEON
+
+void copyRowOpaque(uint32_t* dst, const uint8_t* src, size_t n) {
+    const uint32x4_t alpha = vdupq_n_u32(0xFF000000u);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const uint8_t* s = src + i * 4;
+        uint8x16_t v0 = vld1q_u8(s), v1 = vld1q_u8(s + 16), v2 = vld1q_u8(s + 32), v3 = vld1q_u8(s + 48);
+        vst1q_u32(dst + i,      vorrq_u32(vreinterpretq_u32_u8(v0), alpha));
+        vst1q_u32(dst + i + 4,  vorrq_u32(vreinterpretq_u32_u8(v1), alpha));
+        vst1q_u32(dst + i + 8,  vorrq_u32(vreinterpretq_u32_u8(v2), alpha));
+        vst1q_u32(dst + i + 12, vorrq_u32(vreinterpretq_u32_u8(v3), alpha));
+    }
+    for (; i + 4 <= n; i += 4) {
+        vst1q_u32(dst + i, vorrq_u32(vreinterpretq_u32_u8(vld1q_u8(src + i * 4)), alpha));
+    }
+    scalar::copyRowOpaque(dst + i, src + i * 4, n - i);
+}
+
+void copyRowOpaqueMsb(uint32_t* dst, const uint8_t* src, size_t n) {
+    /* Byte-reverse each pixel ([A,R,G,B] -> [B,G,R,A]) then force alpha */
+    const uint32x4_t alpha = vdupq_n_u32(0xFF000000u);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const uint8_t* s = src + i * 4;
+        uint8x16_t v0 = vld1q_u8(s), v1 = vld1q_u8(s + 16), v2 = vld1q_u8(s + 32), v3 = vld1q_u8(s + 48);
+        vst1q_u32(dst + i,      vorrq_u32(vreinterpretq_u32_u8(vrev32q_u8(v0)), alpha));
+        vst1q_u32(dst + i + 4,  vorrq_u32(vreinterpretq_u32_u8(vrev32q_u8(v1)), alpha));
+        vst1q_u32(dst + i + 8,  vorrq_u32(vreinterpretq_u32_u8(vrev32q_u8(v2)), alpha));
+        vst1q_u32(dst + i + 12, vorrq_u32(vreinterpretq_u32_u8(vrev32q_u8(v3)), alpha));
+    }
+    for (; i + 4 <= n; i += 4) {
+        vst1q_u32(dst + i, vorrq_u32(vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(src + i * 4))), alpha));
+    }
+    scalar::copyRowOpaqueMsb(dst + i, src + i * 4, n - i);
+}
+
+void fillRow(uint32_t* dst, uint32_t pixel, size_t n) {
+    const uint32x4_t v = vdupq_n_u32(pixel);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        vst1q_u32(dst + i, v);
+        vst1q_u32(dst + i + 4, v);
+        vst1q_u32(dst + i + 8, v);
+        vst1q_u32(dst + i + 12, v);
+    }
+    for (; i + 4 <= n; i += 4) vst1q_u32(dst + i, v);
+    scalar::fillRow(dst + i, pixel, n - i);
+}
+
+#else
+
+void copyRowOpaque(uint32_t* dst, const uint8_t* src, size_t n) { scalar::copyRowOpaque(dst, src, n); }
+void copyRowOpaqueMsb(uint32_t* dst, const uint8_t* src, size_t n) { scalar::copyRowOpaqueMsb(dst, src, n); }
+void fillRow(uint32_t* dst, uint32_t pixel, size_t n) { scalar::fillRow(dst, pixel, n); }
+
+#endif // GRC_BLIT_NEON
+
+void visibleSpans(int y, int x1, int x2, const std::vector<ClipRect>& clips,
+                  std::vector<Span>& out, int& bandEnd) {
+    out.clear();
+    bandEnd = INT_MAX;
+    /* Occluded intervals on this row, clamped to [x1, x2) */
+    static thread_local std::vector<Span> hidden;
+    hidden.clear();
+    for (const auto& cr : clips) {
+        if (y < cr.y1) {
+            bandEnd = std::min(bandEnd, cr.y1);
+            continue;
+        }
+        if (y >= cr.y2) continue;
+        bandEnd = std::min(bandEnd, cr.y2);
+        int a = std::max(cr.x1, x1), b = std::min(cr.x2, x2);
+        if (a < b) hidden.push_back({a, b});
+    }
+    std::sort(hidden.begin(), hidden.end(), [](const Span& a, const Span& b) { return a.x1 < b.x1; });
+    int cursor = x1;
+    for (const auto& h : hidden) {
+        if (h.x1 > cursor) out.push_back({cursor, h.x1});
+        cursor = std::max(cursor, h.x2);
+    }
+    if (cursor < x2) out.push_back({cursor, x2});
+}
+
+} // namespace blit
+} // namespace guitarrackcraft
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace guitarrackcraft {
+
+struct ClipRect {
+    int x1, y1, x2, y2;
+};
+
+namespace blit {
+
+/**
+ * Row kernels for the X11 image paths. Pixels are stored in X11 wire format (BGRA as a
+ * little-endian uint32) and forced opaque on the way in, because Cairo reads them back
+ * as depth 24 and expects the padding byte to be 0xFF. The NEON versions move 16 pixels
+ * per iteration; sources may be unaligned (they point into request buffers) and tails
+ * are handled scalar. Straight copies are plain memcpy/memmove.
+ */
+
+/** dst[i] = src[i] | 0xFF000000, src being LSB-first wire pixels. */
+void copyRowOpaque(uint32_t* dst, const uint8_t* src, size_t n);
+
+/** MSB-first wire pixels ([A,R,G,B] bytes) to stored BGRA, forced opaque. */
+void copyRowOpaqueMsb(uint32_t* dst, const uint8_t* src, size_t n);
+
+/** dst[i] = pixel (solid fills). */
+void fillRow(uint32_t* dst, uint32_t pixel, size_t n);
+
+/** Horizontal visible run [x1, x2) on one row. */
+struct Span {
+    int x1, x2;
+};
+
+/**
+ * Visible parts of [x1, x2) on row y once the clip rects (areas not to draw) are
+ * removed, left to right. bandEnd receives the first row below y where the set of
+ * rects crossing the row changes, so the spans can be reused for rows [y, bandEnd).
+ */
+void visibleSpans(int y, int x1, int x2, const std::vector<ClipRect>& clips,
+                  std::vector<Span>& out, int& bandEnd);
+
+/** Plain loops with the same contracts; the reference for tests and benchmarks. */
+namespace scalar {
+void copyRowOpaque(uint32_t* dst, const uint8_t* src, size_t n);
+void copyRowOpaqueMsb(uint32_t* dst, const uint8_t* src, size_t n);
+void fillRow(uint32_t* dst, uint32_t pixel, size_t n);
+} // namespace scalar
+
+} // namespace blit
+} // namespace guitarrackcraft
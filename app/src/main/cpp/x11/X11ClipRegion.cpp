@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "X11ClipRegion.h"
+#include <algorithm>
+#include <climits>
+
+namespace guitarrackcraft {
+
+void X11ClipRegion::setRects(const std::vector<ClipRect>& rects) {
+    clear();
+    std::vector<int> edges;
+    edges.reserve(rects.size() * 2);
+    for (const auto& r : rects) {
+        if (r.x1 >= r.x2 || r.y1 >= r.y2) continue;
+        edges.push_back(r.y1);
+        edges.push_back(r.y2);
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    std::vector<blit::Span> row;
+    for (size_t e = 0; e + 1 < edges.size(); e++) {
+        const int y1 = edges[e], y2 = edges[e + 1];
+        row.clear();
+        for (const auto& r : rects) {
+            if (r.x1 < r.x2 && r.y1 <= y1 && r.y2 >= y2) row.push_back({r.x1, r.x2});
+        }
+        if (row.empty()) continue;
+        std::sort(row.begin(), row.end(),
+                  [](const blit::Span& a, const blit::Span& b) { return a.x1 < b.x1; });
+        // Merge overlapping and touching spans in place
+        size_t n = 0;
+        for (const auto& s : row) {
+            if (n > 0 && s.x1 <= row[n - 1].x2) {
+                row[n - 1].x2 = std::max(row[n - 1].x2, s.x2);
+            } else {
+                row[n++] = s;
+            }
+        }
+        row.resize(n);
+
+        // Coalesce with the band above when it touches and has the same spans
+        if (!bands_.empty()) {
+            Band& prev = bands_.back();
+            if (prev.y2 == y1 && prev.count == n &&
+                std::equal(row.begin(), row.end(), spans_.begin() + prev.first,
+                           [](const blit::Span& a, const blit::Span& b) {
+                               return a.x1 == b.x1 && a.x2 == b.x2;
+                           })) {
+                prev.y2 = y2;
+                continue;
+            }
+        }
+        bands_.push_back({y1, y2, (uint32_t)spans_.size(), (uint32_t)n});
+        spans_.insert(spans_.end(), row.begin(), row.end());
+    }
+}
+
+size_t X11ClipRegion::bandAt(int y) const {
+    auto it = std::upper_bound(bands_.begin(), bands_.end(), y,
+                               [](int v, const Band& b) { return v < b.y2; });
+    return (size_t)(it - bands_.begin());
+}
+
+bool X11ClipRegion::contains(int x, int y) const {
+    size_t b = bandAt(y);
+    if (b == bands_.size() || y < bands_[b].y1) return false;
+    const Band& band = bands_[b];
+    for (uint32_t i = band.first; i < band.first + band.count; i++) {
+        if (x < spans_[i].x1) return false;
+        if (x < spans_[i].x2) return true;
+    }
+    return false;
+}
+
+std::vector<ClipRect> X11ClipRegion::rects() const {
+    std::vector<ClipRect> out;
+    out.reserve(spans_.size());
+    for (const auto& band : bands_) {
+        for (uint32_t i = band.first; i < band.first + band.count; i++) {
+            out.push_back({spans_[i].x1, band.y1, spans_[i].x2, band.y2});
+        }
+    }
+    return out;
+}
+
+void X11ClipRegion::visibleSpans(int y, int x1, int x2, std::vector<blit::Span>& out,
+                                 int& bandEnd) const {
+    out.clear();
+    size_t b = bandAt(y);
+    if (b == bands_.size()) {
+        bandEnd = INT_MAX;
+        if (x1 < x2) out.push_back({x1, x2});
+        return;
+    }
+    const Band& band = bands_[b];
+    if (y < band.y1) {
+        // In the gap above this band: nothing hidden until it starts
+        bandEnd = band.y1;
+        if (x1 < x2) out.push_back({x1, x2});
+        return;
+    }
+    bandEnd = band.y2;
+    int cursor = x1;
+    for (uint32_t i = band.first; i < band.first + band.count && cursor < x2; i++) {
+        const auto& s = spans_[i];
+        if (s.x2 <= cursor) continue;
+        if (s.x1 >= x2) break;
+        if (s.x1 > cursor) out.push_back({cursor, s.x1});
+        cursor = s.x2;
+    }
+    if (cursor < x2) out.push_back({cursor, x2});
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "X11Blit.h"
+
+namespace guitarrackcraft {
+
+/**
+ * Union of rectangles stored as y-x bands, the layout pixman regions use: bands are
+ * sorted top to bottom and never overlap, each holds sorted, disjoint, non-touching
+ * x spans, and vertically adjacent bands with identical spans are merged. The window
+ * manager builds one per window from the mapped windows that obscure it and keeps it
+ * until the window tree changes, so PutImage walks the visible spans of each band
+ * instead of testing every pixel against every rect.
+ */
+class X11ClipRegion {
+public:
+    struct Band {
+        int y1, y2;
+        uint32_t first, count;  // range in spans()
+    };
+
+    /** Replace the region with the union of rects; empty rects are ignored. */
+    void setRects(const std::vector<ClipRect>& rects);
+
+    void clear() { bands_.clear(); spans_.clear(); }
+    bool empty() const { return bands_.empty(); }
+    bool contains(int x, int y) const;
+
+    const std::vector<Band>& bands() const { return bands_; }
+    const std::vector<blit::Span>& spans() const { return spans_; }
+
+    /** The region as rects, one per band span (for logging and tests). */
+    std::vector<ClipRect> rects() const;
+
+    /**
+     * Parts of [x1, x2) on row y not covered by the region, left to right. bandEnd
+     * receives the first row below y where coverage changes, so the spans hold for
+     * rows [y, bandEnd). Same contract as blit::visibleSpans.
+     */
+    void visibleSpans(int y, int x1, int x2, std::vector<blit::Span>& out, int& bandEnd) const;
+
+private:
+    /** Index of the first band with y2 > y (bands_.size() if none). */
+    size_t bandAt(int y) const;
+
+    std::vector<Band> bands_;
+    std::vector<blit::Span> spans_;
+};
+
+} // namespace guitarrackcraft
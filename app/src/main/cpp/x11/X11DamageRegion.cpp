@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "X11DamageRegion.h"
+#include <algorithm>
+
+namespace guitarrackcraft {
+
+namespace {
+
+bool touches(const DamageRect& a, const DamageRect& b) {
+    return a.x1 <= b.x2 && b.x1 <= a.x2 && a.y1 <= b.y2 && b.y1 <= a.y2;
+}
+
+DamageRect unite(const DamageRect& a, const DamageRect& b) {
+    return {std::min(a.x1, b.x1), std::min(a.y1, b.y1),
+            std::max(a.x2, b.x2), std::max(a.y2, b.y2)};
+}
+
+} // namespace
+
+void X11DamageRegion::reset(int w, int h) {
+    width_ = std::max(w, 0);
+    height_ = std::max(h, 0);
+    rects_.clear();
+    addAll();
+}
+
+void X11DamageRegion::add(int x, int y, int w, int h) {
+    if (w <= 0 || h <= 0) return;
+    DamageRect r{std::max(x, 0), std::max(y, 0),
+                 std::min(x + w, width_), std::min(y + h, height_)};
+    if (r.x1 >= r.x2 || r.y1 >= r.y2) return;
+
+    // Absorb every rect the new one touches; the grown rect may now touch
+    // rects it missed earlier, so rescan until nothing else merges.
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < rects_.size(); ++i) {
+            if (touches(rects_[i], r)) {
+                r = unite(rects_[i], r);
+                rects_[i] = rects_.back();
+                rects_.pop_back();
+                merged = true;
+                break;
+            }
+        }
+    }
+    rects_.push_back(r);
+    if (rects_.size() > kMaxRects) collapse();
+}
+
+void X11DamageRegion::addAll() {
+    if (width_ <= 0 || height_ <= 0) return;
+    rects_.assign(1, DamageRect{0, 0, width_, height_});
+}
+
+bool X11DamageRegion::full() const {
+    return rects_.size() == 1 && rects_[0].x1 == 0 && rects_[0].y1 == 0 &&
+           rects_[0].x2 == width_ && rects_[0].y2 == height_;
+}
+
+size_t X11DamageRegion::area() const {
+    size_t total = 0;
+    for (const auto& r : rects_) total += r.area();
+    return total;
+}
+
+void X11DamageRegion::collapse() {
+    DamageRect box = rects_[0];
+    for (size_t i = 1; i < rects_.size(); ++i) box = unite(box, rects_[i]);
+    rects_.assign(1, box);
+}
+
+} // namespace guitarrackcraft
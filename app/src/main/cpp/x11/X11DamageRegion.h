@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/** Damaged area in framebuffer pixels; x2/y2 are exclusive. */
+struct DamageRect {
+    int x1, y1, x2, y2;
+    int width() const { return x2 - x1; }
+    int height() const { return y2 - y1; }
+    size_t area() const { return (size_t)width() * (size_t)height(); }
+};
+
+/**
+ * Accumulates the framebuffer area touched since the last frame as a short list
+ * of merged, non-touching rectangles. The server thread adds rects from
+ * PutImage/CopyArea; the render thread copies and uploads only those
+ * regions. Overlapping or adjacent rects are merged, and once the list grows past
+ * kMaxRects it collapses to the bounding box so per-frame upload cost stays bounded.
+ * Not thread-safe: callers guard it with the framebuffer mutex.
+ */
+class X11DamageRegion {
+public:
+    static constexpr size_t kMaxRects = 16;
+
+    /** Set the clip bounds (framebuffer size) and mark everything damaged. */
+    void reset(int w, int h);
+
+    /** Add a w*h rect at (x, y), clipped to the bounds. Empty results are ignored. */
+    void add(int x, int y, int w, int h);
+
+    /** Mark the whole bounds damaged. */
+    void addAll();
+
+    void clear() { rects_.clear(); }
+    bool empty() const { return rects_.empty(); }
+    bool full() const;
+    const std::vector<DamageRect>& rects() const { return rects_; }
+    size_t area() const;
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+private:
+    void collapse();
+
+    int width_ = 0, height_ = 0;
+    std::vector<DamageRect> rects_;
+};
+
+} // namespace guitarrackcraft
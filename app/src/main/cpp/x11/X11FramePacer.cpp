@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "X11FramePacer.h"
+
+namespace guitarrackcraft {
+
+double X11FramePacer::targetHz(int64_t nowNs) const {
+    int64_t quiet = nowNs - lastInputNs_.load(std::memory_order_relaxed);
+    double hz = quiet < kMeterAfterNs ? 0.0 : quiet < kIdleAfterNs ? kMeterHz : kIdleHz;
+    double cap = capHz_.load(std::memory_order_relaxed);
+    if (cap > 0.0 && (hz <= 0.0 || cap < hz)) hz = cap;
+    return hz;
+}
+
+int64_t X11FramePacer::frameDelayNs(int64_t frameTimeNs) const {
+    double hz = targetHz(frameTimeNs);
+    if (hz <= 0.0 || lastFrameNs_ == 0) return 0;
+    int64_t interval = (int64_t)(1e9 / hz);
+    int64_t due = lastFrameNs_ + interval - kSlackNs;
+    return frameTimeNs >= due ? 0 : due - frameTimeNs;
+}
+
+} // namespace guitarrackcraft
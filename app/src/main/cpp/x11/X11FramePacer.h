@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace guitarrackcraft {
+
+/**
+ * Decides which vsyncs the X11 UI render thread draws on. While the user is touching the
+ * UI every vsync with new content is drawn. Once input stops, what still changes is
+ * usually meters driven by the audio side, so the rate drops to kMeterHz and, after a
+ * longer quiet spell, to kIdleHz; the freed GPU/CPU time goes to the audio thread on
+ * thermally limited phones. Times are CLOCK_MONOTONIC nanoseconds, the Choreographer
+ * frame time base. A rate cap (setCapHz) applies on top, input or not. noteInput() and
+ * setCapHz() may be called from any thread; the rest belongs to the render thread.
+ */
+class X11FramePacer {
+public:
+    static constexpr double kMeterHz = 30.0;
+    static constexpr double kIdleHz = 15.0;
+    static constexpr int64_t kMeterAfterNs = 1000000000LL;   // 1 s without input
+    static constexpr int64_t kIdleAfterNs = 10000000000LL;   // 10 s without input
+    /** Vsync timestamps jitter; a frame this early still counts as on time. */
+    static constexpr int64_t kSlackNs = 4000000LL;
+
+    /** User input (or an explicit frame request) at nowNs: go back to full rate. */
+    void noteInput(int64_t nowNs) { lastInputNs_.store(nowNs, std::memory_order_relaxed); }
+
+    /** Never draw faster than 'hz' (0 = no cap), e.g. while the audio engine sheds load. */
+    void setCapHz(double hz) { capHz_.store(hz, std::memory_order_relaxed); }
+
+    /** Frame rate cap at nowNs; 0 means every vsync. */
+    double targetHz(int64_t nowNs) const;
+
+    /**
+     * For content pending at vsync frameTimeNs: 0 to draw on this vsync, otherwise how
+     * long until the next frame the current rate allows.
+     */
+    int64_t frameDelayNs(int64_t frameTimeNs) const;
+
+    /** A frame was drawn for vsync frameTimeNs. */
+    void noteFrame(int64_t frameTimeNs) { lastFrameNs_ = frameTimeNs; }
+
+private:
+    std::atomic<int64_t> lastInputNs_{0};
+    std::atomic<double> capHz_{0.0};
+    int64_t lastFrameNs_ = 0;
+};
+
+} // namespace guitarrackcraft
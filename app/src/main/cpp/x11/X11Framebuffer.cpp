@@ -31,99 +31,111 @@ void X11Framebuffer::resize(int w, int h, uint32_t fillColor) {
 void X11Framebuffer::putImage(int x, int y, int w, int h,
                                const uint8_t* pixelData, size_t pixelDataLen,
                                bool msbFirst, const std::vector<ClipRect>& childClip) {
-    if (pixels_.empty() || w <= 0 || h <= 0) return;
-
-    uint32_t* dstBuf = pixels_.data();
-    int dW = width_, dH = height_;
-
-    bool fullyCovered = (x >= 0 && y >= 0 && x + w <= dW && y + h <= dH
-                         && pixelDataLen >= (size_t)w * h * 4);
-
-    if (fullyCovered && !msbFirst && childClip.empty()) {
-        // Fast path: fully inside, LSB-first, no child clipping
-        const uint32_t* src32 = reinterpret_cast<const uint32_t*>(pixelData);
-        for (int row = 0; row < h; row++) {
-            uint32_t* dstRow = dstBuf + (y + row) * dW + x;
-            const uint32_t* srcRow = src32 + row * w;
-            for (int col = 0; col < w; col++) {
-                dstRow[col] = srcRow[col] | 0xFF000000u;
-            }
-        }
-    } else if (fullyCovered && !msbFirst) {
-        // Fast path with child clipping
-        const uint32_t* src32 = reinterpret_cast<const uint32_t*>(pixelData);
-        for (int row = 0; row < h; row++) {
-            int dstY = y + row;
-            uint32_t* dstRow = dstBuf + dstY * dW + x;
-            const uint32_t* srcRow = src32 + row * w;
-            for (int col = 0; col < w; col++) {
-                int dstX = x + col;
-                bool clipped = false;
-                for (auto& cr : childClip) {
-                    if (dstX >= cr.x1 && dstX < cr.x2 && dstY >= cr.y1 && dstY < cr.y2) {
-                        clipped = true; break;
-                    }
-                }
-                if (!clipped) dstRow[col] = srcRow[col] | 0xFF000000u;
-            }
-        }
-    } else {
-        // Slow path with bounds checking and child clipping
-        size_t maxPixelIdx = pixelDataLen;
-        for (int row = 0; row < h; row++) {
-            int dstY = y + row;
-            if (dstY < 0 || dstY >= dH) continue;
-            for (int col = 0; col < w; col++) {
-                int dstX = x + col;
-                if (dstX < 0 || dstX >= dW) continue;
-                bool clipped = false;
-                for (auto& cr : childClip) {
-                    if (dstX >= cr.x1 && dstX < cr.x2 && dstY >= cr.y1 && dstY < cr.y2) {
-                        clipped = true; break;
-                    }
-                }
-                if (clipped) continue;
-                size_t srcIdx = (row * w + col) * 4;
-                if (srcIdx + 3 >= maxPixelIdx) continue;
-                uint32_t pixel;
-                if (msbFirst) {
-                    uint8_t a = pixelData[srcIdx], r = pixelData[srcIdx+1],
-                            g = pixelData[srcIdx+2], b = pixelData[srcIdx+3];
-                    pixel = (a << 24) | (r << 16) | (g << 8) | b;
-                } else {
-                    memcpy(&pixel, &pixelData[srcIdx], 4);
-                }
-                dstBuf[(size_t)dstY * dW + dstX] = pixel | 0xFF000000u;
-            }
+    if (pixels_.empty()) return;
+    putImage(pixels_.data(), width_, height_, x, y, w, h, pixelData, pixelDataLen, msbFirst, childClip);
+}
+
+namespace {
+
+// Shared PutImage body; spansFor(y, x1, x2, out, bandEnd) yields the visible spans of a row
+template <typename SpansFor>
+void putImageSpans(uint32_t* dst, int dstW, int dstH, int x, int y, int w, int h,
+                   const uint8_t* pixelData, size_t pixelDataLen, bool msbFirst,
+                   SpansFor spansFor) {
+    if (!dst || !pixelData || w <= 0 || h <= 0) return;
+
+    // Source columns [c0, c1) and rows [r0, r1) that land inside the destination
+    int c0 = std::max(0, -x), c1 = std::min(w, dstW - x);
+    int r0 = std::max(0, -y), r1 = std::min(h, dstH - y);
+    if (c0 >= c1 || r0 >= r1) return;
+
+    // Short requests only cover their first pixelDataLen / 4 pixels
+    size_t avail = pixelDataLen / 4;
+    if ((size_t)r0 * w >= avail) return;
+    r1 = (int)std::min<size_t>(r1, (avail + w - 1) / w);
+
+    auto copyRow = msbFirst ? blit::copyRowOpaqueMsb : blit::copyRowOpaque;
+
+    static thread_local std::vector<blit::Span> spans;
+    int bandEnd = y + r0;
+    for (int row = r0; row < r1; row++) {
+        int dstY = y + row;
+        if (dstY >= bandEnd) spansFor(dstY, x + c0, x + c1, spans, bandEnd);
+        size_t rowStart = (size_t)row * w;
+        uint32_t* dstRow = dst + (size_t)dstY * dstW;
+        for (const auto& sp : spans) {
+            size_t first = rowStart + (sp.x1 - x);
+            if (first >= avail) break;
+            size_t n = std::min<size_t>(sp.x2 - sp.x1, avail - first);
+            copyRow(dstRow + sp.x1, pixelData + first * 4, n);
         }
     }
 }
 
+} // namespace
+
+void X11Framebuffer::putImage(uint32_t* dst, int dstW, int dstH, int x, int y, int w, int h,
+                               const uint8_t* pixelData, size_t pixelDataLen,
+                               bool msbFirst, const std::vector<ClipRect>& childClip) {
+    putImageSpans(dst, dstW, dstH, x, y, w, h, pixelData, pixelDataLen, msbFirst,
+                  [&](int row, int x1, int x2, std::vector<blit::Span>& out, int& bandEnd) {
+                      blit::visibleSpans(row, x1, x2, childClip, out, bandEnd);
+                  });
+}
+
+void X11Framebuffer::putImage(uint32_t* dst, int dstW, int dstH, int x, int y, int w, int h,
+                               const uint8_t* pixelData, size_t pixelDataLen,
+                               bool msbFirst, const X11ClipRegion& clip) {
+    putImageSpans(dst, dstW, dstH, x, y, w, h, pixelData, pixelDataLen, msbFirst,
+                  [&](int row, int x1, int x2, std::vector<blit::Span>& out, int& bandEnd) {
+                      clip.visibleSpans(row, x1, x2, out, bandEnd);
+                  });
+}
+
 void X11Framebuffer::getImage(int x, int y, int w, int h, uint32_t* dst) const {
+    getImage(pixels_.empty() ? nullptr : pixels_.data(), width_, height_, x, y, w, h, dst);
+}
+
+void X11Framebuffer::getImage(const uint32_t* src, int srcW, int srcH,
+                               int x, int y, int w, int h, uint32_t* dst) {
     if (w <= 0 || h <= 0) return;
 
-    bool fullyCovered = (x >= 0 && y >= 0 && x + w <= width_ && y + h <= height_);
-    if (fullyCovered && !pixels_.empty()) {
-        for (int row = 0; row < h; row++) {
-            memcpy(dst + row * w, pixels_.data() + (y + row) * width_ + x, w * 4);
-        }
-    } else {
-        // Partial coverage: zero first, then copy overlapping region
+    int c0 = src ? std::max(0, -x) : 0, c1 = src ? std::min(w, srcW - x) : 0;
+    int r0 = src ? std::max(0, -y) : 0, r1 = src ? std::min(h, srcH - y) : 0;
+    if (c0 >= c1 || r0 >= r1) {
         memset(dst, 0, (size_t)w * h * 4);
-        if (!pixels_.empty()) {
-            int startRow = std::max(0, -y);
-            int endRow = std::min(h, height_ - y);
-            int startCol = std::max(0, -x);
-            int endCol = std::min(w, width_ - x);
-            if (startRow < endRow && startCol < endCol) {
-                int copyW = endCol - startCol;
-                for (int row = startRow; row < endRow; row++) {
-                    memcpy(dst + row * w + startCol,
-                           pixels_.data() + (y + row) * width_ + (x + startCol),
-                           copyW * 4);
-                }
-            }
-        }
+        return;
+    }
+    // Zero only what falls outside the source
+    if (r0 > 0) memset(dst, 0, (size_t)r0 * w * 4);
+    if (r1 < h) memset(dst + (size_t)r1 * w, 0, (size_t)(h - r1) * w * 4);
+    for (int row = r0; row < r1; row++) {
+        uint32_t* dstRow = dst + (size_t)row * w;
+        if (c0 > 0) memset(dstRow, 0, (size_t)c0 * 4);
+        memcpy(dstRow + c0, src + (size_t)(y + row) * srcW + (x + c0), (size_t)(c1 - c0) * 4);
+        if (c1 < w) memset(dstRow + c1, 0, (size_t)(w - c1) * 4);
+    }
+}
+
+void X11Framebuffer::fillRect(int x, int y, int w, int h, uint32_t pixel) {
+    static const X11ClipRegion kNoClip;
+    if (pixels_.empty()) return;
+    fillRect(pixels_.data(), width_, height_, x, y, w, h, pixel, kNoClip);
+}
+
+void X11Framebuffer::fillRect(uint32_t* dst, int dstW, int dstH, int x, int y, int w, int h,
+                               uint32_t pixel, const X11ClipRegion& clip) {
+    if (!dst || w <= 0 || h <= 0) return;
+    int x1 = std::max(x, 0), x2 = std::min(x + w, dstW);
+    int y1 = std::max(y, 0), y2 = std::min(y + h, dstH);
+    if (x1 >= x2 || y1 >= y2) return;
+
+    static thread_local std::vector<blit::Span> spans;
+    int bandEnd = y1;
+    for (int row = y1; row < y2; row++) {
+        if (row >= bandEnd) clip.visibleSpans(row, x1, x2, spans, bandEnd);
+        uint32_t* dstRow = dst + (size_t)row * dstW;
+        for (const auto& sp : spans) blit::fillRow(dstRow + sp.x1, pixel, sp.x2 - sp.x1);
     }
 }
 
@@ -131,14 +143,24 @@ void X11Framebuffer::copyArea(const uint32_t* src, int srcW, int srcH, int srcX,
                                uint32_t* dst, int dstW, int dstH, int dstX, int dstY,
                                int w, int h) {
     if (!src || !dst || w <= 0 || h <= 0) return;
-    for (int row = 0; row < h; row++) {
-        int sy = srcY + row, dy = dstY + row;
-        if (sy < 0 || sy >= srcH || dy < 0 || dy >= dstH) continue;
-        for (int col = 0; col < w; col++) {
-            int sx = srcX + col, dx = dstX + col;
-            if (sx < 0 || sx >= srcW || dx < 0 || dx >= dstW) continue;
-            dst[dy * dstW + dx] = src[sy * srcW + sx];
-        }
+
+    // Offsets [c0, c1) x [r0, r1) valid in both source and destination
+    int c0 = std::max({0, -srcX, -dstX});
+    int c1 = std::min({w, srcW - srcX, dstW - dstX});
+    int r0 = std::max({0, -srcY, -dstY});
+    int r1 = std::min({h, srcH - srcY, dstH - dstY});
+    if (c0 >= c1 || r0 >= r1) return;
+
+    size_t bytes = (size_t)(c1 - c0) * 4;
+    auto rowCopy = [&](int row) {
+        memmove(dst + (size_t)(dstY + row) * dstW + dstX + c0,
+                src + (size_t)(srcY + row) * srcW + srcX + c0, bytes);
+    };
+    // Scrolling down within one buffer: walk bottom-up so source rows are read first
+    if (src == dst && dstY > srcY) {
+        for (int row = r1 - 1; row >= r0; row--) rowCopy(row);
+    } else {
+        for (int row = r0; row < r1; row++) rowCopy(row);
     }
 }
 
@@ -23,13 +23,11 @@
 #include <cstddef>
 #include <cstring>
 #include <vector>
+#include "X11Blit.h"
+#include "X11ClipRegion.h"
 
 namespace guitarrackcraft {
 
-struct ClipRect {
-    int x1, y1, x2, y2;
-};
-
 class X11Framebuffer {
 public:
     void resize(int w, int h, uint32_t fillColor = 0xFF302020);
@@ -53,8 +51,27 @@ public:
     void getImage(int x, int y, int w, int h,
                   uint32_t* dst) const;
 
+    // Raw-buffer versions of the above, shared with the server's pixmap/window paths.
+    // Clipping (bounds and childClip) is resolved to per-row spans before any pixels move.
+    static void putImage(uint32_t* dst, int dstW, int dstH, int x, int y, int w, int h,
+                         const uint8_t* pixelData, size_t pixelDataLen,
+                         bool msbFirst, const std::vector<ClipRect>& childClip);
+    // Same, clipped against a window's cached occlusion region.
+    static void putImage(uint32_t* dst, int dstW, int dstH, int x, int y, int w, int h,
+                         const uint8_t* pixelData, size_t pixelDataLen,
+                         bool msbFirst, const X11ClipRegion& clip);
+    static void getImage(const uint32_t* src, int srcW, int srcH,
+                         int x, int y, int w, int h, uint32_t* dst);
+
+    // Solid fill of a w*h rect (PolyFillRectangle), clipped to bounds and against the
+    // occlusion region. pixel is in stored format.
+    void fillRect(int x, int y, int w, int h, uint32_t pixel);
+    static void fillRect(uint32_t* dst, int dstW, int dstH, int x, int y, int w, int h,
+                         uint32_t pixel, const X11ClipRegion& clip);
+
     // CopyArea: copy a w*h rectangle within this framebuffer (or between two buffers).
-    // Static version operates on raw pointers for flexibility.
+    // Static version operates on raw pointers for flexibility. src and dst may be the
+    // same buffer with overlapping rectangles; the result is as if copied via a temporary.
     static void copyArea(const uint32_t* src, int srcW, int srcH, int srcX, int srcY,
                          uint32_t* dst, int dstW, int dstH, int dstX, int dstY,
                          int w, int h);
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "X11GCStore.h"
+
+namespace guitarrackcraft {
+
+void X11GCStore::create(uint32_t gc, uint32_t valueMask, const uint32_t* values, size_t count) {
+    gcs_[gc] = GCState{};
+    change(gc, valueMask, values, count);
+}
+
+void X11GCStore::change(uint32_t gc, uint32_t valueMask, const uint32_t* values, size_t count) {
+    auto it = gcs_.find(gc);
+    if (it == gcs_.end()) return;
+    GCState& s = it->second;
+    size_t idx = 0;
+    for (int bit = 0; bit < kValueBits && idx < count; bit++) {
+        uint32_t m = 1u << bit;
+        if (!(valueMask & m)) continue;
+        uint32_t v = values[idx++];
+        switch (m) {
+            case kFunction: s.function = (uint8_t)v; break;
+            case kPlaneMask: s.planeMask = v; break;
+            case kForeground: s.foreground = v; break;
+            case kBackground: s.background = v; break;
+            case kFillStyle: s.fillStyle = (uint8_t)v; break;
+            case kClipXOrigin: s.clipX = (int)(int16_t)v; break;
+            case kClipYOrigin: s.clipY = (int)(int16_t)v; break;
+            case kClipMask:
+                s.clipMask = v;
+                s.clipToRects = false;
+                s.clipRects.clear();
+                break;
+            default: break;
+        }
+    }
+}
+
+void X11GCStore::copy(uint32_t src, uint32_t dst, uint32_t valueMask) {
+    auto si = gcs_.find(src);
+    auto di = gcs_.find(dst);
+    if (si == gcs_.end() || di == gcs_.end()) return;
+    const GCState& s = si->second;
+    GCState& d = di->second;
+    if (valueMask & kFunction) d.function = s.function;
+    if (valueMask & kPlaneMask) d.planeMask = s.planeMask;
+    if (valueMask & kForeground) d.foreground = s.foreground;
+    if (valueMask & kBackground) d.background = s.background;
+    if (valueMask & kFillStyle) d.fillStyle = s.fillStyle;
+    if (valueMask & kClipXOrigin) d.clipX = s.clipX;
+    if (valueMask & kClipYOrigin) d.clipY = s.clipY;
+    if (valueMask & kClipMask) {
+        d.clipMask = s.clipMask;
+        d.clipToRects = s.clipToRects;
+        d.clipRects = s.clipRects;
+    }
+}
+
+void X11GCStore::setClipRectangles(uint32_t gc, int xOrigin, int yOrigin, std::vector<ClipRect> rects) {
+    auto it = gcs_.find(gc);
+    if (it == gcs_.end()) return;
+    it->second.clipX = xOrigin;
+    it->second.clipY = yOrigin;
+    it->second.clipMask = 0;
+    it->second.clipToRects = true;
+    it->second.clipRects = std::move(rects);
+}
+
+void X11GCStore::destroy(uint32_t gc) {
+    gcs_.erase(gc);
+}
+
+const GCState* X11GCStore::get(uint32_t gc) const {
+    auto it = gcs_.find(gc);
+    return it != gcs_.end() ? &it->second : nullptr;
+}
+
+bool X11GCStore::solidFill(uint32_t gc, uint32_t& pixel) const {
+    const GCState* s = get(gc);
+    if (!s) return false;
+    if (s->function != 3 /* GXcopy */ || s->fillStyle != 0 /* FillSolid */) return false;
+    if ((s->planeMask & 0x00FFFFFFu) != 0x00FFFFFFu) return false;
+    if (s->clipMask != 0 && !s->clipToRects) return false;
+    pixel = s->foreground | 0xFF000000u;
+    return true;
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "X11Blit.h"
+
+namespace guitarrackcraft {
+
+/**
+ * The parts of a graphics context the server renders with. Everything else in a GC
+ * (line attributes, fonts, dashes, ...) is accepted and ignored.
+ */
+struct GCState {
+    uint8_t function = 3;           // GXcopy
+    uint32_t planeMask = 0xFFFFFFFFu;
+    uint32_t foreground = 0;
+    uint32_t background = 1;
+    uint8_t fillStyle = 0;          // FillSolid
+    int clipX = 0, clipY = 0;       // clip origin
+    uint32_t clipMask = 0;          // None, or a pixmap (which we cannot honour)
+    bool clipToRects = false;       // set by SetClipRectangles
+    std::vector<ClipRect> clipRects;  // relative to the clip origin
+};
+
+/** GCs of the current client, keyed by GC id. Server thread only. */
+class X11GCStore {
+public:
+    // CreateGC/ChangeGC value-mask bits the store tracks
+    static constexpr uint32_t kFunction = 1u << 0;
+    static constexpr uint32_t kPlaneMask = 1u << 1;
+    static constexpr uint32_t kForeground = 1u << 2;
+    static constexpr uint32_t kBackground = 1u << 3;
+    static constexpr uint32_t kFillStyle = 1u << 8;
+    static constexpr uint32_t kClipXOrigin = 1u << 17;
+    static constexpr uint32_t kClipYOrigin = 1u << 18;
+    static constexpr uint32_t kClipMask = 1u << 19;
+    static constexpr int kValueBits = 23;
+
+    /** values holds one entry per set bit of valueMask, lowest bit first (the wire list). */
+    void create(uint32_t gc, uint32_t valueMask, const uint32_t* values, size_t count);
+    void change(uint32_t gc, uint32_t valueMask, const uint32_t* values, size_t count);
+    void copy(uint32_t src, uint32_t dst, uint32_t valueMask);
+    void setClipRectangles(uint32_t gc, int xOrigin, int yOrigin, std::vector<ClipRect> rects);
+    void destroy(uint32_t gc);
+    const GCState* get(uint32_t gc) const;
+    size_t size() const { return gcs_.size(); }
+    void clear() { gcs_.clear(); }
+
+    /**
+     * True when a fill with this GC is a plain opaque store the server can render
+     * exactly (GXcopy, all planes, FillSolid, no clip pixmap); pixel receives the
+     * foreground in stored framebuffer format, alpha forced to 0xFF.
+     */
+    bool solidFill(uint32_t gc, uint32_t& pixel) const;
+
+private:
+    std::unordered_map<uint32_t, GCState> gcs_;
+};
+
+} // namespace guitarrackcraft
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "X11GlxRenderBatch.h"
+#include <algorithm>
+#include <cstring>
+
+namespace guitarrackcraft {
+
+X11GlxRenderBatch::X11GlxRenderBatch() : buffer_(kInitialBytes) {
+    commands_.reserve(1024);
+}
+
+bool X11GlxRenderBatch::addRender(const uint8_t* data, size_t len, const X11ByteOrder& order) {
+    size_t off = 0;
+    while (off + 4 <= len) {
+        /* Command header: length (bytes, header included, multiple of 4), opcode */
+        size_t cmdLen = order.read16(data, (int)off);
+        uint32_t opcode = order.read16(data, (int)off + 2);
+        if (cmdLen < 4 || (cmdLen & 3) || off + cmdLen > len) {
+            stats_.malformed++;
+            return false;
+        }
+        if (!append(opcode, data + off + 4, cmdLen - 4, order)) return false;
+        off += cmdLen;
+    }
+    return true;
+}
+
+bool X11GlxRenderBatch::addRenderLargePart(uint16_t number, uint16_t total, const uint8_t* data,
+                                           size_t len, const X11ByteOrder& order) {
+    if (number == 1) {
+        large_.clear();
+        largeNext_ = 1;
+    }
+    if (number != largeNext_ || number > total || large_.size() + len > kMaxBytes) {
+        large_.clear();
+        largeNext_ = 0;
+        stats_.malformed++;
+        return false;
+    }
+    large_.insert(large_.end(), data, data + len);
+    if (number < total) {
+        largeNext_++;
+        return true;
+    }
+    largeNext_ = 0;
+    /* Large command header: length (4 bytes), opcode (4 bytes) */
+    if (large_.size() < 8) {
+        stats_.malformed++;
+        return false;
+    }
+    uint32_t cmdLen = order.read32(large_.data(), 0);
+    uint32_t opcode = order.read32(large_.data(), 4);
+    size_t size = cmdLen >= 8 && cmdLen - 8 <= large_.size() - 8 ? cmdLen - 8 : large_.size() - 8;
+    return append(opcode, large_.data() + 8, size, order);
+}
+
+bool X11GlxRenderBatch::append(uint32_t opcode, const uint8_t* payload, size_t size,
+                               const X11ByteOrder& order) {
+    if (redundant(opcode, payload, size, order)) {
+        stats_.skipped++;
+        return true;
+    }
+    if (used_ + size > kMaxBytes) {
+        stats_.malformed++;
+        return false;
+    }
+    if (used_ + size > buffer_.size()) {
+        buffer_.resize(std::max(buffer_.size() * 2, used_ + size));
+    }
+    if (size) memcpy(buffer_.data() + used_, payload, size);
+    commands_.push_back({opcode, (uint32_t)used_, (uint32_t)size});
+    used_ += size;
+    stats_.commands++;
+    stats_.bytes += size;
+    return true;
+}
+
+bool X11GlxRenderBatch::redundant(uint32_t opcode, const uint8_t* payload, size_t size,
+                                  const X11ByteOrder& order) {
+    switch (opcode) {
+        case kRopCallList:
+        case kRopCallLists:
+        case kRopPopAttrib:
+            invalidateState();  // may change any of the cached state
+            return false;
+        case kRopBindTexture: {
+            if (size < 8) return false;
+            uint32_t target = order.read32(payload, 0), texture = order.read32(payload, 4);
+            auto it = boundTexture_.find(target);
+            if (it != boundTexture_.end() && it->second == texture) return true;
+            boundTexture_[target] = texture;
+            return false;
+        }
+        case kRopEnable:
+        case kRopDisable: {
+            if (size < 4) return false;
+            bool on = opcode == kRopEnable;
+            auto it = enabled_.find(order.read32(payload, 0));
+            if (it != enabled_.end() && it->second == on) return true;
+            enabled_[order.read32(payload, 0)] = on;
+            return false;
+        }
+        case kRopBlendFunc: {
+            if (size < 8) return false;
+            uint32_t src = order.read32(payload, 0), dst = order.read32(payload, 4);
+            if (blendKnown_ && src == blendSrc_ && dst == blendDst_) return true;
+            blendSrc_ = src;
+            blendDst_ = dst;
+            blendKnown_ = true;
+            return false;
+        }
+        case kRopViewport: {
+            if (size < 16) return false;
+            int32_t v[4];
+            for (int i = 0; i < 4; ++i) v[i] = (int32_t)order.read32(payload, i * 4);
+            if (viewportKnown_ && memcmp(v, viewport_, sizeof(v)) == 0) return true;
+            memcpy(viewport_, v, sizeof(v));
+            viewportKnown_ = true;
+            return false;
+        }
+        default:
+            return false;
+    }
+}
+
+void X11GlxRenderBatch::clear() {
+    used_ = 0;
+    commands_.clear();
+    stats_ = Stats{};
+}
+
+void X11GlxRenderBatch::resetState() {
+    clear();
+    large_.clear();
+    largeNext_ = 0;
+    invalidateState();
+}
+
+void X11GlxRenderBatch::invalidateState() {
+    boundTexture_.clear();
+    enabled_.clear();
+    blendKnown_ = false;
+    viewportKnown_ = false;
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "X11ByteOrder.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * GLX indirect rendering commands of one frame, decoded into a preallocated buffer.
+ * glXRender requests are split into their commands as a whole; glXRenderLarge parts
+ * are reassembled in place and become one command when the last part arrives. State
+ * commands that repeat what the context already has (texture binds, enables, blend
+ * function, viewport) are dropped at decode time, with the cached state kept across
+ * frames until the context changes or a command that can restore state arrives. replay() then walks the frame in one pass.
+ *
+ * Payloads are stored as received (client byte order). Server thread only.
+ */
+class X11GlxRenderBatch {
+public:
+    static constexpr size_t kInitialBytes = 256 * 1024;
+    static constexpr size_t kMaxBytes = 16 * 1024 * 1024;  // a frame larger than this is dropped
+
+    /** GLX render opcodes with cached state (glxproto.h X_GLrop_*). */
+    enum : uint32_t {
+        kRopCallList = 1,
+        kRopCallLists = 2,
+        kRopPopAttrib = 141,
+        kRopViewport = 191,
+        kRopBlendFunc = 160,
+        kRopDisable = 138,
+        kRopEnable = 139,
+        kRopBindTexture = 4117,
+    };
+
+    struct Command {
+        uint32_t opcode;
+        uint32_t offset;  // payload offset in the batch buffer
+        uint32_t size;    // payload bytes (without the command header)
+    };
+
+    struct Stats {
+        size_t commands = 0;   // kept
+        size_t skipped = 0;    // redundant state commands dropped
+        size_t bytes = 0;      // payload bytes kept
+        size_t malformed = 0;  // requests or parts rejected
+    };
+
+    X11GlxRenderBatch();
+
+    /** Decode the command stream of a glXRender request (after the context tag). False if
+     *  malformed; commands before the bad one are kept. */
+    bool addRender(const uint8_t* data, size_t len, const X11ByteOrder& order);
+
+    /** One glXRenderLarge part (request_number numbered from 1 of total). */
+    bool addRenderLargePart(uint16_t number, uint16_t total, const uint8_t* data, size_t len,
+                            const X11ByteOrder& order);
+
+    /** Call fn(opcode, payload, size) for each command of the frame, in order. */
+    template <typename Fn>
+    void replay(Fn&& fn) const {
+        for (const Command& c : commands_) fn(c.opcode, buffer_.data() + c.offset, c.size);
+    }
+
+    const std::vector<Command>& commands() const { return commands_; }
+    const Stats& stats() const { return stats_; }
+
+    /** Start the next frame; keeps buffer capacity and the cached state. */
+    void clear();
+    /** The client switched or destroyed its context: forget cached state as well. */
+    void resetState();
+    /** A command outside the render stream (a glXSingle or vendor request such as
+     *  glDeleteTextures) may have changed GL state: stop trusting the cache. */
+    void invalidateState();
+
+private:
+    bool append(uint32_t opcode, const uint8_t* payload, size_t size, const X11ByteOrder& order);
+    bool redundant(uint32_t opcode, const uint8_t* payload, size_t size, const X11ByteOrder& order);
+
+    std::vector<uint8_t> buffer_;        // payloads of the frame
+    size_t used_ = 0;
+    std::vector<Command> commands_;
+    std::vector<uint8_t> large_;         // glXRenderLarge command being reassembled
+    uint16_t largeNext_ = 0;             // next expected part, 0 when none in progress
+    std::unordered_map<uint32_t, uint32_t> boundTexture_;  // target -> texture
+    std::unordered_map<uint32_t, bool> enabled_;           // cap -> state
+    uint32_t blendSrc_ = 0, blendDst_ = 0;
+    bool blendKnown_ = false;
+    int32_t viewport_[4] = {};
+    bool viewportKnown_ = false;
+    Stats stats_;
+};
+
+} // namespace guitarrackcraft
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "X11HardwareBufferStorage.h"
+#include "X11Log.h"
+#include <cstring>
+
+#define LOG_TAG "X11HardwareBuffer"
+#define LOGI(...) X11_LOGI(LOG_TAG, __VA_ARGS__)
+#define LOGE(...) X11_LOGE(LOG_TAG, __VA_ARGS__)
+
+namespace guitarrackcraft {
+
+namespace {
+
+constexpr uint64_t kUsage = AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN |
+                            AHARDWAREBUFFER_USAGE_GPU_SAMPLED_IMAGE;
+
+bool hasExtension(const char* list, const char* name) {
+    if (!list) return false;
+    size_t n = strlen(name);
+    for (const char* p = strstr(list, name); p; p = strstr(p + n, name)) {
+        if ((p == list || p[-1] == ' ') && (p[n] == ' ' || p[n] == '\0')) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+bool X11HardwareBufferStorage::isSupported(EGLDisplay display) {
+    const char* ext = eglQueryString(display, EGL_EXTENSIONS);
+    return hasExtension(ext, "EGL_KHR_image_base") &&
+           hasExtension(ext, "EGL_ANDROID_image_native_buffer") &&
+           hasExtension(ext, "EGL_ANDROID_get_native_client_buffer") &&
+           eglGetProcAddress("glEGLImageTargetTexture2DOES") != nullptr;
+}
+
+X11HardwareBufferStorage::X11HardwareBufferStorage(EGLDisplay display) : display_(display) {
+    getNativeClientBuffer_ = reinterpret_cast<PFNEGLGETNATIVECLIENTBUFFERANDROIDPROC>(
+        eglGetProcAddress("eglGetNativeClientBufferANDROID"));
+    createImage_ = reinterpret_cast<PFNEGLCREATEIMAGEKHRPROC>(eglGetProcAddress("eglCreateImageKHR"));
+    destroyImage_ = reinterpret_cast<PFNEGLDESTROYIMAGEKHRPROC>(eglGetProcAddress("eglDestroyImageKHR"));
+    imageTargetTexture2D_ = reinterpret_cast<PFNGLEGLIMAGETARGETTEXTURE2DOESPROC>(
+        eglGetProcAddress("glEGLImageTargetTexture2DOES"));
+}
+
+X11HardwareBufferStorage::~X11HardwareBufferStorage() {
+    /* GL objects are intentionally left alone: the render thread skips EGL teardown
+     * (see X11NativeDisplay) and they go with the leaked context. EGLImages hold
+     * their own buffer references, so dropping ours here is safe. */
+    for (auto& s : slots_) {
+        if (s.buffer) AHardwareBuffer_release(s.buffer);
+        if (s.bound) AHardwareBuffer_release(s.bound);
+    }
+}
+
+bool X11HardwareBufferStorage::allocate(int slot, int w, int h) {
+    if (slot < 0 || slot >= 3 || w <= 0 || h <= 0) return false;
+    Slot& s = slots_[slot];
+    AHardwareBuffer_Desc desc{};
+    desc.width = (uint32_t)w;
+    desc.height = (uint32_t)h;
+    desc.layers = 1;
+    desc.format = AHARDWAREBUFFER_FORMAT_R8G8B8A8_UNORM;
+    desc.usage = kUsage;
+    AHardwareBuffer* buffer = nullptr;
+    if (AHardwareBuffer_allocate(&desc, &buffer) != 0 || !buffer) {
+        LOGE("AHardwareBuffer_allocate %dx%d failed", w, h);
+        return false;
+    }
+    if (s.buffer) AHardwareBuffer_release(s.buffer);
+    s.buffer = buffer;
+    ++s.generation;
+    return true;
+}
+
+uint32_t* X11HardwareBufferStorage::lock(int slot, int& stride) {
+    if (slot < 0 || slot >= 3 || !slots_[slot].buffer) return nullptr;
+    AHardwareBuffer* buffer = slots_[slot].buffer;
+    AHardwareBuffer_Desc desc{};
+    AHardwareBuffer_describe(buffer, &desc);
+    void* addr = nullptr;
+    /* The slot reaches the producer only after the render thread has moved on to a
+     * newer frame, and gralloc orders the CPU lock after earlier GPU reads. */
+    if (AHardwareBuffer_lock(buffer, AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN, -1, nullptr, &addr) != 0) {
+        LOGE("AHardwareBuffer_lock slot %d failed", slot);
+        return nullptr;
+    }
+    stride = (int)desc.stride;
+    return static_cast<uint32_t*>(addr);
+}
+
+void X11HardwareBufferStorage::unlock(int slot) {
+    if (slot < 0 || slot >= 3 || !slots_[slot].buffer) return;
+    AHardwareBuffer_unlock(slots_[slot].buffer, nullptr);
+}
+
+bool X11HardwareBufferStorage::bindTexture(int slot) {
+    if (slot < 0 || slot >= 3) return false;
+    Slot& s = slots_[slot];
+    if (s.image == EGL_NO_IMAGE_KHR || s.boundGeneration != s.generation) {
+        if (!importSlot(s)) return false;
+    }
+    glBindTexture(GL_TEXTURE_2D, s.texture);
+    return true;
+}
+
+bool X11HardwareBufferStorage::importSlot(Slot& s) {
+    releaseImport(s);
+    if (!s.buffer || !getNativeClientBuffer_ || !createImage_ || !imageTargetTexture2D_) return false;
+
+    EGLClientBuffer clientBuffer = getNativeClientBuffer_(s.buffer);
+    const EGLint attrs[] = { EGL_IMAGE_PRESERVED_KHR, EGL_TRUE, EGL_NONE };
+    EGLImageKHR image = createImage_(display_, EGL_NO_CONTEXT, EGL_NATIVE_BUFFER_ANDROID,
+                                     clientBuffer, attrs);
+    if (image == EGL_NO_IMAGE_KHR) {
+        LOGE("eglCreateImageKHR failed: 0x%x", eglGetError());
+        return false;
+    }
+    if (s.texture == 0) glGenTextures(1, &s.texture);
+    glBindTexture(GL_TEXTURE_2D, s.texture);
+    while (glGetError() != GL_NO_ERROR) {}
+    imageTargetTexture2D_(GL_TEXTURE_2D, static_cast<GLeglImageOES>(image));
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+        LOGE("glEGLImageTargetTexture2DOES failed: 0x%x", err);
+        destroyImage_(display_, image);
+        return false;
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    AHardwareBuffer_acquire(s.buffer);
+    s.bound = s.buffer;
+    s.boundGeneration = s.generation;
+    s.image = image;
+    LOGI("imported AHardwareBuffer generation %llu", (unsigned long long)s.generation);
+    return true;
+}
+
+void X11HardwareBufferStorage::releaseImport(Slot& s) {
+    if (s.image != EGL_NO_IMAGE_KHR && destroyImage_) destroyImage_(display_, s.image);
+    s.image = EGL_NO_IMAGE_KHR;
+    if (s.bound) AHardwareBuffer_release(s.bound);
+    s.bound = nullptr;
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "X11TripleBuffer.h"
+#include <android/hardware_buffer.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include <atomic>
+#include <cstdint>
+
+namespace guitarrackcraft {
+
+/**
+ * Triple-buffer slots backed by CPU-writable, GPU-sampleable AHardwareBuffers.
+ * The server thread copies damage straight into the buffer; the render thread
+ * samples it through an EGLImage-bound texture, so no glTexSubImage2D upload
+ * is needed. Pixels stay in X11 wire order (BGRA) in an RGBA8 buffer and the
+ * display shader does the swizzle, exactly as for the uploaded texture.
+ *
+ * Producer methods (X11FrameStorage) run on the server thread; bindTexture()
+ * runs on the render thread with the shared render context current. Each slot's
+ * buffer changes hands through the triple buffer, and the render thread holds
+ * its own reference to the buffer it imported, so a producer reallocation never
+ * frees memory the GPU may still sample.
+ */
+class X11HardwareBufferStorage : public X11FrameStorage {
+public:
+    /** True if display can import AHardwareBuffers (EGL_ANDROID_get_native_client_buffer etc.). */
+    static bool isSupported(EGLDisplay display);
+
+    explicit X11HardwareBufferStorage(EGLDisplay display);
+    ~X11HardwareBufferStorage() override;
+
+    X11HardwareBufferStorage(const X11HardwareBufferStorage&) = delete;
+    X11HardwareBufferStorage& operator=(const X11HardwareBufferStorage&) = delete;
+
+    bool allocate(int slot, int w, int h) override;
+    uint32_t* lock(int slot, int& stride) override;
+    void unlock(int slot) override;
+
+    /**
+     * Render thread: bind slot's buffer to GL_TEXTURE_2D on the active unit,
+     * importing it as an EGLImage when the producer reallocated it. Returns false
+     * if the import failed.
+     */
+    bool bindTexture(int slot);
+
+private:
+    struct Slot {
+        AHardwareBuffer* buffer = nullptr;  // producer side
+        uint64_t generation = 0;            // bumped on every allocate()
+        AHardwareBuffer* bound = nullptr;   // render side: our reference to the imported buffer
+        uint64_t boundGeneration = 0;
+        EGLImageKHR image = EGL_NO_IMAGE_KHR;
+        GLuint texture = 0;
+    };
+
+    bool importSlot(Slot& s);
+    void releaseImport(Slot& s);
+
+    EGLDisplay display_;
+    Slot slots_[3];
+    PFNEGLGETNATIVECLIENTBUFFERANDROIDPROC getNativeClientBuffer_ = nullptr;
+    PFNEGLCREATEIMAGEKHRPROC createImage_ = nullptr;
+    PFNEGLDESTROYIMAGEKHRPROC destroyImage_ = nullptr;
+    PFNGLEGLIMAGETARGETTEXTURE2DOESPROC imageTargetTexture2D_ = nullptr;
+};
+
+} // namespace guitarrackcraft
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "X11MotionCoalescer.h"
+#include <algorithm>
+
+namespace guitarrackcraft {
+
+void X11MotionCoalescer::move(int x, int y, int64_t tNs) {
+    history_[historyHead_] = {x, y, tNs};
+    historyHead_ = (historyHead_ + 1) % kHistorySize;
+    historyCount_ = std::min(historyCount_ + 1, kHistorySize);
+    pending_ = true;
+}
+
+void X11MotionCoalescer::predicted(int& x, int& y) const {
+    const Sample& last = history_[(historyHead_ + kHistorySize - 1) % kHistorySize];
+    x = last.x;
+    y = last.y;
+    if (!predict_ || historyCount_ < 3) return;
+    // Velocity from the oldest sample still inside the history window to the newest
+    const Sample* first = nullptr;
+    for (int i = historyCount_; i >= 2; --i) {
+        const Sample& s = history_[(historyHead_ + kHistorySize - i) % kHistorySize];
+        if (last.tNs - s.tNs <= kHistoryNs) {
+            first = &s;
+            break;
+        }
+    }
+    if (!first) return;
+    const int64_t span = last.tNs - first->tNs;
+    if (span < kMinSpanNs) return;
+    const double ahead = static_cast<double>(kPredictNs) / static_cast<double>(span);
+    const int dx = static_cast<int>((last.x - first->x) * ahead);
+    const int dy = static_cast<int>((last.y - first->y) * ahead);
+    x += std::clamp(dx, -kMaxPredictPx, kMaxPredictPx);
+    y += std::clamp(dy, -kMaxPredictPx, kMaxPredictPx);
+}
+
+bool X11MotionCoalescer::take(uint16_t lastSeq, bool clientIdle, int64_t nowNs, int& x, int& y) {
+    if (historyCount_ == 0) return false;
+    const Sample& last = history_[(historyHead_ + kHistorySize - 1) % kHistorySize];
+    const bool settleDue = !pending_ && settle_ && nowNs - last.tNs >= kSettleNs;
+    if (!pending_ && !settleDue) return false;
+    if (inFlight_ && !(clientIdle && lastSeq != sentSeq_) && nowNs - sentNs_ < kMaxHoldNs) {
+        return false;
+    }
+    if (settleDue) {
+        x = last.x;
+        y = last.y;
+        settle_ = false;
+    } else {
+        predicted(x, y);
+        settle_ = x != last.x || y != last.y;
+    }
+    pending_ = false;
+    inFlight_ = true;
+    sentSeq_ = lastSeq;
+    sentNs_ = nowNs;
+    return true;
+}
+
+bool X11MotionCoalescer::takeBeforeButton(int& x, int& y) {
+    const bool send = historyCount_ > 0 && (pending_ || settle_);
+    if (send) {
+        const Sample& last = history_[(historyHead_ + kHistorySize - 1) % kHistorySize];
+        x = last.x;
+        y = last.y;
+    }
+    reset();
+    return send;
+}
+
+int64_t X11MotionCoalescer::waitNs(int64_t nowNs) const {
+    if (historyCount_ == 0 || (!pending_ && !settle_)) return -1;
+    int64_t dueNs = nowNs;
+    if (!pending_) {
+        const Sample& last = history_[(historyHead_ + kHistorySize - 1) % kHistorySize];
+        dueNs = last.tNs + kSettleNs;
+    }
+    if (inFlight_) dueNs = std::max(dueNs, sentNs_ + kMaxHoldNs);
+    return std::max<int64_t>(dueNs - nowNs, 0);
+}
+
+void X11MotionCoalescer::reset() {
+    historyCount_ = 0;
+    historyHead_ = 0;
+    pending_ = false;
+    settle_ = false;
+    inFlight_ = false;
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace guitarrackcraft {
+
+/**
+ * Turns the touch move stream into MotionNotify events the client can keep up with. Moves
+ * are merged into one pending point; the next MotionNotify goes out only once the client
+ * has answered the previous one, i.e. it has processed requests since (the request
+ * sequence moved) and caught up with its socket, or after kMaxHoldNs for clients that do
+ * not redraw on motion. The point sent can be extrapolated kPredictNs ahead from the touch
+ * samples of the last kHistoryNs; once input stops the real point is sent to settle it.
+ * Button presses and releases bypass all of this, so the caller flushes with
+ * takeBeforeButton() first. Times are CLOCK_MONOTONIC nanoseconds; server thread only.
+ */
+class X11MotionCoalescer {
+public:
+    static constexpr int64_t kMaxHoldNs = 50000000LL;   // at least 20 Hz for any client
+    static constexpr int64_t kPredictNs = 8000000LL;    // half a 60 Hz frame
+    static constexpr int64_t kHistoryNs = 40000000LL;
+    static constexpr int64_t kMinSpanNs = 4000000LL;    // shorter history: no velocity
+    static constexpr int64_t kSettleNs = 30000000LL;
+    static constexpr int kMaxPredictPx = 24;
+    static constexpr int kHistorySize = 16;
+
+    explicit X11MotionCoalescer(bool predict = true) : predict_(predict) {}
+
+    /** A touch move sample at (x, y), taken at tNs. */
+    void move(int x, int y, int64_t tNs);
+
+    /**
+     * The motion to send at nowNs, if one is pending and allowed. lastSeq is the sequence
+     * of the last request processed; clientIdle is true when no complete request is
+     * buffered (the client has caught up).
+     */
+    bool take(uint16_t lastSeq, bool clientIdle, int64_t nowNs, int& x, int& y);
+
+    /** Before a button event: the last real point if a motion is still pending, so the
+     *  button lands where the finger is. Starts over either way. */
+    bool takeBeforeButton(int& x, int& y);
+
+    /** Nanoseconds until take() may return a motion without client activity; 0 if it may
+     *  now, -1 if nothing is pending. */
+    int64_t waitNs(int64_t nowNs) const;
+
+    void reset();
+
+private:
+    struct Sample {
+        int x, y;
+        int64_t tNs;
+    };
+
+    void predicted(int& x, int& y) const;
+
+    bool predict_;
+    Sample history_[kHistorySize]{};
+    int historyCount_ = 0;  // valid samples, newest at (historyHead_ - 1)
+    int historyHead_ = 0;
+    bool pending_ = false;  // a move arrived since the last motion sent
+    bool settle_ = false;   // the last motion sent was predicted, not the real point
+    bool inFlight_ = false;
+    uint16_t sentSeq_ = 0;
+    int64_t sentNs_ = 0;
+};
+
+} // namespace guitarrackcraft
@@ -24,11 +24,26 @@
 #include "X11WindowManager.h"
 #include "X11PixmapStore.h"
 #include "X11Framebuffer.h"
+#include "X11GCStore.h"
+#include "X11ReadbackCache.h"
+#include "X11GlxRenderBatch.h"
+#include "X11DamageRegion.h"
+#include "X11TripleBuffer.h"
+#include "X11FramePacer.h"
+#include "X11MotionCoalescer.h"
+#include "X11RenderHub.h"
+#include "X11AdaptiveScale.h"
+#include "X11HardwareBufferStorage.h"
+#include "X11ShmRegistry.h"
+#include "X11RequestReader.h"
 #include "X11ConnectionHandler.h"
 #include "X11EventBuilder.h"
 #include "X11Log.h"
 #include "../plugin/PluginUIGuard.h"
+#include "../utils/SystemTrace.h"
+#include "../utils/ThreadPolicy.h"
 #include "../utils/ThreadUtils.h"
+#include "../utils/ThermalStatus.h"
 #include <android/log.h>
 #include <android/native_window_jni.h>
 #include <EGL/egl.h>
@@ -41,15 +56,15 @@
 #include <arpa/inet.h>
 #include <poll.h>
 #include <sys/un.h>
+#include <sys/eventfd.h>
+#include <time.h>
 #include <chrono>
+#include <cmath>
 #include <cstring>
 #include <thread>
 #include <atomic>
 #include <future>
 #include <vector>
-#if defined(__aarch64__) || defined(__ARM_NEON)
-#include <arm_neon.h>
-#endif
 #include <unordered_map>
 #include <unordered_set>
 #include <cerrno>
@@ -62,37 +77,29 @@
 #define LOGE(...) X11_LOGE(LOG_TAG, __VA_ARGS__)
 #define LOGW(...) X11_LOGW(LOG_TAG, __VA_ARGS__)
 
-/* Swap R and B channels in an array of ARGB pixels using NEON SIMD.
- * Each pixel: swap byte 0 (B/R) with byte 2 (R/B), keep bytes 1 (G) and 3 (A). */
-static void swapRB_neon(const uint32_t* __restrict src, uint32_t* __restrict dst, size_t count) {
-#if defined(__aarch64__) || defined(__ARM_NEON)
-    size_t i = 0;
-    /* Process 4 pixels (16 bytes) at a time using byte-level table lookup */
-    for (; i + 4 <= count; i += 4) {
-        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
-        /* Rearrange bytes: for each pixel [B,G,R,A] → [R,G,B,A] (swap 0↔2) */
-        static const uint8_t tbl[16] = {2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15};
-        uint8x16_t idx = vld1q_u8(tbl);
-        uint8x16_t swapped = vqtbl1q_u8(v, idx);
-        vst1q_u8(reinterpret_cast<uint8_t*>(dst + i), swapped);
-    }
-    /* Handle remaining pixels */
-    for (; i < count; i++) {
-        uint32_t p = src[i];
-        dst[i] = (p & 0xFF00FF00u) | ((p & 0xFFu) << 16) | ((p >> 16) & 0xFFu);
-    }
-#else
-    for (size_t i = 0; i < count; i++) {
-        uint32_t p = src[i];
-        dst[i] = (p & 0xFF00FF00u) | ((p & 0xFFu) << 16) | ((p >> 16) & 0xFFu);
-    }
-#endif
-}
-
 namespace guitarrackcraft {
 
 static constexpr int kX11BasePort = 6000;
-static constexpr double kTouchFlushIntervalSec = 1.0 / 30.0;
+static constexpr size_t kMaxQueuedTouches = 64;
+
+// CLOCK_MONOTONIC nanoseconds, the time base of Choreographer frame times.
+static int64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Audio load feed for adaptive UI scale (see setX11LoadSource).
+static std::mutex g_loadSourceMutex;
+static std::function<float()> g_loadSource;
+
+static float sampleAudioLoad() {
+    std::lock_guard<std::mutex> lock(g_loadSourceMutex);
+    return g_loadSource ? g_loadSource() : 0.0f;
+}
+
+// Frame rate cap for every display (see setX11FrameRateCap); 0 = none.
+static std::atomic<double> g_frameRateCapHz{0.0};
 
 // Log up to 64 bytes as hex (16 per line) for debugging connection setup.
 static void logHex(const char* label, const uint8_t* data, size_t len) {
@@ -112,28 +119,45 @@ static void logHex(const char* label, const uint8_t* data, size_t len) {
 using namespace X11Op;
 using namespace X11Event;
 
-struct X11NativeDisplay::Impl {
+struct X11NativeDisplay::Impl : X11RenderClient {
+    Impl() : wakeFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
+        if (wakeFd < 0) LOGE("eventfd failed: %s (server loop falls back to polling)", strerror(errno));
+    }
+    ~Impl() override {
+        X11RenderHub::instance().remove(this);
+        if (wakeFd >= 0) close(wakeFd);
+    }
+
     ANativeWindow* window = nullptr;
     EGLDisplay eglDisplay = EGL_NO_DISPLAY;
     EGLSurface eglSurface = EGL_NO_SURFACE;
-    EGLContext eglContext = EGL_NO_CONTEXT;
+    EGLConfig eglConfig = nullptr;            // Config eglSurface was created with
+    EGLContext eglContext = EGL_NO_CONTEXT;   // X11RenderHub's shared context
     int width = 0;
     int height = 0;
     int displayNumber_ = 0;
     std::vector<uint32_t> framebuffer;  // ARGB (GL format) - main framebuffer for rendering
     // Framebuffer now stores X11 wire format (BGRA) directly — no separate shadow needed
-    std::vector<uint32_t> renderBuffer; // Staging buffer for render thread (triple buffering)
+    X11DamageRegion damage;             // framebuffer area written since the last publish (under bufferMutex)
+    X11TripleBuffer frames;             // published snapshots for the render thread (lock-free)
+    std::unique_ptr<X11HardwareBufferStorage> hwStorage;  // zero-copy slots, when EGL supports them
+    X11ShmSegmentTable shmSegments;     // MIT-SHM segments attached by the client (server thread only)
+    X11GCStore gcStore;                 // GCs of the current client (server thread only)
+    X11ReadbackCache readback;          // last window GetImage reply (writes noted under bufferMutex)
+    X11GlxRenderBatch glxBatch;         // GLX indirect commands of the current frame (server thread only)
+    int glxFrames = 0;                  // glXSwapBuffers since the last GLX stats line
+    size_t glxCommands = 0, glxSkipped = 0, glxBytes = 0;
+    std::chrono::steady_clock::time_point lastGlxLog = std::chrono::steady_clock::now();
     int serverFd = -1;
     int clientFd = -1;
+    int wakeFd = -1;  // eventfd: wakes the server loop for queued touches and teardown
     std::atomic<bool> running{false};
     bool useUnixSocket_ = false;
-    std::atomic<bool> renderThreadRunning{false};  // Separate flag for render thread to allow pause/resume
+    std::atomic<bool> renderThreadRunning{false};  // Drawing wanted (pause/resume without the server)
     std::thread serverThread;
-    std::thread renderThread;
     std::mutex bufferMutex;
     std::atomic<bool> dirty{false};
-    std::mutex dirtyMutex;                    // Protects dirty condition variable
-    std::condition_variable dirtyCv;          // Signals render thread when dirty changes
+    X11FramePacer pacer;                      // Which vsyncs to draw on (see X11FramePacer)
     std::atomic<bool> detachDeferred{false};  // Set when detach is deferred due to plugin creation
     // Graceful teardown state
     std::atomic<bool> closingGracefully{false};  // Set when graceful teardown initiated
@@ -148,17 +172,22 @@ struct X11NativeDisplay::Impl {
     std::condition_variable pluginUITaskCv;
     std::queue<std::function<void()>> pluginUITasks;
     std::atomic<bool> pluginUIRunning{false};
-    // Render thread exit synchronization
-    std::atomic<bool> renderThreadExited{false};
-    std::mutex renderExitMutex;
-    std::condition_variable renderExitCv;
-    GLuint program = 0;
-    GLuint texUniform = 0;
+    // Render hub membership: exited means X11RenderHub is not drawing this display
+    std::atomic<bool> renderThreadExited{true};
+    std::mutex renderExitMutex;               // Serializes start/stop of drawing
+    bool glInited = false;                    // fbTex/fbVbo exist in the shared context
+    int renderFrameCount = 0;
+    int swapCount = 0;
     GLuint fbTex = 0;    // persistent framebuffer texture (avoid per-frame alloc)
+    int fbTexW = 0, fbTexH = 0;  // allocated fbTex storage size (render thread only)
+    std::vector<DamageRect> renderDamage;  // acquired damage not yet uploaded to fbTex
+    bool renderFullUpload = true;          // next upload must push the whole front frame
+    std::vector<uint32_t> uploadScratch;   // packed rows for narrow sub-rect uploads
     GLuint fbVbo = 0;    // persistent vertex buffer
     X11ByteOrder byteOrder_{true};  // X11 byte order (replaces msbFirst_)
     // Convenience aliases: keep existing call sites working via delegation
     bool& msbFirst_ = byteOrder_.msbFirst;
+    X11RequestReader requestReader{byteOrder_, (size_t)kBigRequestsMaxLength * 4};  // server thread only
     std::atomic<bool> listening_{false};
     std::atomic<uint16_t> lastSeq_{0};  // last request sequence number, for event injection
     std::atomic<uint16_t> lastReplySeq_{0};  // sequence of last REPLY sent (not void requests)
@@ -182,6 +211,7 @@ struct X11NativeDisplay::Impl {
     struct QueuedTouch {
         int action; // 0=down, 1=up, 2=move
         int x, y;
+        int64_t timeNs;  // CLOCK_MONOTONIC time of the sample
     };
     std::mutex touchQueueMutex;
     std::vector<QueuedTouch> touchQueue;
@@ -189,6 +219,19 @@ struct X11NativeDisplay::Impl {
     int pluginWidth = 0;   // plugin's current window width (may be scaled)
     int pluginHeight = 0;  // plugin's current window height
     float uiScale = 1.0f;  // UI scale factor for plugin rendering (< 1.0 = smaller = faster)
+    /* Adaptive UI scale: the pluginUI thread samples load and steps adaptiveScale, the
+     * server thread applies the new size to the plugin window (applyPendingUIScale). */
+    std::atomic<bool> adaptiveScaleEnabled{false};
+    std::atomic<float> adaptiveFactor{1.0f};      // multiplies uiScale
+    std::atomic<bool> uiScaleChangePending{false};
+    X11AdaptiveScale adaptiveScale;               // pluginUI thread only
+    std::chrono::steady_clock::time_point lastScaleSample{};
+    int thermalStatus = -1;
+    int scaleSampleCount = 0;
+    static constexpr double kScaleSampleIntervalSec = 0.5;
+    static constexpr int kThermalEverySamples = 4;  // thermal status every 2 s
+
+    float effectiveUIScale() const { return uiScale * adaptiveFactor.load(std::memory_order_relaxed); }
 
     // Compute absolute position — delegates to windowManager_
     std::pair<int, int> getAbsolutePos(uint32_t wid) const {
@@ -201,140 +244,436 @@ struct X11NativeDisplay::Impl {
     void write16(uint8_t* p, int off, uint16_t val) const { byteOrder_.write16(p, off, val); }
     void write32(uint8_t* p, int off, uint32_t val) const { byteOrder_.write32(p, off, val); }
 
+    /* Per-display GL objects in the shared context; the blit program is the hub's */
     bool initGL() {
-        const char* vs = "attribute vec2 aPos; attribute vec2 aTex; varying vec2 vTex; void main() { gl_Position = vec4(aPos, 0, 1); vTex = aTex; }";
-        const char* fs = "precision mediump float; varying vec2 vTex; uniform sampler2D uTex; void main() { vec4 c = texture2D(uTex, vTex); gl_FragColor = vec4(c.b, c.g, c.r, 1.0); }";
-        GLuint vsId = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vsId, 1, &vs, nullptr);
-        glCompileShader(vsId);
-        GLuint fsId = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fsId, 1, &fs, nullptr);
-        glCompileShader(fsId);
-        program = glCreateProgram();
-        glAttachShader(program, vsId);
-        glAttachShader(program, fsId);
-        glLinkProgram(program);
-        glDeleteShader(vsId);
-        glDeleteShader(fsId);
-        texUniform = glGetUniformLocation(program, "uTex");
+        if (!X11RenderHub::instance().blitProgram().program) return false;
         glGenTextures(1, &fbTex);
+        fbTexW = fbTexH = 0;
+        renderFullUpload = true;
         glGenBuffers(1, &fbVbo);
         float verts[] = { -1,-1, 0,1,  1,-1, 1,1,  -1,1, 0,0,  1,1, 1,0 };
         glBindBuffer(GL_ARRAY_BUFFER, fbVbo);
         glBufferData(GL_ARRAY_BUFFER, sizeof(verts), verts, GL_STATIC_DRAW);
-        return program != 0;
+        return true;
     }
 
-    void renderLoop() {
-        LOGI("X11Debug: render thread STARTED display=%d tid=%ld", displayNumber_, getTid());
-        bool glInited = false;
-        int frameCount = 0;
+    /* Where drawing requests to a drawable land: the shared framebuffer for mapped windows
+     * (with the drawable's origin and occlusion region) or a pixmap's own storage. */
+    struct DrawTarget {
+        uint32_t* pixels = nullptr;
+        int w = 0, h = 0;
+        int originX = 0, originY = 0;
+        bool isWindow = false;  // framebuffer target: clip and report damage
+    };
 
-        while (renderThreadRunning) {
-            // Wait for dirty flag using condition variable (eliminates busy-waiting)
-            {
-                std::unique_lock<std::mutex> lock(dirtyMutex);
-                dirtyCv.wait(lock, [this] {
-                    return dirty.load() || !renderThreadRunning.load();
-                });
+    /* Resolve drawable for drawing; for windows, clip receives the occlusion region.
+     * writeRect (drawable coordinates), when given, is written in full by the caller,
+     * which lets a new pixmap skip its initial fill. Caller holds bufferMutex. */
+    DrawTarget drawTargetLocked(uint32_t drawable, X11ClipRegion& clip, const char* what, bool verbose,
+                                const ClipRect* writeRect = nullptr) {
+        DrawTarget t;
+        /* Check childWindows FIRST to avoid conflict with root window ID */
+        bool isWindow = false;
+        bool isTopLevel = false;
+        for (auto wid : childWindows) {
+            if (wid == drawable) { isWindow = true; break; }
+        }
+        if (!isWindow && drawable == kRootWindowId) {
+            isWindow = true;
+            isTopLevel = true;
+        }
+        if (isWindow && !childWindows.empty() && drawable == childWindows[0]) {
+            isTopLevel = true;
+        }
+
+        /* Skip drawing to unmapped (hidden) windows */
+        if (isWindow && !isTopLevel && windowManager_.isUnmapped(drawable)) {
+            if (verbose) LOGI("X11 %s SKIP unmapped wid=0x%x", what, drawable);
+            isWindow = false;  // suppress framebuffer write
+        }
+
+        /* For child windows, offset drawing coords by window's absolute position */
+        if (isWindow && !isTopLevel) {
+            auto absPos = getAbsolutePos(drawable);
+            t.originX = absPos.first;
+            t.originY = absPos.second;
+        }
+
+        /* Clip parent drawing against mapped children and higher siblings.
+         * On a real X11 server, child windows float above parents and higher
+         * siblings obscure lower ones. On our single-framebuffer server, we
+         * simulate this by skipping pixels inside the window's occlusion
+         * region, which the window manager caches until the tree changes.
+         * Copied out so the blit does not hold windowMapMutex. */
+        clip.clear();
+        if (isWindow) {
+            std::lock_guard<std::mutex> mapLock(windowMapMutex);
+            clip = windowManager_.clipRegion(drawable);
+        }
+
+        int fbw = pluginWidth > 0 ? pluginWidth : width;
+        int fbh = pluginHeight > 0 ? pluginHeight : height;
+        if (isWindow && framebuffer.size() == (size_t)fbw * fbh) {
+            t.pixels = framebuffer.data(); t.w = fbw; t.h = fbh;
+            t.isWindow = true;
+        } else {
+            auto* pm = writeRect
+                ? pixmapStore_.getForWrite(drawable, writeRect->x1, writeRect->y1,
+                                           writeRect->x2 - writeRect->x1, writeRect->y2 - writeRect->y1)
+                : pixmapStore_.get(drawable);
+            if (pm) {
+                t.pixels = pm->pixels.data();
+                t.w = pm->w; t.h = pm->h;
             }
+            t.originX = t.originY = 0;
+        }
+        return t;
+    }
 
-            if (!renderThreadRunning) break;
-            if (!dirty || eglSurface == EGL_NO_SURFACE) {
+    /* Framebuffer pixels in a rect were written (caller holds bufferMutex) */
+    void addDamageLocked(int x, int y, int w, int h) {
+        damage.add(x, y, w, h);
+        readback.noteWrite(x, y, w, h);
+    }
+
+    /* Framebuffer replaced or resized: everything is damaged, cached readback is stale */
+    void resetDamageLocked(int w, int h) {
+        damage.reset(w, h);
+        readback.invalidate();
+    }
+
+    /* Framebuffer changed under bufferMutex: hand it to the render thread */
+    void framebufferChangedLocked() {
+        publishFrameLocked();
+        dirty = true;
+        wakeRenderThread();
+    }
+
+    /* Blit a ZPixmap image (w*h, X11 wire format) into a window or pixmap at (x, y), with
+     * child/sibling clipping for windows. Shared by PutImage and MIT-SHM ShmPutImage. */
+    void drawImage(uint32_t drawable, int x, int y, int w, int h,
+                   const uint8_t* pixels, size_t pixelDataLen, bool verbose) {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        static thread_local X11ClipRegion childClip;
+        /* A complete image writes every pixel of its rect */
+        ClipRect written = {x, y, x + w, y + h};
+        bool complete = w > 0 && h > 0 && pixelDataLen >= (size_t)w * h * 4;
+        DrawTarget t = drawTargetLocked(drawable, childClip, "PutImage", verbose,
+                                        complete ? &written : nullptr);
+        if (!t.pixels) return;
+        x += t.originX;
+        y += t.originY;
+
+        /* Framebuffer stores X11 wire format (BGRA) with alpha forced to 0xFF so
+         * GetImage returns opaque pixels for Cairo (depth 24 padding byte). */
+        X11Framebuffer::putImage(t.pixels, t.w, t.h, x, y, w, h, pixels, pixelDataLen,
+                                 msbFirst_, childClip);
+        if (t.isWindow) {
+            addDamageLocked(x, y, w, h);
+            framebufferChangedLocked();
+        }
+    }
+
+    /* PolyFillRectangle with a solid GC: rects (x, y: INT16, w, h: CARD16) filled with the
+     * GC foreground, clipped by the GC clip rectangles and the window occlusion region.
+     * Returns false when the GC cannot be rendered exactly, in which case nothing is drawn
+     * and the client's follow-up PutImage repaints the area as before. */
+    bool fillRectangles(uint32_t drawable, uint32_t gc, const uint8_t* rects, size_t count,
+                        bool verbose) {
+        uint32_t pixel = 0;
+        if (!gcStore.solidFill(gc, pixel)) return false;
+        const GCState* st = gcStore.get(gc);
+
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        static thread_local X11ClipRegion occlusion;
+        DrawTarget t = drawTargetLocked(drawable, occlusion, "PolyFillRectangle", verbose);
+        if (!t.pixels) return true;
+
+        bool damaged = false;
+        for (size_t i = 0; i < count; i++) {
+            const uint8_t* r = rects + i * 8;
+            int x1 = (int)(int16_t)read16(r, 0) + t.originX;
+            int y1 = (int)(int16_t)read16(r, 2) + t.originY;
+            int x2 = x1 + (int)read16(r, 4);
+            int y2 = y1 + (int)read16(r, 6);
+            auto fill = [&](int fx1, int fy1, int fx2, int fy2) {
+                if (fx1 >= fx2 || fy1 >= fy2) return;
+                X11Framebuffer::fillRect(t.pixels, t.w, t.h, fx1, fy1, fx2 - fx1, fy2 - fy1,
+                                         pixel, occlusion);
+                if (t.isWindow) {
+                    addDamageLocked(fx1, fy1, fx2 - fx1, fy2 - fy1);
+                    damaged = true;
+                }
+            };
+            if (!st->clipToRects) {
+                fill(x1, y1, x2, y2);
                 continue;
             }
+            /* GC clip rects are relative to the clip origin in drawable coordinates */
+            for (const auto& c : st->clipRects) {
+                int cx = st->clipX + t.originX, cy = st->clipY + t.originY;
+                fill(std::max(x1, c.x1 + cx), std::max(y1, c.y1 + cy),
+                     std::min(x2, c.x2 + cx), std::min(y2, c.y2 + cy));
+            }
+        }
+        if (damaged) framebufferChangedLocked();
+        return true;
+    }
 
-            frameCount++;
-            if (frameCount <= 5 || frameCount % 60 == 0) {
-                LOGI("X11Debug: render thread display=%d frame #%d dirty=%d eglSurface=%p",
-                     displayNumber_, frameCount, dirty.load() ? 1 : 0, (void*)eglSurface);
+    struct ImageReadInfo {
+        bool isWindow = false;
+        int srcW = 0, srcH = 0;
+        bool usedShadow = false, fullyCovered = false;
+    };
+
+    /* Copy a gw*gh rect of a window or pixmap into dst32 in X11 wire format; pixels outside
+     * the source are zeroed. Shared by GetImage and MIT-SHM ShmGetImage. When cache is given
+     * (dst32 then lives in its buffer), a window read is recorded there under the same lock. */
+    ImageReadInfo readImage(uint32_t drawable, int gx, int gy, int gw, int gh, uint32_t* dst32,
+                            X11ReadbackCache* cache = nullptr) {
+        ImageReadInfo info;
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        const uint32_t* srcBuf = nullptr;
+        int srcW = 0, srcH = 0;
+        for (auto wid : childWindows) {
+            if (wid == drawable) { info.isWindow = true; break; }
+        }
+        if (!info.isWindow && drawable == kRootWindowId) {
+            info.isWindow = true;
+        }
+        bool useShadow = false;
+        if (info.isWindow && !framebuffer.empty()) {
+            // Framebuffer is already in X11 wire format (BGRA) — read directly
+            srcBuf = framebuffer.data();
+            useShadow = true;  // no swizzle needed
+            srcW = pluginWidth > 0 ? pluginWidth : width;
+            srcH = pluginHeight > 0 ? pluginHeight : height;
+        } else {
+            auto* pm = pixmapStore_.get(drawable);
+            if (pm) {
+                srcBuf = pm->pixels.data();
+                srcW = pm->w;
+                srcH = pm->h;
+                useShadow = true;  // Pixmaps also store X11 wire format — no swizzle needed
             }
-            if (eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext) != EGL_TRUE) {
-                usleep(5000);
-                continue;
+        }
+
+        // Track for diagnostics
+        info.srcW = srcW; info.srcH = srcH;
+        info.usedShadow = useShadow;
+
+        if (srcBuf && gw > 0 && gh > 0) {
+            bool fullyCovered = (gx >= 0 && gy >= 0 && gx + gw <= srcW && gy + gh <= srcH);
+            info.fullyCovered = fullyCovered;
+            if (cache && srcBuf == framebuffer.data()) {
+                cache->store(drawable, gx, gy, gw, gh, srcW, srcH);
             }
-            if (!glInited) {
-                glInited = initGL();
-                if (!glInited) {
-                    dirty = false;
-                    continue;
+            if (fullyCovered || !msbFirst_) {
+                // Stored pixels are already X11 wire format: copy the overlapping rows
+                X11Framebuffer::getImage(srcBuf, srcW, srcH, gx, gy, gw, gh, dst32);
+            } else {
+                // MSB-first slow path (rare)
+                std::memset(dst32, 0, (size_t)gw * gh * 4);
+                uint8_t* dst = reinterpret_cast<uint8_t*>(dst32);
+                for (int row = 0; row < gh; row++) {
+                    for (int col = 0; col < gw; col++) {
+                        int sx = gx + col, sy = gy + row;
+                        if (sx >= 0 && sx < srcW && sy >= 0 && sy < srcH) {
+                            uint32_t pixel = srcBuf[sy * srcW + sx];
+                            size_t off = (row * gw + col) * 4;
+                            dst[off+0] = (pixel >> 24) & 0xff;
+                            dst[off+1] = (pixel >> 0) & 0xff;
+                            dst[off+2] = (pixel >> 8) & 0xff;
+                            dst[off+3] = (pixel >> 16) & 0xff;
+                        }
+                    }
                 }
             }
-            // Copy framebuffer to staging buffer under lock, then clear dirty BEFORE rendering.
-            // Clearing dirty here (not after swap) prevents a race where PutImage sets dirty=true
-            // during GL render/swap, only to have it clobbered by a post-swap dirty=false.
-            int fw = 0, fh = 0;
-            {
-                std::lock_guard<std::mutex> lock(bufferMutex);
-                fw = pluginWidth > 0 ? pluginWidth : width;
-                fh = pluginHeight > 0 ? pluginHeight : height;
-                if (width > 0 && height > 0 && !framebuffer.empty()) {
-                    if (renderBuffer.size() != framebuffer.size()) {
-                        renderBuffer.resize(framebuffer.size());
-                    }
-                    renderBuffer = framebuffer;  // Copy to staging buffer
+        } else {
+            // No source found - zero pixel data
+            std::memset(dst32, 0, (size_t)gw * gh * 4);
+        }
+        return info;
+    }
+
+    /* Hand the damaged framebuffer to the render thread. Only the damaged rects are
+     * copied, into a slot the render thread does not own, so neither side waits.
+     * Caller holds bufferMutex (which keeps publish() single-producer). */
+    void publishFrameLocked() {
+        int fw = pluginWidth > 0 ? pluginWidth : width;
+        int fh = pluginHeight > 0 ? pluginHeight : height;
+        if (fw <= 0 || fh <= 0 || framebuffer.size() != (size_t)fw * fh) return;
+        if (damage.width() != fw || damage.height() != fh) damage.reset(fw, fh);
+        if (damage.empty()) return;
+        frames.publish(framebuffer.data(), fw, fh, damage);
+        damage.clear();
+    }
+
+    /* Bring fbTex up to date with the front frame. Storage is (re)allocated only when
+     * the plugin size changes; otherwise just the pending damage is uploaded. GLES2 has
+     * no GL_UNPACK_ROW_LENGTH, so wide rects go up as whole rows straight from the frame
+     * and narrow ones are packed into uploadScratch first. */
+    void uploadTexture(const X11TripleBuffer::Frame& frame) {
+        const int fw = frame.width, fh = frame.height;
+        const std::vector<uint32_t>& pixels = frame.pixels;
+        if (fbTexW != fw || fbTexH != fh) {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, fw, fh, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            fbTexW = fw;
+            fbTexH = fh;
+        } else if (renderFullUpload) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, fw, fh,
+                            GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        } else {
+            for (const auto& r : renderDamage) {
+                int rw = r.width(), rh = r.height();
+                if (rw * 2 >= fw) {
+                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, r.y1, fw, rh, GL_RGBA,
+                                    GL_UNSIGNED_BYTE, &pixels[(size_t)r.y1 * fw]);
+                    continue;
                 }
+                uploadScratch.resize((size_t)rw * rh);
+                for (int y = 0; y < rh; ++y) {
+                    memcpy(&uploadScratch[(size_t)y * rw], &pixels[(size_t)(r.y1 + y) * fw + r.x1],
+                           (size_t)rw * sizeof(uint32_t));
+                }
+                glTexSubImage2D(GL_TEXTURE_2D, 0, r.x1, r.y1, rw, rh,
+                                GL_RGBA, GL_UNSIGNED_BYTE, uploadScratch.data());
             }
-            dirty = false;  // Clear after snapshot; new PutImage during render will re-set it
-
-            // Render from staging buffer (no lock held - PutImage can update framebuffer concurrently)
-            if (width > 0 && height > 0 && fw > 0 && fh > 0 && !renderBuffer.empty()) {
-                // Compute letterbox viewport: scale to fit surface while preserving aspect ratio
-                float scaleX = (float)width / fw;
-                float scaleY = (float)height / fh;
-                float scale = scaleX < scaleY ? scaleX : scaleY;
-                int renderW = (int)(fw * scale);
-                int renderH = (int)(fh * scale);
-                int x0 = (width - renderW) / 2;
-                int y0 = (height - renderH) / 2;
-
-                // Clear full surface with background colour first
-                glViewport(0, 0, width, height);
-                glClearColor(0.1f, 0.1f, 0.15f, 1.f);
-                glClear(GL_COLOR_BUFFER_BIT);
-
-                // Render plugin texture in letterbox rect
-                glViewport(x0, y0, renderW, renderH);
-                glUseProgram(program);
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, fbTex);
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, fw, fh, 0,
-                             GL_RGBA, GL_UNSIGNED_BYTE, renderBuffer.data());
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                glUniform1i(texUniform, 0);
-                glBindBuffer(GL_ARRAY_BUFFER, fbVbo);
-                GLint aPos = glGetAttribLocation(program, "aPos");
-                GLint aTex = glGetAttribLocation(program, "aTex");
-                glEnableVertexAttribArray((GLuint)aPos);
-                glVertexAttribPointer((GLuint)aPos, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-                glEnableVertexAttribArray((GLuint)aTex);
-                glVertexAttribPointer((GLuint)aTex, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        }
+        renderDamage.clear();
+        renderFullUpload = false;
+    }
+
+    /* dirty or renderThreadRunning changed: wake the render thread wherever it waits */
+    void wakeRenderThread() {
+        X11RenderHub::instance().wake();
+    }
+
+    // X11RenderClient: called on the render hub thread
+    bool wantsFrame() const override {
+        return dirty.load() && renderThreadRunning.load() && eglSurface != EGL_NO_SURFACE;
+    }
+
+    int64_t frameDelayNs(int64_t frameTimeNs) override {
+        pacer.setCapHz(g_frameRateCapHz.load(std::memory_order_relaxed));
+        return pacer.frameDelayNs(frameTimeNs);
+    }
+
+    void onRenderStopped() override {
+        /* No renderExitMutex: stopRenderThreadOnly() may hold it while waiting for this frame */
+        renderThreadExited.store(true, std::memory_order_release);
+        LOGI("X11Debug: render stopped display=%d (EGL teardown skipped to avoid HWUI mutex crash)", displayNumber_);
+    }
+
+    /* Draw the newest published frame for vsync frameTimeNs. Returns false only when the
+     * surface is gone; the hub then stops drawing this display until startRenderThread(). */
+    bool renderFrame(int64_t frameTimeNs) override {
+        SYSTEM_TRACE_SCOPE("X11 renderFrame");
+        if (!dirty || eglSurface == EGL_NO_SURFACE) return true;
+
+        renderFrameCount++;
+        if (renderFrameCount <= 5 || renderFrameCount % 60 == 0) {
+            LOGI("X11Debug: render display=%d frame #%d dirty=%d eglSurface=%p",
+                 displayNumber_, renderFrameCount, dirty.load() ? 1 : 0, (void*)eglSurface);
+        }
+        if (eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext) != EGL_TRUE) {
+            usleep(5000);
+            return true;
+        }
+        if (!glInited) {
+            glInited = initGL();
+            if (!glInited) {
+                dirty = false;
+                return true;
             }
-            if (!renderThreadRunning) break;
-            if (eglSwapBuffers(eglDisplay, eglSurface) != EGL_TRUE) {
-                /* Surface may be destroyed by system; exit immediately without calling
-                 * eglMakeCurrent(EGL_NO_SURFACE). Making no context current can trigger
-                 * driver-level mutex operations that race with HWUI/audio threads.
-                 * Just exit the loop and let the context leak. */
-                LOGI("X11Debug: render thread display=%d eglSwapBuffers failed, exiting loop (no eglMakeCurrent)", displayNumber_);
-                break;
+        }
+        pacer.noteFrame(frameTimeNs);
+        // Take the newest published frame, then clear dirty BEFORE rendering.
+        // Clearing dirty here (not after swap) prevents a race where PutImage sets dirty=true
+        // during GL render/swap, only to have it clobbered by a post-swap dirty=false.
+        if (frames.acquire()) {
+            const auto& upload = frames.front().upload;
+            if (frames.front().external) {
+                renderDamage.clear();  // sampled in place, nothing to upload
+            } else if (frames.front().resized || upload.full()) {
+                renderFullUpload = true;
+            } else {
+                // Append rather than replace: a frame whose draw was skipped
+                // still owes its upload to the next one.
+                renderDamage.insert(renderDamage.end(), upload.rects().begin(), upload.rects().end());
+                if (renderDamage.size() > X11DamageRegion::kMaxRects) {
+                    renderFullUpload = true;
+                }
             }
-            thread_local int swapCount = 0;
-            if (++swapCount <= 10 || swapCount % 60 == 0) {
-                LOGI("X11Debug: render thread display=%d swapped buffer #%d", displayNumber_, swapCount);
+        }
+        const X11TripleBuffer::Frame& frame = frames.front();
+        const int fw = frame.width, fh = frame.height;
+        dirty = false;  // Clear after acquire; new PutImage during render will re-set it
+
+        // Render from the front frame (no lock held - PutImage can update framebuffer concurrently)
+        if (width > 0 && height > 0 && fw > 0 && fh > 0) {
+            // Compute letterbox viewport: scale to fit surface while preserving aspect ratio
+            float scaleX = (float)width / fw;
+            float scaleY = (float)height / fh;
+            float scale = scaleX < scaleY ? scaleX : scaleY;
+            int renderW = (int)(fw * scale);
+            int renderH = (int)(fh * scale);
+            int x0 = (width - renderW) / 2;
+            int y0 = (height - renderH) / 2;
+
+            // Clear full surface with background colour first
+            glViewport(0, 0, width, height);
+            glClearColor(0.1f, 0.1f, 0.15f, 1.f);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            // Render plugin texture in letterbox rect
+            const X11RenderHub::BlitProgram& blit = X11RenderHub::instance().blitProgram();
+            glViewport(x0, y0, renderW, renderH);
+            glUseProgram(blit.program);
+            glActiveTexture(GL_TEXTURE0);
+            if (frame.external) {
+                if (!hwStorage || !hwStorage->bindTexture(frame.slot)) {
+                    // Import failed: republish everything through the upload path.
+                    LOGE("X11Debug: display=%d AHardwareBuffer import failed, using texture uploads", displayNumber_);
+                    std::lock_guard<std::mutex> lock(bufferMutex);
+                    frames.dropStorage();
+                    damage.addAll();
+                    publishFrameLocked();
+                    dirty = true;
+                    return true;
+                }
+            } else {
+                glBindTexture(GL_TEXTURE_2D, fbTex);
+                SYSTEM_TRACE_SCOPE("X11 upload");
+                uploadTexture(frame);
             }
+            glUniform1i(blit.texUniform, 0);
+            glBindBuffer(GL_ARRAY_BUFFER, fbVbo);
+            glEnableVertexAttribArray((GLuint)blit.aPos);
+            glVertexAttribPointer((GLuint)blit.aPos, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+            glEnableVertexAttribArray((GLuint)blit.aTex);
+            glVertexAttribPointer((GLuint)blit.aTex, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
         }
-        /* Skip EGL teardown: eglDestroyContext/eglTerminate can destroy process-wide
-         * driver state and cause "pthread_mutex_lock on destroyed mutex" in HWUI threads
-         * that share the same EGL/GL driver. Leak the context to avoid the crash. */
-        {
-            std::lock_guard<std::mutex> lock(renderExitMutex);
-            renderThreadExited.store(true, std::memory_order_release);
+        if (!renderThreadRunning) return true;  // being stopped: skip the swap
+        SYSTEM_TRACE_SCOPE("X11 swap");
+        if (eglSwapBuffers(eglDisplay, eglSurface) != EGL_TRUE) {
+            /* Surface may be destroyed by system; stop drawing it without calling
+             * eglMakeCurrent(EGL_NO_SURFACE). Making no context current can trigger
+             * driver-level mutex operations that race with HWUI/audio threads.
+             * The next display drawn makes its own surface current. */
+            LOGI("X11Debug: render display=%d eglSwapBuffers failed, stopping (no eglMakeCurrent)", displayNumber_);
+            return false;
+        }
+        if (++swapCount <= 10 || swapCount % 60 == 0) {
+            LOGI("X11Debug: render display=%d swapped buffer #%d", displayNumber_, swapCount);
         }
-        renderExitCv.notify_all();
-        LOGI("X11Debug: render thread exiting display=%d tid=%ld (EGL teardown skipped to avoid HWUI mutex crash)", displayNumber_, getTid());
+        return true;
     }
 
     bool sendAllLocked(int fd, const void* data, size_t len) {
@@ -465,6 +804,153 @@ struct X11NativeDisplay::Impl {
         sendAllLocked(clientFd, buf, 32);
     }
 
+    /* MIT-SHM requests. The body (at most 40 bytes) has already been read into buf. Segment
+     * memory is mapped in this process by X11ShmRegistry, so images are read and written in
+     * place instead of travelling over the socket. */
+    void handleShmRequest(const uint8_t* buf, uint32_t length, uint16_t seq, bool verbose) {
+        uint8_t minor = buf[1];
+        switch (minor) {
+            case X11Shm::QueryVersion: {
+                uint8_t reply[32];
+                memset(reply, 0, 32);
+                reply[0] = 1;
+                reply[1] = 0;               // shared_pixmaps: ShmCreatePixmap is not supported
+                write16(reply, 2, seq);
+                write16(reply, 8, 1);       // major_version
+                write16(reply, 10, 1);      // minor_version
+                write16(reply, 12, (uint16_t)getuid());
+                write16(reply, 14, (uint16_t)getgid());
+                reply[16] = 2;              // pixmap_format: ZPixmap
+                sendReply(reply, 32, seq);
+                break;
+            }
+            case X11Shm::Attach: {
+                if (length < 4) break;
+                uint32_t shmseg = read32(buf, 4);
+                int shmid = (int)read32(buf, 8);
+                bool readOnly = buf[12] != 0;
+                if (!shmSegments.attach(shmseg, shmid, readOnly)) {
+                    LOGE("X11 ShmAttach failed shmseg=0x%x shmid=%d", shmseg, shmid);
+                    sendError(10 /*BadAccess*/, seq, shmseg);
+                    break;
+                }
+                LOGI("X11 ShmAttach shmseg=0x%x shmid=%d size=%zu ro=%d",
+                     shmseg, shmid, shmSegments.get(shmseg)->size, (int)readOnly);
+                break;
+            }
+            case X11Shm::Detach: {
+                if (length < 2) break;
+                uint32_t shmseg = read32(buf, 4);
+                if (!shmSegments.detach(shmseg)) sendError(X11Shm::kFirstError, seq, shmseg);
+                break;
+            }
+            case X11Shm::PutImage: {
+                SYSTEM_TRACE_SCOPE("X11 ShmPutImage");
+                /* drawable(4) gc(4) total_w(2) total_h(2) src_x(2) src_y(2) src_w(2) src_h(2)
+                 * dst_x(2) dst_y(2) depth(1) format(1) send_event(1) pad(1) shmseg(4) offset(4) */
+                if (length < 10) break;
+                uint32_t drawable = read32(buf, 4);
+                int totalW = (int)read16(buf, 12);
+                int totalH = (int)read16(buf, 14);
+                int srcX = (int)read16(buf, 16);
+                int srcY = (int)read16(buf, 18);
+                int srcW = (int)read16(buf, 20);
+                int srcH = (int)read16(buf, 22);
+                int dstX = (int)(int16_t)read16(buf, 24);
+                int dstY = (int)(int16_t)read16(buf, 26);
+                uint8_t format = buf[29];
+                bool sendEvent = buf[30] != 0;
+                uint32_t shmseg = read32(buf, 32);
+                uint32_t offset = read32(buf, 36);
+                const X11ShmSegmentTable::Segment* segment = shmSegments.get(shmseg);
+                if (!segment) {
+                    sendError(X11Shm::kFirstError, seq, shmseg);
+                    break;
+                }
+                size_t stride = (size_t)totalW * 4;
+                if (format != 2 /*ZPixmap*/ || srcX + srcW > totalW || srcY + srcH > totalH ||
+                    !segment->contains(offset, stride * totalH)) {
+                    sendError(2 /*BadValue*/, seq, offset);
+                    break;
+                }
+                if (srcW > 0 && srcH > 0 && srcW <= 4096 && srcH <= 4096) {
+                    const uint8_t* src = segment->base + offset + (size_t)srcY * stride + (size_t)srcX * 4;
+                    size_t rowBytes = (size_t)srcW * 4;
+                    if (srcW != totalW) {
+                        static thread_local std::vector<uint8_t> packed;
+                        if (packed.size() < rowBytes * srcH) packed.resize(rowBytes * srcH);
+                        for (int row = 0; row < srcH; row++)
+                            memcpy(packed.data() + row * rowBytes, src + row * stride, rowBytes);
+                        src = packed.data();
+                    }
+                    drawImage(drawable, dstX, dstY, srcW, srcH, src, rowBytes * srcH, verbose);
+                }
+                if (sendEvent) {
+                    uint8_t ev[32];
+                    memset(ev, 0, 32);
+                    ev[0] = X11Shm::kFirstEvent;  // ShmCompletion
+                    write16(ev, 2, seq);
+                    write32(ev, 4, drawable);
+                    write16(ev, 8, X11Shm::PutImage);
+                    ev[10] = kShmMajorOpcode;
+                    write32(ev, 12, shmseg);
+                    write32(ev, 16, offset);
+                    sendAllLocked(clientFd, ev, 32);
+                }
+                break;
+            }
+            case X11Shm::GetImage: {
+                SYSTEM_TRACE_SCOPE("X11 ShmGetImage");
+                /* drawable(4) x(2) y(2) w(2) h(2) plane_mask(4) format(1) pad(3) shmseg(4) offset(4) */
+                if (length < 8) break;
+                uint32_t drawable = read32(buf, 4);
+                int gx = (int)(int16_t)read16(buf, 8);
+                int gy = (int)(int16_t)read16(buf, 10);
+                int gw = (int)read16(buf, 12);
+                int gh = (int)read16(buf, 14);
+                uint32_t shmseg = read32(buf, 24);
+                uint32_t offset = read32(buf, 28);
+                const X11ShmSegmentTable::Segment* segment = shmSegments.get(shmseg);
+                if (!segment) {
+                    sendError(X11Shm::kFirstError, seq, shmseg);
+                    break;
+                }
+                size_t imgBytes = (size_t)gw * gh * 4;
+                if (segment->readOnly || !segment->contains(offset, imgBytes)) {
+                    sendError(segment->readOnly ? 10 /*BadAccess*/ : 2 /*BadValue*/, seq, offset);
+                    break;
+                }
+                uint8_t* dst = segment->base + offset;
+                static thread_local std::vector<uint32_t> unaligned;
+                uint32_t* dst32 = reinterpret_cast<uint32_t*>(dst);
+                if (reinterpret_cast<uintptr_t>(dst) & 3) {
+                    if (unaligned.size() < (size_t)gw * gh) unaligned.resize((size_t)gw * gh);
+                    dst32 = unaligned.data();
+                }
+                ImageReadInfo readInfo = readImage(drawable, gx, gy, gw, gh, dst32);
+                /* Same alpha-blend truncation bias as GetImage */
+                if (readInfo.isWindow) {
+                    for (size_t i = 0, n = (size_t)gw * gh; i < n; i++) dst32[i] |= 0x00010101u;
+                }
+                if (dst32 != reinterpret_cast<uint32_t*>(dst)) memcpy(dst, dst32, imgBytes);
+                uint8_t reply[32];
+                memset(reply, 0, 32);
+                reply[0] = 1;
+                reply[1] = 24;                       // depth
+                write16(reply, 2, seq);
+                write32(reply, 8, readInfo.isWindow ? kDefaultVisualId : 0);
+                write32(reply, 12, (uint32_t)imgBytes);
+                sendReply(reply, 32, seq);
+                break;
+            }
+            default:
+                /* ShmCreatePixmap and ShmAttachFd are not advertised (shared_pixmaps=0, version 1.1) */
+                LOGE("X11 MIT-SHM minor opcode %u not supported", (unsigned)minor);
+                sendError(1 /*BadRequest*/, seq, 0);
+                break;
+        }
+    }
+
     // X11 GetGeometry reply: reply(1), depth(1), seq(2), length(4),
     //   root(4), x(2), y(2), width(2), height(2), border_width(2), pad(2).
     void sendReplyGetGeometry(uint16_t seq, uint32_t root, int x, int y, int w, int h) {
@@ -483,6 +969,105 @@ struct X11NativeDisplay::Impl {
         sendReply(buf, 32, seq);
     }
 
+    /* Server thread: end of a GLX frame. The batch is replayed in one pass; with no desktop GL
+     * behind this EGL/GLES server, replay only accounts for the frame (Mesa's xlib GLX
+     * renders client side and delivers pixels through PutImage). */
+    void flushGlxFrame() {
+        glxBatch.replay([this](uint32_t, const uint8_t*, uint32_t size) {
+            glxCommands++;
+            glxBytes += size;
+        });
+        glxSkipped += glxBatch.stats().skipped;
+        glxFrames++;
+        glxBatch.clear();
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration<double>(now - lastGlxLog).count() >= 2.0) {
+            LOGI("X11Stats: GLX %d frames in 2s, commands=%zu skipped=%zu bytes=%zuKB",
+                 glxFrames, glxCommands, glxSkipped, glxBytes / 1024);
+            glxFrames = 0; glxCommands = glxSkipped = glxBytes = 0; lastGlxLog = now;
+        }
+    }
+
+    /** ConfigureNotify + full-window Expose after a window's size changed. */
+    void sendConfigureAndExpose(uint32_t wid, int w, int h) {
+        uint16_t evtSeq = lastReplySeq_.load(std::memory_order_relaxed);
+        uint8_t cfgNotify[32];
+        memset(cfgNotify, 0, 32);
+        cfgNotify[0] = 22;  /* ConfigureNotify */
+        write16(cfgNotify, 2, evtSeq);
+        write32(cfgNotify, 4, wid);  /* event window */
+        write32(cfgNotify, 8, wid);  /* window */
+        write32(cfgNotify, 12, 0);   /* above-sibling: None */
+        write16(cfgNotify, 16, 0);   /* x */
+        write16(cfgNotify, 18, 0);   /* y */
+        write16(cfgNotify, 20, (uint16_t)w);
+        write16(cfgNotify, 22, (uint16_t)h);
+        write16(cfgNotify, 24, 0);   /* border-width */
+        cfgNotify[26] = 0;           /* override-redirect */
+        sendAllLocked(clientFd, cfgNotify, 32);
+
+        uint8_t expose[32];
+        memset(expose, 0, 32);
+        expose[0] = Expose;
+        write16(expose, 2, evtSeq);
+        write32(expose, 4, wid);
+        write16(expose, 12, (uint16_t)w);
+        write16(expose, 14, (uint16_t)h);
+        sendAllLocked(clientFd, expose, 32);
+    }
+
+    /* pluginUI thread: sample audio load and thermal status, and when the adaptive level
+     * changes hand the new scale to the server thread. */
+    void sampleAdaptiveScale() {
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration<double>(now - lastScaleSample).count() < kScaleSampleIntervalSec) return;
+        lastScaleSample = now;
+        bool changed;
+        if (adaptiveScaleEnabled.load(std::memory_order_relaxed)) {
+            if (scaleSampleCount++ % kThermalEverySamples == 0) thermalStatus = currentThermalStatus();
+            changed = adaptiveScale.update(nowNs(), sampleAudioLoad(), thermalStatus);
+        } else {
+            changed = adaptiveScale.level() != 0;
+            adaptiveScale.reset();
+        }
+        if (!changed) return;
+        LOGI("X11Perf: adaptive UI scale -> %.2f (level %d, thermal=%d) display=%d",
+             adaptiveScale.scale(), adaptiveScale.level(), thermalStatus, displayNumber_);
+        adaptiveFactor.store(adaptiveScale.scale(), std::memory_order_relaxed);
+        uiScaleChangePending.store(true, std::memory_order_release);
+        wakeServerLoop();
+    }
+
+    /* Server thread: resize the plugin's top-level window to the current effective scale
+     * the way a window manager would, so the plugin relayouts and repaints at that size. */
+    void applyPendingUIScale() {
+        if (!uiScaleChangePending.load(std::memory_order_acquire)) return;
+        uiScaleChangePending.store(false, std::memory_order_relaxed);
+        if (clientFd < 0) return;
+        uint32_t top = 0;
+        int newW = 0, newH = 0;
+        {
+            std::lock_guard<std::mutex> mapLock(windowMapMutex);
+            if (childWindows.empty() || windowManager_.originalChildW() <= 0) return;
+            top = childWindows[0];
+            float scale = effectiveUIScale();
+            newW = std::max(1, (int)(windowManager_.originalChildW() * scale));
+            newH = std::max(1, (int)(windowManager_.originalChildH() * scale));
+            if (newW == pluginWidth && newH == pluginHeight) return;
+            windowManager_.setSize(top, newW, newH);
+        }
+        {
+            std::lock_guard<std::mutex> fbLock(bufferMutex);
+            pluginWidth = newW;
+            pluginHeight = newH;
+            framebuffer.resize((size_t)pluginWidth * pluginHeight, 0xFF302020);
+            resetDamageLocked(pluginWidth, pluginHeight);
+            framebufferChangedLocked();
+        }
+        LOGI("X11 adaptive UI scale: window 0x%x -> %dx%d", top, newW, newH);
+        sendConfigureAndExpose(top, newW, newH);
+    }
+
     /** Send Expose events to root + all child windows to force a full redraw.
      *  Called after resuming from hidden state so the plugin repaints everything. */
     void sendExposeToAllWindows() {
@@ -522,13 +1107,10 @@ struct X11NativeDisplay::Impl {
     /* Drain queued touch events and send them on the socket.
      * MUST be called only from the server thread, between request processing.
      *
-     * Experiment: buffer drag (action==2) events and only flush at 30fps,
-     * followed by an Expose to trigger a full _expose() redraw. */
-    bool hasPendingDrag = false;
-    int pendingDragX = 0, pendingDragY = 0;
+     * Buttons go out at once. Moves are merged by motion (see X11MotionCoalescer): at most
+     * one MotionNotify is outstanding until the client has processed requests after it. */
+    X11MotionCoalescer motion;
     uint32_t grabWindow = 0;  // Window that captured the pointer on ButtonPress
-    std::chrono::steady_clock::time_point lastExposeFlush = std::chrono::steady_clock::now();
-    static constexpr double FLUSH_INTERVAL_SEC = kTouchFlushIntervalSec;
 
     // Send event to a specific child window with local coordinates
     void sendEventToChild(uint8_t type, int globalX, int globalY, int button, uint16_t seq, int stateOverride = -1) {
@@ -543,6 +1125,32 @@ struct X11NativeDisplay::Impl {
         sendEvent(type, hit.wid, hit.localX, hit.localY, button, seq, stateOverride);
     }
 
+    /** Wake the server loop out of poll(). Safe from any thread. */
+    void wakeServerLoop() {
+        if (wakeFd < 0) return;
+        const uint64_t one = 1;
+        // EAGAIN only when the counter is saturated, i.e. a wakeup is already pending.
+        (void)::write(wakeFd, &one, sizeof(one));
+    }
+
+    /** poll() timeout for the server loop: until a held motion is due, otherwise forever. */
+    int serverPollTimeoutMs() const {
+        if (wakeFd < 0) return 2;  // no eventfd: poll the touch queue as before
+        int64_t waitNs = motion.waitNs(nowNs());
+        if (waitNs < 0) return -1;
+        return (int)((waitNs + 999999) / 1000000);
+    }
+
+    /** Send the merged motion if the client is ready for it. clientIdle: no complete
+     *  request is buffered, so the client has caught up with what it was sent. */
+    void flushMotion(bool clientIdle) {
+        int x, y;
+        if (clientFd >= 0 &&
+            motion.take(lastSeq_.load(std::memory_order_relaxed), clientIdle, nowNs(), x, y)) {
+            sendEventToChild(MotionNotify, x, y, 0, lastReplySeq_.load(std::memory_order_relaxed));
+        }
+    }
+
     void drainTouchQueue() {
         std::vector<QueuedTouch> pending;
         {
@@ -556,11 +1164,11 @@ struct X11NativeDisplay::Impl {
         for (auto& t : pending) {
             lastPointerX.store(t.x, std::memory_order_relaxed);
             lastPointerY.store(t.y, std::memory_order_relaxed);
+            int mx, my;
             if (t.action == 0) {
                 // Flush any pending drag before ButtonPress
-                if (hasPendingDrag) {
-                    sendEventToChild(MotionNotify, pendingDragX, pendingDragY, 0, seq);
-                    hasPendingDrag = false;
+                if (motion.takeBeforeButton(mx, my)) {
+                    sendEventToChild(MotionNotify, mx, my, 0, seq);
                 }
                 // Hit-test and grab the child window
                 HitResult hit = hitTestChildWindow(t.x, t.y);
@@ -581,31 +1189,17 @@ struct X11NativeDisplay::Impl {
                 sendEvent(MotionNotify, hit.wid, hit.localX, hit.localY, 0, seq, 0);
             } else if (t.action == 1) {
                 // Flush any pending drag before ButtonRelease
-                if (hasPendingDrag) {
-                    sendEventToChild(MotionNotify, pendingDragX, pendingDragY, 0, seq);
-                    hasPendingDrag = false;
+                if (motion.takeBeforeButton(mx, my)) {
+                    sendEventToChild(MotionNotify, mx, my, 0, seq);
                 }
                 pointerButton1Down.store(false, std::memory_order_relaxed);
                 sendEventToChild(ButtonRelease, t.x, t.y, 1, seq);
                 grabWindow = 0;  // Release grab
             } else {
-                // Drag move: just buffer the latest position
-                hasPendingDrag = true;
-                pendingDragX = t.x;
-                pendingDragY = t.y;
-            }
-        }
-
-        // Flush buffered drag at 30fps + send Expose for full redraw
-        if (hasPendingDrag && clientFd >= 0) {
-            auto now = std::chrono::steady_clock::now();
-            double elapsed = std::chrono::duration<double>(now - lastExposeFlush).count();
-            if (elapsed >= FLUSH_INTERVAL_SEC) {
-                sendEventToChild(MotionNotify, pendingDragX, pendingDragY, 0, seq);
-                hasPendingDrag = false;
-                lastExposeFlush = now;
+                motion.move(t.x, t.y, t.timeNs);
             }
         }
+        flushMotion(false);
     }
 
     // Hit-test: delegates to windowManager_.hitTest().
@@ -650,6 +1244,7 @@ struct X11NativeDisplay::Impl {
     }
 
     void serverLoop() {
+        applyThreadRole(ThreadRole::Display);
         /* Always use TCP loopback. Our custom-built libxcb does not support
          * abstract Unix sockets — it tries filesystem path /tmp/.X11-unix/XN
          * which doesn't exist on Android. TCP 127.0.0.1:(6000+N) works reliably. */
@@ -706,6 +1301,16 @@ struct X11NativeDisplay::Impl {
             }
             pixmapStore_.clear();
             atoms_.clear();
+            shmSegments.clear();
+            gcStore.clear();
+            glxBatch.resetState();
+            {
+                std::lock_guard<std::mutex> lock(bufferMutex);
+                readback.invalidate();
+            }
+            requestReader.reset();
+            motion.reset();
+            grabWindow = 0;
 
             uint8_t req[12];
             if (!recvAll(clientFd, req, 12)) {
@@ -797,60 +1402,66 @@ struct X11NativeDisplay::Impl {
                  * This ensures touch input is delivered promptly even when
                  * the plugin is sending a burst of requests. */
                 drainTouchQueue();
-
-                /* Step 3: Poll socket for X11 requests with short timeout. */
-                auto pollStart = std::chrono::steady_clock::now();
-                struct pollfd pfd = { clientFd, POLLIN, 0 };
-                int pollRet = poll(&pfd, 1, 2 /* ms */);
-                if (pollRet == 0) {
-                    /* No pending requests — continue to next iteration to drain more touch events */
-                    continue;
-                }
-                if (pollRet < 0 || (pfd.revents & (POLLERR | POLLHUP))) break;
-
-                uint8_t buf[256];
-                /* Read request header (4 bytes: opcode, pad, length) */
-                if (!recvAll(clientFd, buf, 4)) {
-                    LOGE("X11 client disconnected tid=%ld: recv request header failed (peer closed or error)",
-                         getTid());
-                    break;
-                }
-                uint8_t opcode = buf[0];
-                uint16_t length = read16(buf, 2);
-
-                /* BigRequests: length=0 means the real 32-bit length follows in the next 4 bytes.
-                 * This only happens if the client negotiated the BIG-REQUESTS extension (our
-                 * QueryExtension returns "not present", so well-behaved clients won't use it).
-                 * Handle defensively to avoid protocol desync. */
-                if (length == 0) {
-                    uint8_t extLenBuf[4];
-                    if (!recvAll(clientFd, extLenBuf, 4)) break;
-                    uint32_t bigLength = read32(extLenBuf, 0);
-                    LOGE("X11 BigRequests: opcode=%u bigLength=%u — skipping (extension not supported)", (unsigned)opcode, bigLength);
-                    if (bigLength > 2) {
-                        size_t skipBytes = ((size_t)bigLength - 2) * 4; // -2 for header+extlen already consumed
-                        while (skipBytes > 0) {
-                            uint8_t tmp[4096];
-                            size_t chunk = std::min(skipBytes, sizeof(tmp));
-                            if (!recvAll(clientFd, tmp, chunk)) break;
-                            skipBytes -= chunk;
-                        }
+                applyPendingUIScale();
+
+                /* Step 3: Take the next buffered request. When none is complete, sleep until
+                 * the client sends more, injectTouch/signalDetach signal wakeFd, or a held
+                 * motion is due, then read whatever has arrived in one recv(). The client
+                 * has caught up at this point, so a held motion may go out first. */
+                X11RequestReader::Request req;
+                if (!requestReader.next(req)) {
+                    flushMotion(true);
+                    struct pollfd pfds[2] = { { clientFd, POLLIN, 0 }, { wakeFd, POLLIN, 0 } };
+                    int pollRet = poll(pfds, wakeFd >= 0 ? 2 : 1, serverPollTimeoutMs());
+                    if (pollRet == 0) {
+                        /* Timed out — a held motion is due; the next iteration flushes it */
+                        continue;
+                    }
+                    if (pollRet < 0 && errno == EINTR) continue;
+                    if (pollRet < 0 || (pfds[0].revents & (POLLERR | POLLHUP))) break;
+                    if (pfds[1].revents & POLLIN) {
+                        uint64_t count;
+                        (void)::read(wakeFd, &count, sizeof(count));
+                    }
+                    if (!(pfds[0].revents & POLLIN)) continue;  // woken for touches or teardown
+                    if (requestReader.fill(clientFd) == X11RequestReader::FillResult::Closed) {
+                        LOGE("X11 client disconnected tid=%ld: recv failed (peer closed or error)", getTid());
+                        break;
                     }
-                    seq++;
-                    lastSeq_.store(seq, std::memory_order_relaxed);
                     continue;
                 }
+                uint8_t opcode = req.opcode;
+                uint32_t length = req.length;
 
                 seq++;
                 lastSeq_.store(seq, std::memory_order_relaxed);
 
+                if (req.discarded) {
+                    LOGE("X11 BigRequests: opcode=%u exceeds %u words — skipped",
+                         (unsigned)opcode, (unsigned)kBigRequestsMaxLength);
+                    continue;
+                }
+
+                /* Handlers index the request at fixed offsets and may read a little past a
+                 * short body, so small requests are copied into a zero-padded scratch. */
+                uint8_t smallBuf[256];
+                uint8_t* buf = req.data;
+                int bufLen = (int)req.size;
+                if (req.size <= sizeof(smallBuf)) {
+                    memcpy(smallBuf, req.data, req.size);
+                    memset(smallBuf + req.size, 0, sizeof(smallBuf) - req.size);
+                    buf = smallBuf;
+                    bufLen = (int)sizeof(smallBuf);
+                }
+
                 thread_local int reqLogCount = 0;
                 thread_local bool seenOpcode[256] = {};
                 ++reqLogCount;
                 if (!seenOpcode[opcode]) {
                     seenOpcode[opcode] = true;
-                    LOGI("X11 opcode first seen: #%d opcode=%u %s length=%u seq=%u tid=%ld",
-                         reqLogCount, (unsigned)opcode, x11OpcodeName(opcode), (unsigned)length, (unsigned)seq, getTid());
+                    LOGI("X11 opcode first seen: #%d opcode=%u %s length=%u%s seq=%u tid=%ld",
+                         reqLogCount, (unsigned)opcode, x11OpcodeName(opcode), (unsigned)length,
+                         req.big ? " (big)" : "", (unsigned)seq, getTid());
                 } else if (reqLogCount <= 100) {
                     LOGI("X11 req #%d opcode=%u %s length=%u seq=%u",
                          reqLogCount, (unsigned)opcode, x11OpcodeName(opcode), (unsigned)length, (unsigned)seq);
@@ -858,13 +1469,9 @@ struct X11NativeDisplay::Impl {
 
                 auto reqStart = std::chrono::steady_clock::now();
 
-                /* length is in 4-byte units; body size = length * 4 bytes */
-                int bodyBytes = length * 4;
-
-                static thread_local long long putImageRecvAccum = 0;
                 if (opcode == PutImage) {
+                    SYSTEM_TRACE_SCOPE("X11 PutImage");
                     auto putStart = std::chrono::steady_clock::now();
-                    if (!recvAll(clientFd, buf + 4, 20)) break;
                     uint32_t drawable = read32(buf, 4);
                     int w = (int)read16(buf, 12);
                     int h = (int)read16(buf, 14);
@@ -872,196 +1479,29 @@ struct X11NativeDisplay::Impl {
                     int y = (int)(int16_t)read16(buf, 18);
                     size_t pixelDataLen = (length >= 6) ? ((size_t)length * 4 - 24) : 0;
                     if (w > 0 && h > 0 && w <= 4096 && h <= 4096 && pixelDataLen > 0) {
-                        // Reuse thread-local buffer to avoid allocation per PutImage
-                        static thread_local std::vector<uint8_t> pixels;
-                        if (pixels.size() < pixelDataLen) pixels.resize(pixelDataLen);
-                        auto recvStart = std::chrono::steady_clock::now();
-                        if (recvAll(clientFd, pixels.data(), pixelDataLen)) {
-                            putImageRecvAccum += std::chrono::duration_cast<std::chrono::microseconds>(
-                                std::chrono::steady_clock::now() - recvStart).count();
-                            std::lock_guard<std::mutex> lock(bufferMutex);
-
-                            /* Determine target: framebuffer (window) or pixmap */
-                            /* Check childWindows FIRST to avoid conflict with root window ID */
-                            bool isWindow = false;
-                            bool isTopLevel = false;
-                            for (auto wid : childWindows) {
-                                if (wid == drawable) { isWindow = true; break; }
-                            }
-                            if (!isWindow && drawable == kRootWindowId) {
-                                isWindow = true;
-                                isTopLevel = true;
-                            }
-                            if (isWindow && !childWindows.empty() && drawable == childWindows[0]) {
-                                isTopLevel = true;
-                            }
-
-                            /* Skip PutImage for unmapped (hidden) windows */
-                            if (isWindow && !isTopLevel && windowManager_.isUnmapped(drawable)) {
-                                if (reqLogCount <= 100) LOGI("X11 PutImage SKIP unmapped wid=0x%x", drawable);
-                                isWindow = false;  // suppress framebuffer write
-                            }
-
-                            /* For child windows, offset PutImage coords by window's absolute position */
-                            if (isWindow && !isTopLevel) {
-                                auto absPos = getAbsolutePos(drawable);
-                                x += absPos.first;
-                                y += absPos.second;
-                            }
-
-                            /* Collect mapped child window rects to clip parent drawing.
-                             * On a real X11 server, child windows float above parents. On our
-                             * single-framebuffer server, we simulate this by skipping parent
-                             * pixels that fall within mapped child window bounds. */
-                            static thread_local std::vector<ClipRect> childClip;
-                            childClip.clear();
-                            if (isWindow) {
-                                std::lock_guard<std::mutex> mapLock(windowMapMutex);
-                                auto rects = windowManager_.getMappedChildRectsOf(drawable);
-                                for (auto& r : rects) {
-                                    childClip.push_back({r.x1, r.y1, r.x2, r.y2});
-                                }
-                                /* Also clip against mapped sibling windows above this
-                                 * window in the stacking order. On a real X11 server,
-                                 * higher siblings obscure lower ones. Without this,
-                                 * a lower sibling's PutImage overwrites higher sibling
-                                 * pixels in overlap regions. */
-                                if (drawable != kRootWindowId) {
-                                    auto sibRects = windowManager_.getMappedSiblingRectsAbove(drawable);
-                                    for (auto& r : sibRects) {
-                                        childClip.push_back({r.x1, r.y1, r.x2, r.y2});
-                                    }
-                                }
-                            }
-
-                            uint32_t* dstBuf = nullptr;
-                            int dW = 0, dH = 0;
-                            int fbw = pluginWidth > 0 ? pluginWidth : width;
-                            int fbh = pluginHeight > 0 ? pluginHeight : height;
-                            if (isWindow && framebuffer.size() == (size_t)fbw * fbh) {
-                                dstBuf = framebuffer.data(); dW = fbw; dH = fbh;
-                            } else {
-                                auto* pm = pixmapStore_.get(drawable);
-                                if (pm) {
-                                    dstBuf = pm->pixels.data();
-                                    dW = pm->w; dH = pm->h;
-                                }
-                            }
-
-                            if (dstBuf) {
-                                /* Fast path: region fully inside destination, LSB-first, complete pixel data */
-                                bool fullyCovered = (x >= 0 && y >= 0 && x + w <= dW && y + h <= dH
-                                    && pixelDataLen >= (size_t)w * h * 4);
-                                if (fullyCovered && !msbFirst_ && childClip.empty()) {
-                                    const uint32_t* src32 = reinterpret_cast<const uint32_t*>(pixels.data());
-                                    // Framebuffer stores X11 wire format (BGRA).
-                                    // Force alpha byte to 0xFF so GetImage returns opaque pixels
-                                    // for Cairo compositing (depth 24 — padding byte must be 0xFF).
-                                    for (int row = 0; row < h; row++) {
-                                        uint32_t* dstRow = dstBuf + (y + row) * dW + x;
-                                        const uint32_t* srcRow = src32 + row * w;
-                                        for (int col = 0; col < w; col++) {
-                                            dstRow[col] = srcRow[col] | 0xFF000000u;
-                                        }
-                                    }
-                                } else if (fullyCovered && !msbFirst_) {
-                                    /* Fast path with child clipping */
-                                    const uint32_t* src32 = reinterpret_cast<const uint32_t*>(pixels.data());
-                                    for (int row = 0; row < h; row++) {
-                                        int dstY = y + row;
-                                        uint32_t* dstRow = dstBuf + dstY * dW + x;
-                                        const uint32_t* srcRow = src32 + row * w;
-                                        for (int col = 0; col < w; col++) {
-                                            int dstX = x + col;
-                                            bool clipped = false;
-                                            for (auto& cr : childClip) {
-                                                if (dstX >= cr.x1 && dstX < cr.x2 && dstY >= cr.y1 && dstY < cr.y2) {
-                                                    clipped = true; break;
-                                                }
-                                            }
-                                            if (!clipped) dstRow[col] = srcRow[col] | 0xFF000000u;
-                                        }
-                                    }
-                                } else {
-                                    /* Slow path with bounds checking and child clipping */
-                                    size_t maxPixelIdx = pixelDataLen;
-                                    for (int row = 0; row < h; row++) {
-                                        int dstY = y + row;
-                                        if (dstY < 0 || dstY >= dH) continue;
-                                        for (int col = 0; col < w; col++) {
-                                            int dstX = x + col;
-                                            if (dstX < 0 || dstX >= dW) continue;
-                                            bool clipped = false;
-                                            for (auto& cr : childClip) {
-                                                if (dstX >= cr.x1 && dstX < cr.x2 && dstY >= cr.y1 && dstY < cr.y2) {
-                                                    clipped = true; break;
-                                                }
-                                            }
-                                            if (clipped) continue;
-                                            size_t srcIdx = (row * w + col) * 4;
-                                            if (srcIdx + 3 >= maxPixelIdx) continue;
-                                            // Store X11 wire format directly (BGRA)
-                                            uint32_t pixel;
-                                            if (msbFirst_) {
-                                                // MSB first: [A][R][G][B] in wire → store as BGRA
-                                                uint8_t a = pixels[srcIdx], r = pixels[srcIdx+1], g = pixels[srcIdx+2], b = pixels[srcIdx+3];
-                                                pixel = (a << 24) | (r << 16) | (g << 8) | b;
-                                            } else {
-                                                // LSB first: [B][G][R][A] in wire → already BGRA, just read as uint32
-                                                memcpy(&pixel, &pixels[srcIdx], 4);
-                                            }
-                                            dstBuf[(size_t)dstY * dW + dstX] = pixel | 0xFF000000u;
-                                        }
-                                    }
-                                }
-                                if (isWindow) {
-                                    dirty = true;
-                                    dirtyCv.notify_one();
-                                }
-                            }
-                        }
-                    } else if (pixelDataLen > 0) {
-                        /* Image too large or invalid dimensions — discard pixel data */
-                        std::vector<uint8_t> discard(pixelDataLen);
-                        recvAll(clientFd, discard.data(), pixelDataLen);
+                        /* Pixels are used straight from the request buffer */
+                        drawImage(drawable, x, y, w, h, buf + 24, pixelDataLen, reqLogCount <= 100);
                     }
                     {
                         auto putUs = std::chrono::duration_cast<std::chrono::microseconds>(
                             std::chrono::steady_clock::now() - putStart).count();
                         static thread_local long long totalPutUs = 0;
                         static thread_local int putCount = 0;
+                        static thread_local long long putBytes = 0;
                         static thread_local auto lastPutLog = std::chrono::steady_clock::now();
                         totalPutUs += putUs;
                         putCount++;
+                        putBytes += (long long)req.size;
                         auto now = std::chrono::steady_clock::now();
                         if (std::chrono::duration<double>(now - lastPutLog).count() >= 2.0) {
-                            LOGI("X11Stats: PutImage %d calls in 2s, total=%lldms avg=%lldus recv=%lldms",
-                                 putCount, totalPutUs / 1000, putCount > 0 ? totalPutUs / putCount : 0, putImageRecvAccum / 1000);
-                            totalPutUs = 0; putCount = 0; putImageRecvAccum = 0; lastPutLog = now;
+                            LOGI("X11Stats: PutImage %d calls in 2s, total=%lldms avg=%lldus bytes=%lldKB",
+                                 putCount, totalPutUs / 1000, putCount > 0 ? totalPutUs / putCount : 0, putBytes / 1024);
+                            totalPutUs = 0; putCount = 0; putBytes = 0; lastPutLog = now;
                         }
                     }
                     drainTouchQueue();  // Drain touch events before continuing
                     continue;
                 }
-
-                /* Read extra body bytes for requests that need it.
-                   Some requests (like ChangeWindowAttributes, DestroyWindow) read their body inside the case handler,
-                   so we skip the general read for those. */
-                if (length > 0 && opcode != 2 && opcode != 4 && opcode != 38) {  /* Skip ChangeWindowAttributes (2), DestroyWindow (4), QueryPointer (38) - read body in case handlers */
-                    size_t extra = (length - 1) * 4;
-                    /* Cap to avoid huge allocations from bad/corrupt client */
-                    if (extra > 65536) extra = 65536;
-                    if (reqLogCount <= 15 && extra > 0 && extra <= 256) {
-                        LOGI("X11 recv extra %zu bytes for %s", extra, x11OpcodeName(opcode));
-                    }
-                    if (extra > sizeof(buf) - 4) {
-                        std::vector<uint8_t> discard(extra);
-                        recvAll(clientFd, discard.data(), extra);
-                    } else {
-                        recvAll(clientFd, buf + 4, extra);
-                    }
-                }
-
                 switch (opcode) {
                     case CreateWindow: {
                         if (length == 0) {
@@ -1088,6 +1528,8 @@ struct X11NativeDisplay::Impl {
                             // Framebuffer stores X11 wire format (BGRA): B=0x20, G=0x20, R=0x30, A=0xFF
                             uint32_t bgX11 = 0xFF302020;
                             framebuffer.assign((size_t)pluginWidth * pluginHeight, bgX11);
+                            resetDamageLocked(pluginWidth, pluginHeight);
+                            publishFrameLocked();
                             LOGI("X11: Plugin size set to %dx%d (framebuffer initial)", pluginWidth, pluginHeight);
                         }
                         /* Send Expose for the new child window so the plugin draws even if MapWindow
@@ -1153,12 +1595,56 @@ struct X11NativeDisplay::Impl {
                     /* NOTE: X11Protocol.h defines ResizeWindow=23, but X11 opcode 23 is
                      * GetSelectionOwner (reply required). Real resize is ConfigureWindow (opcode 12).
                      * GetSelectionOwner is now handled in the generic reply block above. */
-                    case PolyFillRectangle:
-                        /* No-op: skip drawing. The plugin draws all visible content via PutImage.
-                         * PolyFillRectangle is typically used to clear areas before PutImage redraws,
-                         * but we don't know the correct GC foreground color, so drawing with a
-                         * hardcoded color causes visible darkening artifacts. Skipping is safe
-                         * because PutImage overwrites the same pixels immediately after. */
+                    case PolyFillRectangle: {
+                        /* Request: opcode(1), unused(1), length(2), drawable(4), gc(4), rects(8 each).
+                         * Rendered with the tracked GC foreground. GCs we cannot reproduce exactly
+                         * (non-copy function, tiles/stipples, clip pixmaps) are skipped as before:
+                         * a guessed colour causes visible artifacts, and the client's PutImage
+                         * overwrites the same pixels anyway. */
+                        uint32_t drawable = read32(buf, 4);
+                        uint32_t gc = read32(buf, 8);
+                        size_t nRects = length >= 3 ? ((size_t)length * 4 - 12) / 8 : 0;
+                        if (!fillRectangles(drawable, gc, buf + 12, nRects, reqLogCount <= 100) &&
+                            reqLogCount <= 100) {
+                            LOGI("X11 PolyFillRectangle SKIP gc=0x%x (not a solid copy fill)", gc);
+                        }
+                        break;
+                    }
+                    /* --- Graphics contexts: track what solid fills need --- */
+                    case 55: /* CreateGC: cid(4), drawable(4), value_mask(4), values */
+                    case 56: { /* ChangeGC: gc(4), value_mask(4), values */
+                        bool create = opcode == 55;
+                        uint32_t gc = read32(buf, 4);
+                        int maskOff = create ? 12 : 8;
+                        uint32_t mask = read32(buf, maskOff);
+                        uint32_t values[X11GCStore::kValueBits];
+                        size_t avail = (size_t)length * 4 > (size_t)maskOff + 4
+                            ? ((size_t)length * 4 - maskOff - 4) / 4 : 0;
+                        size_t n = std::min<size_t>({avail, (size_t)X11GCStore::kValueBits,
+                                                     (size_t)__builtin_popcount(mask)});
+                        for (size_t i = 0; i < n; i++) values[i] = read32(buf, maskOff + 4 + (int)i * 4);
+                        if (create) gcStore.create(gc, mask, values, n);
+                        else gcStore.change(gc, mask, values, n);
+                        break;
+                    }
+                    case 57: /* CopyGC: src(4), dst(4), value_mask(4) */
+                        gcStore.copy(read32(buf, 4), read32(buf, 8), read32(buf, 12));
+                        break;
+                    case 59: { /* SetClipRectangles: gc(4), x_origin(2), y_origin(2), rects(8 each) */
+                        std::vector<ClipRect> rects;
+                        size_t nRects = length >= 3 ? ((size_t)length * 4 - 12) / 8 : 0;
+                        rects.reserve(nRects);
+                        for (size_t i = 0; i < nRects; i++) {
+                            int off = 12 + (int)i * 8;
+                            int rx = (int)(int16_t)read16(buf, off), ry = (int)(int16_t)read16(buf, off + 2);
+                            rects.push_back({rx, ry, rx + (int)read16(buf, off + 4), ry + (int)read16(buf, off + 6)});
+                        }
+                        gcStore.setClipRectangles(read32(buf, 4), (int)(int16_t)read16(buf, 8),
+                                                  (int)(int16_t)read16(buf, 10), std::move(rects));
+                        break;
+                    }
+                    case 60: /* FreeGC */
+                        gcStore.destroy(read32(buf, 4));
                         break;
                     case GetGeometry: {
                         /* GetGeometry request: opcode(1), unused(1), length(2), drawable(4) */
@@ -1183,8 +1669,8 @@ struct X11NativeDisplay::Impl {
                                  * Plugins call XGetWindowAttributes(parentXwindow) in resize_event
                                  * and resize themselves to match. Using the ORIGINAL size (not current)
                                  * prevents a feedback loop where each resize shrinks the window further. */
-                                geoWidth = (int)(windowManager_.originalChildW() * uiScale);
-                                geoHeight = (int)(windowManager_.originalChildH() * uiScale);
+                                geoWidth = (int)(windowManager_.originalChildW() * effectiveUIScale());
+                                geoHeight = (int)(windowManager_.originalChildH() * effectiveUIScale());
                                 if (geoWidth < 1) geoWidth = 1;
                                 if (geoHeight < 1) geoHeight = 1;
                                 source = "root->orig-scaled";
@@ -1249,9 +1735,11 @@ struct X11NativeDisplay::Impl {
                         uint16_t nameLen = read16(buf, 4);
                         const char* extName = (nameLen > 0 && nameLen <= 200) ? reinterpret_cast<const char*>(buf + 8) : "";
                         bool isGLX = (nameLen == 3 && strncmp(extName, "GLX", 3) == 0);
-                        if (reqLogCount <= 15 || isGLX)
-                            LOGI("X11 handle QueryExtension '%.*s' -> %s",
-                                 (int)nameLen, extName, isGLX ? "present" : "not present");
+                        bool isShm = (nameLen == 7 && strncmp(extName, "MIT-SHM", 7) == 0);
+                        bool isBigReq = (nameLen == 12 && strncmp(extName, "BIG-REQUESTS", 12) == 0);
+                        if (reqLogCount <= 15 || isGLX || isShm || isBigReq)
+                            LOGI("X11 handle QueryExtension '%.*s' -> %s", (int)nameLen, extName,
+                                 (isGLX || isShm || isBigReq) ? "present" : "not present");
                         uint8_t reply[32];
                         memset(reply, 0, 32);
                         reply[0] = 1;  /* reply */
@@ -1261,12 +1749,21 @@ struct X11NativeDisplay::Impl {
                             reply[9] = kGLXMajorOpcode;  /* major_opcode */
                             reply[10] = 0; /* first_event */
                             reply[11] = 0; /* first_error */
+                        } else if (isShm) {
+                            reply[8] = 1;
+                            reply[9] = kShmMajorOpcode;
+                            reply[10] = X11Shm::kFirstEvent;
+                            reply[11] = X11Shm::kFirstError;
+                        } else if (isBigReq) {
+                            reply[8] = 1;
+                            reply[9] = kBigRequestsMajorOpcode;
                         }
                         sendReply(reply, 32, seq);
                         break;
                     }
                     /* --- GetImage: return framebuffer/pixmap pixel data --- */
                     case 73: { /* GetImage */
+                        SYSTEM_TRACE_SCOPE("X11 GetImage");
                         /* Request: opcode(1), format(1), length(2), drawable(4), x(2), y(2), w(2), h(2), plane_mask(4) */
                         uint32_t drawable = read32(buf, 4);
                         int gx = (int)(int16_t)read16(buf, 8);
@@ -1275,144 +1772,74 @@ struct X11NativeDisplay::Impl {
                         int gh = (int)read16(buf, 14);
                         auto getImageStart = std::chrono::steady_clock::now();
 
-                        /* Determine source pixels and copy under lock, then send without lock */
+                        /* Determine source pixels and copy under lock, then send without lock.
+                         * A repeat of the previous window GetImage whose rect no write has
+                         * touched since is answered from the cached reply without copying. */
                         size_t imgBytes = (size_t)gw * gh * 4;
                         size_t imgWords = (imgBytes + 3) / 4;
                         size_t replySize = 32 + imgWords * 4;
-                        // Reuse a thread-local buffer to avoid 6MB alloc+zero every frame
-                        static thread_local std::vector<uint8_t> replyBuf;
-                        if (replyBuf.size() < replySize) {
-                            replyBuf.resize(replySize);
-                        }
-                        // Zero only the 32-byte header
-                        std::memset(replyBuf.data(), 0, 32);
-                        replyBuf[0] = 1;       // Reply
-                        replyBuf[1] = 24;      // depth
-                        write16(replyBuf.data(), 2, seq);
-                        write32(replyBuf.data(), 4, (uint32_t)imgWords);
-                        write32(replyBuf.data(), 8, 0);  // visual
-
-                        int getImageSrcW = 0, getImageSrcH = 0;
-                        bool getImageUsedShadow = false, getImageFullyCovered = false;
-                        bool isWindow = false;
+                        bool cached = false;
                         {
                             std::lock_guard<std::mutex> lock(bufferMutex);
-                            const uint32_t* srcBuf = nullptr;
-                            int srcW = 0, srcH = 0;
-                            for (auto wid : childWindows) {
-                                if (wid == drawable) { isWindow = true; break; }
-                            }
-                            if (!isWindow && drawable == kRootWindowId) {
-                                isWindow = true;
-                            }
-                            bool useShadow = false;
-                            if (isWindow && !framebuffer.empty()) {
-                                // Framebuffer is already in X11 wire format (BGRA) — read directly
-                                srcBuf = framebuffer.data();
-                                useShadow = true;  // no swizzle needed
-                                srcW = pluginWidth > 0 ? pluginWidth : width;
-                                srcH = pluginHeight > 0 ? pluginHeight : height;
-                            } else {
-                                auto* pm = pixmapStore_.get(drawable);
-                                if (pm) {
-                                    srcBuf = pm->pixels.data();
-                                    srcW = pm->w;
-                                    srcH = pm->h;
-                                    useShadow = true;  // Pixmaps also store X11 wire format — no swizzle needed
-                                }
-                            }
-
-                            // Track for diagnostics
-                            getImageSrcW = srcW; getImageSrcH = srcH;
-                            getImageUsedShadow = useShadow; getImageFullyCovered = false;
-
-                            if (srcBuf && gw > 0 && gh > 0) {
-                                uint32_t* dst32 = reinterpret_cast<uint32_t*>(replyBuf.data() + 32);
-                                bool fullyCovered = (gx >= 0 && gy >= 0 && gx + gw <= srcW && gy + gh <= srcH);
-                                getImageFullyCovered = fullyCovered;
-                                if (fullyCovered && useShadow) {
-                                    // Fast path: shadow is already in X11 wire format, just memcpy rows
-                                    for (int row = 0; row < gh; row++) {
-                                        memcpy(dst32 + row * gw, srcBuf + (gy + row) * srcW + gx, gw * 4);
-                                    }
-                                } else if (fullyCovered && !msbFirst_) {
-                                    for (int row = 0; row < gh; row++) {
-                                        const uint32_t* srcRow = srcBuf + (gy + row) * srcW + gx;
-                                        uint32_t* dstRow = dst32 + row * gw;
-                                        swapRB_neon(srcRow, dstRow, gw);
-                                    }
-                                } else if (!msbFirst_) {
-                                    // Partially covered: zero the buffer, then copy/swizzle the overlapping rows
-                                    std::memset(replyBuf.data() + 32, 0, imgWords * 4);
-                                    int startRow = std::max(0, -gy);
-                                    int endRow = std::min(gh, srcH - gy);
-                                    int startCol = std::max(0, -gx);
-                                    int endCol = std::min(gw, srcW - gx);
-                                    if (startRow < endRow && startCol < endCol) {
-                                        int copyW = endCol - startCol;
-                                        for (int row = startRow; row < endRow; row++) {
-                                            const uint32_t* srcRow = srcBuf + (gy + row) * srcW + (gx + startCol);
-                                            uint32_t* dstRow = dst32 + row * gw + startCol;
-                                            if (useShadow) {
-                                                memcpy(dstRow, srcRow, copyW * 4);
-                                            } else {
-                                                swapRB_neon(srcRow, dstRow, copyW);
-                                            }
-                                        }
-                                    }
-                                } else {
-                                    // MSB-first slow path (rare)
-                                    std::memset(replyBuf.data() + 32, 0, imgWords * 4);
-                                    uint8_t* dst = replyBuf.data() + 32;
-                                    for (int row = 0; row < gh; row++) {
-                                        for (int col = 0; col < gw; col++) {
-                                            int sx = gx + col, sy = gy + row;
-                                            if (sx >= 0 && sx < srcW && sy >= 0 && sy < srcH) {
-                                                uint32_t pixel = srcBuf[sy * srcW + sx];
-                                                size_t off = (row * gw + col) * 4;
-                                                dst[off+0] = (pixel >> 24) & 0xff;
-                                                dst[off+1] = (pixel >> 0) & 0xff;
-                                                dst[off+2] = (pixel >> 8) & 0xff;
-                                                dst[off+3] = (pixel >> 16) & 0xff;
-                                            }
-                                        }
-                                    }
+                            int fw = pluginWidth > 0 ? pluginWidth : width;
+                            int fh = pluginHeight > 0 ? pluginHeight : height;
+                            cached = !framebuffer.empty() &&
+                                     readback.matches(drawable, gx, gy, gw, gh, fw, fh);
+                            if (!cached) readback.invalidate();
+                        }
+                        uint8_t* reply = nullptr;
+                        ImageReadInfo readInfo;
+                        if (cached) {
+                            reply = readback.data();
+                            readback.countHit();
+                        } else {
+                            // The cache buffer doubles as the reply buffer (no 6MB alloc+zero per frame)
+                            reply = readback.prepare(replySize);
+                            // Zero only the 32-byte header
+                            std::memset(reply, 0, 32);
+                            reply[0] = 1;       // Reply
+                            reply[1] = 24;      // depth
+                            write32(reply, 4, (uint32_t)imgWords);
+                            write32(reply, 8, 0);  // visual
+
+                            readInfo = readImage(drawable, gx, gy, gw, gh,
+                                                 reinterpret_cast<uint32_t*>(reply + 32), &readback);
+
+                            /* Compensate for integer rounding error accumulation in alpha
+                             * blending. Cairo's pixman uses integer division by 255 which
+                             * truncates, systematically losing ~0.5 LSB per blend cycle.
+                             * Over many GetImage→composite→PutImage frames, this causes
+                             * progressive darkening and dot patterns in GxPlugins.
+                             *
+                             * Workaround: bias each R,G,B channel up by +1 (saturating at
+                             * 255) when returning pixels via GetImage. This approximately
+                             * cancels the truncation loss, stabilizing pixel values across
+                             * repeated blend cycles. The real fix would be implementing the
+                             * RENDER extension for server-side compositing. The cached reply
+                             * keeps the bias, so a reuse returns exactly what a re-read would. */
+                            if (readInfo.isWindow && gw > 0 && gh > 0) {
+                                uint32_t* dst32 = reinterpret_cast<uint32_t*>(reply + 32);
+                                size_t totalPixels = (size_t)gw * gh;
+                                for (size_t i = 0; i < totalPixels; i++) {
+                                    dst32[i] |= 0x00010101u;
                                 }
-                            } else {
-                                // No source found - zero pixel data
-                                std::memset(replyBuf.data() + 32, 0, imgWords * 4);
-                            }
-                        } /* bufferMutex released — PutImage can proceed while we send */
-
-                        /* Compensate for integer rounding error accumulation in alpha
-                         * blending. Cairo's pixman uses integer division by 255 which
-                         * truncates, systematically losing ~0.5 LSB per blend cycle.
-                         * Over many GetImage→composite→PutImage frames, this causes
-                         * progressive darkening and dot patterns in GxPlugins.
-                         *
-                         * Workaround: bias each R,G,B channel up by +1 (saturating at
-                         * 255) when returning pixels via GetImage. This approximately
-                         * cancels the truncation loss, stabilizing pixel values across
-                         * repeated blend cycles. The real fix would be implementing the
-                         * RENDER extension for server-side compositing. */
-                        if (isWindow && gw > 0 && gh > 0) {
-                            uint32_t* dst32 = reinterpret_cast<uint32_t*>(replyBuf.data() + 32);
-                            size_t totalPixels = (size_t)gw * gh;
-                            for (size_t i = 0; i < totalPixels; i++) {
-                                dst32[i] |= 0x00010101u;
                             }
                         }
+                        write16(reply, 2, seq);
+                        int getImageSrcW = readInfo.srcW, getImageSrcH = readInfo.srcH;
+                        bool getImageUsedShadow = readInfo.usedShadow, getImageFullyCovered = readInfo.fullyCovered;
 
                         auto copyDoneTime = std::chrono::steady_clock::now();
                         drainTouchQueue();
-                        sendReply(replyBuf.data(), replySize, seq);
+                        sendReply(reply, replySize, seq);
                         auto sendDoneTime = std::chrono::steady_clock::now();
                         auto copyUs = std::chrono::duration_cast<std::chrono::microseconds>(copyDoneTime - getImageStart).count();
                         auto sendUs = std::chrono::duration_cast<std::chrono::microseconds>(sendDoneTime - copyDoneTime).count();
                         if (copyUs + sendUs > 5000) {
-                            LOGI("X11Perf: GetImage %dx%d copy=%lldus send=%lldus total=%lldus (src=%dx%d shadow=%d covered=%d)",
+                            LOGI("X11Perf: GetImage %dx%d copy=%lldus send=%lldus total=%lldus (src=%dx%d shadow=%d covered=%d cached=%d hits=%zu)",
                                  gw, gh, (long long)copyUs, (long long)sendUs, (long long)(copyUs+sendUs),
-                                 (int)getImageSrcW, (int)getImageSrcH, (int)getImageUsedShadow, (int)getImageFullyCovered);
+                                 (int)getImageSrcW, (int)getImageSrcH, (int)getImageUsedShadow, (int)getImageFullyCovered,
+                                 (int)cached, readback.hits());
                         }
                         break;
                     }
@@ -1504,30 +1931,24 @@ struct X11NativeDisplay::Impl {
                         }
 
                         if (srcPixels && dstPixels && cw > 0 && ch > 0) {
-                            for (int row = 0; row < ch; row++) {
-                                int sy = srcY + row, dy = dstY + row;
-                                if (sy < 0 || sy >= sH || dy < 0 || dy >= dH) continue;
-                                for (int col = 0; col < cw; col++) {
-                                    int sx = srcX + col, dx = dstX + col;
-                                    if (sx < 0 || sx >= sW || dx < 0 || dx >= dW) continue;
-                                    dstPixels[dy * dW + dx] = srcPixels[sy * sW + sx];
-                                }
-                            }
+                            X11Framebuffer::copyArea(srcPixels, sW, sH, srcX, srcY,
+                                                     dstPixels, dW, dH, dstX, dstY, cw, ch);
                             if (dstIsWindow) {
+                                addDamageLocked(dstX, dstY, cw, ch);
+                                publishFrameLocked();
                                 dirty = true;
-                                dirtyCv.notify_one();
+                                wakeRenderThread();
                             }
                         }
                         break;
                     }
                     /* --- Requests that expect a reply (send generic 32-byte) --- */
                     case ListExtensions: {
-                        /* ListExtensions reply: return GLX as available extension.
-                         * Reply format: header(32) + list of STRING8 (1-byte length prefix + name).
-                         * We return a single extension: "GLX" (3 chars). */
-                        if (reqLogCount <= 20) LOGI("X11 handle ListExtensions -> GLX");
-                        const char* extNames[] = { "GLX" };
-                        const int numExt = 1;
+                        /* ListExtensions reply: return the extensions we implement.
+                         * Reply format: header(32) + list of STRING8 (1-byte length prefix + name). */
+                        if (reqLogCount <= 20) LOGI("X11 handle ListExtensions -> GLX, MIT-SHM, BIG-REQUESTS");
+                        const char* extNames[] = { "GLX", "MIT-SHM", "BIG-REQUESTS" };
+                        const int numExt = 3;
                         /* Calculate body size: each entry = 1 byte length + N bytes name */
                         size_t bodySize = 0;
                         for (int i = 0; i < numExt; i++)
@@ -1553,16 +1974,16 @@ struct X11NativeDisplay::Impl {
                         /* Request: opcode(1), only_if_exists(1), length(2), name_len(2), pad(2), name(n) */
                         uint8_t onlyIfExists = buf[1];
                         uint16_t nameLen = read16(buf, 4);
-                        std::string name;
+                        std::string_view name;
                         if (nameLen > 0 && nameLen <= 256) {
-                            name.assign(reinterpret_cast<const char*>(buf + 8), nameLen);
+                            name = std::string_view(reinterpret_cast<const char*>(buf + 8), nameLen);
                         }
 
                         uint32_t atomId = atoms_.intern(name, onlyIfExists);
 
                         if (reqLogCount <= 50)
-                            LOGI("X11 InternAtom '%s' only_if_exists=%d -> atom=%u",
-                                 name.c_str(), (int)onlyIfExists, atomId);
+                            LOGI("X11 InternAtom '%.*s' only_if_exists=%d -> atom=%u",
+                                 (int)name.size(), name.data(), (int)onlyIfExists, atomId);
 
                         uint8_t reply[32];
                         memset(reply, 0, 32);
@@ -1574,7 +1995,7 @@ struct X11NativeDisplay::Impl {
                     }
                     case GetAtomName: { /* 17 — reverse lookup */
                         uint32_t atomId = read32(buf, 4);
-                        std::string name = atoms_.getName(atomId);
+                        std::string_view name = atoms_.getName(atomId);
 
                         /* Reply: name_length(2) at bytes 8-9, then name string */
                         uint16_t nameLen = (uint16_t)name.size();
@@ -1662,14 +2083,6 @@ struct X11NativeDisplay::Impl {
                     }
                     case 38: { /* QueryPointer - needed for plugin to track mouse position */
                         if (reqLogCount <= 20) LOGI("X11 handle QueryPointer");
-                        /* Read the body: window(4). length=2 so body = (2-1)*4 = 4 bytes */
-                        {
-                            int qpBody = (length > 1) ? (int)(length - 1) * 4 : 0;
-                            if (qpBody > 0) {
-                                std::vector<uint8_t> qpBuf(qpBody);
-                                if (!recvAll(clientFd, qpBuf.data(), qpBody)) break;
-                            }
-                        }
                         /* Build proper QueryPointer reply:
                          * byte 0: reply type (1)
                          * byte 1: same-screen boolean (1 = true)
@@ -1706,20 +2119,6 @@ struct X11NativeDisplay::Impl {
                         int cwBodyBytes = (length > 1) ? (int)(length - 1) * 4 : 0;
                         if (cwBodyBytes < 8) {
                             LOGE("X11 ChangeWindowAttributes: body too small %d (length=%u)", cwBodyBytes, (unsigned)length);
-                            if (cwBodyBytes > 0) {
-                                std::vector<uint8_t> skip(cwBodyBytes);
-                                recvAll(clientFd, skip.data(), cwBodyBytes);
-                            }
-                            break;
-                        }
-                        if (cwBodyBytes > 256) {
-                            LOGE("X11 ChangeWindowAttributes: body too large %d (length=%u), skipping", cwBodyBytes, (unsigned)length);
-                            std::vector<uint8_t> skip(cwBodyBytes);
-                            recvAll(clientFd, skip.data(), cwBodyBytes);
-                            break;
-                        }
-                        if (!recvAll(clientFd, buf + 4, cwBodyBytes)) {
-                            LOGE("X11 ChangeWindowAttributes: failed to read body (%d bytes)", cwBodyBytes);
                             break;
                         }
                         uint32_t window = read32(buf, 4);
@@ -1743,7 +2142,6 @@ struct X11NativeDisplay::Impl {
                     }
                     /* --- Void requests (no reply expected by client) --- */
                     case 4:  /* DestroyWindow */
-                        if (!recvAll(clientFd, buf + 4, 4)) break;
                         {
                             uint32_t window = read32(buf, 4);
                             {
@@ -1837,8 +2235,8 @@ struct X11NativeDisplay::Impl {
                             }
                         }
                         int newW = -1, newH = -1;
-                        if ((vmask & 0x0004) && valOff + 4 <= (int)sizeof(buf)) { newW = (int)read32(buf, valOff); valOff += 4; }
-                        if ((vmask & 0x0008) && valOff + 4 <= (int)sizeof(buf)) { newH = (int)read32(buf, valOff); valOff += 4; }
+                        if ((vmask & 0x0004) && valOff + 4 <= bufLen) { newW = (int)read32(buf, valOff); valOff += 4; }
+                        if ((vmask & 0x0008) && valOff + 4 <= bufLen) { newH = (int)read32(buf, valOff); valOff += 4; }
 
                         bool isChildWin = false;
                         int finalW = -1, finalH = -1;
@@ -1882,6 +2280,8 @@ struct X11NativeDisplay::Impl {
                                 uint32_t bgX11 = 0xFF302020;
                                 /* resize() preserves existing pixels; only fills newly added pixels */
                                 framebuffer.resize((size_t)pluginWidth * pluginHeight, bgX11);
+                                resetDamageLocked(pluginWidth, pluginHeight);
+                                publishFrameLocked();
                             }
 
                             /* Only send ConfigureNotify + Expose on actual size changes.
@@ -1889,32 +2289,7 @@ struct X11NativeDisplay::Impl {
                              * feedback loop: ConfigureNotify → resize_event → XResizeWindow
                              * → ConfigureNotify → ..., causing rendering artifacts. */
                             /* Send ConfigureNotify + Expose only on actual size changes */
-                            if (sizeChanged) {
-                                uint16_t evtSeq = lastReplySeq_.load(std::memory_order_relaxed);
-                                uint8_t cfgNotify[32];
-                                memset(cfgNotify, 0, 32);
-                                cfgNotify[0] = 22;  /* ConfigureNotify */
-                                write16(cfgNotify, 2, evtSeq);
-                                write32(cfgNotify, 4, cfgWid);  /* event window */
-                                write32(cfgNotify, 8, cfgWid);  /* window */
-                                write32(cfgNotify, 12, 0);       /* above-sibling: None */
-                                write16(cfgNotify, 16, 0);       /* x */
-                                write16(cfgNotify, 18, 0);       /* y */
-                                write16(cfgNotify, 20, (uint16_t)finalW);
-                                write16(cfgNotify, 22, (uint16_t)finalH);
-                                write16(cfgNotify, 24, 0);       /* border-width */
-                                cfgNotify[26] = 0;               /* override-redirect */
-                                sendAllLocked(clientFd, cfgNotify, 32);
-
-                                uint8_t expose[32];
-                                memset(expose, 0, 32);
-                                expose[0] = Expose;
-                                write16(expose, 2, evtSeq);
-                                write32(expose, 4, cfgWid);
-                                write16(expose, 12, (uint16_t)finalW);
-                                write16(expose, 14, (uint16_t)finalH);
-                                sendAllLocked(clientFd, expose, 32);
-                            }
+                            if (sizeChanged) sendConfigureAndExpose(cfgWid, finalW, finalH);
                         } else {
                             if (reqLogCount <= 20) LOGI("X11 ConfigureWindow wid=0x%x vmask=0x%04x (no size change)", cfgWid, (unsigned)vmask);
                         }
@@ -1938,12 +2313,28 @@ struct X11NativeDisplay::Impl {
                         }
                         break;
                     }
+                    case kShmMajorOpcode:
+                        handleShmRequest(buf, length, seq, reqLogCount <= 100);
+                        break;
+                    case kBigRequestsMajorOpcode: {
+                        /* BigReqEnable (minor 0): from now on the client may send length=0
+                         * requests with a 32-bit length; X11RequestReader always accepts them. */
+                        uint8_t reply[32];
+                        memset(reply, 0, 32);
+                        reply[0] = 1;
+                        write16(reply, 2, seq);
+                        write32(reply, 8, kBigRequestsMaxLength);
+                        sendReply(reply, 32, seq);
+                        LOGI("X11 BigReqEnable -> max %u words", (unsigned)kBigRequestsMaxLength);
+                        break;
+                    }
                     case kGLXMajorOpcode: {
                         /* GLX extension requests.
                          * Mesa's xlib GLX with swrast does most rendering client-side.
                          * The server only needs to handle a few GLX queries.
                          * GLX sub-opcode is in buf[1] (the "data" byte of the request header). */
                         uint8_t glxMinor = buf[1];
+                        SYSTEM_TRACE_SCOPE(glxMinor == 11 ? "X11 glXSwapBuffers" : "X11 GLX");
                         /* GLX sub-opcodes:
                          *   1  = glXRender (void, no reply)
                          *   2  = glXRenderLarge (void, no reply)
@@ -1966,7 +2357,9 @@ struct X11NativeDisplay::Impl {
                          *  24  = glXMakeContextCurrent (reply)
                          *  26  = glXQueryContext (reply)
                          */
-                        LOGI("X11 handle GLX sub-opcode=%u length=%u", (unsigned)glxMinor, (unsigned)length);
+                        if (glxMinor != 1 && glxMinor != 2 && glxMinor != 11)  // per-frame requests
+                            LOGI("X11 handle GLX sub-opcode=%u length=%u", (unsigned)glxMinor, (unsigned)length);
+                        if (glxMinor >= 101) glxBatch.invalidateState();  // glXSingle / vendor: GL state may change
                         switch (glxMinor) {
                             case 7: { /* glXQueryVersion */
                                 uint8_t reply[32];
@@ -1979,6 +2372,7 @@ struct X11NativeDisplay::Impl {
                                 break;
                             }
                             case 5: { /* glXMakeCurrent */
+                                glxBatch.resetState();
                                 /* Reply: context tag (32-bit) */
                                 uint8_t reply[32];
                                 memset(reply, 0, 32);
@@ -1989,6 +2383,7 @@ struct X11NativeDisplay::Impl {
                                 break;
                             }
                             case 24: { /* glXMakeContextCurrent */
+                                glxBatch.resetState();
                                 uint8_t reply[32];
                                 memset(reply, 0, 32);
                                 reply[0] = 1;
@@ -2108,15 +2503,27 @@ struct X11NativeDisplay::Impl {
                                 sendReply(reply, 32, seq);
                                 break;
                             }
+                            case 1:  /* glXRender: context_tag(4), commands... */
+                                if (bufLen > 8) glxBatch.addRender(buf + 8, (size_t)bufLen - 8, byteOrder_);
+                                break;
+                            case 2: { /* glXRenderLarge: context_tag(4), request_number(2), request_total(2), n(4), data */
+                                if (bufLen < 16) break;
+                                size_t n = read32(buf, 12);
+                                if (n > (size_t)bufLen - 16) n = (size_t)bufLen - 16;
+                                glxBatch.addRenderLargePart(read16(buf, 8), read16(buf, 10), buf + 16, n, byteOrder_);
+                                break;
+                            }
+                            case 11: /* glXSwapBuffers: the frame's commands are complete */
+                                flushGlxFrame();
+                                break;
+                            case 4:  /* glXDestroyContext */
+                                glxBatch.resetState();
+                                break;
                             /* Void GLX requests (no reply expected) */
-                            case 1:  /* glXRender */
-                            case 2:  /* glXRenderLarge */
                             case 3:  /* glXCreateContext */
-                            case 4:  /* glXDestroyContext */
                             case 8:  /* glXWaitGL */
                             case 9:  /* glXWaitX */
                             case 10: /* glXCopyContext */
-                            case 11: /* glXSwapBuffers */
                             case 18: /* glXClientInfo */
                             case 20: /* glXCreatePixmap */
                             case 21: /* glXDestroyPixmap */
@@ -2142,12 +2549,7 @@ struct X11NativeDisplay::Impl {
                     case 24: /* ConvertSelection (void) */
                     case 42: /* SetInputFocus */
                     case 51: /* SetFontPath */
-                    case 55: /* CreateGC */
-                    case 56: /* ChangeGC */
-                    case 57: /* CopyGC */
                     case 58: /* SetDashes */
-                    case 59: /* SetClipRectangles */
-                    case 60: /* FreeGC */
                     case 61: /* ClearArea — actually has reply if exposures=1; treat as void for simplicity */
                     case 63: /* CopyPlane */
                     case 64: /* PolyPoint */
@@ -2200,6 +2602,18 @@ struct X11NativeDisplay::Impl {
                 drainTouchQueue();
             }
             LOGI("X11Close: X11 request loop ended tid=%ld (recv<=0 or !running), closing client fd=%d", getTid(), clientFd);
+            shmSegments.clear();
+            gcStore.clear();
+            glxBatch.resetState();
+            {
+                /* Hand pixmap and pool memory back while no client is connected */
+                std::lock_guard<std::mutex> lock(bufferMutex);
+                const auto& ps = pixmapStore_.stats();
+                LOGI("X11Close: pixmaps live=%zu %zuKB pooled=%zuKB peak=%zuKB pool hits=%zu misses=%zu",
+                     ps.pixmaps, ps.liveBytes / 1024, ps.pooledBytes / 1024, ps.peakBytes / 1024,
+                     ps.poolHits, ps.poolMisses);
+                pixmapStore_.clear();
+            }
             if (clientFd >= 0) {
                 close(clientFd);
                 clientFd = -1;
@@ -2213,6 +2627,7 @@ struct X11NativeDisplay::Impl {
 
     void pluginUILoop() {
         LOGI("X11Debug: pluginUI thread STARTED display=%d tid=%ld", displayNumber_, getTid());
+        applyThreadRole(ThreadRole::Display);
         int loopCount = 0;
         while (pluginUIRunning) {
             auto loopStart = std::chrono::steady_clock::now();
@@ -2261,6 +2676,8 @@ struct X11NativeDisplay::Impl {
                 }
             }
 
+            sampleAdaptiveScale();
+
             auto loopUs = std::chrono::duration_cast<std::chrono::microseconds>(
                 std::chrono::steady_clock::now() - loopStart).count();
             if (loopUs > 20000 || loopCount % 120 == 0) {
@@ -2364,8 +2781,7 @@ bool X11NativeDisplay::attachSurface(JNIEnv* jniEnv, jobject jSurface, int width
         return false;
     }
 
-    const EGLint ctxAttribs[] = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE };
-    EGLContext ctx = eglCreateContext(display, config, EGL_NO_CONTEXT, ctxAttribs);
+    EGLContext ctx = X11RenderHub::instance().context(display, config);
     if (ctx == EGL_NO_CONTEXT) {
         LOGE("eglCreateContext failed");
         eglDestroySurface(display, eglSurf);
@@ -2377,9 +2793,23 @@ bool X11NativeDisplay::attachSurface(JNIEnv* jniEnv, jobject jSurface, int width
     impl_->window = win;
     impl_->eglDisplay = display;
     impl_->eglSurface = eglSurf;
+    impl_->eglConfig = config;
     impl_->eglContext = ctx;
+    // Zero-copy path: let the GPU sample the published slots directly when possible
+    {
+        std::unique_ptr<X11HardwareBufferStorage> storage;
+        if (X11HardwareBufferStorage::isSupported(display)) {
+            storage = std::make_unique<X11HardwareBufferStorage>(display);
+        }
+        LOGI("X11Debug: display=%d frame storage: %s", displayNumber_,
+             storage ? "AHardwareBuffer" : "texture upload");
+        impl_->frames.setStorage(storage.get());
+        impl_->hwStorage = std::move(storage);
+    }
     // Framebuffer stores X11 wire format (BGRA) directly
     impl_->framebuffer.assign((size_t)impl_->width * impl_->height, 0xFF302020);
+    impl_->resetDamageLocked(impl_->width, impl_->height);
+    impl_->publishFrameLocked();  // threads not started yet, nothing to race with
     impl_->dirty = true;
     // Note: render thread not started yet, no need to notify
 
@@ -2389,7 +2819,7 @@ bool X11NativeDisplay::attachSurface(JNIEnv* jniEnv, jobject jSurface, int width
     impl_->pluginUIRunning = true;
     impl_->renderThreadExited.store(false, std::memory_order_release);
     impl_->serverThread = std::thread(&Impl::serverLoop, impl_.get());
-    impl_->renderThread = std::thread(&Impl::renderLoop, impl_.get());
+    X11RenderHub::instance().add(impl_.get());
     impl_->pluginUIThread = std::thread(&Impl::pluginUILoop, impl_.get());
 
     for (int i = 0; i < 100 && !impl_->listening_; i++) {
@@ -2403,6 +2833,44 @@ bool X11NativeDisplay::attachSurface(JNIEnv* jniEnv, jobject jSurface, int width
     return true;
 }
 
+bool X11NativeDisplay::isServing() const {
+    return impl_->running.load() && impl_->serverThread.joinable() &&
+           !impl_->closingGracefully.load();
+}
+
+bool X11NativeDisplay::swapSurface(JNIEnv* jniEnv, jobject jSurface, int width, int height) {
+    if (!jniEnv || !jSurface || !isServing() || impl_->eglDisplay == EGL_NO_DISPLAY) return false;
+
+    ANativeWindow* win = ANativeWindow_fromSurface(jniEnv, jSurface);
+    if (!win) {
+        LOGE("swapSurface: ANativeWindow_fromSurface failed");
+        return false;
+    }
+    stopRenderThreadOnly();  // no frame may use the old surface from here on
+
+    if (impl_->eglSurface != EGL_NO_SURFACE) {
+        eglDestroySurface(impl_->eglDisplay, impl_->eglSurface);
+        impl_->eglSurface = EGL_NO_SURFACE;
+    }
+    if (impl_->window) {
+        ANativeWindow_release(impl_->window);
+        impl_->window = nullptr;
+    }
+    ANativeWindow_setBuffersGeometry(win, width > 0 ? width : 1, height > 0 ? height : 1, 1);
+    EGLSurface eglSurf = eglCreateWindowSurface(impl_->eglDisplay, impl_->eglConfig, win, nullptr);
+    if (eglSurf == EGL_NO_SURFACE) {
+        LOGE("swapSurface: eglCreateWindowSurface failed display=%d", displayNumber_);
+        ANativeWindow_release(win);
+        return false;
+    }
+    impl_->window = win;
+    impl_->eglSurface = eglSurf;
+    setSurfaceSize(width, height);
+    startRenderThread();  // sends Expose to every window
+    LOGI("Display %d reattached warm %dx%d", displayNumber_, width, height);
+    return true;
+}
+
 bool X11NativeDisplay::signalDetach() {
     /* Graceful teardown strategy:
      * 1. Mark connection as "closing" instead of hard close
@@ -2433,8 +2901,9 @@ bool X11NativeDisplay::signalDetach() {
          displayNumber_, getTid(), impl_->clientFd);
     
     // Mark as closing gracefully - server thread will handle the rest
-    impl_->closingGracefully.store(true);
     impl_->closeStartTime = std::chrono::steady_clock::now();
+    impl_->closingGracefully.store(true);
+    impl_->wakeServerLoop();
     
     // Keep running=true so server thread can process graceful teardown
     // The server loop will check closingGracefully and send DestroyNotify
@@ -2443,61 +2912,45 @@ bool X11NativeDisplay::signalDetach() {
 }
 
 void X11NativeDisplay::stopRenderThreadOnly() {
-    LOGI("X11Debug: stopRenderThreadOnly display=%d tid=%ld (stopping render thread and waiting for exit)", displayNumber_, getTid());
+    LOGI("X11Debug: stopRenderThreadOnly display=%d tid=%ld (stopping rendering and waiting for frame)", displayNumber_, getTid());
 
-    // Signal render thread to stop using the separate renderThreadRunning flag
-    // This keeps the X11 server thread running (using 'running' flag)
+    // Stop drawing this display; the X11 server thread keeps running (using 'running' flag).
+    // Waiting for a frame in progress prevents the "pthread_mutex_lock on destroyed mutex"
+    // crash by ensuring no EGL operations are in progress when the surface is destroyed.
+    std::lock_guard<std::mutex> guard(impl_->renderExitMutex);
     impl_->renderThreadRunning = false;
-    impl_->dirtyCv.notify_all();  // Wake up render thread if waiting on dirty condition
-
-    // Wait for render thread to actually exit with timeout
-    // This prevents the "pthread_mutex_lock on destroyed mutex" crash by ensuring
-    // no EGL operations are in progress when the surface is destroyed
-    if (impl_->renderThread.joinable()) {
-        LOGI("X11Debug: stopRenderThreadOnly display=%d waiting for render thread to exit...", displayNumber_);
-        std::unique_lock<std::mutex> lock(impl_->renderExitMutex);
-        bool exited = impl_->renderExitCv.wait_for(lock, std::chrono::milliseconds(500), [this]() {
-            return impl_->renderThreadExited.load(std::memory_order_acquire);
-        });
-        if (exited) {
-            LOGI("X11Debug: stopRenderThreadOnly display=%d render thread exited cleanly", displayNumber_);
-        } else {
-            LOGW("X11Debug: stopRenderThreadOnly display=%d timeout waiting for render thread exit", displayNumber_);
-        }
+    if (X11RenderHub::instance().remove(impl_.get())) {
+        LOGI("X11Debug: stopRenderThreadOnly display=%d rendering stopped cleanly", displayNumber_);
+    } else {
+        LOGW("X11Debug: stopRenderThreadOnly display=%d timeout waiting for frame in progress", displayNumber_);
     }
+    impl_->renderThreadExited.store(true, std::memory_order_release);
 }
 
 void X11NativeDisplay::startRenderThread() {
     // Serialize to prevent concurrent starts (e.g. resumeX11Display + requestFrame).
     std::lock_guard<std::mutex> guard(impl_->renderExitMutex);
-    LOGI("X11Debug: startRenderThread display=%d tid=%ld (restarting render thread)", displayNumber_, getTid());
+    LOGI("X11Debug: startRenderThread display=%d tid=%ld (resuming rendering)", displayNumber_, getTid());
 
-    // Check if render thread is already running
-    if (impl_->renderThread.joinable() && !impl_->renderThreadExited.load(std::memory_order_acquire)) {
-        LOGI("X11Debug: startRenderThread display=%d render thread already running", displayNumber_);
+    // Check if the display is already being drawn
+    if (!impl_->renderThreadExited.load(std::memory_order_acquire)) {
+        LOGI("X11Debug: startRenderThread display=%d already rendering", displayNumber_);
         // Just make sure running flags are set and request a frame
         impl_->renderThreadRunning = true;
         impl_->dirty = true;
-        impl_->dirtyCv.notify_all();
+        impl_->wakeRenderThread();
         return;
     }
 
-    // If thread has exited, we need to join it first before creating a new one
-    if (impl_->renderThread.joinable() && impl_->renderThreadExited.load(std::memory_order_acquire)) {
-        LOGI("X11Debug: startRenderThread display=%d joining exited render thread", displayNumber_);
-        impl_->renderThread.join();
-    }
-
-    // Reset the exit flag and start a new render thread
+    // Reset the exit flag and hand the display back to the render hub
     impl_->renderThreadExited.store(false, std::memory_order_release);
     impl_->renderThreadRunning = true;
+    impl_->pacer.noteInput(nowNs());
     impl_->dirty = true;
 
-    LOGI("X11Debug: startRenderThread display=%d starting new render thread, eglSurface=%p",
+    LOGI("X11Debug: startRenderThread display=%d resuming, eglSurface=%p",
          displayNumber_, (void*)impl_->eglSurface);
-    impl_->renderThread = std::thread(&Impl::renderLoop, impl_.get());
-
-    LOGI("X11Debug: startRenderThread display=%d render thread restarted", displayNumber_);
+    X11RenderHub::instance().add(impl_.get());
 
     // Send Expose events to all known windows to force a full redraw.
     // Without this, after hide/resume the plugin only redraws areas that receive
@@ -2534,16 +2987,23 @@ void X11NativeDisplay::detachSurface() {
         impl_->serverThread.join();
         LOGI("X11Debug: detachSurface display=%d serverThread joined", displayNumber_);
     }
-    if (impl_->renderThread.joinable()) {
-        LOGI("X11Debug: detachSurface display=%d joining renderThread...", displayNumber_);
-        impl_->renderThread.join();
-        LOGI("X11Debug: detachSurface display=%d renderThread joined", displayNumber_);
+    {
+        std::lock_guard<std::mutex> guard(impl_->renderExitMutex);
+        impl_->renderThreadRunning = false;
+        if (!X11RenderHub::instance().remove(impl_.get())) {
+            LOGW("X11Debug: detachSurface display=%d timeout waiting for frame in progress", displayNumber_);
+        }
+        impl_->renderThreadExited.store(true, std::memory_order_release);
     }
     if (impl_->window) {
         ANativeWindow_release(impl_->window);
         impl_->window = nullptr;
     }
-    impl_->framebuffer.clear();
+    {
+        std::lock_guard<std::mutex> lock(impl_->bufferMutex);
+        impl_->framebuffer.clear();
+        impl_->readback.invalidate();
+    }
     /* Close the file descriptors AFTER threads have joined/exited.
      * This avoids the fdsan "double close" issue when signalDetach runs
      * on a different thread than the server thread. */
@@ -2570,15 +3030,17 @@ void X11NativeDisplay::setSurfaceSize(int width, int height) {
             int fh = impl_->pluginHeight > 0 ? impl_->pluginHeight : height;
             uint32_t bgX11 = 0xFF302020;
             impl_->framebuffer.assign((size_t)fw * fh, bgX11);
+            impl_->resetDamageLocked(fw, fh);
+            impl_->publishFrameLocked();
         }
         impl_->dirty = true;
-        impl_->dirtyCv.notify_one();  // Wake render thread to re-render at new size
+        impl_->wakeRenderThread();  // Wake render thread to re-render at new size
         if (impl_->window)
             ANativeWindow_setBuffersGeometry(impl_->window, width, height, 1);
     }
 }
 
-void X11NativeDisplay::injectTouch(int action, int x, int y) {
+void X11NativeDisplay::injectTouch(int action, int x, int y, int64_t timeNs) {
     static int touchLogCount = 0;
     const int n = ++touchLogCount;
     const char* actionName = (action == 0) ? "DOWN" : (action == 1) ? "UP" : "MOVE";
@@ -2605,15 +3067,21 @@ void X11NativeDisplay::injectTouch(int action, int x, int y) {
      * be accessed from one thread (the server thread). Sending events directly
      * from the UI thread (via JNI) while the server thread is handling requests
      * causes the threading violation that crashes the app. */
+    const int64_t now = nowNs();
+    if (timeNs <= 0 || timeNs > now) timeNs = now;
     {
         std::lock_guard<std::mutex> lock(impl_->touchQueueMutex);
-        if (action == 2 && !impl_->touchQueue.empty() && impl_->touchQueue.back().action == 2) {
-            impl_->touchQueue.back().x = x;
-            impl_->touchQueue.back().y = y;
+        // Moves are kept one by one for the velocity estimate, unless the server thread is
+        // far behind and the queue is all moves anyway
+        if (action == 2 && impl_->touchQueue.size() >= kMaxQueuedTouches &&
+            impl_->touchQueue.back().action == 2) {
+            impl_->touchQueue.back() = {action, x, y, timeNs};
         } else {
-            impl_->touchQueue.push_back({action, x, y});
+            impl_->touchQueue.push_back({action, x, y, timeNs});
         }
     }
+    impl_->pacer.noteInput(now);
+    impl_->wakeServerLoop();
     if (n <= 80 || n % 50 == 0) {
         LOGI("injectTouch: queued action=%s (%d) at (%d,%d) for server thread", actionName, action, x, y);
     }
@@ -2665,8 +3133,9 @@ void X11NativeDisplay::requestFrame() {
             startRenderThread();
             return;  // startRenderThread sets dirty=true
         }
+        impl_->pacer.noteInput(nowNs());
         impl_->dirty = true;
-        impl_->dirtyCv.notify_one();
+        impl_->wakeRenderThread();
     }
 }
 
@@ -2724,6 +3193,22 @@ float X11NativeDisplay::getUIScale() const {
     return impl_->uiScale;
 }
 
+void X11NativeDisplay::setAdaptiveUIScale(bool enabled) {
+    impl_->adaptiveScaleEnabled.store(enabled, std::memory_order_relaxed);
+    LOGI("X11NativeDisplay: setAdaptiveUIScale(%d) for display=%d", enabled ? 1 : 0, displayNumber_);
+}
+
+void setX11LoadSource(std::function<float()> source) {
+    std::lock_guard<std::mutex> lock(g_loadSourceMutex);
+    g_loadSource = std::move(source);
+}
+
+void setX11FrameRateCap(double hz) {
+    g_frameRateCapHz.store(hz, std::memory_order_relaxed);
+    LOGI("X11NativeDisplay: frame rate cap %.0f Hz", hz);
+    X11RenderHub::instance().wake();
+}
+
 X11NativeDisplay* getOrCreateX11Display(int displayNumber) {
     std::lock_guard<std::mutex> lock(g_displayMutex);
     auto it = g_displays.find(displayNumber);
@@ -2753,11 +3238,11 @@ void withDisplayRequestFrame(int displayNumber) {
         it->second->requestFrame();
 }
 
-void withDisplayInjectTouch(int displayNumber, int action, int x, int y) {
+void withDisplayInjectTouch(int displayNumber, int action, int x, int y, int64_t timeNs) {
     std::lock_guard<std::mutex> lock(g_displayMutex);
     auto it = g_displays.find(displayNumber);
     if (it != g_displays.end())
-        it->second->injectTouch(action, x, y);
+        it->second->injectTouch(action, x, y, timeNs);
 }
 
 void withDisplaySetSurfaceSize(int displayNumber, int width, int height) {
@@ -2783,6 +3268,13 @@ float withDisplayGetUIScale(int displayNumber) {
     return 1.0f;
 }
 
+void withDisplaySetAdaptiveUIScale(int displayNumber, bool enabled) {
+    std::lock_guard<std::mutex> lock(g_displayMutex);
+    auto it = g_displays.find(displayNumber);
+    if (it != g_displays.end())
+        it->second->setAdaptiveUIScale(enabled);
+}
+
 bool withDisplayIsWidgetAtPoint(int displayNumber, int x, int y) {
     std::lock_guard<std::mutex> lock(g_displayMutex);
     auto it = g_displays.find(displayNumber);
@@ -49,17 +49,26 @@ public:
     /** Detach surface and stop X server. */
     void detachSurface();
 
+    /** True while the X server of this display is running (attached and not tearing down),
+     *  so a plugin UI connected to it can be kept warm across surface changes. */
+    bool isServing() const;
+
+    /** Move a serving display to a new Surface: the old EGL surface and window are dropped,
+     *  the X server, client connection and plugin UI are kept, and every window gets an
+     *  Expose. This is how a warm (hidden) UI is reopened without instantiating it again. */
+    bool swapSurface(JNIEnv* env, jobject surface, int width, int height);
+
     /** Signal threads to exit without joining (call from view destroy callback to avoid blocking).
      * Returns true if the detach was deferred (e.g., plugin creation in progress), false if executed immediately. */
     bool signalDetach();
 
-    /** Stop only the render thread and wait for it to exit. Use when surface is destroyed but we must
-     * not close the X fd yet (plugin may still be in XGetWindowAttributes). Avoids eglSwapBuffers
-     * on a destroyed surface and avoids EGL teardown that can crash HWUI.
-     * This method blocks until the render thread has fully exited. */
+    /** Stop only rendering of this display (the shared render thread, X11RenderHub, keeps serving
+     * the others). Use when surface is destroyed but we must not close the X fd yet (plugin may
+     * still be in XGetWindowAttributes). Avoids eglSwapBuffers on a destroyed surface and avoids
+     * EGL teardown that can crash HWUI. Blocks until a frame of this display in progress is done. */
     void stopRenderThreadOnly();
 
-    /** Start/restart the render thread. Call this after stopRenderThreadOnly() to resume rendering.
+    /** Resume rendering of this display. Call this after stopRenderThreadOnly() to resume rendering.
      * Used when switching back to X11 UI mode after hiding the display. */
     void startRenderThread();
 
@@ -69,8 +78,9 @@ public:
     /** Root window ID for XCreateWindow parent (e.g. plugin UI). */
     unsigned long getRootWindowId() const { return rootWindowId_; }
 
-    /** Inject pointer event: action (0=down, 1=up, 2=move), x, y in view coordinates. */
-    void injectTouch(int action, int x, int y);
+    /** Inject pointer event: action (0=down, 1=up, 2=move), x, y in view coordinates.
+     *  timeNs is the CLOCK_MONOTONIC time of the sample (MotionEvent time); 0 means now. */
+    void injectTouch(int action, int x, int y, int64_t timeNs = 0);
 
     /** Hit-test: returns true if (surfaceX, surfaceY) hits an X11 widget (knob, slider, etc.)
      *  rather than the plugin background. Thread-safe (called from Android UI thread). */
@@ -104,6 +114,14 @@ public:
     /** Get the current UI scale factor. */
     float getUIScale() const;
 
+    /**
+     * Adaptive mode: while a plugin UI is shown, lower its render resolution below
+     * getUIScale() when audio load (setX11LoadSource) stays high or the device heats up,
+     * and restore it when load is light. The plugin window is resized with
+     * ConfigureNotify/Expose; touch mapping and display scaling follow the new size.
+     */
+    void setAdaptiveUIScale(bool enabled);
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -120,12 +138,18 @@ void destroyX11Display(int displayNumber);
 
 /** Call display methods while holding the display map lock (avoids TOCTOU use-after-free). */
 void withDisplayRequestFrame(int displayNumber);
-void withDisplayInjectTouch(int displayNumber, int action, int x, int y);
+void withDisplayInjectTouch(int displayNumber, int action, int x, int y, int64_t timeNs = 0);
 void withDisplaySetSurfaceSize(int displayNumber, int width, int height);
 /** Returns true and fills w/h if plugin natural size is known; false if not yet set. */
 bool withDisplayGetPluginSize(int displayNumber, int& w, int& h);
 /** Returns the UI scale factor for the given display (1.0 = no scaling). */
 float withDisplayGetUIScale(int displayNumber);
+/** Enable or disable adaptive UI scale for the given display. */
+void withDisplaySetAdaptiveUIScale(int displayNumber, bool enabled);
+/** Audio load (0..1 of the callback deadline) sampled by displays in adaptive UI scale mode. */
+void setX11LoadSource(std::function<float()> source);
+/** Cap every display's UI frame rate at 'hz' (0 = no cap); the audio engine's load shedding. */
+void setX11FrameRateCap(double hz);
 /** Hit-test: returns true if (x, y) hits an X11 widget rather than plugin background. */
 bool withDisplayIsWidgetAtPoint(int displayNumber, int x, int y);
 /** Post a task to the display's plugin UI thread while holding the display map lock (avoids TOCTOU). */
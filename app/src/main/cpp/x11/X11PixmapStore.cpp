@@ -18,29 +18,107 @@
  */
 
 #include "X11PixmapStore.h"
+#include <algorithm>
 
 namespace guitarrackcraft {
 
+X11PixmapStore::~X11PixmapStore() = default;
+
+size_t X11PixmapStore::sizeClass(size_t count) {
+    if (count <= 64) return 64;
+    // Four classes per power of two bounds the slack to 25%
+    size_t pow2 = 64;
+    while (pow2 * 2 < count) pow2 *= 2;
+    size_t step = pow2 / 4;
+    return (count + step - 1) / step * step;
+}
+
 void X11PixmapStore::create(uint32_t pid, int w, int h, uint32_t fillColor) {
+    auto existing = pixmaps_.find(pid);
+    if (existing != pixmaps_.end()) {
+        release(existing->second.pixels);
+        pixmaps_.erase(existing);
+    }
+
     PixmapData pm;
     pm.w = w;
     pm.h = h;
-    pm.pixels.assign((size_t)w * h, fillColor);
+    size_t count = (w > 0 && h > 0) ? (size_t)w * h : 0;
+    if (count > 0) {
+        size_t cap = sizeClass(count);
+        auto it = pool_.find(cap);
+        if (it != pool_.end() && !it->second.empty()) {
+            pm.pixels.buf_ = std::move(it->second.back());
+            it->second.pop_back();
+            stats_.pooledBytes -= cap * 4;
+            stats_.poolHits++;
+        } else {
+            pm.pixels.buf_.reset(new uint32_t[cap]);  // default-init: no clearing
+            stats_.poolMisses++;
+        }
+        pm.pixels.capacity_ = cap;
+        stats_.liveBytes += cap * 4;
+    }
+    pm.pixels.size_ = count;
+    pm.fillPending = count > 0;
+    pm.fillColor = fillColor;
     pixmaps_[pid] = std::move(pm);
+    stats_.pixmaps = pixmaps_.size();
+    stats_.peakBytes = std::max(stats_.peakBytes, stats_.liveBytes + stats_.pooledBytes);
+}
+
+void X11PixmapStore::release(PixmapPixels& px) {
+    if (!px.buf_) return;
+    size_t bytes = px.capacity_ * 4;
+    stats_.liveBytes -= bytes;
+    if (stats_.pooledBytes + bytes <= kMaxPooledBytes) {
+        pool_[px.capacity_].push_back(std::move(px.buf_));
+        stats_.pooledBytes += bytes;
+    }
+    px.buf_.reset();
+    px.size_ = px.capacity_ = 0;
 }
 
 void X11PixmapStore::destroy(uint32_t pid) {
-    pixmaps_.erase(pid);
+    auto it = pixmaps_.find(pid);
+    if (it == pixmaps_.end()) return;
+    release(it->second.pixels);
+    pixmaps_.erase(it);
+    stats_.pixmaps = pixmaps_.size();
+}
+
+void X11PixmapStore::fillIfPending(const PixmapData& pm) {
+    if (!pm.fillPending) return;
+    // Logically const: the fill only realises the contents the pixmap already has
+    auto& m = const_cast<PixmapData&>(pm);
+    std::fill(m.pixels.begin(), m.pixels.end(), m.fillColor);
+    m.fillPending = false;
 }
 
 PixmapData* X11PixmapStore::get(uint32_t pid) {
     auto it = pixmaps_.find(pid);
-    return (it != pixmaps_.end()) ? &it->second : nullptr;
+    if (it == pixmaps_.end()) return nullptr;
+    fillIfPending(it->second);
+    return &it->second;
 }
 
 const PixmapData* X11PixmapStore::get(uint32_t pid) const {
     auto it = pixmaps_.find(pid);
-    return (it != pixmaps_.end()) ? &it->second : nullptr;
+    if (it == pixmaps_.end()) return nullptr;
+    fillIfPending(it->second);
+    return &it->second;
+}
+
+PixmapData* X11PixmapStore::getForWrite(uint32_t pid, int x, int y, int w, int h) {
+    auto it = pixmaps_.find(pid);
+    if (it == pixmaps_.end()) return nullptr;
+    PixmapData& pm = it->second;
+    if (x <= 0 && y <= 0 && x + w >= pm.w && y + h >= pm.h) {
+        pm.fillPending = false;
+    } else {
+        fillIfPending(pm);
+    }
+    return &pm;
 }
 
 bool X11PixmapStore::exists(uint32_t pid) const {
@@ -49,6 +127,10 @@ bool X11PixmapStore::exists(uint32_t pid) const {
 
 void X11PixmapStore::clear() {
     pixmaps_.clear();
+    pool_.clear();
+    size_t peak = stats_.peakBytes;
+    stats_ = MemoryStats{};
+    stats_.peakBytes = peak;
 }
 
 } // namespace guitarrackcraft
@@ -19,28 +19,94 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
 namespace guitarrackcraft {
 
+/**
+ * Pixel storage of one pixmap. The block comes from X11PixmapStore's size-class pool, so
+ * its capacity may exceed size(), and it is not initialised until first use.
+ */
+class PixmapPixels {
+public:
+    uint32_t* data() { return buf_.get(); }
+    const uint32_t* data() const { return buf_.get(); }
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    uint32_t& operator[](size_t i) { return buf_[i]; }
+    const uint32_t& operator[](size_t i) const { return buf_[i]; }
+    uint32_t* begin() { return buf_.get(); }
+    uint32_t* end() { return buf_.get() + size_; }
+    const uint32_t* begin() const { return buf_.get(); }
+    const uint32_t* end() const { return buf_.get() + size_; }
+
+private:
+    friend class X11PixmapStore;
+    std::unique_ptr<uint32_t[]> buf_;
+    size_t size_ = 0, capacity_ = 0;
+};
+
 struct PixmapData {
     int w = 0, h = 0;
-    std::vector<uint32_t> pixels;
+    PixmapPixels pixels;
+
+private:
+    friend class X11PixmapStore;
+    bool fillPending = false;  // pixels not yet written; fill with fillColor before use
+    uint32_t fillColor = 0;
 };
 
+/**
+ * Server-side pixmaps of one display. Cairo UIs create and free back-buffer pixmaps at a
+ * high rate during knob drags, so freed storage goes back to a pool of size classes
+ * (four per power of two) and is reused by the next pixmap of a similar size. New
+ * pixmaps are filled lazily: get() fills before handing the pixels out, while
+ * getForWrite() skips the fill when the caller is about to overwrite the whole pixmap.
+ */
 class X11PixmapStore {
 public:
+    /** Freed storage kept for reuse; beyond this, blocks go back to the allocator. */
+    static constexpr size_t kMaxPooledBytes = 32u * 1024 * 1024;
+
+    struct MemoryStats {
+        size_t pixmaps = 0;
+        size_t liveBytes = 0;     // capacity of live pixmaps
+        size_t pooledBytes = 0;   // freed storage held for reuse
+        size_t peakBytes = 0;     // high-water mark of live + pooled
+        size_t poolHits = 0, poolMisses = 0;
+    };
+
+    ~X11PixmapStore();
+
     void create(uint32_t pid, int w, int h, uint32_t fillColor = 0xFF302020);
     void destroy(uint32_t pid);
     PixmapData* get(uint32_t pid);
     const PixmapData* get(uint32_t pid) const;
+    /**
+     * Like get(), but when the w*h rect at (x, y) covers the whole pixmap the pending
+     * fill is dropped instead of performed: the caller must then write every pixel.
+     */
+    PixmapData* getForWrite(uint32_t pid, int x, int y, int w, int h);
     bool exists(uint32_t pid) const;
+    /** Drop all pixmaps and release the pool (client disconnected). */
     void clear();
 
+    const MemoryStats& stats() const { return stats_; }
+
+    /** Pixel capacity of the size class holding count pixels. */
+    static size_t sizeClass(size_t count);
+
 private:
+    void release(PixmapPixels& px);
+    static void fillIfPending(const PixmapData& pm);
+
     std::unordered_map<uint32_t, PixmapData> pixmaps_;
+    std::unordered_map<size_t, std::vector<std::unique_ptr<uint32_t[]>>> pool_;
+    MemoryStats stats_;
 };
 
 } // namespace guitarrackcraft
@@ -22,24 +22,125 @@
 
 namespace guitarrackcraft {
 
+namespace {
+
+constexpr uint32_t kInitialSlots = 64;
+
+} // namespace
+
+X11PropertyStore::X11PropertyStore()
+    : slots_(kInitialSlots)
+{
+}
+
+uint32_t X11PropertyStore::hashWindow(uint32_t window) {
+    // Resource ids are client base | small counter; mix so consecutive ids spread
+    window ^= window >> 16;
+    window *= 0x7feb352du;
+    window ^= window >> 15;
+    window *= 0x846ca68bu;
+    window ^= window >> 16;
+    return window;
+}
+
+uint32_t X11PropertyStore::probe(uint32_t window) const {
+    const uint32_t mask = static_cast<uint32_t>(slots_.size()) - 1;
+    uint32_t i = hashWindow(window) & mask;
+    while (slots_[i].window != 0 && slots_[i].window != window) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+std::vector<X11PropertyStore::Entry>* X11PropertyStore::findWindow(uint32_t window) {
+    const Slot& s = slots_[probe(window)];
+    return s.window != 0 ? &windows_[s.index] : nullptr;
+}
+
+const std::vector<X11PropertyStore::Entry>* X11PropertyStore::findWindow(uint32_t window) const {
+    const Slot& s = slots_[probe(window)];
+    return s.window != 0 ? &windows_[s.index] : nullptr;
+}
+
+std::vector<X11PropertyStore::Entry>& X11PropertyStore::addWindow(uint32_t window) {
+    uint32_t slot = probe(window);
+    if (slots_[slot].window != 0) return windows_[slots_[slot].index];
+
+    if ((windowCount_ + 1) * 2 > slots_.size()) {
+        grow();
+        slot = probe(window);
+    }
+    uint32_t index;
+    if (!freeWindows_.empty()) {
+        index = freeWindows_.back();
+        freeWindows_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(windows_.size());
+        windows_.emplace_back();
+    }
+    slots_[slot] = {window, index};
+    ++windowCount_;
+    return windows_[index];
+}
+
+void X11PropertyStore::eraseSlot(uint32_t slot) {
+    // Backward-shift deletion: pull later entries of the probe run into the hole so lookups
+    // never need tombstones
+    const uint32_t mask = static_cast<uint32_t>(slots_.size()) - 1;
+    auto& props = windows_[slots_[slot].index];
+    props.clear();  // keeps capacity for reuse
+    freeWindows_.push_back(slots_[slot].index);
+    --windowCount_;
+
+    uint32_t hole = slot;
+    for (uint32_t j = (hole + 1) & mask; slots_[j].window != 0; j = (j + 1) & mask) {
+        const uint32_t home = hashWindow(slots_[j].window) & mask;
+        // Move j into the hole unless its home lies cyclically in (hole, j]
+        const bool homeBetween = hole <= j ? (home > hole && home <= j)
+                                           : (home > hole || home <= j);
+        if (!homeBetween) {
+            slots_[hole] = slots_[j];
+            hole = j;
+        }
+    }
+    slots_[hole] = Slot{};
+}
+
+void X11PropertyStore::grow() {
+    std::vector<Slot> old(slots_.size() * 2);
+    old.swap(slots_);
+    const uint32_t mask = static_cast<uint32_t>(slots_.size()) - 1;
+    for (const Slot& s : old) {
+        if (s.window == 0) continue;
+        uint32_t i = hashWindow(s.window) & mask;
+        while (slots_[i].window != 0) i = (i + 1) & mask;
+        slots_[i] = s;
+    }
+}
+
 void X11PropertyStore::change(uint32_t window, uint32_t property, uint32_t type,
                                uint8_t format, uint8_t mode, const uint8_t* data,
                                uint32_t numElements) {
     if (format != 8 && format != 16 && format != 32) return;
+    if (window == 0) return;
     size_t elementBytes = format / 8;
     size_t dataBytes = (size_t)numElements * elementBytes;
 
-    auto& windowProps = store_[window];
-    auto& prop = windowProps[property];
+    auto& windowProps = addWindow(window);
+    auto it = std::find_if(windowProps.begin(), windowProps.end(),
+                           [property](const Entry& e) { return e.atom == property; });
+    if (it == windowProps.end()) {
+        windowProps.push_back({property, {}});
+        it = windowProps.end() - 1;
+    }
+    auto& prop = it->prop;
 
     if (mode == ModeReplace || prop.format == 0) {
         prop.type = type;
         prop.format = format;
         prop.data.assign(data, data + dataBytes);
     } else if (mode == ModePrepend && prop.format == format) {
-        std::vector<uint8_t> newData(data, data + dataBytes);
-        newData.insert(newData.end(), prop.data.begin(), prop.data.end());
-        prop.data = std::move(newData);
+        prop.data.insert(prop.data.begin(), data, data + dataBytes);
         prop.type = type;
     } else if (mode == ModeAppend && prop.format == format) {
         prop.data.insert(prop.data.end(), data, data + dataBytes);
@@ -51,13 +152,14 @@ X11PropertyStore::Property X11PropertyStore::get(uint32_t window, uint32_t prope
                                                   uint32_t reqType, uint32_t offset,
                                                   uint32_t maxLen, uint32_t& bytesAfter) const {
     bytesAfter = 0;
-    auto winIt = store_.find(window);
-    if (winIt == store_.end()) return {};
+    const auto* windowProps = findWindow(window);
+    if (!windowProps) return {};
 
-    auto propIt = winIt->second.find(property);
-    if (propIt == winIt->second.end()) return {};
+    auto propIt = std::find_if(windowProps->begin(), windowProps->end(),
+                               [property](const Entry& e) { return e.atom == property; });
+    if (propIt == windowProps->end()) return {};
 
-    const auto& prop = propIt->second;
+    const auto& prop = propIt->prop;
 
     // If reqType is specified and doesn't match, return type info but no data
     if (reqType != 0 && reqType != prop.type) {
@@ -95,19 +197,23 @@ X11PropertyStore::Property X11PropertyStore::get(uint32_t window, uint32_t prope
 }
 
 void X11PropertyStore::remove(uint32_t window, uint32_t property) {
-    auto winIt = store_.find(window);
-    if (winIt != store_.end()) {
-        winIt->second.erase(property);
-        if (winIt->second.empty()) store_.erase(winIt);
-    }
+    const uint32_t slot = probe(window);
+    if (slots_[slot].window == 0) return;
+    auto& windowProps = windows_[slots_[slot].index];
+    auto it = std::find_if(windowProps.begin(), windowProps.end(),
+                           [property](const Entry& e) { return e.atom == property; });
+    if (it == windowProps.end()) return;
+    if (it != windowProps.end() - 1) std::swap(*it, windowProps.back());
+    windowProps.pop_back();
+    if (windowProps.empty()) eraseSlot(slot);
 }
 
 std::vector<uint32_t> X11PropertyStore::list(uint32_t window) const {
     std::vector<uint32_t> atoms;
-    auto winIt = store_.find(window);
-    if (winIt != store_.end()) {
-        for (auto& [atom, _] : winIt->second) {
-            atoms.push_back(atom);
+    if (const auto* windowProps = findWindow(window)) {
+        atoms.reserve(windowProps->size());
+        for (const auto& e : *windowProps) {
+            atoms.push_back(e.atom);
         }
         std::sort(atoms.begin(), atoms.end());
     }
@@ -115,11 +221,18 @@ std::vector<uint32_t> X11PropertyStore::list(uint32_t window) const {
 }
 
 void X11PropertyStore::clearWindow(uint32_t window) {
-    store_.erase(window);
+    const uint32_t slot = probe(window);
+    if (slots_[slot].window != 0) eraseSlot(slot);
 }
 
 void X11PropertyStore::clear() {
-    store_.clear();
+    std::fill(slots_.begin(), slots_.end(), Slot{});
+    freeWindows_.clear();
+    for (uint32_t i = 0; i < windows_.size(); ++i) {
+        windows_[i].clear();
+        freeWindows_.push_back(i);
+    }
+    windowCount_ = 0;
 }
 
 } // namespace guitarrackcraft
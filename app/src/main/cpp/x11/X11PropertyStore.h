@@ -20,11 +20,18 @@
 #pragma once
 
 #include <cstdint>
-#include <unordered_map>
 #include <vector>
 
 namespace guitarrackcraft {
 
+/**
+ * Window properties for one client connection.
+ *
+ * Windows are found through a flat open-addressing table (linear probing, backward-shift
+ * deletion) and keep their properties in a small per-window vector that is scanned linearly;
+ * a window rarely carries more than a dozen. Cleared windows return their vector to a free list
+ * so a UI that keeps recreating popups does not reallocate.
+ */
 class X11PropertyStore {
 public:
     struct Property {
@@ -38,6 +45,8 @@ public:
     static constexpr uint8_t ModePrepend = 1;
     static constexpr uint8_t ModeAppend = 2;
 
+    X11PropertyStore();
+
     // ChangeProperty: set/prepend/append property data on a window.
     // numElements is the count of format-sized elements (not bytes).
     void change(uint32_t window, uint32_t property, uint32_t type,
@@ -63,8 +72,28 @@ public:
     void clear();
 
 private:
-    // window -> (property atom -> Property)
-    std::unordered_map<uint32_t, std::unordered_map<uint32_t, Property>> store_;
+    struct Entry {
+        uint32_t atom = 0;
+        Property prop;
+    };
+    struct Slot {
+        uint32_t window = 0;  // 0 = empty (None is never a window)
+        uint32_t index = 0;   // into windows_
+    };
+
+    static uint32_t hashWindow(uint32_t window);
+    /** Slot holding window, or the empty slot where the probe stopped. */
+    uint32_t probe(uint32_t window) const;
+    std::vector<Entry>* findWindow(uint32_t window);
+    const std::vector<Entry>* findWindow(uint32_t window) const;
+    std::vector<Entry>& addWindow(uint32_t window);
+    void eraseSlot(uint32_t slot);
+    void grow();
+
+    std::vector<Slot> slots_;                 // power-of-2 size, load factor <= 0.5
+    std::vector<std::vector<Entry>> windows_; // per-window properties, reused via freeWindows_
+    std::vector<uint32_t> freeWindows_;
+    uint32_t windowCount_ = 0;
 };
 
 } // namespace guitarrackcraft
@@ -60,8 +60,25 @@ namespace X11Op {
     static constexpr uint8_t QueryExtension = 98;
     static constexpr uint8_t ListExtensions = 99;
     static constexpr uint8_t kGLXMajorOpcode = 128;
+    static constexpr uint8_t kShmMajorOpcode = 129;
+    static constexpr uint8_t kBigRequestsMajorOpcode = 130;
 } // namespace X11Op
 
+// BIG-REQUESTS: BigReqEnable (minor 0) reply advertises this maximum, in 4-byte units
+static constexpr uint32_t kBigRequestsMaxLength = 4 * 1024 * 1024;  // 16 MiB
+
+// MIT-SHM extension (segments come from X11ShmRegistry, shared in-process)
+namespace X11Shm {
+    static constexpr uint8_t kFirstEvent = 64;   // ShmCompletion
+    static constexpr uint8_t kFirstError = 128;  // BadShmSeg
+    static constexpr uint8_t QueryVersion = 0;
+    static constexpr uint8_t Attach = 1;
+    static constexpr uint8_t Detach = 2;
+    static constexpr uint8_t PutImage = 3;
+    static constexpr uint8_t GetImage = 4;
+    static constexpr uint8_t CreatePixmap = 5;
+} // namespace X11Shm
+
 // X11 event types
 namespace X11Event {
     static constexpr uint8_t ButtonPress = 4;
@@ -113,6 +130,8 @@ inline const char* x11OpcodeName(uint8_t op) {
         case X11Op::QueryExtension: return "QueryExtension";
         case X11Op::ListExtensions: return "ListExtensions";
         case X11Op::kGLXMajorOpcode: return "GLX";
+        case X11Op::kShmMajorOpcode: return "MIT-SHM";
+        case X11Op::kBigRequestsMajorOpcode: return "BIG-REQUESTS";
         default: return "?";
     }
 }
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "X11ReadbackCache.h"
+
+namespace guitarrackcraft {
+
+bool X11ReadbackCache::matches(uint32_t drawable, int x, int y, int w, int h, int fbW, int fbH) const {
+    return valid_ && drawable == drawable_ && x == x_ && y == y_ && w == w_ && h == h_ &&
+           fbW == fbW_ && fbH == fbH_;
+}
+
+uint8_t* X11ReadbackCache::prepare(size_t size) {
+    if (buf_.size() < size) buf_.resize(size);
+    return buf_.data();
+}
+
+void X11ReadbackCache::store(uint32_t drawable, int x, int y, int w, int h, int fbW, int fbH) {
+    drawable_ = drawable;
+    x_ = x; y_ = y; w_ = w; h_ = h;
+    fbW_ = fbW; fbH_ = fbH;
+    valid_ = true;
+}
+
+void X11ReadbackCache::noteWrite(int x, int y, int w, int h) {
+    if (!valid_ || w <= 0 || h <= 0) return;
+    if (x < x_ + w_ && x + w > x_ && y < y_ + h_ && y + h > y_) valid_ = false;
+}
+
+} // namespace guitarrackcraft
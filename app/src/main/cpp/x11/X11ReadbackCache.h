@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * The last window GetImage reply, kept so an identical request can be answered without
+ * touching the framebuffer. Cairo/DPF UIs read back the same rect every frame before
+ * compositing; when no framebuffer write has touched that rect since, the cached pixels
+ * are still exact and only the sequence number in the header needs rewriting.
+ * The server calls noteWrite() for every framebuffer write and invalidate() whenever the
+ * framebuffer is replaced or resized. Server thread only, except noteWrite()/invalidate(),
+ * which callers serialise with the framebuffer mutex like the writes themselves.
+ */
+class X11ReadbackCache {
+public:
+    /** True when a reply for drawable's rect on an fbW*fbH framebuffer is cached and current. */
+    bool matches(uint32_t drawable, int x, int y, int w, int h, int fbW, int fbH) const;
+
+    /** Reply buffer of at least size bytes; invalidate() first, its contents get replaced. */
+    uint8_t* prepare(size_t size);
+
+    /** The reply now in the buffer covers drawable's rect on an fbW*fbH framebuffer. */
+    void store(uint32_t drawable, int x, int y, int w, int h, int fbW, int fbH);
+
+    /** Framebuffer pixels in the w*h rect at (x, y) changed. */
+    void noteWrite(int x, int y, int w, int h);
+    void invalidate() { valid_ = false; }
+
+    uint8_t* data() { return buf_.data(); }
+    size_t hits() const { return hits_; }
+    void countHit() { hits_++; }
+
+private:
+    std::vector<uint8_t> buf_;
+    bool valid_ = false;
+    uint32_t drawable_ = 0;
+    int x_ = 0, y_ = 0, w_ = 0, h_ = 0, fbW_ = 0, fbH_ = 0;
+    size_t hits_ = 0;
+};
+
+} // namespace guitarrackcraft
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "X11RenderHub.h"
+#include "X11Log.h"
+#include "../utils/ThreadPolicy.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <thread>
+#include <time.h>
+
+#define LOG_TAG "X11RenderHub"
+#define LOGI(...) X11_LOGI(LOG_TAG, __VA_ARGS__)
+#define LOGE(...) X11_LOGE(LOG_TAG, __VA_ARGS__)
+#define LOGW(...) X11_LOGW(LOG_TAG, __VA_ARGS__)
+
+namespace guitarrackcraft {
+
+namespace {
+
+int64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+} // namespace
+
+X11RenderHub& X11RenderHub::instance() {
+    static X11RenderHub* hub = new X11RenderHub();  // never destroyed: its thread outlives statics
+    return *hub;
+}
+
+EGLContext X11RenderHub::context(EGLDisplay display, EGLConfig config) {
+    std::lock_guard<std::mutex> lock(contextMutex_);
+    if (context_ != EGL_NO_CONTEXT) {
+        if (display != eglDisplay_) LOGE("context: display %p differs from %p", display, eglDisplay_);
+        return context_;
+    }
+    const EGLint ctxAttribs[] = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE };
+    context_ = eglCreateContext(display, config, EGL_NO_CONTEXT, ctxAttribs);
+    if (context_ != EGL_NO_CONTEXT) {
+        eglDisplay_ = display;
+        LOGI("shared render context %p created", context_);
+    }
+    return context_;
+}
+
+const X11RenderHub::BlitProgram& X11RenderHub::blitProgram() {
+    if (blit_.program) return blit_;
+    const char* vs = "attribute vec2 aPos; attribute vec2 aTex; varying vec2 vTex; void main() { gl_Position = vec4(aPos, 0, 1); vTex = aTex; }";
+    const char* fs = "precision mediump float; varying vec2 vTex; uniform sampler2D uTex; void main() { vec4 c = texture2D(uTex, vTex); gl_FragColor = vec4(c.b, c.g, c.r, 1.0); }";
+    GLuint vsId = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vsId, 1, &vs, nullptr);
+    glCompileShader(vsId);
+    GLuint fsId = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fsId, 1, &fs, nullptr);
+    glCompileShader(fsId);
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vsId);
+    glAttachShader(program, fsId);
+    glLinkProgram(program);
+    glDeleteShader(vsId);
+    glDeleteShader(fsId);
+    if (program) {
+        blit_.program = program;
+        blit_.texUniform = glGetUniformLocation(program, "uTex");
+        blit_.aPos = glGetAttribLocation(program, "aPos");
+        blit_.aTex = glGetAttribLocation(program, "aTex");
+    }
+    return blit_;
+}
+
+void X11RenderHub::add(X11RenderClient* client) {
+    bool start = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (std::find(clients_.begin(), clients_.end(), client) == clients_.end()) {
+            clients_.push_back(client);
+        }
+        start = !started_;
+        started_ = true;
+    }
+    if (start) {
+        std::thread(&X11RenderHub::loop, this).detach();
+    }
+    wake();
+}
+
+bool X11RenderHub::remove(X11RenderClient* client, int timeoutMs) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    clients_.erase(std::remove(clients_.begin(), clients_.end(), client), clients_.end());
+    return cv_.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                        [&] { return rendering_ != client; });
+}
+
+void X11RenderHub::wake() {
+    {
+        /* Taking the lock orders this wake after the waiter's predicate check */
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (looper_) ALooper_wake(looper_);
+    }
+    cv_.notify_all();
+}
+
+void X11RenderHub::onVsync(long frameTimeNanos, void* data) {
+    auto* self = static_cast<X11RenderHub*>(data);
+    self->vsyncPending_ = false;
+    self->vsyncArrived_ = true;
+    self->vsyncFrameNs_ = (int64_t)frameTimeNanos;
+}
+
+void X11RenderHub::onDelayedVsync(long frameTimeNanos, void* data) {
+    auto* self = static_cast<X11RenderHub*>(data);
+    self->delayedPending_ = false;
+    self->vsyncArrived_ = true;
+    self->vsyncFrameNs_ = (int64_t)frameTimeNanos;
+}
+
+bool X11RenderHub::anyWantsFrameLocked() const {
+    for (X11RenderClient* c : clients_) {
+        if (c->wantsFrame()) return true;
+    }
+    return false;
+}
+
+void X11RenderHub::collectDueLocked(int64_t frameTimeNs, std::vector<X11RenderClient*>& due,
+                                    int64_t& minDelayNs) {
+    minDelayNs = std::numeric_limits<int64_t>::max();
+    for (X11RenderClient* c : clients_) {
+        if (!c->wantsFrame()) continue;
+        int64_t delayNs = c->frameDelayNs(frameTimeNs);
+        if (delayNs == 0) {
+            due.push_back(c);
+        } else {
+            minDelayNs = std::min(minDelayNs, delayNs);
+        }
+    }
+}
+
+void X11RenderHub::waitForFrames(AChoreographer* choreographer, std::vector<X11RenderClient*>& due,
+                                 int64_t& frameTimeNs) {
+    due.clear();
+    if (!choreographer) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return anyWantsFrameLocked(); });
+        for (X11RenderClient* c : clients_) {
+            if (c->wantsFrame()) due.push_back(c);
+        }
+        frameTimeNs = monotonicNs();
+        return;
+    }
+    for (;;) {
+        int64_t minDelayNs;
+        if (vsyncArrived_) {
+            vsyncArrived_ = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                collectDueLocked(vsyncFrameNs_, due, minDelayNs);
+            }
+            if (!due.empty()) {
+                frameTimeNs = vsyncFrameNs_;
+                return;
+            }
+        }
+        /* Clients due now get the next vsync; paced ones a delayed callback for the
+         * earliest of them, so a throttled display does not wake this thread every vsync. */
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            collectDueLocked(monotonicNs(), due, minDelayNs);
+        }
+        bool anyDue = !due.empty();
+        due.clear();
+        if (anyDue && !vsyncPending_) {
+            AChoreographer_postFrameCallback(choreographer, onVsync, this);
+            vsyncPending_ = true;
+        }
+        if (minDelayNs != std::numeric_limits<int64_t>::max() && !delayedPending_) {
+            AChoreographer_postFrameCallbackDelayed(choreographer, onDelayedVsync, this,
+                                                    (long)(minDelayNs / 1000000));
+            delayedPending_ = true;
+        }
+        /* Returns after a callback ran or wake() */
+        ALooper_pollOnce(-1, nullptr, nullptr, nullptr);
+    }
+}
+
+void X11RenderHub::render(X11RenderClient* client, int64_t frameTimeNs) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (std::find(clients_.begin(), clients_.end(), client) == clients_.end()) return;  // removed meanwhile
+        rendering_ = client;
+    }
+    if (!client->renderFrame(frameTimeNs)) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            clients_.erase(std::remove(clients_.begin(), clients_.end(), client), clients_.end());
+        }
+        /* Still marked rendering_, so a concurrent remove() waits for this as well */
+        client->onRenderStopped();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rendering_ = nullptr;
+    }
+    cv_.notify_all();
+}
+
+void X11RenderHub::loop() {
+    LOGI("render hub thread STARTED");
+    applyThreadRole(ThreadRole::Display);
+    ALooper* looper = ALooper_prepare(0);
+    AChoreographer* choreographer = looper ? AChoreographer_getInstance() : nullptr;
+    if (choreographer) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        looper_ = looper;
+    } else {
+        LOGW("render hub has no Choreographer, drawing on every update");
+    }
+    std::vector<X11RenderClient*> due;
+    for (;;) {
+        int64_t frameTimeNs = 0;
+        waitForFrames(choreographer, due, frameTimeNs);
+        for (X11RenderClient* c : due) render(c, frameTimeNs);
+    }
+}
+
+} // namespace guitarrackcraft
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+#include <android/choreographer.h>
+#include <android/looper.h>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/** A display drawn by X11RenderHub. Methods run on the hub thread unless noted. */
+class X11RenderClient {
+public:
+    virtual ~X11RenderClient() = default;
+    /** New content is waiting. Any thread. */
+    virtual bool wantsFrame() const = 0;
+    /** 0 to draw for vsync frameTimeNs, otherwise how long until the client's pacing allows it. */
+    virtual int64_t frameDelayNs(int64_t frameTimeNs) = 0;
+    /** Make the client's surface current with the hub context, draw and present. False if
+     *  the surface is gone: the hub then drops the client and calls onRenderStopped(). */
+    virtual bool renderFrame(int64_t frameTimeNs) = 0;
+    virtual void onRenderStopped() = 0;
+};
+
+/**
+ * The single render thread behind every X11NativeDisplay. All displays share one GLES2
+ * context and one blit program; each keeps its own window surface and texture. The
+ * thread is driven by Choreographer vsync: one frame callback serves every display, and
+ * each client's pacing decides whether it draws on that vsync. Without a Choreographer
+ * it draws as soon as a client has content.
+ *
+ * The thread and context live for the rest of the process once started, matching the
+ * displays' policy of never tearing EGL down (see X11NativeDisplay::Impl::renderFrame).
+ */
+class X11RenderHub {
+public:
+    static X11RenderHub& instance();
+
+    /** Shared context for window surfaces of config, created on first use. Any thread. */
+    EGLContext context(EGLDisplay display, EGLConfig config);
+
+    struct BlitProgram {
+        GLuint program = 0;
+        GLint texUniform = -1;
+        GLint aPos = -1;
+        GLint aTex = -1;
+    };
+    /** The BGRA-swizzling blit program, compiled on first use with a surface current. */
+    const BlitProgram& blitProgram();
+
+    /** Start drawing client (starts the hub thread on first use). Any thread. */
+    void add(X11RenderClient* client);
+    /** Stop drawing client. Waits up to timeoutMs for a frame of it in progress; false on timeout. */
+    bool remove(X11RenderClient* client, int timeoutMs = 500);
+    /** A client's content or state changed: wake the hub thread wherever it waits. Any thread. */
+    void wake();
+
+private:
+    X11RenderHub() = default;
+    void loop();
+    /** Block until some clients should draw; fills due and the frame time to draw them for. */
+    void waitForFrames(AChoreographer* choreographer, std::vector<X11RenderClient*>& due,
+                       int64_t& frameTimeNs);
+    void collectDueLocked(int64_t frameTimeNs, std::vector<X11RenderClient*>& due, int64_t& minDelayNs);
+    bool anyWantsFrameLocked() const;
+    void render(X11RenderClient* client, int64_t frameTimeNs);
+    static void onVsync(long frameTimeNanos, void* data);
+    static void onDelayedVsync(long frameTimeNanos, void* data);
+
+    std::mutex mutex_;                    // clients_, rendering_, looper_, started_
+    std::condition_variable cv_;          // remove() waiting for rendering_; no-Choreographer wait
+    std::vector<X11RenderClient*> clients_;
+    X11RenderClient* rendering_ = nullptr;  // client whose renderFrame() is running
+    ALooper* looper_ = nullptr;
+    bool started_ = false;
+
+    std::mutex contextMutex_;
+    EGLDisplay eglDisplay_ = EGL_NO_DISPLAY;
+    EGLContext context_ = EGL_NO_CONTEXT;
+
+    // Hub thread only
+    BlitProgram blit_;
+    bool vsyncPending_ = false;           // plain frame callback posted
+    bool delayedPending_ = false;         // delayed frame callback posted for a paced client
+    bool vsyncArrived_ = false;
+    int64_t vsyncFrameNs_ = 0;
+};
+
+} // namespace guitarrackcraft
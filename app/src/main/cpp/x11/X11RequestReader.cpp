@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "X11RequestReader.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+
+namespace guitarrackcraft {
+
+X11RequestReader::X11RequestReader(const X11ByteOrder& byteOrder, size_t maxRequestBytes)
+    : byteOrder_(byteOrder), maxRequestBytes_(maxRequestBytes), buf_(kInitialCapacity) {}
+
+void X11RequestReader::reset() {
+    head_ = tail_ = 0;
+    pendingSize_ = 0;
+    discardRemaining_ = 0;
+    discardDone_ = false;
+    if (buf_.size() > kInitialCapacity) {
+        buf_.assign(kInitialCapacity, 0);
+        buf_.shrink_to_fit();
+    }
+}
+
+void X11RequestReader::reserveTail(size_t need) {
+    if (buf_.size() - tail_ >= need) return;
+    if (head_ > 0) {
+        size_t pending = tail_ - head_;
+        memmove(buf_.data(), buf_.data() + head_, pending);
+        head_ = 0;
+        tail_ = pending;
+    }
+    if (buf_.size() - tail_ < need) {
+        buf_.resize(std::max(buf_.size() * 2, tail_ + need));
+    }
+}
+
+X11RequestReader::FillResult X11RequestReader::fill(int fd) {
+    /* Room for the rest of a known pending request, or at least a decent chunk */
+    size_t need = 4096;
+    if (pendingSize_ > buffered()) need = std::max(need, pendingSize_ - buffered());
+    reserveTail(need);
+    ssize_t n = recv(fd, buf_.data() + tail_, buf_.size() - tail_, 0);
+    if (n > 0) {
+        tail_ += (size_t)n;
+        return FillResult::Data;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        return FillResult::WouldBlock;
+    return FillResult::Closed;
+}
+
+void X11RequestReader::append(const void* data, size_t len) {
+    reserveTail(len);
+    memcpy(buf_.data() + tail_, data, len);
+    tail_ += len;
+}
+
+bool X11RequestReader::next(Request& out) {
+    if (discardRemaining_ > 0) {
+        size_t n = std::min(discardRemaining_, buffered());
+        head_ += n;
+        discardRemaining_ -= n;
+        if (discardRemaining_ > 0) {
+            head_ = tail_ = 0;  // everything buffered was payload
+            return false;
+        }
+        discardDone_ = true;
+    }
+    if (discardDone_) {
+        discardDone_ = false;
+        out = Request{};
+        out.opcode = discardOpcode_;
+        out.big = true;
+        out.discarded = true;
+        return true;
+    }
+
+    size_t avail = buffered();
+    if (avail < 4) return false;
+    uint8_t* p = buf_.data() + head_;
+    uint32_t length = byteOrder_.read16(p, 2);
+    bool big = false;
+    size_t total;
+    if (length == 0) {
+        if (avail < 8) return false;
+        uint32_t bigLength = byteOrder_.read32(p, 4);
+        total = (size_t)bigLength * 4;
+        big = true;
+        if (bigLength < 2 || total > maxRequestBytes_) {
+            /* Malformed or over the advertised maximum: drop it whole */
+            discardOpcode_ = p[0];
+            discardRemaining_ = bigLength < 2 ? 8 : total;
+            pendingSize_ = 0;
+            return next(out);
+        }
+    } else {
+        total = (size_t)length * 4;
+    }
+    if (avail < total) {
+        pendingSize_ = total;
+        return false;
+    }
+    pendingSize_ = 0;
+    head_ += total;
+
+    out = Request{};
+    out.opcode = p[0];
+    out.big = big;
+    if (big) {
+        /* Slide opcode/data/length over the extended length word */
+        memmove(p + 4, p, 4);
+        p += 4;
+        total -= 4;
+    }
+    out.data = p;
+    out.size = total;
+    out.length = (uint32_t)(total / 4);
+    if (head_ == tail_) {
+        /* Fully consumed; next fill() can start at the front. The returned
+         * pointer stays valid because nothing is written until then. */
+        head_ = tail_ = 0;
+    }
+    return true;
+}
+
+} // namespace guitarrackcraft
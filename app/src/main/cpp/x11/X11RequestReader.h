@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "X11ByteOrder.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Buffers a client's request stream and splits it into complete requests.
+ *
+ * Each fill() is one large recv() into the free tail of the buffer, so a burst of
+ * small requests (or one big PutImage) is read with a handful of syscalls and then
+ * parsed in place. Consumed bytes are reclaimed by sliding the unread tail to the
+ * front, which keeps every request contiguous for the handlers.
+ *
+ * BIG-REQUESTS: a header length of 0 is followed by a 32-bit length. Such requests
+ * are normalized so that handlers see a plain 4-byte header followed by the body;
+ * Request::length carries the real length in 4-byte units (minus the extra word).
+ * Requests above maxRequestBytes are drained from the socket and reported with
+ * discarded = true so the caller can still advance its sequence number.
+ */
+class X11RequestReader {
+public:
+    struct Request {
+        uint8_t* data = nullptr;   // 4-byte header + body; valid until the next fill()/next()
+        size_t size = 0;           // bytes at data (length * 4)
+        uint32_t length = 0;       // request length in 4-byte units, as in a normal header
+        uint8_t opcode = 0;
+        bool big = false;          // arrived with a BIG-REQUESTS header
+        bool discarded = false;    // too large; body was dropped and data is nullptr
+    };
+
+    enum class FillResult { Data, WouldBlock, Closed };
+
+    static constexpr size_t kInitialCapacity = 64 * 1024;
+
+    explicit X11RequestReader(const X11ByteOrder& byteOrder,
+                              size_t maxRequestBytes = 16 * 1024 * 1024);
+
+    /** One non-blocking recv() into the buffer. Grows it when a pending request needs more room. */
+    FillResult fill(int fd);
+
+    /** Append bytes directly (tests, or data already read from the socket). */
+    void append(const void* data, size_t len);
+
+    /** Pop the next complete request. Returns false if more data is needed. */
+    bool next(Request& out);
+
+    /** Bytes buffered but not yet returned by next(). */
+    size_t buffered() const { return tail_ - head_; }
+
+    /** Drop all buffered data (new connection). */
+    void reset();
+
+private:
+    /** Make room for at least `need` more bytes after tail_. */
+    void reserveTail(size_t need);
+
+    const X11ByteOrder& byteOrder_;
+    size_t maxRequestBytes_;
+    std::vector<uint8_t> buf_;
+    size_t head_ = 0;
+    size_t tail_ = 0;
+    size_t pendingSize_ = 0;     // full size of the request at head_, once its header is known
+    size_t discardRemaining_ = 0;
+    uint8_t discardOpcode_ = 0;
+    bool discardDone_ = false;
+};
+
+} // namespace guitarrackcraft
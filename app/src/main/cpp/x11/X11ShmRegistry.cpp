@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "X11ShmRegistry.h"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace guitarrackcraft {
+
+namespace {
+
+int createMemfd() {
+#if defined(__NR_memfd_create)
+    /* Via syscall: bionic only wraps memfd_create from API 30. */
+    return (int)syscall(__NR_memfd_create, "x11-shm", 1u /* MFD_CLOEXEC */);
+#else
+    return -1;
+#endif
+}
+
+} // namespace
+
+X11ShmRegistry& X11ShmRegistry::instance() {
+    static X11ShmRegistry registry;
+    return registry;
+}
+
+X11ShmRegistry::~X11ShmRegistry() {
+    for (auto& kv : segments_) {
+        munmap(kv.second.addr, kv.second.size);
+        if (kv.second.fd >= 0) close(kv.second.fd);
+    }
+}
+
+int X11ShmRegistry::create(size_t size) {
+    if (size == 0) return -1;
+    Segment seg;
+    seg.size = size;
+    seg.fd = createMemfd();
+    if (seg.fd >= 0 && ftruncate(seg.fd, (off_t)size) == 0) {
+        seg.addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, seg.fd, 0);
+    }
+    if (!seg.addr || seg.addr == MAP_FAILED) {
+        if (seg.fd >= 0) close(seg.fd);
+        seg.fd = -1;
+        seg.addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (seg.addr == MAP_FAILED) return -1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    int id = nextId_++;
+    if (nextId_ <= 0) nextId_ = 1;
+    segments_[id] = seg;
+    return id;
+}
+
+void* X11ShmRegistry::attach(int id, size_t* size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = segments_.find(id);
+    if (it == segments_.end()) return nullptr;
+    ++it->second.refs;
+    if (size) *size = it->second.size;
+    return it->second.addr;
+}
+
+bool X11ShmRegistry::detach(int id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = segments_.find(id);
+    if (it == segments_.end() || it->second.refs == 0) return false;
+    --it->second.refs;
+    releaseIfUnused(it);
+    return true;
+}
+
+bool X11ShmRegistry::detachAddress(const void* addr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = segments_.begin(); it != segments_.end(); ++it) {
+        if (it->second.addr == addr && it->second.refs > 0) {
+            --it->second.refs;
+            releaseIfUnused(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool X11ShmRegistry::remove(int id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = segments_.find(id);
+    if (it == segments_.end()) return false;
+    it->second.removed = true;
+    releaseIfUnused(it);
+    return true;
+}
+
+size_t X11ShmRegistry::segmentCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return segments_.size();
+}
+
+void X11ShmRegistry::releaseIfUnused(std::unordered_map<int, Segment>::iterator it) {
+    if (!it->second.removed || it->second.refs > 0) return;
+    munmap(it->second.addr, it->second.size);
+    if (it->second.fd >= 0) close(it->second.fd);
+    segments_.erase(it);
+}
+
+bool X11ShmSegmentTable::attach(uint32_t shmseg, int shmid, bool readOnly) {
+    if (segments_.count(shmseg)) return false;
+    size_t size = 0;
+    void* addr = registry_.attach(shmid, &size);
+    if (!addr) return false;
+    segments_[shmseg] = Segment{shmid, static_cast<uint8_t*>(addr), size, readOnly};
+    return true;
+}
+
+bool X11ShmSegmentTable::detach(uint32_t shmseg) {
+    auto it = segments_.find(shmseg);
+    if (it == segments_.end()) return false;
+    registry_.detach(it->second.shmid);
+    segments_.erase(it);
+    return true;
+}
+
+const X11ShmSegmentTable::Segment* X11ShmSegmentTable::get(uint32_t shmseg) const {
+    auto it = segments_.find(shmseg);
+    return it == segments_.end() ? nullptr : &it->second;
+}
+
+void X11ShmSegmentTable::clear() {
+    for (auto& kv : segments_) registry_.detach(kv.second.shmid);
+    segments_.clear();
+}
+
+} // namespace guitarrackcraft
+
+using guitarrackcraft::X11ShmRegistry;
+
+extern "C" __attribute__((visibility("default")))
+int grc_x11_shm_create(size_t size) {
+    return X11ShmRegistry::instance().create(size);
+}
+
+extern "C" __attribute__((visibility("default")))
+void* grc_x11_shm_attach(int id, size_t* size) {
+    return X11ShmRegistry::instance().attach(id, size);
+}
+
+extern "C" __attribute__((visibility("default")))
+int grc_x11_shm_detach_address(const void* addr) {
+    return X11ShmRegistry::instance().detachAddress(addr) ? 0 : -1;
+}
+
+extern "C" __attribute__((visibility("default")))
+int grc_x11_shm_remove(int id) {
+    return X11ShmRegistry::instance().remove(id) ? 0 : -1;
+}
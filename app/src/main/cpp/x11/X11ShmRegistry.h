@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace guitarrackcraft {
+
+/**
+ * Process-wide table of MIT-SHM segments. The embedded server and its plugin UI
+ * clients share one address space, so a segment is created once (memfd-backed,
+ * anonymous shared mapping as fallback) and both sides reference the same mapping
+ * by id. Clients reach it through the grc_x11_shm_* C entry points below, which the
+ * SysV shm shim in xshm_stub.c uses to implement shmget/shmat/shmdt/shmctl.
+ *
+ * A segment lives until it has been removed (IPC_RMID) and every attach has been
+ * matched by a detach, mirroring SysV semantics.
+ */
+class X11ShmRegistry {
+public:
+    static X11ShmRegistry& instance();
+
+    /** Create a segment of size bytes. Returns its id (> 0), or -1 on failure. */
+    int create(size_t size);
+
+    /** Take a reference to segment id. Returns its base address, or nullptr if unknown. */
+    void* attach(int id, size_t* size = nullptr);
+
+    /** Drop a reference taken by attach(). */
+    bool detach(int id);
+
+    /** Drop a reference by base address (shmdt). */
+    bool detachAddress(const void* addr);
+
+    /** Destroy the segment once it has no references left (IPC_RMID). */
+    bool remove(int id);
+
+    size_t segmentCount() const;
+
+    X11ShmRegistry() = default;
+    ~X11ShmRegistry();
+    X11ShmRegistry(const X11ShmRegistry&) = delete;
+    X11ShmRegistry& operator=(const X11ShmRegistry&) = delete;
+
+private:
+    struct Segment {
+        int fd = -1;
+        void* addr = nullptr;
+        size_t size = 0;
+        int refs = 0;
+        bool removed = false;
+    };
+
+    /** Caller holds mutex_. Unmaps and erases the segment if removed and unreferenced. */
+    void releaseIfUnused(std::unordered_map<int, Segment>::iterator it);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<int, Segment> segments_;
+    int nextId_ = 1;
+};
+
+/**
+ * One client's attached segments, keyed by the client-chosen SHMSEG id. Each attach
+ * holds a registry reference that is dropped on detach or when the table goes away.
+ */
+class X11ShmSegmentTable {
+public:
+    struct Segment {
+        int shmid = -1;
+        uint8_t* base = nullptr;
+        size_t size = 0;
+        bool readOnly = false;
+
+        /** True if [offset, offset + len) lies inside the segment. */
+        bool contains(size_t offset, size_t len) const {
+            return offset <= size && len <= size - offset;
+        }
+    };
+
+    explicit X11ShmSegmentTable(X11ShmRegistry& registry = X11ShmRegistry::instance())
+        : registry_(registry) {}
+    ~X11ShmSegmentTable() { clear(); }
+    X11ShmSegmentTable(const X11ShmSegmentTable&) = delete;
+    X11ShmSegmentTable& operator=(const X11ShmSegmentTable&) = delete;
+
+    /** Attach shmid as shmseg. Fails for unknown shmids or an shmseg already in use. */
+    bool attach(uint32_t shmseg, int shmid, bool readOnly);
+    bool detach(uint32_t shmseg);
+    const Segment* get(uint32_t shmseg) const;
+    size_t size() const { return segments_.size(); }
+    void clear();
+
+private:
+    X11ShmRegistry& registry_;
+    std::unordered_map<uint32_t, Segment> segments_;
+};
+
+} // namespace guitarrackcraft
+
+/* C entry points for the client-side shim (resolved with dlsym at runtime). */
+extern "C" {
+int grc_x11_shm_create(size_t size);
+void* grc_x11_shm_attach(int id, size_t* size);
+int grc_x11_shm_detach_address(const void* addr);
+int grc_x11_shm_remove(int id);
+}
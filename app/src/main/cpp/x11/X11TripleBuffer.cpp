@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "X11TripleBuffer.h"
+#include <cstring>
+
+namespace guitarrackcraft {
+
+namespace {
+
+void addRegion(X11DamageRegion& dst, const X11DamageRegion& src) {
+    for (const auto& r : src.rects()) dst.add(r.x1, r.y1, r.width(), r.height());
+}
+
+void copyRect(uint32_t* dst, int dstStride, const uint32_t* src, int srcStride, const DamageRect& r) {
+    for (int y = r.y1; y < r.y2; ++y) {
+        memcpy(dst + (size_t)y * dstStride + r.x1, src + (size_t)y * srcStride + r.x1,
+               (size_t)r.width() * sizeof(uint32_t));
+    }
+}
+
+} // namespace
+
+X11TripleBuffer::X11TripleBuffer() {
+    for (int i = 0; i < 3; ++i) frames_[i].slot = i;
+}
+
+void X11TripleBuffer::setStorage(X11FrameStorage* storage) {
+    storage_ = storage;
+    publishedW_ = publishedH_ = 0;
+    for (auto& f : frames_) {
+        f.pixels.clear();
+        f.width = f.height = 0;
+        f.external = false;
+    }
+    back_ = 0;
+    front_ = 1;
+    state_.store(2, std::memory_order_release);
+}
+
+void X11TripleBuffer::dropStorage() {
+    storage_ = nullptr;
+    publishedW_ = publishedH_ = 0;  // next frame is a full upload from local pixels
+}
+
+void X11TripleBuffer::publish(const uint32_t* src, int w, int h, const X11DamageRegion& damage) {
+    if (!src || w <= 0 || h <= 0) return;
+    Frame& b = frames_[back_];
+    const bool resized = w != publishedW_ || h != publishedH_;
+    if (resized) {
+        for (auto& s : stale_) s.reset(w, h);
+        publishedW_ = w;
+        publishedH_ = h;
+    }
+
+    const bool reallocate = b.width != w || b.height != h || b.external != (storage_ != nullptr);
+    if (reallocate && storage_ && !storage_->allocate(back_, w, h)) {
+        dropStorage();
+        return publish(src, w, h, damage);
+    }
+    if (reallocate) {
+        b.width = w;
+        b.height = h;
+        b.external = storage_ != nullptr;
+        if (b.external) {
+            b.pixels = std::vector<uint32_t>();
+        } else {
+            b.pixels.resize((size_t)w * h);
+        }
+        stale_[back_].reset(w, h);
+    } else {
+        addRegion(stale_[back_], damage);
+    }
+
+    uint32_t* dst = b.pixels.data();
+    int stride = w;
+    if (b.external) {
+        dst = storage_->lock(back_, stride);
+        if (!dst) {
+            dropStorage();
+            return publish(src, w, h, damage);
+        }
+    }
+    for (const auto& r : stale_[back_].rects()) copyRect(dst, stride, src, w, r);
+    if (b.external) storage_->unlock(back_);
+
+    b.resized = resized;
+    b.upload.reset(w, h);
+    if (!resized) {
+        b.upload.clear();
+        addRegion(b.upload, damage);
+        for (int i = 0; i < 3; ++i) {
+            if (i != back_) addRegion(stale_[i], damage);
+        }
+    }
+    stale_[back_].clear();
+
+    // Fold in the damage of a ready frame the consumer never took. If it takes the
+    // frame between our load and exchange the extra rects are merely re-uploaded.
+    uint8_t s = state_.load(std::memory_order_acquire);
+    for (;;) {
+        if (s & kFresh) {
+            const Frame& skipped = frames_[s & kIndexMask];
+            if (skipped.resized) {
+                b.resized = true;
+                b.upload.addAll();
+            } else {
+                addRegion(b.upload, skipped.upload);
+            }
+        }
+        if (state_.compare_exchange_weak(s, (uint8_t)(back_ | kFresh),
+                                         std::memory_order_acq_rel, std::memory_order_acquire)) {
+            break;
+        }
+    }
+    back_ = s & kIndexMask;
+}
+
+bool X11TripleBuffer::acquire() {
+    uint8_t s = state_.load(std::memory_order_acquire);
+    for (;;) {
+        if (!(s & kFresh)) return false;
+        if (state_.compare_exchange_weak(s, (uint8_t)front_,
+                                         std::memory_order_acq_rel, std::memory_order_acquire)) {
+            break;
+        }
+    }
+    front_ = s & kIndexMask;
+    return true;
+}
+
+} // namespace guitarrackcraft
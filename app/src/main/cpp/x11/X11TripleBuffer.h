@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "X11DamageRegion.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace guitarrackcraft {
+
+/**
+ * Out-of-line pixel storage for the triple buffer's slots, e.g. buffers the GPU can
+ * sample directly. allocate/lock/unlock are called on the producer thread for the
+ * slot it currently owns; the consumer reads a slot only after acquiring it.
+ */
+class X11FrameStorage {
+public:
+    virtual ~X11FrameStorage() = default;
+    /** (Re)allocate slot for w*h pixels. Returning false drops back to local pixels. */
+    virtual bool allocate(int slot, int w, int h) = 0;
+    /** Map slot for CPU writes; sets stride (in pixels). nullptr drops back to local pixels. */
+    virtual uint32_t* lock(int slot, int& stride) = 0;
+    virtual void unlock(int slot) = 0;
+};
+
+/**
+ * Lock-free triple buffer between the X server thread (producer) and the render
+ * thread (consumer). The server keeps drawing into its own framebuffer; publish()
+ * brings the back slot up to date by copying only the rects that slot is missing,
+ * then swaps it in as the ready slot with one atomic exchange. acquire() swaps the
+ * newest ready slot into the front. Neither side ever blocks on the other.
+ *
+ * Each published frame carries the damage relative to the frame before it. If the
+ * consumer skipped a frame, its damage is folded into the next one, so the front's
+ * upload always covers everything changed since the previously acquired frame.
+ *
+ * Slots can live in an X11FrameStorage so the render thread samples them with no
+ * upload at all; the consumer then only looks at Frame::external and Frame::slot.
+ *
+ * publish() must be called from a single producer at a time (the caller serialises
+ * with the framebuffer mutex); acquire()/front() from a single consumer.
+ */
+class X11TripleBuffer {
+public:
+    struct Frame {
+        std::vector<uint32_t> pixels;  // empty when external
+        int width = 0, height = 0;
+        int slot = 0;            // index for X11FrameStorage lookups
+        bool external = false;   // pixels live in the X11FrameStorage slot
+        X11DamageRegion upload;  // changed since the previously published frame
+        bool resized = false;    // size or storage changed: upload everything
+    };
+
+    X11TripleBuffer();
+
+    /**
+     * Keep slot pixels in storage instead of local vectors (nullptr: local). Resets all
+     * slots, so call it only while neither producer nor consumer is running.
+     */
+    void setStorage(X11FrameStorage* storage);
+
+    /** Producer: stop using storage; later frames (the first one full) use local pixels. */
+    void dropStorage();
+
+    /** Publish src (w*h pixels) after damage was drawn into it. */
+    void publish(const uint32_t* src, int w, int h, const X11DamageRegion& damage);
+
+    /** Swap the newest published frame into front(). Returns false if none is new. */
+    bool acquire();
+
+    const Frame& front() const { return frames_[front_]; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;  // ready slot not yet acquired
+
+    Frame frames_[3];
+    X11FrameStorage* storage_ = nullptr;
+    X11DamageRegion stale_[3];  // producer-only: area each slot lags behind the source
+    int publishedW_ = 0, publishedH_ = 0;  // producer-only: size of the last publish
+    int back_ = 0;
+    int front_ = 1;
+    std::atomic<uint8_t> state_{2};  // ready slot index | kFresh
+};
+
+} // namespace guitarrackcraft
@@ -27,6 +27,7 @@ X11WindowManager::X11WindowManager(uint32_t rootWindowId)
     : rootWindowId_(rootWindowId) {}
 
 void X11WindowManager::createWindow(uint32_t wid, uint32_t parent, int x, int y, int w, int h) {
+    invalidateClip();
     childWindows_.push_back(wid);
     windowSizes_[wid] = {w, h};
     windowPositions_[wid] = {x, y, parent};
@@ -40,6 +41,7 @@ void X11WindowManager::createWindow(uint32_t wid, uint32_t parent, int x, int y,
 }
 
 void X11WindowManager::destroyWindow(uint32_t wid) {
+    invalidateClip();
     childWindows_.erase(
         std::remove(childWindows_.begin(), childWindows_.end(), wid),
         childWindows_.end());
@@ -50,14 +52,17 @@ void X11WindowManager::destroyWindow(uint32_t wid) {
 }
 
 void X11WindowManager::mapWindow(uint32_t wid) {
+    invalidateClip();
     unmappedWindows_.erase(wid);
 }
 
 void X11WindowManager::unmapWindow(uint32_t wid) {
+    invalidateClip();
     unmappedWindows_.insert(wid);
 }
 
 void X11WindowManager::configureWindow(uint32_t wid, int x, int y, int w, int h) {
+    invalidateClip();
     if (w > 0 && h > 0) {
         windowSizes_[wid] = {w, h};
     }
@@ -148,6 +153,7 @@ bool X11WindowManager::setPositionX(uint32_t wid, int x) {
     auto it = windowPositions_.find(wid);
     if (it != windowPositions_.end() && it->second.x != x) {
         it->second.x = x;
+        invalidateClip();
         return true;
     }
     return false;
@@ -157,12 +163,14 @@ bool X11WindowManager::setPositionY(uint32_t wid, int y) {
     auto it = windowPositions_.find(wid);
     if (it != windowPositions_.end() && it->second.y != y) {
         it->second.y = y;
+        invalidateClip();
         return true;
     }
     return false;
 }
 
 void X11WindowManager::setSize(uint32_t wid, int w, int h) {
+    invalidateClip();
     windowSizes_[wid] = {w, h};
 }
 
@@ -196,6 +204,7 @@ size_t X11WindowManager::raiseSubtreeToFront(uint32_t wid) {
     // Add back at the end in creation order
     for (auto w : toMove)
         childWindows_.push_back(w);
+    invalidateClip();
     return toMove.size();
 }
 
@@ -259,7 +268,20 @@ std::vector<X11WindowManager::Rect> X11WindowManager::getMappedSiblingRectsAbove
     return rects;
 }
 
+const X11ClipRegion& X11WindowManager::clipRegion(uint32_t wid) const {
+    auto it = clipCache_.find(wid);
+    if (it != clipCache_.end()) return it->second;
+
+    std::vector<ClipRect> rects;
+    for (const auto& r : getMappedChildRectsOf(wid)) rects.push_back({r.x1, r.y1, r.x2, r.y2});
+    for (const auto& r : getMappedSiblingRectsAbove(wid)) rects.push_back({r.x1, r.y1, r.x2, r.y2});
+    X11ClipRegion& region = clipCache_[wid];
+    region.setRects(rects);
+    return region;
+}
+
 void X11WindowManager::clear() {
+    invalidateClip();
     childWindows_.clear();
     windowSizes_.clear();
     windowPositions_.clear();
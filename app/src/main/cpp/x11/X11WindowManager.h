@@ -19,11 +19,13 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
+#include "X11ClipRegion.h"
 
 namespace guitarrackcraft {
 
@@ -64,6 +66,12 @@ public:
     // "Above" means later in childWindows_. Only considers siblings with the same parent.
     std::vector<Rect> getMappedSiblingRectsAbove(uint32_t wid) const;
 
+    // Absolute area PutImage to wid must not touch: its mapped children plus the mapped
+    // siblings above it, as a banded region. Built on first use and cached until a
+    // window is created, destroyed, mapped, unmapped, moved, resized or restacked.
+    // The reference is valid until the next such change.
+    const X11ClipRegion& clipRegion(uint32_t wid) const;
+
     std::pair<int, int> getAbsolutePos(uint32_t wid) const;
     HitResult hitTest(int x, int y) const;
 
@@ -88,6 +96,9 @@ private:
     std::unordered_set<uint32_t> unmappedWindows_;
     std::unordered_map<uint32_t, uint32_t> windowEventMasks_;
     int originalChildW_ = 0, originalChildH_ = 0;
+
+    void invalidateClip() { clipCache_.clear(); }
+    mutable std::unordered_map<uint32_t, X11ClipRegion> clipCache_;
 };
 
 } // namespace guitarrackcraft
@@ -18,6 +18,7 @@
  */
 
 #include "X11Worker.h"
+#include "../utils/ThreadPolicy.h"
 #include <android/log.h>
 
 #define LOG_TAG "X11Worker"
@@ -88,6 +89,7 @@ void X11Worker::postAndWait(Task task) {
 
 void X11Worker::run() {
     threadId_ = std::this_thread::get_id();
+    applyThreadRole(ThreadRole::Display);
     LOGI("X11Worker thread started tid=%lu", 
          static_cast<unsigned long>(std::hash<std::thread::id>{}(threadId_)));
     
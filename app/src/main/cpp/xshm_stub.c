@@ -17,117 +17,83 @@
  * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
  */
 
-/* XShm stub library for Android - provides stub implementations
- * of MIT-SHM extension functions since android-xserver doesn't
- * support this extension.
- * 
- * This file provides weak stub implementations that will be used
- * if the real XShm functions are not available.
+/* SysV shared memory shim for plugin UIs (MIT-SHM client side).
+ *
+ * Bionic has no working shmget/shmat, so cairo's XShm path and libXext's XShm*
+ * functions had nothing to attach. The embedded X server runs in the same process
+ * as the UIs, so segments come from its in-process registry (X11ShmRegistry)
+ * instead: these shmget/shmat/shmdt/shmctl definitions resolve the registry's C
+ * entry points from libguitarrackcraft.so at first use, and the resulting shmid
+ * is what XShmAttach sends to the server.
+ *
+ * Only IPC_PRIVATE segments are supported. If the registry cannot be resolved
+ * every call fails with ENOSYS and clients fall back to plain PutImage.
  */
-#include <stdlib.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <stddef.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/types.h>
 
-// Opaque X11 types (we only need pointers)
-typedef void* Display;
-typedef unsigned long Drawable;
-typedef void* GC;
-typedef void* XImage;
-typedef void* Visual;
-typedef void* Pixmap;
-typedef unsigned long Bool;
-typedef int Status;
+#define HIDDEN __attribute__((visibility("hidden")))
 
-// XShmSegmentInfo structure (minimal)
-typedef struct {
-    unsigned long shmseg;
-    int shmid;
-    char *shmaddr;
-    int readOnly;
-} XShmSegmentInfo;
+typedef int (*shm_create_fn)(size_t size);
+typedef void* (*shm_attach_fn)(int id, size_t* size);
+typedef int (*shm_detach_fn)(const void* addr);
+typedef int (*shm_remove_fn)(int id);
 
-// Weak symbol stubs - will be overridden if real XShm is available
-__attribute__((weak)) int XShmQueryExtension(void *dpy) {
-    (void)dpy;
-    return 0; // Extension not available
-}
+static struct {
+    int resolved;
+    shm_create_fn create;
+    shm_attach_fn attach;
+    shm_detach_fn detach;
+    shm_remove_fn remove;
+} g_shm;
 
-__attribute__((weak)) int XShmGetEventBase(void *dpy) {
-    (void)dpy;
-    return -1;
+static int shm_resolve(void) {
+    if (__atomic_load_n(&g_shm.resolved, __ATOMIC_ACQUIRE))
+        return g_shm.create != NULL;
+    void* lib = dlopen("libguitarrackcraft.so", RTLD_NOW | RTLD_NOLOAD);
+    if (lib) {
+        g_shm.create = (shm_create_fn)dlsym(lib, "grc_x11_shm_create");
+        g_shm.attach = (shm_attach_fn)dlsym(lib, "grc_x11_shm_attach");
+        g_shm.detach = (shm_detach_fn)dlsym(lib, "grc_x11_shm_detach_address");
+        g_shm.remove = (shm_remove_fn)dlsym(lib, "grc_x11_shm_remove");
+        if (!g_shm.attach || !g_shm.detach || !g_shm.remove) g_shm.create = NULL;
+    }
+    __atomic_store_n(&g_shm.resolved, 1, __ATOMIC_RELEASE);
+    return g_shm.create != NULL;
 }
 
-__attribute__((weak)) Bool XShmQueryVersion(void *dpy, int *major, int *minor, Bool *pixmaps) {
-    (void)dpy;
-    (void)major;
-    (void)minor;
-    (void)pixmaps;
-    return 0; // Extension not available
+HIDDEN int shmget(key_t key, size_t size, int shmflg) {
+    (void)shmflg;
+    if (!shm_resolve()) { errno = ENOSYS; return -1; }
+    if (key != IPC_PRIVATE) { errno = EINVAL; return -1; }
+    int id = g_shm.create(size);
+    if (id < 0) errno = ENOMEM;
+    return id;
 }
 
-__attribute__((weak)) int XShmPixmapFormat(void *dpy) {
-    (void)dpy;
-    return -1;
+HIDDEN void* shmat(int shmid, const void* shmaddr, int shmflg) {
+    (void)shmflg;
+    if (!shm_resolve()) { errno = ENOSYS; return (void*)-1; }
+    if (shmaddr != NULL) { errno = EINVAL; return (void*)-1; }
+    void* addr = g_shm.attach(shmid, NULL);
+    if (!addr) { errno = EINVAL; return (void*)-1; }
+    return addr;
 }
 
-__attribute__((weak)) Status XShmAttach(void *dpy, XShmSegmentInfo *shminfo) {
-    (void)dpy;
-    (void)shminfo;
-    return 0; // Failed
-}
-
-__attribute__((weak)) Status XShmDetach(void *dpy, XShmSegmentInfo *shminfo) {
-    (void)dpy;
-    (void)shminfo;
+HIDDEN int shmdt(const void* shmaddr) {
+    if (!shm_resolve()) { errno = ENOSYS; return -1; }
+    if (g_shm.detach(shmaddr) != 0) { errno = EINVAL; return -1; }
     return 0;
 }
 
-// External XPutImage function (provided by android-xserver)
-extern int XPutImage(void *dpy, unsigned long d, void *gc, void *image,
-                     int src_x, int src_y, int dest_x, int dest_y,
-                     unsigned int width, unsigned int height);
-
-__attribute__((weak)) Status XShmPutImage(void *dpy, unsigned long d, void *gc, void *image,
-                    int src_x, int src_y, int dest_x, int dest_y,
-                    unsigned int width, unsigned int height, Bool send_event) {
-    (void)send_event;
-    // Fall back to regular XPutImage
-    XPutImage(dpy, d, gc, image, src_x, src_y, dest_x, dest_y, width, height);
-    return 1;
-}
-
-__attribute__((weak)) Status XShmGetImage(void *dpy, unsigned long d, void *image,
-                    int x, int y, unsigned long plane_mask) {
-    (void)dpy;
-    (void)d;
-    (void)image;
-    (void)x;
-    (void)y;
-    (void)plane_mask;
-    return 0; // Failed
-}
-
-// External XCreateImage function (provided by android-xserver)
-extern void* XCreateImage(void *dpy, void *visual, unsigned int depth,
-                         int format, int offset, char *data,
-                         unsigned int width, unsigned int height,
-                         int bitmap_pad, int bytes_per_line);
-
-__attribute__((weak)) XImage *XShmCreateImage(void *dpy, void *visual, unsigned int depth,
-                        int format, char *data, XShmSegmentInfo *shminfo,
-                        unsigned int width, unsigned int height) {
-    (void)shminfo;
-    // Just create a regular XImage, ignore shared memory
-    return XCreateImage(dpy, visual, depth, format, 0, data, width, height, 32, 0);
-}
-
-__attribute__((weak)) unsigned long XShmCreatePixmap(void *dpy, unsigned long d, char *data,
-                     XShmSegmentInfo *shminfo, unsigned int width, unsigned int height,
-                     unsigned int depth) {
-    (void)dpy;
-    (void)d;
-    (void)data;
-    (void)shminfo;
-    (void)width;
-    (void)height;
-    (void)depth;
-    return 0; // Failed
+HIDDEN int shmctl(int shmid, int cmd, struct shmid_ds* buf) {
+    (void)buf;
+    if (!shm_resolve()) { errno = ENOSYS; return -1; }
+    if (cmd != IPC_RMID) { errno = EINVAL; return -1; }
+    if (g_shm.remove(shmid) != 0) { errno = EINVAL; return -1; }
+    return 0;
 }
@@ -66,7 +66,7 @@ class X11PluginUIActivity : ComponentActivity() {
                     if (++touchLogCount <= 40 || touchLogCount % 50 == 0) {
                         Log.i(TAG, "X11Touch display=$displayNumber action=$action x=${event.x.toInt()} y=${event.y.toInt()} (#$touchLogCount)")
                     }
-                    X11Bridge.injectTouch(displayNumber, action, event.x.toInt(), event.y.toInt())
+                    X11Bridge.injectTouch(displayNumber, action, event.x.toInt(), event.y.toInt(), event.eventTime * 1_000_000L)
                     X11DisplayManager.pluginUiExecutor.execute {
                         X11Bridge.idlePluginUIs()
                         X11Bridge.requestX11Frame(displayNumber)
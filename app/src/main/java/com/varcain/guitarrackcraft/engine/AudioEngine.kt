@@ -19,24 +19,62 @@
 
 package com.varcain.guitarrackcraft.engine
 
+import android.media.midi.MidiDevice
+
 /**
  * Facade for audio engine lifecycle, metering, and latency.
  */
 object AudioEngine {
     private val native get() = NativeEngine.getInstance()
 
+    /** [midiLearn] port index that binds the plugin's host bypass instead of a control. */
+    const val MIDI_BYPASS_PORT = -1
+    /** [setAnalysisSource] values besides a chain index. */
+    const val ANALYSIS_INPUT = -1
+    const val ANALYSIS_OFF = -2
+
     fun start(sampleRate: Float = 48000f, inputDeviceId: Int = 0, outputDeviceId: Int = 0, bufferFrames: Int = 0): Boolean =
         native.startEngine(sampleRate, inputDeviceId, outputDeviceId, bufferFrames)
+    /** Switch devices or buffer size in place; plugins keep running state unless the rate or block changes. */
+    fun reconfigure(sampleRate: Float = 48000f, inputDeviceId: Int = 0, outputDeviceId: Int = 0, bufferFrames: Int = 0): Boolean =
+        native.reconfigureEngine(sampleRate, inputDeviceId, outputDeviceId, bufferFrames)
     fun stop() = native.stopEngine()
     fun isRunning(): Boolean = native.isEngineRunning()
     fun getSampleRate(): Float = native.getSampleRate()
     fun getBufferFrameCount(): Int = native.getBufferFrameCount()
     fun getStreamInfo(): AudioStreamInfo = native.getStreamInfo()
     fun getLatencyMs(): Double = native.getLatencyMs()
+    fun getRoundTripLatencyMs(): Double = native.getRoundTripLatencyMs()
+    fun startLatencyCalibration(): Boolean = native.startLatencyCalibration()
+    fun pollLatencyCalibration(): Int = native.pollLatencyCalibration()
+    fun setMeasuredLatencyFrames(frames: Int) = native.setMeasuredLatencyFrames(frames)
 
     fun getInputLevel(): Float = native.getInputLevel()
     fun getOutputLevel(): Float = native.getOutputLevel()
     fun getCpuLoad(): Float = native.getCpuLoad()
+    /** Meters, load, xruns and plugin output ports from shared memory; no JNI call. */
+    fun readTelemetry(): TelemetrySnapshot? = native.telemetry.read()
+    /** Tuner/spectrum/scope of the engine input or one plugin's output, computed off the audio thread. */
+    fun setAnalysisSource(source: Int): Boolean = native.setAnalysisSource(source)
+    fun readAnalysis(): AnalysisSnapshot? = native.telemetry.readAnalysis()
+    fun setPluginProfiling(enabled: Boolean) = native.setPluginProfiling(enabled)
+    /** System trace markers for a Perfetto capture; near-free while off. */
+    fun setSystemTraceEnabled(enabled: Boolean): Boolean = native.setSystemTraceEnabled(enabled)
+    fun setMemoryLocking(locked: Boolean): Boolean = native.setMemoryLocking(locked)
+
+    /** Native MIDI input from an opened device (see NativeEngine.nativeOpenMidiInput). */
+    fun openMidiInput(device: MidiDevice, portNumber: Int = 0): Boolean =
+        native.openMidiInput(device, portNumber)
+    fun closeMidiInput() = native.closeMidiInput()
+    /** MIDI learn: [portIndex] [MIDI_BYPASS_PORT] binds the plugin's bypass. */
+    fun midiLearn(pluginIndex: Int, portIndex: Int, min: Float = 0f, max: Float = 1f, toggle: Boolean = false) =
+        native.midiLearn(pluginIndex, portIndex, min, max, toggle)
+    fun cancelMidiLearn() = native.cancelMidiLearn()
+    fun isMidiLearning(): Boolean = native.isMidiLearning()
+    fun clearMidiMappings() = native.clearMidiMappings()
+    fun getPluginTimings(): List<PluginTiming> = native.getPluginTimings()
+    fun getCallbackHistogram(): CallbackHistogram = native.getCallbackHistogram()
+    fun resetCallbackHistogram() = native.resetCallbackHistogram()
     fun getXRunCount(): Int = native.getXRunCount()
     fun isInputClipping(): Boolean = native.isInputClipping()
     fun isOutputClipping(): Boolean = native.isOutputClipping()
@@ -34,6 +34,7 @@ object AudioSettingsManager {
     private const val KEY_INPUT_DEVICE_ID = "inputDeviceId"
     private const val KEY_OUTPUT_DEVICE_ID = "outputDeviceId"
     private const val KEY_BUFFER_SIZE = "bufferSize"
+    private const val KEY_MEASURED_LATENCY_PREFIX = "measuredLatency_"
 
     val BUFFER_SIZE_OPTIONS = listOf(
         0 to "Auto",
@@ -70,6 +71,17 @@ object AudioSettingsManager {
         prefs(context).edit().putInt(KEY_BUFFER_SIZE, size).apply()
     }
 
+    /** Calibrated round-trip latency in frames for a device pair and buffer setting; 0 if never measured. */
+    fun getMeasuredLatencyFrames(context: Context, inputId: Int, outputId: Int, bufferSize: Int): Int =
+        prefs(context).getInt(measuredLatencyKey(inputId, outputId, bufferSize), 0)
+
+    fun setMeasuredLatencyFrames(context: Context, inputId: Int, outputId: Int, bufferSize: Int, frames: Int) {
+        prefs(context).edit().putInt(measuredLatencyKey(inputId, outputId, bufferSize), frames).apply()
+    }
+
+    private fun measuredLatencyKey(inputId: Int, outputId: Int, bufferSize: Int) =
+        "$KEY_MEASURED_LATENCY_PREFIX${inputId}_${outputId}_$bufferSize"
+
     fun getInputDevices(context: Context): List<AudioDeviceOption> {
         val am = context.getSystemService(Context.AUDIO_SERVICE) as AudioManager
         val devices = am.getDevices(AudioManager.GET_DEVICES_INPUTS)
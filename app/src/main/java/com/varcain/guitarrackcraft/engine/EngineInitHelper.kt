@@ -86,6 +86,8 @@ object EngineInitHelper {
         } else {
             val count = engine.getAvailablePlugins().size
             Log.d(TAG, "Native engine init OK, plugin count=$count")
+            // Instantiate spares of the favorite/recent plugins in the background
+            RecentPluginsManager.updateEngine(context.applicationContext)
         }
         return ok
     }
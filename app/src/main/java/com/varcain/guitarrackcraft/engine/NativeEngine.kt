@@ -20,7 +20,11 @@
 package com.varcain.guitarrackcraft.engine
 
 import android.content.Context
+import android.media.midi.MidiDevice
 import java.io.File
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.FloatBuffer
 
 data class AudioStreamInfo(
     val isAAudio: Boolean = false,
@@ -30,9 +34,44 @@ data class AudioStreamInfo(
     val outputLowLatency: Boolean = false,
     val outputMMap: Boolean = false,
     val outputCallback: Boolean = false,
-    val framesPerBurst: Int = 0
+    val framesPerBurst: Int = 0,
+    /** Full-duplex input health: frames zero-filled on short reads, drift slips, surplus frames dropped. */
+    val inputZeroFilledFrames: Int = 0,
+    val inputSlippedFrames: Int = 0,
+    val inputDiscardedFrames: Int = 0
 )
 
+/**
+ * Audio callback timing histograms. [loadBuckets][i] counts callbacks whose wall time was
+ * i * [loadBucketPercent]% of the deadline (last bucket = beyond); [intervalBuckets] does the
+ * same for the time between callbacks relative to the nominal period.
+ */
+data class CallbackHistogram(
+    val callbacks: Int = 0,
+    val nearMisses: Int = 0,
+    val deadlineMisses: Int = 0,
+    val maxWallUs: Int = 0,
+    val maxJitterUs: Int = 0,
+    val loadBucketPercent: Int = 0,
+    val intervalBucketPercent: Int = 0,
+    val loadBuckets: List<Int> = emptyList(),
+    val intervalBuckets: List<Int> = emptyList()
+)
+
+/** DSP time of one rack slot over the native rolling window, in microseconds. */
+data class PluginTiming(
+    val lastUs: Float = 0f,
+    val avgUs: Float = 0f,
+    val p99Us: Float = 0f,
+    /** Silent-input blocks that ran far slower than on signal (denormal tails); should stay 0. */
+    val silentSpikes: Int = 0,
+    /** Input has been silent past the plugin's tail, so its processing is skipped. */
+    val asleep: Boolean = false
+) {
+    /** Share of a callback period of [budgetUs] used on average (for a per-plugin CPU bar). */
+    fun load(budgetUs: Float): Float = if (budgetUs > 0f) (avgUs / budgetUs).coerceIn(0f, 1f) else 0f
+}
+
 /**
  * JNI bridge to the native audio engine.
  * Provides a Kotlin interface to the C++ audio processing engine.
@@ -40,6 +79,17 @@ data class AudioStreamInfo(
 class NativeEngine private constructor() {
     
     companion object {
+        /** [pollLatencyCalibration] results; mirror AudioEngine::kCalibration* in native code. */
+        const val CALIBRATION_FAILED = -1
+        const val CALIBRATION_PENDING = -2
+
+        /** Recording sample formats for [startRecording]; mirror AudioRecorder::Format. */
+        const val RECORD_FORMAT_PCM16 = 0
+        const val RECORD_FORMAT_PCM24 = 1
+        const val RECORD_FORMAT_FLOAT32 = 2
+        const val RECORD_FORMAT_FLAC16 = 3
+        const val RECORD_FORMAT_FLAC24 = 4
+
         @Volatile
         private var INSTANCE: NativeEngine? = null
 
@@ -111,6 +161,13 @@ class NativeEngine private constructor() {
      */
     external fun nativeStartEngine(sampleRate: Float = 48000f, inputDeviceId: Int = 0, outputDeviceId: Int = 0, bufferFrames: Int = 0): Boolean
 
+    /**
+     * Reopen the streams with new devices or buffer size without stopping the chain; plugins
+     * are reactivated only if the sample rate or block size changes. Starts a stopped engine.
+     * @return true if the engine is running afterwards
+     */
+    external fun nativeReconfigureEngine(sampleRate: Float = 48000f, inputDeviceId: Int = 0, outputDeviceId: Int = 0, bufferFrames: Int = 0): Boolean
+
     /**
      * Stop the audio engine.
      */
@@ -141,6 +198,10 @@ class NativeEngine private constructor() {
      * Get current audio latency in milliseconds.
      */
     external fun nativeGetLatencyMs(): Double
+    external fun nativeGetRoundTripLatencyMs(): Double
+    external fun nativeStartLatencyCalibration(): Boolean
+    external fun nativePollLatencyCalibration(): Int
+    external fun nativeSetMeasuredLatencyFrames(frames: Int)
 
     /**
      * Get input peak level (0.0–1.0).
@@ -157,6 +218,62 @@ class NativeEngine private constructor() {
      */
     external fun nativeGetCpuLoad(): Float
 
+    /**
+     * Direct ByteBuffer over the native telemetry block (valid for the process lifetime).
+     * Read it through [telemetry] rather than directly.
+     */
+    external fun nativeGetTelemetryBuffer(): ByteBuffer
+
+    /**
+     * Enable per-plugin timing (two clock reads per plugin per block; off by default).
+     */
+    external fun nativeSetPluginProfiling(enabled: Boolean)
+
+    /**
+     * Pin plugin and chain buffers and the audio thread stack in RAM (best effort; the app's
+     * memlock budget is small). Returns false if some lock was refused.
+     */
+    external fun nativeSetMemoryLocking(locked: Boolean): Boolean
+
+    /**
+     * Analysis tap source: -1 engine input, a chain index for that plugin's output, -2 off.
+     * Results appear in [telemetry] ([TelemetryReader.readAnalysis]).
+     */
+    external fun nativeSetAnalysisSource(source: Int): Boolean
+
+    /**
+     * Emit ATrace sections and counters (audio callback, plugin slots, LV2 worker, recorder,
+     * X11 server and render) for Perfetto/systrace captures. False if the OS lacks ATrace.
+     */
+    external fun nativeSetSystemTraceEnabled(enabled: Boolean): Boolean
+
+    /**
+     * Read MIDI natively (AMidi, API 29+) from output port [portNumber] of an opened [device].
+     * Returns false on older releases or if the port cannot be opened.
+     */
+    external fun nativeOpenMidiInput(device: MidiDevice, portNumber: Int): Boolean
+    external fun nativeCloseMidiInput()
+
+    /**
+     * Bind the next CC or note received to a control port of the plugin at [pluginIndex]
+     * ([portIndex] -1: its bypass), scaled to [min, max]; [toggle] flips on each press.
+     */
+    external fun nativeMidiLearn(pluginIndex: Int, portIndex: Int, min: Float, max: Float, toggle: Boolean)
+    external fun nativeCancelMidiLearn()
+    external fun nativeIsMidiLearning(): Boolean
+    external fun nativeClearMidiMappings()
+
+    /**
+     * Get per-plugin DSP timings: [lastUs, avgUs, p99Us, silentSpikes, asleep] per slot, in chain order.
+     */
+    external fun nativeGetPluginTimings(): FloatArray
+
+    /**
+     * Get callback timing histograms (see [CallbackHistogram] for the layout).
+     */
+    external fun nativeGetCallbackStats(): IntArray
+    external fun nativeResetCallbackStats()
+
     /**
      * Get cumulative audio xrun (underrun/overrun) count.
      */
@@ -177,10 +294,11 @@ class NativeEngine private constructor() {
      */
     external fun nativeResetClipping()
 
-    /**
-     * Get list of all available plugins.
-     */
-    external fun nativeGetAvailablePlugins(): Array<PluginInfo>
+    /** Stamp that changes whenever the native plugin registry is (re)scanned. */
+    external fun nativeGetPluginCatalogVersion(): Long
+
+    /** Direct view of the encoded plugin catalog (see [PluginCatalogDecoder]); stays valid for the process. */
+    external fun nativeGetPluginCatalog(): ByteBuffer?
 
     /**
      * Add a plugin to the rack.
@@ -190,6 +308,13 @@ class NativeEngine private constructor() {
      */
     external fun nativeAddPluginToRack(pluginId: String, position: Int = -1): Int
 
+    /**
+     * Keep one pre-instantiated spare of each plugin warm in the background, so adding it
+     * to the rack skips instantiation. Replaces the previous set.
+     * @param pluginIds Full plugin IDs (format:uri)
+     */
+    external fun nativeSetWarmPlugins(pluginIds: Array<String>)
+
     /**
      * Remove a plugin from the rack.
      * @param position Index of plugin to remove
@@ -230,13 +355,52 @@ class NativeEngine private constructor() {
     external fun nativeGetParameter(pluginIndex: Int, portIndex: Int): Float
 
     /**
-     * Process an audio file offline through the plugin chain.
+     * Host bypass for one rack slot: crossfades to dry, then the plugin stops running.
+     * @return false if there is no such slot
+     */
+    external fun nativeSetPluginBypass(pluginIndex: Int, bypassed: Boolean): Boolean
+
+    external fun nativeIsPluginBypassed(pluginIndex: Int): Boolean
+
+    /**
+     * Read all control ports of one plugin under a single chain lock.
+     * Layout: [count, port0, value0, port1, value1, ...] (port indices as floats).
+     * @param buffer Direct FloatBuffer in native byte order
+     * @return Floats needed; when larger than the buffer's capacity nothing was written
+     */
+    external fun nativeGetParameters(pluginIndex: Int, buffer: FloatBuffer): Int
+
+    /**
+     * Write [count] (port, value) pairs, packed from index 0 of [buffer], to one plugin.
+     */
+    external fun nativeSetParameters(pluginIndex: Int, buffer: FloatBuffer, count: Int)
+
+    /**
+     * Read every plugin's control ports: [pluginCount, then one nativeGetParameters block per
+     * plugin in chain order]. Same return convention as nativeGetParameters.
+     */
+    external fun nativeGetAllParameters(buffer: FloatBuffer): Int
+
+    /**
+     * Apply a block laid out like nativeGetAllParameters' output ([size] floats).
+     * @return false if the block is malformed or was taken from a chain of a different size
+     */
+    external fun nativeSetAllParameters(buffer: FloatBuffer, size: Int): Boolean
+
+    /**
+     * Process an audio file offline through a copy of the plugin chain.
      * @param inputPath Path to input WAV file
      * @param outputPath Path to output WAV file
      * @return true if processing succeeded
      */
     external fun nativeProcessFile(inputPath: String, outputPath: String): Boolean
 
+    /**
+     * Render several files through copies of the plugin chain, concurrently.
+     * @return number of files rendered successfully
+     */
+    external fun nativeProcessFiles(inputPaths: Array<String>, outputPaths: Array<String>): Int
+
     /**
      * Get the number of plugins in the rack.
      */
@@ -287,8 +451,9 @@ class NativeEngine private constructor() {
     /** Update surface size (e.g. on surfaceChanged). */
     external fun nativeSetSurfaceSize(displayNumber: Int, width: Int, height: Int)
 
-    /** Inject touch: action 0=down, 1=up, 2=move; x, y in view coordinates. */
-    external fun nativeInjectTouch(displayNumber: Int, action: Int, x: Int, y: Int)
+    /** Inject touch: action 0=down, 1=up, 2=move; x, y in view coordinates; timeNs is the
+     *  sample's uptime in nanoseconds (MotionEvent time), 0 for now. */
+    external fun nativeInjectTouch(displayNumber: Int, action: Int, x: Int, y: Int, timeNs: Long)
 
     /** Hit-test: returns true if (x, y) in surface coords hits an X11 widget (knob, slider, etc.). */
     external fun nativeIsWidgetAtPoint(displayNumber: Int, x: Int, y: Int): Boolean
@@ -302,6 +467,9 @@ class NativeEngine private constructor() {
     /** Get the UI scale factor for the given display (1.0 = no scaling). */
     external fun nativeGetX11UIScale(displayNumber: Int): Float
 
+    /** Let the display lower the plugin UI resolution under high audio load or thermal pressure. */
+    external fun nativeSetX11AdaptiveUIScale(displayNumber: Int, enabled: Boolean)
+
     /**
      * Mark that we are about to create a plugin UI for this display.
      * Call from the UI thread before posting createPluginUI to the executor, so that if surfaceDestroyed
@@ -318,7 +486,14 @@ class NativeEngine private constructor() {
     /** Tear down the X11 UI for the given rack index. */
     external fun nativeDestroyPluginUI(pluginIndex: Int)
 
-    /** Pump idle on every active X11 UI (event processing).  Returns true if any UI reported work (dirty). */
+    /** Tear down the X11 UI running on the given display, wherever its plugin is in the rack. */
+    external fun nativeDestroyPluginUIForDisplay(displayNumber: Int)
+
+    /** True if the display still serves an instantiated plugin UI, so attaching a surface
+     *  reopens it without createPluginUI. */
+    external fun nativeHasWarmPluginUI(displayNumber: Int): Boolean
+
+    /** UIs are idled natively on each display's thread; returns true while any UI is open. */
     external fun nativeIdlePluginUIs(): Boolean
 
     /** Poll for a pending file request from any X11 plugin UI (ui:requestValue).
@@ -331,6 +506,12 @@ class NativeEngine private constructor() {
     /** Save the complete chain state (all plugins) as a JSON string. */
     external fun nativeSaveChainState(): String?
 
+    /** Write the chain state to [path] in the binary preset format. */
+    external fun nativeSaveChainStateFile(path: String): Boolean
+
+    /** Rebuild the whole rack from a binary chain-state file in one native call. */
+    external fun nativeLoadChainStateFile(path: String): Boolean
+
     /** Restore a single plugin's state from decomposed arrays. */
     external fun nativeRestorePluginState(
         pluginIndex: Int,
@@ -351,11 +532,12 @@ class NativeEngine private constructor() {
     fun hideX11Display(displayNumber: Int) = nativeHideX11Display(displayNumber)
     fun resumeX11Display(displayNumber: Int) = nativeResumeX11Display(displayNumber)
     fun setSurfaceSize(displayNumber: Int, width: Int, height: Int) = nativeSetSurfaceSize(displayNumber, width, height)
-    fun injectTouch(displayNumber: Int, action: Int, x: Int, y: Int) = nativeInjectTouch(displayNumber, action, x, y)
+    fun injectTouch(displayNumber: Int, action: Int, x: Int, y: Int, timeNs: Long = 0L) = nativeInjectTouch(displayNumber, action, x, y, timeNs)
     fun isWidgetAtPoint(displayNumber: Int, x: Int, y: Int): Boolean = nativeIsWidgetAtPoint(displayNumber, x, y)
     fun requestX11Frame(displayNumber: Int) = nativeRequestX11Frame(displayNumber)
     fun getX11PluginSize(displayNumber: Int): IntArray = nativeGetX11PluginSize(displayNumber)
     fun getX11UIScale(displayNumber: Int): Float = nativeGetX11UIScale(displayNumber)
+    fun setX11AdaptiveUIScale(displayNumber: Int, enabled: Boolean) = nativeSetX11AdaptiveUIScale(displayNumber, enabled)
 
     /**
      * Ensure the X11 scratch directory exists and set on native side.
@@ -374,14 +556,22 @@ class NativeEngine private constructor() {
 
     fun destroyPluginUI(pluginIndex: Int) = nativeDestroyPluginUI(pluginIndex)
 
+    fun destroyPluginUIForDisplay(displayNumber: Int) = nativeDestroyPluginUIForDisplay(displayNumber)
+
+    fun hasWarmPluginUI(displayNumber: Int): Boolean = nativeHasWarmPluginUI(displayNumber)
+
     fun idlePluginUIs(): Boolean = nativeIdlePluginUIs()
 
     // --- Real-time recording ---
 
-    external fun nativeStartRecording(rawPath: String, processedPath: String): Boolean
+    external fun nativeStartRecording(rawPath: String, processedPath: String, format: Int): Boolean
     external fun nativeStopRecording()
     external fun nativeIsRecording(): Boolean
     external fun nativeGetRecordingDurationSec(): Double
+    external fun nativeSaveLastSeconds(rawPath: String, processedPath: String, seconds: Double, format: Int): Boolean
+    external fun nativeGetPreRollAvailableSec(): Double
+    external fun nativeIsSavingPreRoll(): Boolean
+    external fun nativeSetPreRollSeconds(seconds: Float)
 
     // --- WAV real-time playback ---
 
@@ -394,17 +584,52 @@ class NativeEngine private constructor() {
     external fun nativeGetWavPositionSec(): Double
     external fun nativeIsWavPlaying(): Boolean
     external fun nativeIsWavLoaded(): Boolean
-    external fun nativeSetChainBypass(bypass: Boolean)
+    external fun nativeBeginChainBatch()
+    external fun nativeCommitChainBatch()
+    external fun nativeArmPresets(paths: Array<String>)
+    external fun nativeSetPreloadBudgetMb(megabytes: Int)
+    external fun nativeSetChainCrossfadeFrames(frames: Int)
+    external fun nativeSetPluginRouting(pluginIndex: Int, group: Int, branch: Int): Boolean
+    external fun nativeSetBranchGain(group: Int, branch: Int, gain: Float)
+    external fun nativeSetPipelineStages(stages: Int)
+    external fun nativeRebalancePipeline()
     external fun nativeSetWavBypassChain(bypass: Boolean)
 
     // Kotlin-friendly wrapper methods
-    fun setChainBypass(bypass: Boolean) = nativeSetChainBypass(bypass)
+
+    /** Audio keeps running the current chain until [commitChainBatch] crossfades to the edited one. */
+    fun beginChainBatch() = nativeBeginChainBatch()
+    fun commitChainBatch() = nativeCommitChainBatch()
+
+    /**
+     * Setlist mode: prepare the chains in these binary preset files (next one first) in the
+     * background, so [loadChainStateFile] on one of them is a single swap.
+     */
+    fun armPresets(paths: List<String>) = nativeArmPresets(paths.toTypedArray())
+    fun setPreloadBudgetMb(megabytes: Int) = nativeSetPreloadBudgetMb(megabytes)
+    fun setChainCrossfadeFrames(frames: Int) = nativeSetChainCrossfadeFrames(frames)
+
+    /**
+     * Put a plugin on a parallel branch. Adjacent plugins with the same non-zero [group] form a
+     * split/merge block; plugins with the same [branch] run serially inside it. Group 0 = serial.
+     */
+    fun setPluginRouting(pluginIndex: Int, group: Int, branch: Int): Boolean =
+        nativeSetPluginRouting(pluginIndex, group, branch)
+    fun setBranchGain(group: Int, branch: Int, gain: Float) = nativeSetBranchGain(group, branch, gain)
+
+    /** Split the chain across [stages] cores (0/1 = off); adds (stages - 1) buffers of latency. */
+    fun setPipelineStages(stages: Int) = nativeSetPipelineStages(stages)
+    fun rebalancePipeline() = nativeRebalancePipeline()
     fun setWavBypassChain(bypass: Boolean) = nativeSetWavBypassChain(bypass)
 
     fun startEngine(sampleRate: Float = 48000f, inputDeviceId: Int = 0, outputDeviceId: Int = 0, bufferFrames: Int = 0): Boolean {
         return nativeStartEngine(sampleRate, inputDeviceId, outputDeviceId, bufferFrames)
     }
 
+    fun reconfigureEngine(sampleRate: Float = 48000f, inputDeviceId: Int = 0, outputDeviceId: Int = 0, bufferFrames: Int = 0): Boolean {
+        return nativeReconfigureEngine(sampleRate, inputDeviceId, outputDeviceId, bufferFrames)
+    }
+
     fun stopEngine() {
         nativeStopEngine()
     }
@@ -425,7 +650,10 @@ class NativeEngine private constructor() {
             outputLowLatency = arr[4] != 0,
             outputMMap = arr[5] != 0,
             outputCallback = arr[6] != 0,
-            framesPerBurst = arr[7]
+            framesPerBurst = arr[7],
+            inputZeroFilledFrames = arr[8],
+            inputSlippedFrames = arr[9],
+            inputDiscardedFrames = arr[10]
         )
     }
 
@@ -433,22 +661,82 @@ class NativeEngine private constructor() {
         return nativeGetLatencyMs()
     }
 
+    fun getRoundTripLatencyMs(): Double = nativeGetRoundTripLatencyMs()
+    fun startLatencyCalibration(): Boolean = nativeStartLatencyCalibration()
+    /** Measured frames, or [CALIBRATION_PENDING] / [CALIBRATION_FAILED]. */
+    fun pollLatencyCalibration(): Int = nativePollLatencyCalibration()
+    fun setMeasuredLatencyFrames(frames: Int) = nativeSetMeasuredLatencyFrames(frames)
+
     fun getInputLevel(): Float = nativeGetInputLevel()
     fun getOutputLevel(): Float = nativeGetOutputLevel()
     fun getCpuLoad(): Float = nativeGetCpuLoad()
+    val telemetry: TelemetryReader by lazy { TelemetryReader(nativeGetTelemetryBuffer()) }
+    fun getCallbackHistogram(): CallbackHistogram {
+        val arr = nativeGetCallbackStats()
+        val nLoad = arr[7]
+        val nInterval = arr[8]
+        return CallbackHistogram(
+            callbacks = arr[0],
+            nearMisses = arr[1],
+            deadlineMisses = arr[2],
+            maxWallUs = arr[3],
+            maxJitterUs = arr[4],
+            loadBucketPercent = arr[5],
+            intervalBucketPercent = arr[6],
+            loadBuckets = arr.copyOfRange(9, 9 + nLoad).toList(),
+            intervalBuckets = arr.copyOfRange(9 + nLoad, 9 + nLoad + nInterval).toList()
+        )
+    }
+    fun resetCallbackHistogram() = nativeResetCallbackStats()
+    fun setPluginProfiling(enabled: Boolean) = nativeSetPluginProfiling(enabled)
+    fun setMemoryLocking(locked: Boolean): Boolean = nativeSetMemoryLocking(locked)
+    fun setAnalysisSource(source: Int): Boolean = nativeSetAnalysisSource(source)
+    fun setSystemTraceEnabled(enabled: Boolean): Boolean = nativeSetSystemTraceEnabled(enabled)
+    fun openMidiInput(device: MidiDevice, portNumber: Int): Boolean = nativeOpenMidiInput(device, portNumber)
+    fun closeMidiInput() = nativeCloseMidiInput()
+    fun midiLearn(pluginIndex: Int, portIndex: Int, min: Float, max: Float, toggle: Boolean) =
+        nativeMidiLearn(pluginIndex, portIndex, min, max, toggle)
+    fun cancelMidiLearn() = nativeCancelMidiLearn()
+    fun isMidiLearning(): Boolean = nativeIsMidiLearning()
+    fun clearMidiMappings() = nativeClearMidiMappings()
+    fun getPluginTimings(): List<PluginTiming> {
+        val arr = nativeGetPluginTimings()
+        return (0 until arr.size / 5).map { i ->
+            PluginTiming(
+                lastUs = arr[i * 5],
+                avgUs = arr[i * 5 + 1],
+                p99Us = arr[i * 5 + 2],
+                silentSpikes = arr[i * 5 + 3].toInt(),
+                asleep = arr[i * 5 + 4] != 0f
+            )
+        }
+    }
     fun getXRunCount(): Int = nativeGetXRunCount()
     fun isInputClipping(): Boolean = nativeIsInputClipping()
     fun isOutputClipping(): Boolean = nativeIsOutputClipping()
     fun resetClipping() = nativeResetClipping()
 
+    @Volatile
+    private var catalog: PluginCatalog? = null
+
+    fun getPluginCatalogVersion(): Long = nativeGetPluginCatalogVersion()
+
+    /** All available plugins; decoded once per catalog version and shared until the registry changes. */
     fun getAvailablePlugins(): List<PluginInfo> {
-        return nativeGetAvailablePlugins().toList()
+        catalog?.let { if (it.version == nativeGetPluginCatalogVersion()) return it.plugins }
+        val decoded = nativeGetPluginCatalog()?.let { PluginCatalogDecoder.decode(it) } ?: return emptyList()
+        catalog = decoded
+        return decoded.plugins
     }
 
     fun addPluginToRack(pluginId: String, position: Int = -1): Int {
         return nativeAddPluginToRack(pluginId, position)
     }
 
+    fun setWarmPlugins(pluginIds: List<String>) {
+        nativeSetWarmPlugins(pluginIds.toTypedArray())
+    }
+
     fun removePluginFromRack(position: Int): Boolean {
         return nativeRemovePluginFromRack(position)
     }
@@ -469,10 +757,99 @@ class NativeEngine private constructor() {
         return nativeGetParameter(pluginIndex, portIndex)
     }
 
+    fun setPluginBypass(pluginIndex: Int, bypassed: Boolean): Boolean =
+        nativeSetPluginBypass(pluginIndex, bypassed)
+
+    fun isPluginBypassed(pluginIndex: Int): Boolean = nativeIsPluginBypassed(pluginIndex)
+
+    // Reused for all bulk parameter calls; grown on demand.
+    private var paramBuffer: FloatBuffer = allocateFloatBuffer(256)
+
+    private fun allocateFloatBuffer(floats: Int): FloatBuffer =
+        ByteBuffer.allocateDirect(floats * 4).order(ByteOrder.nativeOrder()).asFloatBuffer()
+
+    /** Fill [paramBuffer] via [read], growing it once if the first attempt did not fit. */
+    private inline fun readParams(read: (FloatBuffer) -> Int): Int {
+        var needed = read(paramBuffer)
+        if (needed > paramBuffer.capacity()) {
+            paramBuffer = allocateFloatBuffer(needed + 64)
+            needed = read(paramBuffer)
+        }
+        return if (needed <= paramBuffer.capacity()) needed else 0
+    }
+
+    private fun decodeParams(at: Int): Pair<Map<Int, Float>, Int> {
+        val count = paramBuffer.get(at).toInt()
+        val values = HashMap<Int, Float>(count * 2)
+        for (i in 0 until count) {
+            values[paramBuffer.get(at + 1 + 2 * i).toInt()] = paramBuffer.get(at + 2 + 2 * i)
+        }
+        return values to at + 1 + 2 * count
+    }
+
+    /** All control values of one plugin (port index -> value) in one JNI call. */
+    @Synchronized
+    fun getParameters(pluginIndex: Int): Map<Int, Float> {
+        if (readParams { nativeGetParameters(pluginIndex, it) } == 0) return emptyMap()
+        return decodeParams(0).first
+    }
+
+    /** Set several control ports of one plugin in one JNI call. */
+    @Synchronized
+    fun setParameters(pluginIndex: Int, values: Map<Int, Float>) {
+        if (values.isEmpty()) return
+        if (values.size * 2 > paramBuffer.capacity()) paramBuffer = allocateFloatBuffer(values.size * 2)
+        var i = 0
+        for ((port, value) in values) {
+            paramBuffer.put(i++, port.toFloat())
+            paramBuffer.put(i++, value)
+        }
+        nativeSetParameters(pluginIndex, paramBuffer, values.size)
+    }
+
+    /** Control values of every plugin in the rack, in chain order. */
+    @Synchronized
+    fun getAllParameters(): List<Map<Int, Float>> {
+        if (readParams { nativeGetAllParameters(it) } == 0) return emptyList()
+        val plugins = paramBuffer.get(0).toInt()
+        val result = ArrayList<Map<Int, Float>>(plugins)
+        var pos = 1
+        repeat(plugins) {
+            val (values, next) = decodeParams(pos)
+            result.add(values)
+            pos = next
+        }
+        return result
+    }
+
+    /** Apply values for every plugin in the rack (one map per plugin, in chain order). */
+    @Synchronized
+    fun setAllParameters(values: List<Map<Int, Float>>): Boolean {
+        val size = 1 + values.sumOf { 1 + 2 * it.size }
+        if (size > paramBuffer.capacity()) paramBuffer = allocateFloatBuffer(size)
+        var pos = 0
+        paramBuffer.put(pos++, values.size.toFloat())
+        for (plugin in values) {
+            paramBuffer.put(pos++, plugin.size.toFloat())
+            for ((port, value) in plugin) {
+                paramBuffer.put(pos++, port.toFloat())
+                paramBuffer.put(pos++, value)
+            }
+        }
+        return nativeSetAllParameters(paramBuffer, size)
+    }
+
     fun processFile(inputFile: File, outputFile: File): Boolean {
         return nativeProcessFile(inputFile.absolutePath, outputFile.absolutePath)
     }
 
+    fun processFiles(files: List<Pair<File, File>>): Int {
+        return nativeProcessFiles(
+            files.map { it.first.absolutePath }.toTypedArray(),
+            files.map { it.second.absolutePath }.toTypedArray()
+        )
+    }
+
     fun getRackSize(): Int {
         return nativeGetRackSize()
     }
@@ -491,11 +868,20 @@ class NativeEngine private constructor() {
     }
 
     // Recording wrappers
-    fun startRecording(rawPath: String, processedPath: String): Boolean = nativeStartRecording(rawPath, processedPath)
+    fun startRecording(rawPath: String, processedPath: String, format: Int = RECORD_FORMAT_PCM16): Boolean =
+        nativeStartRecording(rawPath, processedPath, format)
     fun stopRecording() = nativeStopRecording()
     fun isRecording(): Boolean = nativeIsRecording()
     fun getRecordingDurationSec(): Double = nativeGetRecordingDurationSec()
 
+    /** Retroactive capture from the pre-roll history; the files are written in the background. */
+    fun saveLastSeconds(rawPath: String, processedPath: String, seconds: Double, format: Int = RECORD_FORMAT_PCM16): Boolean =
+        nativeSaveLastSeconds(rawPath, processedPath, seconds, format)
+    fun getPreRollAvailableSec(): Double = nativeGetPreRollAvailableSec()
+    fun isSavingPreRoll(): Boolean = nativeIsSavingPreRoll()
+    /** Takes effect the next time the engine starts. */
+    fun setPreRollSeconds(seconds: Float) = nativeSetPreRollSeconds(seconds)
+
     // WAV playback wrappers
     fun loadWav(file: File): Boolean = nativeLoadWav(file.absolutePath)
     fun loadWav(path: String): Boolean = nativeLoadWav(path)
@@ -510,6 +896,8 @@ class NativeEngine private constructor() {
 
     // State save/restore wrappers
     fun saveChainState(): String? = nativeSaveChainState()
+    fun saveChainStateFile(path: String): Boolean = nativeSaveChainStateFile(path)
+    fun loadChainStateFile(path: String): Boolean = nativeLoadChainStateFile(path)
 
     fun restorePluginState(
         pluginIndex: Int,
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+package com.varcain.guitarrackcraft.engine
+
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Decodes the plugin catalog snapshot the native PluginRegistry hands over as a direct
+ * ByteBuffer (native PluginInfoCodec.h): one buffer for the whole catalog instead of a JNI
+ * object per plugin, port and scale point. Layout and constants mirror PluginInfoCodec.h.
+ */
+internal class PluginCatalog(val version: Long, val plugins: List<PluginInfo>)
+
+internal object PluginCatalogDecoder {
+    private val MAGIC = "GRCCATLG".toByteArray(Charsets.US_ASCII)
+    private const val LAYOUT_VERSION = 1
+
+    /** The catalog in [snapshot], or null if it is not one this build understands. */
+    fun decode(snapshot: ByteBuffer): PluginCatalog? {
+        val buf = snapshot.duplicate().order(ByteOrder.LITTLE_ENDIAN)
+        buf.rewind()
+        return try {
+            val magic = ByteArray(MAGIC.size)
+            buf.get(magic)
+            if (!magic.contentEquals(MAGIC) || buf.int != LAYOUT_VERSION) return null
+            val version = buf.long
+            val count = buf.int
+            val reader = Reader(buf)
+            val plugins = List(count) { reader.plugin() }
+            if (buf.hasRemaining()) null else PluginCatalog(version, plugins)
+        } catch (e: RuntimeException) {
+            // BufferUnderflowException / negative counts: a truncated or foreign buffer
+            null
+        }
+    }
+
+    private class Reader(private val buf: ByteBuffer) {
+        private var scratch = ByteArray(256)
+
+        fun str(): String {
+            val n = buf.int
+            if (n > scratch.size) scratch = ByteArray(n)
+            buf.get(scratch, 0, n)
+            return String(scratch, 0, n, Charsets.UTF_8)
+        }
+
+        fun plugin(): PluginInfo {
+            val id = str()
+            val name = str()
+            val format = str()
+            val modguiBasePath = str()
+            val modguiIconTemplate = str()
+            val hasX11Ui = buf.get().toInt() != 0
+            val x11UiBinaryPath = str()
+            val x11UiUri = str()
+            val ports = List(buf.int) { port() }
+            return PluginInfo(
+                id = id,
+                name = name,
+                format = format,
+                ports = ports,
+                modguiBasePath = modguiBasePath,
+                modguiIconTemplate = modguiIconTemplate,
+                hasX11Ui = hasX11Ui,
+                x11UiBinaryPath = x11UiBinaryPath,
+                x11UiUri = x11UiUri
+            )
+        }
+
+        private fun port(): PortInfo {
+            val index = buf.int
+            val name = str()
+            val symbol = str()
+            val flags = buf.get().toInt()
+            val defaultValue = buf.float
+            val minValue = buf.float
+            val maxValue = buf.float
+            val scalePoints = List(buf.int) { ScalePoint(label = str(), value = buf.float) }
+            return PortInfo(
+                index = index,
+                name = name,
+                symbol = symbol,
+                isInput = flags and 1 != 0,
+                isAudio = flags and 2 != 0,
+                isControl = flags and 4 != 0,
+                isToggle = flags and 8 != 0,
+                defaultValue = defaultValue,
+                minValue = minValue,
+                maxValue = maxValue,
+                scalePoints = scalePoints
+            )
+        }
+    }
+}
@@ -29,12 +29,16 @@ import java.io.File
 /**
  * Manages preset save/load using JSON files stored in filesDir/presets/.
  * Each preset captures the full chain state (all plugins' control ports + state properties).
+ * Alongside each JSON file a binary sidecar (.grcs) is written; loading prefers it, since the
+ * native side maps it and diffs it against the live rack in one call, keeping shared plugin
+ * instances. JSON remains the source of truth and export format.
  */
 class PresetManager(private val engine: NativeEngine) {
 
     companion object {
         private const val TAG = "PresetManager"
         private const val PRESETS_DIR = "presets"
+        private const val BINARY_EXT = "grcs"
     }
 
     private fun presetsDir(context: Context): File {
@@ -71,12 +75,20 @@ class PresetManager(private val engine: NativeEngine) {
 
         val file = File(presetsDir(context), "$name.json")
         file.writeText(root.toString(2))
+        // Written after the JSON so its mtime marks it as current
+        if (!engine.saveChainStateFile(binaryFile(context, name).absolutePath)) {
+            Log.w(TAG, "savePreset: binary sidecar not written for '$name'")
+        }
         Log.i(TAG, "savePreset: saved '$name' to ${file.absolutePath}")
         return true
     }
 
+    private fun binaryFile(context: Context, name: String): File =
+        File(presetsDir(context), "$name.$BINARY_EXT")
+
     /**
-     * Load a preset by name: reads the file and delegates to [loadPresetFromJson].
+     * Load a preset by name: restores from the binary sidecar when it is at least as new as the
+     * JSON file, otherwise (or if that fails) reads the JSON and delegates to [loadPresetFromJson].
      * @return true if all plugins restored successfully.
      */
     fun loadPreset(context: Context, name: String): Boolean {
@@ -85,7 +97,20 @@ class PresetManager(private val engine: NativeEngine) {
             Log.e(TAG, "loadPreset: file not found: ${file.absolutePath}")
             return false
         }
-        return loadPresetFromJson(file.readText())
+        val binary = binaryFile(context, name)
+        if (binary.exists() && binary.lastModified() >= file.lastModified()) {
+            if (engine.loadChainStateFile(binary.absolutePath)) {
+                Log.i(TAG, "loadPreset: restored '$name' from binary sidecar")
+                return true
+            }
+            Log.w(TAG, "loadPreset: binary sidecar for '$name' failed, falling back to JSON")
+        }
+        val ok = loadPresetFromJson(file.readText())
+        if (ok) {
+            // Presets saved before the binary format (or imported) switch fast from now on
+            engine.saveChainStateFile(binary.absolutePath)
+        }
+        return ok
     }
 
     /**
@@ -135,6 +160,15 @@ class PresetManager(private val engine: NativeEngine) {
         return allOk
     }
 
+    /**
+     * Preload the given presets (most important first) so switching to them is instant.
+     * Presets without a binary sidecar are skipped; they get one on their first load.
+     */
+    fun armPresets(context: Context, names: List<String>) {
+        val paths = names.map { binaryFile(context, it) }.filter { it.exists() }.map { it.absolutePath }
+        engine.armPresets(paths)
+    }
+
     /**
      * List all saved presets.
      * @return list of preset names (without .json extension).
@@ -154,6 +188,7 @@ class PresetManager(private val engine: NativeEngine) {
     fun deletePreset(context: Context, name: String): Boolean {
         val file = File(presetsDir(context), "$name.json")
         val ok = file.delete()
+        binaryFile(context, name).delete()
         Log.i(TAG, "deletePreset: '$name' deleted=$ok")
         return ok
     }
@@ -40,6 +40,9 @@ object RackManager {
 
     fun getAvailablePlugins(): List<PluginInfo> = native.getAvailablePlugins()
 
+    /** Changes whenever the plugin registry is rescanned; compare to skip refetching the catalog. */
+    fun getPluginCatalogVersion(): Long = native.getPluginCatalogVersion()
+
     fun addPlugin(pluginId: String, position: Int = -1): Int =
         native.addPluginToRack(pluginId, position)
 
@@ -53,6 +56,20 @@ object RackManager {
     fun getParameter(pluginIndex: Int, portIndex: Int): Float =
         native.getParameter(pluginIndex, portIndex)
 
+    fun setPluginBypass(pluginIndex: Int, bypassed: Boolean): Boolean =
+        native.setPluginBypass(pluginIndex, bypassed)
+
+    fun isPluginBypassed(pluginIndex: Int): Boolean = native.isPluginBypassed(pluginIndex)
+
+    fun getParameters(pluginIndex: Int): Map<Int, Float> = native.getParameters(pluginIndex)
+
+    fun setParameters(pluginIndex: Int, values: Map<Int, Float>) =
+        native.setParameters(pluginIndex, values)
+
+    fun getAllParameters(): List<Map<Int, Float>> = native.getAllParameters()
+
+    fun setAllParameters(values: List<Map<Int, Float>>): Boolean = native.setAllParameters(values)
+
     fun getRackSize(): Int = native.getRackSize()
 
     fun getRackPluginInfo(index: Int): PluginInfo? = native.getRackPluginInfo(index)
@@ -61,4 +78,6 @@ object RackManager {
 
     fun processFile(inputFile: File, outputFile: File): Boolean =
         native.processFile(inputFile, outputFile)
+
+    fun processFiles(files: List<Pair<File, File>>): Int = native.processFiles(files)
 }
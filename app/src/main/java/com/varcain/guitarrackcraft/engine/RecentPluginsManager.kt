@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+package com.varcain.guitarrackcraft.engine
+
+import android.content.Context
+
+/**
+ * Most recently added plugins, newest first. Together with the favorites they form the set
+ * of plugins the engine keeps a warm spare instance of.
+ */
+object RecentPluginsManager {
+    private const val PREFS_NAME = "plugin_recents"
+    private const val KEY_RECENTS = "recents"
+    private const val MAX_RECENTS = 8
+    private const val MAX_WARM = 16
+
+    private fun prefs(context: Context) =
+        context.getSharedPreferences(PREFS_NAME, Context.MODE_PRIVATE)
+
+    fun getRecent(context: Context): List<String> =
+        prefs(context).getString(KEY_RECENTS, null)
+            ?.split('\n')
+            ?.filter { it.isNotEmpty() }
+            ?: emptyList()
+
+    fun recordUse(context: Context, fullId: String) {
+        val updated = (listOf(fullId) + getRecent(context).filter { it != fullId }).take(MAX_RECENTS)
+        prefs(context).edit().putString(KEY_RECENTS, updated.joinToString("\n")).apply()
+    }
+
+    /** Recent plugins first (most likely next), then favorites. */
+    fun warmSet(context: Context): List<String> =
+        (getRecent(context) + FavoritesManager.getFavorites(context).sorted()).distinct().take(MAX_WARM)
+
+    /** Push the current warm set to the engine. */
+    fun updateEngine(context: Context) {
+        NativeEngine.getInstance().setWarmPlugins(warmSet(context))
+    }
+}
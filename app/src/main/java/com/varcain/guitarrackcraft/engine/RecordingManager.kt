@@ -51,6 +51,10 @@ object RecordingManager {
     private val fileTimestampFormat = SimpleDateFormat("yyyy-MM-dd_HH-mm-ss", Locale.US)
     private val displayFormat = SimpleDateFormat("MMM dd, yyyy h:mm:ss a", Locale.US)
 
+    /** Sample format of new recordings: one of NativeEngine.RECORD_FORMAT_*. */
+    @Volatile
+    var recordingFormat: Int = NativeEngine.RECORD_FORMAT_PCM16
+
     private fun recordingsDir(context: Context): File {
         val dir = File(context.filesDir, DIR_NAME)
         dir.mkdirs()
@@ -61,6 +65,29 @@ object RecordingManager {
         val engine = NativeEngine.getInstance()
         if (!engine.isEngineRunning()) return false
 
+        val format = recordingFormat
+        val (rawPath, processedPath) = newRecordingPaths(context, format)
+        return engine.startRecording(rawPath, processedPath, format)
+    }
+
+    /**
+     * Save the last [seconds] already played (raw and processed) as a new recording,
+     * from the engine's always-on pre-roll history.
+     */
+    fun saveLastSeconds(context: Context, seconds: Double): Boolean {
+        val engine = NativeEngine.getInstance()
+        if (!engine.isEngineRunning() || engine.getPreRollAvailableSec() <= 0.0) return false
+
+        val format = recordingFormat
+        val (rawPath, processedPath) = newRecordingPaths(context, format)
+        return engine.saveLastSeconds(rawPath, processedPath, seconds, format)
+    }
+
+    fun getPreRollAvailableSec(): Double = NativeEngine.getInstance().getPreRollAvailableSec()
+
+    /** Timestamped raw/processed paths for a new recording, plus its sidecar preset. */
+    private fun newRecordingPaths(context: Context, format: Int): Pair<String, String> {
+        val engine = NativeEngine.getInstance()
         val dir = recordingsDir(context)
         val ts = fileTimestampFormat.format(Date())
 
@@ -72,16 +99,15 @@ object RecordingManager {
                 val plugins = root.optJSONArray("plugins")
                 if (plugins != null && plugins.length() > 0) {
                     File(dir, "Preset_$ts.json").writeText(root.toString(2))
-                    Log.i(TAG, "startRecording: saved sidecar preset for $ts")
+                    Log.i(TAG, "newRecordingPaths: saved sidecar preset for $ts")
                 }
             }
         } catch (e: Exception) {
-            Log.e(TAG, "startRecording: failed to save sidecar preset", e)
+            Log.e(TAG, "newRecordingPaths: failed to save sidecar preset", e)
         }
 
-        val rawPath = File(dir, "Raw_$ts.wav").absolutePath
-        val processedPath = File(dir, "Processed_$ts.wav").absolutePath
-        return engine.startRecording(rawPath, processedPath)
+        val ext = if (isFlac(format)) "flac" else "wav"
+        return File(dir, "Raw_$ts.$ext").absolutePath to File(dir, "Processed_$ts.$ext").absolutePath
     }
 
     fun stopRecording() {
@@ -96,13 +122,16 @@ object RecordingManager {
         val dir = recordingsDir(context)
         if (!dir.exists()) return emptyList()
 
-        val rawFiles = dir.listFiles { f -> f.name.startsWith("Raw_") && f.name.endsWith(".wav") }
+        val rawFiles = dir.listFiles { f ->
+            f.name.startsWith("Raw_") && (f.name.endsWith(".wav") || f.name.endsWith(".flac"))
+        }
             ?.sortedByDescending { it.name }
             ?: return emptyList()
 
         return rawFiles.mapNotNull { rawFile ->
-            val ts = rawFile.name.removePrefix("Raw_").removeSuffix(".wav")
-            val processedFile = File(dir, "Processed_$ts.wav")
+            val ext = rawFile.extension
+            val ts = rawFile.name.removePrefix("Raw_").removeSuffix(".$ext")
+            val processedFile = File(dir, "Processed_$ts.$ext")
             if (!processedFile.exists()) return@mapNotNull null
 
             val displayName = try {
@@ -110,7 +139,7 @@ object RecordingManager {
                 if (date != null) displayFormat.format(date) else ts
             } catch (_: Exception) { ts }
 
-            val duration = getWavDurationFromHeader(rawFile)
+            val duration = if (ext == "flac") getFlacDurationFromHeader(rawFile) else getWavDurationFromHeader(rawFile)
 
             val presetFile = File(dir, "Preset_$ts.json")
 
@@ -131,6 +160,9 @@ object RecordingManager {
         entry.presetFile?.delete()
     }
 
+    private fun isFlac(format: Int): Boolean =
+        format == NativeEngine.RECORD_FORMAT_FLAC16 || format == NativeEngine.RECORD_FORMAT_FLAC24
+
     private fun readLeU16(raf: RandomAccessFile): Int {
         val b0 = raf.read()
         val b1 = raf.read()
@@ -167,4 +199,27 @@ object RecordingManager {
             0.0
         }
     }
+
+    /** Duration from STREAMINFO (sample rate and total samples), which the native writer keeps current. */
+    private fun getFlacDurationFromHeader(file: File): Double {
+        return try {
+            RandomAccessFile(file, "r").use { raf ->
+                if (raf.length() < 42) return 0.0
+                val magic = ByteArray(4)
+                raf.readFully(magic)
+                if (String(magic, Charsets.US_ASCII) != "fLaC") return 0.0
+                val info = ByteArray(8)
+                raf.seek(18)  // STREAMINFO byte 10: sample rate, channels, bps, total samples
+                raf.readFully(info)
+                val b = IntArray(8) { info[it].toInt() and 0xFF }
+                val sampleRate = (b[0] shl 12) or (b[1] shl 4) or (b[2] shr 4)
+                val totalSamples = ((b[3] and 0x0F).toLong() shl 32) or (b[4].toLong() shl 24) or
+                    (b[5].toLong() shl 16) or (b[6].toLong() shl 8) or b[7].toLong()
+                if (sampleRate == 0) return 0.0
+                totalSamples.toDouble() / sampleRate.toDouble()
+            }
+        } catch (_: Exception) {
+            0.0
+        }
+    }
 }
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2026 Kamil Lulko <kamil.lulko@gmail.com>
+ *
+ * This file is part of Guitar RackCraft.
+ *
+ * Guitar RackCraft is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Guitar RackCraft is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Guitar RackCraft. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+package com.varcain.guitarrackcraft.engine
+
+import android.os.Build
+import java.lang.invoke.VarHandle
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/** One consistent copy of the engine telemetry block. */
+data class TelemetrySnapshot(
+    val callbacks: Int,
+    val inputLevel: Float,
+    val outputLevel: Float,
+    val cpuLoad: Float,
+    val xRunCount: Int,
+    val inputClipping: Boolean,
+    val outputClipping: Boolean,
+    /** Core the audio callback last ran on (-1 unknown) and whether it is a performance core. */
+    val callbackCpu: Int,
+    val callbackOnPerformanceCore: Boolean,
+    /**
+     * Load shedding actions in force because the callback ran close to its deadline: plugin
+     * quality controls turned down, fast silence sleep, capped X11 UI rate, larger buffer.
+     */
+    val shedQuality: Boolean,
+    val shedFastSleep: Boolean,
+    val shedSlowUi: Boolean,
+    val shedLargeBuffer: Boolean,
+    /** Output control port values of each plugin in chain order, in port index order. */
+    val outputControls: List<FloatArray>
+)
+
+/** One consistent copy of the analysis tap's results (native AnalysisTap). */
+data class AnalysisSnapshot(
+    /** [AudioEngine.ANALYSIS_INPUT], the chain index being analyzed, or [AudioEngine.ANALYSIS_OFF]. */
+    val source: Int,
+    val updates: Int,
+    /** 0 when no clear pitch. */
+    val pitchHz: Float,
+    val pitchClarity: Float,
+    val rmsDb: Float,
+    /** Peak per log-spaced band from 20 Hz to Nyquist, dBFS. */
+    val spectrumDb: FloatArray,
+    /** Min/max per scope point, starting at a rising zero crossing. */
+    val scopeMin: FloatArray,
+    val scopeMax: FloatArray
+)
+
+/**
+ * Reads the telemetry block the audio thread publishes once per callback (native
+ * TelemetryBlock) straight from shared memory, so polling it every UI frame costs no JNI call.
+ * The block is a seqlock: copy it, and retry if the sequence was odd or moved meanwhile.
+ * Offsets mirror TelemetryBlock::Layout.
+ */
+class TelemetryReader internal constructor(shared: ByteBuffer) {
+    private val shared = shared.order(ByteOrder.nativeOrder())
+    private val bytes = ByteArray(shared.capacity())
+    private val copy = ByteBuffer.wrap(bytes).order(ByteOrder.nativeOrder())
+
+    @Volatile
+    private var fenceField = 0
+
+    /** Latest block, or null if the layout does not match or the writer kept interrupting. */
+    @Synchronized
+    fun read(): TelemetrySnapshot? {
+        if (bytes.size < HEADER_SIZE || shared.getInt(OFFSET_VERSION) != VERSION) return null
+        repeat(MAX_ATTEMPTS) {
+            val before = shared.getInt(OFFSET_SEQUENCE)
+            if (before and 1 == 0) {
+                loadFence()
+                shared.position(0)
+                shared.get(bytes, 0, HEADER_SIZE)
+                loadFence()
+                if (shared.getInt(OFFSET_SEQUENCE) == before) return decode()
+            }
+        }
+        return null
+    }
+
+    /** Latest analysis results under their own sequence, or null (layout mismatch, busy writer). */
+    @Synchronized
+    fun readAnalysis(): AnalysisSnapshot? {
+        if (bytes.size < TOTAL_SIZE || shared.getInt(OFFSET_VERSION) != VERSION) return null
+        repeat(MAX_ATTEMPTS) {
+            val before = shared.getInt(OFFSET_ANALYSIS)
+            if (before and 1 == 0) {
+                loadFence()
+                shared.position(OFFSET_ANALYSIS)
+                shared.get(bytes, OFFSET_ANALYSIS, ANALYSIS_SIZE)
+                loadFence()
+                if (shared.getInt(OFFSET_ANALYSIS) == before) return decodeAnalysis()
+            }
+        }
+        return null
+    }
+
+    private fun decodeAnalysis(): AnalysisSnapshot {
+        fun floats(offset: Int, count: Int) = FloatArray(count) { copy.getFloat(offset + 4 * it) }
+        return AnalysisSnapshot(
+            source = copy.getInt(OFFSET_ANALYSIS_SOURCE),
+            updates = copy.getInt(OFFSET_ANALYSIS_UPDATES),
+            pitchHz = copy.getFloat(OFFSET_PITCH_HZ),
+            pitchClarity = copy.getFloat(OFFSET_PITCH_CLARITY),
+            rmsDb = copy.getFloat(OFFSET_RMS_DB),
+            spectrumDb = floats(OFFSET_SPECTRUM, SPECTRUM_BANDS),
+            scopeMin = floats(OFFSET_SCOPE_MIN, SCOPE_POINTS),
+            scopeMax = floats(OFFSET_SCOPE_MAX, SCOPE_POINTS)
+        )
+    }
+
+    private fun decode(): TelemetrySnapshot {
+        val flags = copy.getInt(OFFSET_FLAGS)
+        val numPlugins = copy.getInt(OFFSET_NUM_PLUGINS).coerceIn(0, MAX_PLUGINS)
+        val controls = ArrayList<FloatArray>(numPlugins)
+        var value = 0
+        for (p in 0 until numPlugins) {
+            val count = copy.getInt(OFFSET_COUNTS + 4 * p).coerceIn(0, MAX_OUTPUT_CONTROLS - value)
+            controls.add(FloatArray(count) { copy.getFloat(OFFSET_VALUES + 4 * (value + it)) })
+            value += count
+        }
+        return TelemetrySnapshot(
+            callbacks = copy.getInt(OFFSET_CALLBACKS),
+            inputLevel = copy.getFloat(OFFSET_INPUT_LEVEL),
+            outputLevel = copy.getFloat(OFFSET_OUTPUT_LEVEL),
+            cpuLoad = copy.getFloat(OFFSET_CPU_LOAD),
+            xRunCount = copy.getInt(OFFSET_XRUNS),
+            inputClipping = flags and FLAG_INPUT_CLIPPING != 0,
+            outputClipping = flags and FLAG_OUTPUT_CLIPPING != 0,
+            callbackCpu = copy.getInt(OFFSET_CALLBACK_CPU),
+            callbackOnPerformanceCore = flags and FLAG_CALLBACK_ON_PERFORMANCE_CORE != 0,
+            shedQuality = flags and FLAG_SHED_QUALITY != 0,
+            shedFastSleep = flags and FLAG_SHED_FAST_SLEEP != 0,
+            shedSlowUi = flags and FLAG_SHED_SLOW_UI != 0,
+            shedLargeBuffer = flags and FLAG_SHED_LARGE_BUFFER != 0,
+            outputControls = controls
+        )
+    }
+
+    /** Keep the sequence reads on either side of the bulk copy. */
+    private fun loadFence() {
+        if (Build.VERSION.SDK_INT >= 33) {
+            VarHandle.acquireFence()
+        } else {
+            // Volatile store + load: ART emits release/acquire barriers around it
+            fenceField = 0
+            @Suppress("UNUSED_VARIABLE") val unused = fenceField
+        }
+    }
+
+    private companion object {
+        const val VERSION = 3
+        const val MAX_ATTEMPTS = 8
+        const val MAX_PLUGINS = 32
+        const val MAX_OUTPUT_CONTROLS = 256
+
+        const val OFFSET_SEQUENCE = 0
+        const val OFFSET_VERSION = 4
+        const val OFFSET_CALLBACKS = 8
+        const val OFFSET_FLAGS = 12
+        const val OFFSET_INPUT_LEVEL = 16
+        const val OFFSET_OUTPUT_LEVEL = 20
+        const val OFFSET_CPU_LOAD = 24
+        const val OFFSET_XRUNS = 28
+        const val OFFSET_CALLBACK_CPU = 32
+        const val OFFSET_NUM_PLUGINS = 36
+        const val OFFSET_COUNTS = 40
+        const val OFFSET_VALUES = OFFSET_COUNTS + 4 * MAX_PLUGINS
+        const val HEADER_SIZE = OFFSET_VALUES + 4 * MAX_OUTPUT_CONTROLS
+
+        // TelemetryBlock::Analysis, right after the header
+        const val SPECTRUM_BANDS = 128
+        const val SCOPE_POINTS = 256
+        const val OFFSET_ANALYSIS = HEADER_SIZE
+        const val OFFSET_ANALYSIS_SOURCE = OFFSET_ANALYSIS + 4
+        const val OFFSET_ANALYSIS_UPDATES = OFFSET_ANALYSIS + 8
+        const val OFFSET_PITCH_HZ = OFFSET_ANALYSIS + 12
+        const val OFFSET_PITCH_CLARITY = OFFSET_ANALYSIS + 16
+        const val OFFSET_RMS_DB = OFFSET_ANALYSIS + 20
+        const val OFFSET_SPECTRUM = OFFSET_ANALYSIS + 24
+        const val OFFSET_SCOPE_MIN = OFFSET_SPECTRUM + 4 * SPECTRUM_BANDS
+        const val OFFSET_SCOPE_MAX = OFFSET_SCOPE_MIN + 4 * SCOPE_POINTS
+        const val ANALYSIS_SIZE = OFFSET_SCOPE_MAX + 4 * SCOPE_POINTS - OFFSET_ANALYSIS
+        const val TOTAL_SIZE = OFFSET_ANALYSIS + ANALYSIS_SIZE
+
+        const val FLAG_INPUT_CLIPPING = 1
+        const val FLAG_OUTPUT_CLIPPING = 2
+        const val FLAG_CALLBACK_ON_PERFORMANCE_CORE = 4
+        const val FLAG_SHED_QUALITY = 8
+        const val FLAG_SHED_FAST_SLEEP = 16
+        const val FLAG_SHED_SLOW_UI = 32
+        const val FLAG_SHED_LARGE_BUFFER = 64
+    }
+}
@@ -41,11 +41,12 @@ object X11Bridge {
     fun hideX11Display(displayNumber: Int) = native.hideX11Display(displayNumber)
     fun resumeX11Display(displayNumber: Int) = native.resumeX11Display(displayNumber)
     fun setSurfaceSize(displayNumber: Int, width: Int, height: Int) = native.setSurfaceSize(displayNumber, width, height)
-    fun injectTouch(displayNumber: Int, action: Int, x: Int, y: Int) = native.injectTouch(displayNumber, action, x, y)
+    fun injectTouch(displayNumber: Int, action: Int, x: Int, y: Int, timeNs: Long = 0L) = native.injectTouch(displayNumber, action, x, y, timeNs)
     fun isWidgetAtPoint(displayNumber: Int, x: Int, y: Int): Boolean = native.isWidgetAtPoint(displayNumber, x, y)
     fun requestX11Frame(displayNumber: Int) = native.requestX11Frame(displayNumber)
     fun getX11PluginSize(displayNumber: Int): IntArray = native.getX11PluginSize(displayNumber)
     fun getX11UIScale(displayNumber: Int): Float = native.getX11UIScale(displayNumber)
+    fun setX11AdaptiveUIScale(displayNumber: Int, enabled: Boolean) = native.setX11AdaptiveUIScale(displayNumber, enabled)
 
     fun ensureX11LibsDir(context: Context): File = native.ensureX11LibsDir(context)
 
@@ -56,6 +57,8 @@ object X11Bridge {
         native.createPluginUI(pluginIndex, displayNumber, parentWindowId)
 
     fun destroyPluginUI(pluginIndex: Int) = native.destroyPluginUI(pluginIndex)
+    fun destroyPluginUIForDisplay(displayNumber: Int) = native.destroyPluginUIForDisplay(displayNumber)
+    fun hasWarmPluginUI(displayNumber: Int): Boolean = native.hasWarmPluginUI(displayNumber)
     fun idlePluginUIs(): Boolean = native.idlePluginUIs()
 
     fun pollFileRequest(): Array<String>? = native.nativePollFileRequest()
@@ -24,6 +24,7 @@ import android.content.Context
 import androidx.lifecycle.AndroidViewModel
 import androidx.lifecycle.viewModelScope
 import com.varcain.guitarrackcraft.engine.FavoritesManager
+import com.varcain.guitarrackcraft.engine.RecentPluginsManager
 import com.varcain.guitarrackcraft.engine.PluginInfo
 import com.varcain.guitarrackcraft.engine.RackManager
 import kotlinx.coroutines.Dispatchers
@@ -384,6 +385,8 @@ class PluginBrowserViewModel(application: Application) : AndroidViewModel(applic
             val index = RackManager.addPlugin(plugin.fullId, position)
             android.util.Log.i("PluginBrowser", "[LIFECYCLE] addPluginToRack result: ${plugin.name} -> index=$index")
             if (index >= 0) {
+                RecentPluginsManager.recordUse(appContext, plugin.fullId)
+                RecentPluginsManager.updateEngine(appContext)
                 true
             } else {
                 _addFailureMessage.value = "Could not add plugin. Plugin binaries (.so) are not included in this build—only metadata is available."
@@ -403,6 +406,8 @@ class PluginBrowserViewModel(application: Application) : AndroidViewModel(applic
             val index = RackManager.addPlugin(plugin.fullId, position)
             android.util.Log.i("PluginBrowser", "[LIFECYCLE] replacePluginInRack result: ${plugin.name} -> index=$index")
             if (index >= 0) {
+                RecentPluginsManager.recordUse(appContext, plugin.fullId)
+                RecentPluginsManager.updateEngine(appContext)
                 true
             } else {
                 _addFailureMessage.value = "Could not add plugin. Plugin binaries (.so) are not included in this build—only metadata is available."
@@ -422,6 +427,7 @@ class PluginBrowserViewModel(application: Application) : AndroidViewModel(applic
     fun toggleFavorite(pluginId: String) {
         FavoritesManager.toggleFavorite(appContext, pluginId)
         _favorites.value = FavoritesManager.getFavorites(appContext)
+        RecentPluginsManager.updateEngine(appContext)
         // Regroup to add/remove from Favorites section
         _groupedPlugins.value = groupPluginsByAuthorAndCategory(_plugins.value)
     }
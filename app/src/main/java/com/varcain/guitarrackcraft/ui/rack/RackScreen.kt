@@ -59,6 +59,7 @@ import androidx.compose.material.icons.filled.StopCircle
 import androidx.compose.material.icons.filled.SwapHoriz
 import androidx.compose.material.icons.filled.Tune
 import androidx.compose.material.icons.filled.PlayArrow
+import androidx.compose.material.icons.filled.PowerSettingsNew
 import androidx.compose.material.icons.filled.Stop
 import androidx.compose.material3.*
 import androidx.compose.material3.surfaceColorAtElevation
@@ -69,6 +70,7 @@ import androidx.compose.runtime.collectAsState
 import androidx.compose.runtime.getValue
 import androidx.compose.runtime.mutableStateListOf
 import androidx.compose.runtime.mutableStateOf
+import androidx.compose.runtime.produceState
 import androidx.compose.runtime.remember
 import androidx.compose.runtime.rememberUpdatedState
 import androidx.compose.runtime.saveable.rememberSaveable
@@ -270,6 +272,9 @@ fun RackScreen(
     val inputClipping by viewModel.inputClipping.collectAsState()
     val outputClipping by viewModel.outputClipping.collectAsState()
     val rackPlugins by viewModel.rackPlugins.collectAsState()
+    LaunchedEffect(rackPlugins) {
+        X11DisplayManager.pruneWarmDisplays(rackPlugins.map { it.instanceId }.toSet())
+    }
     val errorMessage by viewModel.errorMessage.collectAsState()
     val presetMessage by viewModel.presetMessage.collectAsState()
 
@@ -1230,6 +1235,25 @@ fun PluginCard(
                         fontWeight = FontWeight.Bold,
                         modifier = Modifier.weight(1f)
                     )
+                    // Bypass: the plugin stops running while off
+                    var bypassed by remember(plugin.instanceId) {
+                        mutableStateOf(viewModel.isPluginBypassed(pluginIndex))
+                    }
+                    IconButton(
+                        onClick = {
+                            bypassed = !bypassed
+                            viewModel.setPluginBypass(pluginIndex, bypassed)
+                        },
+                        modifier = Modifier.size(32.dp).testTag("plugin_card_bypass")
+                    ) {
+                        Icon(
+                            Icons.Default.PowerSettingsNew,
+                            contentDescription = if (bypassed) "Enable" else "Bypass",
+                            tint = if (bypassed) MaterialTheme.colorScheme.onSurface.copy(alpha = 0.38f)
+                                   else MaterialTheme.colorScheme.primary,
+                            modifier = Modifier.size(20.dp)
+                        )
+                    }
                     // Collapse
                     IconButton(
                         onClick = { expanded = !expanded },
@@ -1292,25 +1316,33 @@ fun PluginCard(
                 Spacer(modifier = Modifier.height(8.dp))
 
                 // Allocate X11 display number for this plugin — always kept alive while in rack.
-                // Display is only released when plugin is removed from rack (onDispose).
+                // A display parked by an earlier card for the same instance is reused warm.
                 var x11DisplayNumber by remember {
                     mutableStateOf(
-                        if (pluginInfo.hasX11Ui) X11DisplayManager.allocateDisplay() else -1
+                        if (pluginInfo.hasX11Ui) {
+                            X11DisplayManager.takeWarmDisplay(plugin.instanceId) ?: X11DisplayManager.allocateDisplay()
+                        } else -1
                     )
                 }
 
-                // Cleanup X11 display when plugin is removed from rack
+                // Park the X11 display if the plugin is still in the rack (card left the screen),
+                // release it if the plugin was removed
                 DisposableEffect(Unit) {
                     onDispose {
                         if (x11DisplayNumber >= 0) {
-                            Log.i("GuitarRackCraft.UI", "Plugin[$pluginIndex]: Releasing X11 display $x11DisplayNumber (removed from rack)")
                             val dispNum = x11DisplayNumber
-                            val pIdx = pluginIndex
                             x11DisplayNumber = -1
-                            X11DisplayManager.teardownExecutor.execute {
-                                X11Bridge.destroyPluginUI(pIdx)
-                                X11Bridge.detachAndDestroyX11DisplayIfExists(dispNum)
-                                X11DisplayManager.releaseDisplay(dispNum)
+                            if (viewModel.rackPlugins.value.any { it.instanceId == plugin.instanceId }) {
+                                Log.i("GuitarRackCraft.UI", "Plugin[$pluginIndex]: Parking X11 display $dispNum (still in rack)")
+                                X11DisplayManager.parkDisplay(plugin.instanceId, dispNum)
+                            } else {
+                                Log.i("GuitarRackCraft.UI", "Plugin[$pluginIndex]: Releasing X11 display $dispNum (removed from rack)")
+                                X11DisplayManager.teardownExecutor.execute {
+                                    // By display: removal has already shifted rack indices
+                                    X11Bridge.destroyPluginUIForDisplay(dispNum)
+                                    X11Bridge.detachAndDestroyX11DisplayIfExists(dispNum)
+                                    X11DisplayManager.releaseDisplay(dispNum)
+                                }
                             }
                         }
                     }
@@ -1433,7 +1465,7 @@ fun PluginCard(
                                     pluginIndex = pluginIndex,
                                     displayNumber = x11DisplayNumber,
                                     isVisible = expanded && currentUiMode == UiType.X11 && (!isAnyPluginFullscreen || isFullscreen),
-                                    shouldDestroyOnDispose = true,
+                                    shouldDestroyOnDispose = false,
                                     modifier = Modifier.fillMaxSize(),
                                     onPluginSizeKnown = { w, h, scale ->
                                         x11PluginNaturalW = w
@@ -1665,6 +1697,24 @@ fun PluginCard(
                         }
                         val controlPorts = pluginInfo.controlPorts
                         if (controlPorts.isNotEmpty()) {
+                            // Poll native values periodically so that changes made via the X11 UI
+                            // (or other external sources) are reflected in the slider controls.
+                            // One bulk read per card instead of one call per port.
+                            val nativeValues by produceState(
+                                initialValue = viewModel.getParameters(pluginIndex),
+                                pluginIndex
+                            ) {
+                                while (true) {
+                                    delay(200)
+                                    value = viewModel.getParameters(pluginIndex)
+                                }
+                            }
+                            // Output ports (meters) follow the telemetry block at the meter rate
+                            val outputControls by viewModel.pluginOutputControls.collectAsState()
+                            val outputValues = outputControls.getOrNull(pluginIndex)
+                            val outputPorts = remember(controlPorts) {
+                                controlPorts.filter { !it.isInput }.sortedBy { it.index }
+                            }
                             Divider()
                             Spacer(modifier = Modifier.height(8.dp))
                             Column(
@@ -1674,6 +1724,12 @@ fun PluginCard(
                                     ParameterControl(
                                         port = port,
                                         pluginIndex = pluginIndex,
+                                        nativeValue = if (port.isInput) {
+                                            nativeValues[port.index]
+                                        } else {
+                                            outputValues?.getOrNull(outputPorts.indexOf(port))
+                                                ?: nativeValues[port.index]
+                                        },
                                         viewModel = viewModel
                                     )
                                 }
@@ -1699,22 +1755,19 @@ fun PluginCard(
 fun ParameterControl(
     port: com.varcain.guitarrackcraft.engine.PortInfo,
     pluginIndex: Int,
+    nativeValue: Float?,
     viewModel: RackViewModel
 ) {
-    val currentValue = remember { mutableStateOf(viewModel.getParameter(pluginIndex, port.index)) }
+    val currentValue = remember {
+        mutableStateOf(nativeValue ?: viewModel.getParameter(pluginIndex, port.index))
+    }
     var isUserInteracting by remember { mutableStateOf(false) }
 
-    // Poll native parameter value periodically so that changes made via the X11 UI
-    // (or other external sources) are reflected in the Android slider controls.
-    LaunchedEffect(pluginIndex, port.index) {
-        while (true) {
-            delay(200)
-            if (!isUserInteracting) {
-                val nativeValue = viewModel.getParameter(pluginIndex, port.index)
-                if (kotlin.math.abs(nativeValue - currentValue.value) > 1e-5f) {
-                    currentValue.value = nativeValue
-                }
-            }
+    // Follow the value polled by the plugin card unless the user is dragging this control
+    LaunchedEffect(nativeValue) {
+        if (nativeValue != null && !isUserInteracting &&
+            kotlin.math.abs(nativeValue - currentValue.value) > 1e-5f) {
+            currentValue.value = nativeValue
         }
     }
 
@@ -24,6 +24,7 @@ import android.content.Context
 import androidx.lifecycle.AndroidViewModel
 import androidx.lifecycle.viewModelScope
 import com.varcain.guitarrackcraft.engine.AudioEngine
+import com.varcain.guitarrackcraft.engine.AudioSettingsManager
 import com.varcain.guitarrackcraft.engine.NativeEngine
 import com.varcain.guitarrackcraft.engine.PresetManager
 import com.varcain.guitarrackcraft.engine.RackManager
@@ -56,12 +57,25 @@ data class RackPlugin(
 
 class RackViewModel(application: Application) : AndroidViewModel(application) {
 
+    companion object {
+        /** Presets after the current one kept preloaded (see [PresetManager.armPresets]). */
+        private const val SETLIST_PRELOAD_COUNT = 2
+    }
+
     private val _isEngineRunning = MutableStateFlow(false)
     val isEngineRunning: StateFlow<Boolean> = _isEngineRunning.asStateFlow()
 
     private val _latencyMs = MutableStateFlow(0.0)
     val latencyMs: StateFlow<Double> = _latencyMs.asStateFlow()
 
+    /** True while a latency calibration burst is playing; see [calibrateLatency]. */
+    private val _isCalibrating = MutableStateFlow(false)
+    val isCalibrating: StateFlow<Boolean> = _isCalibrating.asStateFlow()
+
+    /** Last calibration outcome in ms, or null if it failed / never ran this session. */
+    private val _calibrationResultMs = MutableStateFlow<Double?>(null)
+    val calibrationResultMs: StateFlow<Double?> = _calibrationResultMs.asStateFlow()
+
     private val _inputLevel = MutableStateFlow(0f)
     val inputLevel: StateFlow<Float> = _inputLevel.asStateFlow()
 
@@ -71,6 +85,14 @@ class RackViewModel(application: Application) : AndroidViewModel(application) {
     private val _cpuLoad = MutableStateFlow(0f)
     val cpuLoad: StateFlow<Float> = _cpuLoad.asStateFlow()
 
+    /** Per-plugin average share of the callback budget, in rack order. */
+    private val _pluginLoads = MutableStateFlow<List<Float>>(emptyList())
+    val pluginLoads: StateFlow<List<Float>> = _pluginLoads.asStateFlow()
+
+    /** Output control port values per plugin (chain order, port index order), from telemetry. */
+    private val _pluginOutputControls = MutableStateFlow<List<FloatArray>>(emptyList())
+    val pluginOutputControls: StateFlow<List<FloatArray>> = _pluginOutputControls.asStateFlow()
+
     private val _xRunCount = MutableStateFlow(0)
     val xRunCount: StateFlow<Int> = _xRunCount.asStateFlow()
 
@@ -150,17 +172,25 @@ class RackViewModel(application: Application) : AndroidViewModel(application) {
             while (true) {
                 if (_isEngineRunning.value) {
                     try {
-                        _inputLevel.value = AudioEngine.getInputLevel()
-                        _outputLevel.value = AudioEngine.getOutputLevel()
-                        _inputClipping.value = AudioEngine.isInputClipping()
-                        _outputClipping.value = AudioEngine.isOutputClipping()
-                        cpuSum += AudioEngine.getCpuLoad()
-                        latencySum += AudioEngine.getLatencyMs()
+                        // Meters come from the shared telemetry block: no JNI call per value
+                        val telemetry = AudioEngine.readTelemetry()
+                        if (telemetry != null) {
+                            _inputLevel.value = telemetry.inputLevel
+                            _outputLevel.value = telemetry.outputLevel
+                            _inputClipping.value = telemetry.inputClipping
+                            _outputClipping.value = telemetry.outputClipping
+                            cpuSum += telemetry.cpuLoad
+                            _pluginOutputControls.value = telemetry.outputControls
+                        }
+                        latencySum += AudioEngine.getRoundTripLatencyMs()
                         sampleCount++
                         if (sampleCount >= 20) { // ~1 second (20 × 50ms)
                             _cpuLoad.value = cpuSum / sampleCount
                             _latencyMs.value = latencySum / sampleCount
-                            _xRunCount.value = AudioEngine.getXRunCount()
+                            _xRunCount.value = telemetry?.xRunCount ?: AudioEngine.getXRunCount()
+                            val rate = AudioEngine.getSampleRate()
+                            val budgetUs = if (rate > 0f) AudioEngine.getBufferFrameCount() * 1_000_000f / rate else 0f
+                            _pluginLoads.value = AudioEngine.getPluginTimings().map { it.load(budgetUs) }
                             cpuSum = 0f
                             latencySum = 0.0
                             sampleCount = 0
@@ -180,6 +210,12 @@ class RackViewModel(application: Application) : AndroidViewModel(application) {
         }
     }
 
+    /** Per-plugin timing costs clock reads on the audio thread; enable only while [pluginLoads] is shown. */
+    fun setPluginProfiling(enabled: Boolean) {
+        AudioEngine.setPluginProfiling(enabled)
+        if (!enabled) _pluginLoads.value = emptyList()
+    }
+
     fun startEngine(inputDeviceId: Int = 0, outputDeviceId: Int = 0, bufferFrames: Int = 0) {
         android.util.Log.i("AudioLifecycle", "RackViewModel.startEngine(input=$inputDeviceId, output=$outputDeviceId, buf=$bufferFrames) (thread=${Thread.currentThread().name})")
         viewModelScope.launch {
@@ -193,6 +229,11 @@ class RackViewModel(application: Application) : AndroidViewModel(application) {
                 _isEngineRunning.value = started
                 if (started) {
                     _errorMessage.value = null
+                    AudioEngine.setMeasuredLatencyFrames(
+                        AudioSettingsManager.getMeasuredLatencyFrames(
+                            getApplication(), inputDeviceId, outputDeviceId, bufferFrames
+                        )
+                    )
                 }
             } catch (e: Exception) {
                 _errorMessage.value = "Failed to start engine: ${e.message}"
@@ -209,9 +250,60 @@ class RackViewModel(application: Application) : AndroidViewModel(application) {
             val outputId = com.varcain.guitarrackcraft.engine.AudioSettingsManager.getOutputDeviceId(context)
             val bufSize = com.varcain.guitarrackcraft.engine.AudioSettingsManager.getBufferSize(context)
             android.util.Log.i("AudioLifecycle", "RackViewModel.restartEngine(input=$inputId, output=$outputId, buf=$bufSize)")
-            stopEngine()
-            delay(100)
-            startEngine(inputDeviceId = inputId, outputDeviceId = outputId, bufferFrames = bufSize)
+            if (!_isEngineRunning.value) {
+                startEngine(inputDeviceId = inputId, outputDeviceId = outputId, bufferFrames = bufSize)
+                return@launch
+            }
+            // Streams only: the chain keeps running and plugins keep their state
+            stopRecording()
+            val running = AudioEngine.reconfigure(
+                inputDeviceId = inputId,
+                outputDeviceId = outputId,
+                bufferFrames = bufSize
+            )
+            _isEngineRunning.value = running
+            if (running) {
+                _errorMessage.value = null
+                AudioEngine.setMeasuredLatencyFrames(
+                    AudioSettingsManager.getMeasuredLatencyFrames(getApplication(), inputId, outputId, bufSize)
+                )
+            } else {
+                _errorMessage.value = "Failed to restart engine with the new audio settings"
+            }
+        }
+    }
+
+    /**
+     * Measure the real input-to-output latency with an MLS burst (needs a loopback cable
+     * or the mic hearing the speaker) and store it for the current devices and buffer size.
+     */
+    fun calibrateLatency(context: Context) {
+        if (_isCalibrating.value || !_isEngineRunning.value) return
+        viewModelScope.launch {
+            _isCalibrating.value = true
+            _calibrationResultMs.value = null
+            try {
+                if (!AudioEngine.startLatencyCalibration()) return@launch
+                var result = NativeEngine.CALIBRATION_PENDING
+                while (result == NativeEngine.CALIBRATION_PENDING) {
+                    delay(100)
+                    result = withContext(Dispatchers.Default) { AudioEngine.pollLatencyCalibration() }
+                }
+                if (result >= 0) {
+                    AudioSettingsManager.setMeasuredLatencyFrames(
+                        context,
+                        AudioSettingsManager.getInputDeviceId(context),
+                        AudioSettingsManager.getOutputDeviceId(context),
+                        AudioSettingsManager.getBufferSize(context),
+                        result
+                    )
+                    _calibrationResultMs.value = AudioEngine.getRoundTripLatencyMs()
+                } else {
+                    _errorMessage.value = "Latency calibration failed: no clear echo on the input"
+                }
+            } finally {
+                _isCalibrating.value = false
+            }
         }
     }
 
@@ -388,6 +480,24 @@ class RackViewModel(application: Application) : AndroidViewModel(application) {
         }
     }
 
+    fun setPluginBypass(pluginIndex: Int, bypassed: Boolean) {
+        viewModelScope.launch {
+            try {
+                RackManager.setPluginBypass(pluginIndex, bypassed)
+            } catch (e: Exception) {
+                _errorMessage.value = "Failed to bypass plugin: ${e.message}"
+            }
+        }
+    }
+
+    fun isPluginBypassed(pluginIndex: Int): Boolean {
+        return try {
+            RackManager.isPluginBypassed(pluginIndex)
+        } catch (e: Exception) {
+            false
+        }
+    }
+
     fun getParameter(pluginIndex: Int, portIndex: Int): Float {
         return try {
             RackManager.getParameter(pluginIndex, portIndex)
@@ -396,6 +506,15 @@ class RackViewModel(application: Application) : AndroidViewModel(application) {
         }
     }
 
+    /** All control values of one plugin (port index -> value) in a single native call. */
+    fun getParameters(pluginIndex: Int): Map<Int, Float> {
+        return try {
+            RackManager.getParameters(pluginIndex)
+        } catch (e: Exception) {
+            emptyMap()
+        }
+    }
+
     /**
      * Returns the UI type to use for this plugin: last user choice if stored and still available,
      * otherwise the default (MODGUI > Native > Sliders).
@@ -469,17 +588,18 @@ class RackViewModel(application: Application) : AndroidViewModel(application) {
         viewModelScope.launch {
             val engine = NativeEngine.getInstance()
             val ok = withContext(Dispatchers.IO) {
-                engine.setChainBypass(true)
+                engine.beginChainBatch()
                 try {
                     presetManager.loadPreset(ctx, name)
                 } finally {
-                    engine.setChainBypass(false)
+                    engine.commitChainBatch()
                 }
             }
             if (ok) {
                 ensureRecentManager(ctx).addRecent(name)
                 refreshPresets(ctx)
                 refreshRack(forceNewInstanceIds = true)
+                armFollowingPresets(ctx, name)
                 _presetMessage.value = "Preset '$name' loaded"
             } else {
                 _presetMessage.value = "Failed to load preset (plugin count mismatch?)"
@@ -491,11 +611,11 @@ class RackViewModel(application: Application) : AndroidViewModel(application) {
         viewModelScope.launch {
             val engine = NativeEngine.getInstance()
             val ok = withContext(Dispatchers.IO) {
-                engine.setChainBypass(true)
+                engine.beginChainBatch()
                 try {
                     presetManager.loadPresetFromJson(json)
                 } finally {
-                    engine.setChainBypass(false)
+                    engine.commitChainBatch()
                 }
             }
             if (ok) {
@@ -507,6 +627,17 @@ class RackViewModel(application: Application) : AndroidViewModel(application) {
         }
     }
 
+    /** Setlist order is the preset list: keep the next presets after [name] ready to switch to. */
+    private fun armFollowingPresets(ctx: Context, name: String) {
+        val list = _presetList.value
+        val index = list.indexOf(name)
+        if (index < 0) return
+        val following = list.drop(index + 1).take(SETLIST_PRELOAD_COUNT)
+        viewModelScope.launch(Dispatchers.IO) {
+            presetManager.armPresets(ctx, following)
+        }
+    }
+
     fun deletePreset(ctx: Context, name: String) {
         viewModelScope.launch {
             presetManager.deletePreset(ctx, name)
@@ -127,6 +127,9 @@ fun AudioSettingsScreen(
                 val sampleRate = remember(refreshKey) { AudioEngine.getSampleRate() }
                 val bufferFrames = remember(refreshKey) { AudioEngine.getBufferFrameCount() }
                 val streamInfo = remember(refreshKey) { AudioEngine.getStreamInfo() }
+                val isCalibrating by viewModel.isCalibrating.collectAsState()
+                val calibrationMs by viewModel.calibrationResultMs.collectAsState()
+                val roundTripMs = remember(refreshKey, calibrationMs) { AudioEngine.getRoundTripLatencyMs() }
 
                 Divider()
                 Text(
@@ -138,6 +141,30 @@ fun AudioSettingsScreen(
                 InfoRow("Buffer Size", "$bufferFrames frames")
                 InfoRow("Burst Size", "${streamInfo.framesPerBurst} frames")
                 InfoRow("Audio Format", "32-bit Float")
+                InfoRow("Round-Trip Latency", "%.1f ms".format(roundTripMs))
+                Row(
+                    modifier = Modifier.fillMaxWidth(),
+                    horizontalArrangement = Arrangement.SpaceBetween,
+                    verticalAlignment = Alignment.CenterVertically
+                ) {
+                    Text(
+                        text = calibrationMs?.let { "Measured: %.1f ms".format(it) }
+                            ?: "Loopback cable or speaker near mic",
+                        style = MaterialTheme.typography.bodySmall,
+                        color = MaterialTheme.colorScheme.onSurfaceVariant
+                    )
+                    OutlinedButton(
+                        onClick = { viewModel.calibrateLatency(context) },
+                        enabled = !isCalibrating
+                    ) {
+                        Text(if (isCalibrating) "Measuring…" else "Measure Latency")
+                    }
+                }
+                InfoRow(
+                    "Input Dropouts",
+                    "${streamInfo.inputZeroFilledFrames} frames zero-filled, " +
+                        "${streamInfo.inputSlippedFrames} slips"
+                )
 
                 Spacer(modifier = Modifier.height(4.dp))
                 Divider()
@@ -161,6 +188,12 @@ fun AudioSettingsScreen(
                 ChecklistItem("Sample rate: 48000 Hz", sampleRate.toInt() == 48000, "%.0f Hz".format(sampleRate))
                 ChecklistItem("Data callback", streamInfo.outputCallback)
                 ChecklistItem("MMAP buffer", streamInfo.outputMMap)
+                val telemetry = remember(refreshKey) { AudioEngine.readTelemetry() }
+                ChecklistItem(
+                    "Callback on performance core",
+                    telemetry?.callbackOnPerformanceCore == true,
+                    telemetry?.callbackCpu?.takeIf { it >= 0 }?.let { "CPU $it" }
+                )
             }
         }
     }
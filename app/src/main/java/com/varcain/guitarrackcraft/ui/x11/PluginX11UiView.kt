@@ -98,6 +98,18 @@ private fun buildX11TouchListener(
                 true
             }
             MotionEvent.ACTION_MOVE -> {
+                // Batched samples first, with their own times: the native side merges them
+                // and estimates the finger velocity for prediction
+                for (i in 0 until event.historySize) {
+                    val hx = event.getHistoricalX(i)
+                    val hy = event.getHistoricalY(i)
+                    accumulatedX += (hx - lastRawX) * VELOCITY_SCALE
+                    accumulatedY += (hy - lastRawY) * VELOCITY_SCALE
+                    lastRawX = hx
+                    lastRawY = hy
+                    X11Bridge.injectTouch(displayNumber, 2, accumulatedX.toInt(), accumulatedY.toInt(),
+                        event.getHistoricalEventTime(i) * 1_000_000L)
+                }
                 val deltaX = event.x - lastRawX
                 val deltaY = event.y - lastRawY
                 accumulatedX += deltaX * VELOCITY_SCALE
@@ -105,7 +117,8 @@ private fun buildX11TouchListener(
                 lastRawX = event.x
                 lastRawY = event.y
                 X11DisplayManager.updateLastTouchTime(SystemClock.elapsedRealtimeNanos())
-                X11Bridge.injectTouch(displayNumber, 2, accumulatedX.toInt(), accumulatedY.toInt())
+                X11Bridge.injectTouch(displayNumber, 2, accumulatedX.toInt(), accumulatedY.toInt(),
+                    event.eventTime * 1_000_000L)
                 X11Bridge.requestX11Frame(displayNumber)
                 true
             }
@@ -238,6 +251,20 @@ fun PluginX11UiView(
                     attached = false
                     return
                 }
+                X11Bridge.setX11AdaptiveUIScale(displayNumber, true)
+                if (X11Bridge.hasWarmPluginUI(displayNumber)) {
+                    // Parked display (X11DisplayManager.parkDisplay): the UI is still instantiated and
+                    // the attach swapped in the new surface and sent Expose, so skip createPluginUI.
+                    Log.i("AudioLifecycle", "PluginX11UiView attachSurfaceToDisplay ok rootId=$rootId -> reusing warm plugin UI")
+                    isReady = true
+                    onUiReady()
+                    val sizeArr = X11Bridge.getX11PluginSize(displayNumber)
+                    if (sizeArr[0] > 0 && sizeArr[1] > 0) {
+                        onPluginSizeKnown(sizeArr[0], sizeArr[1], X11Bridge.getX11UIScale(displayNumber))
+                    }
+                    X11Bridge.requestX11Frame(displayNumber)
+                    return
+                }
                 Log.i("AudioLifecycle", "PluginX11UiView attachSurfaceToDisplay ok rootId=$rootId -> nativeBeginCreatePluginUI then create")
                 X11Bridge.beginCreatePluginUI(displayNumber, pluginIndex)
                 // Each plugin uses its own X11 display + pluginUI thread, so
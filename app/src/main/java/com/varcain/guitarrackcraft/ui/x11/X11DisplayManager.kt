@@ -73,6 +73,26 @@ object X11DisplayManager {
 
     private val allocatedDisplays = mutableSetOf<Int>()
 
+    /** Default for [maxWarmDisplays]. */
+    const val DEFAULT_MAX_WARM_DISPLAYS = 4
+
+    /**
+     * Displays kept alive, with their plugin UI instantiated but hidden, after their rack card
+     * left the composition (e.g. navigating away from the rack). Keyed by
+     * RackPlugin.instanceId, least recently parked first.
+     */
+    private val warmDisplays = LinkedHashMap<Long, Int>()
+
+    /** How many hidden UIs [parkDisplay] keeps warm; the least recently parked beyond this are torn down. */
+    var maxWarmDisplays: Int = DEFAULT_MAX_WARM_DISPLAYS
+        set(value) {
+            val evicted = synchronized(this) {
+                field = value.coerceAtLeast(0)
+                trimWarmLocked()
+            }
+            evicted.forEach { destroyWarm(it) }
+        }
+
     /**
      * Allocate a new X11 display number.
      * @return Display number (e.g., 10 for display :10), or -1 if none available
@@ -106,6 +126,61 @@ object X11DisplayManager {
         }
     }
 
+    /**
+     * Take the warm display of a plugin instance for reuse, or null if it has none. The display
+     * stays allocated; attaching a surface to it reopens the UI without instantiating it again.
+     */
+    @Synchronized
+    fun takeWarmDisplay(instanceId: Long): Int? {
+        val display = warmDisplays.remove(instanceId) ?: return null
+        Log.i(TAG, "[DISPLAY-LIFECYCLE] REUSING warm display :$display for instance $instanceId")
+        return display
+    }
+
+    /**
+     * Hide a display whose card left the composition while its plugin stays in the rack, and keep
+     * it (server, connection, instantiated UI) for [takeWarmDisplay]. Over [maxWarmDisplays], the
+     * least recently parked display is destroyed and released.
+     */
+    fun parkDisplay(instanceId: Long, displayNumber: Int) {
+        X11Bridge.hideX11Display(displayNumber)
+        val evicted = synchronized(this) {
+            warmDisplays.remove(instanceId)
+            warmDisplays[instanceId] = displayNumber
+            Log.i(TAG, "[DISPLAY-LIFECYCLE] PARKED display :$displayNumber for instance $instanceId (warm: ${warmDisplays.size}/$maxWarmDisplays)")
+            trimWarmLocked()
+        }
+        evicted.forEach { destroyWarm(it) }
+    }
+
+    /** Tear down warm displays whose plugin instance is no longer in the rack. */
+    fun pruneWarmDisplays(liveInstanceIds: Set<Long>) {
+        val evicted = synchronized(this) {
+            val dead = warmDisplays.keys.filter { it !in liveInstanceIds }
+            dead.mapNotNull { warmDisplays.remove(it) }
+        }
+        evicted.forEach { destroyWarm(it) }
+    }
+
+    private fun trimWarmLocked(): List<Int> {
+        val evicted = mutableListOf<Int>()
+        val it = warmDisplays.entries.iterator()
+        while (warmDisplays.size - evicted.size > maxWarmDisplays && it.hasNext()) {
+            evicted.add(it.next().value)
+            it.remove()
+        }
+        return evicted
+    }
+
+    private fun destroyWarm(displayNumber: Int) {
+        Log.i(TAG, "[DISPLAY-LIFECYCLE] EVICTING warm display :$displayNumber")
+        teardownExecutor.execute {
+            X11Bridge.destroyPluginUIForDisplay(displayNumber)
+            X11Bridge.detachAndDestroyX11DisplayIfExists(displayNumber)
+            releaseDisplay(displayNumber)
+        }
+    }
+
     /**
      * Check if a display number is currently allocated.
      */
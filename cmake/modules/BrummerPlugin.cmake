@@ -118,6 +118,7 @@ function(brummer_add_ui_target TARGET_NAME OUTPUT_NAME SOURCE BUILD_DIR XPUTTY_T
         "${X11_SYSROOT}/lib/libcairo.a"
         "${X11_SYSROOT}/lib/libpixman-1.a"
         "${X11_SYSROOT}/lib/libpng.a"
+        "${X11_SYSROOT}/lib/libXext.a"
         -L"${X11_SYSROOT}/lib"
         X11 xcb Xau
         xshm_stub
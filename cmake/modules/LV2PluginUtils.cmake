@@ -150,3 +150,35 @@ function(lv2_strip_and_save_debug TARGET_NAME BINARY_PATH)
         COMMENT "Stripping ${TARGET_NAME} (debug copy saved to ${_debug_path})"
     )
 endfunction()
+
+# ─── CPU-tuned DSP variants ───────────────────────────────────────────────────
+# Heavy DSP plugins (NAM, AIDA-X) are additionally built for newer arm64 tiers and
+# shipped as lib<name>_<tier>.so next to the baseline lib<name>.so. At startup the
+# app's LV2PluginFactory points lv2:binary at the best one the CPU supports
+# (getauxval(AT_HWCAP), app/src/main/cpp/utils/CpuFeatures.h); tier names and
+# -march values here must match that file.
+set(GRC_TUNED_DSP_VARIANTS ON CACHE BOOL "Build CPU-tuned variants of heavy DSP plugins")
+set(GRC_DSP_VARIANTS "armv82;armv9")
+set(GRC_DSP_VARIANT_MARCH_armv82 "armv8.2-a+dotprod+fp16")
+set(GRC_DSP_VARIANT_MARCH_armv9 "armv9-a+sve2")
+
+# Usage: lv2_sync_variant_to_jnilibs(TARGET_NAME SO_PATH TIER DEPENDS_LIST)
+#
+# Copies SO_PATH (<name>.so from a variant build) to jniLibs as lib<name>_<TIER>.so.
+function(lv2_sync_variant_to_jnilibs TARGET_NAME SO_PATH TIER DEPENDS_LIST)
+    get_filename_component(_stem "${SO_PATH}" NAME_WE)
+    set(_dest "${JNILIBS_DIR}/lib${_stem}_${TIER}.so")
+    set(_stamp "${CMAKE_BINARY_DIR}/stamps/${TARGET_NAME}.stamp")
+    file(MAKE_DIRECTORY "${CMAKE_BINARY_DIR}/stamps")
+
+    add_custom_command(
+        OUTPUT "${_stamp}"
+        COMMAND ${CMAKE_COMMAND} -E make_directory "${JNILIBS_DIR}"
+        COMMAND ${CMAKE_COMMAND} -E copy_if_different "${SO_PATH}" "${_dest}"
+        COMMAND ${NDK_STRIP} --strip-unneeded "${_dest}"
+        COMMAND ${CMAKE_COMMAND} -E touch "${_stamp}"
+        DEPENDS ${DEPENDS_LIST}
+        COMMENT "Syncing ${_stem} (${TIER}) to jniLibs"
+    )
+    add_custom_target(${TARGET_NAME} DEPENDS "${_stamp}")
+endfunction()
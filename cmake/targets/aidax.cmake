@@ -49,21 +49,25 @@ endif()
 # ─── Phase 2: CMake cross-compile ────────────────────────────────────────────
 set(_aidax_so_output "${_aidax_build}/rt-neural-generic/rt-neural-generic.so")
 
+set(_aidax_cmake_args
+    -DCMAKE_TOOLCHAIN_FILE=${CMAKE_TOOLCHAIN_FILE}
+    -DANDROID_ABI=${ANDROID_ABI}
+    -DANDROID_PLATFORM=${ANDROID_PLATFORM}
+    -DCMAKE_BUILD_TYPE=Release
+    -DRTNEURAL_XSIMD=ON
+    -DCMAKE_SHARED_LINKER_FLAGS_RELEASE=-Wl,--as-needed\ -Wl,--strip-all
+    -DCMAKE_PREFIX_PATH=${LV2_PREFIX}
+    -DCMAKE_FIND_ROOT_PATH_MODE_PACKAGE=BOTH
+    ${NDK_CCACHE_CMAKE_ARGS}
+)
+
 ExternalProject_Add(aidax_build
     SOURCE_DIR      "${_aidax_src}"
     BINARY_DIR      "${_aidax_build}"
     INSTALL_DIR     "${_aidax_assets}"
     CMAKE_ARGS
-        -DCMAKE_TOOLCHAIN_FILE=${CMAKE_TOOLCHAIN_FILE}
-        -DANDROID_ABI=${ANDROID_ABI}
-        -DANDROID_PLATFORM=${ANDROID_PLATFORM}
-        -DCMAKE_BUILD_TYPE=Release
-        -DRTNEURAL_XSIMD=ON
+        ${_aidax_cmake_args}
         -DCMAKE_CXX_FLAGS_RELEASE=-O3\ -DNDEBUG\ -funroll-loops
-        -DCMAKE_SHARED_LINKER_FLAGS_RELEASE=-Wl,--as-needed\ -Wl,--strip-all
-        -DCMAKE_PREFIX_PATH=${LV2_PREFIX}
-        -DCMAKE_FIND_ROOT_PATH_MODE_PACKAGE=BOTH
-        ${NDK_CCACHE_CMAKE_ARGS}
     BUILD_COMMAND   ${CMAKE_COMMAND} --build <BINARY_DIR> -j${NJOBS}
     INSTALL_COMMAND ""
     DEPENDS         lv2_libs
@@ -74,7 +78,35 @@ ExternalProject_Add(aidax_build
 
 watch_external_sources(aidax_build DIRECTORIES "${_aidax_src}/rt-neural-generic")
 
+# CPU-tuned variants (GRC_DSP_VARIANTS). RTNeural's xsimd backend stays on NEON kernels;
+# the tiers buy dotprod/fp16/SVE2 code generation for everything around them.
+set(_aidax_variant_syncs "")
+if(GRC_TUNED_DSP_VARIANTS)
+    foreach(_tier IN LISTS GRC_DSP_VARIANTS)
+        set(_aidax_tier_build "${_aidax_build}_${_tier}")
+        set(_aidax_tier_so "${_aidax_tier_build}/rt-neural-generic/rt-neural-generic.so")
+        set(_aidax_tier_flags "-O3 -DNDEBUG -funroll-loops -march=${GRC_DSP_VARIANT_MARCH_${_tier}}")
+        ExternalProject_Add(aidax_build_${_tier}
+            SOURCE_DIR      "${_aidax_src}"
+            BINARY_DIR      "${_aidax_tier_build}"
+            CMAKE_ARGS
+                ${_aidax_cmake_args}
+                "-DCMAKE_C_FLAGS_RELEASE=${_aidax_tier_flags}"
+                "-DCMAKE_CXX_FLAGS_RELEASE=${_aidax_tier_flags}"
+            BUILD_COMMAND   ${CMAKE_COMMAND} --build <BINARY_DIR> -j${NJOBS}
+            INSTALL_COMMAND ""
+            DEPENDS         lv2_libs
+            BUILD_BYPRODUCTS "${_aidax_tier_so}"
+            LOG_CONFIGURE TRUE
+            LOG_BUILD TRUE
+        )
+        watch_external_sources(aidax_build_${_tier} DIRECTORIES "${_aidax_src}/rt-neural-generic")
+        lv2_sync_variant_to_jnilibs(aidax_sync_${_tier} "${_aidax_tier_so}" ${_tier} "${_aidax_tier_so}")
+        list(APPEND _aidax_variant_syncs aidax_sync_${_tier})
+    endforeach()
+endif()
+
 # ─── Phase 3: Sync to assets + jniLibs ──────────────────────────────────────
 lv2_sync_to_jnilibs(aidax_sync "${_aidax_build}/rt-neural-generic" "${_aidax_so_output}")
 
-add_custom_target(aidax_done DEPENDS aidax_sync)
+add_custom_target(aidax_done DEPENDS aidax_sync ${_aidax_variant_syncs})
@@ -93,6 +93,7 @@ target_link_libraries(gxcabsim_ui PRIVATE
     "${X11_SYSROOT}/lib/libcairo.a"
     "${X11_SYSROOT}/lib/libpixman-1.a"
     "${X11_SYSROOT}/lib/libpng.a"
+    "${X11_SYSROOT}/lib/libXext.a"
     -L"${X11_SYSROOT}/lib"
     X11 xcb Xau
     xshm_stub
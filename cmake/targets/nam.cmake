@@ -77,21 +77,24 @@ fi
 
 set(_nam_so_output "${_nam_build}/neural_amp_modeler.lv2/neural_amp_modeler.so")
 
+set(_nam_cmake_args
+    -DCMAKE_TOOLCHAIN_FILE=${CMAKE_TOOLCHAIN_FILE}
+    -DANDROID_ABI=${ANDROID_ABI}
+    -DANDROID_PLATFORM=${ANDROID_PLATFORM}
+    -DCMAKE_BUILD_TYPE=Release
+    -DCMAKE_SHARED_LINKER_FLAGS_RELEASE=-Wl,--as-needed\ -Wl,--strip-all
+    -DUSE_NATIVE_ARCH=OFF
+    -DSMART_BYPASS_ENABLED=ON
+    -DBUILD_UTILS=OFF
+    ${NDK_CCACHE_CMAKE_ARGS}
+)
+
 ExternalProject_Add(nam_build
     SOURCE_DIR      "${_nam_src}"
     BINARY_DIR      "${_nam_build}"
     INSTALL_DIR     "${_nam_assets}"
     PATCH_COMMAND   bash "${_nam_patch_script}" <SOURCE_DIR>
-    CMAKE_ARGS
-        -DCMAKE_TOOLCHAIN_FILE=${CMAKE_TOOLCHAIN_FILE}
-        -DANDROID_ABI=${ANDROID_ABI}
-        -DANDROID_PLATFORM=${ANDROID_PLATFORM}
-        -DCMAKE_BUILD_TYPE=Release
-        -DCMAKE_SHARED_LINKER_FLAGS_RELEASE=-Wl,--as-needed\ -Wl,--strip-all
-        -DUSE_NATIVE_ARCH=OFF
-        -DSMART_BYPASS_ENABLED=ON
-        -DBUILD_UTILS=OFF
-        ${NDK_CCACHE_CMAKE_ARGS}
+    CMAKE_ARGS      ${_nam_cmake_args}
     BUILD_COMMAND   ${CMAKE_COMMAND} --build <BINARY_DIR> -j${NJOBS}
     INSTALL_COMMAND ""
     DEPENDS         lv2_libs
@@ -102,7 +105,34 @@ ExternalProject_Add(nam_build
 
 watch_external_sources(nam_build DIRECTORIES "${_nam_src}/src" "${_nam_src}/deps")
 
+# CPU-tuned variants (GRC_DSP_VARIANTS): same sources, after nam_build has patched them
+set(_nam_variant_syncs "")
+if(GRC_TUNED_DSP_VARIANTS)
+    foreach(_tier IN LISTS GRC_DSP_VARIANTS)
+        set(_nam_tier_build "${_nam_build}_${_tier}")
+        set(_nam_tier_so "${_nam_tier_build}/neural_amp_modeler.lv2/neural_amp_modeler.so")
+        set(_nam_tier_flags "-O3 -DNDEBUG -march=${GRC_DSP_VARIANT_MARCH_${_tier}}")
+        ExternalProject_Add(nam_build_${_tier}
+            SOURCE_DIR      "${_nam_src}"
+            BINARY_DIR      "${_nam_tier_build}"
+            CMAKE_ARGS
+                ${_nam_cmake_args}
+                "-DCMAKE_C_FLAGS_RELEASE=${_nam_tier_flags}"
+                "-DCMAKE_CXX_FLAGS_RELEASE=${_nam_tier_flags}"
+            BUILD_COMMAND   ${CMAKE_COMMAND} --build <BINARY_DIR> -j${NJOBS}
+            INSTALL_COMMAND ""
+            DEPENDS         nam_build
+            BUILD_BYPRODUCTS "${_nam_tier_so}"
+            LOG_CONFIGURE TRUE
+            LOG_BUILD TRUE
+        )
+        watch_external_sources(nam_build_${_tier} DIRECTORIES "${_nam_src}/src" "${_nam_src}/deps")
+        lv2_sync_variant_to_jnilibs(nam_sync_${_tier} "${_nam_tier_so}" ${_tier} "${_nam_tier_so}")
+        list(APPEND _nam_variant_syncs nam_sync_${_tier})
+    endforeach()
+endif()
+
 # ─── Phase 3: Sync to assets + jniLibs ──────────────────────────────────────
 lv2_sync_to_jnilibs(nam_sync "${_nam_build}/neural_amp_modeler.lv2" "${_nam_so_output}")
 
-add_custom_target(nam_done DEPENDS nam_sync)
+add_custom_target(nam_done DEPENDS nam_sync ${_nam_variant_syncs})
@@ -157,6 +157,7 @@ foreach(_pdir IN LISTS _trunk_plugin_dirs)
         "${X11_SYSROOT}/lib/libcairo.a"
         "${X11_SYSROOT}/lib/libpixman-1.a"
         "${X11_SYSROOT}/lib/libpng.a"
+        "${X11_SYSROOT}/lib/libXext.a"
         -L"${X11_SYSROOT}/lib"
         X11 xcb Xau
         xshm_stub
@@ -259,6 +260,7 @@ if(IS_DIRECTORY "${_gx_plugins_src}")
             "${X11_SYSROOT}/lib/libcairo.a"
             "${X11_SYSROOT}/lib/libpixman-1.a"
             "${X11_SYSROOT}/lib/libpng.a"
+            "${X11_SYSROOT}/lib/libXext.a"
             -L"${X11_SYSROOT}/lib"
             X11 xcb Xau
             xshm_stub
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include "engine/AnalysisTap.h"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using guitarrackcraft::AnalysisTap;
+using guitarrackcraft::TelemetryBlock;
+
+namespace {
+// Feed 'blocks' 256-frame blocks of a 110 Hz sine, as the callback would.
+void feed(AnalysisTap& tap, int blocks, uint32_t& phase) {
+    std::vector<float> block(256);
+    for (int b = 0; b < blocks; ++b) {
+        for (float& s : block) s = 0.5f * std::sin(2.0f * 3.14159265f * 110.0f * phase++ / 48000.0f);
+        tap.write(block.data(), static_cast<uint32_t>(block.size()));
+    }
+}
+
+bool waitForUpdates(const TelemetryBlock& block, uint32_t updates, TelemetryBlock::Analysis& out) {
+    for (int i = 0; i < 400; ++i) {
+        if (block.readAnalysis(out) && out.updates >= updates) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+}
+}
+
+TEST(AnalysisTap, ConsumesWithoutAnalyzingWhileOff) {
+    AnalysisTap tap;
+    uint32_t phase = 0;
+    feed(tap, 16, phase);
+    EXPECT_EQ(tap.poll(), 0u);
+    EXPECT_EQ(tap.poll(), 0u);
+}
+
+TEST(AnalysisTap, ThreadPublishesOncePerHop) {
+    AnalysisTap tap;
+    TelemetryBlock block;
+    tap.setTelemetry(&block);
+    tap.setSampleRate(48000.0f);
+    tap.setSource(AnalysisTap::kInput);
+
+    uint32_t phase = 0;
+    feed(tap, 16, phase);  // four hops
+    TelemetryBlock::Analysis out{};
+    ASSERT_TRUE(waitForUpdates(block, 4, out));
+    EXPECT_EQ(out.updates, 4u);
+    EXPECT_EQ(out.source, AnalysisTap::kInput);
+    EXPECT_NEAR(out.pitchHz, 110.0f, 0.5f);
+    EXPECT_EQ(tap.droppedBlocks(), 0u);
+
+    tap.setSource(AnalysisTap::kOff);
+    ASSERT_TRUE(block.readAnalysis(out));
+    EXPECT_EQ(out.source, AnalysisTap::kOff);
+}
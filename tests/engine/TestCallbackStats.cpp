@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "engine/CallbackStats.h"
+
+#include <cstdint>
+
+using guitarrackcraft::CallbackStats;
+
+namespace {
+
+// 480 frames at 48 kHz: a 10 ms period, so 1% of the budget is 100 us
+constexpr uint32_t kFrames = 480;
+constexpr float kRate = 48000.0f;
+constexpr int64_t kPeriodNs = 10000000;
+
+int64_t percentOfPeriod(int64_t percent) { return percent * kPeriodNs / 100; }
+
+/** Record a callback starting at startNs that used 'percent' of the budget. */
+void recordLoad(CallbackStats& stats, int64_t startNs, int64_t percent) {
+    stats.record(startNs, startNs + percentOfPeriod(percent), kFrames, kRate);
+}
+
+uint32_t totalOf(const uint32_t* buckets, int count) {
+    uint32_t total = 0;
+    for (int i = 0; i < count; ++i) total += buckets[i];
+    return total;
+}
+
+} // namespace
+
+TEST(CallbackStats, LoadBucketEdges) {
+    CallbackStats stats;
+    // Each 10 periods apart, so the interval histogram stays out of the way
+    const struct { int64_t percent; int bucket; } cases[] = {
+        {0, 0},
+        {4, 0},
+        {5, 1},
+        {80, 16},
+        {100, 20},
+        {114, 22},
+        {115, CallbackStats::kLoadBuckets - 1},
+        {500, CallbackStats::kLoadBuckets - 1},  // overflow
+    };
+    int64_t start = 0;
+    for (const auto& c : cases) {
+        CallbackStats one;
+        recordLoad(one, 0, c.percent);
+        const CallbackStats::Snapshot s = one.read();
+        EXPECT_EQ(s.load[c.bucket], 1u) << c.percent << "%";
+        EXPECT_EQ(totalOf(s.load, CallbackStats::kLoadBuckets), 1u) << c.percent << "%";
+
+        recordLoad(stats, start, c.percent);
+        start += 10 * kPeriodNs;
+    }
+    const CallbackStats::Snapshot s = stats.read();
+    EXPECT_EQ(s.callbacks, 8u);
+    EXPECT_EQ(s.load[0], 2u);
+    EXPECT_EQ(s.load[CallbackStats::kLoadBuckets - 1], 2u);
+    EXPECT_EQ(s.maxWallUs, 50000u);
+}
+
+TEST(CallbackStats, NearAndDeadlineMissesStartAboveTheirThresholds) {
+    CallbackStats stats;
+    recordLoad(stats, 0, CallbackStats::kNearMissPercent);
+    EXPECT_EQ(stats.read().nearMisses, 0u);
+    recordLoad(stats, kPeriodNs, CallbackStats::kNearMissPercent + 1);
+    EXPECT_EQ(stats.read().nearMisses, 1u);
+    EXPECT_EQ(stats.read().deadlineMisses, 0u);
+
+    recordLoad(stats, 2 * kPeriodNs, 100);
+    EXPECT_EQ(stats.read().nearMisses, 2u);
+    EXPECT_EQ(stats.read().deadlineMisses, 0u);
+    recordLoad(stats, 3 * kPeriodNs, 101);
+    EXPECT_EQ(stats.read().nearMisses, 3u);
+    EXPECT_EQ(stats.read().deadlineMisses, 1u);
+}
+
+TEST(CallbackStats, IntervalIsMeasuredFromThePreviousStart) {
+    CallbackStats stats;
+    recordLoad(stats, 0, 10);
+    // No previous callback: nothing to measure yet
+    EXPECT_EQ(totalOf(stats.read().interval, CallbackStats::kIntervalBuckets), 0u);
+
+    int64_t start = kPeriodNs;  // on time
+    recordLoad(stats, start, 10);
+    CallbackStats::Snapshot s = stats.read();
+    EXPECT_EQ(s.interval[10], 1u);
+    EXPECT_EQ(s.maxJitterUs, 0u);
+
+    start += percentOfPeriod(130);  // 3 ms late
+    recordLoad(stats, start, 10);
+    s = stats.read();
+    EXPECT_EQ(s.interval[13], 1u);
+    EXPECT_EQ(s.maxJitterUs, 3000u);
+
+    start += percentOfPeriod(45);  // early counts as jitter too
+    recordLoad(stats, start, 10);
+    s = stats.read();
+    EXPECT_EQ(s.interval[4], 1u);
+    EXPECT_EQ(s.maxJitterUs, 5500u);
+
+    recordLoad(stats, start, 10);  // same start: zero interval
+    start += percentOfPeriod(350);  // stall: beyond the last bucket
+    recordLoad(stats, start, 10);
+    s = stats.read();
+    EXPECT_EQ(s.interval[0], 1u);
+    EXPECT_EQ(s.interval[CallbackStats::kIntervalBuckets - 1], 1u);
+    EXPECT_EQ(s.maxJitterUs, 25000u);
+    EXPECT_EQ(totalOf(s.interval, CallbackStats::kIntervalBuckets), s.callbacks - 1);
+}
+
+TEST(CallbackStats, ResetAppliesAtTheNextRecord) {
+    CallbackStats stats;
+    for (int i = 0; i < 5; ++i) recordLoad(stats, i * kPeriodNs, 90);
+    stats.requestReset();
+    // Still the old counts until the audio thread runs
+    CallbackStats::Snapshot s = stats.read();
+    EXPECT_EQ(s.callbacks, 5u);
+    EXPECT_EQ(s.nearMisses, 5u);
+
+    recordLoad(stats, 5 * kPeriodNs, 20);
+    s = stats.read();
+    EXPECT_EQ(s.callbacks, 1u);
+    EXPECT_EQ(s.nearMisses, 0u);
+    EXPECT_EQ(s.load[4], 1u);
+    EXPECT_EQ(s.load[18], 0u);
+    EXPECT_EQ(s.maxWallUs, 2000u);
+    // The interval restarts too: the first callback after a reset has no predecessor
+    EXPECT_EQ(totalOf(s.interval, CallbackStats::kIntervalBuckets), 0u);
+
+    recordLoad(stats, 6 * kPeriodNs, 20);
+    EXPECT_EQ(stats.read().interval[10], 1u);
+}
+
+TEST(CallbackStats, ResetStillAppliesWhenTheCallbackIsNotTimed) {
+    CallbackStats stats;
+    recordLoad(stats, 0, 50);
+    stats.requestReset();
+    stats.record(kPeriodNs, kPeriodNs, 0, kRate);  // zero frames: not counted
+    EXPECT_EQ(stats.read().callbacks, 0u);
+    EXPECT_EQ(stats.read().maxWallUs, 0u);
+}
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include "engine/HistoryRing.h"
+
+#include <vector>
+
+using guitarrackcraft::HistoryRing;
+
+TEST(HistoryRing, KeepsNewestSamples) {
+    HistoryRing ring;
+    ring.resize(8);
+    std::vector<float> in(13);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = static_cast<float>(i);
+    ring.write(in.data(), 5);
+    ring.write(in.data() + 5, 8);  // wraps and overwrites 0..4
+    EXPECT_EQ(ring.written(), 13u);
+
+    float out[8];
+    ASSERT_TRUE(ring.read(5, 8, out));
+    for (int i = 0; i < 8; ++i) EXPECT_EQ(out[i], 5.0f + i);
+    EXPECT_FALSE(ring.read(4, 2, out));   // 4 is gone
+    EXPECT_FALSE(ring.read(12, 2, out));  // 13 not written yet
+}
+
+TEST(HistoryRing, OversizedWriteKeepsTail) {
+    HistoryRing ring;
+    ring.resize(4);
+    const float in[6] = {0, 1, 2, 3, 4, 5};
+    ring.write(in, 6);
+    EXPECT_EQ(ring.written(), 6u);
+    float out[4];
+    ASSERT_TRUE(ring.read(2, 4, out));
+    EXPECT_EQ(out[0], 2.0f);
+    EXPECT_EQ(out[3], 5.0f);
+}
+
+TEST(HistoryRing, InterleavesAcrossWrap) {
+    HistoryRing ring;
+    ring.resize(8);
+    const float pad[3] = {};
+    ring.write(pad, 3);
+    const float l[3] = {1, 2, 3};
+    const float r[3] = {-1, -2, -3};
+    ring.writeInterleaved(l, r, 3);
+    float out[6];
+    ASSERT_TRUE(ring.read(3, 6, out));
+    EXPECT_EQ(std::vector<float>(out, out + 6), (std::vector<float>{1, -1, 2, -2, 3, -3}));
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include "engine/LoadShedder.h"
+
+using guitarrackcraft::LoadShedder;
+
+namespace {
+constexpr int64_t kPollNs = 250000000LL;  // the engine's poll period
+constexpr int kCallbacksPerPoll = 100;
+
+// One poll window of callbacks at 'load', 'hot' of which run at 0.95 instead.
+uint32_t poll(LoadShedder& s, int64_t& nowNs, float load, int hot = 0) {
+    for (int i = 0; i < kCallbacksPerPoll; ++i) s.record(i < hot ? 0.95f : load);
+    nowNs += kPollNs;
+    return s.update(nowNs);
+}
+}
+
+TEST(LoadShedder, StaysNormalUnderModerateLoad) {
+    LoadShedder s;
+    int64_t now = 0;
+    for (int i = 0; i < 40; ++i) EXPECT_EQ(poll(s, now, 0.7f, 1), LoadShedder::kNormal);
+}
+
+TEST(LoadShedder, EscalatesOneStepPerHold) {
+    LoadShedder s;
+    int64_t now = 0;
+    EXPECT_EQ(poll(s, now, 0.7f, 10), LoadShedder::kCheapQuality);
+    EXPECT_EQ(poll(s, now, 0.7f, 10), LoadShedder::kCheapQuality);  // 0.25 s < hold
+    EXPECT_EQ(poll(s, now, 0.7f, 10), LoadShedder::kFastSleep);
+    for (int i = 0; i < 20; ++i) poll(s, now, 0.7f, 10);
+    EXPECT_EQ(s.level(), LoadShedder::kMaxLevel);
+}
+
+TEST(LoadShedder, AMissedDeadlineEscalates) {
+    LoadShedder s;
+    int64_t now = 0;
+    s.record(1.0f);
+    now += kPollNs;
+    EXPECT_EQ(s.update(now), LoadShedder::kCheapQuality);
+}
+
+TEST(LoadShedder, RestoresAfterCalmHoldOneStepAtATime) {
+    LoadShedder s;
+    int64_t now = 0;
+    poll(s, now, 0.7f, 10);
+    poll(s, now, 0.7f, 10);
+    poll(s, now, 0.7f, 10);
+    ASSERT_EQ(s.level(), LoadShedder::kFastSleep);
+
+    // Warm but not hot: keeps the level and does not count as calm
+    const int holdPolls = static_cast<int>(LoadShedder::kRestoreHoldNs / kPollNs);
+    for (int i = 0; i < holdPolls * 2; ++i) poll(s, now, 0.7f);
+    EXPECT_EQ(s.level(), LoadShedder::kFastSleep);
+
+    int polls = 0;
+    while (s.level() == LoadShedder::kFastSleep && polls < holdPolls * 2) {
+        poll(s, now, 0.3f);
+        ++polls;
+    }
+    EXPECT_EQ(s.level(), LoadShedder::kCheapQuality);
+    EXPECT_EQ(polls, holdPolls + 1);
+    for (int i = 0; i < holdPolls; ++i) poll(s, now, 0.3f);
+    EXPECT_EQ(s.level(), LoadShedder::kNormal);
+}
+
+TEST(LoadShedder, QuickRelapseDoublesRestoreHold) {
+    LoadShedder s;
+    int64_t now = 0;
+    poll(s, now, 0.7f, 10);
+    const int holdPolls = static_cast<int>(LoadShedder::kRestoreHoldNs / kPollNs);
+    for (int i = 0; i <= holdPolls; ++i) poll(s, now, 0.3f);
+    ASSERT_EQ(s.level(), LoadShedder::kNormal);
+
+    EXPECT_EQ(poll(s, now, 0.7f, 10), LoadShedder::kCheapQuality);
+    EXPECT_EQ(s.restoreHoldNs(), 2 * LoadShedder::kRestoreHoldNs);
+    for (int i = 0; i <= holdPolls; ++i) poll(s, now, 0.3f);
+    EXPECT_EQ(s.level(), LoadShedder::kCheapQuality);
+    for (int i = 0; i < holdPolls; ++i) poll(s, now, 0.3f);
+    EXPECT_EQ(s.level(), LoadShedder::kNormal);
+}
+
+TEST(LoadShedder, IdleWindowsAndResetLeaveHistoryBehind) {
+    LoadShedder s;
+    int64_t now = 0;
+    poll(s, now, 0.7f, 10);
+    ASSERT_EQ(s.level(), LoadShedder::kCheapQuality);
+    now += 100 * LoadShedder::kRestoreHoldNs;
+    EXPECT_EQ(s.update(now), LoadShedder::kCheapQuality);  // no callbacks: no verdict
+
+    for (int i = 0; i < 50; ++i) s.record(1.0f);
+    s.reset();
+    now += kPollNs;
+    EXPECT_EQ(s.update(now), LoadShedder::kNormal);
+    EXPECT_EQ(s.restoreHoldNs(), LoadShedder::kRestoreHoldNs);
+}
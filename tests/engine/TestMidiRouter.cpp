@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include "engine/MidiRouter.h"
+
+#include <vector>
+
+using guitarrackcraft::MidiMapping;
+using guitarrackcraft::MidiMessage;
+using guitarrackcraft::MidiParser;
+using guitarrackcraft::MidiRouter;
+using HostEvent = guitarrackcraft::PluginChain::HostEvent;
+
+namespace {
+MidiMessage message(uint8_t status, uint8_t a, uint8_t b) {
+    MidiMessage msg;
+    msg.size = 3;
+    msg.data[0] = status;
+    msg.data[1] = a;
+    msg.data[2] = b;
+    return msg;
+}
+
+std::vector<MidiMessage> parse(MidiParser& parser, const std::vector<uint8_t>& bytes) {
+    std::vector<MidiMessage> out;
+    parser.feed(bytes.data(), bytes.size(), 0, [&](const MidiMessage& m) { out.push_back(m); });
+    return out;
+}
+}
+
+TEST(MidiParser, HandlesRunningStatusAndInterleavedRealtime) {
+    MidiParser parser;
+    auto msgs = parse(parser, {0x90, 60, 0xF8, 100, 62, 90, 0xC1, 5});
+    ASSERT_EQ(msgs.size(), 4u);
+    EXPECT_EQ(msgs[0].size, 1u);
+    EXPECT_EQ(msgs[0].data[0], 0xF8);
+    EXPECT_EQ(msgs[1].data[1], 60);
+    EXPECT_EQ(msgs[1].data[2], 100);
+    EXPECT_EQ(msgs[2].data[0], 0x90);  // running status
+    EXPECT_EQ(msgs[2].data[1], 62);
+    EXPECT_EQ(msgs[3].size, 2u);
+    EXPECT_EQ(msgs[3].data[1], 5);
+}
+
+TEST(MidiParser, SkipsSysEx) {
+    MidiParser parser;
+    auto msgs = parse(parser, {0xF0, 0x7E, 0x01, 0x02, 0xF7, 0xB0, 7, 64});
+    ASSERT_EQ(msgs.size(), 1u);
+    EXPECT_EQ(msgs[0].data[0], 0xB0);
+    EXPECT_EQ(msgs[0].data[2], 64);
+}
+
+TEST(MidiRouter, UnmappedMessagesPassThrough) {
+    MidiRouter router;
+    HostEvent out[4];
+    ASSERT_EQ(router.route(message(0x90, 60, 100), 7, out, 4), 1u);
+    EXPECT_EQ(out[0].kind, HostEvent::Kind::Midi);
+    EXPECT_EQ(out[0].size, 3u);
+    EXPECT_EQ(out[0].data[1], 60);
+    EXPECT_EQ(out[0].frame, 7u);
+}
+
+TEST(MidiRouter, LearnBindsTheNextControllerAndScalesIt) {
+    MidiRouter router;
+    router.learn(2, 5, 100.0f, 200.0f, false);
+    EXPECT_TRUE(router.isLearning());
+    EXPECT_FALSE(router.capture(message(0x80, 60, 0)));  // note off does not bind
+    EXPECT_TRUE(router.capture(message(0xB3, 11, 0)));
+    EXPECT_FALSE(router.isLearning());
+
+    HostEvent out[4];
+    ASSERT_EQ(router.route(message(0xB3, 11, 127), 0, out, 4), 1u);
+    EXPECT_EQ(out[0].kind, HostEvent::Kind::Control);
+    EXPECT_EQ(out[0].pluginIndex, 2);
+    EXPECT_EQ(out[0].portIndex, 5u);
+    EXPECT_FLOAT_EQ(out[0].value, 200.0f);
+
+    // Learned on channel 4: the same CC on another channel is plain MIDI
+    ASSERT_EQ(router.route(message(0xB0, 11, 127), 0, out, 4), 1u);
+    EXPECT_EQ(out[0].kind, HostEvent::Kind::Midi);
+}
+
+TEST(MidiRouter, RelearningATargetReplacesItsController) {
+    MidiRouter router;
+    router.learn(0, 3, 0.0f, 1.0f, false);
+    router.capture(message(0xB0, 20, 0));
+    router.learn(0, 3, 0.0f, 1.0f, false);
+    router.capture(message(0xB0, 21, 0));
+    auto mappings = router.mappings();
+    ASSERT_EQ(mappings.size(), 1u);
+    EXPECT_EQ(mappings[0].number, 21);
+}
+
+TEST(MidiRouter, FootswitchTogglesBypassOnPressOnly) {
+    MidiRouter router;
+    router.learn(1, MidiMapping::kBypassPort, 0.0f, 1.0f, true);
+    router.capture(message(0xB0, 80, 127));
+
+    HostEvent out[4];
+    ASSERT_EQ(router.route(message(0xB0, 80, 127), 0, out, 4), 1u);
+    EXPECT_EQ(out[0].kind, HostEvent::Kind::BypassToggle);
+    EXPECT_EQ(out[0].pluginIndex, 1);
+    EXPECT_EQ(router.route(message(0xB0, 80, 0), 0, out, 4), 0u);  // release: consumed
+}
+
+TEST(MidiRouter, MomentaryBypassFollowsTheController) {
+    MidiRouter router;
+    MidiMapping m;
+    m.source = MidiMapping::Source::Note;
+    m.number = 36;
+    m.pluginIndex = 0;
+    router.setMappings({m});
+
+    HostEvent out[4];
+    ASSERT_EQ(router.route(message(0x90, 36, 100), 0, out, 4), 1u);
+    EXPECT_EQ(out[0].kind, HostEvent::Kind::Bypass);
+    EXPECT_FLOAT_EQ(out[0].value, 0.0f);  // note on: engaged
+    ASSERT_EQ(router.route(message(0x90, 36, 0), 0, out, 4), 1u);  // note on, velocity 0
+    EXPECT_FLOAT_EQ(out[0].value, 1.0f);
+}
+
+TEST(MidiRouter, FrameOffsetDelaysByOneBlock) {
+    const float rate = 48000.0f;
+    const int64_t blockNs = 1000000000LL;
+    // 1 ms before the block starts: 48 frames early of a 256-frame period
+    EXPECT_EQ(MidiRouter::frameOffset(blockNs - 1000000, blockNs, 256, rate), 208u);
+    EXPECT_EQ(MidiRouter::frameOffset(blockNs - 100000000, blockNs, 256, rate), 0u);
+    EXPECT_EQ(MidiRouter::frameOffset(blockNs + 1000000, blockNs, 256, rate), 255u);
+    EXPECT_EQ(MidiRouter::frameOffset(blockNs, blockNs, 0, rate), 0u);
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include "engine/OfflineProcessor.h"
+#include "utils/MappedWavFile.h"
+#include "utils/WavStreamWriter.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using guitarrackcraft::IPlugin;
+using guitarrackcraft::IPluginFactory;
+using guitarrackcraft::MappedWavFile;
+using guitarrackcraft::OfflineProcessor;
+using guitarrackcraft::PluginChain;
+using guitarrackcraft::PluginInfo;
+using guitarrackcraft::PluginRegistry;
+using guitarrackcraft::PluginState;
+using guitarrackcraft::WavStreamWriter;
+
+namespace {
+
+constexpr uint32_t kRate = 48000;
+constexpr size_t kFrames = 10000;  // a few chain blocks
+
+class GainPlugin : public IPlugin {
+public:
+    explicit GainPlugin(float gain) : gain_(gain) {}
+
+    void activate(float, uint32_t) override {}
+    void deactivate() override {}
+    void process(const float* const* inputs, float* const* outputs, uint32_t numFrames) override {
+        for (uint32_t n = 0; n < numFrames; ++n) {
+            outputs[0][n] = gain_ * inputs[0][n];
+            outputs[1][n] = gain_ * inputs[1][n];
+        }
+    }
+    PluginInfo getInfo() const override { return {}; }
+    void setParameter(uint32_t, float) override {}
+    float getParameter(uint32_t) const override { return 0.0f; }
+    uint32_t getNumInputPorts() const override { return 2; }
+    uint32_t getNumOutputPorts() const override { return 2; }
+    bool restoreState(const PluginState&) override { return true; }
+
+private:
+    float gain_;
+};
+
+/** Makes "urn:gain:<g>" plugins and records how many creations overlapped. */
+class GainFactory : public IPluginFactory {
+public:
+    std::string getFormat() const override { return "LV2"; }
+    std::vector<PluginInfo> enumeratePlugins() override { return {}; }
+    bool initialize() override { return true; }
+    std::unique_ptr<IPlugin> createPlugin(const std::string& pluginId) override {
+        const int inside = active_.fetch_add(1) + 1;
+        int seen = maxActive.load();
+        while (inside > seen && !maxActive.compare_exchange_weak(seen, inside)) {}
+        // Long enough for a second worker to arrive while this one is instantiating
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        active_.fetch_sub(1);
+
+        const std::string prefix = "urn:gain:";
+        if (pluginId.compare(0, prefix.size(), prefix) != 0) return nullptr;
+        created.fetch_add(1);
+        return std::make_unique<GainPlugin>(std::strtof(pluginId.c_str() + prefix.size(), nullptr));
+    }
+
+    std::atomic<int> maxActive{0};
+    std::atomic<int> created{0};
+
+private:
+    std::atomic<int> active_{0};
+};
+
+float inputSample(size_t n) {
+    return 0.5f * static_cast<float>(n % 200) / 200.0f - 0.25f;
+}
+
+std::string tempPath() {
+    char path[] = "/tmp/offline_XXXXXX";
+    const int fd = mkstemp(path);
+    ::close(fd);
+    return path;
+}
+
+std::string writeInput() {
+    std::vector<float> interleaved(kFrames * 2);
+    for (size_t n = 0; n < kFrames; ++n) interleaved[2 * n] = interleaved[2 * n + 1] = inputSample(n);
+    const std::string path = tempPath();
+    WavStreamWriter writer;
+    EXPECT_TRUE(writer.open(path, kRate, 2, WavStreamWriter::Format::Float32));
+    EXPECT_TRUE(writer.write(interleaved.data(), kFrames));
+    EXPECT_TRUE(writer.close());
+    return path;
+}
+
+PluginChain::ChainState chainOf(const std::vector<std::string>& uris) {
+    PluginChain::ChainState state;
+    for (const std::string& uri : uris) {
+        PluginState plugin;
+        plugin.pluginUri = uri;
+        state.plugins.push_back(plugin);
+    }
+    return state;
+}
+
+} // namespace
+
+TEST(OfflineProcessor, BatchRendersEveryJobBuildingOneChainAtATime) {
+    auto factory = std::make_unique<GainFactory>();
+    GainFactory& fake = *factory;
+    PluginRegistry registry;
+    registry.registerFactory(std::move(factory));
+
+    const std::string input = writeInput();
+    const std::vector<float> gains = {0.5f, 2.0f, 1.5f, 0.25f, 3.0f, 1.0f};
+    std::vector<OfflineProcessor::Job> jobs;
+    for (float gain : gains) {
+        // Two plugins per chain: product of the gains
+        const std::string uri = "urn:gain:" + std::to_string(gain);
+        jobs.push_back({input, tempPath(), chainOf({uri, "urn:gain:1"})});
+    }
+    // A chain naming a plugin the registry does not have fails alone
+    jobs.push_back({input, tempPath(), chainOf({"urn:gain:2", "urn:missing"})});
+
+    OfflineProcessor processor(registry);
+    processor.setMaxThreads(4);
+    std::atomic<int> progressCalls{0};
+    float lastProgress = 0.0f;
+    EXPECT_EQ(processor.processBatch(jobs, [&](float p) {
+                  progressCalls.fetch_add(1);
+                  lastProgress = p;  // serialized by processBatch
+              }),
+              gains.size());
+    EXPECT_EQ(fake.maxActive.load(), 1);
+    EXPECT_EQ(fake.created.load(), static_cast<int>(2 * gains.size() + 1));
+    EXPECT_GT(progressCalls.load(), 0);
+    EXPECT_LT(lastProgress, 1.0f);  // the failed job never reports done
+
+    for (size_t j = 0; j < gains.size(); ++j) {
+        MappedWavFile output;
+        ASSERT_TRUE(output.open(jobs[j].outputPath)) << j;
+        EXPECT_EQ(output.sampleRate(), kRate) << j;
+        ASSERT_EQ(output.frames(), kFrames) << j;
+        std::vector<float> rendered(kFrames * output.channels());
+        ASSERT_EQ(output.readFrames(0, kFrames, rendered.data()), kFrames) << j;
+        for (size_t n = 0; n < kFrames; ++n) {
+            // The output file is 16-bit
+            ASSERT_NEAR(rendered[2 * n], gains[j] * inputSample(n), 1e-4f) << "job " << j << " frame " << n;
+            ASSERT_NEAR(rendered[2 * n + 1], rendered[2 * n], 1e-4f) << "job " << j << " frame " << n;
+        }
+    }
+
+    std::remove(input.c_str());
+    for (const auto& job : jobs) std::remove(job.outputPath.c_str());
+}
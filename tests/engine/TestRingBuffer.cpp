@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "engine/RingBuffer.h"
+
+#include <vector>
+
+using guitarrackcraft::RingBuffer;
+
+TEST(RingBuffer, BulkCopiesAcrossWrap) {
+    RingBuffer ring(8);
+    std::vector<float> in = {1, 2, 3, 4, 5, 6};
+    std::vector<float> out(8, 0.0f);
+    ASSERT_EQ(ring.write(in.data(), 6), 6u);
+    ASSERT_EQ(ring.read(out.data(), 4), 4u);
+    // Wraps: 2 left + 6 more; only 6 fit before full
+    std::vector<float> more = {7, 8, 9, 10, 11, 12, 13};
+    EXPECT_EQ(ring.write(more.data(), 7), 6u);
+    EXPECT_EQ(ring.available(), 8u);
+    ASSERT_EQ(ring.read(out.data(), 8), 8u);
+    EXPECT_EQ(out, (std::vector<float>{5, 6, 7, 8, 9, 10, 11, 12}));
+    EXPECT_EQ(ring.read(out.data(), 1), 0u);
+}
+
+TEST(RingBuffer, PeekReturnsSpansInOrder) {
+    RingBuffer ring(8);
+    std::vector<float> in = {1, 2, 3, 4, 5, 6};
+    ring.write(in.data(), 6);
+    ring.skip(5);
+    ring.write(in.data(), 4);  // 6, 1, 2, 3, 4 with the wrap after the 1
+    RingBuffer::Span first, second;
+    ASSERT_EQ(ring.peek(first, second), 5u);
+    ASSERT_EQ(first.count, 3u);
+    ASSERT_EQ(second.count, 2u);
+    EXPECT_EQ(first.data[0], 6.0f);
+    EXPECT_EQ(first.data[2], 2.0f);
+    EXPECT_EQ(second.data[0], 3.0f);
+    EXPECT_EQ(second.data[1], 4.0f);
+    EXPECT_EQ(ring.skip(5), 5u);
+    EXPECT_EQ(ring.peek(first, second), 0u);
+}
+
+TEST(RingBuffer, WriteInterleavedWholeFramesOnly) {
+    RingBuffer ring(8);
+    const float pad[3] = {};
+    ring.write(pad, 3);
+    ring.skip(3);  // write position now 3: a frame straddles the wrap
+    const float l[4] = {1, 2, 3, 4};
+    const float r[4] = {-1, -2, -3, -4};
+    EXPECT_EQ(ring.writeInterleaved(l, r, 4), 4u);
+    EXPECT_EQ(ring.writeInterleaved(l, r, 1), 0u);  // full
+    std::vector<float> out(8);
+    ASSERT_EQ(ring.read(out.data(), 8), 8u);
+    EXPECT_EQ(out, (std::vector<float>{1, -1, 2, -2, 3, -3, 4, -4}));
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "engine/SignalAnalyzer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using guitarrackcraft::SignalAnalyzer;
+using guitarrackcraft::TelemetryBlock;
+
+namespace {
+constexpr float kRate = 48000.0f;
+
+std::vector<float> sine(float hz, float amplitude, float phase = 0.0f) {
+    std::vector<float> x(SignalAnalyzer::kWindowFrames);
+    for (size_t n = 0; n < x.size(); ++n) {
+        x[n] = amplitude * std::sin(phase + 2.0f * 3.14159265f * hz * n / kRate);
+    }
+    return x;
+}
+}
+
+TEST(SignalAnalyzer, FindsThePitchOfALowString) {
+    SignalAnalyzer analyzer(kRate);
+    TelemetryBlock::Analysis out{};
+    analyzer.analyze(sine(82.41f, 0.5f).data(), out);
+    EXPECT_NEAR(out.pitchHz, 82.41f, 0.2f);
+    EXPECT_GT(out.pitchClarity, 0.9f);
+    EXPECT_NEAR(out.rmsDb, 20.0f * std::log10(0.5f / std::sqrt(2.0f)), 0.2f);
+}
+
+TEST(SignalAnalyzer, FindsTheFundamentalUnderHarmonics) {
+    SignalAnalyzer analyzer(kRate);
+    std::vector<float> x = sine(196.0f, 0.3f);
+    const std::vector<float> h2 = sine(392.0f, 0.4f);
+    const std::vector<float> h3 = sine(588.0f, 0.2f);
+    for (size_t n = 0; n < x.size(); ++n) x[n] += h2[n] + h3[n];
+    TelemetryBlock::Analysis out{};
+    analyzer.analyze(x.data(), out);
+    EXPECT_NEAR(out.pitchHz, 196.0f, 0.5f);
+}
+
+TEST(SignalAnalyzer, SilenceHasNoPitch) {
+    SignalAnalyzer analyzer(kRate);
+    const std::vector<float> x(SignalAnalyzer::kWindowFrames, 0.0f);
+    TelemetryBlock::Analysis out{};
+    analyzer.analyze(x.data(), out);
+    EXPECT_EQ(out.pitchHz, 0.0f);
+    EXPECT_EQ(out.rmsDb, SignalAnalyzer::kFloorDb);
+}
+
+TEST(SignalAnalyzer, SpectrumPeaksInTheSinesBandAtItsLevel) {
+    SignalAnalyzer analyzer(kRate);
+    TelemetryBlock::Analysis out{};
+    analyzer.analyze(sine(1000.0f, 1.0f).data(), out);
+    const float* begin = out.spectrumDb;
+    const float* end = begin + TelemetryBlock::kSpectrumBands;
+    const size_t peak = std::max_element(begin, end) - begin;
+    const float bandLo = SignalAnalyzer::kMinBandHz *
+        std::pow(kRate / 2 / SignalAnalyzer::kMinBandHz, float(peak) / TelemetryBlock::kSpectrumBands);
+    const float bandHi = SignalAnalyzer::kMinBandHz *
+        std::pow(kRate / 2 / SignalAnalyzer::kMinBandHz, float(peak + 1) / TelemetryBlock::kSpectrumBands);
+    EXPECT_LE(bandLo, 1000.0f + kRate / SignalAnalyzer::kWindowFrames);
+    EXPECT_GE(bandHi, 1000.0f - kRate / SignalAnalyzer::kWindowFrames);
+    EXPECT_NEAR(out.spectrumDb[peak], 0.0f, 1.5f);  // Hann scalloping stays under 1.5 dB
+    EXPECT_LT(out.spectrumDb[TelemetryBlock::kSpectrumBands - 1], -60.0f);
+}
+
+TEST(SignalAnalyzer, ScopeStartsAtARisingZeroCrossing) {
+    SignalAnalyzer analyzer(kRate);
+    TelemetryBlock::Analysis a{}, b{};
+    analyzer.analyze(sine(440.0f, 0.8f, 0.3f).data(), a);
+    analyzer.analyze(sine(440.0f, 0.8f, 2.1f).data(), b);
+    // Different phases, same picture
+    for (uint32_t p = 0; p < TelemetryBlock::kScopePoints; ++p) {
+        EXPECT_NEAR(a.scopeMax[p], b.scopeMax[p], 0.1f) << p;
+    }
+    EXPECT_LT(std::fabs(a.scopeMin[0]), 0.1f);
+    EXPECT_LE(a.scopeMin[0], a.scopeMax[0]);
+}
@@ -0,0 +1,445 @@
+// PluginChain::process cost on the host, per plugin (each alone in a chain) and for the whole
+// chain, at 32/64/128/256-frame blocks over a DI signal, with heap allocations and lock
+// acquisitions counted on the audio thread while measuring (both should be zero).
+// Plugins: built-in reference processors shaped like the bundled ones (gain, EQ biquads,
+// oversampled waveshaper, cabinet FIR, small LSTM), or, when configured with lilv found, the
+// LV2 bundles under --lv2 loaded through LV2PluginFactory (all of them, or the listed URIs, in
+// order). Configure with -DCMAKE_BUILD_TYPE=Release; the bundles must be built for the host.
+// Runs with flush-to-zero like the audio thread; --no-ftz shows the denormal cost in tails.
+// Usage: plugin_chain_bench [--json] [--no-ftz] [--di file.wav] [--seconds N] [--lv2 dir [uri ...]]
+
+#include "plugin/IPlugin.h"
+#include "plugin/PluginChain.h"
+#include "utils/FloatEnv.h"
+#include "utils/MappedWavFile.h"
+#if defined(HAVE_LV2) && HAVE_LV2 == 1
+#include "plugin/lv2/LV2PluginFactory.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <functional>
+#include <memory>
+#include <new>
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+using namespace guitarrackcraft;
+
+namespace {
+
+// Counted only on the thread measuring process(), only while it measures
+thread_local bool t_counting = false;
+uint64_t g_allocs = 0;
+uint64_t g_locks = 0;
+
+template <typename Fn>
+Fn realSymbol(const char* name) {
+    return reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+}
+
+using MutexFn = int (*)(pthread_mutex_t*);
+using RwlockFn = int (*)(pthread_rwlock_t*);
+const MutexFn realMutexLock = realSymbol<MutexFn>("pthread_mutex_lock");
+const MutexFn realMutexTrylock = realSymbol<MutexFn>("pthread_mutex_trylock");
+const RwlockFn realRdlock = realSymbol<RwlockFn>("pthread_rwlock_rdlock");
+const RwlockFn realWrlock = realSymbol<RwlockFn>("pthread_rwlock_wrlock");
+const RwlockFn realTryrdlock = realSymbol<RwlockFn>("pthread_rwlock_tryrdlock");
+const RwlockFn realTrywrlock = realSymbol<RwlockFn>("pthread_rwlock_trywrlock");
+
+template <typename Fn, typename Lock>
+int countedLock(Fn real, Lock* lock) {
+    if (t_counting) ++g_locks;
+    return real(lock);
+}
+
+} // namespace
+
+// Interpose the lock entry points std::mutex and std::shared_mutex use
+extern "C" {
+int pthread_mutex_lock(pthread_mutex_t* m) { return countedLock(realMutexLock, m); }
+int pthread_mutex_trylock(pthread_mutex_t* m) { return countedLock(realMutexTrylock, m); }
+int pthread_rwlock_rdlock(pthread_rwlock_t* l) { return countedLock(realRdlock, l); }
+int pthread_rwlock_wrlock(pthread_rwlock_t* l) { return countedLock(realWrlock, l); }
+int pthread_rwlock_tryrdlock(pthread_rwlock_t* l) { return countedLock(realTryrdlock, l); }
+int pthread_rwlock_trywrlock(pthread_rwlock_t* l) { return countedLock(realTrywrlock, l); }
+}
+
+void* operator new(std::size_t size) {
+    if (t_counting) ++g_allocs;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+constexpr float kSampleRate = 48000.0f;
+constexpr uint32_t kBlockSizes[] = {32, 64, 128, 256};
+
+/** Mono-in, mono-out processor on channel 0, copied to channel 1, like most guitar plugins. */
+class ReferencePlugin : public IPlugin {
+public:
+    explicit ReferencePlugin(std::string name) : name_(std::move(name)) {}
+
+    void activate(float sampleRate, uint32_t) override { sampleRate_ = sampleRate; reset(); }
+    void deactivate() override {}
+    void process(const float* const* inputs, float* const* outputs, uint32_t numFrames) override {
+        run(inputs[0], outputs[0], numFrames);
+        std::memcpy(outputs[1], outputs[0], numFrames * sizeof(float));
+    }
+    PluginInfo getInfo() const override {
+        PluginInfo info;
+        info.id = "urn:grc:bench:" + name_;
+        info.name = name_;
+        info.format = "reference";
+        return info;
+    }
+    void setParameter(uint32_t, float) override {}
+    float getParameter(uint32_t) const override { return 0.0f; }
+    uint32_t getNumInputPorts() const override { return 1; }
+    uint32_t getNumOutputPorts() const override { return 1; }
+
+protected:
+    virtual void reset() {}
+    virtual void run(const float* in, float* out, uint32_t n) = 0;
+    float sampleRate_ = kSampleRate;
+
+private:
+    std::string name_;
+};
+
+class Gain : public ReferencePlugin {
+public:
+    Gain() : ReferencePlugin("gain") {}
+    void run(const float* in, float* out, uint32_t n) override {
+        for (uint32_t i = 0; i < n; ++i) out[i] = in[i] * 0.8f;
+    }
+};
+
+/** Four peaking biquads, as in a tone stack / EQ pedal. */
+class Eq : public ReferencePlugin {
+public:
+    Eq() : ReferencePlugin("eq 4 biquads") {}
+    void reset() override {
+        const float freqs[4] = {120.0f, 500.0f, 1800.0f, 5000.0f};
+        for (int b = 0; b < 4; ++b) {
+            const float w = 2.0f * (float)M_PI * freqs[b] / sampleRate_;
+            const float alpha = std::sin(w) / 1.4f, a = std::pow(10.0f, (b % 2 ? 3.0f : -2.0f) / 40.0f);
+            const float a0 = 1.0f + alpha / a;
+            bands_[b] = {(1.0f + alpha * a) / a0, -2.0f * std::cos(w) / a0, (1.0f - alpha * a) / a0,
+                         -2.0f * std::cos(w) / a0, (1.0f - alpha / a) / a0, 0.0f, 0.0f};
+        }
+    }
+    void run(const float* in, float* out, uint32_t n) override {
+        std::memmove(out, in, n * sizeof(float));
+        for (auto& b : bands_) {
+            for (uint32_t i = 0; i < n; ++i) {
+                const float x = out[i];
+                const float y = b.b0 * x + b.z1;
+                b.z1 = b.b1 * x - b.a1 * y + b.z2;
+                b.z2 = b.b2 * x - b.a2 * y;
+                out[i] = y;
+            }
+        }
+    }
+
+private:
+    struct Biquad { float b0, b1, b2, a1, a2, z1, z2; };
+    Biquad bands_[4] = {};
+};
+
+/** tanh waveshaper at 4x with linear-interpolation upsampling and a one-pole decimator. */
+class Drive : public ReferencePlugin {
+public:
+    Drive() : ReferencePlugin("drive 4x tanh") {}
+    void reset() override { prev_ = 0.0f; lp_ = 0.0f; }
+    void run(const float* in, float* out, uint32_t n) override {
+        for (uint32_t i = 0; i < n; ++i) {
+            float acc = 0.0f;
+            for (int k = 1; k <= 4; ++k) {
+                const float x = prev_ + (in[i] - prev_) * (float)k * 0.25f;
+                lp_ += 0.45f * (std::tanh(6.0f * x) - lp_);
+                acc += lp_;
+            }
+            prev_ = in[i];
+            out[i] = acc * 0.25f;
+        }
+    }
+
+private:
+    float prev_ = 0.0f, lp_ = 0.0f;
+};
+
+/** Direct-form FIR over a 512-tap decaying impulse, roughly a short cabinet IR. */
+class Cabinet : public ReferencePlugin {
+public:
+    static constexpr uint32_t kTaps = 512;
+    Cabinet() : ReferencePlugin("cab FIR 512") {}
+    void reset() override {
+        uint32_t seed = 12345;
+        for (uint32_t i = 0; i < kTaps; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            taps_[i] = ((float)(seed >> 8) / 16777216.0f - 0.5f) * std::exp(-(float)i / 80.0f);
+        }
+        std::fill(std::begin(history_), std::end(history_), 0.0f);
+        pos_ = 0;
+    }
+    void run(const float* in, float* out, uint32_t n) override {
+        for (uint32_t i = 0; i < n; ++i) {
+            pos_ = (pos_ + kTaps - 1) % kTaps;
+            history_[pos_] = history_[pos_ + kTaps] = in[i];
+            float acc = 0.0f;
+            const float* h = history_ + pos_;
+            for (uint32_t t = 0; t < kTaps; ++t) acc += taps_[t] * h[t];
+            out[i] = acc;
+        }
+    }
+
+private:
+    float taps_[kTaps] = {};
+    float history_[2 * kTaps] = {};
+    uint32_t pos_ = 0;
+};
+
+/** One LSTM layer (hidden 16) plus a dense output, the shape of a small AIDA-X model. */
+class Lstm : public ReferencePlugin {
+public:
+    static constexpr int kHidden = 16;
+    Lstm() : ReferencePlugin("lstm 16") {}
+    void reset() override {
+        uint32_t seed = 777;
+        auto rnd = [&] { seed = seed * 1664525u + 1013904223u; return ((float)(seed >> 8) / 16777216.0f - 0.5f) * 0.4f; };
+        for (auto& w : wIn_) w = rnd();
+        for (auto& w : wRec_) w = rnd();
+        for (auto& w : wOut_) w = rnd();
+        std::fill(std::begin(h_), std::end(h_), 0.0f);
+        std::fill(std::begin(c_), std::end(c_), 0.0f);
+    }
+    void run(const float* in, float* out, uint32_t n) override {
+        float gates[4 * kHidden];
+        for (uint32_t i = 0; i < n; ++i) {
+            for (int g = 0; g < 4 * kHidden; ++g) {
+                float acc = wIn_[g] * in[i];
+                for (int k = 0; k < kHidden; ++k) acc += wRec_[g * kHidden + k] * h_[k];
+                gates[g] = acc;
+            }
+            float y = 0.0f;
+            for (int k = 0; k < kHidden; ++k) {
+                const float ig = sigmoid(gates[k]), fg = sigmoid(gates[kHidden + k]);
+                const float cg = std::tanh(gates[2 * kHidden + k]), og = sigmoid(gates[3 * kHidden + k]);
+                c_[k] = fg * c_[k] + ig * cg;
+                h_[k] = og * std::tanh(c_[k]);
+                y += wOut_[k] * h_[k];
+            }
+            out[i] = y + in[i];
+        }
+    }
+
+private:
+    static float sigmoid(float x) { return 1.0f / (1.0f + std::exp(-x)); }
+    float wIn_[4 * kHidden] = {};
+    float wRec_[4 * kHidden * kHidden] = {};
+    float wOut_[kHidden] = {};
+    float h_[kHidden] = {};
+    float c_[kHidden] = {};
+};
+
+struct Candidate {
+    std::string name;
+    std::function<std::unique_ptr<IPlugin>()> create;
+};
+
+std::vector<Candidate> referencePlugins() {
+    return {
+        {"gain", [] { return std::make_unique<Gain>(); }},
+        {"eq 4 biquads", [] { return std::make_unique<Eq>(); }},
+        {"drive 4x tanh", [] { return std::make_unique<Drive>(); }},
+        {"cab FIR 512", [] { return std::make_unique<Cabinet>(); }},
+        {"lstm 16", [] { return std::make_unique<Lstm>(); }},
+    };
+}
+
+/** Decaying plucked-string partials with pick noise, repeated every half second. */
+std::vector<float> syntheticDI(size_t frames) {
+    std::vector<float> di(frames);
+    uint32_t seed = 1;
+    const size_t note = (size_t)(kSampleRate / 2);
+    const float freqs[] = {82.4f, 110.0f, 146.8f, 196.0f};
+    for (size_t i = 0; i < frames; ++i) {
+        const size_t t = i % note;
+        const float f = freqs[(i / note) % 4];
+        const float env = std::exp(-(float)t / (kSampleRate * 0.25f));
+        float s = 0.0f;
+        for (int h = 1; h <= 6; ++h) s += std::sin(2.0f * (float)M_PI * f * h * (float)t / kSampleRate) / (float)h;
+        seed = seed * 1664525u + 1013904223u;
+        const float noise = t < 200 ? ((float)(seed >> 8) / 16777216.0f - 0.5f) : 0.0f;
+        di[i] = 0.3f * env * s + 0.2f * noise;
+    }
+    return di;
+}
+
+bool loadDI(const char* path, std::vector<float>& di) {
+    MappedWavFile wav;
+    if (!wav.open(path)) {
+        std::fprintf(stderr, "%s: %s\n", path, wav.error().c_str());
+        return false;
+    }
+    std::vector<float> interleaved(wav.frames() * wav.channels());
+    const size_t got = wav.readFrames(0, wav.frames(), interleaved.data());
+    di.resize(got);
+    for (size_t i = 0; i < got; ++i) di[i] = interleaved[i * wav.channels()];
+    return got > 0;
+}
+
+struct Result {
+    std::string name;
+    uint32_t block;
+    double nsPerFrame;
+    double worstBlockUs;
+    uint64_t allocs;
+    uint64_t locks;
+};
+
+Result measure(const std::string& name, const std::vector<const Candidate*>& plugins,
+               uint32_t block, const std::vector<float>& di, size_t frames) {
+    PluginChain chain;
+    chain.setSampleRate(kSampleRate, block);
+    for (const Candidate* c : plugins) chain.addPlugin(c->create());
+
+    std::vector<float> silence(block, 0.0f), outL(block), outR(block);
+    float* outputs[2] = {outL.data(), outR.data()};
+    // Settle: fade-in ramp, first-block lazy work
+    for (int i = 0; i < 200; ++i) {
+        const float* inputs[2] = {silence.data(), silence.data()};
+        chain.process(inputs, outputs, block);
+    }
+
+    const size_t blocks = std::max<size_t>(1, frames / block);
+    const uint64_t allocs0 = g_allocs, locks0 = g_locks;
+    int64_t worst = 0;
+    const auto start = std::chrono::steady_clock::now();
+    t_counting = true;
+    size_t pos = 0;
+    for (size_t b = 0; b < blocks; ++b) {
+        if (pos + block > di.size()) pos = 0;
+        const float* inputs[2] = {di.data() + pos, di.data() + pos};
+        const auto t0 = std::chrono::steady_clock::now();
+        chain.process(inputs, outputs, block);
+        const auto t1 = std::chrono::steady_clock::now();
+        worst = std::max<int64_t>(worst, std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        pos += block;
+    }
+    t_counting = false;
+    const auto end = std::chrono::steady_clock::now();
+    const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    return {name, block, ns / (double)(blocks * block), (double)worst / 1000.0,
+            g_allocs - allocs0, g_locks - locks0};
+}
+
+std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool json = false;
+    bool flushToZero = true;
+    double seconds = 10.0;
+    std::vector<float> di;
+    std::string lv2Dir;
+    std::vector<std::string> uris;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--json")) json = true;
+        else if (!std::strcmp(argv[i], "--no-ftz")) flushToZero = false;
+        else if (!std::strcmp(argv[i], "--di") && i + 1 < argc) { if (!loadDI(argv[++i], di)) return 1; }
+        else if (!std::strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--lv2") && i + 1 < argc) {
+            lv2Dir = argv[++i];
+            while (i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0) uris.push_back(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [--json] [--no-ftz] [--di file.wav] [--seconds N] [--lv2 dir [uri ...]]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (di.empty()) di = syntheticDI((size_t)(kSampleRate * 10));
+    if (flushToZero) enableFlushToZero();
+
+    std::vector<Candidate> candidates;
+#if defined(HAVE_LV2) && HAVE_LV2 == 1
+    std::unique_ptr<LV2PluginFactory> factory;
+    if (!lv2Dir.empty()) {
+        factory = std::make_unique<LV2PluginFactory>(lv2Dir);
+        if (!factory->initialize()) {
+            std::fprintf(stderr, "LV2 scan of %s failed\n", lv2Dir.c_str());
+            return 1;
+        }
+        if (uris.empty()) {
+            for (const auto& info : factory->enumeratePlugins()) uris.push_back(info.id);
+        }
+        for (const auto& uri : uris) {
+            LV2PluginFactory* f = factory.get();
+            if (!f->createPlugin(uri)) {
+                std::fprintf(stderr, "skipping %s: cannot instantiate\n", uri.c_str());
+                continue;
+            }
+            candidates.push_back({uri, [f, uri] { return f->createPlugin(uri); }});
+        }
+    }
+#else
+    if (!lv2Dir.empty()) {
+        std::fprintf(stderr, "built without lilv; --lv2 needs lilv-0 found at configure time\n");
+        return 1;
+    }
+#endif
+    if (candidates.empty()) candidates = referencePlugins();
+
+    const size_t frames = (size_t)(kSampleRate * seconds);
+    std::vector<Result> results;
+    std::vector<const Candidate*> all;
+    for (const auto& c : candidates) all.push_back(&c);
+    for (uint32_t block : kBlockSizes) {
+        for (const auto& c : candidates) results.push_back(measure(c.name, {&c}, block, di, frames));
+        results.push_back(measure("chain", all, block, di, frames));
+    }
+
+    if (json) {
+        std::printf("{\n  \"sampleRate\": %.0f,\n  \"flushToZero\": %s,\n  \"plugins\": [", kSampleRate,
+                    flushToZero ? "true" : "false");
+        for (size_t i = 0; i < candidates.size(); ++i)
+            std::printf("%s\"%s\"", i ? ", " : "", jsonEscape(candidates[i].name).c_str());
+        std::printf("],\n  \"results\": [\n");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            std::printf("    {\"name\": \"%s\", \"block\": %u, \"nsPerFrame\": %.2f, \"worstBlockUs\": %.2f, "
+                        "\"allocs\": %llu, \"locks\": %llu}%s\n",
+                        jsonEscape(r.name).c_str(), r.block, r.nsPerFrame, r.worstBlockUs,
+                        (unsigned long long)r.allocs, (unsigned long long)r.locks,
+                        i + 1 < results.size() ? "," : "");
+        }
+        std::printf("  ]\n}\n");
+        return 0;
+    }
+
+    std::printf("%-40s %6s %10s %12s %8s %8s\n", "plugin", "block", "ns/frame", "worst us", "allocs", "locks");
+    for (const Result& r : results) {
+        std::printf("%-40s %6u %10.2f %12.2f %8llu %8llu\n", r.name.c_str(), r.block, r.nsPerFrame,
+                    r.worstBlockUs, (unsigned long long)r.allocs, (unsigned long long)r.locks);
+    }
+    return 0;
+}
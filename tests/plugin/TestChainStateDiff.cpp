@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "plugin/ChainStateDiff.h"
+
+#include <string>
+#include <vector>
+
+using guitarrackcraft::ChainStatePlan;
+using guitarrackcraft::PluginState;
+using guitarrackcraft::StateProperty;
+
+namespace {
+
+PluginState plugin(const std::string& uri, const std::string& model = "", float gain = 0.5f) {
+    PluginState s;
+    s.pluginUri = uri;
+    s.controlPortValues = {{0, gain}, {1, 1.0f}};
+    if (!model.empty()) {
+        StateProperty prop;
+        prop.keyUri = "urn:test:model";
+        prop.typeUri = "http://lv2plug.in/ns/ext/atom#Path";
+        prop.value.assign(model.begin(), model.end());
+        s.properties.push_back(prop);
+    }
+    return s;
+}
+
+} // namespace
+
+TEST(ChainStateDiffTest, SameChainKeepsEverythingWithoutChanges) {
+    std::vector<PluginState> chain = {plugin("urn:amp", "a.nam"), plugin("urn:cab", "c.wav")};
+    ChainStatePlan plan = guitarrackcraft::planChainState(chain, chain);
+    ASSERT_EQ(plan.slots.size(), 2u);
+    EXPECT_EQ(plan.slots[0].liveIndex, 0);
+    EXPECT_EQ(plan.slots[1].liveIndex, 1);
+    EXPECT_TRUE(plan.slots[0].controlChanges.empty());
+    EXPECT_TRUE(plan.dropped.empty());
+    EXPECT_EQ(plan.reusedCount(), 2u);
+}
+
+TEST(ChainStateDiffTest, OnlyChangedControlsArePushed) {
+    std::vector<PluginState> live = {plugin("urn:amp", "a.nam", 0.5f)};
+    std::vector<PluginState> target = {plugin("urn:amp", "a.nam", 0.8f)};
+    ChainStatePlan plan = guitarrackcraft::planChainState(live, target);
+    ASSERT_EQ(plan.slots[0].liveIndex, 0);
+    ASSERT_EQ(plan.slots[0].controlChanges.size(), 1u);
+    EXPECT_EQ(plan.slots[0].controlChanges[0].first, 0u);
+    EXPECT_FLOAT_EQ(plan.slots[0].controlChanges[0].second, 0.8f);
+}
+
+TEST(ChainStateDiffTest, DifferentModelIsNotReused) {
+    std::vector<PluginState> live = {plugin("urn:amp", "a.nam")};
+    std::vector<PluginState> target = {plugin("urn:amp", "b.nam")};
+    ChainStatePlan plan = guitarrackcraft::planChainState(live, target);
+    EXPECT_EQ(plan.slots[0].liveIndex, -1);
+    EXPECT_EQ(plan.dropped, std::vector<int>{0});
+    EXPECT_FALSE(guitarrackcraft::canReuseInstance(live[0], plugin("urn:amp")));
+    EXPECT_FALSE(guitarrackcraft::canReuseInstance(live[0], plugin("urn:other", "a.nam")));
+}
+
+TEST(ChainStateDiffTest, MovedInstancesAreFoundAndDuplicatesKeepOrder) {
+    std::vector<PluginState> live = {plugin("urn:gate"), plugin("urn:drive"), plugin("urn:drive"),
+                                     plugin("urn:amp", "a.nam")};
+    std::vector<PluginState> target = {plugin("urn:amp", "a.nam"), plugin("urn:drive"), plugin("urn:drive"),
+                                       plugin("urn:reverb")};
+    ChainStatePlan plan = guitarrackcraft::planChainState(live, target);
+    ASSERT_EQ(plan.slots.size(), 4u);
+    EXPECT_EQ(plan.slots[0].liveIndex, 3);
+    EXPECT_EQ(plan.slots[1].liveIndex, 1);
+    EXPECT_EQ(plan.slots[2].liveIndex, 2);
+    EXPECT_EQ(plan.slots[3].liveIndex, -1);
+    EXPECT_EQ(plan.dropped, std::vector<int>{0});
+}
+
+TEST(ChainStateDiffTest, PropertyOrderDoesNotMatter) {
+    PluginState a = plugin("urn:amp", "a.nam");
+    StateProperty extra;
+    extra.keyUri = "urn:test:ir";
+    extra.value = {1, 2, 3};
+    a.properties.push_back(extra);
+    PluginState b = a;
+    std::swap(b.properties[0], b.properties[1]);
+    EXPECT_TRUE(guitarrackcraft::canReuseInstance(a, b));
+    b.properties[0].value.push_back(4);
+    EXPECT_FALSE(guitarrackcraft::canReuseInstance(a, b));
+}
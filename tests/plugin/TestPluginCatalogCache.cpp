@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include "plugin/lv2/PluginCatalogCache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <vector>
+
+using guitarrackcraft::PluginCatalogCache;
+using guitarrackcraft::PluginInfo;
+using guitarrackcraft::PortInfo;
+
+namespace {
+
+class PluginCatalogCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char tmpl[] = "/tmp/plugin_catalog_XXXXXX";
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        dir_ = tmpl;
+        bundle_ = dir_ + "/amp.lv2";
+        ASSERT_EQ(mkdir(bundle_.c_str(), 0755), 0);
+        writeFile(bundle_ + "/manifest.ttl", "@prefix lv2: <http://lv2plug.in/ns/lv2core#> .\n");
+        writeFile(bundle_ + "/amp.ttl", "<urn:amp> a lv2:Plugin .\n");
+        cacheFile_ = dir_ + "/catalog.bin";
+    }
+
+    void TearDown() override {
+        std::remove(cacheFile_.c_str());
+        std::remove((bundle_ + "/.stamp").c_str());
+        std::remove((bundle_ + "/manifest.ttl").c_str());
+        std::remove((bundle_ + "/amp.ttl").c_str());
+        rmdir(bundle_.c_str());
+        rmdir(dir_.c_str());
+    }
+
+    static void writeFile(const std::string& path, const std::string& content) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+    }
+
+    static PluginInfo makePlugin(const std::string& id) {
+        PluginInfo info;
+        info.id = id;
+        info.name = "Amp " + id;
+        info.format = "LV2";
+        info.modguiBasePath = "/bundles/amp.lv2/modgui";
+        info.modguiIconTemplate = "icon.html";
+        info.hasX11Ui = true;
+        info.x11UiBinaryPath = "/lib/libamp_ui.so";
+        info.x11UiUri = id + "#ui";
+        PortInfo gain{};
+        gain.index = 3;
+        gain.name = "Gain";
+        gain.symbol = "gain";
+        gain.isInput = true;
+        gain.isControl = true;
+        gain.defaultValue = 0.5f;
+        gain.minValue = -12.0f;
+        gain.maxValue = 12.0f;
+        gain.scalePoints = {{"Low", -12.0f}, {"High", 12.0f}};
+        PortInfo out{};
+        out.index = 4;
+        out.symbol = "out";
+        out.isAudio = true;
+        info.ports = {gain, out};
+        return info;
+    }
+
+    std::string dir_;
+    std::string bundle_;
+    std::string cacheFile_;
+};
+
+TEST_F(PluginCatalogCacheTest, RoundTripsEveryField) {
+    const uint64_t fp = PluginCatalogCache::fingerprintBundle(bundle_);
+    ASSERT_NE(fp, 0u);
+
+    PluginCatalogCache cache;
+    cache.put({bundle_, fp, {makePlugin("urn:amp"), makePlugin("urn:amp2")}});
+    cache.put({dir_ + "/empty.lv2", 42, {}});
+    ASSERT_TRUE(cache.save(cacheFile_, 7));
+
+    PluginCatalogCache loaded;
+    ASSERT_TRUE(loaded.load(cacheFile_, 7));
+    ASSERT_EQ(loaded.bundles().size(), 2u);
+    const auto* bundle = loaded.find(bundle_, fp);
+    ASSERT_NE(bundle, nullptr);
+    ASSERT_EQ(bundle->plugins.size(), 2u);
+
+    const PluginInfo expected = makePlugin("urn:amp2");
+    const PluginInfo& got = bundle->plugins[1];
+    EXPECT_EQ(got.id, expected.id);
+    EXPECT_EQ(got.name, expected.name);
+    EXPECT_EQ(got.format, expected.format);
+    EXPECT_EQ(got.modguiBasePath, expected.modguiBasePath);
+    EXPECT_EQ(got.modguiIconTemplate, expected.modguiIconTemplate);
+    EXPECT_TRUE(got.hasX11Ui);
+    EXPECT_EQ(got.x11UiBinaryPath, expected.x11UiBinaryPath);
+    EXPECT_EQ(got.x11UiUri, expected.x11UiUri);
+    ASSERT_EQ(got.ports.size(), 2u);
+    const PortInfo& gain = got.ports[0];
+    EXPECT_EQ(gain.index, 3u);
+    EXPECT_EQ(gain.name, "Gain");
+    EXPECT_EQ(gain.symbol, "gain");
+    EXPECT_TRUE(gain.isInput);
+    EXPECT_TRUE(gain.isControl);
+    EXPECT_FALSE(gain.isAudio);
+    EXPECT_FALSE(gain.isToggle);
+    EXPECT_FLOAT_EQ(gain.defaultValue, 0.5f);
+    EXPECT_FLOAT_EQ(gain.minValue, -12.0f);
+    EXPECT_FLOAT_EQ(gain.maxValue, 12.0f);
+    ASSERT_EQ(gain.scalePoints.size(), 2u);
+    EXPECT_EQ(gain.scalePoints[1].label, "High");
+    EXPECT_FLOAT_EQ(gain.scalePoints[1].value, 12.0f);
+    EXPECT_TRUE(got.ports[1].isAudio);
+    EXPECT_FALSE(got.ports[1].isInput);
+
+    EXPECT_NE(loaded.find(dir_ + "/empty.lv2", 42), nullptr);
+}
+
+TEST_F(PluginCatalogCacheTest, FingerprintTracksBundleFiles) {
+    const uint64_t before = PluginCatalogCache::fingerprintBundle(bundle_);
+    EXPECT_EQ(PluginCatalogCache::fingerprintBundle(bundle_), before);
+
+    // Same size, different mtime
+    const std::string ttl = bundle_ + "/amp.ttl";
+    struct timeval times[2] = {{1000000, 0}, {1000000, 0}};
+    ASSERT_EQ(utimes(ttl.c_str(), times), 0);
+    const uint64_t touched = PluginCatalogCache::fingerprintBundle(bundle_);
+    EXPECT_NE(touched, before);
+
+    writeFile(bundle_ + "/extra.ttl", "");
+    EXPECT_NE(PluginCatalogCache::fingerprintBundle(bundle_), touched);
+    std::remove((bundle_ + "/extra.ttl").c_str());
+    EXPECT_EQ(PluginCatalogCache::fingerprintBundle(bundle_), touched);
+
+    EXPECT_EQ(PluginCatalogCache::fingerprintBundle(dir_ + "/missing.lv2"), 0u);
+}
+
+TEST_F(PluginCatalogCacheTest, StaleFingerprintAndRetain) {
+    PluginCatalogCache cache;
+    cache.put({bundle_, 5, {makePlugin("urn:amp")}});
+    cache.put({dir_ + "/gone.lv2", 6, {}});
+    EXPECT_EQ(cache.find(bundle_, 9), nullptr);
+    EXPECT_EQ(cache.find(bundle_, 0), nullptr);
+    ASSERT_NE(cache.find(bundle_, 5), nullptr);
+
+    cache.put({bundle_, 9, {}});
+    ASSERT_NE(cache.find(bundle_, 9), nullptr);
+    EXPECT_TRUE(cache.find(bundle_, 9)->plugins.empty());
+
+    cache.retain({bundle_});
+    ASSERT_EQ(cache.bundles().size(), 1u);
+    EXPECT_EQ(cache.bundles()[0].path, bundle_);
+}
+
+TEST_F(PluginCatalogCacheTest, RejectsOtherEnvironmentAndCorruptFiles) {
+    PluginCatalogCache cache;
+    cache.put({bundle_, 5, {makePlugin("urn:amp")}});
+    ASSERT_TRUE(cache.save(cacheFile_, 1));
+
+    PluginCatalogCache loaded;
+    EXPECT_FALSE(loaded.load(cacheFile_, 2));
+    EXPECT_TRUE(loaded.bundles().empty());
+    EXPECT_FALSE(loaded.load(dir_ + "/missing.bin", 1));
+
+    std::string bytes;
+    {
+        std::ifstream in(cacheFile_, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    ASSERT_GT(bytes.size(), 64u);
+
+    std::string flipped = bytes;
+    flipped[40] ^= 0x5A;
+    writeFile(cacheFile_, flipped);
+    EXPECT_FALSE(loaded.load(cacheFile_, 1));
+    EXPECT_TRUE(loaded.bundles().empty());
+
+    writeFile(cacheFile_, bytes.substr(0, bytes.size() / 2));
+    EXPECT_FALSE(loaded.load(cacheFile_, 1));
+
+    writeFile(cacheFile_, bytes);
+    EXPECT_TRUE(loaded.load(cacheFile_, 1));
+    EXPECT_EQ(loaded.bundles().size(), 1u);
+}
+
+TEST_F(PluginCatalogCacheTest, BundleStampTracksKeyAndFiles) {
+    EXPECT_FALSE(PluginCatalogCache::bundleStampMatches(bundle_, ".stamp", 11));
+    ASSERT_TRUE(PluginCatalogCache::writeBundleStamp(bundle_, ".stamp", 11));
+    EXPECT_TRUE(PluginCatalogCache::bundleStampMatches(bundle_, ".stamp", 11));
+    EXPECT_FALSE(PluginCatalogCache::bundleStampMatches(bundle_, ".stamp", 12));
+
+    // The stamp itself does not change the fingerprint; bundle edits invalidate it
+    writeFile(bundle_ + "/manifest.ttl", "@prefix lv2: <http://lv2plug.in/ns/lv2core#> .\n# rewritten\n");
+    EXPECT_FALSE(PluginCatalogCache::bundleStampMatches(bundle_, ".stamp", 11));
+    EXPECT_FALSE(PluginCatalogCache::writeBundleStamp(dir_ + "/missing.lv2", ".stamp", 11));
+}
+
+} // namespace
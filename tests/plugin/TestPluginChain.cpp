@@ -0,0 +1,883 @@
+#include <gtest/gtest.h>
+#include "plugin/PluginChain.h"
+#include "engine/RingBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using guitarrackcraft::IPlugin;
+using guitarrackcraft::PluginChain;
+using guitarrackcraft::PluginInfo;
+using guitarrackcraft::PluginState;
+using guitarrackcraft::QualityControl;
+
+namespace {
+
+constexpr float kRate = 1000.0f;  // sleep hold = 250 frames
+constexpr uint32_t kBlock = 50;
+
+/** Copies its input and rings on for 'ring' frames after the input stops. */
+class RingingPlugin : public IPlugin {
+public:
+    RingingPlugin(uint32_t ring, uint32_t tail) : ring_(ring), tail_(tail) {}
+
+    void activate(float, uint32_t) override {}
+    void deactivate() override {}
+    void process(const float* const* inputs, float* const* outputs, uint32_t numFrames) override {
+        ++calls;
+        for (uint32_t n = 0; n < numFrames; ++n) {
+            const float in = inputs[0][n];
+            if (in != 0.0f) left_ = ring_;
+            const float out = in != 0.0f ? in : (left_ > 0 ? 0.01f : 0.0f);
+            if (in == 0.0f && left_ > 0) --left_;
+            outputs[0][n] = outputs[1][n] = out;
+        }
+    }
+    PluginInfo getInfo() const override { return {}; }
+    void setParameter(uint32_t, float) override {}
+    float getParameter(uint32_t) const override { return 0.0f; }
+    uint32_t getNumInputPorts() const override { return 2; }
+    uint32_t getNumOutputPorts() const override { return 2; }
+    uint32_t getTailFrames() const override { return tail_; }
+
+    int calls = 0;
+
+private:
+    uint32_t ring_;
+    uint32_t tail_;
+    uint32_t left_ = 0;
+};
+
+/** Halves its input; port 0 is an lv2:enabled-style switch when 'withEnabledPort'. */
+class GainPlugin : public IPlugin {
+public:
+    explicit GainPlugin(bool withEnabledPort, float enabled = 1.0f)
+        : withEnabledPort_(withEnabledPort), enabled_(enabled) {}
+
+    void activate(float, uint32_t) override {}
+    void deactivate() override {}
+    void process(const float* const* inputs, float* const* outputs, uint32_t numFrames) override {
+        ++calls;
+        for (uint32_t n = 0; n < numFrames; ++n) {
+            outputs[0][n] = outputs[1][n] = 0.5f * inputs[0][n];
+        }
+    }
+    PluginInfo getInfo() const override { return {}; }
+    void setParameter(uint32_t port, float value) override {
+        if (port == 0) enabled_ = value;
+    }
+    void setParameterRt(uint32_t port, float value, uint32_t) override { setParameter(port, value); }
+    float getParameter(uint32_t port) const override { return port == 0 ? enabled_ : 0.0f; }
+    uint32_t getNumInputPorts() const override { return 2; }
+    uint32_t getNumOutputPorts() const override { return 2; }
+    uint32_t getTailFrames() const override { return kTailInfinite; }
+    int32_t getEnabledPortIndex() const override { return withEnabledPort_ ? 0 : -1; }
+
+    int calls = 0;
+
+private:
+    bool withEnabledPort_;
+    float enabled_;
+};
+
+/** One block of constant input through 'chain'. */
+std::vector<float> runConstant(PluginChain& chain, float value) {
+    std::vector<float> in(kBlock, value), outL(kBlock), outR(kBlock);
+    const float* inputs[2] = {in.data(), in.data()};
+    float* outputs[2] = {outL.data(), outR.data()};
+    chain.process(inputs, outputs, kBlock);
+    return outL;
+}
+
+GainPlugin* addGain(PluginChain& chain, std::unique_ptr<GainPlugin> owned) {
+    chain.setCrossfadeFrames(0);
+    chain.setSampleRate(kRate, kBlock);  // bypass ramp = 10 frames
+    GainPlugin* plugin = owned.get();
+    chain.addPlugin(std::move(owned));
+    plugin->calls = 0;
+    return plugin;
+}
+
+/** Port 0 is an oversampling factor (1 = cheapest), port 1 a plain control. */
+class QualityPlugin : public IPlugin {
+public:
+    void activate(float, uint32_t) override {}
+    void deactivate() override {}
+    void process(const float* const*, float* const*, uint32_t) override {}
+    PluginInfo getInfo() const override { return {}; }
+    void setParameter(uint32_t port, float value) override { values_[port] = value; }
+    float getParameter(uint32_t port) const override { return values_[port]; }
+    uint32_t getNumInputPorts() const override { return 2; }
+    uint32_t getNumOutputPorts() const override { return 2; }
+    std::vector<QualityControl> getQualityControls() const override { return {{0, 1.0f}}; }
+    PluginState saveState() override { return {"urn:test:quality", {{0, values_[0]}, {1, values_[1]}}, {}}; }
+
+private:
+    float values_[2] = {4.0f, 0.5f};
+};
+
+struct Rig {
+    explicit Rig(uint32_t ring, uint32_t tail = IPlugin::kTailUnknown) {
+        chain.setCrossfadeFrames(0);
+        chain.setSampleRate(kRate, kBlock);
+        auto owned = std::make_unique<RingingPlugin>(ring, tail);
+        plugin = owned.get();
+        chain.addPlugin(std::move(owned));
+        plugin->calls = 0;
+    }
+
+    /** One block; 'onset' >= 0 puts a 1.0 at that frame, otherwise the input is silent. */
+    std::vector<float> run(int onset = -1) {
+        std::vector<float> in(kBlock, 0.0f), outL(kBlock), outR(kBlock);
+        if (onset >= 0) in[onset] = 1.0f;
+        const float* inputs[2] = {in.data(), in.data()};
+        float* outputs[2] = {outL.data(), outR.data()};
+        chain.process(inputs, outputs, kBlock);
+        return outL;
+    }
+
+    bool asleep() const { return chain.getSlotTimings().at(0).asleep; }
+
+    PluginChain chain;
+    RingingPlugin* plugin;
+};
+
+} // namespace
+
+TEST(PluginChainSleep, SleepsOnceOutputHasDecayedAndEmitsZeros) {
+    Rig rig(120);
+    rig.run(0);
+    // 120 ringing frames, then the 250-frame probe: asleep within 8 silent blocks
+    for (int i = 0; i < 8; ++i) rig.run();
+    EXPECT_TRUE(rig.asleep());
+    const int calls = rig.plugin->calls;
+    const std::vector<float> out = rig.run();
+    EXPECT_EQ(rig.plugin->calls, calls);
+    EXPECT_TRUE(std::all_of(out.begin(), out.end(), [](float v) { return v == 0.0f; }));
+}
+
+TEST(PluginChainSleep, KeepsRunningWhileTheTailRings) {
+    Rig rig(400);
+    rig.run(0);
+    for (int i = 0; i < 8; ++i) rig.run();  // input silent 450 frames, output still ringing
+    EXPECT_FALSE(rig.asleep());
+    EXPECT_EQ(rig.plugin->calls, 9);
+}
+
+TEST(PluginChainSleep, WakesOnTheBlockWhereSignalReturns) {
+    Rig rig(0);
+    for (int i = 0; i < 12; ++i) rig.run();
+    ASSERT_TRUE(rig.asleep());
+    const std::vector<float> out = rig.run(37);
+    EXPECT_FALSE(rig.asleep());
+    EXPECT_EQ(out[37], 1.0f);
+    EXPECT_EQ(out[36], 0.0f);
+}
+
+TEST(PluginChainSleep, DeclaredTailSkipsTheProbe) {
+    Rig rig(0, 100);
+    rig.run(0);
+    rig.run();
+    EXPECT_FALSE(rig.asleep());  // 50 silent frames < 100
+    rig.run();
+    EXPECT_TRUE(rig.asleep());
+}
+
+TEST(PluginChainSleep, GeneratorsNeverSleep) {
+    Rig rig(0, IPlugin::kTailInfinite);
+    for (int i = 0; i < 40; ++i) rig.run();
+    EXPECT_FALSE(rig.asleep());
+    EXPECT_EQ(rig.plugin->calls, 40);
+}
+
+TEST(PluginChainSleep, ParameterChangeWakesForOneProbe) {
+    Rig rig(0);
+    for (int i = 0; i < 12; ++i) rig.run();
+    ASSERT_TRUE(rig.asleep());
+    rig.chain.setParameter(0, 0, 1.0f);
+    const int calls = rig.plugin->calls;
+    rig.run();
+    EXPECT_EQ(rig.plugin->calls, calls + 1);
+    EXPECT_FALSE(rig.asleep());
+}
+
+TEST(PluginChainBypass, RampsToDryThenStopsCallingThePlugin) {
+    PluginChain chain;
+    GainPlugin* plugin = addGain(chain, std::make_unique<GainPlugin>(false));
+    EXPECT_FLOAT_EQ(runConstant(chain, 1.0f)[0], 0.5f);
+
+    ASSERT_TRUE(chain.setPluginBypass(0, true));
+    EXPECT_TRUE(chain.isPluginBypassed(0));
+    std::vector<float> out = runConstant(chain, 1.0f);
+    EXPECT_FLOAT_EQ(out[0], 0.55f);  // 90% wet after the first ramp step
+    EXPECT_FLOAT_EQ(out[9], 1.0f);
+    EXPECT_FLOAT_EQ(out[49], 1.0f);
+    EXPECT_EQ(plugin->calls, 2);
+
+    out = runConstant(chain, 1.0f);
+    EXPECT_EQ(plugin->calls, 2);
+    EXPECT_TRUE(std::all_of(out.begin(), out.end(), [](float v) { return v == 1.0f; }));
+}
+
+TEST(PluginChainBypass, ReenablingRampsBackIn) {
+    PluginChain chain;
+    GainPlugin* plugin = addGain(chain, std::make_unique<GainPlugin>(false));
+    chain.setPluginBypass(0, true);
+    runConstant(chain, 1.0f);
+    runConstant(chain, 1.0f);
+    const int calls = plugin->calls;
+
+    chain.setPluginBypass(0, false);
+    const std::vector<float> out = runConstant(chain, 1.0f);
+    EXPECT_EQ(plugin->calls, calls + 1);
+    EXPECT_FLOAT_EQ(out[0], 0.95f);
+    EXPECT_FLOAT_EQ(out[9], 0.5f);
+    EXPECT_FLOAT_EQ(out[49], 0.5f);
+}
+
+TEST(PluginChainBypass, EnabledPortDrivesHostBypass) {
+    PluginChain chain;
+    GainPlugin* plugin = addGain(chain, std::make_unique<GainPlugin>(true));
+    chain.setParameter(0, 0, 0.0f);
+    EXPECT_TRUE(chain.isPluginBypassed(0));
+    chain.setPluginBypass(0, false);
+    EXPECT_FLOAT_EQ(plugin->getParameter(0), 1.0f);
+    EXPECT_FALSE(chain.isPluginBypassed(0));
+}
+
+TEST(PluginChainBypass, HostEventsToggleBypassAndEnabledPort) {
+    PluginChain chain;
+    GainPlugin* plugin = addGain(chain, std::make_unique<GainPlugin>(true));
+    PluginChain::HostEvent event;
+    event.kind = PluginChain::HostEvent::Kind::BypassToggle;
+    event.pluginIndex = 0;
+    chain.deliverHostEvents(&event, 1);
+    EXPECT_TRUE(chain.isPluginBypassed(0));
+    EXPECT_FLOAT_EQ(plugin->getParameter(0), 0.0f);
+
+    // A learned write to the enabled port switches the host bypass back off
+    event.kind = PluginChain::HostEvent::Kind::Control;
+    event.portIndex = 0;
+    event.value = 1.0f;
+    chain.deliverHostEvents(&event, 1);
+    EXPECT_FALSE(chain.isPluginBypassed(0));
+
+    event.pluginIndex = 3;  // no such plugin: dropped
+    chain.deliverHostEvents(&event, 1);
+    EXPECT_FALSE(chain.isPluginBypassed(0));
+}
+
+TEST(PluginChainAnalysisTap, CopiesTheTappedSlotsOutputUntilItIsRemoved) {
+    PluginChain chain;
+    addGain(chain, std::make_unique<GainPlugin>(false));
+    guitarrackcraft::RingBuffer ring(1024);
+    EXPECT_FALSE(chain.setAnalysisTap(1, &ring));
+    ASSERT_TRUE(chain.setAnalysisTap(0, &ring));
+    runConstant(chain, 1.0f);
+    ASSERT_EQ(ring.available(), kBlock);
+    float first = 0.0f;
+    ring.read(&first, 1);
+    EXPECT_FLOAT_EQ(first, 0.5f);
+
+    ring.reset();
+    chain.removePlugin(0);
+    runConstant(chain, 1.0f);
+    EXPECT_EQ(ring.available(), 0u);
+}
+
+TEST(PluginChainBypass, PluginAddedSwitchedOffStartsBypassed) {
+    PluginChain chain;
+    GainPlugin* plugin = addGain(chain, std::make_unique<GainPlugin>(true, 0.0f));
+    EXPECT_TRUE(chain.isPluginBypassed(0));
+    const std::vector<float> out = runConstant(chain, 1.0f);
+    EXPECT_EQ(plugin->calls, 0);
+    EXPECT_FLOAT_EQ(out[0], 1.0f);
+}
+
+TEST(PluginChainSleep, FastSleepShortensTheProbe) {
+    Rig rig(0);
+    rig.chain.setFastSleep(true);
+    rig.run(0);
+    rig.run();
+    rig.run();  // 50-frame probe after the silent input started
+    EXPECT_TRUE(rig.asleep());
+    rig.chain.setFastSleep(false);
+    rig.run(0);
+    for (int i = 0; i < 3; ++i) rig.run();
+    EXPECT_FALSE(rig.asleep());
+}
+
+TEST(PluginChainLoadShed, QualityShedRestoresOriginalValues) {
+    PluginChain chain;
+    chain.addPlugin(std::make_unique<QualityPlugin>());
+    EXPECT_EQ(chain.setQualityShed(true), 1u);
+    EXPECT_EQ(chain.setQualityShed(true), 0u);  // already shed
+    EXPECT_FLOAT_EQ(chain.getParameter(0, 0), 1.0f);
+    EXPECT_FLOAT_EQ(chain.getParameter(0, 1), 0.5f);
+    EXPECT_EQ(chain.setQualityShed(false), 1u);
+    EXPECT_FLOAT_EQ(chain.getParameter(0, 0), 4.0f);
+}
+
+TEST(PluginChainLoadShed, UserChangesWinAndPresetsKeepTheOriginal) {
+    PluginChain chain;
+    chain.addPlugin(std::make_unique<QualityPlugin>());
+    chain.setQualityShed(true);
+    const PluginChain::ChainState saved = chain.saveChainState();
+    ASSERT_EQ(saved.plugins.size(), 1u);
+    EXPECT_FLOAT_EQ(saved.plugins[0].controlPortValues[0].second, 4.0f);
+
+    chain.setParameter(0, 0, 2.0f);
+    EXPECT_EQ(chain.setQualityShed(false), 0u);
+    EXPECT_FLOAT_EQ(chain.getParameter(0, 0), 2.0f);
+}
+
+namespace {
+
+/** Multiplies its input by 'gain'; never sleeps. With a probe, reports calls and checks it is
+ *  not destroyed while process() runs. */
+class ScalePlugin : public IPlugin {
+public:
+    struct Probe {
+        std::atomic<int> calls{0};
+        std::atomic<bool> inProcess{false};
+        std::atomic<bool> destroyedInUse{false};
+        std::chrono::microseconds processTime{0};
+    };
+
+    explicit ScalePlugin(float gain, Probe* probe = nullptr) : gain_(gain), probe_(probe) {}
+    ~ScalePlugin() override {
+        if (probe_ && probe_->inProcess.load()) probe_->destroyedInUse.store(true);
+    }
+
+    void activate(float, uint32_t) override {}
+    void deactivate() override {}
+    void process(const float* const* inputs, float* const* outputs, uint32_t numFrames) override {
+        if (probe_) {
+            probe_->inProcess.store(true);
+            std::this_thread::sleep_for(probe_->processTime);
+        }
+        for (uint32_t n = 0; n < numFrames; ++n) {
+            outputs[0][n] = gain_ * inputs[0][n];
+            outputs[1][n] = gain_ * inputs[1][n];
+        }
+        if (probe_) {
+            probe_->calls.fetch_add(1);
+            probe_->inProcess.store(false);
+        }
+    }
+    PluginInfo getInfo() const override { return {}; }
+    void setParameter(uint32_t, float) override {}
+    float getParameter(uint32_t) const override { return 0.0f; }
+    uint32_t getNumInputPorts() const override { return 2; }
+    uint32_t getNumOutputPorts() const override { return 2; }
+    uint32_t getTailFrames() const override { return kTailInfinite; }
+
+private:
+    float gain_;
+    Probe* probe_;
+};
+
+/** One-frame delay plus 'gain': stateful across blocks, so block order matters. */
+class DelayPlugin : public IPlugin {
+public:
+    explicit DelayPlugin(float gain) : gain_(gain) {}
+
+    void activate(float, uint32_t) override {}
+    void deactivate() override {}
+    void process(const float* const* inputs, float* const* outputs, uint32_t numFrames) override {
+        for (uint32_t ch = 0; ch < 2; ++ch) {
+            for (uint32_t n = 0; n < numFrames; ++n) {
+                const float in = inputs[ch][n];
+                outputs[ch][n] = gain_ * last_[ch];
+                last_[ch] = in;
+            }
+        }
+    }
+    PluginInfo getInfo() const override { return {}; }
+    void setParameter(uint32_t, float) override {}
+    float getParameter(uint32_t) const override { return 0.0f; }
+    uint32_t getNumInputPorts() const override { return 2; }
+    uint32_t getNumOutputPorts() const override { return 2; }
+    uint32_t getTailFrames() const override { return kTailInfinite; }
+
+private:
+    float gain_;
+    float last_[2] = {0.0f, 0.0f};
+};
+
+/** Records the buffers of every process() call; a one-pole low-pass, safe to run in place. */
+class PointerPlugin : public IPlugin {
+public:
+    struct Call {
+        const float* in[2];
+        float* out[2];
+    };
+
+    PointerPlugin(float gain, bool inPlace, std::vector<Call>* calls)
+        : gain_(gain), inPlace_(inPlace), calls_(calls) {}
+
+    void activate(float, uint32_t) override {}
+    void deactivate() override {}
+    void process(const float* const* inputs, float* const* outputs, uint32_t numFrames) override {
+        calls_->push_back({{inputs[0], inputs[1]}, {outputs[0], outputs[1]}});
+        for (uint32_t ch = 0; ch < 2; ++ch) {
+            for (uint32_t n = 0; n < numFrames; ++n) {
+                state_[ch] = gain_ * inputs[ch][n] + 0.5f * state_[ch];
+                outputs[ch][n] = state_[ch];
+            }
+        }
+    }
+    PluginInfo getInfo() const override { return {}; }
+    void setParameter(uint32_t, float) override {}
+    float getParameter(uint32_t) const override { return 0.0f; }
+    uint32_t getNumInputPorts() const override { return 2; }
+    uint32_t getNumOutputPorts() const override { return 2; }
+    uint32_t getTailFrames() const override { return kTailInfinite; }
+    bool canProcessInPlace() const override { return inPlace_; }
+
+private:
+    float gain_;
+    bool inPlace_;
+    std::vector<Call>* calls_;
+    float state_[2] = {0.0f, 0.0f};
+};
+
+/** Serial chain of PointerPlugins, one call log per plugin. */
+void buildPointerChain(PluginChain& chain, const std::vector<float>& gains, bool inPlace,
+                       std::vector<std::vector<PointerPlugin::Call>>& calls) {
+    chain.setCrossfadeFrames(0);
+    chain.setSampleRate(kRate, kBlock);
+    calls.resize(gains.size());
+    for (size_t i = 0; i < gains.size(); ++i) {
+        chain.addPlugin(std::make_unique<PointerPlugin>(gains[i], inPlace, &calls[i]));
+    }
+    for (auto& log : calls) log.clear();  // addPlugin() warms plugins up on its own buffers
+}
+
+/** Chain of delay plugins with the given gains, split into 'stages' pipeline segments. */
+void buildDelayChain(PluginChain& chain, const std::vector<float>& gains, int stages) {
+    chain.setCrossfadeFrames(0);
+    chain.setSampleRate(kRate, kBlock);
+    for (float gain : gains) chain.addPlugin(std::make_unique<DelayPlugin>(gain));
+    chain.setPipelineStages(stages);
+}
+
+/** Block 'index' of a deterministic, never-silent test signal. */
+std::vector<float> testBlock(uint32_t index, uint32_t frames) {
+    std::vector<float> block(frames);
+    for (uint32_t n = 0; n < frames; ++n) {
+        block[n] = 0.25f + 0.5f * std::sin(0.05f * static_cast<float>(index * frames + n));
+    }
+    return block;
+}
+
+/** Calls process() back to back on its own thread, as the audio callback does, with constant
+ *  input, and records the left output. */
+class AudioThread {
+public:
+    AudioThread(PluginChain& chain, float input) : chain_(chain), input_(input) {
+        thread_ = std::thread([this] { run(); });
+    }
+    ~AudioThread() { stop(); }
+
+    /** Block until 'count' more blocks have been processed. */
+    void waitBlocks(uint64_t count) const {
+        const uint64_t target = blocks_.load() + count;
+        while (blocks_.load() < target) std::this_thread::yield();
+    }
+
+    /** Stop the thread; returns every recorded frame. */
+    const std::vector<float>& stop() {
+        if (thread_.joinable()) {
+            stop_.store(true);
+            thread_.join();
+        }
+        return recorded_;
+    }
+
+private:
+    void run() {
+        std::vector<float> in(kBlock, input_), outL(kBlock), outR(kBlock);
+        const float* inputs[2] = {in.data(), in.data()};
+        float* outputs[2] = {outL.data(), outR.data()};
+        while (!stop_.load()) {
+            chain_.process(inputs, outputs, kBlock);
+            recorded_.insert(recorded_.end(), outL.begin(), outL.end());
+            blocks_.fetch_add(1);
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    PluginChain& chain_;
+    const float input_;
+    std::vector<float> recorded_;
+    std::atomic<uint64_t> blocks_{0};
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+/**
+ * 'out' holds 'from' until one linear ramp of 'frames' frames to 'to', then only 'to': the
+ * shape of a single crossfade, g = (k + 1) / frames at ramp frame k, as the chain mixes it.
+ */
+void expectSingleRamp(const std::vector<float>& out, float from, float to, uint32_t frames) {
+    size_t start = 0;
+    while (start < out.size() && out[start] == from) ++start;
+    ASSERT_GT(start, 0u) << "no frames before the change";
+    ASSERT_LE(start + frames, out.size()) << "ramp did not finish";
+    const float step = 1.0f / static_cast<float>(frames);
+    for (uint32_t k = 0; k < frames; ++k) {
+        const float g = std::min(1.0f, static_cast<float>(k + 1) * step);
+        ASSERT_FLOAT_EQ(out[start + k], from + g * (to - from)) << "ramp frame " << k;
+    }
+    for (size_t n = start + frames; n < out.size(); ++n) {
+        ASSERT_EQ(out[n], to) << "frame " << n - start << " after the ramp started";
+    }
+}
+
+} // namespace
+
+TEST(PluginChainSnapshot, ProcessRunsWholeChainsWhilePluginsComeAndGo) {
+    PluginChain chain;
+    chain.setCrossfadeFrames(0);
+    chain.setSampleRate(kRate, kBlock);
+    chain.addPlugin(std::make_unique<ScalePlugin>(0.5f));
+
+    AudioThread audio(chain, 1.0f);
+    for (int i = 0; i < 200; ++i) {
+        chain.addPlugin(std::make_unique<ScalePlugin>(0.5f), i % 2 == 0 ? 0 : -1);
+        if (i % 3 == 0) chain.addPlugin(std::make_unique<ScalePlugin>(0.5f));
+        if (i % 5 == 0) chain.reorderPlugins(0, static_cast<int>(chain.getSize()) - 1);
+        while (chain.getSize() > 1) chain.removePlugin(i % 2 == 0 ? 0 : static_cast<int>(chain.getSize()) - 1);
+        audio.waitBlocks(1);
+    }
+    const std::vector<float>& out = audio.stop();
+
+    // Every block ran one published chain from end to end: within a block all frames agree
+    // and the value is 0.5^k for a chain of k plugins
+    ASSERT_GE(out.size(), 200u * kBlock);
+    for (size_t block = 0; block + kBlock <= out.size(); block += kBlock) {
+        const float v = out[block];
+        for (uint32_t n = 1; n < kBlock; ++n) ASSERT_EQ(out[block + n], v) << "block " << block / kBlock;
+        const float k = -std::log2(v);
+        ASSERT_GE(k, 1.0f);
+        ASSERT_LE(k, 3.0f);
+        ASSERT_EQ(k, std::round(k)) << "block " << block / kBlock;
+    }
+}
+
+TEST(PluginChainSnapshot, RemovalWaitsForTheBlockStillUsingThePlugin) {
+    PluginChain chain;
+    chain.setCrossfadeFrames(0);
+    chain.setSampleRate(kRate, kBlock);
+    chain.addPlugin(std::make_unique<ScalePlugin>(0.5f));
+
+    AudioThread audio(chain, 1.0f);
+    for (int i = 0; i < 20; ++i) {
+        ScalePlugin::Probe probe;
+        probe.processTime = std::chrono::microseconds(2000);
+        chain.addPlugin(std::make_unique<ScalePlugin>(2.0f, &probe));
+        // Remove it while the audio thread is (very likely) inside its process()
+        while (!probe.inProcess.load()) std::this_thread::yield();
+        ASSERT_TRUE(chain.removePlugin(1));
+        EXPECT_FALSE(probe.destroyedInUse.load()) << "iteration " << i;
+    }
+    audio.stop();
+    EXPECT_EQ(chain.getSize(), 1u);
+}
+
+TEST(PluginChainCrossfade, InsertedPluginRampsFromDryToWet) {
+    constexpr uint32_t kFade = 120;
+    PluginChain chain;
+    chain.setSampleRate(kRate, kBlock);
+    chain.setCrossfadeFrames(0);
+    chain.addPlugin(std::make_unique<ScalePlugin>(0.5f));
+    chain.setCrossfadeFrames(kFade);
+
+    AudioThread audio(chain, 1.0f);
+    audio.waitBlocks(3);
+    chain.addPlugin(std::make_unique<ScalePlugin>(2.0f));  // returns once the ramp is done
+    audio.waitBlocks(3);
+    expectSingleRamp(audio.stop(), 0.5f, 1.0f, kFade);
+}
+
+TEST(PluginChainCrossfade, BatchRunsTheOldChainThenCrossfadesOnceToTheNewOne) {
+    constexpr uint32_t kFade = 200;  // not a whole number of blocks
+    PluginChain chain;
+    chain.setSampleRate(kRate, kBlock);
+    chain.setCrossfadeFrames(0);
+    chain.addPlugin(std::make_unique<ScalePlugin>(0.5f));
+    chain.setCrossfadeFrames(kFade);
+
+    AudioThread audio(chain, 1.0f);
+    audio.waitBlocks(3);
+    chain.beginBatch();
+    // Published one by one these would pass through dry (1.0) and the 2.0 chain (2.0)
+    chain.removePlugin(0);
+    chain.addPlugin(std::make_unique<ScalePlugin>(2.0f));
+    audio.waitBlocks(3);
+    chain.addPlugin(std::make_unique<ScalePlugin>(3.0f));
+    audio.waitBlocks(3);
+    chain.commitBatch();
+    audio.waitBlocks(3);
+    // Old and new chains share no instance: both run and the outputs are mixed linearly
+    expectSingleRamp(audio.stop(), 0.5f, 6.0f, kFade);
+    EXPECT_EQ(chain.getSize(), 2u);
+}
+
+TEST(PluginChainCrossfade, RemovedPluginRampsFromWetToDry) {
+    constexpr uint32_t kFade = 100;
+    PluginChain chain;
+    chain.setSampleRate(kRate, kBlock);
+    chain.setCrossfadeFrames(0);
+    chain.addPlugin(std::make_unique<ScalePlugin>(0.5f));
+    chain.addPlugin(std::make_unique<ScalePlugin>(4.0f));
+    chain.setCrossfadeFrames(kFade);
+
+    AudioThread audio(chain, 1.0f);
+    audio.waitBlocks(3);
+    chain.removePlugin(1);
+    audio.waitBlocks(3);
+    expectSingleRamp(audio.stop(), 2.0f, 0.5f, kFade);
+}
+
+TEST(PluginChainGraph, ParallelBranchesAreMixedWithTheirGains) {
+    PluginChain chain;
+    chain.setCrossfadeFrames(0);
+    chain.setSampleRate(kRate, kBlock);
+    chain.addPlugin(std::make_unique<ScalePlugin>(0.5f));  // serial, feeds the split
+    chain.addPlugin(std::make_unique<ScalePlugin>(2.0f));
+    chain.addPlugin(std::make_unique<ScalePlugin>(3.0f));  // same branch: serial after 2.0
+    chain.addPlugin(std::make_unique<ScalePlugin>(8.0f));
+    ASSERT_TRUE(chain.setPluginRouting(1, 1, 0));
+    ASSERT_TRUE(chain.setPluginRouting(2, 1, 0));
+    ASSERT_TRUE(chain.setPluginRouting(3, 1, 1));
+
+    // Unset gains: equal-weight sum of 0.5 * 6 and 0.5 * 8
+    std::vector<float> in(kBlock), outL(kBlock), outR(kBlock);
+    for (uint32_t n = 0; n < kBlock; ++n) in[n] = static_cast<float>(n) / kBlock - 0.5f;
+    const float* inputs[2] = {in.data(), in.data()};
+    float* outputs[2] = {outL.data(), outR.data()};
+    chain.process(inputs, outputs, kBlock);
+    for (uint32_t n = 0; n < kBlock; ++n) {
+        ASSERT_FLOAT_EQ(outL[n], 0.5f * (0.5f * 6.0f + 0.5f * 8.0f) * in[n]) << n;
+        ASSERT_FLOAT_EQ(outR[n], outL[n]) << n;
+    }
+
+    chain.setBranchGain(1, 0, 0.25f);
+    chain.setBranchGain(1, 1, 0.75f);
+    for (int block = 0; block < 50; ++block) {  // the pool runs both branches every block
+        chain.process(inputs, outputs, kBlock);
+        for (uint32_t n = 0; n < kBlock; ++n) {
+            ASSERT_FLOAT_EQ(outL[n], 0.5f * (0.25f * 6.0f + 0.75f * 8.0f) * in[n]) << n;
+        }
+    }
+}
+
+TEST(PluginChainGraph, CallbackLongerThanTheBufferSizeRunsInSlices) {
+    PluginChain chain;
+    chain.setCrossfadeFrames(0);
+    chain.setSampleRate(kRate, kBlock);
+    chain.addPlugin(std::make_unique<ScalePlugin>(2.0f));
+    chain.addPlugin(std::make_unique<ScalePlugin>(4.0f));
+    ASSERT_TRUE(chain.setPluginRouting(0, 1, 0));
+    ASSERT_TRUE(chain.setPluginRouting(1, 1, 1));
+
+    // Scratch holds kBlock frames; the rest of the callback must not read past it
+    for (uint32_t frames : {3 * kBlock + 7, kBlock, 2 * kBlock}) {
+        const std::vector<float> in = testBlock(frames, frames);
+        std::vector<float> outL(frames), outR(frames);
+        const float* inputs[2] = {in.data(), in.data()};
+        float* outputs[2] = {outL.data(), outR.data()};
+        chain.process(inputs, outputs, frames);
+        for (uint32_t n = 0; n < frames; ++n) {
+            ASSERT_FLOAT_EQ(outL[n], 3.0f * in[n]) << frames << " frame " << n;
+        }
+    }
+
+    // A larger buffer size moves the chain onto scratch that holds it
+    chain.setSampleRate(kRate, 4 * kBlock);
+    const std::vector<float> in = testBlock(1, 4 * kBlock);
+    std::vector<float> outL(4 * kBlock), outR(4 * kBlock);
+    const float* inputs[2] = {in.data(), in.data()};
+    float* outputs[2] = {outL.data(), outR.data()};
+    chain.process(inputs, outputs, 4 * kBlock);
+    for (uint32_t n = 0; n < 4 * kBlock; ++n) ASSERT_FLOAT_EQ(outR[n], 3.0f * in[n]) << n;
+}
+
+TEST(PluginChainBuffers, SlotInputsNeverAliasTheirOutputs) {
+    PluginChain chain;
+    std::vector<std::vector<PointerPlugin::Call>> calls;
+    buildPointerChain(chain, {0.9f, 1.2f, 0.7f, 1.1f}, false, calls);
+
+    std::vector<float> outL(kBlock), outR(kBlock);
+    float* outputs[2] = {outL.data(), outR.data()};
+    for (uint32_t b = 0; b < 3; ++b) {
+        const std::vector<float> inL = testBlock(b, kBlock), inR = testBlock(b + 7, kBlock);
+        const float* inputs[2] = {inL.data(), inR.data()};
+        chain.process(inputs, outputs, kBlock);
+        for (size_t slot = 0; slot < calls.size(); ++slot) {
+            ASSERT_EQ(calls[slot].size(), b + 1) << slot;
+            const PointerPlugin::Call& call = calls[slot].back();
+            for (const float* in : call.in) {
+                for (const float* out : call.out) EXPECT_NE(in, out) << "slot " << slot;
+            }
+            EXPECT_NE(call.in[0], call.in[1]) << "slot " << slot;
+            EXPECT_NE(call.out[0], call.out[1]) << "slot " << slot;
+        }
+        // The caller's buffers are read by the first slot and written by the last only
+        EXPECT_EQ(calls.front().back().in[0], inputs[0]);
+        EXPECT_EQ(calls.front().back().in[1], inputs[1]);
+        EXPECT_EQ(calls.back().back().out[0], outputs[0]);
+        EXPECT_EQ(calls.back().back().out[1], outputs[1]);
+        for (size_t slot = 1; slot < calls.size(); ++slot) {
+            EXPECT_EQ(calls[slot].back().in[0], calls[slot - 1].back().out[0]) << slot;
+            EXPECT_EQ(calls[slot].back().in[1], calls[slot - 1].back().out[1]) << slot;
+        }
+    }
+}
+
+TEST(PluginChainBuffers, SlotBuffersStayPutWhileTheTopologyIsUnchanged) {
+    PluginChain chain;
+    std::vector<std::vector<PointerPlugin::Call>> calls;
+    buildPointerChain(chain, {0.9f, 1.2f, 0.7f, 1.1f}, false, calls);
+
+    // The caller's buffers stay fixed too, as the audio callback's do
+    const std::vector<float> in = testBlock(0, kBlock);
+    std::vector<float> outL(kBlock), outR(kBlock);
+    const float* inputs[2] = {in.data(), in.data()};
+    float* outputs[2] = {outL.data(), outR.data()};
+    for (int b = 0; b < 10; ++b) {
+        chain.process(inputs, outputs, kBlock);
+        if (b == 4) chain.setBranchGain(1, 0, 0.5f);  // republishes the same topology
+    }
+    for (size_t slot = 0; slot < calls.size(); ++slot) {
+        ASSERT_EQ(calls[slot].size(), 10u);
+        for (const PointerPlugin::Call& call : calls[slot]) {
+            for (uint32_t ch = 0; ch < 2; ++ch) {
+                EXPECT_EQ(call.in[ch], calls[slot][0].in[ch]) << "slot " << slot;
+                EXPECT_EQ(call.out[ch], calls[slot][0].out[ch]) << "slot " << slot;
+            }
+        }
+    }
+}
+
+TEST(PluginChainBuffers, InPlaceSlotsMatchTheCopyPath) {
+    const std::vector<float> gains = {0.9f, 1.2f, 0.7f, 1.1f, 0.8f};
+    PluginChain inPlace;
+    PluginChain copying;
+    std::vector<std::vector<PointerPlugin::Call>> inPlaceCalls, copyingCalls;
+    buildPointerChain(inPlace, gains, true, inPlaceCalls);
+    buildPointerChain(copying, gains, false, copyingCalls);
+
+    std::vector<float> inPlaceL(kBlock), inPlaceR(kBlock), copyL(kBlock), copyR(kBlock);
+    float* inPlaceOut[2] = {inPlaceL.data(), inPlaceR.data()};
+    float* copyOut[2] = {copyL.data(), copyR.data()};
+    for (uint32_t b = 0; b < 30; ++b) {
+        // Bypass ramps in the middle of the chain need the dry input after the slot ran
+        if (b == 5) {
+            inPlace.setPluginBypass(2, true);
+            copying.setPluginBypass(2, true);
+        } else if (b == 15) {
+            inPlace.setPluginBypass(2, false);
+            copying.setPluginBypass(2, false);
+        }
+        const std::vector<float> inL = testBlock(b, kBlock), inR = testBlock(b + 11, kBlock);
+        const float* inputs[2] = {inL.data(), inR.data()};
+        inPlace.process(inputs, inPlaceOut, kBlock);
+        copying.process(inputs, copyOut, kBlock);
+        for (uint32_t n = 0; n < kBlock; ++n) {
+            ASSERT_EQ(inPlaceL[n], copyL[n]) << "block " << b << " frame " << n;
+            ASSERT_EQ(inPlaceR[n], copyR[n]) << "block " << b << " frame " << n;
+        }
+    }
+
+    // Steady blocks really ran in place: the middle slots share one buffer pair
+    for (size_t slot = 1; slot + 1 < gains.size(); ++slot) {
+        const PointerPlugin::Call& call = inPlaceCalls[slot].front();
+        EXPECT_EQ(call.in[0], call.out[0]) << slot;
+        EXPECT_EQ(call.in[1], call.out[1]) << slot;
+        EXPECT_EQ(call.out[0], inPlaceCalls[1].front().out[0]) << slot;
+        EXPECT_NE(copyingCalls[slot].front().in[0], copyingCalls[slot].front().out[0]) << slot;
+    }
+}
+
+TEST(PluginChainPipeline, AddsSegmentsMinusOneBlocksOfLatency) {
+    for (int stages : {2, 3}) {
+        PluginChain chain;
+        buildDelayChain(chain, {1.0f, 1.0f, 1.0f}, stages);
+        std::vector<float> in(kBlock, 1.0f), outL(kBlock), outR(kBlock);
+        const float* inputs[2] = {in.data(), in.data()};
+        float* outputs[2] = {outL.data(), outR.data()};
+        chain.process(inputs, outputs, kBlock);
+        EXPECT_EQ(chain.getAddedLatencyFrames(), static_cast<uint32_t>(stages - 1) * kBlock);
+
+        chain.setPipelineStages(0);
+        chain.process(inputs, outputs, kBlock);
+        EXPECT_EQ(chain.getAddedLatencyFrames(), 0u);
+    }
+}
+
+TEST(PluginChainPipeline, OutputMatchesSerialChainDelayedBySegments) {
+    const std::vector<float> gains = {0.9f, 1.5f, 0.5f, 2.0f};
+    for (int stages : {2, 3, 4}) {
+        PluginChain serial;
+        PluginChain pipelined;
+        buildDelayChain(serial, gains, 0);
+        buildDelayChain(pipelined, gains, stages);
+
+        const uint32_t lag = static_cast<uint32_t>(stages - 1);
+        std::vector<std::vector<float>> expected;
+        std::vector<float> outL(kBlock), outR(kBlock);
+        float* outputs[2] = {outL.data(), outR.data()};
+        for (uint32_t b = 0; b < 40; ++b) {
+            const std::vector<float> in = testBlock(b, kBlock);
+            const float* inputs[2] = {in.data(), in.data()};
+            serial.process(inputs, outputs, kBlock);
+            expected.push_back(outL);
+
+            pipelined.process(inputs, outputs, kBlock);
+            for (uint32_t n = 0; n < kBlock; ++n) {
+                // The first blocks out of the pipe are the silence it was primed with
+                const float want = b < lag ? 0.0f : expected[b - lag][n];
+                ASSERT_FLOAT_EQ(outL[n], want) << "stages " << stages << " block " << b << " frame " << n;
+                ASSERT_FLOAT_EQ(outR[n], want) << "stages " << stages << " block " << b << " frame " << n;
+            }
+        }
+    }
+}
+
+TEST(PluginChainPipeline, BlockSizeChangeRestartsThePipeFromSilence) {
+    PluginChain chain;
+    buildDelayChain(chain, {1.0f, 1.0f}, 2);
+    std::vector<float> outL(kBlock), outR(kBlock);
+    float* outputs[2] = {outL.data(), outR.data()};
+    for (uint32_t b = 0; b < 5; ++b) {
+        const std::vector<float> in = testBlock(b, kBlock);
+        const float* inputs[2] = {in.data(), in.data()};
+        chain.process(inputs, outputs, kBlock);
+    }
+
+    for (uint32_t frames : {32u, kBlock}) {
+        // First block at the new size: the queued block no longer lines up and is dropped
+        std::vector<float> first = testBlock(100, frames);
+        const float* inputs[2] = {first.data(), first.data()};
+        chain.process(inputs, outputs, frames);
+        EXPECT_EQ(chain.getAddedLatencyFrames(), frames);
+        // (frame 0 is the sample the second delay still held from the previous block)
+        for (uint32_t n = 1; n < frames; ++n) ASSERT_EQ(outL[n], 0.0f) << frames << " frame " << n;
+
+        // Next block: the one queued at the new size, through both one-frame delays
+        std::vector<float> second = testBlock(101, frames);
+        inputs[0] = inputs[1] = second.data();
+        chain.process(inputs, outputs, frames);
+        for (uint32_t n = 2; n < frames; ++n) {
+            ASSERT_FLOAT_EQ(outL[n], first[n - 2]) << frames << " frame " << n;
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "plugin/PluginInfoCodec.h"
+#include "plugin/PluginRegistry.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using guitarrackcraft::decodePluginCatalog;
+using guitarrackcraft::encodePluginCatalog;
+using guitarrackcraft::IPlugin;
+using guitarrackcraft::IPluginFactory;
+using guitarrackcraft::PluginInfo;
+using guitarrackcraft::PluginRegistry;
+using guitarrackcraft::PortInfo;
+
+namespace {
+
+PluginInfo makePlugin(const std::string& id) {
+    PluginInfo info;
+    info.id = id;
+    info.name = "Amp " + id;
+    info.format = "LV2";
+    info.modguiBasePath = "/bundles/amp.lv2";
+    info.modguiIconTemplate = "modgui/icon.html";
+    info.hasX11Ui = true;
+    info.x11UiBinaryPath = "/lib/libamp_ui.so";
+    info.x11UiUri = id + "#ui";
+    PortInfo mode{};
+    mode.index = 4;
+    mode.name = "Mode";
+    mode.symbol = "mode";
+    mode.isInput = true;
+    mode.isControl = true;
+    mode.defaultValue = 1.0f;
+    mode.maxValue = 2.0f;
+    mode.scalePoints = {{"Clean", 0.0f}, {"Crunch", 1.0f}, {"Lead", 2.0f}};
+    PortInfo out{};
+    out.index = 1;
+    out.name = "Out";
+    out.symbol = "out";
+    out.isAudio = true;
+    info.ports = {mode, out};
+    return info;
+}
+
+class CatalogFactory : public IPluginFactory {
+public:
+    std::string getFormat() const override { return "LV2"; }
+    std::vector<PluginInfo> enumeratePlugins() override { return plugins; }
+    std::unique_ptr<IPlugin> createPlugin(const std::string&) override { return nullptr; }
+    bool initialize() override { return true; }
+
+    std::vector<PluginInfo> plugins;
+};
+
+} // namespace
+
+TEST(PluginInfoCodec, CatalogRoundTripsEveryField) {
+    const std::vector<PluginInfo> plugins = {makePlugin("urn:amp"), makePlugin("urn:fuzz")};
+    const auto bytes = encodePluginCatalog(plugins, 7);
+
+    std::vector<PluginInfo> decoded;
+    uint64_t version = 0;
+    ASSERT_TRUE(decodePluginCatalog(bytes.data(), bytes.size(), decoded, &version));
+    EXPECT_EQ(version, 7u);
+    ASSERT_EQ(decoded.size(), 2u);
+    const PluginInfo& p = decoded[1];
+    EXPECT_EQ(p.id, "urn:fuzz");
+    EXPECT_EQ(p.name, "Amp urn:fuzz");
+    EXPECT_EQ(p.modguiIconTemplate, "modgui/icon.html");
+    EXPECT_TRUE(p.hasX11Ui);
+    EXPECT_EQ(p.x11UiUri, "urn:fuzz#ui");
+    ASSERT_EQ(p.ports.size(), 2u);
+    EXPECT_EQ(p.ports[0].index, 4u);
+    EXPECT_TRUE(p.ports[0].isControl);
+    EXPECT_FALSE(p.ports[0].isAudio);
+    EXPECT_FLOAT_EQ(p.ports[0].maxValue, 2.0f);
+    ASSERT_EQ(p.ports[0].scalePoints.size(), 3u);
+    EXPECT_EQ(p.ports[0].scalePoints[2].label, "Lead");
+    EXPECT_TRUE(p.ports[1].isAudio);
+    EXPECT_FALSE(p.ports[1].isInput);
+}
+
+TEST(PluginInfoCodec, RejectsTruncatedOrForeignBuffers) {
+    const auto bytes = encodePluginCatalog({makePlugin("urn:amp")}, 1);
+    std::vector<PluginInfo> decoded;
+    EXPECT_FALSE(decodePluginCatalog(bytes.data(), bytes.size() - 1, decoded));
+    EXPECT_TRUE(decoded.empty());
+
+    auto foreign = bytes;
+    foreign[0] ^= 0xFF;
+    EXPECT_FALSE(decodePluginCatalog(foreign.data(), foreign.size(), decoded));
+
+    auto trailing = bytes;
+    trailing.push_back(0);
+    EXPECT_FALSE(decodePluginCatalog(trailing.data(), trailing.size(), decoded));
+}
+
+TEST(PluginInfoCodec, RegistrySnapshotIsSortedAndReusedUntilRescan) {
+    auto factory = std::make_unique<CatalogFactory>();
+    CatalogFactory* raw = factory.get();
+    raw->plugins = {makePlugin("urn:zeta"), makePlugin("urn:alpha")};
+    PluginRegistry registry;
+    registry.registerFactory(std::move(factory));
+    EXPECT_EQ(registry.catalogVersion(), 0u);
+    ASSERT_TRUE(registry.initializeAll());
+    const uint64_t first = registry.catalogVersion();
+    EXPECT_NE(first, 0u);
+
+    const std::vector<uint8_t>& snapshot = registry.catalogSnapshot();
+    EXPECT_EQ(&registry.catalogSnapshot(), &snapshot);
+    std::vector<PluginInfo> decoded;
+    uint64_t version = 0;
+    ASSERT_TRUE(decodePluginCatalog(snapshot.data(), snapshot.size(), decoded, &version));
+    EXPECT_EQ(version, first);
+    ASSERT_EQ(decoded.size(), 2u);
+    EXPECT_EQ(decoded[0].id, "urn:alpha");
+    EXPECT_EQ(decoded[1].id, "urn:zeta");
+
+    raw->plugins.push_back(makePlugin("urn:mid"));
+    ASSERT_TRUE(registry.initializeAll());
+    EXPECT_GT(registry.catalogVersion(), first);
+    const std::vector<uint8_t>& rescanned = registry.catalogSnapshot();
+    EXPECT_NE(&rescanned, &snapshot);
+    ASSERT_TRUE(decodePluginCatalog(rescanned.data(), rescanned.size(), decoded));
+    EXPECT_EQ(decoded.size(), 3u);
+    // The earlier snapshot is still alive for any ByteBuffer that views it
+    ASSERT_TRUE(decodePluginCatalog(snapshot.data(), snapshot.size(), decoded));
+    EXPECT_EQ(decoded.size(), 2u);
+}
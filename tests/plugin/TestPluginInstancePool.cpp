@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "plugin/PluginInstancePool.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+using guitarrackcraft::IPlugin;
+using guitarrackcraft::PluginInfo;
+using guitarrackcraft::PluginInstancePool;
+
+namespace {
+
+std::atomic<int> g_alive{0};
+
+class FakePlugin : public IPlugin {
+public:
+    explicit FakePlugin(std::string id) : id_(std::move(id)) { g_alive.fetch_add(1); }
+    ~FakePlugin() override { g_alive.fetch_sub(1); }
+
+    void activate(float sampleRate, uint32_t bufferSize) override {
+        rate = sampleRate;
+        buffer = bufferSize;
+    }
+    void deactivate() override {}
+    void process(const float* const*, float* const*, uint32_t) override {}
+    PluginInfo getInfo() const override {
+        PluginInfo info;
+        info.id = id_;
+        return info;
+    }
+    void setParameter(uint32_t, float) override {}
+    float getParameter(uint32_t) const override { return 0.0f; }
+    uint32_t getNumInputPorts() const override { return 2; }
+    uint32_t getNumOutputPorts() const override { return 2; }
+
+    float rate = 0.0f;
+    uint32_t buffer = 0;
+
+private:
+    std::string id_;
+};
+
+struct Counting {
+    std::atomic<int> created{0};
+    PluginInstancePool::Creator creator() {
+        return [this](const std::string& id) -> std::unique_ptr<IPlugin> {
+            created.fetch_add(1);
+            if (id == "LV2:broken") return nullptr;
+            return std::make_unique<FakePlugin>(id);
+        };
+    }
+};
+
+TEST(PluginInstancePoolTest, WarmsOneSparePerIdAndRefillsAfterTake) {
+    Counting counting;
+    PluginInstancePool pool(counting.creator());
+    EXPECT_EQ(pool.take("LV2:amp"), nullptr);
+
+    pool.setWarmSet({"LV2:amp", "LV2:cab", "LV2:amp"});
+    pool.waitIdle();
+    EXPECT_EQ(pool.spareCount(), 2u);
+    EXPECT_EQ(counting.created.load(), 2);
+
+    auto amp = pool.take("LV2:amp");
+    ASSERT_NE(amp, nullptr);
+    EXPECT_EQ(amp->getInfo().id, "LV2:amp");
+    EXPECT_EQ(pool.take("LV2:drive"), nullptr);
+
+    pool.waitIdle();
+    EXPECT_EQ(pool.spareCount(), 2u);
+    EXPECT_EQ(counting.created.load(), 3);
+}
+
+TEST(PluginInstancePoolTest, ActivatesSparesAtCurrentSettings) {
+    Counting counting;
+    PluginInstancePool pool(counting.creator());
+    pool.setWarmSet({"LV2:amp"});
+    pool.waitIdle();
+    auto inactive = pool.take("LV2:amp");
+    ASSERT_NE(inactive, nullptr);
+    EXPECT_EQ(static_cast<FakePlugin*>(inactive.get())->rate, 0.0f);
+
+    pool.setActivation(48000.0f, 128);
+    pool.waitIdle();
+    auto active = pool.take("LV2:amp");
+    ASSERT_NE(active, nullptr);
+    EXPECT_EQ(static_cast<FakePlugin*>(active.get())->rate, 48000.0f);
+    EXPECT_EQ(static_cast<FakePlugin*>(active.get())->buffer, 128u);
+
+    // Outdated spares are replaced in the background
+    pool.waitIdle();
+    const int before = counting.created.load();
+    pool.setActivation(44100.0f, 256);
+    pool.waitIdle();
+    EXPECT_EQ(counting.created.load(), before + 1);
+    auto replaced = pool.take("LV2:amp");
+    ASSERT_NE(replaced, nullptr);
+    EXPECT_EQ(static_cast<FakePlugin*>(replaced.get())->rate, 44100.0f);
+}
+
+TEST(PluginInstancePoolTest, DropsUnwantedSparesAndSkipsFailures) {
+    Counting counting;
+    {
+        PluginInstancePool pool(counting.creator());
+        pool.setWarmSet({"LV2:amp", "LV2:broken"});
+        pool.waitIdle();
+        EXPECT_EQ(pool.spareCount(), 1u);
+        const int afterFirst = counting.created.load();
+        EXPECT_EQ(afterFirst, 2);
+
+        pool.setWarmSet({"LV2:cab"});
+        pool.waitIdle();
+        EXPECT_EQ(pool.spareCount(), 1u);
+        EXPECT_EQ(pool.take("LV2:amp"), nullptr);
+        EXPECT_NE(pool.take("LV2:cab"), nullptr);
+        pool.waitIdle();
+    }
+    EXPECT_EQ(g_alive.load(), 0);
+}
+
+} // namespace
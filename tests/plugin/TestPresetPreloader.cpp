@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "plugin/PresetPreloader.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+using guitarrackcraft::IPlugin;
+using guitarrackcraft::PluginChain;
+using guitarrackcraft::PluginInfo;
+using guitarrackcraft::PluginState;
+using guitarrackcraft::PresetPreloader;
+
+namespace {
+
+class StatefulPlugin : public IPlugin {
+public:
+    void activate(float sampleRate, uint32_t) override { rate = sampleRate; }
+    void deactivate() override {}
+    void process(const float* const*, float* const*, uint32_t) override { ++blocks; }
+    PluginInfo getInfo() const override { return {}; }
+    void setParameter(uint32_t, float value) override { gain = value; }
+    float getParameter(uint32_t) const override { return gain; }
+    uint32_t getNumInputPorts() const override { return 2; }
+    uint32_t getNumOutputPorts() const override { return 2; }
+    bool restoreState(const PluginState& state) override {
+        for (const auto& cp : state.controlPortValues) gain = cp.second;
+        restored = true;
+        return true;
+    }
+
+    float rate = 0.0f;
+    float gain = 0.0f;
+    int blocks = 0;
+    bool restored = false;
+};
+
+PresetPreloader::Preset preset(const std::string& key, std::vector<std::string> uris, float gain = 0.5f) {
+    PresetPreloader::Preset p;
+    p.key = key;
+    for (const auto& uri : uris) {
+        PluginState s;
+        s.pluginUri = uri;
+        s.controlPortValues = {{0, gain}};
+        p.state.plugins.push_back(s);
+    }
+    return p;
+}
+
+struct Counting {
+    std::atomic<int> created{0};
+    PresetPreloader::Creator creator() {
+        return [this](const std::string& uri) -> std::unique_ptr<IPlugin> {
+            created.fetch_add(1);
+            if (uri == "urn:broken") return nullptr;
+            return std::make_unique<StatefulPlugin>();
+        };
+    }
+};
+
+constexpr size_t kChain = PresetPreloader::kInstanceOverheadBytes;
+
+} // namespace
+
+TEST(PresetPreloaderTest, PreparesArmedChainsActivatedAndRestored) {
+    Counting counting;
+    PresetPreloader preloader(counting.creator());
+    preloader.setActivation(48000.0f, 128);
+    auto next = preset("song2", {"urn:amp", "urn:cab"}, 0.7f);
+    preloader.arm({next, preset("song3", {"urn:amp"})});
+    preloader.waitIdle();
+    EXPECT_EQ(preloader.preparedCount(), 2u);
+    EXPECT_EQ(preloader.residentBytes(), 3 * kChain);
+
+    auto chain = preloader.take("song2", next.state);
+    ASSERT_NE(chain, nullptr);
+    ASSERT_EQ(chain->plugins.size(), 2u);
+    auto* amp = static_cast<StatefulPlugin*>(chain->plugins[0].get());
+    EXPECT_FLOAT_EQ(amp->rate, 48000.0f);
+    EXPECT_TRUE(amp->restored);
+    EXPECT_FLOAT_EQ(amp->gain, 0.7f);
+    EXPECT_GT(amp->blocks, 0);  // warmed up
+    EXPECT_EQ(preloader.preparedCount(), 1u);
+    EXPECT_EQ(preloader.take("song2", next.state), nullptr);
+}
+
+TEST(PresetPreloaderTest, TakeRejectsChangedStateAndSettings) {
+    Counting counting;
+    PresetPreloader preloader(counting.creator());
+    preloader.setActivation(48000.0f, 128);
+    auto p = preset("song", {"urn:amp"}, 0.5f);
+    preloader.arm({p});
+    preloader.waitIdle();
+
+    EXPECT_EQ(preloader.take("song", preset("song", {"urn:amp"}, 0.9f).state), nullptr);
+    preloader.setActivation(44100.0f, 128);
+    preloader.waitIdle();  // rebuilt at the new rate
+    auto chain = preloader.take("song", p.state);
+    ASSERT_NE(chain, nullptr);
+    EXPECT_FLOAT_EQ(static_cast<StatefulPlugin*>(chain->plugins[0].get())->rate, 44100.0f);
+    EXPECT_EQ(counting.created.load(), 2);
+}
+
+TEST(PresetPreloaderTest, BudgetEvictsLeastRecentlyArmedFirst) {
+    Counting counting;
+    PresetPreloader preloader(counting.creator());
+    preloader.setBudgetBytes(2 * kChain);
+    preloader.arm({preset("a", {"urn:amp"}), preset("b", {"urn:amp"})});
+    preloader.waitIdle();
+    EXPECT_EQ(preloader.preparedCount(), 2u);
+
+    // Moving on in the setlist: "a" is no longer armed and gets evicted for "c"
+    auto c = preset("c", {"urn:amp"});
+    preloader.arm({preset("b", {"urn:amp"}), c});
+    preloader.waitIdle();
+    EXPECT_EQ(preloader.preparedCount(), 2u);
+    EXPECT_EQ(preloader.take("a", preset("a", {"urn:amp"}).state), nullptr);
+    EXPECT_NE(preloader.take("c", c.state), nullptr);
+
+    // A chain larger than the budget is never prepared, and never evicts higher priority ones
+    preloader.arm({preset("b", {"urn:amp"}), preset("big", {"urn:amp", "urn:cab", "urn:eq"})});
+    preloader.waitIdle();
+    EXPECT_EQ(preloader.preparedCount(), 1u);
+    EXPECT_NE(preloader.take("b", preset("b", {"urn:amp"}).state), nullptr);
+}
+
+TEST(PresetPreloaderTest, FailedChainsAreSkippedAndClearDropsEverything) {
+    Counting counting;
+    PresetPreloader preloader(counting.creator());
+    preloader.arm({preset("bad", {"urn:amp", "urn:broken"}), preset("good", {"urn:amp"})});
+    preloader.waitIdle();
+    EXPECT_EQ(preloader.preparedCount(), 1u);
+
+    preloader.clear();
+    EXPECT_EQ(preloader.preparedCount(), 0u);
+    EXPECT_EQ(preloader.residentBytes(), 0u);
+}
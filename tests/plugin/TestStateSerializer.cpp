@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "plugin/StateSerializer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using guitarrackcraft::PluginChain;
+using guitarrackcraft::PluginState;
+using guitarrackcraft::StateProperty;
+
+namespace {
+
+PluginChain::ChainState makeChain() {
+    PluginChain::ChainState chain;
+
+    PluginState amp;
+    amp.pluginUri = "urn:test:amp";
+    amp.controlPortValues = {{0, 0.5f}, {3, -12.0f}};
+    StateProperty model;
+    model.keyUri = "urn:test:model";
+    model.typeUri = "http://lv2plug.in/ns/ext/atom#Path";
+    model.flags = 3;
+    model.value = {'/', 'm', '.', 'n', 'a', 'm', 0};
+    amp.properties.push_back(model);
+    StateProperty blob;
+    blob.keyUri = "urn:test:blob";
+    blob.typeUri = "urn:test:chunk";
+    blob.value = {0x00, 0xff, 0x10};
+    amp.properties.push_back(blob);
+    chain.plugins.push_back(amp);
+
+    // Same URIs again: must be interned, not duplicated
+    PluginState amp2 = amp;
+    amp2.controlPortValues = {{1, 1.0f}};
+    chain.plugins.push_back(amp2);
+
+    PluginState empty;
+    empty.pluginUri = "urn:test:gate";
+    chain.plugins.push_back(empty);
+    return chain;
+}
+
+size_t countOccurrences(const std::vector<uint8_t>& bytes, const std::string& needle) {
+    size_t n = 0;
+    const std::string hay(bytes.begin(), bytes.end());
+    for (size_t pos = hay.find(needle); pos != std::string::npos; pos = hay.find(needle, pos + 1)) ++n;
+    return n;
+}
+
+} // namespace
+
+TEST(StateSerializerTest, BinaryRoundTrip) {
+    const auto chain = makeChain();
+    const auto bytes = guitarrackcraft::serializeChainStateToBinary(chain);
+
+    PluginChain::ChainState out;
+    ASSERT_TRUE(guitarrackcraft::deserializeChainStateFromBinary(bytes.data(), bytes.size(), out));
+    ASSERT_EQ(out.plugins.size(), chain.plugins.size());
+    for (size_t i = 0; i < chain.plugins.size(); ++i) {
+        const auto& a = chain.plugins[i];
+        const auto& b = out.plugins[i];
+        EXPECT_EQ(b.pluginUri, a.pluginUri);
+        EXPECT_EQ(b.controlPortValues, a.controlPortValues);
+        ASSERT_EQ(b.properties.size(), a.properties.size());
+        for (size_t p = 0; p < a.properties.size(); ++p) {
+            EXPECT_EQ(b.properties[p].keyUri, a.properties[p].keyUri);
+            EXPECT_EQ(b.properties[p].typeUri, a.properties[p].typeUri);
+            EXPECT_EQ(b.properties[p].flags, a.properties[p].flags);
+            EXPECT_EQ(b.properties[p].value, a.properties[p].value);
+        }
+    }
+}
+
+TEST(StateSerializerTest, BinaryInternsUris) {
+    const auto bytes = guitarrackcraft::serializeChainStateToBinary(makeChain());
+    EXPECT_EQ(countOccurrences(bytes, "urn:test:amp"), 1u);
+    EXPECT_EQ(countOccurrences(bytes, "urn:test:model"), 1u);
+}
+
+TEST(StateSerializerTest, BinaryRejectsCorruption) {
+    const auto bytes = guitarrackcraft::serializeChainStateToBinary(makeChain());
+    PluginChain::ChainState out;
+
+    for (size_t i = 0; i < bytes.size(); i += 7) {
+        auto damaged = bytes;
+        damaged[i] ^= 0x5a;
+        EXPECT_FALSE(guitarrackcraft::deserializeChainStateFromBinary(damaged.data(), damaged.size(), out))
+            << "flipped byte " << i;
+        EXPECT_TRUE(out.plugins.empty());
+    }
+    for (size_t len : {size_t(0), size_t(10), bytes.size() - 1}) {
+        EXPECT_FALSE(guitarrackcraft::deserializeChainStateFromBinary(bytes.data(), len, out));
+    }
+}
+
+TEST(StateSerializerTest, FileRoundTrip) {
+    char tmpl[] = "/tmp/chain_state_XXXXXX";
+    const int fd = mkstemp(tmpl);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    const std::string path = tmpl;
+
+    ASSERT_TRUE(guitarrackcraft::saveChainStateFile(path, makeChain()));
+    PluginChain::ChainState out;
+    ASSERT_TRUE(guitarrackcraft::loadChainStateFile(path, out));
+    EXPECT_EQ(out.plugins.size(), 3u);
+    EXPECT_EQ(out.plugins[2].pluginUri, "urn:test:gate");
+
+    std::remove(path.c_str());
+    EXPECT_FALSE(guitarrackcraft::loadChainStateFile(path, out));
+    EXPECT_TRUE(out.plugins.empty());
+}
+
+TEST(StateSerializerTest, EmptyChain) {
+    const auto bytes = guitarrackcraft::serializeChainStateToBinary({});
+    PluginChain::ChainState out;
+    EXPECT_TRUE(guitarrackcraft::deserializeChainStateFromBinary(bytes.data(), bytes.size(), out));
+    EXPECT_TRUE(out.plugins.empty());
+}
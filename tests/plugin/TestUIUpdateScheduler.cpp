@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "plugin/UIUpdateScheduler.h"
+
+#include <cstring>
+#include <vector>
+
+using guitarrackcraft::PatchSetUrids;
+using guitarrackcraft::UIIdleBudget;
+using guitarrackcraft::coalesceOutputAtoms;
+
+namespace {
+
+constexpr uint32_t kObject = 10;
+constexpr uint32_t kSet = 11;
+constexpr uint32_t kProperty = 12;
+constexpr uint32_t kValue = 13;
+constexpr uint32_t kUrid = 14;
+constexpr uint32_t kFloat = 15;
+constexpr uint32_t kOther = 16;
+
+PatchSetUrids urids() {
+    PatchSetUrids u;
+    u.atomObject = kObject;
+    u.atomBlank = 0;
+    u.patchSet = kSet;
+    u.patchProperty = kProperty;
+    return u;
+}
+
+void put(std::vector<uint8_t>& buf, uint32_t v) {
+    uint8_t b[4];
+    std::memcpy(b, &v, 4);
+    buf.insert(buf.end(), b, b + 4);
+}
+
+void putFloat(std::vector<uint8_t>& buf, float f) {
+    uint32_t v;
+    std::memcpy(&v, &f, 4);
+    put(buf, v);
+}
+
+/** [port] patch:Set { patch:property <property>, patch:value <value> } as in LV2 forge output. */
+OutputAtomEvent patchSet(uint32_t port, uint32_t property, float value, bool valueFirst = false) {
+    std::vector<uint8_t> body;
+    put(body, 0);     // id
+    put(body, kSet);  // otype
+    auto addProperty = [&] {
+        put(body, kProperty); put(body, 0); put(body, 4); put(body, kUrid);
+        put(body, property); put(body, 0);  // padding
+    };
+    auto addValue = [&] {
+        put(body, kValue); put(body, 0); put(body, 4); put(body, kFloat);
+        putFloat(body, value); put(body, 0);
+    };
+    if (valueFirst) { addValue(); addProperty(); } else { addProperty(); addValue(); }
+    OutputAtomEvent ev;
+    ev.portIndex = port;
+    put(ev.data, static_cast<uint32_t>(body.size()));
+    put(ev.data, kObject);
+    ev.data.insert(ev.data.end(), body.begin(), body.end());
+    return ev;
+}
+
+OutputAtomEvent plainAtom(uint32_t port, uint32_t tag) {
+    OutputAtomEvent ev;
+    ev.portIndex = port;
+    put(ev.data, 4);
+    put(ev.data, kOther);
+    put(ev.data, tag);
+    return ev;
+}
+
+float valueOf(const OutputAtomEvent& ev) {
+    float f;
+    std::memcpy(&f, ev.data.data() + ev.data.size() - 8, 4);
+    return f;
+}
+
+} // namespace
+
+TEST(CoalesceOutputAtoms, KeepsLastPatchSetPerProperty) {
+    std::vector<OutputAtomEvent> events = {
+        patchSet(5, 100, 1.0f), patchSet(5, 200, 2.0f), patchSet(5, 100, 3.0f),
+        patchSet(5, 100, 4.0f)};
+    EXPECT_EQ(coalesceOutputAtoms(events, urids()), 2u);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_FLOAT_EQ(valueOf(events[0]), 2.0f);
+    EXPECT_FLOAT_EQ(valueOf(events[1]), 4.0f);
+}
+
+TEST(CoalesceOutputAtoms, PortsAndOtherAtomsAreKept) {
+    std::vector<OutputAtomEvent> events = {
+        plainAtom(5, 1), patchSet(5, 100, 1.0f), patchSet(6, 100, 2.0f), plainAtom(5, 1),
+        patchSet(5, 100, 3.0f, true)};
+    EXPECT_EQ(coalesceOutputAtoms(events, urids()), 1u);
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events[0].portIndex, 5u);
+    EXPECT_EQ(events[1].portIndex, 6u);
+    EXPECT_EQ(events[2].data, plainAtom(5, 1).data);
+    EXPECT_EQ(events[3].data, patchSet(5, 100, 3.0f, true).data);  // property after value
+}
+
+TEST(CoalesceOutputAtoms, TruncatedAtomsAreLeftAlone) {
+    OutputAtomEvent cut = patchSet(5, 100, 1.0f);
+    cut.data.resize(20);
+    std::vector<OutputAtomEvent> events = {cut, cut, patchSet(5, 100, 2.0f)};
+    EXPECT_EQ(coalesceOutputAtoms(events, urids()), 0u);
+    EXPECT_EQ(events.size(), 3u);
+}
+
+TEST(UIIdleBudget, CheapUIRunsEveryLoopPass) {
+    UIIdleBudget budget;
+    EXPECT_TRUE(budget.due(0));
+    budget.ran(0, 200000, 10);  // 0.2 ms for ten UIs is well within a 16 ms pass
+    EXPECT_EQ(budget.intervalNs(), UIIdleBudget::kMinIntervalNs);
+    EXPECT_FALSE(budget.due(10000000));
+    EXPECT_TRUE(budget.due(UIIdleBudget::kMinIntervalNs - 1000000));
+}
+
+TEST(UIIdleBudget, ExpensiveUIsAreSpreadOut) {
+    UIIdleBudget one, ten;
+    for (int i = 0; i < 20; ++i) {
+        one.ran(0, 2000000, 1);
+        ten.ran(0, 2000000, 10);
+    }
+    EXPECT_EQ(one.intervalNs(), UIIdleBudget::kMinIntervalNs);
+    EXPECT_EQ(ten.intervalNs(), 80000000);  // 2 ms * 10 UIs / 25%
+    for (int i = 0; i < 20; ++i) ten.ran(0, 50000000, 10);
+    EXPECT_EQ(ten.intervalNs(), UIIdleBudget::kMaxIntervalNs);
+    ten.reset();
+    EXPECT_TRUE(ten.due(0));
+    EXPECT_EQ(ten.intervalNs(), UIIdleBudget::kMinIntervalNs);
+}
@@ -0,0 +1,78 @@
+// Per-callback fixed costs of AudioEngine::onAudioReady: the scalar loops it used to run
+// (input scan, output scan, then interleave) against the fused kernels.
+// Configure with -DCMAKE_BUILD_TYPE=Release. Build for arm64 to measure the NEON path; on
+// other hosts the kernels fall back to their fused scalar loops.
+// Usage: audio_kernels_bench [iterations]
+
+#include "utils/AudioKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace kernels = guitarrackcraft::kernels;
+
+namespace {
+
+volatile float gSink;
+
+// The pre-kernel callback: three traversals plus a separate clip compare
+void legacyCallback(const float* in, const float* l, const float* r, float* out, size_t n) {
+    float inPeak = 0.0f;
+    bool inClip = false;
+    for (size_t i = 0; i < n; ++i) {
+        float s = std::fabs(in[i]);
+        if (s > inPeak) inPeak = s;
+        if (s >= 0.99f) inClip = true;
+    }
+    float outPeak = 0.0f;
+    bool outClip = false;
+    for (size_t i = 0; i < n; ++i) {
+        float s = std::max(std::fabs(l[i]), std::fabs(r[i]));
+        if (s > outPeak) outPeak = s;
+        if (s >= 0.99f) outClip = true;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        out[i * 2] = l[i];
+        out[i * 2 + 1] = r[i];
+    }
+    gSink = inPeak + outPeak + (inClip ? 1.0f : 0.0f) + (outClip ? 1.0f : 0.0f);
+}
+
+void kernelCallback(const float* in, const float* l, const float* r, float* out, size_t n) {
+    const float inPeak = kernels::peakAbs(in, n);
+    const float outPeak = kernels::interleaveStereoPeak(l, r, out, n);
+    gSink = inPeak + outPeak + (inPeak >= 0.99f ? 1.0f : 0.0f) + (outPeak >= 0.99f ? 1.0f : 0.0f);
+}
+
+template <typename Fn>
+double nsPerCall(Fn fn, const std::vector<float>& in, const std::vector<float>& l,
+                 const std::vector<float>& r, std::vector<float>& out, size_t n, int iterations) {
+    for (int i = 0; i < iterations / 10; ++i) fn(in.data(), l.data(), r.data(), out.data(), n);
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) fn(in.data(), l.data(), r.data(), out.data(), n);
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+    std::printf("%8s %12s %12s %8s\n", "frames", "scalar ns", "kernel ns", "speedup");
+    for (size_t n : {32, 64, 96, 128, 192, 256, 512}) {
+        std::vector<float> in(n), l(n), r(n), out(n * 2);
+        for (size_t i = 0; i < n; ++i) {
+            in[i] = std::sin(0.01f * i);
+            l[i] = std::sin(0.02f * i) * 0.8f;
+            r[i] = std::cos(0.03f * i) * 0.8f;
+        }
+        const double legacy = nsPerCall(legacyCallback, in, l, r, out, n, iterations);
+        const double fused = nsPerCall(kernelCallback, in, l, r, out, n, iterations);
+        std::printf("%8zu %12.1f %12.1f %7.2fx\n", n, legacy, fused, legacy / fused);
+    }
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include "utils/AudioKernels.h"
+
+#include <cmath>
+#include <vector>
+
+namespace kernels = guitarrackcraft::kernels;
+
+namespace {
+
+// Odd lengths exercise the vector body and the scalar tail
+const size_t kLengths[] = {0, 1, 3, 4, 7, 8, 15, 64, 129};
+
+std::vector<float> ramp(size_t n, float scale, float offset) {
+    std::vector<float> v(n);
+    for (size_t i = 0; i < n; ++i) v[i] = std::sin(offset + 0.37f * i) * scale;
+    return v;
+}
+
+} // namespace
+
+TEST(AudioKernels, PeakAbsFindsLargestMagnitude) {
+    for (size_t n : kLengths) {
+        auto x = ramp(n, 0.5f, 0.0f);
+        if (n > 0) x[n - 1] = -0.9f;  // peak in the tail
+        EXPECT_FLOAT_EQ(kernels::peakAbs(x.data(), n), kernels::scalar::peakAbs(x.data(), n)) << n;
+        if (n > 0) {
+            EXPECT_FLOAT_EQ(kernels::peakAbs(x.data(), n), 0.9f) << n;
+        }
+    }
+}
+
+TEST(AudioKernels, PeakAbsClipThreshold) {
+    std::vector<float> x(32, 0.1f);
+    EXPECT_LT(kernels::peakAbs(x.data(), x.size()), 0.99f);
+    x[17] = -0.995f;
+    EXPECT_GE(kernels::peakAbs(x.data(), x.size()), 0.99f);
+}
+
+TEST(AudioKernels, InterleaveMatchesScalar) {
+    for (size_t n : kLengths) {
+        auto l = ramp(n, 0.7f, 0.0f);
+        auto r = ramp(n, 1.2f, 1.0f);
+        std::vector<float> out(n * 2 + 1, 42.0f), ref(n * 2 + 1, 42.0f);
+        const float peak = kernels::interleaveStereoPeak(l.data(), r.data(), out.data(), n);
+        const float refPeak = kernels::scalar::interleaveStereoPeak(l.data(), r.data(), ref.data(), n);
+        EXPECT_FLOAT_EQ(peak, refPeak) << n;
+        EXPECT_EQ(out, ref) << n;
+        EXPECT_EQ(out[n * 2], 42.0f);  // no overrun
+    }
+}
+
+TEST(AudioKernels, MonoMixMetersInputs) {
+    for (size_t n : kLengths) {
+        auto l = ramp(n, 0.4f, 0.0f);
+        std::vector<float> r(n);
+        for (size_t i = 0; i < n; ++i) r[i] = -l[i];
+        std::vector<float> out(n, 1.0f);
+        const float peak = kernels::mixToMonoPeak(l.data(), r.data(), out.data(), n);
+        EXPECT_FLOAT_EQ(peak, kernels::scalar::peakAbs(l.data(), n)) << n;
+        for (size_t i = 0; i < n; ++i) EXPECT_FLOAT_EQ(out[i], 0.0f);
+    }
+}
+
+TEST(AudioKernels, DeinterleaveRoundTrip) {
+    for (size_t n : kLengths) {
+        auto l = ramp(n, 0.3f, 0.5f);
+        auto r = ramp(n, 0.6f, 2.0f);
+        std::vector<float> lr(n * 2), l2(n), r2(n);
+        kernels::interleaveStereoPeak(l.data(), r.data(), lr.data(), n);
+        kernels::deinterleaveStereo(lr.data(), l2.data(), r2.data(), n);
+        EXPECT_EQ(l, l2) << n;
+        EXPECT_EQ(r, r2) << n;
+    }
+}
+
+TEST(AudioKernels, GainAndMix) {
+    for (size_t n : kLengths) {
+        auto a = ramp(n, 1.0f, 0.0f);
+        auto b = ramp(n, 1.0f, 3.0f);
+        std::vector<float> out(n), ref(n);
+        kernels::copyWithGain(out.data(), a.data(), n, 0.5f);
+        kernels::mixInto(out.data(), b.data(), n, 0.25f);
+        kernels::applyGain(out.data(), n, 2.0f);
+        kernels::scalar::copyWithGain(ref.data(), a.data(), n, 0.5f);
+        kernels::scalar::mixInto(ref.data(), b.data(), n, 0.25f);
+        kernels::scalar::applyGain(ref.data(), n, 2.0f);
+        for (size_t i = 0; i < n; ++i) EXPECT_NEAR(out[i], ref[i], 1e-6f) << n;
+    }
+}
+
+TEST(AudioKernels, PcmToFloatMatchesScalar) {
+    for (size_t n : kLengths) {
+        // Offset by one byte: views into a mapped file have no alignment guarantee
+        std::vector<uint8_t> bytes(n * 4 + 1);
+        for (size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+        const uint8_t* src = bytes.data() + 1;
+        std::vector<float> out(n), ref(n);
+
+        kernels::pcm16ToFloat(src, out.data(), n);
+        kernels::scalar::pcm16ToFloat(src, ref.data(), n);
+        EXPECT_EQ(out, ref) << n;
+        kernels::pcm24ToFloat(src, out.data(), n);
+        kernels::scalar::pcm24ToFloat(src, ref.data(), n);
+        EXPECT_EQ(out, ref) << n;
+        kernels::pcm32ToFloat(src, out.data(), n);
+        kernels::scalar::pcm32ToFloat(src, ref.data(), n);
+        EXPECT_EQ(out, ref) << n;
+    }
+}
+
+TEST(AudioKernels, PcmToFloatScaling) {
+    const uint8_t pcm16[] = {0x00, 0x80, 0xFF, 0x7F, 0x00, 0x40};
+    const uint8_t pcm24[] = {0x00, 0x00, 0x80, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x40};
+    const uint8_t pcm32[] = {0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0xC0};
+    float out[3];
+    kernels::pcm16ToFloat(pcm16, out, 3);
+    EXPECT_FLOAT_EQ(out[0], -1.0f);
+    EXPECT_FLOAT_EQ(out[1], 32767.0f / 32768.0f);
+    EXPECT_FLOAT_EQ(out[2], 0.5f);
+    kernels::pcm24ToFloat(pcm24, out, 3);
+    EXPECT_FLOAT_EQ(out[0], -1.0f);
+    EXPECT_FLOAT_EQ(out[1], -1.0f / 8388608.0f);
+    EXPECT_FLOAT_EQ(out[2], 0.5f);
+    kernels::pcm32ToFloat(pcm32, out, 2);
+    EXPECT_FLOAT_EQ(out[0], -1.0f);
+    EXPECT_FLOAT_EQ(out[1], -0.5f);
+}
+
+TEST(AudioKernels, FloatToPcmMatchesScalar) {
+    for (size_t n : kLengths) {
+        const std::vector<float> src = ramp(n, 1.3f, 0.2f);  // some samples clip
+        std::vector<uint8_t> out(n * 3 + 1), ref(n * 3 + 1);
+
+        kernels::floatToPcm16(src.data(), out.data() + 1, n);
+        kernels::scalar::floatToPcm16(src.data(), ref.data() + 1, n);
+        EXPECT_EQ(out, ref) << n;
+        kernels::floatToPcm24(src.data(), out.data() + 1, n);
+        kernels::scalar::floatToPcm24(src.data(), ref.data() + 1, n);
+        EXPECT_EQ(out, ref) << n;
+    }
+}
+
+TEST(AudioKernels, FloatToPcmRoundTrip) {
+    const float src[4] = {-2.0f, -0.5f, 0.25f, 1.0f};
+    uint8_t pcm[12];
+    float back[4];
+    kernels::floatToPcm24(src, pcm, 4);
+    EXPECT_EQ(pcm[0], 0x01);  // -8388607
+    EXPECT_EQ(pcm[2], 0x80);
+    kernels::pcm24ToFloat(pcm, back, 4);
+    EXPECT_NEAR(back[0], -1.0f, 1e-6f);
+    EXPECT_NEAR(back[1], -0.5f, 1e-6f);
+    EXPECT_NEAR(back[3], 1.0f, 1e-6f);
+    kernels::floatToPcm16(src, pcm, 4);
+    kernels::pcm16ToFloat(pcm, back, 4);
+    EXPECT_NEAR(back[2], 0.25f, 1e-4f);
+    EXPECT_NEAR(back[3], 1.0f, 1e-4f);
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include "utils/BufferPipe.h"
+
+#include <thread>
+#include <vector>
+
+using guitarrackcraft::BufferPipe;
+
+TEST(BufferPipe, HandsBlocksAcrossThreadsInOrder) {
+    BufferPipe pipe(2, 4);
+    std::thread producer([&] {
+        for (int i = 0; i < 100; ++i) {
+            BufferPipe::Block* block = pipe.acquireFree();
+            ASSERT_NE(block, nullptr);
+            block->data[0] = static_cast<float>(i);
+            block->frames = 1;
+            block->last = i == 99;
+            pipe.submit(block);
+        }
+    });
+    std::vector<float> received;
+    while (BufferPipe::Block* block = pipe.acquireFilled()) {
+        received.push_back(block->data[0]);
+        const bool last = block->last;
+        pipe.release(block);
+        if (last) break;
+    }
+    producer.join();
+    ASSERT_EQ(received.size(), 100u);
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(received[i], static_cast<float>(i));
+}
+
+TEST(BufferPipe, CloseWakesBothSides) {
+    BufferPipe pipe(1, 1);
+    BufferPipe::Block* held = pipe.acquireFree();
+    ASSERT_NE(held, nullptr);
+    pipe.submit(held);
+
+    std::thread blockedProducer([&] { EXPECT_EQ(pipe.acquireFree(), nullptr); });
+    pipe.close();
+    blockedProducer.join();
+
+    // A block submitted before close() is still delivered, then the pipe reads as empty
+    EXPECT_EQ(pipe.acquireFilled(), held);
+    EXPECT_EQ(pipe.acquireFilled(), nullptr);
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include "utils/CpuFeatures.h"
+
+#include <string>
+#include <vector>
+
+using guitarrackcraft::CpuFeatures;
+using guitarrackcraft::stripVariantSuffix;
+
+namespace {
+// Linux arm64 HWCAP bits
+constexpr uint64_t kAtomics = 1ull << 8;
+constexpr uint64_t kFphp = 1ull << 9;
+constexpr uint64_t kAsimdhp = 1ull << 10;
+constexpr uint64_t kAsimdrdm = 1ull << 12;
+constexpr uint64_t kAsimddp = 1ull << 20;
+constexpr uint64_t kSve = 1ull << 22;
+constexpr uint64_t kSve2 = 1ull << 1;  // AT_HWCAP2
+constexpr uint64_t kArmv82 = kAtomics | kFphp | kAsimdhp | kAsimdrdm | kAsimddp;
+} // namespace
+
+TEST(CpuFeatures, BaselineCpuRunsOnlyTheBaseline) {
+    // Cortex-A53 class: FP/ASIMD/CRC only
+    const CpuFeatures f = CpuFeatures::fromHwcaps(0x3 | (1ull << 7), 0);
+    EXPECT_FALSE(f.armv82());
+    EXPECT_EQ(f.variantSuffixes(), std::vector<std::string>{""});
+    EXPECT_EQ(f.bestSuffix(), "");
+}
+
+TEST(CpuFeatures, Armv82NeedsDotprodFp16AndLse) {
+    EXPECT_TRUE(CpuFeatures::fromHwcaps(kArmv82, 0).armv82());
+    EXPECT_FALSE(CpuFeatures::fromHwcaps(kArmv82 & ~kAsimddp, 0).armv82());
+    EXPECT_FALSE(CpuFeatures::fromHwcaps(kArmv82 & ~kAsimdhp, 0).armv82());
+    EXPECT_FALSE(CpuFeatures::fromHwcaps(kArmv82 & ~kAtomics, 0).armv82());
+    EXPECT_EQ(CpuFeatures::fromHwcaps(kArmv82, 0).variantSuffixes(),
+              (std::vector<std::string>{"_armv82", ""}));
+}
+
+TEST(CpuFeatures, Armv9NeedsSve2OnTopOfArmv82) {
+    const CpuFeatures f = CpuFeatures::fromHwcaps(kArmv82 | kSve, kSve2);
+    EXPECT_TRUE(f.armv9());
+    EXPECT_EQ(f.variantSuffixes(), (std::vector<std::string>{"_armv9", "_armv82", ""}));
+    EXPECT_FALSE(CpuFeatures::fromHwcaps(kArmv82 | kSve, 0).armv9());
+    EXPECT_FALSE(CpuFeatures::fromHwcaps(kSve, kSve2).armv9());
+}
+
+TEST(CpuFeatures, StripVariantSuffix) {
+    EXPECT_EQ(stripVariantSuffix("neural_amp_modeler_armv82"), "neural_amp_modeler");
+    EXPECT_EQ(stripVariantSuffix("rt-neural-generic_armv9"), "rt-neural-generic");
+    EXPECT_EQ(stripVariantSuffix("gx_amp"), "gx_amp");
+    EXPECT_EQ(stripVariantSuffix("_armv9"), "_armv9");
+}
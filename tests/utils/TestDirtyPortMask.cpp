@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "utils/DirtyPortMask.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using guitarrackcraft::DirtyPortMask;
+
+namespace {
+std::vector<uint32_t> takeAll(DirtyPortMask& mask) {
+    std::vector<uint32_t> out;
+    mask.take([&](uint32_t i) { out.push_back(i); });
+    return out;
+}
+}
+
+TEST(DirtyPortMask, TakeReturnsMarkedIndicesOnceInOrder) {
+    DirtyPortMask mask(130);
+    EXPECT_FALSE(mask.any());
+    mask.mark(129);
+    mask.mark(3);
+    mask.mark(64);
+    mask.mark(3);
+    EXPECT_TRUE(mask.any());
+    EXPECT_EQ(takeAll(mask), (std::vector<uint32_t>{3, 64, 129}));
+    EXPECT_FALSE(mask.any());
+    EXPECT_TRUE(takeAll(mask).empty());
+}
+
+TEST(DirtyPortMask, OutOfRangeIsIgnored) {
+    DirtyPortMask mask(10);
+    mask.mark(10);
+    mask.mark(1000);
+    EXPECT_TRUE(takeAll(mask).empty());
+    DirtyPortMask empty;
+    empty.mark(0);
+    EXPECT_TRUE(takeAll(empty).empty());
+}
+
+TEST(DirtyPortMask, ResizeClears) {
+    DirtyPortMask mask(64);
+    mask.mark(5);
+    mask.resize(64);
+    EXPECT_TRUE(takeAll(mask).empty());
+    mask.resize(200);
+    mask.mark(199);
+    EXPECT_EQ(takeAll(mask), (std::vector<uint32_t>{199}));
+}
+
+TEST(DirtyPortMask, ConcurrentMarksAreNeverLost) {
+    DirtyPortMask mask(256);
+    std::atomic<bool> finished{false};
+    std::vector<int> seen(256, 0);
+    std::thread writer([&] {
+        for (int r = 0; r < 2000; ++r) {
+            for (uint32_t i = 0; i < 256; i += 5) mask.mark(i);
+        }
+        finished.store(true, std::memory_order_release);
+    });
+    while (!finished.load(std::memory_order_acquire)) {
+        mask.take([&](uint32_t i) { seen[i]++; });
+    }
+    writer.join();
+    mask.take([&](uint32_t i) { seen[i]++; });
+    for (uint32_t i = 0; i < 256; ++i) {
+        if (i % 5 == 0) {
+            EXPECT_GE(seen[i], 1) << i;
+        } else {
+            EXPECT_EQ(seen[i], 0) << i;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "utils/DriftCompensator.h"
+
+#include <vector>
+
+using guitarrackcraft::DriftCompensator;
+
+namespace {
+void finishDrain(DriftCompensator& drift) {
+    while (drift.draining()) drift.drained();
+}
+}
+
+TEST(DriftCompensator, DrainsFirstThenReadsExactly) {
+    DriftCompensator drift;
+    drift.configure(96);
+    EXPECT_TRUE(drift.draining());
+    finishDrain(drift);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(drift.framesToRead(96, 96 + 96), 96u);
+    }
+    EXPECT_EQ(drift.slippedFrames(), 0u);
+}
+
+TEST(DriftCompensator, SlipsTowardCushion) {
+    DriftCompensator drift;
+    drift.configure(96);
+    finishDrain(drift);
+    // Input runs ahead: backlog two cushions above target -> consume extra frames.
+    uint32_t extra = 0;
+    for (int i = 0; i < 200; ++i) {
+        extra += drift.framesToRead(96, 96 + 3 * 96) - 96;
+    }
+    EXPECT_GT(extra, 0u);
+    EXPECT_EQ(drift.slippedFrames(), extra);
+
+    // Input falls behind: nothing left over -> consume fewer frames.
+    DriftCompensator slow;
+    slow.configure(96);
+    finishDrain(slow);
+    EXPECT_EQ(slow.framesToRead(96, 96), 95u);
+}
+
+TEST(DriftCompensator, DiscardsLargeBacklog) {
+    DriftCompensator drift;
+    drift.configure(64);
+    finishDrain(drift);
+    EXPECT_EQ(drift.framesToDiscard(64, 64 + 64), 0u);
+    EXPECT_EQ(drift.framesToDiscard(64, 64 + 1000), 1000u - 64u);
+    EXPECT_EQ(drift.discardedFrames(), 1000u - 64u);
+    drift.recordShortRead(5);
+    EXPECT_EQ(drift.zeroFilledFrames(), 5u);
+}
+
+TEST(DriftCompensator, ResampleKeepsEndpoints) {
+    std::vector<float> src(97);
+    for (size_t i = 0; i < src.size(); ++i) src[i] = static_cast<float>(i);
+    std::vector<float> dst(96);
+    DriftCompensator::resample(src.data(), 97, dst.data(), 96);
+    EXPECT_FLOAT_EQ(dst.front(), 0.0f);
+    EXPECT_FLOAT_EQ(dst.back(), 96.0f);
+    for (size_t i = 1; i < dst.size(); ++i) EXPECT_GT(dst[i], dst[i - 1]);
+
+    DriftCompensator::resample(src.data(), 96, dst.data(), 96);
+    EXPECT_FLOAT_EQ(dst[50], 50.0f);
+}
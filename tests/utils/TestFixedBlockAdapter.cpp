@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include "utils/FixedBlockAdapter.h"
+
+#include <vector>
+
+using guitarrackcraft::FixedBlockAdapter;
+
+namespace {
+// Records block sizes and passes the signal through (right channel negated).
+struct Recorder {
+    std::vector<uint32_t> blocks;
+
+    static void process(void* context, const float* const* in, float* const* out, uint32_t frames) {
+        auto* self = static_cast<Recorder*>(context);
+        self->blocks.push_back(frames);
+        for (uint32_t i = 0; i < frames; ++i) {
+            out[0][i] = in[0][i];
+            out[1][i] = -in[1][i];
+        }
+    }
+};
+
+// Push a ramp through in callbacks of the given sizes; the output must be the
+// same ramp delayed by exactly latencyFrames().
+void runRamp(FixedBlockAdapter& adapter, Recorder& recorder, const std::vector<uint32_t>& sizes) {
+    float next = 1.0f;
+    std::vector<float> produced;
+    for (uint32_t n : sizes) {
+        std::vector<float> inL(n), inR(n), outL(n), outR(n);
+        for (uint32_t i = 0; i < n; ++i) inL[i] = inR[i] = next++;
+        const float* in[2] = {inL.data(), inR.data()};
+        float* out[2] = {outL.data(), outR.data()};
+        adapter.process(in, out, n, &Recorder::process, &recorder);
+        for (uint32_t i = 0; i < n; ++i) {
+            ASSERT_EQ(outR[i], -outL[i]);
+            produced.push_back(outL[i]);
+        }
+    }
+    const uint32_t latency = adapter.latencyFrames();
+    for (size_t i = 0; i < produced.size(); ++i) {
+        const float expected = i < latency ? 0.0f : static_cast<float>(i - latency + 1);
+        ASSERT_EQ(produced[i], expected) << "frame " << i << " latency " << latency;
+    }
+    for (uint32_t b : recorder.blocks) EXPECT_EQ(b, adapter.blockFrames());
+}
+}
+
+TEST(FixedBlockAdapter, ChoosesLeastLatencyBlock) {
+    EXPECT_EQ(FixedBlockAdapter::chooseBlockFrames(96), 32u);
+    EXPECT_EQ(FixedBlockAdapter::chooseBlockFrames(192), 64u);
+    EXPECT_EQ(FixedBlockAdapter::chooseBlockFrames(256), 256u);
+    EXPECT_EQ(FixedBlockAdapter::chooseBlockFrames(240), 32u);
+    EXPECT_EQ(FixedBlockAdapter::primingFrames(32, 96), 0u);
+    EXPECT_EQ(FixedBlockAdapter::primingFrames(32, 240), 16u);
+    EXPECT_EQ(FixedBlockAdapter::primingFrames(128, 96), 96u);
+}
+
+TEST(FixedBlockAdapter, AlignedCallbacksAddNoLatency) {
+    FixedBlockAdapter adapter;
+    adapter.configure(32, 96, 1024);
+    Recorder recorder;
+    runRamp(adapter, recorder, {96, 96, 96, 96});
+    EXPECT_EQ(adapter.latencyFrames(), 0u);
+    EXPECT_EQ(recorder.blocks.size(), 12u);
+}
+
+TEST(FixedBlockAdapter, UnalignedCallbacksDelayByPrimingOnly) {
+    FixedBlockAdapter adapter;
+    adapter.configure(64, 240, 1024);
+    Recorder recorder;
+    runRamp(adapter, recorder, std::vector<uint32_t>(20, 240));
+    EXPECT_EQ(adapter.latencyFrames(), FixedBlockAdapter::primingFrames(64, 240));
+}
+
+TEST(FixedBlockAdapter, IrregularCallbacksStayContinuous) {
+    FixedBlockAdapter adapter;
+    adapter.configure(128, 96, 256);
+    Recorder recorder;
+    runRamp(adapter, recorder, {96, 17, 200, 1, 96, 500, 128, 3, 96, 96});
+    EXPECT_LT(adapter.latencyFrames(), 2 * 128u);
+}
@@ -0,0 +1,285 @@
+#include <gtest/gtest.h>
+#include "utils/FlacStreamWriter.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using guitarrackcraft::FlacStreamWriter;
+
+namespace {
+
+std::string tempPath() {
+    char tmpl[] = "/tmp/flac_writer_XXXXXX";
+    const int fd = mkstemp(tmpl);
+    ::close(fd);
+    return tmpl;
+}
+
+std::vector<uint8_t> readFile(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()};
+}
+
+class BitReader {
+public:
+    BitReader(const std::vector<uint8_t>& d, size_t pos) : d_(d), bit_(pos * 8) {}
+    uint32_t get(int n) {
+        uint32_t v = 0;
+        for (int i = 0; i < n; ++i, ++bit_) v = (v << 1) | ((d_.at(bit_ >> 3) >> (7 - (bit_ & 7))) & 1);
+        return v;
+    }
+    int32_t getSigned(int n) {
+        const uint32_t v = get(n);
+        return n < 32 && (v >> (n - 1)) ? static_cast<int32_t>(v | (~0u << n)) : static_cast<int32_t>(v);
+    }
+    uint32_t unary() {
+        uint32_t z = 0;
+        while (get(1) == 0) ++z;
+        return z;
+    }
+    void align() { bit_ = (bit_ + 7) & ~size_t{7}; }
+    size_t bytePos() const { return bit_ >> 3; }
+
+private:
+    const std::vector<uint8_t>& d_;
+    size_t bit_;
+};
+
+uint8_t crc8(const uint8_t* p, size_t n) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < n; ++i) {
+        crc ^= p[i];
+        for (int b = 0; b < 8; ++b) crc = static_cast<uint8_t>((crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1);
+    }
+    return crc;
+}
+
+uint16_t crc16(const uint8_t* p, size_t n) {
+    uint16_t crc = 0;
+    for (size_t i = 0; i < n; ++i) {
+        crc ^= static_cast<uint16_t>(p[i] << 8);
+        for (int b = 0; b < 8; ++b) crc = static_cast<uint16_t>((crc & 0x8000) ? (crc << 1) ^ 0x8005 : crc << 1);
+    }
+    return crc;
+}
+
+void decodeSubframe(BitReader& br, int bps, uint32_t n, std::vector<int32_t>& out) {
+    ASSERT_EQ(br.get(1), 0u);
+    const uint32_t type = br.get(6);
+    ASSERT_EQ(br.get(1), 0u);  // no wasted bits
+    out.assign(n, 0);
+    if (type == 0) {
+        const int32_t v = br.getSigned(bps);
+        for (auto& s : out) s = v;
+        return;
+    }
+    if (type == 1) {
+        for (auto& s : out) s = br.getSigned(bps);
+        return;
+    }
+    ASSERT_EQ(type & 0x38, 0x08u) << "only FIXED expected";
+    const uint32_t order = type & 7;
+    for (uint32_t i = 0; i < order; ++i) out[i] = br.getSigned(bps);
+    const uint32_t method = br.get(2);
+    const int paramBits = method ? 5 : 4;
+    const uint32_t po = br.get(4);
+    const uint32_t size = n >> po;
+    std::vector<int32_t> res(n, 0);
+    for (uint32_t p = 0; p < (1u << po); ++p) {
+        const uint32_t k = br.get(paramBits);
+        ASSERT_NE(k, (1u << paramBits) - 1) << "escape not expected";
+        for (uint32_t i = (p == 0 ? order : p * size); i < (p + 1) * size; ++i) {
+            const uint32_t u = (br.unary() << k) | (k ? br.get(static_cast<int>(k)) : 0);
+            res[i] = static_cast<int32_t>(u >> 1) ^ -static_cast<int32_t>(u & 1);
+        }
+    }
+    for (uint32_t i = order; i < n; ++i) {
+        const int32_t* x = out.data();
+        int32_t pred = 0;
+        switch (order) {
+            case 1: pred = x[i - 1]; break;
+            case 2: pred = 2 * x[i - 1] - x[i - 2]; break;
+            case 3: pred = 3 * x[i - 1] - 3 * x[i - 2] + x[i - 3]; break;
+            case 4: pred = 4 * x[i - 1] - 6 * x[i - 2] + 4 * x[i - 3] - x[i - 4]; break;
+            default: break;
+        }
+        out[i] = pred + res[i];
+    }
+}
+
+struct Decoded {
+    uint32_t sampleRate = 0, channels = 0, bps = 0;
+    uint64_t totalFrames = 0;
+    std::vector<std::vector<int32_t>> samples;
+};
+
+/** Decoder for the subset FlacStreamWriter emits; checks every frame CRC. */
+void decode(const std::vector<uint8_t>& d, Decoded& out) {
+    ASSERT_GE(d.size(), 42u);
+    ASSERT_EQ(std::string(d.begin(), d.begin() + 4), "fLaC");
+    BitReader info(d, 8);
+    info.get(16);
+    info.get(16);
+    info.get(24);
+    info.get(24);
+    out.sampleRate = info.get(20);
+    out.channels = info.get(3) + 1;
+    out.bps = info.get(5) + 1;
+    out.totalFrames = (static_cast<uint64_t>(info.get(4)) << 32) | info.get(32);
+    out.samples.assign(out.channels, {});
+
+    size_t pos = 42;
+    while (pos < d.size()) {
+        const size_t start = pos;
+        BitReader br(d, pos);
+        ASSERT_EQ(br.get(16), 0xFFF8u);
+        const uint32_t blockCode = br.get(4);
+        const uint32_t rateCode = br.get(4);
+        const uint32_t assignment = br.get(4);
+        br.get(3);
+        br.get(1);
+        uint32_t lead = br.get(8);
+        for (uint32_t mask = 0x80; lead & mask && mask != 0x40; mask >>= 1) {
+            ASSERT_GE(br.get(8) & 0xC0, 0x80u);  // continuation bytes
+            lead &= ~mask;
+        }
+        uint32_t n = blockCode == 12 ? 4096 : 0;
+        if (blockCode == 6) n = br.get(8) + 1;
+        if (blockCode == 7) n = br.get(16) + 1;
+        ASSERT_GT(n, 0u);
+        if (rateCode == 12) br.get(8);
+        if (rateCode == 13 || rateCode == 14) br.get(16);
+        const size_t headerEnd = br.bytePos();
+        ASSERT_EQ(br.get(8), crc8(d.data() + start, headerEnd - start));
+
+        std::vector<std::vector<int32_t>> ch(out.channels);
+        for (uint32_t c = 0; c < out.channels; ++c) {
+            const bool side = (assignment == 8 && c == 1) || (assignment == 9 && c == 0) ||
+                              (assignment == 10 && c == 1);
+            decodeSubframe(br, static_cast<int>(out.bps) + (side ? 1 : 0), n, ch[c]);
+            if (::testing::Test::HasFatalFailure()) return;
+        }
+        for (uint32_t i = 0; i < n && out.channels == 2; ++i) {
+            if (assignment == 8) ch[1][i] = ch[0][i] - ch[1][i];
+            if (assignment == 9) ch[0][i] += ch[1][i];
+            if (assignment == 10) {
+                const int32_t mid = (ch[0][i] * 2) | (ch[1][i] & 1);
+                const int32_t side = ch[1][i];
+                ch[0][i] = (mid + side) >> 1;
+                ch[1][i] = (mid - side) >> 1;
+            }
+        }
+        br.align();
+        const uint16_t crc = static_cast<uint16_t>(br.get(16));
+        pos = br.bytePos();
+        ASSERT_EQ(crc16(d.data() + start, pos - start - 2), crc);
+        for (uint32_t c = 0; c < out.channels; ++c) {
+            out.samples[c].insert(out.samples[c].end(), ch[c].begin(), ch[c].end());
+        }
+    }
+}
+
+int32_t quantize(float v, float scale) { return static_cast<int32_t>(std::max(-1.0f, std::min(1.0f, v)) * scale); }
+
+} // namespace
+
+TEST(FlacStreamWriter, StereoRoundTripIsLossless) {
+    for (uint16_t bps : {16, 24}) {
+        const std::string path = tempPath();
+        const float scale = bps == 16 ? 32767.0f : 8388607.0f;
+        // Correlated channels plus a stretch of silence and a clipped burst
+        const size_t frames = FlacStreamWriter::kBlockFrames * 3 + 1234;
+        std::vector<float> in(frames * 2);
+        for (size_t i = 0; i < frames; ++i) {
+            const float t = static_cast<float>(i) / 48000.0f;
+            float v = 0.6f * std::sin(2.0f * 3.14159265f * 220.0f * t) + 0.05f * std::sin(t * 9000.0f);
+            if (i > 5000 && i < 9200) v = 0.0f;
+            if (i > 12000 && i < 12100) v *= 3.0f;
+            in[2 * i] = v;
+            in[2 * i + 1] = 0.8f * v + 0.01f * std::cos(t * 3000.0f);
+        }
+        FlacStreamWriter writer;
+        ASSERT_TRUE(writer.open(path, 48000, 2, bps));
+        for (size_t i = 0; i < in.size();) {
+            const size_t n = std::min<size_t>(1001, in.size() - i);  // splits frames across calls
+            ASSERT_TRUE(writer.writeSamples(in.data() + i, n));
+            i += n;
+        }
+        EXPECT_EQ(writer.framesWritten(), frames);
+        ASSERT_TRUE(writer.close());
+
+        const auto bytes = readFile(path);
+        Decoded dec;
+        decode(bytes, dec);
+        ASSERT_FALSE(HasFatalFailure());
+        EXPECT_EQ(dec.sampleRate, 48000u);
+        EXPECT_EQ(dec.channels, 2u);
+        EXPECT_EQ(dec.bps, bps);
+        EXPECT_EQ(dec.totalFrames, frames);
+        ASSERT_EQ(dec.samples[0].size(), frames);
+        for (size_t i = 0; i < frames; ++i) {
+            ASSERT_EQ(dec.samples[0][i], quantize(in[2 * i], scale)) << i;
+            ASSERT_EQ(dec.samples[1][i], quantize(in[2 * i + 1], scale)) << i;
+        }
+        // A tonal signal compresses well below PCM size
+        EXPECT_LT(bytes.size(), frames * 2 * (bps / 8) / 2);
+        std::remove(path.c_str());
+    }
+}
+
+TEST(FlacStreamWriter, MonoNoiseFallsBackToVerbatim) {
+    const std::string path = tempPath();
+    FlacStreamWriter writer;
+    ASSERT_TRUE(writer.open(path, 44100, 1, 16));
+    std::vector<float> noise(5000);
+    uint32_t seed = 1;
+    for (auto& s : noise) {
+        seed = seed * 1664525u + 1013904223u;
+        s = static_cast<float>(static_cast<int32_t>(seed)) / 2147483648.0f;
+    }
+    ASSERT_TRUE(writer.writeSamples(noise.data(), noise.size()));
+    ASSERT_TRUE(writer.close());
+
+    Decoded dec;
+    decode(readFile(path), dec);
+    ASSERT_FALSE(HasFatalFailure());
+    EXPECT_EQ(dec.sampleRate, 44100u);
+    ASSERT_EQ(dec.samples[0].size(), noise.size());
+    for (size_t i = 0; i < noise.size(); ++i) ASSERT_EQ(dec.samples[0][i], quantize(noise[i], 32767.0f)) << i;
+    std::remove(path.c_str());
+}
+
+TEST(FlacStreamWriter, CheckpointLeavesCompleteFrames) {
+    const std::string path = tempPath();
+    FlacStreamWriter writer;
+    ASSERT_TRUE(writer.open(path, 48000, 1, 16));
+    std::vector<float> block(FlacStreamWriter::kBlockFrames + 100, 0.25f);
+    ASSERT_TRUE(writer.writeSamples(block.data(), block.size()));
+    ASSERT_TRUE(writer.checkpoint());
+
+    // As after a crash: the complete block is on disk and described by STREAMINFO
+    Decoded dec;
+    decode(readFile(path), dec);
+    ASSERT_FALSE(HasFatalFailure());
+    EXPECT_EQ(dec.totalFrames, FlacStreamWriter::kBlockFrames);
+    EXPECT_EQ(dec.samples[0].size(), FlacStreamWriter::kBlockFrames);
+
+    ASSERT_TRUE(writer.close());
+    decode(readFile(path), dec);
+    EXPECT_EQ(dec.totalFrames, block.size());
+    std::remove(path.c_str());
+}
+
+TEST(FlacStreamWriter, RejectsUnsupportedFormats) {
+    FlacStreamWriter writer;
+    const std::string path = tempPath();
+    EXPECT_FALSE(writer.open(path, 48000, 2, 32));
+    EXPECT_FALSE(writer.open(path, 48000, 0, 16));
+    EXPECT_FALSE(writer.isOpen());
+    std::remove(path.c_str());
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "utils/FloatEnv.h"
+
+#include <cfloat>
+#include <thread>
+
+using namespace guitarrackcraft;
+
+namespace {
+// volatile keeps the compiler from folding the multiply at build time
+float scaleDenormal() {
+    volatile float x = FLT_MIN;
+    volatile float scale = 0.5f;
+    return x * scale;
+}
+
+template <typename Fn>
+void onFreshThread(Fn fn) {
+    std::thread(fn).join();
+}
+}
+
+TEST(FloatEnv, FlushToZeroIsPerThreadAndFlushesResults) {
+    if (float_env::kFlushBits == 0) GTEST_SKIP() << "no FTZ control on this architecture";
+    onFreshThread([] {
+        EXPECT_FALSE(flushToZeroEnabled());
+        EXPECT_GT(scaleDenormal(), 0.0f);
+        enableFlushToZero();
+        EXPECT_TRUE(flushToZeroEnabled());
+        EXPECT_EQ(scaleDenormal(), 0.0f);
+    });
+    EXPECT_FALSE(flushToZeroEnabled());
+}
+
+TEST(FloatEnv, ScopedModeRestoresOnExit) {
+    if (float_env::kFlushBits == 0) GTEST_SKIP() << "no FTZ control on this architecture";
+    onFreshThread([] {
+        enableFlushToZero();
+        {
+            const ScopedFloatMode strict(false);
+            EXPECT_FALSE(flushToZeroEnabled());
+            EXPECT_GT(scaleDenormal(), 0.0f);
+        }
+        EXPECT_TRUE(flushToZeroEnabled());
+        {
+            const ScopedFloatMode same(true);
+            EXPECT_TRUE(flushToZeroEnabled());
+        }
+        EXPECT_TRUE(flushToZeroEnabled());
+    });
+}
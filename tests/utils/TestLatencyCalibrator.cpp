@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "utils/LatencyCalibrator.h"
+
+#include <cmath>
+#include <deque>
+#include <random>
+#include <vector>
+
+using guitarrackcraft::LatencyCalibrator;
+
+TEST(LatencyCalibrator, MlsIsMaximalLength) {
+    for (int order : {8, 10, 12}) {
+        auto seq = LatencyCalibrator::mls(order);
+        ASSERT_EQ(seq.size(), (1u << order) - 1);
+        double sum = 0.0;
+        for (float v : seq) sum += v;
+        EXPECT_EQ(sum, 1.0) << "order " << order;
+        // Periodic autocorrelation of an m-sequence is -1 at every non-zero shift.
+        for (size_t shift : {size_t{1}, size_t{7}, seq.size() / 2}) {
+            double acc = 0.0;
+            for (size_t i = 0; i < seq.size(); ++i) acc += seq[i] * seq[(i + shift) % seq.size()];
+            EXPECT_EQ(acc, -1.0) << "order " << order << " shift " << shift;
+        }
+    }
+}
+
+TEST(LatencyCalibrator, MeasuresLoopbackDelayThroughProcess) {
+    const float sampleRate = 48000.0f;
+    const uint32_t delay = 1234;
+    const uint32_t block = 192;
+    LatencyCalibrator calibrator;
+    ASSERT_TRUE(calibrator.prepare(sampleRate));
+    calibrator.start();
+
+    // Loopback: the input is the output delayed, inverted, attenuated and noisy.
+    std::deque<float> line(delay, 0.0f);
+    std::mt19937 rng(7);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    std::vector<float> in(block), out(block, 0.0f);
+    int callbacks = 0;
+    while (calibrator.state() == LatencyCalibrator::State::Running && callbacks < 10000) {
+        calibrator.process(in.data(), out.data(), block);
+        for (uint32_t i = 0; i < block; ++i) {
+            line.push_back(out[i]);
+            in[i] = -0.3f * line.front() + noise(rng);
+            line.pop_front();
+        }
+        ++callbacks;
+    }
+    ASSERT_EQ(calibrator.state(), LatencyCalibrator::State::Captured);
+    float ratio = 0.0f;
+    // One block extra: input captured in a callback is what the previous one played into the line.
+    EXPECT_EQ(calibrator.analyze(&ratio), static_cast<int32_t>(delay + block));
+    EXPECT_GT(ratio, LatencyCalibrator::kMinPeakRatio);
+    EXPECT_EQ(calibrator.state(), LatencyCalibrator::State::Idle);
+}
+
+TEST(LatencyCalibrator, RejectsSilence) {
+    auto stimulus = LatencyCalibrator::mls(10);
+    std::vector<float> capture(stimulus.size() + 2000, 0.0f);
+    EXPECT_EQ(LatencyCalibrator::findLag(stimulus, capture, 2000, LatencyCalibrator::kMinPeakRatio), -1);
+}
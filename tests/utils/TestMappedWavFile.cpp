@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "utils/MappedWavFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using guitarrackcraft::MappedWavFile;
+
+namespace {
+
+void put16(std::vector<uint8_t>& b, uint16_t v) {
+    b.push_back(v & 0xFF);
+    b.push_back(v >> 8);
+}
+void put32(std::vector<uint8_t>& b, uint32_t v) {
+    for (int i = 0; i < 4; ++i) b.push_back((v >> (8 * i)) & 0xFF);
+}
+void putId(std::vector<uint8_t>& b, const char* id) { b.insert(b.end(), id, id + 4); }
+
+struct WavSpec {
+    uint16_t tag = 1;
+    uint16_t channels = 1;
+    uint32_t rate = 48000;
+    uint16_t bits = 16;
+    bool extensible = false;
+    bool junkBeforeFmt = false;
+    uint32_t declaredDataSize = UINT32_MAX;  // UINT32_MAX: the real size
+};
+
+// Build a WAV in a temp file; payload is the raw data chunk body.
+class TempWav {
+public:
+    TempWav(const WavSpec& spec, const std::vector<uint8_t>& payload) {
+        std::vector<uint8_t> b;
+        putId(b, "RIFF");
+        put32(b, 0);  // patched below
+        putId(b, "WAVE");
+        if (spec.junkBeforeFmt) {
+            putId(b, "JUNK");
+            put32(b, 3);
+            b.insert(b.end(), {1, 2, 3, 0});  // odd body, one pad byte
+        }
+        putId(b, "fmt ");
+        put32(b, spec.extensible ? 40 : 16);
+        put16(b, spec.extensible ? 0xFFFE : spec.tag);
+        put16(b, spec.channels);
+        put32(b, spec.rate);
+        const uint16_t align = static_cast<uint16_t>(spec.channels * spec.bits / 8);
+        put32(b, spec.rate * align);
+        put16(b, align);
+        put16(b, spec.bits);
+        if (spec.extensible) {
+            put16(b, 22);
+            put16(b, spec.bits);
+            put32(b, 0);
+            put16(b, spec.tag);  // sub-format GUID: tag then 14 fixed bytes
+            b.insert(b.end(), 14, 0);
+        }
+        putId(b, "data");
+        put32(b, spec.declaredDataSize == UINT32_MAX ? static_cast<uint32_t>(payload.size())
+                                                     : spec.declaredDataSize);
+        b.insert(b.end(), payload.begin(), payload.end());
+        const uint32_t riffSize = static_cast<uint32_t>(b.size() - 8);
+        std::memcpy(b.data() + 4, &riffSize, 4);
+
+        char tmpl[] = "/tmp/mapped_wav_XXXXXX";
+        const int fd = mkstemp(tmpl);
+        EXPECT_EQ(write(fd, b.data(), b.size()), static_cast<ssize_t>(b.size()));
+        ::close(fd);
+        path_ = tmpl;
+    }
+    ~TempWav() { std::remove(path_.c_str()); }
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+};
+
+} // namespace
+
+TEST(MappedWavFile, IndexesChunksAndConvertsPcm16) {
+    WavSpec spec;
+    spec.channels = 2;
+    spec.junkBeforeFmt = true;
+    std::vector<uint8_t> payload;
+    for (int16_t v : {int16_t(-32768), int16_t(16384), int16_t(0), int16_t(-16384)}) {
+        put16(payload, static_cast<uint16_t>(v));
+    }
+    TempWav file(spec, payload);
+
+    MappedWavFile wav;
+    ASSERT_TRUE(wav.open(file.path())) << wav.error();
+    ASSERT_EQ(wav.chunks().size(), 3u);
+    EXPECT_EQ(std::memcmp(wav.chunks()[0].id, "JUNK", 4), 0);
+    EXPECT_EQ(wav.chunks()[0].size, 3u);
+    ASSERT_NE(wav.findChunk("data"), nullptr);
+    EXPECT_EQ(wav.findChunk("LIST"), nullptr);
+
+    EXPECT_EQ(wav.format(), MappedWavFile::SampleFormat::Pcm16);
+    EXPECT_EQ(wav.channels(), 2u);
+    EXPECT_EQ(wav.sampleRate(), 48000u);
+    EXPECT_EQ(wav.frames(), 2u);
+    EXPECT_EQ(wav.frameData(1), wav.frameData(0) + 4);
+
+    float out[4];
+    EXPECT_EQ(wav.readFrames(0, 10, out), 2u);
+    EXPECT_FLOAT_EQ(out[0], -1.0f);
+    EXPECT_FLOAT_EQ(out[1], 0.5f);
+    EXPECT_FLOAT_EQ(out[2], 0.0f);
+    EXPECT_FLOAT_EQ(out[3], -0.5f);
+    EXPECT_EQ(wav.readFrames(1, 1, out), 1u);
+    EXPECT_FLOAT_EQ(out[1], -0.5f);
+    EXPECT_EQ(wav.readFrames(2, 1, out), 0u);
+}
+
+TEST(MappedWavFile, ExtensibleAndFloatFormats) {
+    {
+        WavSpec spec;
+        spec.bits = 24;
+        spec.extensible = true;
+        TempWav file(spec, {0x00, 0x00, 0xC0, 0xFF, 0xFF, 0x7F});
+        MappedWavFile wav;
+        ASSERT_TRUE(wav.open(file.path())) << wav.error();
+        EXPECT_EQ(wav.format(), MappedWavFile::SampleFormat::Pcm24);
+        float out[2];
+        ASSERT_EQ(wav.readFrames(0, 2, out), 2u);
+        EXPECT_FLOAT_EQ(out[0], -0.5f);
+        EXPECT_FLOAT_EQ(out[1], 8388607.0f / 8388608.0f);
+    }
+    {
+        WavSpec spec;
+        spec.tag = 3;
+        spec.bits = 32;
+        std::vector<uint8_t> payload(8);
+        const float values[2] = {0.25f, -1.5f};
+        std::memcpy(payload.data(), values, sizeof(values));
+        TempWav file(spec, payload);
+        MappedWavFile wav;
+        ASSERT_TRUE(wav.open(file.path())) << wav.error();
+        EXPECT_EQ(wav.format(), MappedWavFile::SampleFormat::Float32);
+        float out[2];
+        ASSERT_EQ(wav.readFrames(0, 2, out), 2u);
+        EXPECT_EQ(out[0], 0.25f);
+        EXPECT_EQ(out[1], -1.5f);
+    }
+}
+
+TEST(MappedWavFile, StreamedDataSizeUsesFileLength) {
+    WavSpec spec;
+    spec.declaredDataSize = 0;
+    TempWav file(spec, std::vector<uint8_t>(200));
+    MappedWavFile wav;
+    ASSERT_TRUE(wav.open(file.path())) << wav.error();
+    EXPECT_EQ(wav.frames(), 100u);
+}
+
+TEST(MappedWavFile, RejectsUnsupportedInput) {
+    WavSpec spec;
+    spec.bits = 8;
+    TempWav eightBit(spec, {1, 2, 3});
+    MappedWavFile wav;
+    EXPECT_FALSE(wav.open(eightBit.path()));
+    EXPECT_FALSE(wav.isOpen());
+    EXPECT_FALSE(wav.error().empty());
+    EXPECT_FALSE(wav.open("/nonexistent/file.wav"));
+}
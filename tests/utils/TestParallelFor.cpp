@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include "utils/ParallelFor.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using guitarrackcraft::parallelFor;
+
+TEST(ParallelForTest, VisitsEveryIndexOnce) {
+    std::vector<std::atomic<int>> hits(1000);
+    parallelFor(hits.size(), [&](size_t i) { hits[i].fetch_add(1); }, 4);
+    for (const auto& h : hits) EXPECT_EQ(h.load(), 1);
+}
+
+TEST(ParallelForTest, UsesSeveralThreadsAndCaller) {
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    parallelFor(64, [&](size_t) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::lock_guard<std::mutex> lock(mutex);
+        ids.insert(std::this_thread::get_id());
+    }, 4);
+    EXPECT_GT(ids.size(), 1u);
+    EXPECT_LE(ids.size(), 4u);
+}
+
+TEST(ParallelForTest, EmptyAndSingleThread) {
+    int calls = 0;
+    parallelFor(0, [&](size_t) { ++calls; });
+    EXPECT_EQ(calls, 0);
+    std::thread::id id;
+    parallelFor(5, [&](size_t) { ++calls; id = std::this_thread::get_id(); }, 1);
+    EXPECT_EQ(calls, 5);
+    EXPECT_EQ(id, std::this_thread::get_id());
+}
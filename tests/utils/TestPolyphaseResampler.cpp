@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "utils/PolyphaseResampler.h"
+
+#include <cmath>
+#include <vector>
+
+using guitarrackcraft::PolyphaseResampler;
+
+namespace {
+
+std::vector<float> sine(size_t n, double freq, double rate, double amplitude = 0.5) {
+    std::vector<float> v(n);
+    for (size_t i = 0; i < n; ++i) v[i] = static_cast<float>(amplitude * std::sin(2.0 * M_PI * freq * i / rate));
+    return v;
+}
+
+// Mono resample of the whole input in blocks of chunk frames, including the flushed tail.
+std::vector<float> resample(const std::vector<float>& in, uint32_t inRate, uint32_t outRate, size_t chunk) {
+    PolyphaseResampler r;
+    EXPECT_TRUE(r.configure(inRate, outRate, 1, chunk));
+    std::vector<float> out, block(r.maxOutputFrames(std::max<size_t>(chunk, r.taps())));
+    float* outPtr = block.data();
+    for (size_t offset = 0; offset < in.size(); offset += chunk) {
+        const float* inPtr = in.data() + offset;
+        const size_t n = r.process(&inPtr, std::min(chunk, in.size() - offset), &outPtr);
+        out.insert(out.end(), block.begin(), block.begin() + n);
+    }
+    const size_t n = r.flush(&outPtr);
+    out.insert(out.end(), block.begin(), block.begin() + n);
+    EXPECT_EQ(out.size(), r.outputFramesFor(in.size()));
+    return out;
+}
+
+double maxErrorVsSine(const std::vector<float>& out, double freq, double rate, size_t margin) {
+    double err = 0.0;
+    for (size_t i = margin; i + margin < out.size(); ++i) {
+        err = std::max(err, std::fabs(out[i] - 0.5 * std::sin(2.0 * M_PI * freq * i / rate)));
+    }
+    return err;
+}
+
+} // namespace
+
+TEST(PolyphaseResampler, EqualRatesPassThrough) {
+    PolyphaseResampler r;
+    ASSERT_TRUE(r.configure(48000, 48000, 2, 16));
+    EXPECT_TRUE(r.isPassthrough());
+    const float l[3] = {1, 2, 3}, rr[3] = {4, 5, 6};
+    float ol[3], orr[3];
+    const float* in[2] = {l, rr};
+    float* out[2] = {ol, orr};
+    EXPECT_EQ(r.process(in, 3, out), 3u);
+    EXPECT_EQ(ol[2], 3.0f);
+    EXPECT_EQ(orr[0], 4.0f);
+    EXPECT_EQ(r.flush(out), 0u);
+    EXPECT_FALSE(r.configure(0, 48000, 1, 16));
+}
+
+TEST(PolyphaseResampler, OutputLengthMatchesRatio) {
+    const std::vector<float> in(44100, 0.25f);
+    EXPECT_EQ(resample(in, 44100, 48000, 997).size(), 48000u);
+    EXPECT_EQ(resample(in, 48000, 44100, 512).size(), 40517u);  // ceil(44100 * 147 / 160)
+    EXPECT_EQ(resample(in, 96000, 48000, 4096).size(), 22050u);
+}
+
+TEST(PolyphaseResampler, PreservesToneAndTiming) {
+    // 1 kHz at 44.1 kHz must come out as the same 1 kHz at 48 kHz with no delay
+    const std::vector<float> up = resample(sine(22050, 1000.0, 44100.0), 44100, 48000, 300);
+    EXPECT_LT(maxErrorVsSine(up, 1000.0, 48000.0, 64), 1e-3);
+    const std::vector<float> down = resample(sine(48000, 1000.0, 96000.0), 96000, 48000, 4096);
+    EXPECT_LT(maxErrorVsSine(down, 1000.0, 48000.0, 64), 1e-3);
+    // Ratio too fine for exact phases: exercises the interpolated table
+    const std::vector<float> odd = resample(sine(22050, 1000.0, 44100.0), 44100, 47999, 256);
+    EXPECT_LT(maxErrorVsSine(odd, 1000.0, 47999.0, 64), 2e-3);
+}
+
+TEST(PolyphaseResampler, RejectsAboveOutputNyquist) {
+    // 30 kHz at 96 kHz cannot be represented at 48 kHz; it must not fold to 18 kHz
+    const std::vector<float> out = resample(sine(96000, 30000.0, 96000.0), 96000, 48000, 1024);
+    double sumSq = 0.0;
+    for (size_t i = 256; i + 256 < out.size(); ++i) sumSq += out[i] * out[i];
+    const double rms = std::sqrt(sumSq / (out.size() - 512));
+    EXPECT_LT(20.0 * std::log10(rms / (0.5 / std::sqrt(2.0))), -60.0);
+}
+
+TEST(PolyphaseResampler, BlockSizeDoesNotChangeOutput) {
+    const std::vector<float> in = sine(10000, 440.0, 44100.0);
+    const std::vector<float> a = resample(in, 44100, 48000, 10000);
+    const std::vector<float> b = resample(in, 44100, 48000, 37);
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) ASSERT_EQ(a[i], b[i]) << i;
+}
+
+TEST(PolyphaseResampler, DotProduct) {
+    std::vector<float> a(36), b(36);
+    double ref = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = 0.1f * i;
+        b[i] = 1.0f - 0.05f * i;
+        ref += static_cast<double>(a[i]) * b[i];
+    }
+    EXPECT_NEAR(PolyphaseResampler::dot(a.data(), b.data(), a.size()), ref, 1e-4);
+}
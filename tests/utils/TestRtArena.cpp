@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include "utils/RtArena.h"
+
+#include <cstdint>
+
+using guitarrackcraft::RtArena;
+
+TEST(RtArena, RegionsAreAlignedAndDisjoint) {
+    RtArena arena;
+    const size_t a = arena.reserve(3 * sizeof(float));
+    const size_t b = arena.reserve(100);
+    const size_t c = arena.reserve(RtArena::kAlignment);
+    EXPECT_EQ(a, 0u);
+    EXPECT_EQ(b, RtArena::kAlignment);
+    EXPECT_EQ(c, 3 * RtArena::kAlignment);
+    EXPECT_EQ(arena.reserved(), 4 * RtArena::kAlignment);
+
+    ASSERT_TRUE(arena.allocate());
+    EXPECT_EQ(arena.size(), arena.reserved());
+    for (size_t offset : {a, b, c}) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(arena.at<uint8_t>(offset)) % RtArena::kAlignment, 0u);
+    }
+    const uint8_t* bytes = arena.at<uint8_t>(0);
+    for (size_t i = 0; i < arena.size(); ++i) ASSERT_EQ(bytes[i], 0) << i;
+}
+
+TEST(RtArena, ReallocateZeroesAndResetForgetsLayout) {
+    RtArena arena;
+    arena.reserve(sizeof(float));
+    ASSERT_TRUE(arena.allocate());
+    *arena.at<float>(0) = 1.0f;
+    ASSERT_TRUE(arena.allocate());
+    EXPECT_EQ(*arena.at<float>(0), 0.0f);
+
+    arena.reset();
+    EXPECT_EQ(arena.reserved(), 0u);
+    EXPECT_EQ(arena.size(), 0u);
+    EXPECT_TRUE(arena.allocate());  // empty layout
+    EXPECT_EQ(arena.reserve(8), 0u);
+}
+
+TEST(RtArena, LockLastsUntilTheBlockIsReplaced) {
+    RtArena arena;
+    EXPECT_TRUE(arena.lock());  // nothing allocated: nothing to pin
+    EXPECT_FALSE(arena.locked());
+    arena.reserve(4096);
+    ASSERT_TRUE(arena.allocate());
+    if (!arena.lock()) GTEST_SKIP() << "mlock refused (RLIMIT_MEMLOCK)";
+    EXPECT_TRUE(arena.locked());
+    ASSERT_TRUE(arena.allocate());
+    EXPECT_FALSE(arena.locked());
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include "utils/RtGuard.h"
+
+#include <thread>
+
+namespace rt_guard = guitarrackcraft::rt_guard;
+
+namespace {
+
+const rt_guard::Offender* find(const std::vector<rt_guard::Offender>& offenders, const char* owner) {
+    for (const auto& offender : offenders) {
+        if (offender.owner == owner) return &offender;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST(RtGuard, TalliesArmedThreadCallsPerOwner) {
+    const char* amp = rt_guard::intern("Amp");
+    EXPECT_EQ(rt_guard::intern("Amp"), amp);
+
+    rt_guard::armThread();
+    {
+        const rt_guard::Scope scope(amp);
+        rt_guard::note(rt_guard::kMalloc);
+        rt_guard::note(rt_guard::kMutexLock);
+    }
+    rt_guard::note(rt_guard::kFree);
+    rt_guard::disarm();
+    rt_guard::note(rt_guard::kMalloc);  // disarmed: not counted
+
+    const auto offenders = rt_guard::takeOffenders();
+    const auto* ampEntry = find(offenders, amp);
+    ASSERT_NE(ampEntry, nullptr);
+    EXPECT_EQ(ampEntry->kinds, rt_guard::kMalloc | rt_guard::kMutexLock);
+    EXPECT_EQ(ampEntry->count, 2u);
+    const auto* hostEntry = find(offenders, rt_guard::kHostOwner);
+    ASSERT_NE(hostEntry, nullptr);
+    EXPECT_EQ(hostEntry->kinds, rt_guard::kFree);
+
+    // Reported once, until new calls arrive
+    EXPECT_TRUE(rt_guard::takeOffenders().empty());
+}
+
+TEST(RtGuard, OtherThreadsAreNotTallied) {
+    rt_guard::armThread();
+    std::thread other([] { rt_guard::note(rt_guard::kMalloc); });
+    other.join();
+    rt_guard::disarm();
+    EXPECT_TRUE(rt_guard::takeOffenders().empty());
+}
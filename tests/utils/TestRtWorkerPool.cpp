@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include "utils/RtWorkerPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using guitarrackcraft::RtWorkerPool;
+
+namespace {
+
+constexpr uint32_t kMaxJobs = 16;
+
+struct Counts {
+    std::atomic<uint32_t> hits[kMaxJobs] = {};
+};
+
+void countJob(void* context, uint32_t index) {
+    static_cast<Counts*>(context)->hits[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+TEST(RtWorkerPool, BackToBackRunsExecuteEveryIndexExactlyOnce) {
+    RtWorkerPool pool(3);
+    // Enough runs for workers from one generation to still be claiming when the next starts.
+    // Counts alternate small and large: a worker holding the previous generation's exhausted
+    // word must never claim against the next, larger count.
+    for (uint32_t runIndex = 0; runIndex < 40000; ++runIndex) {
+        const uint32_t count = runIndex % 2 == 0 ? 2 + runIndex % 3 : kMaxJobs - runIndex % 5;
+        Counts counts;
+        pool.run(&countJob, &counts, count);
+        // run() returned, so every job has finished and none of this run's are still to come
+        for (uint32_t i = 0; i < kMaxJobs; ++i) {
+            ASSERT_EQ(counts.hits[i].load(), i < count ? 1u : 0u)
+                << "run " << runIndex << " index " << i << " of " << count;
+        }
+    }
+}
+
+TEST(RtWorkerPool, WorkersWakeFromParkedAfterIdle) {
+    RtWorkerPool pool(2);
+    for (int round = 0; round < 5; ++round) {
+        // Long enough for the workers to stop spinning and park on the futex
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        Counts counts;
+        pool.run(&countJob, &counts, 8);
+        for (uint32_t i = 0; i < 8; ++i) ASSERT_EQ(counts.hits[i].load(), 1u) << "round " << round;
+    }
+}
+
+TEST(RtWorkerPool, RunsInlineWithoutWorkers) {
+    RtWorkerPool pool(0);
+    Counts counts;
+    pool.run(&countJob, &counts, 5);
+    for (uint32_t i = 0; i < 5; ++i) EXPECT_EQ(counts.hits[i].load(), 1u);
+    pool.run(&countJob, &counts, 0);
+    EXPECT_EQ(counts.hits[0].load(), 1u);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "utils/SerialWorkerPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using guitarrackcraft::SerialWorkerPool;
+
+namespace {
+
+// Pending work is a counter; every run consumes all of it, like an LV2 request ring.
+class CountingClient : public SerialWorkerPool::Client {
+public:
+    std::atomic<int> pending{0};
+    std::atomic<int> done{0};
+    std::atomic<int> inside{0};
+    std::atomic<int> maxInside{0};
+    std::chrono::microseconds workTime{0};
+
+protected:
+    void runPendingWork() override {
+        const int now = inside.fetch_add(1) + 1;
+        int seen = maxInside.load();
+        while (now > seen && !maxInside.compare_exchange_weak(seen, now)) {}
+        while (pending.load() > 0) {
+            if (workTime.count() > 0) std::this_thread::sleep_for(workTime);
+            pending.fetch_sub(1);
+            done.fetch_add(1);
+        }
+        inside.fetch_sub(1);
+    }
+};
+
+void waitFor(const std::atomic<int>& value, int target) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (value.load() < target && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+} // namespace
+
+TEST(SerialWorkerPool, RunsScheduledWork) {
+    SerialWorkerPool pool(2);
+    CountingClient client;
+    client.pending = 3;
+    pool.schedule(&client);
+    waitFor(client.done, 3);
+    pool.waitIdle(&client);
+    EXPECT_EQ(client.done.load(), 3);
+}
+
+TEST(SerialWorkerPool, ClientNeverRunsConcurrentlyAndMissesNothing) {
+    SerialWorkerPool pool(4);
+    CountingClient client;
+    client.workTime = std::chrono::microseconds(20);
+    constexpr int kRequests = 500;
+    for (int i = 0; i < kRequests; ++i) {
+        client.pending.fetch_add(1);
+        pool.schedule(&client);
+        if (i % 50 == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    waitFor(client.done, kRequests);
+    pool.waitIdle(&client);
+    EXPECT_EQ(client.done.load(), kRequests);
+    EXPECT_EQ(client.maxInside.load(), 1);
+}
+
+TEST(SerialWorkerPool, DifferentClientsRunInParallel) {
+    SerialWorkerPool pool(4);
+    std::vector<CountingClient> clients(4);
+    for (auto& c : clients) {
+        c.workTime = std::chrono::milliseconds(50);
+        c.pending = 1;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    for (auto& c : clients) pool.schedule(&c);
+    for (auto& c : clients) {
+        waitFor(c.done, 1);
+        pool.waitIdle(&c);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    for (auto& c : clients) EXPECT_EQ(c.done.load(), 1);
+    // Serial execution would take 200 ms; allow slack for loaded single-core machines
+    if (std::thread::hardware_concurrency() >= 4) {
+        EXPECT_LT(elapsed, std::chrono::milliseconds(180));
+    }
+}
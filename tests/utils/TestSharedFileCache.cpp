@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "utils/SharedFileCache.h"
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+using guitarrackcraft::SharedFileCache;
+
+namespace {
+
+std::string writeFile(const char* name, const std::string& contents) {
+    std::string path = std::string("/tmp/grc_filecache_") + std::to_string(getpid()) + "_" + name;
+    FILE* f = fopen(path.c_str(), "wb");
+    fwrite(contents.data(), 1, contents.size(), f);
+    fclose(f);
+    return path;
+}
+
+} // namespace
+
+TEST(SharedFileCache, SamePathSharesOneMapping) {
+    SharedFileCache cache;
+    const std::string path = writeFile("a.nam", "capture weights");
+    auto a = cache.acquire(path);
+    auto b = cache.acquire(path);
+    ASSERT_TRUE(a);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(a->data()), a->size()), "capture weights");
+    EXPECT_EQ(cache.mappedCount(), 1u);
+    EXPECT_EQ(cache.mappedBytes(), a->size());
+    unlink(path.c_str());
+}
+
+TEST(SharedFileCache, IdenticalContentIsDeduplicated) {
+    SharedFileCache cache;
+    const std::string p1 = writeFile("ir1.wav", "RIFF same impulse");
+    const std::string p2 = writeFile("ir2.wav", "RIFF same impulse");
+    const std::string p3 = writeFile("ir3.wav", "RIFF other impulse");
+    auto a = cache.acquire(p1);
+    auto b = cache.acquire(p2);
+    auto c = cache.acquire(p3);
+    ASSERT_TRUE(a && b && c);
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(cache.mappedCount(), 2u);
+    unlink(p1.c_str());
+    unlink(p2.c_str());
+    unlink(p3.c_str());
+}
+
+TEST(SharedFileCache, ReleasedMappingIsDroppedAndChangedFileRemapped) {
+    SharedFileCache cache;
+    const std::string path = writeFile("m.json", "v1");
+    auto first = cache.acquire(path);
+    ASSERT_TRUE(first);
+    // Replaced, not rewritten in place
+    const std::string next = writeFile("m.json.tmp", "version 2");
+    ASSERT_EQ(rename(next.c_str(), path.c_str()), 0);
+    auto second = cache.acquire(path);
+    ASSERT_TRUE(second);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(first->data()), first->size()), "v1");
+    EXPECT_EQ(second->size(), 9u);
+
+    first.reset();
+    second.reset();
+    EXPECT_EQ(cache.mappedCount(), 0u);
+    unlink(path.c_str());
+}
+
+TEST(SharedFileCache, MissingOrEmptyFileFails) {
+    SharedFileCache cache;
+    EXPECT_FALSE(cache.acquire("/nonexistent/grc_model.nam"));
+    const std::string path = writeFile("empty", "");
+    EXPECT_FALSE(cache.acquire(path));
+    unlink(path.c_str());
+}
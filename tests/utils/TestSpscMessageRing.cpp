@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "utils/SpscMessageRing.h"
+
+#include <thread>
+#include <vector>
+
+using guitarrackcraft::SpscMessageRing;
+
+TEST(SpscMessageRing, WriteReadRoundTrip) {
+    SpscMessageRing ring(256);
+    const char hello[] = "hello";
+    EXPECT_TRUE(ring.empty());
+    EXPECT_TRUE(ring.write(hello, sizeof(hello)));
+    uint32_t size = 0;
+    ASSERT_TRUE(ring.peek(size));
+    EXPECT_EQ(size, sizeof(hello));
+    char out[16] = {};
+    ASSERT_TRUE(ring.read(out, sizeof(out), size));
+    EXPECT_STREQ(out, "hello");
+    EXPECT_TRUE(ring.empty());
+    EXPECT_FALSE(ring.read(out, sizeof(out), size));
+}
+
+TEST(SpscMessageRing, TwoPartMessageIsContiguous) {
+    SpscMessageRing ring(64);
+    const uint32_t port = 7;
+    const char body[] = "abc";
+    ASSERT_TRUE(ring.write(&port, sizeof(port), body, sizeof(body)));
+    uint8_t out[16] = {};
+    uint32_t size = 0;
+    ASSERT_TRUE(ring.read(out, sizeof(out), size));
+    ASSERT_EQ(size, sizeof(port) + sizeof(body));
+    uint32_t readPort = 0;
+    std::memcpy(&readPort, out, sizeof(readPort));
+    EXPECT_EQ(readPort, 7u);
+    EXPECT_STREQ(reinterpret_cast<const char*>(out + sizeof(port)), "abc");
+}
+
+TEST(SpscMessageRing, RefusesWhenFullAndWraps) {
+    SpscMessageRing ring(64);
+    uint8_t msg[20];
+    int written = 0;
+    while (ring.write(msg, sizeof(msg))) ++written;
+    EXPECT_EQ(written, 2);  // 2 * (4 + 20) fit in 64, a third does not
+
+    // Keep cycling so messages straddle the end of the buffer
+    uint8_t out[20];
+    uint32_t size = 0;
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(ring.read(out, sizeof(out), size));
+        for (uint8_t k = 0; k < sizeof(msg); ++k) msg[k] = static_cast<uint8_t>(i + k);
+        ASSERT_TRUE(ring.write(msg, sizeof(msg)));
+    }
+    ASSERT_TRUE(ring.read(out, sizeof(out), size));
+    ASSERT_TRUE(ring.read(out, sizeof(out), size));
+    EXPECT_EQ(out[0], 99);
+    EXPECT_EQ(out[19], 99 + 19);
+}
+
+TEST(SpscMessageRing, OversizedMessageIsSkipped) {
+    SpscMessageRing ring(128);
+    uint8_t big[32] = {};
+    uint8_t small[4] = {1, 2, 3, 4};
+    ASSERT_TRUE(ring.write(big, sizeof(big)));
+    ASSERT_TRUE(ring.write(small, sizeof(small)));
+    uint8_t out[8];
+    uint32_t size = 0;
+    EXPECT_FALSE(ring.read(out, sizeof(out), size));
+    EXPECT_EQ(size, sizeof(big));
+    ASSERT_TRUE(ring.read(out, sizeof(out), size));
+    EXPECT_EQ(out[3], 4);
+    EXPECT_FALSE(ring.write(big, 200));  // can never fit
+}
+
+TEST(SpscMessageRing, ConcurrentProducerConsumerKeepsOrder) {
+    SpscMessageRing ring(1024);
+    constexpr uint32_t kCount = 50000;
+    std::thread producer([&ring] {
+        for (uint32_t i = 0; i < kCount;) {
+            const uint32_t len = 1 + i % 13;
+            uint8_t payload[16];
+            for (uint32_t k = 0; k < len; ++k) payload[k] = static_cast<uint8_t>(i + k);
+            if (ring.write(&i, sizeof(i), payload, len)) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint32_t expected = 0;
+    uint8_t out[32];
+    uint32_t size = 0;
+    while (expected < kCount) {
+        if (!ring.read(out, sizeof(out), size)) {
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t seq = 0;
+        std::memcpy(&seq, out, sizeof(seq));
+        ASSERT_EQ(seq, expected);
+        ASSERT_EQ(size, sizeof(seq) + 1 + seq % 13);
+        ASSERT_EQ(out[size - 1], static_cast<uint8_t>(seq + size - sizeof(seq) - 1));
+        ++expected;
+    }
+    producer.join();
+}
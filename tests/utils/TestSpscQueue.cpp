@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include "utils/SpscQueue.h"
+
+#include <thread>
+
+using guitarrackcraft::SpscQueue;
+
+namespace {
+struct Event {
+    uint32_t slot;
+    uint32_t frame;
+    float value;
+};
+}
+
+TEST(SpscQueue, PushPopInOrder) {
+    SpscQueue<Event> queue(8);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_TRUE(queue.push({1, 10, 0.5f}));
+    EXPECT_TRUE(queue.push({2, 20, 0.25f}));
+    Event e{};
+    ASSERT_TRUE(queue.pop(e));
+    EXPECT_EQ(e.slot, 1u);
+    EXPECT_EQ(e.frame, 10u);
+    EXPECT_FLOAT_EQ(e.value, 0.5f);
+    ASSERT_TRUE(queue.pop(e));
+    EXPECT_EQ(e.slot, 2u);
+    EXPECT_FALSE(queue.pop(e));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueue, RefusesWhenFullAndWraps) {
+    SpscQueue<int> queue(3);  // rounded up to 4
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(queue.push(i));
+    EXPECT_FALSE(queue.push(99));
+    int v = -1;
+    for (int round = 0; round < 10; ++round) {
+        ASSERT_TRUE(queue.pop(v));
+        EXPECT_EQ(v, round);
+        EXPECT_TRUE(queue.push(round + 4));
+    }
+    queue.clear();
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.pop(v));
+}
+
+TEST(SpscQueue, ConcurrentProducerConsumerKeepsOrder) {
+    SpscQueue<uint32_t> queue(64);
+    constexpr uint32_t kCount = 50000;
+    std::thread producer([&queue] {
+        for (uint32_t i = 0; i < kCount;) {
+            if (queue.push(i)) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint32_t expected = 0;
+    uint32_t v = 0;
+    while (expected < kCount) {
+        if (!queue.pop(v)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(v, expected);
+        ++expected;
+    }
+    producer.join();
+}
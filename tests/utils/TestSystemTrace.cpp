@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+#include "utils/SystemTrace.h"
+
+using guitarrackcraft::SystemTrace;
+using guitarrackcraft::TraceSection;
+
+namespace {
+int evaluations = 0;
+int64_t countedValue() {
+    ++evaluations;
+    return 42;
+}
+} // namespace
+
+TEST(SystemTrace, StaysOffWithoutATrace) {
+    // Host builds have no libandroid.so: enabling fails and every marker is a no-op
+    EXPECT_FALSE(SystemTrace::setEnabled(true));
+    EXPECT_FALSE(SystemTrace::enabled());
+    EXPECT_TRUE(SystemTrace::setEnabled(false));
+    {
+        SYSTEM_TRACE_SCOPE("outer");
+        const TraceSection inner("inner");
+        SystemTrace::beginAsync("async", 1);
+        SystemTrace::endAsync("async", 1);
+    }
+    SystemTrace::endSection();
+}
+
+TEST(SystemTrace, CounterValueIsNotEvaluatedWhileOff) {
+    evaluations = 0;
+    SYSTEM_TRACE_COUNTER("counter", countedValue());
+    EXPECT_EQ(evaluations, 0);
+}
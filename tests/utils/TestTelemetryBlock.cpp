@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "utils/TelemetryBlock.h"
+
+#include <atomic>
+#include <thread>
+
+using guitarrackcraft::TelemetryBlock;
+
+TEST(TelemetryBlock, PublishesVersionAndFields) {
+    TelemetryBlock block;
+    TelemetryBlock::Layout out{};
+    ASSERT_TRUE(block.read(out));
+    EXPECT_EQ(out.version, TelemetryBlock::kVersion);
+    EXPECT_EQ(out.sequence % 2, 0u);
+
+    auto& t = block.beginWrite();
+    t.callbacks = 42;
+    t.inputLevel = 0.5f;
+    t.flags = TelemetryBlock::kOutputClipping;
+    t.numPlugins = 1;
+    t.outputControlCounts[0] = 2;
+    t.outputControls[0] = 1.0f;
+    t.outputControls[1] = -3.0f;
+    block.endWrite();
+
+    ASSERT_TRUE(block.read(out));
+    EXPECT_EQ(out.callbacks, 42u);
+    EXPECT_FLOAT_EQ(out.inputLevel, 0.5f);
+    EXPECT_EQ(out.flags, static_cast<uint32_t>(TelemetryBlock::kOutputClipping));
+    EXPECT_EQ(out.outputControlCounts[0], 2u);
+    EXPECT_FLOAT_EQ(out.outputControls[1], -3.0f);
+    EXPECT_EQ(out.sequence, 2u);
+}
+
+TEST(TelemetryBlock, ReaderNeverSeesTornBlock) {
+    TelemetryBlock block;
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        for (uint32_t n = 1; !stop.load(std::memory_order_relaxed); ++n) {
+            auto& t = block.beginWrite();
+            t.callbacks = n;
+            t.xruns = static_cast<int32_t>(n);
+            for (uint32_t i = 0; i < TelemetryBlock::kMaxOutputControls; ++i) {
+                t.outputControls[i] = static_cast<float>(n & 0xffff);
+            }
+            block.endWrite();
+            if ((n & 63) == 0) std::this_thread::yield();
+        }
+    });
+    TelemetryBlock::Layout out{};
+    int consistent = 0;
+    for (int i = 0; i < 2000; ++i) {
+        if (!block.read(out)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(out.xruns, static_cast<int32_t>(out.callbacks));
+        const float expected = static_cast<float>(out.callbacks & 0xffff);
+        ASSERT_EQ(out.outputControls[0], expected);
+        ASSERT_EQ(out.outputControls[TelemetryBlock::kMaxOutputControls - 1], expected);
+        ++consistent;
+        if ((i & 15) == 0) std::this_thread::yield();
+    }
+    stop = true;
+    writer.join();
+    EXPECT_GT(consistent, 0);
+}
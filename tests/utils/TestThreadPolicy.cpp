@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include "utils/ThreadPolicy.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using guitarrackcraft::CpuTopology;
+
+namespace {
+class FakeSysfs {
+public:
+    FakeSysfs() {
+        char tmpl[] = "/tmp/cpu_topology_XXXXXX";
+        root_ = mkdtemp(tmpl);
+    }
+    ~FakeSysfs() { std::system(("rm -rf " + root_).c_str()); }
+
+    void write(int cpu, const std::string& relPath, long value) {
+        std::string dir = root_ + "/cpu" + std::to_string(cpu);
+        mkdir(dir.c_str(), 0755);
+        const size_t slash = relPath.rfind('/');
+        if (slash != std::string::npos) mkdir((dir + "/" + relPath.substr(0, slash)).c_str(), 0755);
+        FILE* f = std::fopen((dir + "/" + relPath).c_str(), "w");
+        ASSERT_NE(f, nullptr);
+        std::fprintf(f, "%ld\n", value);
+        std::fclose(f);
+    }
+
+    const std::string& root() const { return root_; }
+
+private:
+    std::string root_;
+};
+}
+
+TEST(CpuTopology, SplitsClustersByCapacity) {
+    FakeSysfs sysfs;
+    // 4 little, 3 mid, 1 prime
+    for (int cpu = 0; cpu < 4; ++cpu) sysfs.write(cpu, "cpu_capacity", 160);
+    for (int cpu = 4; cpu < 7; ++cpu) sysfs.write(cpu, "cpu_capacity", 740);
+    sysfs.write(7, "cpu_capacity", 1024);
+
+    CpuTopology topology = CpuTopology::fromSysfs(sysfs.root());
+    EXPECT_TRUE(topology.heterogeneous());
+    EXPECT_EQ(topology.performanceCpus(), (std::vector<int>{4, 5, 6, 7}));
+    EXPECT_EQ(topology.efficiencyCpus(), (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_TRUE(topology.isPerformanceCpu(7));
+    EXPECT_FALSE(topology.isPerformanceCpu(0));
+    EXPECT_FALSE(topology.isPerformanceCpu(-1));
+}
+
+TEST(CpuTopology, FallsBackToMaxFrequency) {
+    FakeSysfs sysfs;
+    sysfs.write(0, "cpufreq/cpuinfo_max_freq", 1800000);
+    sysfs.write(1, "cpufreq/cpuinfo_max_freq", 1800000);
+    sysfs.write(2, "cpufreq/cpuinfo_max_freq", 2800000);
+    CpuTopology topology = CpuTopology::fromSysfs(sysfs.root());
+    // 1.8 GHz is above half of 2.8 GHz: everything is a performance core, nothing to pin apart
+    EXPECT_FALSE(topology.heterogeneous());
+    EXPECT_EQ(topology.performanceCpus().size(), 3u);
+}
+
+TEST(CpuTopology, HomogeneousOrMissingLeavesPlacementAlone) {
+    FakeSysfs sysfs;
+    EXPECT_FALSE(CpuTopology::fromSysfs(sysfs.root()).heterogeneous());
+    for (int cpu = 0; cpu < 4; ++cpu) sysfs.write(cpu, "cpu_capacity", 1024);
+    EXPECT_FALSE(CpuTopology::fromSysfs(sysfs.root()).heterogeneous());
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "utils/UridTable.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using guitarrackcraft::UridTable;
+
+TEST(UridTableTest, MapsStableIdsAndUnmapsThem) {
+    UridTable table;
+    const uint32_t a = table.map("http://lv2plug.in/ns/ext/atom#Float");
+    const uint32_t b = table.map("http://lv2plug.in/ns/ext/atom#Int");
+    EXPECT_NE(a, 0u);
+    EXPECT_NE(b, 0u);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(table.map("http://lv2plug.in/ns/ext/atom#Float"), a);
+    EXPECT_STREQ(table.unmap(a), "http://lv2plug.in/ns/ext/atom#Float");
+    EXPECT_STREQ(table.unmap(b), "http://lv2plug.in/ns/ext/atom#Int");
+    EXPECT_EQ(table.size(), 2u);
+}
+
+TEST(UridTableTest, InvalidIdsUnmapToNull) {
+    UridTable table;
+    EXPECT_EQ(table.map(nullptr), 0u);
+    EXPECT_EQ(table.unmap(0), nullptr);
+    EXPECT_EQ(table.unmap(1), nullptr);
+    EXPECT_EQ(table.unmap(UridTable::kMaxIds + 5), nullptr);
+}
+
+TEST(UridTableTest, UnmappedPointersStayValidAsTheTableGrows) {
+    UridTable table;
+    const uint32_t first = table.map("urn:first");
+    const char* p = table.unmap(first);
+    for (int i = 0; i < 5000; ++i) {
+        table.map(("urn:grow:" + std::to_string(i)).c_str());
+    }
+    EXPECT_EQ(table.unmap(first), p);
+    EXPECT_STREQ(p, "urn:first");
+}
+
+TEST(UridTableTest, OverflowBeyondTheLockFreeRangeStillWorks) {
+    auto table = std::make_unique<UridTable>();
+    std::vector<uint32_t> ids;
+    for (uint32_t i = 0; i < UridTable::kMaxIds + 100; ++i) {
+        ids.push_back(table->map(("urn:n:" + std::to_string(i)).c_str()));
+    }
+    for (uint32_t i = 0; i < ids.size(); i += 97) {
+        EXPECT_EQ(ids[i], i + 1);
+        EXPECT_EQ(table->map(("urn:n:" + std::to_string(i)).c_str()), ids[i]);
+        EXPECT_EQ(std::string(table->unmap(ids[i])), "urn:n:" + std::to_string(i));
+    }
+}
+
+TEST(UridTableTest, ConcurrentMappingAgreesOnIds) {
+    UridTable table;
+    constexpr int kThreads = 4;
+    constexpr int kUris = 2000;
+    std::vector<std::vector<uint32_t>> seen(kThreads, std::vector<uint32_t>(kUris));
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            while (!go.load()) {}
+            // Each thread walks the URIs in a different order (strides coprime to kUris)
+            static const int kStrides[kThreads] = {1, 3, 7, 9};
+            for (int k = 0; k < kUris; ++k) {
+                const int i = (k * kStrides[t]) % kUris;
+                seen[t][i] = table.map(("urn:c:" + std::to_string(i)).c_str());
+                ASSERT_NE(table.unmap(seen[t][i]), nullptr);
+            }
+        });
+    }
+    go.store(true);
+    for (auto& th : threads) th.join();
+
+    EXPECT_EQ(table.size(), static_cast<uint32_t>(kUris));
+    for (int i = 0; i < kUris; ++i) {
+        for (int t = 1; t < kThreads; ++t) {
+            EXPECT_EQ(seen[t][i], seen[0][i]);
+        }
+        EXPECT_EQ(std::string(table.unmap(seen[0][i])), "urn:c:" + std::to_string(i));
+    }
+}
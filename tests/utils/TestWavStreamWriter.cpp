@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "utils/MappedWavFile.h"
+#include "utils/WavStreamWriter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using guitarrackcraft::MappedWavFile;
+using guitarrackcraft::WavStreamWriter;
+
+namespace {
+
+std::string tempPath() {
+    char tmpl[] = "/tmp/wav_writer_XXXXXX";
+    const int fd = mkstemp(tmpl);
+    ::close(fd);
+    return tmpl;
+}
+
+} // namespace
+
+TEST(WavStreamWriter, AppendsAndFinalizes) {
+    const std::string path = tempPath();
+    WavStreamWriter writer;
+    ASSERT_TRUE(writer.open(path, 44100, 2));
+    const float a[4] = {0.5f, -0.5f, 0.25f, 2.0f};  // 2.0 clamps
+    const float b[2] = {0.0f, -1.0f};
+    ASSERT_TRUE(writer.write(a, 2));
+    ASSERT_TRUE(writer.write(b, 1));
+    EXPECT_EQ(writer.framesWritten(), 3u);
+    ASSERT_TRUE(writer.close());
+    EXPECT_TRUE(writer.close());
+
+    MappedWavFile wav;
+    ASSERT_TRUE(wav.open(path)) << wav.error();
+    EXPECT_EQ(wav.sampleRate(), 44100u);
+    EXPECT_EQ(wav.channels(), 2u);
+    ASSERT_EQ(wav.frames(), 3u);
+    EXPECT_EQ(wav.findChunk("data")->size, 12u);
+    float out[6];
+    wav.readFrames(0, 3, out);
+    EXPECT_NEAR(out[0], 0.5f, 1e-4f);
+    EXPECT_NEAR(out[1], -0.5f, 1e-4f);
+    EXPECT_NEAR(out[3], 1.0f, 1e-4f);
+    EXPECT_NEAR(out[5], -1.0f, 1e-4f);
+    std::remove(path.c_str());
+}
+
+TEST(WavStreamWriter, CheckpointCoversWrittenFrames) {
+    const std::string path = tempPath();
+    WavStreamWriter writer;
+    ASSERT_TRUE(writer.open(path, 48000, 1));
+    std::vector<float> block(1000, 0.1f);
+    ASSERT_TRUE(writer.write(block.data(), block.size()));
+    ASSERT_TRUE(writer.checkpoint());
+    ASSERT_TRUE(writer.write(block.data(), 10));
+
+    // Read while still open, as after a crash: valid up to the checkpoint
+    {
+        MappedWavFile wav;
+        ASSERT_TRUE(wav.open(path)) << wav.error();
+        EXPECT_EQ(wav.findChunk("data")->size, 2000u);
+    }
+    writer.close();
+    MappedWavFile wav;
+    ASSERT_TRUE(wav.open(path)) << wav.error();
+    EXPECT_EQ(wav.frames(), 1010u);
+    std::remove(path.c_str());
+}
+
+TEST(WavStreamWriter, FailsOnUnwritablePath) {
+    WavStreamWriter writer;
+    EXPECT_FALSE(writer.open("/nonexistent/dir/out.wav", 48000, 2));
+    EXPECT_FALSE(writer.isOpen());
+    const float x = 0.0f;
+    EXPECT_FALSE(writer.write(&x, 1));
+}
+
+TEST(WavStreamWriter, WritesPcm24AndFloat) {
+    const float frames[4] = {0.5f, -0.25f, 1.5f, -1.5f};  // float keeps what 24-bit clamps
+    for (auto format : {WavStreamWriter::Format::Pcm24, WavStreamWriter::Format::Float32}) {
+        const std::string path = tempPath();
+        WavStreamWriter writer;
+        ASSERT_TRUE(writer.open(path, 48000, 2, format));
+        ASSERT_TRUE(writer.write(frames, 2));
+        ASSERT_TRUE(writer.close());
+
+        MappedWavFile wav;
+        ASSERT_TRUE(wav.open(path)) << wav.error();
+        const bool isFloat = format == WavStreamWriter::Format::Float32;
+        EXPECT_EQ(wav.format(), isFloat ? MappedWavFile::SampleFormat::Float32 : MappedWavFile::SampleFormat::Pcm24);
+        ASSERT_EQ(wav.frames(), 2u);
+        float out[4];
+        wav.readFrames(0, 2, out);
+        EXPECT_NEAR(out[0], 0.5f, 1e-6f);
+        EXPECT_NEAR(out[1], -0.25f, 1e-6f);
+        EXPECT_NEAR(out[2], isFloat ? 1.5f : 1.0f, 1e-6f);
+        EXPECT_NEAR(out[3], isFloat ? -1.5f : -1.0f, 1e-6f);
+        std::remove(path.c_str());
+    }
+}
+
+TEST(WavStreamWriter, BatchesSpanAndCarryPartialFrames) {
+    // Several batches' worth, fed in odd-sized pieces that split frames
+    const std::string path = tempPath();
+    WavStreamWriter writer;
+    ASSERT_TRUE(writer.open(path, 48000, 2, WavStreamWriter::Format::Pcm24));
+    const size_t totalSamples = WavStreamWriter::kBatchBytes;  // 3 batches at 3 bytes per sample
+    std::vector<float> samples(totalSamples);
+    for (size_t i = 0; i < totalSamples; ++i) samples[i] = static_cast<float>(i % 1000) / 1000.0f;
+    for (size_t i = 0; i < totalSamples;) {
+        const size_t n = std::min<size_t>(777, totalSamples - i);
+        ASSERT_TRUE(writer.writeSamples(samples.data() + i, n));
+        i += n;
+    }
+    EXPECT_EQ(writer.framesWritten(), totalSamples / 2);
+    ASSERT_TRUE(writer.close());
+
+    MappedWavFile wav;
+    ASSERT_TRUE(wav.open(path)) << wav.error();
+    ASSERT_EQ(wav.frames(), totalSamples / 2);
+    std::vector<float> out(totalSamples);
+    wav.readFrames(0, totalSamples / 2, out.data());
+    for (size_t i = 0; i < totalSamples; i += 997) EXPECT_NEAR(out[i], samples[i], 1e-6f) << i;
+    std::remove(path.c_str());
+}
@@ -0,0 +1,116 @@
+// PutImage/CopyArea costs for the sizes plugin UIs actually send: a full 1080p frame, a
+// plugin-sized window repaint and a knob-sized redraw, with and without the child/sibling
+// clip rects the server passes in. "pixel" is the per-pixel clip test the server used
+// before the span blitters; "span" is X11Framebuffer::putImage.
+// Configure with -DCMAKE_BUILD_TYPE=Release and build for arm64 to measure the NEON path.
+// Usage: framebuffer_bench [iterations]
+
+#include "X11Framebuffer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace guitarrackcraft;
+
+namespace {
+
+void perPixelPutImage(uint32_t* dst, int dW, int dH, int x, int y, int w, int h,
+                      const uint8_t* px, size_t len, const std::vector<ClipRect>& clips) {
+    for (int row = 0; row < h; row++) {
+        int dstY = y + row;
+        if (dstY < 0 || dstY >= dH) continue;
+        for (int col = 0; col < w; col++) {
+            int dstX = x + col;
+            if (dstX < 0 || dstX >= dW) continue;
+            bool clipped = false;
+            for (auto& cr : clips) {
+                if (dstX >= cr.x1 && dstX < cr.x2 && dstY >= cr.y1 && dstY < cr.y2) {
+                    clipped = true; break;
+                }
+            }
+            if (clipped) continue;
+            size_t idx = (size_t)(row * w + col) * 4;
+            if (idx + 3 >= len) continue;
+            uint32_t p;
+            std::memcpy(&p, px + idx, 4);
+            dst[(size_t)dstY * dW + dstX] = p | 0xFF000000u;
+        }
+    }
+}
+
+void perPixelCopyArea(const uint32_t* src, int sW, int sH, int sx0, int sy0,
+                      uint32_t* dst, int dW, int dH, int dx0, int dy0, int w, int h) {
+    for (int row = 0; row < h; row++) {
+        int sy = sy0 + row, dy = dy0 + row;
+        if (sy < 0 || sy >= sH || dy < 0 || dy >= dH) continue;
+        for (int col = 0; col < w; col++) {
+            int sx = sx0 + col, dx = dx0 + col;
+            if (sx < 0 || sx >= sW || dx < 0 || dx >= dW) continue;
+            dst[dy * dW + dx] = src[sy * sW + sx];
+        }
+    }
+}
+
+template <typename Fn>
+double usPerCall(Fn fn, int iterations) {
+    for (int i = 0; i < iterations / 10 + 1; ++i) fn();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+struct Case {
+    const char* name;
+    int x, y, w, h;
+    int scale;  // iterations divisor for large blits
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int W = 1920, H = 1080;
+    std::vector<uint32_t> fb((size_t)W * H, 0xFF302020);
+    std::vector<uint8_t> src((size_t)W * H * 4);
+    for (size_t i = 0; i < src.size(); i++) src[i] = (uint8_t)(i * 31);
+
+    // Two knob-sized child windows and an overlapping sibling dialog
+    const std::vector<ClipRect> noClip;
+    const std::vector<ClipRect> clips = {{300, 200, 364, 264}, {420, 200, 484, 264},
+                                         {800, 400, 1200, 700}};
+    const Case cases[] = {
+        {"1080p frame", 0, 0, W, H, 50},
+        {"plugin 800x480", 200, 150, 800, 480, 5},
+        {"knob 64x64", 310, 210, 64, 64, 1},
+    };
+
+    std::printf("%-16s %-6s %12s %12s %8s\n", "blit", "clip", "pixel us", "span us", "speedup");
+    for (const auto& c : cases) {
+        const int n = iterations / c.scale + 1;
+        const size_t len = (size_t)c.w * c.h * 4;
+        for (const auto* cl : {&noClip, &clips}) {
+            double pixel = usPerCall([&] {
+                perPixelPutImage(fb.data(), W, H, c.x, c.y, c.w, c.h, src.data(), len, *cl);
+            }, n);
+            double span = usPerCall([&] {
+                X11Framebuffer::putImage(fb.data(), W, H, c.x, c.y, c.w, c.h, src.data(), len,
+                                         false, *cl);
+            }, n);
+            std::printf("%-16s %-6s %12.2f %12.2f %7.2fx\n", c.name, cl->empty() ? "none" : "3",
+                        pixel, span, pixel / span);
+        }
+        double pixel = usPerCall([&] {
+            perPixelCopyArea(fb.data(), W, H, c.x, c.y, fb.data(), W, H, c.x / 2 + 8, c.y / 2 + 8, c.w / 2, c.h / 2);
+        }, n);
+        double span = usPerCall([&] {
+            X11Framebuffer::copyArea(fb.data(), W, H, c.x, c.y, fb.data(), W, H, c.x / 2 + 8, c.y / 2 + 8,
+                                     c.w / 2, c.h / 2);
+        }, n);
+        std::printf("%-16s %-6s %12.2f %12.2f %7.2fx\n", "  copyArea", "-", pixel, span, pixel / span);
+    }
+    return 0;
+}
@@ -0,0 +1,190 @@
+// Atom and property store costs for what a toolkit does when a plugin UI connects: intern
+// its atom set (most names twice, as Xlib/xcb helpers re-intern), resolve a few names back,
+// then set and read the usual WM/_NET properties on a handful of windows and destroy them.
+// "map" is the unordered_map layout the stores used before the flat tables; "flat" is
+// X11AtomStore/X11PropertyStore. Allocations are counted through global operator new.
+// Usage: stores_bench [iterations]
+
+#include "X11AtomStore.h"
+#include "X11PropertyStore.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace guitarrackcraft;
+
+namespace {
+
+std::atomic<uint64_t> g_allocs{0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+class MapAtomStore {
+public:
+    uint32_t intern(const std::string& name, bool onlyIfExists) {
+        auto it = nameToId_.find(name);
+        if (it != nameToId_.end()) return it->second;
+        if (onlyIfExists || name.empty()) return 0;
+        uint32_t id = nextId_++;
+        nameToId_[name] = id;
+        idToName_[id] = name;
+        return id;
+    }
+    std::string getName(uint32_t id) const {
+        auto it = idToName_.find(id);
+        return it != idToName_.end() ? it->second : std::string();
+    }
+    void clear() { nameToId_.clear(); idToName_.clear(); nextId_ = 1; }
+
+private:
+    std::unordered_map<std::string, uint32_t> nameToId_;
+    std::unordered_map<uint32_t, std::string> idToName_;
+    uint32_t nextId_ = 1;
+};
+
+class MapPropertyStore {
+public:
+    void change(uint32_t window, uint32_t property, uint32_t type, uint8_t format,
+                const uint8_t* data, uint32_t bytes) {
+        auto& prop = store_[window][property];
+        prop.type = type;
+        prop.format = format;
+        prop.data.assign(data, data + bytes);
+    }
+    X11PropertyStore::Property get(uint32_t window, uint32_t property) const {
+        auto w = store_.find(window);
+        if (w == store_.end()) return {};
+        auto p = w->second.find(property);
+        return p != w->second.end() ? p->second : X11PropertyStore::Property{};
+    }
+    void clearWindow(uint32_t window) { store_.erase(window); }
+    void clear() { store_.clear(); }
+
+private:
+    std::unordered_map<uint32_t, std::unordered_map<uint32_t, X11PropertyStore::Property>> store_;
+};
+
+// Roughly the set cairo/pugl/GTK-based LV2 UIs intern on connect
+std::vector<std::string> toolkitAtoms() {
+    std::vector<std::string> names = {
+        "WM_PROTOCOLS", "WM_DELETE_WINDOW", "WM_TAKE_FOCUS", "WM_STATE", "WM_CLIENT_LEADER",
+        "WM_WINDOW_ROLE", "WM_NAME", "WM_CLASS", "WM_HINTS", "WM_NORMAL_HINTS", "UTF8_STRING",
+        "CLIPBOARD", "TARGETS", "INCR", "XdndAware", "XdndEnter", "XdndPosition", "XdndStatus",
+        "XdndLeave", "XdndDrop", "XdndFinished", "XdndSelection", "XdndTypeList",
+        "XdndActionCopy", "_MOTIF_WM_HINTS", "_XEMBED", "_XEMBED_INFO", "_XSETTINGS_SETTINGS",
+        "RESOURCE_MANAGER", "_NET_SUPPORTED", "_NET_WM_PID", "_NET_WM_PING", "_NET_WM_SYNC_REQUEST",
+        "_NET_WM_SYNC_REQUEST_COUNTER",
+    };
+    const char* net[] = {"NAME", "ICON_NAME", "ICON", "STATE", "WINDOW_TYPE", "USER_TIME",
+                         "USER_TIME_WINDOW", "BYPASS_COMPOSITOR", "OPAQUE_REGION", "FRAME_DRAWN",
+                         "STATE_FULLSCREEN", "STATE_MAXIMIZED_VERT", "STATE_MAXIMIZED_HORZ",
+                         "STATE_HIDDEN", "STATE_FOCUSED", "STATE_ABOVE", "STATE_MODAL",
+                         "STATE_SKIP_TASKBAR", "WINDOW_TYPE_NORMAL", "WINDOW_TYPE_DIALOG",
+                         "WINDOW_TYPE_UTILITY", "WINDOW_TYPE_POPUP_MENU", "WINDOW_TYPE_TOOLTIP",
+                         "WINDOW_TYPE_DROPDOWN_MENU", "WINDOW_TYPE_COMBO", "ALLOWED_ACTIONS",
+                         "ACTION_MOVE", "ACTION_RESIZE", "ACTION_CLOSE", "DESKTOP", "STRUT",
+                         "STRUT_PARTIAL", "ICON_GEOMETRY", "FULLSCREEN_MONITORS", "MOVERESIZE"};
+    for (const char* n : net) names.push_back(std::string("_NET_WM_") + n);
+    for (int i = 0; i < 24; ++i) names.push_back("_GTK_PRIVATE_" + std::to_string(i));
+    return names;
+}
+
+template <typename Fn>
+double usPerCall(Fn fn, int iterations, double& allocsPerCall) {
+    for (int i = 0; i < iterations / 10 + 1; ++i) fn();
+    const uint64_t allocs0 = g_allocs.load(std::memory_order_relaxed);
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    const auto end = std::chrono::steady_clock::now();
+    allocsPerCall = double(g_allocs.load(std::memory_order_relaxed) - allocs0) / iterations;
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+constexpr int kWindows = 12;
+constexpr int kPropsPerWindow = 8;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 5000;
+    const std::vector<std::string> names = toolkitAtoms();
+
+    MapAtomStore mapAtoms;
+    X11AtomStore flatAtoms;
+    volatile size_t sink = 0;
+
+    double mapAllocs = 0, flatAllocs = 0;
+    double mapUs = usPerCall([&] {
+        mapAtoms.clear();
+        // The server used to copy each request's (pointer, length) name into a std::string
+        for (int pass = 0; pass < 2; ++pass)
+            for (const auto& n : names) sink = sink + mapAtoms.intern(std::string(n.data(), n.size()), false);
+        for (uint32_t id = 1; id < 40; ++id) sink = sink + mapAtoms.getName(id).size();
+    }, iterations, mapAllocs);
+    double flatUs = usPerCall([&] {
+        flatAtoms.clear();
+        for (int pass = 0; pass < 2; ++pass)
+            for (const auto& n : names) sink = sink + flatAtoms.intern(std::string_view(n.data(), n.size()), false);
+        for (uint32_t id = 1; id < 40; ++id) sink = sink + flatAtoms.getName(id).size();
+    }, iterations, flatAllocs);
+
+    std::printf("%-22s %10s %10s %12s %12s\n", "workload", "map us", "flat us", "map allocs", "flat allocs");
+    std::printf("%-22s %10.2f %10.2f %12.1f %12.1f\n", "connect: intern atoms", mapUs, flatUs,
+                mapAllocs, flatAllocs);
+
+    MapPropertyStore mapProps;
+    X11PropertyStore flatProps;
+    const uint8_t payload[64] = {1, 2, 3, 4};
+    uint32_t windowBase = 0x00200000;
+    auto windowCycle = [&](auto&& change, auto&& get, auto&& destroy) {
+        for (int w = 0; w < kWindows; ++w) {
+            const uint32_t win = windowBase + (uint32_t)w;
+            for (int p = 0; p < kPropsPerWindow; ++p) {
+                change(win, 300u + (uint32_t)p, (uint32_t)(p % 3 == 0 ? 31 : 6), (uint32_t)(8 + p * 4));
+            }
+            for (int p = 0; p < kPropsPerWindow; ++p) sink = sink + get(win, 300u + (uint32_t)p);
+        }
+        for (int w = 0; w < kWindows; ++w) destroy(windowBase + (uint32_t)w);
+        windowBase += 0x100;  // next cycle creates fresh ids, like popups being recreated
+    };
+
+    mapUs = usPerCall([&] {
+        windowCycle(
+            [&](uint32_t win, uint32_t prop, uint32_t type, uint32_t bytes) {
+                mapProps.change(win, prop, type, 8, payload, bytes);
+            },
+            [&](uint32_t win, uint32_t prop) { return mapProps.get(win, prop).data.size(); },
+            [&](uint32_t win) { mapProps.clearWindow(win); });
+    }, iterations, mapAllocs);
+    flatUs = usPerCall([&] {
+        windowCycle(
+            [&](uint32_t win, uint32_t prop, uint32_t type, uint32_t bytes) {
+                flatProps.change(win, prop, type, 8, X11PropertyStore::ModeReplace, payload, bytes);
+            },
+            [&](uint32_t win, uint32_t prop) {
+                uint32_t after = 0;
+                return flatProps.get(win, prop, 0, 0, 16, after).data.size();
+            },
+            [&](uint32_t win) { flatProps.clearWindow(win); });
+    }, iterations, flatAllocs);
+    std::printf("%-22s %10.2f %10.2f %12.1f %12.1f\n", "window props cycle", mapUs, flatUs,
+                mapAllocs, flatAllocs);
+    return sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,383 @@
+// Server throughput for the request streams plugin UIs actually send: the stream is written to
+// X11TestServer over a socketpair, pipelined like xcb does, and a GetGeometry round trip closes
+// every frame. Built-in streams follow what the UIs send per repaint (guitarix knob turns:
+// small cairo PutImages over filled backgrounds; NeuralRack slider drag: a back pixmap redrawn
+// and copied to the window; DPF/AIDA-X: indirect GLX Render batches and SwapBuffers). Captures
+// of real sessions can be replayed too: raw client-to-server bytes, LSB, with or without the
+// connection setup (e.g. Wireshark "Follow TCP Stream", saved as raw from the client side).
+// Reports requests/s and MB/s for the pipelined run, then per-frame round trips with PutImage
+// handling time percentiles and allocations per frame (global operator new, both threads).
+// Usage: wire_replay_bench [frames] [capture.bin ...]
+
+#include "TestHelpers.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <string>
+
+using namespace guitarrackcraft;
+using namespace guitarrackcraft::test;
+
+namespace {
+
+std::atomic<uint64_t> g_allocs{0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+const X11ByteOrder bo{false};
+
+constexpr uint32_t kWindow = 0x00200001;
+constexpr uint32_t kGC = 0x00200002;
+constexpr uint32_t kBackPixmap = 0x00200003;
+constexpr uint32_t kGLXContext = 0x00200004;
+
+struct Stream {
+    std::string name;
+    std::vector<uint8_t> setup;
+    std::vector<std::vector<uint8_t>> frames;  // replayed round-robin
+};
+
+void appendRequest(std::vector<uint8_t>& out, uint8_t opcode, uint8_t data1,
+                   const std::vector<uint8_t>& body) {
+    const size_t padded = (4 + body.size() + 3) & ~size_t(3);
+    const size_t at = out.size();
+    if (padded / 4 <= 0xFFFF) {
+        out.resize(at + padded, 0);
+        bo.write16(out.data() + at, 2, (uint16_t)(padded / 4));
+        std::memcpy(out.data() + at + 4, body.data(), body.size());
+    } else {
+        // BIG-REQUESTS: length 0, then the 32-bit length including the extra word
+        out.resize(at + padded + 4, 0);
+        bo.write32(out.data() + at, 4, (uint32_t)(padded / 4 + 1));
+        std::memcpy(out.data() + at + 8, body.data(), body.size());
+    }
+    out[at] = opcode;
+    out[at + 1] = data1;
+}
+
+std::vector<uint8_t> words(std::initializer_list<uint32_t> values) {
+    std::vector<uint8_t> body(values.size() * 4);
+    size_t off = 0;
+    for (uint32_t v : values) { bo.write32(body.data(), (int)off, v); off += 4; }
+    return body;
+}
+
+uint32_t pack16(int lo, int hi) { return (uint32_t)(uint16_t)lo | ((uint32_t)(uint16_t)hi << 16); }
+
+void createWindow(std::vector<uint8_t>& out, uint32_t wid, int w, int h) {
+    // wid, parent, x/y, w/h, border/class, visual, value-mask
+    appendRequest(out, X11Op::CreateWindow, 24,
+                  words({wid, kRootWindowId, pack16(0, 0), pack16(w, h), pack16(0, 1), 0, 0}));
+}
+
+void mapWindow(std::vector<uint8_t>& out, uint32_t wid) {
+    appendRequest(out, X11Op::MapWindow, 0, words({wid}));
+}
+
+void createGC(std::vector<uint8_t>& out, uint32_t gc, uint32_t drawable, uint32_t foreground) {
+    appendRequest(out, 55, 0, words({gc, drawable, 0x4 /*GCForeground*/, foreground}));
+}
+
+void createPixmap(std::vector<uint8_t>& out, uint32_t pid, uint32_t drawable, int w, int h) {
+    appendRequest(out, X11Op::CreatePixmap, 24, words({pid, drawable, pack16(w, h)}));
+}
+
+void putImage(std::vector<uint8_t>& out, uint32_t drawable, int x, int y, int w, int h, uint32_t seed) {
+    std::vector<uint8_t> body = words({drawable, kGC, pack16(w, h), pack16(x, y), 24u << 8});
+    const size_t header = body.size();
+    body.resize(header + (size_t)w * h * 4);
+    for (size_t i = header; i + 4 <= body.size(); i += 4) {
+        seed = seed * 1664525u + 1013904223u;
+        bo.write32(body.data(), (int)i, seed >> 8);
+    }
+    appendRequest(out, X11Op::PutImage, 2 /*ZPixmap*/, body);
+}
+
+void copyArea(std::vector<uint8_t>& out, uint32_t src, uint32_t dst, int w, int h) {
+    appendRequest(out, X11Op::CopyArea, 0,
+                  words({src, dst, kGC, pack16(0, 0), pack16(0, 0), pack16(w, h)}));
+}
+
+void fillRect(std::vector<uint8_t>& out, uint32_t drawable, int x, int y, int w, int h) {
+    appendRequest(out, X11Op::PolyFillRectangle, 0, words({drawable, kGC, pack16(x, y), pack16(w, h)}));
+}
+
+void glxRender(std::vector<uint8_t>& out, size_t commandBytes) {
+    // ContextTag, then 16-byte commands (length, opcode, two words of state)
+    std::vector<uint8_t> body = words({1});
+    for (size_t i = 0; i < commandBytes / 16; ++i) {
+        std::vector<uint8_t> cmd = words({pack16(16, 100 + (int)(i % 40)), (uint32_t)i, 0x3f800000u});
+        cmd.resize(16, 0);
+        body.insert(body.end(), cmd.begin(), cmd.end());
+    }
+    appendRequest(out, X11Op::kGLXMajorOpcode, 1 /*Render*/, body);
+}
+
+void syncRequest(std::vector<uint8_t>& out) {
+    appendRequest(out, X11Op::GetGeometry, 0, words({kRootWindowId}));
+}
+
+std::vector<uint8_t> commonSetup(int w, int h) {
+    std::vector<uint8_t> out;
+    appendRequest(out, X11Op::kBigRequestsMajorOpcode, 0, {});
+    createWindow(out, kWindow, w, h);
+    mapWindow(out, kWindow);
+    createGC(out, kGC, kWindow, 0x202020);
+    return out;
+}
+
+Stream guitarixKnobs() {
+    Stream s{"guitarix knobs", commonSetup(720, 300), {}};
+    for (int f = 0; f < 16; ++f) {
+        std::vector<uint8_t> frame;
+        for (int k = 0; k < 3; ++k) {
+            const int x = 40 + ((f + k) % 8) * 80, y = 60;
+            fillRect(frame, kWindow, x, y, 64, 64);
+            putImage(frame, kWindow, x, y, 64, 64, (uint32_t)(f * 3 + k));
+            putImage(frame, kWindow, x + 8, y + 70, 48, 14, (uint32_t)(f * 7 + k));
+        }
+        s.frames.push_back(std::move(frame));
+    }
+    return s;
+}
+
+Stream neuralRackDrag() {
+    Stream s{"NeuralRack drag", commonSetup(900, 420), {}};
+    createPixmap(s.setup, kBackPixmap, kWindow, 900, 420);
+    for (int f = 0; f < 16; ++f) {
+        std::vector<uint8_t> frame;
+        putImage(frame, kBackPixmap, 40 + f * 4, 120, 300, 180, (uint32_t)f);
+        putImage(frame, kBackPixmap, 600, 40, 120, 40, (uint32_t)f + 100);
+        copyArea(frame, kBackPixmap, kWindow, 900, 420);
+        s.frames.push_back(std::move(frame));
+    }
+    return s;
+}
+
+Stream aidaxGLX() {
+    Stream s{"AIDA-X GLX", commonSetup(800, 480), {}};
+    // CreateContext(context, visual, screen, share, direct), MakeCurrent(drawable, context, old tag)
+    appendRequest(s.setup, X11Op::kGLXMajorOpcode, 3, words({kGLXContext, kDefaultVisualId, 0, 0, 0}));
+    appendRequest(s.setup, X11Op::kGLXMajorOpcode, 5, words({kWindow, kGLXContext, 0}));
+    std::vector<uint8_t> frame;
+    for (int batch = 0; batch < 3; ++batch) glxRender(frame, 2048);
+    appendRequest(frame, X11Op::kGLXMajorOpcode, 11 /*SwapBuffers*/, words({1, kWindow}));
+    s.frames.push_back(std::move(frame));
+    return s;
+}
+
+bool loadCapture(const char* path, Stream& s) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    size_t start = 0;
+    if (bytes.size() >= 12 && (bytes[0] == 0x6c || bytes[0] == 0x42) && bytes[1] == 0 &&
+        bo.read16(bytes.data(), 2) == 11) {
+        if (bytes[0] == 0x42) {
+            std::fprintf(stderr, "%s: MSB-first captures are not supported\n", path);
+            return false;
+        }
+        const uint16_t nameLen = bo.read16(bytes.data(), 6), dataLen = bo.read16(bytes.data(), 8);
+        start = 12 + ((nameLen + 3u) & ~3u) + ((dataLen + 3u) & ~3u);
+    }
+    if (start >= bytes.size()) return false;
+    std::string name = path;
+    s.name = name.substr(name.find_last_of('/') + 1);
+    s.frames.emplace_back(bytes.begin() + (long)start, bytes.end());
+    return true;
+}
+
+/** Requests in a stream, as the server's sequence counter sees them. */
+uint64_t countRequests(const std::vector<uint8_t>& bytes) {
+    uint64_t n = 0;
+    size_t off = 0;
+    while (off + 4 <= bytes.size()) {
+        size_t len = bo.read16(bytes.data() + off, 2);
+        if (len == 0) {
+            if (off + 8 > bytes.size()) break;
+            len = bo.read32(bytes.data() + off, 4);
+        }
+        if (len == 0) break;
+        off += len * 4;
+        ++n;
+    }
+    return n;
+}
+
+/** Drains replies, events and errors, tracking the highest reply sequence number seen. */
+class ReplyReader {
+public:
+    explicit ReplyReader(int fd) : fd_(fd), buf_(1 << 16), thread_([this] { run(); }) {}
+    ~ReplyReader() { if (thread_.joinable()) thread_.join(); }
+
+    void waitFor(uint64_t seq) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return lastSeq_ >= seq || closed_; });
+    }
+    uint64_t errors() const { return errors_.load(); }
+
+private:
+    void run() {
+        size_t have = 0;
+        while (true) {
+            ssize_t n = recv(fd_, buf_.data() + have, buf_.size() - have, 0);
+            if (n <= 0) break;
+            have += (size_t)n;
+            size_t off = 0;
+            while (have - off >= 32) {
+                const uint8_t* p = buf_.data() + off;
+                size_t size = 32;
+                if (p[0] == 1 || p[0] == 35) size += (size_t)bo.read32(p, 4) * 4;
+                if (size > buf_.size()) buf_.resize(size);
+                if (have - off < size) break;
+                if (p[0] == 0) errors_.fetch_add(1);
+                if (p[0] == 1) {
+                    // Unwrap the 16-bit sequence; every frame ends in a reply, so gaps stay small
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    const uint16_t seq = bo.read16(p, 2);
+                    lastSeq_ += (uint16_t)(seq - (uint16_t)lastSeq_);
+                    cv_.notify_all();
+                }
+                off += size;
+            }
+            std::memmove(buf_.data(), buf_.data() + off, have - off);
+            have -= off;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        cv_.notify_all();
+    }
+
+    int fd_;
+    std::vector<uint8_t> buf_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    uint64_t lastSeq_ = 0;
+    bool closed_ = false;
+    std::atomic<uint64_t> errors_{0};
+    std::thread thread_;
+};
+
+double percentile(std::vector<int64_t> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return (double)v[(size_t)(p * (double)(v.size() - 1))] / 1000.0;
+}
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void run(const Stream& stream, int frames) {
+    // Frames as sent in both passes: the stream's frame plus the closing round trip
+    std::vector<std::vector<uint8_t>> wire;
+    std::vector<uint64_t> wireRequests;
+    for (const auto& f : stream.frames) {
+        wire.push_back(f);
+        syncRequest(wire.back());
+        wireRequests.push_back(countRequests(wire.back()));
+    }
+    std::vector<uint8_t> setup = stream.setup;
+    syncRequest(setup);
+
+    std::vector<int64_t> putNs(2 * (size_t)frames * 64);
+    std::atomic<size_t> putCount{0};
+    X11TestServer server;
+    server.onRequestHandled = [&](uint8_t opcode, size_t, int64_t ns) {
+        if (opcode != X11Op::PutImage) return;
+        const size_t i = putCount.load(std::memory_order_relaxed);
+        if (i < putNs.size()) {
+            putNs[i] = ns;
+            putCount.store(i + 1, std::memory_order_release);
+        }
+    };
+    const int fd = server.start(1920, 1080);
+    if (fd < 0) return;
+
+    uint8_t hello[12] = {0x6c, 0, 11, 0};
+    uint8_t header[8];
+    if (!sendRaw(fd, hello, sizeof(hello)) || !recvExact(fd, header, sizeof(header))) return;
+    std::vector<uint8_t> rest((size_t)bo.read16(header, 6) * 4);
+    if (!recvExact(fd, rest.data(), rest.size())) return;
+
+    uint64_t seq = 0;
+    {
+        ReplyReader reader(fd);
+        sendRaw(fd, setup.data(), setup.size());
+        seq += countRequests(setup);
+        reader.waitFor(seq);
+
+        // Pipelined: throughput
+        uint64_t bytes = 0, requests = 0;
+        const int64_t t0 = nowNs();
+        for (int i = 0; i < frames; ++i) {
+            const size_t f = (size_t)i % wire.size();
+            sendRaw(fd, wire[f].data(), wire[f].size());
+            bytes += wire[f].size();
+            requests += wireRequests[f];
+        }
+        seq += requests;
+        reader.waitFor(seq);
+        const double sec = (double)(nowNs() - t0) / 1e9;
+        const size_t pipelinedPuts = putCount.load(std::memory_order_acquire);
+
+        // One frame at a time: latency and allocations
+        std::vector<int64_t> frameNs((size_t)frames);
+        const uint64_t allocs0 = g_allocs.load(std::memory_order_relaxed);
+        for (int i = 0; i < frames; ++i) {
+            const size_t f = (size_t)i % wire.size();
+            const int64_t start = nowNs();
+            sendRaw(fd, wire[f].data(), wire[f].size());
+            seq += wireRequests[f];
+            reader.waitFor(seq);
+            frameNs[(size_t)i] = nowNs() - start;
+        }
+        const double allocsPerFrame = (double)(g_allocs.load(std::memory_order_relaxed) - allocs0) / frames;
+        const size_t puts = putCount.load(std::memory_order_acquire);
+        std::vector<int64_t> framePuts(putNs.begin() + (long)pipelinedPuts, putNs.begin() + (long)puts);
+
+        std::printf("%-18s %10.0f %9.1f %9.2f %9.2f %9.2f %10.1f %8.1f %6llu\n", stream.name.c_str(),
+                    (double)requests / sec, (double)bytes / sec / 1e6,
+                    percentile(framePuts, 0.5), percentile(framePuts, 0.99), percentile(framePuts, 1.0),
+                    percentile(frameNs, 0.5), allocsPerFrame,
+                    (unsigned long long)reader.errors());
+        server.stop();
+    }
+    close(fd);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? std::max(1, std::atoi(argv[1])) : 2000;
+    std::vector<Stream> streams = {guitarixKnobs(), neuralRackDrag(), aidaxGLX()};
+    for (int i = 2; i < argc; ++i) {
+        Stream s;
+        if (loadCapture(argv[i], s)) streams.push_back(std::move(s));
+        else std::fprintf(stderr, "%s: cannot load capture\n", argv[i]);
+    }
+
+    std::printf("%-18s %10s %9s %9s %9s %9s %10s %8s %6s\n", "stream", "req/s", "MB/s",
+                "put p50", "put p99", "put max", "frame p50", "allocs", "errors");
+    std::printf("%-18s %10s %9s %9s %9s %9s %10s %8s %6s\n", "", "", "", "us", "us", "us", "us",
+                "/frame", "");
+    for (const auto& s : streams) run(s, frames);
+    return 0;
+}
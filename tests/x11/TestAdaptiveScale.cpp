@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "X11AdaptiveScale.h"
+
+using namespace guitarrackcraft;
+
+namespace {
+constexpr int64_t kMs = 1000000LL;
+constexpr int64_t kSec = 1000 * kMs;
+
+/* Feed the same load every 500 ms from t0 for durationNs; returns the last time fed. */
+int64_t feed(X11AdaptiveScale& s, int64_t t0, int64_t durationNs, float load, int thermal = 0) {
+    int64_t t = t0;
+    for (; t <= t0 + durationNs; t += 500 * kMs) s.update(t, load, thermal);
+    return t - 500 * kMs;
+}
+}
+
+TEST(AdaptiveScale, StaysAtFullScaleUnderModerateLoad) {
+    X11AdaptiveScale s;
+    feed(s, kSec, 30 * kSec, 0.6f);
+    EXPECT_EQ(s.level(), 0);
+    EXPECT_FLOAT_EQ(s.scale(), 1.0f);
+}
+
+TEST(AdaptiveScale, SustainedHighLoadStepsDownWithDwell) {
+    X11AdaptiveScale s;
+    int64_t t = kSec;
+    EXPECT_FALSE(s.update(t, 0.9f, 0));
+    EXPECT_FALSE(s.update(t + 500 * kMs, 0.9f, 0));
+    EXPECT_TRUE(s.update(t + X11AdaptiveScale::kDownAfterNs, 0.9f, 0));
+    EXPECT_EQ(s.level(), 1);
+    // Still overloaded, but the next step waits for the dwell time
+    EXPECT_FALSE(s.update(t + X11AdaptiveScale::kDownAfterNs + 2 * kSec, 0.9f, 0));
+    EXPECT_TRUE(s.update(t + X11AdaptiveScale::kDownAfterNs + X11AdaptiveScale::kMinDwellNs, 0.9f, 0));
+    EXPECT_EQ(s.level(), 2);
+}
+
+TEST(AdaptiveScale, BottomsOutAtLowestLevel) {
+    X11AdaptiveScale s;
+    feed(s, kSec, 60 * kSec, 1.0f);
+    EXPECT_EQ(s.level(), X11AdaptiveScale::kLevelCount - 1);
+    EXPECT_LT(s.scale(), 1.0f);
+    EXPECT_GT(s.scale(), 0.0f);
+}
+
+TEST(AdaptiveScale, LightLoadRestoresFullScale) {
+    X11AdaptiveScale s;
+    int64_t t = feed(s, kSec, 10 * kSec, 0.9f);
+    ASSERT_GT(s.level(), 0);
+    // A short dip does not step back up
+    t = feed(s, t + 500 * kMs, 2 * kSec, 0.2f);
+    int dipped = s.level();
+    t = feed(s, t + 500 * kMs, 500 * kMs, 0.6f);
+    EXPECT_EQ(s.level(), dipped);
+    feed(s, t + 500 * kMs, 60 * kSec, 0.2f);
+    EXPECT_EQ(s.level(), 0);
+}
+
+TEST(AdaptiveScale, ThermalStatusSetsFloorImmediately) {
+    X11AdaptiveScale s;
+    EXPECT_TRUE(s.update(kSec, 0.1f, 3 /*SEVERE*/));
+    EXPECT_EQ(s.level(), X11AdaptiveScale::thermalFloor(3));
+    // Light load cannot step above the thermal floor
+    feed(s, 2 * kSec, 30 * kSec, 0.1f, 3);
+    EXPECT_EQ(s.level(), 2);
+    // Cooling down lets light load restore it
+    feed(s, 40 * kSec, 60 * kSec, 0.1f, 0);
+    EXPECT_EQ(s.level(), 0);
+}
+
+TEST(AdaptiveScale, ThermalFloorAndReset) {
+    EXPECT_EQ(X11AdaptiveScale::thermalFloor(-1), 0);
+    EXPECT_EQ(X11AdaptiveScale::thermalFloor(1), 0);
+    EXPECT_EQ(X11AdaptiveScale::thermalFloor(2), 1);
+    EXPECT_EQ(X11AdaptiveScale::thermalFloor(4), X11AdaptiveScale::kLevelCount - 1);
+    EXPECT_EQ(X11AdaptiveScale::thermalFloor(6), X11AdaptiveScale::kLevelCount - 1);
+
+    X11AdaptiveScale s;
+    s.update(kSec, 0.1f, 6);
+    s.reset();
+    EXPECT_EQ(s.level(), 0);
+    EXPECT_FLOAT_EQ(s.scale(), 1.0f);
+}
@@ -49,10 +49,10 @@ TEST(AtomStore, GetAtomNameUnknown) {
 
 TEST(AtomStore, ClearResetsState) {
     X11AtomStore store;
-    uint32_t id = store.intern("WM_NAME", false);
+    uint32_t id = store.intern("_NET_WM_NAME", false);
     EXPECT_NE(id, 0u);
     store.clear();
-    EXPECT_EQ(store.intern("WM_NAME", true), 0u);
+    EXPECT_EQ(store.intern("_NET_WM_NAME", true), 0u);
     EXPECT_EQ(store.getName(id), "");
 }
 
@@ -61,9 +61,42 @@ TEST(AtomStore, SequentialIds) {
     uint32_t id1 = store.intern("ATOM_A", false);
     uint32_t id2 = store.intern("ATOM_B", false);
     uint32_t id3 = store.intern("ATOM_C", false);
-    EXPECT_EQ(id1, 1u);
-    EXPECT_EQ(id2, 2u);
-    EXPECT_EQ(id3, 3u);
+    EXPECT_EQ(id1, X11AtomStore::kFirstDynamicAtom);
+    EXPECT_EQ(id2, X11AtomStore::kFirstDynamicAtom + 1);
+    EXPECT_EQ(id3, X11AtomStore::kFirstDynamicAtom + 2);
+}
+
+TEST(AtomStore, PredefinedAtomsHaveProtocolIds) {
+    X11AtomStore store;
+    EXPECT_EQ(store.intern("PRIMARY", true), 1u);
+    EXPECT_EQ(store.intern("ATOM", true), 4u);
+    EXPECT_EQ(store.intern("STRING", true), 31u);
+    EXPECT_EQ(store.intern("WM_NAME", false), 39u);
+    EXPECT_EQ(store.intern("WM_CLASS", true), 67u);
+    EXPECT_EQ(store.intern("WM_TRANSIENT_FOR", true), X11AtomStore::kLastPredefinedAtom);
+    EXPECT_EQ(store.getName(6), "CARDINAL");
+    EXPECT_EQ(store.getName(0), "");
+}
+
+TEST(AtomStore, PredefinedAtomsSurviveClear) {
+    X11AtomStore store;
+    store.intern("_NET_WM_STATE", false);
+    store.clear();
+    EXPECT_EQ(store.intern("WM_NAME", true), 39u);
+    EXPECT_EQ(store.getName(33), "WINDOW");
+}
+
+TEST(AtomStore, NamesAreCopied) {
+    X11AtomStore store;
+    std::string name = "_NET_WM_PID";
+    uint32_t id = store.intern(name, false);
+    name.assign("XXXXXXXXXXX");
+    EXPECT_EQ(store.getName(id), "_NET_WM_PID");
+    // Longer than a storage chunk
+    std::string longName(5000, 'a');
+    uint32_t longId = store.intern(longName, false);
+    EXPECT_EQ(store.getName(longId), longName);
+    EXPECT_EQ(store.getName(id), "_NET_WM_PID");
 }
 
 TEST(AtomStore, EmptyNameRejected) {
@@ -94,7 +127,7 @@ TEST(AtomStore, ClearThenReuse) {
     store.intern("A", false);
     store.intern("B", false);
     store.clear();
-    // After clear, IDs restart from 1
+    // After clear, IDs restart after the predefined atoms
     uint32_t id = store.intern("C", false);
-    EXPECT_EQ(id, 1u);
+    EXPECT_EQ(id, X11AtomStore::kFirstDynamicAtom);
 }
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "X11ClipRegion.h"
+#include "X11Framebuffer.h"
+
+using namespace guitarrackcraft;
+
+TEST(ClipRegion, EmptyRectsGiveEmptyRegion) {
+    X11ClipRegion r;
+    r.setRects({{5, 5, 5, 10}, {0, 3, 10, 3}});
+    EXPECT_TRUE(r.empty());
+    std::vector<blit::Span> spans;
+    int bandEnd = 0;
+    r.visibleSpans(4, 0, 10, spans, bandEnd);
+    ASSERT_EQ(spans.size(), 1u);
+    EXPECT_EQ(spans[0].x1, 0);
+    EXPECT_EQ(spans[0].x2, 10);
+}
+
+TEST(ClipRegion, OverlappingRectsBecomeDisjointBands) {
+    X11ClipRegion r;
+    r.setRects({{0, 0, 10, 10}, {5, 5, 20, 15}});
+    // Bands: [0,5) {0..10}, [5,10) {0..20}, [10,15) {5..20}
+    ASSERT_EQ(r.bands().size(), 3u);
+    EXPECT_EQ(r.bands()[1].y1, 5);
+    EXPECT_EQ(r.bands()[1].count, 1u);
+    EXPECT_EQ(r.spans()[r.bands()[1].first].x2, 20);
+    EXPECT_TRUE(r.contains(0, 0));
+    EXPECT_TRUE(r.contains(19, 14));
+    EXPECT_FALSE(r.contains(2, 12));
+    EXPECT_FALSE(r.contains(10, 2));
+}
+
+TEST(ClipRegion, AdjacentIdenticalBandsCoalesce) {
+    X11ClipRegion r;
+    r.setRects({{0, 0, 10, 5}, {0, 5, 10, 9}, {0, 9, 4, 12}, {4, 9, 10, 12}});
+    ASSERT_EQ(r.bands().size(), 1u);
+    EXPECT_EQ(r.bands()[0].y1, 0);
+    EXPECT_EQ(r.bands()[0].y2, 12);
+    EXPECT_EQ(r.rects().size(), 1u);
+}
+
+TEST(ClipRegion, VisibleSpansAndBandEnd) {
+    X11ClipRegion r;
+    r.setRects({{10, 10, 20, 20}, {30, 10, 40, 20}});
+    std::vector<blit::Span> spans;
+    int bandEnd = 0;
+
+    r.visibleSpans(0, 0, 50, spans, bandEnd);
+    ASSERT_EQ(spans.size(), 1u);
+    EXPECT_EQ(bandEnd, 10);  // gap above the first band
+
+    r.visibleSpans(10, 0, 50, spans, bandEnd);
+    ASSERT_EQ(spans.size(), 3u);
+    EXPECT_EQ(spans[0].x2, 10);
+    EXPECT_EQ(spans[1].x1, 20); EXPECT_EQ(spans[1].x2, 30);
+    EXPECT_EQ(spans[2].x1, 40);
+    EXPECT_EQ(bandEnd, 20);
+
+    // Query range falling inside one hidden span
+    r.visibleSpans(15, 12, 18, spans, bandEnd);
+    EXPECT_TRUE(spans.empty());
+
+    r.visibleSpans(25, 0, 50, spans, bandEnd);
+    ASSERT_EQ(spans.size(), 1u);
+}
+
+TEST(ClipRegion, PutImageMatchesRectListClip) {
+    std::vector<ClipRect> rects = {{3, 1, 9, 7}, {6, 4, 14, 11}, {0, 9, 2, 12}};
+    X11ClipRegion region;
+    region.setRects(rects);
+
+    const int W = 16, H = 12;
+    std::vector<uint8_t> src((size_t)W * H * 4);
+    for (size_t i = 0; i < src.size(); i++) src[i] = (uint8_t)(i * 7 + 1);
+    std::vector<uint32_t> a((size_t)W * H, 0), b((size_t)W * H, 0);
+    X11Framebuffer::putImage(a.data(), W, H, -1, 0, W, H, src.data(), src.size(), false, rects);
+    X11Framebuffer::putImage(b.data(), W, H, -1, 0, W, H, src.data(), src.size(), false, region);
+    EXPECT_EQ(a, b);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "X11DamageRegion.h"
+
+using namespace guitarrackcraft;
+
+TEST(DamageRegion, ResetMarksEverything) {
+    X11DamageRegion d;
+    d.reset(100, 50);
+    ASSERT_EQ(d.rects().size(), 1u);
+    EXPECT_TRUE(d.full());
+    EXPECT_EQ(d.area(), 100u * 50u);
+}
+
+TEST(DamageRegion, AddClipsToBounds) {
+    X11DamageRegion d;
+    d.reset(100, 50);
+    d.clear();
+    d.add(-10, 40, 30, 30);
+    ASSERT_EQ(d.rects().size(), 1u);
+    const auto& r = d.rects()[0];
+    EXPECT_EQ(r.x1, 0);
+    EXPECT_EQ(r.y1, 40);
+    EXPECT_EQ(r.x2, 20);
+    EXPECT_EQ(r.y2, 50);
+}
+
+TEST(DamageRegion, IgnoresEmptyAndOutside) {
+    X11DamageRegion d;
+    d.reset(100, 50);
+    d.clear();
+    d.add(10, 10, 0, 5);
+    d.add(200, 10, 5, 5);
+    d.add(10, -20, 5, 5);
+    EXPECT_TRUE(d.empty());
+}
+
+TEST(DamageRegion, DisjointRectsStaySeparate) {
+    X11DamageRegion d;
+    d.reset(100, 100);
+    d.clear();
+    d.add(0, 0, 10, 10);
+    d.add(50, 50, 10, 10);
+    EXPECT_EQ(d.rects().size(), 2u);
+    EXPECT_EQ(d.area(), 200u);
+}
+
+TEST(DamageRegion, OverlappingAndAdjacentRectsMerge) {
+    X11DamageRegion d;
+    d.reset(100, 100);
+    d.clear();
+    d.add(0, 0, 10, 10);
+    d.add(5, 5, 10, 10);
+    ASSERT_EQ(d.rects().size(), 1u);
+    EXPECT_EQ(d.rects()[0].x2, 15);
+    d.add(15, 0, 5, 15);  // shares an edge
+    ASSERT_EQ(d.rects().size(), 1u);
+    EXPECT_EQ(d.rects()[0].x2, 20);
+}
+
+TEST(DamageRegion, GrownRectAbsorbsEarlierNeighbours) {
+    X11DamageRegion d;
+    d.reset(100, 100);
+    d.clear();
+    d.add(0, 0, 10, 10);
+    d.add(30, 0, 10, 10);
+    ASSERT_EQ(d.rects().size(), 2u);
+    d.add(5, 0, 30, 5);  // bridges both
+    ASSERT_EQ(d.rects().size(), 1u);
+    EXPECT_EQ(d.rects()[0].x1, 0);
+    EXPECT_EQ(d.rects()[0].x2, 40);
+}
+
+TEST(DamageRegion, CollapsesToBoundingBoxPastLimit) {
+    X11DamageRegion d;
+    d.reset(1000, 10);
+    d.clear();
+    for (size_t i = 0; i <= X11DamageRegion::kMaxRects; ++i) {
+        d.add((int)i * 20, 2, 5, 3);
+    }
+    ASSERT_EQ(d.rects().size(), 1u);
+    const auto& r = d.rects()[0];
+    EXPECT_EQ(r.x1, 0);
+    EXPECT_EQ(r.y1, 2);
+    EXPECT_EQ(r.x2, (int)X11DamageRegion::kMaxRects * 20 + 5);
+    EXPECT_EQ(r.y2, 5);
+}
+
+TEST(DamageRegion, ClearKeepsBounds) {
+    X11DamageRegion d;
+    d.reset(10, 10);
+    d.clear();
+    EXPECT_TRUE(d.empty());
+    EXPECT_EQ(d.width(), 10);
+    d.addAll();
+    EXPECT_TRUE(d.full());
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "X11FramePacer.h"
+
+using namespace guitarrackcraft;
+
+namespace {
+constexpr int64_t kSec = 1000000000LL;
+constexpr int64_t kVsync = 16666667LL;  // 60 Hz
+}
+
+TEST(FramePacer, FullRateWhileInputIsRecent) {
+    X11FramePacer p;
+    int64_t t = 100 * kSec;
+    p.noteInput(t);
+    EXPECT_EQ(p.targetHz(t + kSec / 2), 0.0);
+    p.noteFrame(t);
+    EXPECT_EQ(p.frameDelayNs(t + kVsync), 0);
+}
+
+TEST(FramePacer, DropsToMeterThenIdleRate) {
+    X11FramePacer p;
+    int64_t t = 100 * kSec;
+    p.noteInput(t);
+    EXPECT_EQ(p.targetHz(t + X11FramePacer::kMeterAfterNs), X11FramePacer::kMeterHz);
+    EXPECT_EQ(p.targetHz(t + X11FramePacer::kIdleAfterNs), X11FramePacer::kIdleHz);
+    p.noteInput(t + X11FramePacer::kIdleAfterNs);
+    EXPECT_EQ(p.targetHz(t + X11FramePacer::kIdleAfterNs + kVsync), 0.0);
+}
+
+TEST(FramePacer, MeterRateDrawsEverySecondVsync) {
+    X11FramePacer p;
+    int64_t t = 100 * kSec;
+    p.noteInput(t - 2 * kSec);
+    EXPECT_EQ(p.frameDelayNs(t), 0);  // nothing drawn yet
+    p.noteFrame(t);
+
+    int64_t next = t + kVsync;
+    int64_t delay = p.frameDelayNs(next);
+    EXPECT_GT(delay, 0);
+    EXPECT_LT(delay, kVsync);
+    // The following vsync is within the slack of 1/30 s and is drawn
+    EXPECT_EQ(p.frameDelayNs(t + 2 * kVsync), 0);
+}
+
+TEST(FramePacer, IdleRateDrawsEveryFourthVsync) {
+    X11FramePacer p;
+    int64_t t = 100 * kSec;
+    p.noteInput(t - 20 * kSec);
+    p.noteFrame(t);
+    for (int i = 1; i < 4; ++i) EXPECT_GT(p.frameDelayNs(t + i * kVsync), 0) << i;
+    EXPECT_EQ(p.frameDelayNs(t + 4 * kVsync), 0);
+}
+
+TEST(FramePacer, CapAppliesEvenDuringInput) {
+    X11FramePacer p;
+    int64_t t = 100 * kSec;
+    p.noteInput(t);
+    p.setCapHz(20.0);
+    EXPECT_EQ(p.targetHz(t), 20.0);
+    EXPECT_EQ(p.targetHz(t + X11FramePacer::kIdleAfterNs), X11FramePacer::kIdleHz);  // slower wins
+    p.noteFrame(t);
+    EXPECT_GT(p.frameDelayNs(t + 2 * kVsync), 0);
+    EXPECT_EQ(p.frameDelayNs(t + 3 * kVsync), 0);
+    p.setCapHz(0.0);
+    EXPECT_EQ(p.targetHz(t), 0.0);
+}
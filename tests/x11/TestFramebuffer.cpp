@@ -265,3 +265,138 @@ TEST(Framebuffer, EmptyFramebufferGetImage) {
     // Should zero the output
     for (auto& p : dst) EXPECT_EQ(p, 0u);
 }
+
+// --- Row kernels and span clipping ---
+
+TEST(Framebuffer, RowKernelsMatchScalar) {
+    // Odd lengths and an unaligned source exercise the vector body and the scalar tail
+    std::vector<uint8_t> src(4 * 67 + 1);
+    for (size_t i = 0; i < src.size(); i++) src[i] = (uint8_t)(i * 37 + 11);
+    for (size_t n : {0u, 1u, 3u, 4u, 15u, 16u, 17u, 33u, 67u}) {
+        std::vector<uint32_t> got(n + 1, 0), want(n + 1, 0);
+        blit::copyRowOpaque(got.data(), src.data() + 1, n);
+        blit::scalar::copyRowOpaque(want.data(), src.data() + 1, n);
+        EXPECT_EQ(got, want) << "LSB n=" << n;
+        blit::copyRowOpaqueMsb(got.data(), src.data() + 1, n);
+        blit::scalar::copyRowOpaqueMsb(want.data(), src.data() + 1, n);
+        EXPECT_EQ(got, want) << "MSB n=" << n;
+        EXPECT_EQ(got[n], 0u) << "wrote past n=" << n;
+    }
+}
+
+TEST(Framebuffer, VisibleSpansSubtractsOverlappingRects) {
+    std::vector<ClipRect> clips = {{10, 0, 20, 5}, {15, 2, 30, 8}, {50, 10, 60, 20}};
+    std::vector<blit::Span> spans;
+    int bandEnd = 0;
+
+    blit::visibleSpans(0, 0, 40, clips, spans, bandEnd);
+    ASSERT_EQ(spans.size(), 2u);
+    EXPECT_EQ(spans[0].x1, 0);  EXPECT_EQ(spans[0].x2, 10);
+    EXPECT_EQ(spans[1].x1, 20); EXPECT_EQ(spans[1].x2, 40);
+    EXPECT_EQ(bandEnd, 2);  // second rect starts
+
+    blit::visibleSpans(3, 0, 40, clips, spans, bandEnd);
+    ASSERT_EQ(spans.size(), 2u);
+    EXPECT_EQ(spans[0].x2, 10);
+    EXPECT_EQ(spans[1].x1, 30);
+    EXPECT_EQ(bandEnd, 5);
+
+    blit::visibleSpans(12, 0, 40, clips, spans, bandEnd);
+    ASSERT_EQ(spans.size(), 1u);  // rect at x 50..60 lies outside [0, 40)
+    EXPECT_EQ(spans[0].x2, 40);
+    EXPECT_EQ(bandEnd, 20);
+}
+
+TEST(Framebuffer, PutImageSpansMatchPerPixelReference) {
+    const int W = 37, H = 23;
+    std::vector<ClipRect> clips = {{5, 3, 12, 9}, {8, 6, 20, 14}, {30, -4, 50, 7}};
+    // Source hangs off the top-left and is one row short of complete
+    const int x = -3, y = -2, w = 40, h = 20;
+    std::vector<uint8_t> src((size_t)w * (h - 1) * 4 + 6);
+    for (size_t i = 0; i < src.size(); i++) src[i] = (uint8_t)(i * 13 + 5);
+
+    for (bool msb : {false, true}) {
+        X11Framebuffer fb;
+        fb.resize(W, H, 0x11111111);
+        fb.putImage(x, y, w, h, src.data(), src.size(), msb, clips);
+
+        for (int dy = 0; dy < H; dy++) {
+            for (int dx = 0; dx < W; dx++) {
+                uint32_t want = 0x11111111;
+                int col = dx - x, row = dy - y;
+                bool clipped = false;
+                for (auto& cr : clips) {
+                    if (dx >= cr.x1 && dx < cr.x2 && dy >= cr.y1 && dy < cr.y2) clipped = true;
+                }
+                size_t idx = (size_t)(row * w + col) * 4;
+                if (col >= 0 && col < w && row >= 0 && row < h && !clipped && idx + 3 < src.size()) {
+                    const uint8_t* p = &src[idx];
+                    want = msb ? ((uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3])
+                               : ((uint32_t)p[3] << 24 | (uint32_t)p[2] << 16 | (uint32_t)p[1] << 8 | p[0]);
+                    want |= 0xFF000000u;
+                }
+                ASSERT_EQ(fb.data()[dy * W + dx], want) << "msb=" << msb << " at " << dx << "," << dy;
+            }
+        }
+    }
+}
+
+TEST(Framebuffer, CopyAreaOverlapBehavesLikeTemporary) {
+    const int W = 16, H = 12;
+    std::vector<uint32_t> orig((size_t)W * H);
+    for (size_t i = 0; i < orig.size(); i++) orig[i] = 0xFF000000u | (uint32_t)i;
+
+    const int offsets[][2] = {{3, 2}, {-3, -2}, {2, -3}, {-2, 3}, {0, 1}};
+    for (auto& o : offsets) {
+        // Source and destination both lie inside W x H, so nothing is clipped
+        const int sx = 4, sy = 4, w = 8, h = 5;
+        int dx = sx + o[0], dy = sy + o[1];
+        ASSERT_TRUE(dx >= 0 && dy >= 0 && dx + w <= W && dy + h <= H) << "offset " << o[0] << "," << o[1];
+        std::vector<uint32_t> buf = orig, want = orig;
+        for (int r = 0; r < h; r++)
+            for (int c = 0; c < w; c++)
+                want[(dy + r) * W + dx + c] = orig[(sy + r) * W + sx + c];
+        X11Framebuffer::copyArea(buf.data(), W, H, sx, sy, buf.data(), W, H, dx, dy, w, h);
+        EXPECT_EQ(buf, want) << "offset " << o[0] << "," << o[1];
+    }
+}
+
+TEST(Framebuffer, CopyAreaClipsToBothBuffers) {
+    std::vector<uint32_t> src(4 * 4), dst(6 * 3, 0);
+    for (size_t i = 0; i < src.size(); i++) src[i] = (uint32_t)i + 1;
+    // Source starts one column left of its buffer; destination overhangs bottom-right
+    X11Framebuffer::copyArea(src.data(), 4, 4, -1, 0, dst.data(), 6, 3, 4, 1, 4, 4);
+    EXPECT_EQ(dst[1 * 6 + 4], 0u);  // came from src x=-1
+    EXPECT_EQ(dst[1 * 6 + 5], 1u);  // src (0,0)
+    EXPECT_EQ(dst[2 * 6 + 5], 5u);  // src (0,1)
+    EXPECT_EQ(dst[0 * 6 + 5], 0u);
+}
+
+TEST(Framebuffer, FillRectClipsToBoundsAndRegion) {
+    X11Framebuffer fb;
+    fb.resize(8, 6, 0);
+    fb.fillRect(-2, 4, 5, 10, 0xFF00FF00u);
+    EXPECT_EQ(fb.data()[4 * 8 + 0], 0xFF00FF00u);
+    EXPECT_EQ(fb.data()[5 * 8 + 2], 0xFF00FF00u);
+    EXPECT_EQ(fb.data()[5 * 8 + 3], 0u);
+    EXPECT_EQ(fb.data()[3 * 8 + 0], 0u);
+
+    X11ClipRegion occluded;
+    occluded.setRects({{2, 1, 4, 3}});
+    std::vector<uint32_t> buf(8 * 6, 0);
+    X11Framebuffer::fillRect(buf.data(), 8, 6, 0, 0, 8, 4, 0xFF112233u, occluded);
+    EXPECT_EQ(buf[1 * 8 + 1], 0xFF112233u);
+    EXPECT_EQ(buf[1 * 8 + 2], 0u);
+    EXPECT_EQ(buf[2 * 8 + 3], 0u);
+    EXPECT_EQ(buf[2 * 8 + 4], 0xFF112233u);
+    EXPECT_EQ(buf[4 * 8 + 0], 0u);
+}
+
+TEST(Framebuffer, FillRowMatchesScalar) {
+    for (size_t n : {0u, 1u, 5u, 16u, 21u, 64u}) {
+        std::vector<uint32_t> got(n + 1, 0), want(n + 1, 0);
+        blit::fillRow(got.data(), 0xFFABCDEFu, n);
+        blit::scalar::fillRow(want.data(), 0xFFABCDEFu, n);
+        EXPECT_EQ(got, want) << "n=" << n;
+    }
+}
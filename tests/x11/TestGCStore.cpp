@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "X11GCStore.h"
+
+using namespace guitarrackcraft;
+
+TEST(GCStore, CreateAppliesValueListInMaskOrder) {
+    X11GCStore gcs;
+    // function, foreground, fill-style (bits 0, 2, 8)
+    uint32_t mask = X11GCStore::kFunction | X11GCStore::kForeground | X11GCStore::kFillStyle;
+    uint32_t values[] = {3, 0x00123456, 0};
+    gcs.create(0x400001, mask, values, 3);
+    const GCState* gc = gcs.get(0x400001);
+    ASSERT_NE(gc, nullptr);
+    EXPECT_EQ(gc->function, 3);
+    EXPECT_EQ(gc->foreground, 0x00123456u);
+    uint32_t pixel = 0;
+    ASSERT_TRUE(gcs.solidFill(0x400001, pixel));
+    EXPECT_EQ(pixel, 0xFF123456u);
+}
+
+TEST(GCStore, UntrackedBitsAreSkipped) {
+    X11GCStore gcs;
+    // line-width (bit 4) sits between foreground and fill-style in the list
+    uint32_t mask = X11GCStore::kForeground | (1u << 4) | X11GCStore::kFillStyle;
+    uint32_t values[] = {0x00AABBCC, 7, 1 /* FillTiled */};
+    gcs.create(1, mask, values, 3);
+    EXPECT_EQ(gcs.get(1)->foreground, 0x00AABBCCu);
+    EXPECT_EQ(gcs.get(1)->fillStyle, 1);
+    uint32_t pixel;
+    EXPECT_FALSE(gcs.solidFill(1, pixel));
+}
+
+TEST(GCStore, NonCopyFunctionAndClipPixmapAreNotSolid) {
+    X11GCStore gcs;
+    gcs.create(1, 0, nullptr, 0);
+    uint32_t pixel;
+    EXPECT_TRUE(gcs.solidFill(1, pixel));
+
+    uint32_t xorFn = 6;
+    gcs.change(1, X11GCStore::kFunction, &xorFn, 1);
+    EXPECT_FALSE(gcs.solidFill(1, pixel));
+
+    uint32_t copyFn = 3, clipPixmap = 0x400010;
+    gcs.change(1, X11GCStore::kFunction, &copyFn, 1);
+    gcs.change(1, X11GCStore::kClipMask, &clipPixmap, 1);
+    EXPECT_FALSE(gcs.solidFill(1, pixel));
+
+    // SetClipRectangles replaces the clip pixmap
+    gcs.setClipRectangles(1, 2, 3, {{0, 0, 4, 4}});
+    EXPECT_TRUE(gcs.solidFill(1, pixel));
+    EXPECT_TRUE(gcs.get(1)->clipToRects);
+    EXPECT_EQ(gcs.get(1)->clipX, 2);
+
+    // clip-mask None drops the rectangles again
+    uint32_t none = 0;
+    gcs.change(1, X11GCStore::kClipMask, &none, 1);
+    EXPECT_FALSE(gcs.get(1)->clipToRects);
+    EXPECT_TRUE(gcs.get(1)->clipRects.empty());
+}
+
+TEST(GCStore, CopyAndDestroy) {
+    X11GCStore gcs;
+    uint32_t fg = 0x00FF0000;
+    gcs.create(1, X11GCStore::kForeground, &fg, 1);
+    gcs.create(2, 0, nullptr, 0);
+    gcs.copy(1, 2, X11GCStore::kForeground);
+    EXPECT_EQ(gcs.get(2)->foreground, 0x00FF0000u);
+    gcs.destroy(1);
+    EXPECT_EQ(gcs.get(1), nullptr);
+    uint32_t pixel;
+    EXPECT_FALSE(gcs.solidFill(1, pixel));
+    EXPECT_EQ(gcs.size(), 1u);
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "X11GlxRenderBatch.h"
+
+using namespace guitarrackcraft;
+
+namespace {
+
+X11ByteOrder kLsb{false};
+
+/* One glXRender command: length(2) opcode(2) then 32-bit words, little-endian */
+void putCommand(std::vector<uint8_t>& out, uint16_t opcode, std::initializer_list<uint32_t> words) {
+    size_t at = out.size();
+    out.resize(at + 4 + words.size() * 4);
+    kLsb.write16(out.data(), (int)at, (uint16_t)(4 + words.size() * 4));
+    kLsb.write16(out.data(), (int)at + 2, opcode);
+    int off = (int)at + 4;
+    for (uint32_t w : words) { kLsb.write32(out.data(), off, w); off += 4; }
+}
+
+std::vector<uint32_t> opcodes(const X11GlxRenderBatch& b) {
+    std::vector<uint32_t> ops;
+    b.replay([&](uint32_t op, const uint8_t*, uint32_t) { ops.push_back(op); });
+    return ops;
+}
+
+} // namespace
+
+TEST(GlxRenderBatch, DecodesWholeRenderRequest) {
+    X11GlxRenderBatch b;
+    std::vector<uint8_t> req;
+    putCommand(req, 4117, {0x0DE1, 5});   // BindTexture
+    putCommand(req, 9, {1, 2, 3});        // some other command
+    ASSERT_TRUE(b.addRender(req.data(), req.size(), kLsb));
+    ASSERT_EQ(b.commands().size(), 2u);
+    EXPECT_EQ(b.commands()[1].opcode, 9u);
+    EXPECT_EQ(b.commands()[1].size, 12u);
+    b.replay([&](uint32_t op, const uint8_t* p, uint32_t size) {
+        if (op == 9) {
+            ASSERT_EQ(size, 12u);
+            EXPECT_EQ(kLsb.read32(p, 8), 3u);
+        }
+    });
+}
+
+TEST(GlxRenderBatch, MalformedCommandKeepsPrefix) {
+    X11GlxRenderBatch b;
+    std::vector<uint8_t> req;
+    putCommand(req, 9, {1});
+    putCommand(req, 10, {2});
+    kLsb.write16(req.data(), 8, 64);  // second command claims more than the request holds
+    EXPECT_FALSE(b.addRender(req.data(), req.size(), kLsb));
+    EXPECT_EQ(opcodes(b), std::vector<uint32_t>({9}));
+    EXPECT_EQ(b.stats().malformed, 1u);
+}
+
+TEST(GlxRenderBatch, RedundantStateIsSkippedAcrossFrames) {
+    X11GlxRenderBatch b;
+    std::vector<uint8_t> frame;
+    putCommand(frame, X11GlxRenderBatch::kRopBindTexture, {0x0DE1, 5});
+    putCommand(frame, X11GlxRenderBatch::kRopEnable, {0x0BE2});
+    putCommand(frame, X11GlxRenderBatch::kRopBlendFunc, {0x302, 0x303});
+    putCommand(frame, X11GlxRenderBatch::kRopViewport, {0, 0, 640, 480});
+    putCommand(frame, 9, {1});
+    ASSERT_TRUE(b.addRender(frame.data(), frame.size(), kLsb));
+    EXPECT_EQ(b.commands().size(), 5u);
+
+    b.clear();
+    ASSERT_TRUE(b.addRender(frame.data(), frame.size(), kLsb));
+    EXPECT_EQ(opcodes(b), std::vector<uint32_t>({9}));
+    EXPECT_EQ(b.stats().skipped, 4u);
+
+    // A different binding or a disable still goes through
+    b.clear();
+    std::vector<uint8_t> change;
+    putCommand(change, X11GlxRenderBatch::kRopBindTexture, {0x0DE1, 6});
+    putCommand(change, X11GlxRenderBatch::kRopDisable, {0x0BE2});
+    ASSERT_TRUE(b.addRender(change.data(), change.size(), kLsb));
+    EXPECT_EQ(b.commands().size(), 2u);
+}
+
+TEST(GlxRenderBatch, StateRestoringCommandsInvalidateCache) {
+    X11GlxRenderBatch b;
+    std::vector<uint8_t> req;
+    putCommand(req, X11GlxRenderBatch::kRopBindTexture, {0x0DE1, 5});
+    putCommand(req, X11GlxRenderBatch::kRopPopAttrib, {});
+    putCommand(req, X11GlxRenderBatch::kRopBindTexture, {0x0DE1, 5});
+    ASSERT_TRUE(b.addRender(req.data(), req.size(), kLsb));
+    EXPECT_EQ(b.commands().size(), 3u);
+
+    b.clear();
+    b.invalidateState();
+    std::vector<uint8_t> again;
+    putCommand(again, X11GlxRenderBatch::kRopBindTexture, {0x0DE1, 5});
+    ASSERT_TRUE(b.addRender(again.data(), again.size(), kLsb));
+    EXPECT_EQ(b.commands().size(), 1u);
+}
+
+TEST(GlxRenderBatch, ReassemblesRenderLarge) {
+    X11GlxRenderBatch b;
+    std::vector<uint8_t> cmd(8 + 1000);
+    kLsb.write32(cmd.data(), 0, (uint32_t)cmd.size());
+    kLsb.write32(cmd.data(), 4, 4100);  // e.g. TexImage2D
+    for (size_t i = 8; i < cmd.size(); ++i) cmd[i] = (uint8_t)i;
+
+    ASSERT_TRUE(b.addRenderLargePart(1, 3, cmd.data(), 400, kLsb));
+    ASSERT_TRUE(b.addRenderLargePart(2, 3, cmd.data() + 400, 400, kLsb));
+    EXPECT_TRUE(b.commands().empty());
+    ASSERT_TRUE(b.addRenderLargePart(3, 3, cmd.data() + 800, cmd.size() - 800, kLsb));
+    ASSERT_EQ(b.commands().size(), 1u);
+    EXPECT_EQ(b.commands()[0].opcode, 4100u);
+    EXPECT_EQ(b.commands()[0].size, 1000u);
+    b.replay([&](uint32_t, const uint8_t* p, uint32_t size) {
+        EXPECT_EQ(memcmp(p, cmd.data() + 8, size), 0);
+    });
+}
+
+TEST(GlxRenderBatch, OutOfOrderLargePartIsRejected) {
+    X11GlxRenderBatch b;
+    uint8_t part[16] = {};
+    EXPECT_FALSE(b.addRenderLargePart(2, 2, part, sizeof(part), kLsb));
+    ASSERT_TRUE(b.addRenderLargePart(1, 3, part, sizeof(part), kLsb));
+    EXPECT_FALSE(b.addRenderLargePart(3, 3, part, sizeof(part), kLsb));
+    EXPECT_TRUE(b.commands().empty());
+    EXPECT_EQ(b.stats().malformed, 2u);
+}
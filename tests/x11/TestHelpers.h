@@ -9,13 +9,18 @@
 #include "X11ConnectionHandler.h"
 #include "X11EventBuilder.h"
 #include "X11PropertyStore.h"
+#include "X11ShmRegistry.h"
+#include "X11RequestReader.h"
+#include "X11GCStore.h"
 
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <chrono>
 #include <cstring>
+#include <functional>
 #include <vector>
 #include <thread>
 #include <atomic>
@@ -86,6 +91,10 @@ public:
 
     int displayNum() const { return tcpDisplayNum_; }
 
+    // Benchmark hook, called on the server thread after each request with its opcode, size in
+    // bytes and handling time. Set before start(); requests are not timed when it is empty.
+    std::function<void(uint8_t opcode, size_t bytes, int64_t ns)> onRequestHandled;
+
     void stop() {
         running_ = false;
         if (listenFd_ >= 0) { close(listenFd_); listenFd_ = -1; }
@@ -157,38 +166,30 @@ private:
             if (ret <= 0) continue;
             if (pfd.revents & (POLLERR | POLLHUP)) break;
 
-            uint8_t buf[65536];
-            if (!recvAll(serverFd_, buf, 4)) break;
-            uint8_t opcode = buf[0];
-            uint16_t length = byteOrder_.read16(buf, 2);
-            seq++;
-
-            // BigRequests: length=0 means 32-bit extended length follows
-            if (length == 0) {
-                uint8_t extBuf[4];
-                if (!recvAll(serverFd_, extBuf, 4)) break;
-                uint32_t bigLength = byteOrder_.read32(extBuf, 0);
-                if (bigLength > 2) {
-                    size_t skipBytes = ((size_t)bigLength - 2) * 4;
-                    while (skipBytes > 0) {
-                        uint8_t tmp[4096];
-                        size_t chunk = std::min(skipBytes, sizeof(tmp));
-                        if (!recvAll(serverFd_, tmp, chunk)) break;
-                        skipBytes -= chunk;
-                    }
+            if (reader_.fill(serverFd_) == X11RequestReader::FillResult::Closed) break;
+
+            // Parse every complete request that arrived with this read
+            X11RequestReader::Request req;
+            while (reader_.next(req)) {
+                seq++;
+                if (req.discarded) continue;
+                // Small requests go through a zeroed scratch, as in the real server
+                uint8_t small[256] = {};
+                uint8_t* buf = req.data;
+                if (req.size <= sizeof(small)) {
+                    memcpy(small, req.data, req.size);
+                    buf = small;
                 }
-                continue;
-            }
-
-            // Read remaining body
-            size_t extra = 0;
-            if (length > 1) {
-                extra = (length - 1) * 4;
-                if (extra > sizeof(buf) - 4) { break; }
-                if (!recvAll(serverFd_, buf + 4, extra)) break;
+                if (!onRequestHandled) {
+                    handleRequest(req.opcode, buf, req.length, seq);
+                    continue;
+                }
+                const auto t0 = std::chrono::steady_clock::now();
+                handleRequest(req.opcode, buf, req.length, seq);
+                const auto t1 = std::chrono::steady_clock::now();
+                onRequestHandled(req.opcode, req.size,
+                                 std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
             }
-
-            handleRequest(opcode, buf, length, seq);
         }
     }
 
@@ -212,7 +213,7 @@ private:
         return {nullptr, 0, 0};
     }
 
-    void handleRequest(uint8_t opcode, uint8_t* buf, uint16_t length, uint16_t seq) {
+    void handleRequest(uint8_t opcode, uint8_t* buf, uint32_t length, uint16_t seq) {
         using namespace X11Op;
 
         switch (opcode) {
@@ -293,9 +294,9 @@ private:
             case InternAtom: {
                 uint8_t onlyIfExists = buf[1];
                 uint16_t nameLen = byteOrder_.read16(buf, 4);
-                std::string name;
+                std::string_view name;
                 if (nameLen > 0 && nameLen <= 256)
-                    name.assign(reinterpret_cast<const char*>(buf + 8), nameLen);
+                    name = std::string_view(reinterpret_cast<const char*>(buf + 8), nameLen);
                 uint32_t atomId = atoms_.intern(name, onlyIfExists);
                 uint8_t reply[32] = {};
                 reply[0] = 1;
@@ -306,7 +307,7 @@ private:
             }
             case GetAtomName: {
                 uint32_t atomId = byteOrder_.read32(buf, 4);
-                std::string name = atoms_.getName(atomId);
+                std::string_view name = atoms_.getName(atomId);
                 uint16_t nameLen = (uint16_t)name.size();
                 uint32_t pad = (4 - (nameLen % 4)) % 4;
                 uint32_t replyLen = (nameLen + pad) / 4;
@@ -338,23 +339,36 @@ private:
                 if (name == "GLX") {
                     reply[8] = 1;
                     reply[9] = X11Op::kGLXMajorOpcode;
+                } else if (name == "BIG-REQUESTS") {
+                    reply[8] = 1;
+                    reply[9] = X11Op::kBigRequestsMajorOpcode;
+                } else if (name == "MIT-SHM") {
+                    reply[8] = 1;
+                    reply[9] = X11Op::kShmMajorOpcode;
+                    reply[10] = X11Shm::kFirstEvent;
+                    reply[11] = X11Shm::kFirstError;
                 }
                 sendAll(serverFd_, reply, 32);
                 break;
             }
             case ListExtensions: {
-                const char* ext = "GLX";
-                uint8_t nameLen = 3;
-                uint32_t dataLen = 1 + nameLen;
+                const char* exts[] = {"GLX", "MIT-SHM", "BIG-REQUESTS"};
+                uint32_t dataLen = 0;
+                for (const char* ext : exts) dataLen += 1 + (uint32_t)strlen(ext);
                 uint32_t pad = (4 - (dataLen % 4)) % 4;
                 uint32_t replySize = 32 + dataLen + pad;
                 std::vector<uint8_t> reply(replySize, 0);
                 reply[0] = 1;
-                reply[1] = 1;
+                reply[1] = (uint8_t)(sizeof(exts) / sizeof(exts[0]));
                 byteOrder_.write16(reply.data(), 2, seq);
                 byteOrder_.write32(reply.data(), 4, (dataLen + pad) / 4);
-                reply[32] = nameLen;
-                memcpy(reply.data() + 33, ext, nameLen);
+                size_t off = 32;
+                for (const char* ext : exts) {
+                    uint8_t nameLen = (uint8_t)strlen(ext);
+                    reply[off++] = nameLen;
+                    memcpy(reply.data() + off, ext, nameLen);
+                    off += nameLen;
+                }
                 sendAll(serverFd_, reply.data(), replySize);
                 break;
             }
@@ -448,27 +462,7 @@ private:
                 int x = (int)(int16_t)byteOrder_.read16(buf, 16);
                 int y = (int)(int16_t)byteOrder_.read16(buf, 18);
                 size_t pixelDataLen = (length >= 6) ? ((size_t)length * 4 - 24) : 0;
-                const uint8_t* pixelData = buf + 24;
-
-                if (isWindow(drawable)) {
-                    std::vector<ClipRect> noClip;
-                    framebuffer_.putImage(x, y, w, h, pixelData, pixelDataLen,
-                                          byteOrder_.msbFirst, noClip);
-                } else {
-                    auto* pm = pixmapStore_.get(drawable);
-                    if (pm && w > 0 && h > 0 && pixelDataLen >= (size_t)w * h * 4) {
-                        // Simple blit into pixmap (LSB, no clipping)
-                        const uint32_t* src = reinterpret_cast<const uint32_t*>(pixelData);
-                        for (int row = 0; row < h && row + y < pm->h; row++) {
-                            for (int col = 0; col < w && col + x < pm->w; col++) {
-                                if (x + col >= 0 && y + row >= 0) {
-                                    pm->pixels[(y + row) * pm->w + (x + col)] =
-                                        src[row * w + col] | 0xFF000000u;
-                                }
-                            }
-                        }
-                    }
-                }
+                drawImage(drawable, x, y, w, h, buf + 24, pixelDataLen);
                 break;  // void, no reply
             }
             case GetImage: {
@@ -486,25 +480,7 @@ private:
                 reply[1] = 24;  // depth
                 byteOrder_.write16(reply.data(), 2, seq);
                 byteOrder_.write32(reply.data(), 4, (uint32_t)imgWords);
-
-                if (isWindow(drawable)) {
-                    framebuffer_.getImage(gx, gy, gw, gh,
-                                          reinterpret_cast<uint32_t*>(reply.data() + 32));
-                } else {
-                    auto* pm = pixmapStore_.get(drawable);
-                    if (pm && gw > 0 && gh > 0) {
-                        uint32_t* dst = reinterpret_cast<uint32_t*>(reply.data() + 32);
-                        for (int row = 0; row < gh; row++) {
-                            int sy = gy + row;
-                            for (int col = 0; col < gw; col++) {
-                                int sx = gx + col;
-                                if (sx >= 0 && sx < pm->w && sy >= 0 && sy < pm->h) {
-                                    dst[row * gw + col] = pm->pixels[sy * pm->w + sx];
-                                }
-                            }
-                        }
-                    }
-                }
+                readImage(drawable, gx, gy, gw, gh, reinterpret_cast<uint32_t*>(reply.data() + 32));
                 sendAll(serverFd_, reply.data(), replySize);
                 break;
             }
@@ -540,6 +516,72 @@ private:
                 }
                 break;
             }
+            // --- Graphics contexts and solid fills ---
+            case 55:    // CreateGC
+            case 56: {  // ChangeGC
+                int maskOff = opcode == 55 ? 12 : 8;
+                uint32_t mask = byteOrder_.read32(buf, maskOff);
+                uint32_t values[X11GCStore::kValueBits];
+                size_t n = std::min<size_t>(((size_t)length * 4 - maskOff - 4) / 4,
+                                            (size_t)X11GCStore::kValueBits);
+                for (size_t i = 0; i < n; i++) values[i] = byteOrder_.read32(buf, maskOff + 4 + (int)i * 4);
+                if (opcode == 55) gcStore_.create(byteOrder_.read32(buf, 4), mask, values, n);
+                else gcStore_.change(byteOrder_.read32(buf, 4), mask, values, n);
+                break;
+            }
+            case 59: {  // SetClipRectangles
+                std::vector<ClipRect> rects;
+                for (size_t off = 12; off + 8 <= (size_t)length * 4; off += 8) {
+                    int rx = (int)(int16_t)byteOrder_.read16(buf, (int)off);
+                    int ry = (int)(int16_t)byteOrder_.read16(buf, (int)off + 2);
+                    rects.push_back({rx, ry, rx + byteOrder_.read16(buf, (int)off + 4),
+                                     ry + byteOrder_.read16(buf, (int)off + 6)});
+                }
+                gcStore_.setClipRectangles(byteOrder_.read32(buf, 4),
+                                           (int16_t)byteOrder_.read16(buf, 8),
+                                           (int16_t)byteOrder_.read16(buf, 10), std::move(rects));
+                break;
+            }
+            case 60:  // FreeGC
+                gcStore_.destroy(byteOrder_.read32(buf, 4));
+                break;
+            case PolyFillRectangle: {
+                uint32_t pixel;
+                const GCState* gc = gcStore_.get(byteOrder_.read32(buf, 8));
+                auto dst = resolveDrawable(byteOrder_.read32(buf, 4));
+                if (!dst.pixels || !gcStore_.solidFill(byteOrder_.read32(buf, 8), pixel)) break;
+                static const X11ClipRegion noClip;
+                for (size_t off = 12; off + 8 <= (size_t)length * 4; off += 8) {
+                    int x1 = (int16_t)byteOrder_.read16(buf, (int)off);
+                    int y1 = (int16_t)byteOrder_.read16(buf, (int)off + 2);
+                    int x2 = x1 + byteOrder_.read16(buf, (int)off + 4);
+                    int y2 = y1 + byteOrder_.read16(buf, (int)off + 6);
+                    if (!gc->clipToRects) {
+                        X11Framebuffer::fillRect(dst.pixels, dst.w, dst.h, x1, y1, x2 - x1, y2 - y1,
+                                                 pixel, noClip);
+                        continue;
+                    }
+                    for (const auto& c : gc->clipRects) {
+                        int cx1 = std::max(x1, c.x1 + gc->clipX), cy1 = std::max(y1, c.y1 + gc->clipY);
+                        int cx2 = std::min(x2, c.x2 + gc->clipX), cy2 = std::min(y2, c.y2 + gc->clipY);
+                        X11Framebuffer::fillRect(dst.pixels, dst.w, dst.h, cx1, cy1, cx2 - cx1, cy2 - cy1,
+                                                 pixel, noClip);
+                    }
+                }
+                break;
+            }
+            case kBigRequestsMajorOpcode: {  // BigReqEnable
+                uint8_t reply[32] = {};
+                reply[0] = 1;
+                byteOrder_.write16(reply, 2, seq);
+                byteOrder_.write32(reply, 8, kBigRequestsMaxLength);
+                sendAll(serverFd_, reply, 32);
+                break;
+            }
+            // --- MIT-SHM sub-protocol ---
+            case kShmMajorOpcode:
+                handleShm(buf[1], buf, length, seq);
+                break;
             // --- GLX sub-protocol ---
             case kGLXMajorOpcode: {
                 uint8_t glxMinor = buf[1];
@@ -551,7 +593,155 @@ private:
         }
     }
 
-    void handleGLX(uint8_t minor, uint8_t* buf, uint16_t length, uint16_t seq) {
+    // Blit a ZPixmap image into a window (via the framebuffer) or a pixmap
+    void drawImage(uint32_t drawable, int x, int y, int w, int h,
+                   const uint8_t* pixelData, size_t pixelDataLen) {
+        if (isWindow(drawable)) {
+            std::vector<ClipRect> noClip;
+            framebuffer_.putImage(x, y, w, h, pixelData, pixelDataLen,
+                                  byteOrder_.msbFirst, noClip);
+        } else {
+            auto* pm = pixmapStore_.get(drawable);
+            if (pm && w > 0 && h > 0 && pixelDataLen >= (size_t)w * h * 4) {
+                // Simple blit into pixmap (LSB, no clipping)
+                const uint32_t* src = reinterpret_cast<const uint32_t*>(pixelData);
+                for (int row = 0; row < h && row + y < pm->h; row++) {
+                    for (int col = 0; col < w && col + x < pm->w; col++) {
+                        if (x + col >= 0 && y + row >= 0) {
+                            pm->pixels[(y + row) * pm->w + (x + col)] =
+                                src[row * w + col] | 0xFF000000u;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Copy a rect of a window or pixmap into dst (pixels outside the source are left as-is)
+    void readImage(uint32_t drawable, int gx, int gy, int gw, int gh, uint32_t* dst) {
+        if (isWindow(drawable)) {
+            framebuffer_.getImage(gx, gy, gw, gh, dst);
+            return;
+        }
+        auto* pm = pixmapStore_.get(drawable);
+        if (!pm || gw <= 0 || gh <= 0) return;
+        for (int row = 0; row < gh; row++) {
+            int sy = gy + row;
+            for (int col = 0; col < gw; col++) {
+                int sx = gx + col;
+                if (sx >= 0 && sx < pm->w && sy >= 0 && sy < pm->h) {
+                    dst[row * gw + col] = pm->pixels[sy * pm->w + sx];
+                }
+            }
+        }
+    }
+
+    void handleShm(uint8_t minor, uint8_t* buf, uint32_t length, uint16_t seq) {
+        switch (minor) {
+            case X11Shm::QueryVersion: {
+                uint8_t reply[32] = {};
+                reply[0] = 1;
+                byteOrder_.write16(reply, 2, seq);
+                byteOrder_.write16(reply, 8, 1);
+                byteOrder_.write16(reply, 10, 1);
+                reply[16] = 2;  // ZPixmap
+                sendAll(serverFd_, reply, 32);
+                break;
+            }
+            case X11Shm::Attach: {
+                uint32_t shmseg = byteOrder_.read32(buf, 4);
+                int shmid = (int)byteOrder_.read32(buf, 8);
+                if (length < 4 || !shmSegments_.attach(shmseg, shmid, buf[12] != 0))
+                    sendError(10 /*BadAccess*/, seq, shmseg, X11Op::kShmMajorOpcode);
+                break;
+            }
+            case X11Shm::Detach: {
+                uint32_t shmseg = byteOrder_.read32(buf, 4);
+                if (!shmSegments_.detach(shmseg))
+                    sendError(X11Shm::kFirstError, seq, shmseg, X11Op::kShmMajorOpcode);
+                break;
+            }
+            case X11Shm::PutImage: {
+                uint32_t drawable = byteOrder_.read32(buf, 4);
+                int totalW = (int)byteOrder_.read16(buf, 12);
+                int totalH = (int)byteOrder_.read16(buf, 14);
+                int srcX = (int)byteOrder_.read16(buf, 16);
+                int srcY = (int)byteOrder_.read16(buf, 18);
+                int srcW = (int)byteOrder_.read16(buf, 20);
+                int srcH = (int)byteOrder_.read16(buf, 22);
+                int dstX = (int)(int16_t)byteOrder_.read16(buf, 24);
+                int dstY = (int)(int16_t)byteOrder_.read16(buf, 26);
+                bool sendEvent = buf[30] != 0;
+                uint32_t shmseg = byteOrder_.read32(buf, 32);
+                uint32_t offset = byteOrder_.read32(buf, 36);
+                auto* segment = shmSegments_.get(shmseg);
+                if (!segment) {
+                    sendError(X11Shm::kFirstError, seq, shmseg, X11Op::kShmMajorOpcode);
+                    break;
+                }
+                size_t stride = (size_t)totalW * 4;
+                if (srcX + srcW > totalW || srcY + srcH > totalH ||
+                    !segment->contains(offset, stride * totalH)) {
+                    sendError(2 /*BadValue*/, seq, offset, X11Op::kShmMajorOpcode);
+                    break;
+                }
+                std::vector<uint8_t> packed((size_t)srcW * srcH * 4);
+                for (int row = 0; row < srcH; row++) {
+                    memcpy(packed.data() + (size_t)row * srcW * 4,
+                           segment->base + offset + (size_t)(srcY + row) * stride + (size_t)srcX * 4,
+                           (size_t)srcW * 4);
+                }
+                drawImage(drawable, dstX, dstY, srcW, srcH, packed.data(), packed.size());
+                if (sendEvent) {
+                    uint8_t ev[32] = {};
+                    ev[0] = X11Shm::kFirstEvent;
+                    byteOrder_.write16(ev, 2, seq);
+                    byteOrder_.write32(ev, 4, drawable);
+                    byteOrder_.write16(ev, 8, X11Shm::PutImage);
+                    ev[10] = X11Op::kShmMajorOpcode;
+                    byteOrder_.write32(ev, 12, shmseg);
+                    byteOrder_.write32(ev, 16, offset);
+                    sendAll(serverFd_, ev, 32);
+                }
+                break;
+            }
+            case X11Shm::GetImage: {
+                uint32_t drawable = byteOrder_.read32(buf, 4);
+                int gx = (int)(int16_t)byteOrder_.read16(buf, 8);
+                int gy = (int)(int16_t)byteOrder_.read16(buf, 10);
+                int gw = (int)byteOrder_.read16(buf, 12);
+                int gh = (int)byteOrder_.read16(buf, 14);
+                uint32_t shmseg = byteOrder_.read32(buf, 24);
+                uint32_t offset = byteOrder_.read32(buf, 28);
+                auto* segment = shmSegments_.get(shmseg);
+                size_t imgBytes = (size_t)gw * gh * 4;
+                if (!segment) {
+                    sendError(X11Shm::kFirstError, seq, shmseg, X11Op::kShmMajorOpcode);
+                    break;
+                }
+                if (segment->readOnly || !segment->contains(offset, imgBytes)) {
+                    sendError(segment->readOnly ? 10 /*BadAccess*/ : 2 /*BadValue*/, seq, offset,
+                              X11Op::kShmMajorOpcode);
+                    break;
+                }
+                std::vector<uint32_t> pixels((size_t)gw * gh, 0);
+                readImage(drawable, gx, gy, gw, gh, pixels.data());
+                memcpy(segment->base + offset, pixels.data(), imgBytes);
+                uint8_t reply[32] = {};
+                reply[0] = 1;
+                reply[1] = 24;
+                byteOrder_.write16(reply, 2, seq);
+                byteOrder_.write32(reply, 12, (uint32_t)imgBytes);
+                sendAll(serverFd_, reply, 32);
+                break;
+            }
+            default:
+                sendError(1 /*BadRequest*/, seq, 0, X11Op::kShmMajorOpcode);
+                break;
+        }
+    }
+
+    void handleGLX(uint8_t minor, uint8_t* /*buf*/, uint32_t /*length*/, uint16_t seq) {
         switch (minor) {
             case 7: { // glXQueryVersion
                 uint8_t reply[32] = {};
@@ -688,6 +878,9 @@ private:
     X11WindowManager windowManager_;
     X11PixmapStore pixmapStore_;
     X11PropertyStore propertyStore_;
+    X11ShmSegmentTable shmSegments_;
+    X11GCStore gcStore_;
+    X11RequestReader reader_{byteOrder_, (size_t)kBigRequestsMaxLength * 4};
     X11Framebuffer framebuffer_;
     X11EventBuilder eventBuilder_{byteOrder_};
 };
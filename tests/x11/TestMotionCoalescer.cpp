@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "X11MotionCoalescer.h"
+
+using namespace guitarrackcraft;
+
+namespace {
+constexpr int64_t kMs = 1000000LL;
+constexpr int64_t kT0 = 1000 * kMs;
+}
+
+TEST(MotionCoalescer, MergesMovesWhileAMotionIsInFlight) {
+    X11MotionCoalescer m(false);
+    int x = 0, y = 0;
+    m.move(10, 10, kT0);
+    ASSERT_TRUE(m.take(5, false, kT0, x, y));
+    EXPECT_EQ(x, 10);
+    for (int i = 1; i <= 10; ++i) m.move(10 + i, 10, kT0 + i * kMs);
+    // Client has not reacted yet: nothing, whatever the idle state
+    EXPECT_FALSE(m.take(5, false, kT0 + 10 * kMs, x, y));
+    EXPECT_FALSE(m.take(5, true, kT0 + 10 * kMs, x, y));
+    // Processed requests but is still busy
+    EXPECT_FALSE(m.take(9, false, kT0 + 11 * kMs, x, y));
+    // Processed requests and caught up: one merged motion at the latest point
+    ASSERT_TRUE(m.take(9, true, kT0 + 12 * kMs, x, y));
+    EXPECT_EQ(x, 20);
+    EXPECT_FALSE(m.take(12, true, kT0 + 13 * kMs, x, y));
+}
+
+TEST(MotionCoalescer, HoldTimesOutForClientsThatDoNotRedraw) {
+    X11MotionCoalescer m(false);
+    int x = 0, y = 0;
+    m.move(1, 1, kT0);
+    ASSERT_TRUE(m.take(3, true, kT0, x, y));
+    m.move(2, 2, kT0 + kMs);
+    EXPECT_EQ(m.waitNs(kT0 + kMs), X11MotionCoalescer::kMaxHoldNs - kMs);
+    EXPECT_FALSE(m.take(3, true, kT0 + X11MotionCoalescer::kMaxHoldNs - 1, x, y));
+    ASSERT_TRUE(m.take(3, false, kT0 + X11MotionCoalescer::kMaxHoldNs, x, y));
+    EXPECT_EQ(x, 2);
+    EXPECT_EQ(m.waitNs(kT0 + X11MotionCoalescer::kMaxHoldNs), -1);
+}
+
+TEST(MotionCoalescer, ButtonFlushesPendingPointAndStartsOver) {
+    X11MotionCoalescer m;
+    int x = 0, y = 0;
+    EXPECT_FALSE(m.takeBeforeButton(x, y));
+    m.move(4, 5, kT0);
+    ASSERT_TRUE(m.take(1, true, kT0, x, y));
+    m.move(6, 7, kT0 + kMs);
+    ASSERT_TRUE(m.takeBeforeButton(x, y));
+    EXPECT_EQ(x, 6);
+    EXPECT_EQ(y, 7);
+    EXPECT_EQ(m.waitNs(kT0 + kMs), -1);
+    // Nothing in flight after the button: the next move goes out at once
+    m.move(8, 8, kT0 + 2 * kMs);
+    EXPECT_TRUE(m.take(1, false, kT0 + 2 * kMs, x, y));
+}
+
+TEST(MotionCoalescer, PredictsAlongTheStrokeThenSettles) {
+    X11MotionCoalescer m(true);
+    int x = 0, y = 0;
+    // 1 px per ms to the right
+    for (int i = 0; i <= 16; ++i) m.move(100 + i, 50, kT0 + i * kMs);
+    ASSERT_TRUE(m.take(1, true, kT0 + 16 * kMs, x, y));
+    EXPECT_EQ(x, 116 + 8);
+    EXPECT_EQ(y, 50);
+    // Finger stops: after kSettleNs the real point is sent once
+    int64_t last = kT0 + 16 * kMs;
+    EXPECT_EQ(m.waitNs(last), X11MotionCoalescer::kMaxHoldNs);
+    EXPECT_FALSE(m.take(2, true, last + X11MotionCoalescer::kSettleNs - 1, x, y));
+    ASSERT_TRUE(m.take(2, true, last + X11MotionCoalescer::kSettleNs, x, y));
+    EXPECT_EQ(x, 116);
+    EXPECT_FALSE(m.take(3, true, last + 2 * X11MotionCoalescer::kSettleNs, x, y));
+}
+
+TEST(MotionCoalescer, PredictionIsClampedAndNeedsHistory) {
+    X11MotionCoalescer m(true);
+    int x = 0, y = 0;
+    m.move(0, 0, kT0);
+    m.move(100, 0, kT0 + kMs);
+    ASSERT_TRUE(m.take(1, true, kT0 + kMs, x, y));
+    EXPECT_EQ(x, 100);  // two samples: no velocity yet
+    m.move(200, 0, kT0 + 2 * kMs);
+    m.move(300, 0, kT0 + 5 * kMs);
+    ASSERT_TRUE(m.take(2, true, kT0 + 5 * kMs, x, y));
+    EXPECT_EQ(x, 300 + X11MotionCoalescer::kMaxPredictPx);
+}
@@ -76,3 +76,78 @@ TEST(PixmapStore, PixmapPixelsAreWritable) {
     pm->pixels[0] = 0xFFFF0000;
     EXPECT_EQ(store.get(100)->pixels[0], 0xFFFF0000u);
 }
+
+TEST(PixmapStore, SizeClassesBoundSlack) {
+    EXPECT_EQ(X11PixmapStore::sizeClass(1), 64u);
+    EXPECT_EQ(X11PixmapStore::sizeClass(64), 64u);
+    for (size_t n : {65u, 100u, 1000u, 4097u, 640u * 480u, 1920u * 1080u}) {
+        size_t c = X11PixmapStore::sizeClass(n);
+        EXPECT_GE(c, n);
+        EXPECT_LE(c, n + n / 4 + 16) << n;
+    }
+    // Nearby sizes share a class so drags that jitter the size still hit the pool
+    EXPECT_EQ(X11PixmapStore::sizeClass(400 * 300), X11PixmapStore::sizeClass(401 * 300));
+}
+
+TEST(PixmapStore, FreedStorageIsReused) {
+    X11PixmapStore store;
+    store.create(1, 400, 300);
+    const uint32_t* first = store.get(1)->pixels.data();
+    store.destroy(1);
+    EXPECT_EQ(store.stats().liveBytes, 0u);
+    EXPECT_EQ(store.stats().pooledBytes, X11PixmapStore::sizeClass(400 * 300) * 4);
+
+    store.create(2, 401, 300, 0xFF010203);
+    auto* pm = store.get(2);
+    EXPECT_EQ(pm->pixels.data(), first);
+    EXPECT_EQ(pm->pixels.size(), 401u * 300u);
+    EXPECT_EQ(store.stats().poolHits, 1u);
+    EXPECT_EQ(store.stats().pooledBytes, 0u);
+    // Recycled storage is refilled, not left with the old contents
+    for (auto p : pm->pixels) ASSERT_EQ(p, 0xFF010203u);
+}
+
+TEST(PixmapStore, FullOverwriteSkipsFillPartialWriteFills) {
+    X11PixmapStore store;
+    store.create(1, 8, 8, 0xFFAAAAAA);
+    auto* pm = store.getForWrite(1, 0, 0, 8, 8);
+    ASSERT_NE(pm, nullptr);
+    std::fill(pm->pixels.begin(), pm->pixels.end(), 0xFF000001u);
+    EXPECT_EQ(store.get(1)->pixels[63], 0xFF000001u);  // later get() must not refill
+
+    store.create(2, 8, 8, 0xFFAAAAAA);
+    pm = store.getForWrite(2, 1, 1, 4, 4);
+    EXPECT_EQ(pm->pixels[0], 0xFFAAAAAAu);
+    EXPECT_EQ(pm->pixels[63], 0xFFAAAAAAu);
+}
+
+TEST(PixmapStore, AccountingAndPoolCap) {
+    X11PixmapStore store;
+    store.create(1, 100, 100);
+    store.create(2, 200, 100);
+    size_t live = (X11PixmapStore::sizeClass(100 * 100) + X11PixmapStore::sizeClass(200 * 100)) * 4;
+    EXPECT_EQ(store.stats().pixmaps, 2u);
+    EXPECT_EQ(store.stats().liveBytes, live);
+    EXPECT_EQ(store.stats().peakBytes, live);
+
+    // A block larger than the pool cap is freed, not pooled
+    int side = 3000;  // 36 MB
+    store.create(3, side, side);
+    store.destroy(3);
+    EXPECT_EQ(store.stats().pooledBytes, 0u);
+    EXPECT_EQ(store.stats().liveBytes, live);
+
+    store.clear();
+    EXPECT_EQ(store.stats().liveBytes, 0u);
+    EXPECT_EQ(store.stats().pooledBytes, 0u);
+    EXPECT_GT(store.stats().peakBytes, live);
+}
+
+TEST(PixmapStore, RecreateSameIdReleasesOldStorage) {
+    X11PixmapStore store;
+    store.create(1, 64, 64);
+    store.create(1, 32, 32);
+    EXPECT_EQ(store.stats().pixmaps, 1u);
+    EXPECT_EQ(store.stats().liveBytes, X11PixmapStore::sizeClass(32 * 32) * 4);
+    EXPECT_EQ(store.get(1)->w, 32);
+}
@@ -180,3 +180,44 @@ TEST(PropertyStore, ClearAll) {
     EXPECT_TRUE(store.list(1).empty());
     EXPECT_TRUE(store.list(2).empty());
 }
+
+TEST(PropertyStore, ManyWindowsSurviveRemoval) {
+    // Enough windows to grow the table, then remove every other one so lookups
+    // have to cross backward-shifted probe runs
+    X11PropertyStore store;
+    const uint32_t base = 0x00200000;
+    for (uint32_t i = 0; i < 500; i++) {
+        uint32_t v = i;
+        store.change(base + i, 39, 6, 32, X11PropertyStore::ModeReplace,
+                     reinterpret_cast<const uint8_t*>(&v), 1);
+    }
+    for (uint32_t i = 0; i < 500; i += 2) {
+        store.clearWindow(base + i);
+    }
+    for (uint32_t i = 0; i < 500; i++) {
+        uint32_t bytesAfter = 0;
+        auto prop = store.get(base + i, 39, 0, 0, 1, bytesAfter);
+        if (i % 2 == 0) {
+            EXPECT_EQ(prop.format, 0) << i;
+        } else {
+            ASSERT_EQ(prop.data.size(), 4u) << i;
+            uint32_t v = 0;
+            memcpy(&v, prop.data.data(), 4);
+            EXPECT_EQ(v, i);
+        }
+    }
+}
+
+TEST(PropertyStore, DeletingLastPropertyReleasesWindow) {
+    X11PropertyStore store;
+    uint8_t data[] = "x";
+    store.change(7, 100, 31, 8, X11PropertyStore::ModeReplace, data, 1);
+    store.change(7, 200, 31, 8, X11PropertyStore::ModeReplace, data, 1);
+    store.remove(7, 100);
+    EXPECT_EQ(store.list(7), std::vector<uint32_t>{200u});
+    store.remove(7, 200);
+    EXPECT_TRUE(store.list(7).empty());
+    // Reused storage starts empty
+    store.change(8, 300, 31, 8, X11PropertyStore::ModeReplace, data, 1);
+    EXPECT_EQ(store.list(8), std::vector<uint32_t>{300u});
+}
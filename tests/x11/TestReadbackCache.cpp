@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include "X11ReadbackCache.h"
+
+using namespace guitarrackcraft;
+
+TEST(ReadbackCache, EmptyCacheNeverMatches) {
+    X11ReadbackCache c;
+    EXPECT_FALSE(c.matches(1, 0, 0, 10, 10, 100, 100));
+}
+
+TEST(ReadbackCache, MatchesOnlySameRequestAndFramebufferSize) {
+    X11ReadbackCache c;
+    c.prepare(32 + 10 * 10 * 4);
+    c.store(1, 5, 5, 10, 10, 100, 100);
+    EXPECT_TRUE(c.matches(1, 5, 5, 10, 10, 100, 100));
+    EXPECT_FALSE(c.matches(2, 5, 5, 10, 10, 100, 100));
+    EXPECT_FALSE(c.matches(1, 6, 5, 10, 10, 100, 100));
+    EXPECT_FALSE(c.matches(1, 5, 5, 10, 11, 100, 100));
+    EXPECT_FALSE(c.matches(1, 5, 5, 10, 10, 120, 100));
+}
+
+TEST(ReadbackCache, WritesOutsideRectKeepCache) {
+    X11ReadbackCache c;
+    c.store(1, 10, 10, 20, 20, 100, 100);
+    c.noteWrite(0, 0, 10, 100);   // touches the left edge only
+    c.noteWrite(30, 10, 5, 5);    // starts at x2
+    c.noteWrite(10, 10, 0, 20);   // empty
+    EXPECT_TRUE(c.matches(1, 10, 10, 20, 20, 100, 100));
+}
+
+TEST(ReadbackCache, OverlappingWriteOrInvalidateDropsCache) {
+    X11ReadbackCache c;
+    c.store(1, 10, 10, 20, 20, 100, 100);
+    c.noteWrite(29, 29, 5, 5);
+    EXPECT_FALSE(c.matches(1, 10, 10, 20, 20, 100, 100));
+
+    c.store(1, 10, 10, 20, 20, 100, 100);
+    c.invalidate();
+    EXPECT_FALSE(c.matches(1, 10, 10, 20, 20, 100, 100));
+}
+
+TEST(ReadbackCache, PrepareKeepsCapacity) {
+    X11ReadbackCache c;
+    uint8_t* big = c.prepare(4096);
+    big[4095] = 0x5A;
+    uint8_t* small = c.prepare(64);
+    EXPECT_EQ(big, small);
+    EXPECT_EQ(c.data()[4095], 0x5A);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "X11RequestReader.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace guitarrackcraft;
+
+namespace {
+
+std::vector<uint8_t> makeRequest(const X11ByteOrder& bo, uint8_t opcode, uint8_t data, size_t bodyBytes,
+                                 uint8_t fill = 0xAB) {
+    std::vector<uint8_t> r(4 + bodyBytes, fill);
+    r[0] = opcode;
+    r[1] = data;
+    bo.write16(r.data(), 2, (uint16_t)(r.size() / 4));
+    return r;
+}
+
+std::vector<uint8_t> makeBigRequest(const X11ByteOrder& bo, uint8_t opcode, uint8_t data, size_t bodyBytes) {
+    std::vector<uint8_t> r(8 + bodyBytes);
+    r[0] = opcode;
+    r[1] = data;
+    bo.write16(r.data(), 2, 0);
+    bo.write32(r.data(), 4, (uint32_t)(r.size() / 4));
+    for (size_t i = 0; i < bodyBytes; i++) r[8 + i] = (uint8_t)i;
+    return r;
+}
+
+} // namespace
+
+TEST(RequestReader, ParsesSeveralRequestsFromOneChunk) {
+    X11ByteOrder bo{false};
+    X11RequestReader reader(bo);
+    auto a = makeRequest(bo, 16, 0, 8);
+    auto b = makeRequest(bo, 43, 0, 0);
+    auto c = makeRequest(bo, 72, 2, 24);
+    std::vector<uint8_t> chunk;
+    for (auto* r : {&a, &b, &c}) chunk.insert(chunk.end(), r->begin(), r->end());
+    reader.append(chunk.data(), chunk.size());
+
+    X11RequestReader::Request req;
+    ASSERT_TRUE(reader.next(req));
+    EXPECT_EQ(req.opcode, 16);
+    EXPECT_EQ(req.length, 3u);
+    ASSERT_TRUE(reader.next(req));
+    EXPECT_EQ(req.opcode, 43);
+    EXPECT_EQ(req.length, 1u);
+    ASSERT_TRUE(reader.next(req));
+    EXPECT_EQ(req.opcode, 72);
+    EXPECT_EQ(req.data[1], 2);
+    EXPECT_EQ(req.size, 28u);
+    EXPECT_FALSE(reader.next(req));
+    EXPECT_EQ(reader.buffered(), 0u);
+}
+
+TEST(RequestReader, WaitsForPartialRequest) {
+    X11ByteOrder bo{true};
+    X11RequestReader reader(bo);
+    auto r = makeRequest(bo, 1, 0, 28);
+    X11RequestReader::Request req;
+    reader.append(r.data(), 2);
+    EXPECT_FALSE(reader.next(req));
+    reader.append(r.data() + 2, 10);
+    EXPECT_FALSE(reader.next(req));
+    reader.append(r.data() + 12, r.size() - 12);
+    ASSERT_TRUE(reader.next(req));
+    EXPECT_EQ(req.length, 8u);
+    EXPECT_EQ(memcmp(req.data, r.data(), r.size()), 0);
+}
+
+TEST(RequestReader, NormalizesBigRequests) {
+    X11ByteOrder bo{false};
+    X11RequestReader reader(bo);
+    const size_t body = 300000;  // larger than the initial buffer
+    auto r = makeBigRequest(bo, 72, 2, body);
+    reader.append(r.data(), r.size());
+
+    X11RequestReader::Request req;
+    ASSERT_TRUE(reader.next(req));
+    EXPECT_TRUE(req.big);
+    EXPECT_EQ(req.opcode, 72);
+    EXPECT_EQ(req.size, 4 + body);
+    EXPECT_EQ(req.length, (4 + body) / 4);
+    EXPECT_EQ(req.data[0], 72);
+    EXPECT_EQ(req.data[1], 2);
+    EXPECT_EQ(req.data[4], 0);
+    EXPECT_EQ(req.data[4 + body - 1], (uint8_t)(body - 1));
+}
+
+TEST(RequestReader, DiscardsOversizedRequestAcrossChunks) {
+    X11ByteOrder bo{false};
+    X11RequestReader reader(bo, 1024);
+    auto big = makeBigRequest(bo, 72, 2, 4096);
+    auto after = makeRequest(bo, 43, 0, 0);
+
+    X11RequestReader::Request req;
+    reader.append(big.data(), 1000);
+    EXPECT_FALSE(reader.next(req));
+    reader.append(big.data() + 1000, big.size() - 1000);
+    reader.append(after.data(), after.size());
+    ASSERT_TRUE(reader.next(req));
+    EXPECT_TRUE(req.discarded);
+    EXPECT_EQ(req.opcode, 72);
+    EXPECT_EQ(req.data, nullptr);
+    ASSERT_TRUE(reader.next(req));
+    EXPECT_FALSE(req.discarded);
+    EXPECT_EQ(req.opcode, 43);
+}
+
+TEST(RequestReader, FillReadsAvailableBytesInOneCall) {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    X11ByteOrder bo{false};
+    X11RequestReader reader(bo);
+    std::vector<uint8_t> stream;
+    for (int i = 0; i < 50; i++) {
+        auto r = makeRequest(bo, 16, 0, 12);
+        stream.insert(stream.end(), r.begin(), r.end());
+    }
+    ASSERT_EQ(write(fds[1], stream.data(), stream.size()), (ssize_t)stream.size());
+
+    EXPECT_EQ(reader.fill(fds[0]), X11RequestReader::FillResult::Data);
+    int count = 0;
+    X11RequestReader::Request req;
+    while (reader.next(req)) count++;
+    EXPECT_EQ(count, 50);
+
+    close(fds[1]);
+    EXPECT_EQ(reader.fill(fds[0]), X11RequestReader::FillResult::Closed);
+    close(fds[0]);
+}
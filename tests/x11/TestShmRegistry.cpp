@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include "X11ShmRegistry.h"
+#include <cstring>
+
+using namespace guitarrackcraft;
+
+TEST(ShmRegistry, CreateAttachSharesMapping) {
+    X11ShmRegistry reg;
+    int id = reg.create(4096);
+    ASSERT_GT(id, 0);
+    size_t size = 0;
+    auto* a = static_cast<uint8_t*>(reg.attach(id, &size));
+    auto* b = static_cast<uint8_t*>(reg.attach(id));
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(size, 4096u);
+    EXPECT_EQ(a, b);
+    memset(a, 0x5a, 4096);
+    EXPECT_EQ(b[4095], 0x5a);
+    EXPECT_TRUE(reg.detach(id));
+    EXPECT_TRUE(reg.detach(id));
+}
+
+TEST(ShmRegistry, RejectsZeroSizeAndUnknownIds) {
+    X11ShmRegistry reg;
+    EXPECT_EQ(reg.create(0), -1);
+    EXPECT_EQ(reg.attach(42), nullptr);
+    EXPECT_FALSE(reg.detach(42));
+    EXPECT_FALSE(reg.remove(42));
+}
+
+TEST(ShmRegistry, RemoveWaitsForLastDetach) {
+    X11ShmRegistry reg;
+    int id = reg.create(1024);
+    void* addr = reg.attach(id);
+    ASSERT_NE(addr, nullptr);
+    EXPECT_TRUE(reg.remove(id));
+    EXPECT_EQ(reg.segmentCount(), 1u);  // still attached
+    EXPECT_TRUE(reg.detachAddress(addr));
+    EXPECT_EQ(reg.segmentCount(), 0u);
+    EXPECT_EQ(reg.attach(id), nullptr);
+}
+
+TEST(ShmRegistry, RemoveUnattachedFreesImmediately) {
+    X11ShmRegistry reg;
+    int id = reg.create(1024);
+    EXPECT_TRUE(reg.remove(id));
+    EXPECT_EQ(reg.segmentCount(), 0u);
+}
+
+TEST(ShmSegmentTable, AttachDetachHoldsReference) {
+    X11ShmRegistry reg;
+    int id = reg.create(256);
+    {
+        X11ShmSegmentTable table(reg);
+        EXPECT_TRUE(table.attach(7, id, true));
+        EXPECT_FALSE(table.attach(7, id, false));  // shmseg already in use
+        EXPECT_FALSE(table.attach(8, id + 100, false));
+        const auto* seg = table.get(7);
+        ASSERT_NE(seg, nullptr);
+        EXPECT_EQ(seg->size, 256u);
+        EXPECT_TRUE(seg->readOnly);
+        reg.remove(id);
+        EXPECT_EQ(reg.segmentCount(), 1u);  // table still holds it
+    }
+    EXPECT_EQ(reg.segmentCount(), 0u);  // released by the table destructor
+}
+
+TEST(ShmSegmentTable, ContainsChecksBounds) {
+    X11ShmSegmentTable::Segment seg;
+    seg.size = 100;
+    EXPECT_TRUE(seg.contains(0, 100));
+    EXPECT_TRUE(seg.contains(100, 0));
+    EXPECT_FALSE(seg.contains(1, 100));
+    EXPECT_FALSE(seg.contains(101, 0));
+    EXPECT_FALSE(seg.contains(50, SIZE_MAX));
+}
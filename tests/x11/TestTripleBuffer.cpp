@@ -0,0 +1,262 @@
+#include <gtest/gtest.h>
+#include "X11TripleBuffer.h"
+#include <atomic>
+#include <thread>
+
+using namespace guitarrackcraft;
+
+namespace {
+
+/* Consumer-side mirror of the GPU texture: applies each acquired frame's upload. */
+struct Mirror {
+    std::vector<uint32_t> px;
+    int w = 0, h = 0;
+
+    void apply(const X11TripleBuffer::Frame& f) {
+        if (f.resized || f.width != w || f.height != h || f.upload.full()) {
+            px = f.pixels;
+            w = f.width;
+            h = f.height;
+            return;
+        }
+        for (const auto& r : f.upload.rects()) {
+            for (int y = r.y1; y < r.y2; ++y) {
+                for (int x = r.x1; x < r.x2; ++x) {
+                    px[(size_t)y * w + x] = f.pixels[(size_t)y * w + x];
+                }
+            }
+        }
+    }
+};
+
+void fill(std::vector<uint32_t>& src, int w, X11DamageRegion& dmg,
+          int x, int y, int rw, int rh, uint32_t v) {
+    for (int yy = y; yy < y + rh; ++yy) {
+        for (int xx = x; xx < x + rw; ++xx) src[(size_t)yy * w + xx] = v;
+    }
+    dmg.add(x, y, rw, rh);
+}
+
+} // namespace
+
+TEST(TripleBuffer, AcquireWithoutPublishReturnsFalse) {
+    X11TripleBuffer tb;
+    EXPECT_FALSE(tb.acquire());
+    EXPECT_EQ(tb.front().width, 0);
+}
+
+TEST(TripleBuffer, FirstPublishIsFullFrame) {
+    X11TripleBuffer tb;
+    std::vector<uint32_t> src(8 * 4, 0xFF00FF00u);
+    X11DamageRegion dmg;
+    dmg.reset(8, 4);
+    tb.publish(src.data(), 8, 4, dmg);
+    ASSERT_TRUE(tb.acquire());
+    EXPECT_TRUE(tb.front().resized);
+    EXPECT_EQ(tb.front().pixels, src);
+    EXPECT_FALSE(tb.acquire());
+}
+
+TEST(TripleBuffer, FrameCarriesOnlyNewDamage) {
+    X11TripleBuffer tb;
+    const int w = 16, h = 16;
+    std::vector<uint32_t> src((size_t)w * h, 0);
+    X11DamageRegion dmg;
+    dmg.reset(w, h);
+    tb.publish(src.data(), w, h, dmg);
+    ASSERT_TRUE(tb.acquire());
+
+    dmg.clear();
+    fill(src, w, dmg, 2, 3, 4, 2, 7);
+    tb.publish(src.data(), w, h, dmg);
+    ASSERT_TRUE(tb.acquire());
+    const auto& f = tb.front();
+    EXPECT_FALSE(f.resized);
+    ASSERT_EQ(f.upload.rects().size(), 1u);
+    EXPECT_EQ(f.upload.area(), 8u);
+    EXPECT_EQ(f.pixels, src);
+}
+
+TEST(TripleBuffer, SkippedFrameDamageFoldsIntoNext) {
+    X11TripleBuffer tb;
+    const int w = 32, h = 8;
+    std::vector<uint32_t> src((size_t)w * h, 0);
+    X11DamageRegion dmg;
+    dmg.reset(w, h);
+    tb.publish(src.data(), w, h, dmg);
+    Mirror tex;
+    ASSERT_TRUE(tb.acquire());
+    tex.apply(tb.front());
+
+    dmg.clear();
+    fill(src, w, dmg, 0, 0, 2, 2, 1);
+    tb.publish(src.data(), w, h, dmg);
+    dmg.clear();
+    fill(src, w, dmg, 20, 5, 3, 3, 2);
+    tb.publish(src.data(), w, h, dmg);  // consumer never saw the first one
+
+    ASSERT_TRUE(tb.acquire());
+    EXPECT_EQ(tb.front().upload.rects().size(), 2u);
+    tex.apply(tb.front());
+    EXPECT_EQ(tex.px, src);
+}
+
+TEST(TripleBuffer, StaleSlotsCatchUpAcrossPublishes) {
+    X11TripleBuffer tb;
+    const int w = 24, h = 24;
+    std::vector<uint32_t> src((size_t)w * h, 0);
+    X11DamageRegion dmg;
+    dmg.reset(w, h);
+    tb.publish(src.data(), w, h, dmg);
+    Mirror tex;
+    for (int i = 0; i < 20; ++i) {
+        dmg.clear();
+        fill(src, w, dmg, (i * 5) % 20, (i * 7) % 20, 4, 4, (uint32_t)i + 1);
+        tb.publish(src.data(), w, h, dmg);
+        if (i % 3 != 0) {
+            ASSERT_TRUE(tb.acquire());
+            tex.apply(tb.front());
+            EXPECT_EQ(tb.front().pixels, src) << "publish " << i;
+        }
+    }
+    EXPECT_FALSE(tb.acquire());  // publish 19 was already taken
+    EXPECT_EQ(tex.px, src);
+}
+
+TEST(TripleBuffer, ResizeRepublishesWholeFrame) {
+    X11TripleBuffer tb;
+    std::vector<uint32_t> a(4 * 4, 1), b(6 * 3, 2);
+    X11DamageRegion dmg;
+    dmg.reset(4, 4);
+    tb.publish(a.data(), 4, 4, dmg);
+    ASSERT_TRUE(tb.acquire());
+    dmg.reset(6, 3);
+    tb.publish(b.data(), 6, 3, dmg);
+    ASSERT_TRUE(tb.acquire());
+    EXPECT_TRUE(tb.front().resized);
+    EXPECT_EQ(tb.front().width, 6);
+    EXPECT_EQ(tb.front().pixels, b);
+}
+
+TEST(TripleBuffer, ConcurrentProducerConsumerConverge) {
+    X11TripleBuffer tb;
+    const int w = 64, h = 32;
+    std::vector<uint32_t> src((size_t)w * h, 0);
+    X11DamageRegion dmg;
+    dmg.reset(w, h);
+    tb.publish(src.data(), w, h, dmg);
+
+    std::atomic<bool> done{false};
+    Mirror tex;
+    std::thread consumer([&] {
+        while (!done.load()) {
+            if (tb.acquire()) tex.apply(tb.front());
+        }
+    });
+    for (int i = 0; i < 5000; ++i) {
+        dmg.clear();
+        fill(src, w, dmg, (i * 13) % (w - 8), (i * 5) % (h - 4), 8, 4, (uint32_t)i);
+        tb.publish(src.data(), w, h, dmg);
+    }
+    done = true;
+    consumer.join();
+    if (tb.acquire()) tex.apply(tb.front());
+    EXPECT_EQ(tex.px, src);
+}
+
+namespace {
+
+/* Padded-stride storage standing in for AHardwareBuffers. */
+struct FakeStorage : X11FrameStorage {
+    static constexpr int kPad = 3;
+    std::vector<uint32_t> slots[3];
+    int strides[3] = {0, 0, 0};
+    int allocations = 0, locks = 0, unlocks = 0;
+    bool failAllocate = false;
+
+    bool allocate(int slot, int w, int h) override {
+        if (failAllocate) return false;
+        strides[slot] = w + kPad;
+        slots[slot].assign((size_t)strides[slot] * h, 0xDEADBEEFu);
+        ++allocations;
+        return true;
+    }
+    uint32_t* lock(int slot, int& stride) override {
+        ++locks;
+        stride = strides[slot];
+        return slots[slot].data();
+    }
+    void unlock(int) override { ++unlocks; }
+
+    bool matches(int slot, const std::vector<uint32_t>& src, int w, int h) const {
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                if (slots[slot][(size_t)y * strides[slot] + x] != src[(size_t)y * w + x]) return false;
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+TEST(TripleBuffer, ExternalStorageReceivesStridedCopies) {
+    FakeStorage storage;
+    X11TripleBuffer tb;
+    tb.setStorage(&storage);
+    const int w = 10, h = 6;
+    std::vector<uint32_t> src((size_t)w * h, 5);
+    X11DamageRegion dmg;
+    dmg.reset(w, h);
+    tb.publish(src.data(), w, h, dmg);
+    for (int i = 0; i < 6; ++i) {
+        dmg.clear();
+        fill(src, w, dmg, i, i % 4, 3, 2, (uint32_t)(100 + i));
+        tb.publish(src.data(), w, h, dmg);
+        ASSERT_TRUE(tb.acquire());
+        const auto& f = tb.front();
+        EXPECT_TRUE(f.external);
+        EXPECT_TRUE(f.pixels.empty());
+        EXPECT_TRUE(storage.matches(f.slot, src, w, h)) << "publish " << i;
+    }
+    EXPECT_EQ(storage.allocations, 3);  // once per slot, not per frame
+    EXPECT_EQ(storage.locks, storage.unlocks);
+}
+
+TEST(TripleBuffer, FailedAllocationFallsBackToLocalPixels) {
+    FakeStorage storage;
+    storage.failAllocate = true;
+    X11TripleBuffer tb;
+    tb.setStorage(&storage);
+    std::vector<uint32_t> src(4 * 4, 9);
+    X11DamageRegion dmg;
+    dmg.reset(4, 4);
+    tb.publish(src.data(), 4, 4, dmg);
+    ASSERT_TRUE(tb.acquire());
+    EXPECT_FALSE(tb.front().external);
+    EXPECT_TRUE(tb.front().resized);
+    EXPECT_EQ(tb.front().pixels, src);
+}
+
+TEST(TripleBuffer, DropStorageRepublishesFullLocalFrame) {
+    FakeStorage storage;
+    X11TripleBuffer tb;
+    tb.setStorage(&storage);
+    const int w = 8, h = 8;
+    std::vector<uint32_t> src((size_t)w * h, 1);
+    X11DamageRegion dmg;
+    dmg.reset(w, h);
+    tb.publish(src.data(), w, h, dmg);
+    ASSERT_TRUE(tb.acquire());
+    ASSERT_TRUE(tb.front().external);
+
+    tb.dropStorage();
+    dmg.clear();
+    fill(src, w, dmg, 1, 1, 2, 2, 3);
+    tb.publish(src.data(), w, h, dmg);
+    ASSERT_TRUE(tb.acquire());
+    const auto& f = tb.front();
+    EXPECT_FALSE(f.external);
+    EXPECT_TRUE(f.resized);
+    EXPECT_EQ(f.pixels, src);
+}
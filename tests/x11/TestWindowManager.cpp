@@ -266,3 +266,40 @@ TEST_F(WindowManagerTest, GetMappedChildRectsEmpty) {
     auto rects = wm.getMappedChildRectsOf(0x200001);
     EXPECT_TRUE(rects.empty());
 }
+
+TEST_F(WindowManagerTest, ClipRegionCoversChildrenAndHigherSiblings) {
+    wm.createWindow(0x200001, kRoot, 0, 0, 400, 300);
+    wm.mapWindow(0x200001);
+    wm.createWindow(0x200002, 0x200001, 10, 10, 100, 100);
+    wm.mapWindow(0x200002);
+    wm.createWindow(0x200003, 0x200002, 5, 5, 20, 20);   // child of 0x200002
+    wm.mapWindow(0x200003);
+    wm.createWindow(0x200004, 0x200001, 50, 50, 100, 100);  // sibling above 0x200002
+    wm.mapWindow(0x200004);
+
+    const auto& clip = wm.clipRegion(0x200002);
+    EXPECT_TRUE(clip.contains(15, 15));    // child at absolute (15,15)
+    EXPECT_TRUE(clip.contains(60, 60));    // higher sibling
+    EXPECT_FALSE(clip.contains(12, 12));
+    EXPECT_FALSE(wm.clipRegion(0x200004).contains(15, 15));  // nothing above 0x200004
+}
+
+TEST_F(WindowManagerTest, ClipRegionRebuiltOnTreeChange) {
+    wm.createWindow(0x200001, kRoot, 0, 0, 400, 300);
+    wm.mapWindow(0x200001);
+    wm.createWindow(0x200002, 0x200001, 10, 10, 20, 20);
+    EXPECT_TRUE(wm.clipRegion(0x200001).empty());  // child not mapped yet
+
+    wm.mapWindow(0x200002);
+    EXPECT_TRUE(wm.clipRegion(0x200001).contains(10, 10));
+
+    wm.setPositionX(0x200002, 100);
+    EXPECT_FALSE(wm.clipRegion(0x200001).contains(10, 10));
+    EXPECT_TRUE(wm.clipRegion(0x200001).contains(100, 10));
+
+    wm.setSize(0x200002, 5, 5);
+    EXPECT_FALSE(wm.clipRegion(0x200001).contains(110, 10));
+
+    wm.unmapWindow(0x200002);
+    EXPECT_TRUE(wm.clipRegion(0x200001).empty());
+}
@@ -102,6 +102,29 @@ protected:
         bo.write16(body.data(), 22, (uint16_t)h);
         return sendRequest(fd, bo, 62, 0, body);
     }
+
+    // Helper: CreateGC with function and foreground
+    bool createGC(uint32_t gc, uint32_t function, uint32_t foreground) {
+        std::vector<uint8_t> body(20, 0);
+        bo.write32(body.data(), 0, gc);
+        bo.write32(body.data(), 4, kRootWindowId);
+        bo.write32(body.data(), 8, 0x1 | 0x4);  // function | foreground
+        bo.write32(body.data(), 12, function);
+        bo.write32(body.data(), 16, foreground);
+        return sendRequest(fd, bo, 55, 0, body);
+    }
+
+    // Helper: PolyFillRectangle with one rect
+    bool fillRect(uint32_t drawable, uint32_t gc, int x, int y, int w, int h) {
+        std::vector<uint8_t> body(16, 0);
+        bo.write32(body.data(), 0, drawable);
+        bo.write32(body.data(), 4, gc);
+        bo.write16(body.data(), 8, (uint16_t)(int16_t)x);
+        bo.write16(body.data(), 10, (uint16_t)(int16_t)y);
+        bo.write16(body.data(), 12, (uint16_t)w);
+        bo.write16(body.data(), 14, (uint16_t)h);
+        return sendRequest(fd, bo, 70, 0, body);
+    }
 };
 
 TEST_F(ImageOpsWireTest, PutImageGetImageRoundTrip_LSB) {
@@ -300,6 +323,27 @@ TEST_F(ImageOpsWireTest, CopyAreaOverlappingSrcDst) {
     EXPECT_EQ(got[1], (pixels[1] | 0xFF000000u));
 }
 
+TEST_F(ImageOpsWireTest, PutImageWithBigRequestHeader) {
+    const int w = 64, h = 64;
+    std::vector<uint32_t> pixels(w * h);
+    for (int i = 0; i < w * h; i++) pixels[i] = 0xFF000000u | (uint32_t)(i * 2654435761u >> 8);
+    auto body = buildPutImageBody(kRootWindowId, w, h, 0, 0, pixels.data());
+
+    // Header with length=0 followed by the 32-bit length (header + ext length + body)
+    std::vector<uint8_t> req(8 + body.size());
+    req[0] = 72;
+    req[1] = 2;  // ZPixmap
+    bo.write32(req.data(), 4, (uint32_t)(req.size() / 4));
+    memcpy(req.data() + 8, body.data(), body.size());
+    ASSERT_TRUE(sendRaw(fd, req.data(), req.size()));
+
+    std::vector<uint32_t> out;
+    ASSERT_TRUE(getImage(kRootWindowId, 0, 0, w, h, out));
+    for (int i = 0; i < w * h; i++) {
+        ASSERT_EQ(out[i] & 0x00FFFFFFu, pixels[i] & 0x00FFFFFFu) << "pixel " << i;
+    }
+}
+
 TEST_F(ImageOpsWireTest, PutImageZeroSize) {
     // PutImage with w=0 — should be a no-op, not crash
     uint32_t dummy = 0;
@@ -327,3 +371,51 @@ TEST_F(ImageOpsWireTest, CreatePixmapZeroSize) {
     ASSERT_TRUE(recvExact(fd, reply, 32));
     EXPECT_EQ(reply[0], 1);  // InternAtom reply OK
 }
+
+TEST_F(ImageOpsWireTest, PolyFillRectangleUsesGCForeground) {
+    ASSERT_TRUE(createGC(0x400001, 3 /*GXcopy*/, 0x00336699));
+    ASSERT_TRUE(fillRect(kRootWindowId, 0x400001, 2, 3, 4, 2));
+
+    std::vector<uint32_t> got;
+    ASSERT_TRUE(getImage(kRootWindowId, 1, 3, 6, 2, got));
+    EXPECT_NE(got[0], 0xFF336699u);  // x=1 outside the rect
+    for (int col = 1; col <= 4; col++) EXPECT_EQ(got[col], 0xFF336699u);
+    EXPECT_EQ(got[6 + 4], 0xFF336699u);
+    EXPECT_NE(got[5], 0xFF336699u);
+}
+
+TEST_F(ImageOpsWireTest, PolyFillRectangleIntoPixmapHonoursClipRects) {
+    ASSERT_TRUE(createPixmap(0x400010, 8, 8));
+    ASSERT_TRUE(createGC(0x400001, 3, 0x00FF0000));
+    // Clip to a 2x2 box at (1,1) relative to clip origin (2,2)
+    std::vector<uint8_t> body(16, 0);
+    bo.write32(body.data(), 0, 0x400001);
+    bo.write16(body.data(), 4, 2);
+    bo.write16(body.data(), 6, 2);
+    bo.write16(body.data(), 8, 1);
+    bo.write16(body.data(), 10, 1);
+    bo.write16(body.data(), 12, 2);
+    bo.write16(body.data(), 14, 2);
+    ASSERT_TRUE(sendRequest(fd, bo, 59, 0 /*Unsorted*/, body));
+    ASSERT_TRUE(fillRect(0x400010, 0x400001, 0, 0, 8, 8));
+
+    std::vector<uint32_t> got;
+    ASSERT_TRUE(getImage(0x400010, 0, 0, 8, 8, got));
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            bool inside = x >= 3 && x < 5 && y >= 3 && y < 5;
+            EXPECT_EQ(got[y * 8 + x] == 0xFFFF0000u, inside) << x << "," << y;
+        }
+    }
+}
+
+TEST_F(ImageOpsWireTest, PolyFillRectangleSkipsNonCopyFunction) {
+    uint32_t pixels[4] = {0x00010203, 0x00010203, 0x00010203, 0x00010203};
+    ASSERT_TRUE(putImage(kRootWindowId, 2, 2, 0, 0, pixels));
+    ASSERT_TRUE(createGC(0x400001, 6 /*GXxor*/, 0x00FFFFFF));
+    ASSERT_TRUE(fillRect(kRootWindowId, 0x400001, 0, 0, 2, 2));
+
+    std::vector<uint32_t> got;
+    ASSERT_TRUE(getImage(kRootWindowId, 0, 0, 2, 2, got));
+    for (auto p : got) EXPECT_EQ(p, 0xFF010203u);
+}
@@ -284,6 +284,25 @@ TEST_F(WireProtocolTest, BigRequestsSkip) {
     EXPECT_NE(bo.read32(reply, 8), 0u);
 }
 
+TEST_F(WireProtocolTest, BigReqEnable) {
+    std::string name = "BIG-REQUESTS";
+    std::vector<uint8_t> body(4 + name.size());
+    bo.write16(body.data(), 0, (uint16_t)name.size());
+    memcpy(body.data() + 4, name.data(), name.size());
+    ASSERT_TRUE(sendRequest(fd, bo, 98, 0, body));
+    uint8_t reply[32];
+    ASSERT_TRUE(recvExact(fd, reply, 32));
+    ASSERT_EQ(reply[8], 1);
+    uint8_t major = reply[9];
+    EXPECT_EQ(major, X11Op::kBigRequestsMajorOpcode);
+
+    ASSERT_TRUE(sendRequest(fd, bo, major, 0, {}));
+    ASSERT_TRUE(recvExact(fd, reply, 32));
+    EXPECT_EQ(reply[0], 1);
+    EXPECT_EQ(bo.read16(reply, 2), 2);  // sequence
+    EXPECT_EQ(bo.read32(reply, 8), kBigRequestsMaxLength);
+}
+
 TEST_F(WireProtocolTest, UnknownOpcodeRecovery) {
     // Send request with unhandled opcode 254, length=1 (4 bytes, header only)
     std::vector<uint8_t> emptyBody;
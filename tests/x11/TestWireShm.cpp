@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include "TestHelpers.h"
+#include <unistd.h>
+
+using namespace guitarrackcraft;
+using namespace guitarrackcraft::test;
+
+class ShmWireTest : public ::testing::Test {
+protected:
+    X11TestServer server;
+    X11ByteOrder bo{false};  // LSB
+    int fd = -1;
+    int shmid = -1;
+    uint32_t* shm = nullptr;
+    static constexpr uint32_t kSeg = 0x00400001;
+    static constexpr int kSegW = 16, kSegH = 16;
+
+    void SetUp() override {
+        fd = server.start(64, 64);
+        ASSERT_GE(fd, 0);
+        uint8_t req[12] = {};
+        req[0] = 0x6c;
+        bo.write16(req, 2, 11);
+        ASSERT_EQ(send(fd, req, 12, MSG_NOSIGNAL), 12);
+        uint8_t reply[120];
+        ASSERT_TRUE(recvExact(fd, reply, 120));
+
+        shmid = X11ShmRegistry::instance().create(kSegW * kSegH * 4);
+        ASSERT_GT(shmid, 0);
+        shm = static_cast<uint32_t*>(X11ShmRegistry::instance().attach(shmid));
+        ASSERT_NE(shm, nullptr);
+        X11ShmRegistry::instance().remove(shmid);  // freed once everyone detaches
+    }
+
+    void TearDown() override {
+        if (fd >= 0) close(fd);
+        server.stop();
+        if (shm) X11ShmRegistry::instance().detachAddress(shm);
+    }
+
+    bool shmRequest(uint8_t minor, const std::vector<uint8_t>& body) {
+        return sendRequest(fd, bo, X11Op::kShmMajorOpcode, minor, body);
+    }
+
+    bool attach(uint32_t seg, int id, bool readOnly = false) {
+        std::vector<uint8_t> body(12, 0);
+        bo.write32(body.data(), 0, seg);
+        bo.write32(body.data(), 4, (uint32_t)id);
+        body[8] = readOnly ? 1 : 0;
+        return shmRequest(X11Shm::Attach, body);
+    }
+
+    bool putImage(uint32_t drawable, int srcX, int srcY, int w, int h, int dstX, int dstY,
+                  bool sendEvent) {
+        std::vector<uint8_t> body(36, 0);
+        bo.write32(body.data(), 0, drawable);
+        bo.write16(body.data(), 8, kSegW);
+        bo.write16(body.data(), 10, kSegH);
+        bo.write16(body.data(), 12, (uint16_t)srcX);
+        bo.write16(body.data(), 14, (uint16_t)srcY);
+        bo.write16(body.data(), 16, (uint16_t)w);
+        bo.write16(body.data(), 18, (uint16_t)h);
+        bo.write16(body.data(), 20, (uint16_t)(int16_t)dstX);
+        bo.write16(body.data(), 22, (uint16_t)(int16_t)dstY);
+        body[24] = 24;  // depth
+        body[25] = 2;   // ZPixmap
+        body[26] = sendEvent ? 1 : 0;
+        bo.write32(body.data(), 28, kSeg);
+        bo.write32(body.data(), 32, 0);
+        return shmRequest(X11Shm::PutImage, body);
+    }
+
+    bool getImage(uint32_t drawable, int x, int y, int w, int h, uint32_t offset, uint8_t* reply) {
+        std::vector<uint8_t> body(28, 0);
+        bo.write32(body.data(), 0, drawable);
+        bo.write16(body.data(), 4, (uint16_t)(int16_t)x);
+        bo.write16(body.data(), 6, (uint16_t)(int16_t)y);
+        bo.write16(body.data(), 8, (uint16_t)w);
+        bo.write16(body.data(), 10, (uint16_t)h);
+        bo.write32(body.data(), 12, 0xFFFFFFFF);
+        body[16] = 2;  // ZPixmap
+        bo.write32(body.data(), 20, kSeg);
+        bo.write32(body.data(), 24, offset);
+        return shmRequest(X11Shm::GetImage, body) && recvExact(fd, reply, 32);
+    }
+
+    // Core GetImage, used to check what ShmPutImage wrote
+    std::vector<uint32_t> coreGetImage(uint32_t drawable, int x, int y, int w, int h) {
+        std::vector<uint8_t> body(16, 0);
+        bo.write32(body.data(), 0, drawable);
+        bo.write16(body.data(), 4, (uint16_t)x);
+        bo.write16(body.data(), 6, (uint16_t)y);
+        bo.write16(body.data(), 8, (uint16_t)w);
+        bo.write16(body.data(), 10, (uint16_t)h);
+        bo.write32(body.data(), 12, 0xFFFFFFFF);
+        std::vector<uint32_t> px((size_t)w * h, 0);
+        if (!sendRequest(fd, bo, 73, 2, body)) return {};
+        uint8_t header[32];
+        if (!recvExact(fd, header, 32)) return {};
+        if (!recvExact(fd, px.data(), px.size() * 4)) return {};
+        return px;
+    }
+};
+
+TEST_F(ShmWireTest, QueryExtensionReportsBases) {
+    std::vector<uint8_t> body(12, 0);
+    bo.write16(body.data(), 0, 7);
+    memcpy(body.data() + 4, "MIT-SHM", 7);
+    ASSERT_TRUE(sendRequest(fd, bo, 98, 0, body));
+    uint8_t reply[32];
+    ASSERT_TRUE(recvExact(fd, reply, 32));
+    EXPECT_EQ(reply[8], 1);
+    EXPECT_EQ(reply[9], X11Op::kShmMajorOpcode);
+    EXPECT_EQ(reply[10], X11Shm::kFirstEvent);
+    EXPECT_EQ(reply[11], X11Shm::kFirstError);
+}
+
+TEST_F(ShmWireTest, QueryVersion) {
+    ASSERT_TRUE(shmRequest(X11Shm::QueryVersion, {}));
+    uint8_t reply[32];
+    ASSERT_TRUE(recvExact(fd, reply, 32));
+    EXPECT_EQ(reply[0], 1);
+    EXPECT_EQ(reply[1], 0);  // no shared pixmaps
+    EXPECT_EQ(bo.read16(reply, 8), 1);
+    EXPECT_EQ(bo.read16(reply, 10), 1);
+    EXPECT_EQ(reply[16], 2);  // ZPixmap
+}
+
+TEST_F(ShmWireTest, PutImageSubRectWithCompletion) {
+    for (int i = 0; i < kSegW * kSegH; i++) shm[i] = 0xFF000000u | (uint32_t)i;
+    ASSERT_TRUE(attach(kSeg, shmid));
+    ASSERT_TRUE(putImage(kRootWindowId, 2, 3, 4, 2, 10, 20, true));
+
+    uint8_t ev[32];
+    ASSERT_TRUE(recvExact(fd, ev, 32));
+    EXPECT_EQ(ev[0], X11Shm::kFirstEvent);
+    EXPECT_EQ(bo.read32(ev, 4), kRootWindowId);
+    EXPECT_EQ(bo.read16(ev, 8), X11Shm::PutImage);
+    EXPECT_EQ(ev[10], X11Op::kShmMajorOpcode);
+    EXPECT_EQ(bo.read32(ev, 12), kSeg);
+
+    auto px = coreGetImage(kRootWindowId, 10, 20, 4, 2);
+    ASSERT_EQ(px.size(), 8u);
+    for (int row = 0; row < 2; row++) {
+        for (int col = 0; col < 4; col++) {
+            EXPECT_EQ(px[row * 4 + col] & 0x00FFFFFFu, (uint32_t)((3 + row) * kSegW + 2 + col));
+        }
+    }
+}
+
+TEST_F(ShmWireTest, GetImageWritesSegment) {
+    ASSERT_TRUE(attach(kSeg, shmid));
+    for (int i = 0; i < kSegW * kSegH; i++) shm[i] = 0xFF000000u | 0x123456u;
+    ASSERT_TRUE(putImage(kRootWindowId, 0, 0, kSegW, kSegH, 0, 0, false));
+    // Round-trip so the server has consumed the segment before it is cleared
+    ASSERT_TRUE(shmRequest(X11Shm::QueryVersion, {}));
+    uint8_t version[32];
+    ASSERT_TRUE(recvExact(fd, version, 32));
+    memset(shm, 0, kSegW * kSegH * 4);
+
+    uint8_t reply[32];
+    ASSERT_TRUE(getImage(kRootWindowId, 0, 0, 4, 4, 64, reply));
+    EXPECT_EQ(reply[0], 1);
+    EXPECT_EQ(reply[1], 24);
+    EXPECT_EQ(bo.read32(reply, 12), 64u);
+    EXPECT_EQ(shm[0], 0u);  // before the requested offset
+    for (int i = 16; i < 32; i++) EXPECT_EQ(shm[i] & 0x00FFFFFFu, 0x123456u);
+}
+
+TEST_F(ShmWireTest, UnknownSegmentIsBadShmSeg) {
+    ASSERT_TRUE(putImage(kRootWindowId, 0, 0, 1, 1, 0, 0, false));
+    uint8_t err[32];
+    ASSERT_TRUE(recvExact(fd, err, 32));
+    EXPECT_EQ(err[0], 0);
+    EXPECT_EQ(err[1], X11Shm::kFirstError);
+    EXPECT_EQ(bo.read32(err, 4), kSeg);
+}
+
+TEST_F(ShmWireTest, ReadOnlySegmentRejectsGetImage) {
+    ASSERT_TRUE(attach(kSeg, shmid, true));
+    uint8_t reply[32];
+    ASSERT_TRUE(getImage(kRootWindowId, 0, 0, 2, 2, 0, reply));
+    EXPECT_EQ(reply[0], 0);
+    EXPECT_EQ(reply[1], 10);  // BadAccess
+}
+
+TEST_F(ShmWireTest, OutOfBoundsOffsetIsBadValue) {
+    ASSERT_TRUE(attach(kSeg, shmid));
+    uint8_t reply[32];
+    ASSERT_TRUE(getImage(kRootWindowId, 0, 0, 16, 16, 4, reply));
+    EXPECT_EQ(reply[0], 0);
+    EXPECT_EQ(reply[1], 2);  // BadValue
+}